@@ -405,20 +405,21 @@ napi_value CommonNapi::CreateFormatBuffer(napi_env env, Format &format)
     napi_status status = napi_create_object(env, &buffer);
     CHECK_AND_RETURN_RET(status == napi_ok, nullptr);
 
-    for (auto &iter : format.GetFormatMap()) {
-        switch (format.GetValueType(std::string_view(iter.first))) {
+    for (auto &keyView : format.GetKeys()) {
+        std::string key(keyView);
+        switch (format.GetValueType(keyView)) {
             case FORMAT_TYPE_INT32:
-                if (format.GetIntValue(iter.first, intValue)) {
-                    CHECK_AND_RETURN_RET(SetPropertyInt32(env, buffer, iter.first, intValue) == true, nullptr);
+                if (format.GetIntValue(keyView, intValue)) {
+                    CHECK_AND_RETURN_RET(SetPropertyInt32(env, buffer, key, intValue) == true, nullptr);
                 }
                 break;
             case FORMAT_TYPE_STRING:
-                if (format.GetStringValue(iter.first, strValue)) {
-                    CHECK_AND_RETURN_RET(SetPropertyString(env, buffer, iter.first, strValue) == true, nullptr);
+                if (format.GetStringValue(keyView, strValue)) {
+                    CHECK_AND_RETURN_RET(SetPropertyString(env, buffer, key, strValue) == true, nullptr);
                 }
                 break;
             default:
-                MEDIA_LOGE("format key: %{public}s", iter.first.c_str());
+                MEDIA_LOGE("format key: %{public}s", key.c_str());
                 break;
         }
     }
@@ -433,20 +434,21 @@ bool CommonNapi::CreateFormatBufferByRef(napi_env env, Format &format, napi_valu
     napi_status status = napi_create_object(env, &result);
     CHECK_AND_RETURN_RET(status == napi_ok, false);
 
-    for (auto &iter : format.GetFormatMap()) {
-        switch (format.GetValueType(std::string_view(iter.first))) {
+    for (auto &keyView : format.GetKeys()) {
+        std::string key(keyView);
+        switch (format.GetValueType(keyView)) {
             case FORMAT_TYPE_INT32:
-                if (format.GetIntValue(iter.first, intValue)) {
-                    (void)SetPropertyInt32(env, result, iter.first, intValue);
+                if (format.GetIntValue(keyView, intValue)) {
+                    (void)SetPropertyInt32(env, result, key, intValue);
                 }
                 break;
             case FORMAT_TYPE_STRING:
-                if (format.GetStringValue(iter.first, strValue)) {
-                    (void)SetPropertyString(env, result, iter.first, strValue);
+                if (format.GetStringValue(keyView, strValue)) {
+                    (void)SetPropertyString(env, result, key, strValue);
                 }
                 break;
             default:
-                MEDIA_LOGE("format key: %{public}s", iter.first.c_str());
+                MEDIA_LOGE("format key: %{public}s", key.c_str());
                 break;
         }
     }
@@ -14,6 +14,7 @@
  */
 
 #include "avcodec_list_impl.h"
+#include "avcodec_capability_index.h"
 #include "media_log.h"
 #include "media_errors.h"
 #include "i_media_service.h"
@@ -58,24 +59,40 @@ AVCodecListImpl::~AVCodecListImpl()
 std::string AVCodecListImpl::FindVideoDecoder(const Format &format)
 {
     CHECK_AND_RETURN_RET_LOG(codecListService_ != nullptr, "", "AvCodecList service does not exist..");
+    std::shared_ptr<const AVCodecCapabilityIndex> capabilityIndex = codecListService_->GetCapabilityIndex();
+    if (capabilityIndex != nullptr) {
+        return capabilityIndex->FindCodec(format, AVCODEC_TYPE_VIDEO_DECODER);
+    }
     return codecListService_->FindVideoDecoder(format);
 }
 
 std::string AVCodecListImpl::FindVideoEncoder(const Format &format)
 {
     CHECK_AND_RETURN_RET_LOG(codecListService_ != nullptr, "", "AvCodecList service does not exist..");
+    std::shared_ptr<const AVCodecCapabilityIndex> capabilityIndex = codecListService_->GetCapabilityIndex();
+    if (capabilityIndex != nullptr) {
+        return capabilityIndex->FindCodec(format, AVCODEC_TYPE_VIDEO_ENCODER);
+    }
     return codecListService_->FindVideoEncoder(format);
 }
 
 std::string AVCodecListImpl::FindAudioDecoder(const Format &format)
 {
     CHECK_AND_RETURN_RET_LOG(codecListService_ != nullptr, "", "AvCodecList service does not exist..");
+    std::shared_ptr<const AVCodecCapabilityIndex> capabilityIndex = codecListService_->GetCapabilityIndex();
+    if (capabilityIndex != nullptr) {
+        return capabilityIndex->FindCodec(format, AVCODEC_TYPE_AUDIO_DECODER);
+    }
     return codecListService_->FindAudioDecoder(format);
 }
 
 std::string AVCodecListImpl::FindAudioEncoder(const Format &format)
 {
     CHECK_AND_RETURN_RET_LOG(codecListService_ != nullptr, "", "AvCodecList service does not exist..");
+    std::shared_ptr<const AVCodecCapabilityIndex> capabilityIndex = codecListService_->GetCapabilityIndex();
+    if (capabilityIndex != nullptr) {
+        return capabilityIndex->FindCodec(format, AVCODEC_TYPE_AUDIO_ENCODER);
+    }
     return codecListService_->FindAudioEncoder(format);
 }
 
@@ -85,6 +102,11 @@ std::vector<CapabilityData> AVCodecListImpl::GetCodecCapabilityInfos()
         MEDIA_LOGD("capabilityArray_ has been assigned.");
         return capabilityArray_;
     }
+    CHECK_AND_RETURN_RET_LOG(codecListService_ != nullptr, capabilityArray_, "AvCodecList service does not exist..");
+    std::shared_ptr<const AVCodecCapabilityIndex> capabilityIndex = codecListService_->GetCapabilityIndex();
+    if (capabilityIndex != nullptr) {
+        return capabilityIndex->GetCapabilityDataArray();
+    }
     return codecListService_->GetCodecCapabilityInfos();
 }
 
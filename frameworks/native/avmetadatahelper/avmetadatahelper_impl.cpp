@@ -14,6 +14,7 @@
  */
 
 #include "avmetadatahelper_impl.h"
+#include <atomic>
 #include "securec.h"
 #include "i_media_service.h"
 #include "media_log.h"
@@ -134,6 +135,49 @@ static std::shared_ptr<PixelMap> CreatePixelMap(const std::shared_ptr<AVSharedMe
     return pixelMap;
 }
 
+class AVMetadataBatchCallbackAdapter : public AVMetadataBatchServiceCallback, public NoCopyable {
+public:
+    AVMetadataBatchCallbackAdapter(const std::shared_ptr<AVMetadataBatchCallback> &callback, PixelFormat color)
+        : callback_(callback), color_(color)
+    {
+    }
+    ~AVMetadataBatchCallbackAdapter() = default;
+
+    void OnBatchResult(int32_t index, int32_t errCode, const std::unordered_map<int32_t, std::string> &metadata,
+        const std::shared_ptr<AVSharedMemory> &thumbnail) override
+    {
+        // the results sent by the service before the cancellation may still arrive
+        if (cancelled_.load() || finished_.load()) {
+            return;
+        }
+        std::shared_ptr<PixelMap> pixelMap = nullptr;
+        if (thumbnail != nullptr) {
+            pixelMap = CreatePixelMap(thumbnail, color_);
+        }
+        callback_->OnResult(index, errCode, metadata, pixelMap);
+    }
+
+    void OnBatchFinished(int32_t errCode) override
+    {
+        // reported once, the service death may come after the batch is finished
+        if (finished_.exchange(true)) {
+            return;
+        }
+        callback_->OnFinished(errCode);
+    }
+
+    void Cancel()
+    {
+        cancelled_ = true;
+    }
+
+private:
+    std::shared_ptr<AVMetadataBatchCallback> callback_;
+    PixelFormat color_;
+    std::atomic<bool> cancelled_ = false;
+    std::atomic<bool> finished_ = false;
+};
+
 std::shared_ptr<AVMetadataHelper> AVMetadataHelperFactory::CreateAVMetadataHelper()
 {
     std::shared_ptr<AVMetadataHelperImpl> impl = std::make_shared<AVMetadataHelperImpl>();
@@ -225,9 +269,86 @@ std::shared_ptr<PixelMap> AVMetadataHelperImpl::FetchFrameAtTime(
     return CreatePixelMap(mem, param.colorFormat);
 }
 
+int32_t AVMetadataHelperImpl::FetchFramesAtTimes(const std::vector<int64_t> &timesUs, int32_t option,
+    const PixelMapParams &param, const FrameFetchedCallback &callback)
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperService_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper service does not exist.");
+    CHECK_AND_RETURN_RET_LOG(callback != nullptr, MSERR_INVALID_VAL, "callback is nullptr");
+    CHECK_AND_RETURN_RET_LOG(!timesUs.empty() && timesUs.size() <= MAX_FETCH_FRAMES_NUM, MSERR_INVALID_VAL,
+        "invalid frames count: %{public}zu", timesUs.size());
+
+    OutputConfiguration config;
+    config.colorFormat = param.colorFormat;
+    config.dstHeight = param.dstHeight;
+    config.dstWidth = param.dstWidth;
+
+    int32_t ret = avMetadataHelperService_->PrepareFetchFrames(timesUs, option, config);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "prepare fetch frames failed");
+
+    // the frames are delivered one by one as soon as they are decoded, rather than all at the end
+    int32_t result = MSERR_OK;
+    for (size_t i = 0; i < timesUs.size(); i++) {
+        int64_t timeUs = -1;
+        auto mem = avMetadataHelperService_->FetchNextFrame(timeUs);
+        CHECK_AND_RETURN_RET_LOG(timeUs >= 0, MSERR_UNKNOWN, "the batch is interrupted at %{public}zu", i);
+
+        std::shared_ptr<PixelMap> pixelMap = CreatePixelMap(mem, param.colorFormat);
+        if (pixelMap == nullptr) {
+            result = MSERR_UNKNOWN;
+        }
+        callback(timeUs, pixelMap);
+    }
+    return result;
+}
+
+int32_t AVMetadataHelperImpl::ResolveMetadataBatch(const std::vector<AVMetadataBatchSource> &sources,
+    const AVMetadataBatchParams &params, const std::shared_ptr<AVMetadataBatchCallback> &callback)
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperService_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper service does not exist.");
+    CHECK_AND_RETURN_RET_LOG(callback != nullptr, MSERR_INVALID_VAL, "callback is nullptr");
+    CHECK_AND_RETURN_RET_LOG(!sources.empty() && sources.size() <= MAX_BATCH_SOURCES_NUM, MSERR_INVALID_VAL,
+        "invalid sources count: %{public}zu", sources.size());
+    for (auto &source : sources) {
+        CHECK_AND_RETURN_RET_LOG(source.fd > 0 && source.offset >= 0 && source.size > 0, MSERR_INVALID_VAL,
+            "invalid source param");
+    }
+
+    AVMetadataBatchConfig config;
+    config.keys = params.keys;
+    config.fetchThumbnail = params.fetchThumbnail;
+    config.thumbnailTimeUs = params.thumbnailTimeUs;
+    config.thumbnailOption = params.thumbnailOption;
+    config.thumbnailConfig.colorFormat = params.thumbnailParams.colorFormat;
+    config.thumbnailConfig.dstHeight = params.thumbnailParams.dstHeight;
+    config.thumbnailConfig.dstWidth = params.thumbnailParams.dstWidth;
+
+    auto batchCallback = std::make_shared<AVMetadataBatchCallbackAdapter>(callback,
+        params.thumbnailParams.colorFormat);
+    int32_t ret = avMetadataHelperService_->ResolveMetadataBatch(sources, config, batchCallback);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "resolve metadata batch failed");
+    batchCallback_ = batchCallback;
+    return MSERR_OK;
+}
+
+int32_t AVMetadataHelperImpl::CancelBatch()
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperService_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper service does not exist.");
+    if (batchCallback_ != nullptr) {
+        batchCallback_->Cancel();
+    }
+    return avMetadataHelperService_->CancelBatch();
+}
+
 void AVMetadataHelperImpl::Release()
 {
     CHECK_AND_RETURN_LOG(avMetadataHelperService_ != nullptr, "avmetadatahelper service does not exist.");
+    if (batchCallback_ != nullptr) {
+        batchCallback_->Cancel();
+        batchCallback_ = nullptr;
+    }
     avMetadataHelperService_->Release();
     (void)MediaServiceFactory::GetInstance().DestroyAVMetadataHelperService(avMetadataHelperService_);
     avMetadataHelperService_ = nullptr;
@@ -21,6 +21,8 @@
 
 namespace OHOS {
 namespace Media {
+class AVMetadataBatchCallbackAdapter;
+
 class AVMetadataHelperImpl : public AVMetadataHelper, public NoCopyable {
 public:
     AVMetadataHelperImpl();
@@ -32,10 +34,16 @@ public:
     std::unordered_map<int32_t, std::string> ResolveMetadata() override;
     std::shared_ptr<AVSharedMemory> FetchArtPicture() override;
     std::shared_ptr<PixelMap> FetchFrameAtTime(int64_t timeUs, int32_t option, const PixelMapParams &param) override;
+    int32_t FetchFramesAtTimes(const std::vector<int64_t> &timesUs, int32_t option,
+        const PixelMapParams &param, const FrameFetchedCallback &callback) override;
+    int32_t ResolveMetadataBatch(const std::vector<AVMetadataBatchSource> &sources,
+        const AVMetadataBatchParams &params, const std::shared_ptr<AVMetadataBatchCallback> &callback) override;
+    int32_t CancelBatch() override;
     void Release() override;
     int32_t Init();
 private:
     std::shared_ptr<IAVMetadataHelperService> avMetadataHelperService_ = nullptr;
+    std::shared_ptr<AVMetadataBatchCallbackAdapter> batchCallback_ = nullptr;
 };
 } // namespace Media
 } // namespace OHOS
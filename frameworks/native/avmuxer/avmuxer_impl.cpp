@@ -14,11 +14,9 @@
  */
 
 #include "avmuxer_impl.h"
-#include "securec.h"
 #include "i_media_service.h"
 #include "media_log.h"
 #include "media_errors.h"
-#include "avsharedmemorybase.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMuxerImpl"};
@@ -26,6 +24,34 @@ namespace {
 
 namespace OHOS {
 namespace Media {
+/**
+ * Borrow the sample of the caller during WriteTrackSample, the service copies it into the shared
+ * memory, so that the sample is copied only once.
+ */
+class AVContainerMemoryRef : public AVSharedMemory, public NoCopyable {
+public:
+    explicit AVContainerMemoryRef(const std::shared_ptr<AVContainerMemory> &memory) : memory_(memory) {}
+    ~AVContainerMemoryRef() = default;
+
+    uint8_t *GetBase() const override
+    {
+        return memory_->Data();
+    }
+
+    int32_t GetSize() const override
+    {
+        return static_cast<int32_t>(memory_->Size());
+    }
+
+    uint32_t GetFlags() const override
+    {
+        return FLAGS_READ_ONLY;
+    }
+
+private:
+    std::shared_ptr<AVContainerMemory> memory_;
+};
+
 std::shared_ptr<AVMuxer> AVMuxerFactory::CreateAVMuxer()
 {
     std::shared_ptr<AVMuxerImpl> impl = std::make_shared<AVMuxerImpl>();
@@ -101,15 +127,12 @@ int32_t AVMuxerImpl::WriteTrackSample(std::shared_ptr<AVContainerMemory> sampleD
     CHECK_AND_RETURN_RET_LOG(avmuxerService_ != nullptr, MSERR_INVALID_OPERATION, "AVMuxer Service does not exist");
     CHECK_AND_RETURN_RET_LOG(sampleData != nullptr &&
         sampleData->Offset() + sampleData->Size() <= sampleData->Capacity() &&
-        sampleData->Offset() + sampleData->Size() >= sampleData->Size(),
+        sampleData->Offset() + sampleData->Size() >= sampleData->Size() &&
+        sampleData->Size() <= static_cast<size_t>(INT32_MAX),
         MSERR_INVALID_VAL, "Invalid memory");
-    std::shared_ptr<AVSharedMemoryBase> avSharedMem =
-        std::make_shared<AVSharedMemoryBase>(sampleData->Size(), AVSharedMemory::FLAGS_READ_ONLY, "sampleData");
-    int32_t ret = avSharedMem->Init();
-    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, MSERR_NO_MEMORY, "Failed to create AVSharedMemoryBase");
-    errno_t rc = memcpy_s(avSharedMem->GetBase(), avSharedMem->GetSize(), sampleData->Data(), sampleData->Size());
-    CHECK_AND_RETURN_RET_LOG(rc == EOK, MSERR_UNKNOWN, "memcpy_s failed");
-    return avmuxerService_->WriteTrackSample(avSharedMem, info);
+    std::shared_ptr<AVSharedMemory> sampleRef = std::make_shared<AVContainerMemoryRef>(sampleData);
+    CHECK_AND_RETURN_RET_LOG(sampleRef != nullptr, MSERR_NO_MEMORY, "Failed to create AVContainerMemoryRef");
+    return avmuxerService_->WriteTrackSample(sampleRef, info);
 }
 
 int32_t AVMuxerImpl::Stop()
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avspliter_impl.h"
+#include "securec.h"
+#include "i_media_service.h"
+#include "media_log.h"
+#include "media_errors.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVSpliterImpl"};
+}
+
+namespace OHOS {
+namespace Media {
+std::shared_ptr<AVSpliter> AVSpliterFactory::CreateAVSpliter()
+{
+    std::shared_ptr<AVSpliterImpl> impl = std::make_shared<AVSpliterImpl>();
+    CHECK_AND_RETURN_RET_LOG(impl != nullptr, nullptr, "Failed to create avspliter implementation");
+
+    int32_t ret = impl->Init();
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, nullptr, "Failed to init avspliter implementation");
+    return impl;
+}
+
+int32_t AVSpliterImpl::Init()
+{
+    avspliterService_ = MediaServiceFactory::GetInstance().CreateAVSpliterService();
+    CHECK_AND_RETURN_RET_LOG(avspliterService_ != nullptr, MSERR_NO_MEMORY, "Failed to create avspliter service");
+    return MSERR_OK;
+}
+
+AVSpliterImpl::AVSpliterImpl()
+{
+    MEDIA_LOGD("AVSpliterImpl:0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVSpliterImpl::~AVSpliterImpl()
+{
+    if (avspliterService_ != nullptr) {
+        (void)MediaServiceFactory::GetInstance().DestroyAVSpliterService(avspliterService_);
+        avspliterService_ = nullptr;
+    }
+    MEDIA_LOGD("AVSpliterImpl:0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+int32_t AVSpliterImpl::SetSource(const std::string &uri, TrackSelectMode mode)
+{
+    CHECK_AND_RETURN_RET_LOG(avspliterService_ != nullptr, MSERR_INVALID_OPERATION,
+        "AVSpliter Service does not exist");
+    CHECK_AND_RETURN_RET_LOG(!uri.empty(), MSERR_INVALID_VAL, "uri is empty");
+    CHECK_AND_RETURN_RET_LOG(mode <= TRACK_TIME_INDEPENDENT, MSERR_INVALID_VAL, "invalid mode");
+
+    return avspliterService_->SetSource(uri, mode);
+}
+
+int32_t AVSpliterImpl::SetSource(std::shared_ptr<IMediaDataSource> dataSource, TrackSelectMode mode)
+{
+    CHECK_AND_RETURN_RET_LOG(avspliterService_ != nullptr, MSERR_INVALID_OPERATION,
+        "AVSpliter Service does not exist");
+    CHECK_AND_RETURN_RET_LOG(dataSource != nullptr, MSERR_INVALID_VAL, "data source is nullptr");
+    CHECK_AND_RETURN_RET_LOG(mode <= TRACK_TIME_INDEPENDENT, MSERR_INVALID_VAL, "invalid mode");
+
+    return avspliterService_->SetSource(dataSource, mode);
+}
+
+int32_t AVSpliterImpl::GetContainerDescription(MediaDescription &desc)
+{
+    CHECK_AND_RETURN_RET_LOG(avspliterService_ != nullptr, MSERR_INVALID_OPERATION,
+        "AVSpliter Service does not exist");
+    return avspliterService_->GetContainerDescription(desc);
+}
+
+int32_t AVSpliterImpl::GetTrackDescription(uint32_t trackIdx, MediaDescription &desc)
+{
+    CHECK_AND_RETURN_RET_LOG(avspliterService_ != nullptr, MSERR_INVALID_OPERATION,
+        "AVSpliter Service does not exist");
+    return avspliterService_->GetTrackDescription(trackIdx, desc);
+}
+
+int32_t AVSpliterImpl::SelectTrack(uint32_t trackIdx)
+{
+    CHECK_AND_RETURN_RET_LOG(avspliterService_ != nullptr, MSERR_INVALID_OPERATION,
+        "AVSpliter Service does not exist");
+    return avspliterService_->SelectTrack(trackIdx);
+}
+
+int32_t AVSpliterImpl::UnSelectTrack(uint32_t trackIdx)
+{
+    CHECK_AND_RETURN_RET_LOG(avspliterService_ != nullptr, MSERR_INVALID_OPERATION,
+        "AVSpliter Service does not exist");
+    return avspliterService_->UnSelectTrack(trackIdx);
+}
+
+int32_t AVSpliterImpl::ReadTrackSample(std::shared_ptr<AVContainerMemory> buffer, TrackSampleInfo &info)
+{
+    CHECK_AND_RETURN_RET_LOG(avspliterService_ != nullptr, MSERR_INVALID_OPERATION,
+        "AVSpliter Service does not exist");
+    CHECK_AND_RETURN_RET_LOG(buffer != nullptr && buffer->Base() != nullptr && buffer->Capacity() > 0,
+        MSERR_INVALID_VAL, "Invalid memory");
+
+    // The memory is sized to the caller's buffer: the engine keeps a sample queued when it does not fit,
+    // so a sample too large for this buffer is never taken out of the queue.
+    if (readMem_ == nullptr || static_cast<size_t>(readMem_->GetSize()) != buffer->Capacity()) {
+        readMem_ = std::make_shared<AVSharedMemoryBase>(static_cast<int32_t>(buffer->Capacity()),
+            AVSharedMemory::FLAGS_READ_WRITE, "spliterSample");
+        int32_t ret = readMem_->Init();
+        if (ret != MSERR_OK) {
+            readMem_ = nullptr;
+            MEDIA_LOGE("Failed to create AVSharedMemoryBase");
+            return MSERR_NO_MEMORY;
+        }
+    }
+
+    int32_t ret = avspliterService_->ReadTrackSample(readMem_, info);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+    CHECK_AND_RETURN_RET_LOG(info.size <= buffer->Capacity(), MSERR_NO_MEMORY, "buffer is too small");
+
+    if (info.size > 0) {
+        errno_t rc = memcpy_s(buffer->Base(), buffer->Capacity(), readMem_->GetBase(), info.size);
+        CHECK_AND_RETURN_RET_LOG(rc == EOK, MSERR_UNKNOWN, "memcpy_s failed");
+    }
+    buffer->SetRange(0, info.size);
+    return MSERR_OK;
+}
+
+int32_t AVSpliterImpl::Seek(int64_t timeUs, AVSeekMode mode)
+{
+    CHECK_AND_RETURN_RET_LOG(avspliterService_ != nullptr, MSERR_INVALID_OPERATION,
+        "AVSpliter Service does not exist");
+    return avspliterService_->Seek(timeUs, mode);
+}
+
+int32_t AVSpliterImpl::GetCacheState(int64_t &durationUs, bool &endOfStream)
+{
+    CHECK_AND_RETURN_RET_LOG(avspliterService_ != nullptr, MSERR_INVALID_OPERATION,
+        "AVSpliter Service does not exist");
+    return avspliterService_->GetCacheState(durationUs, endOfStream);
+}
+
+void AVSpliterImpl::Release()
+{
+    CHECK_AND_RETURN_LOG(avspliterService_ != nullptr, "AVSpliter Service does not exist");
+    (void)avspliterService_->Release();
+    (void)MediaServiceFactory::GetInstance().DestroyAVSpliterService(avspliterService_);
+    avspliterService_ = nullptr;
+    readMem_ = nullptr;
+}
+}  // namespace Media
+}  // namespace OHOS
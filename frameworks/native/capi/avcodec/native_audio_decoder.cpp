@@ -13,10 +13,11 @@
  * limitations under the License.
  */
 
-#include <list>
+#include <atomic>
 #include "native_avcodec_base.h"
 #include "native_avcodec_audiodecoder.h"
 #include "native_avmagic.h"
+#include "native_avmemory_table.h"
 #include "avcodec_audio_decoder.h"
 #include "avsharedmemory.h"
 #include "media_log.h"
@@ -34,7 +35,8 @@ struct AudioDecoderObject : public OH_AVCodec {
     ~AudioDecoderObject() = default;
 
     const std::shared_ptr<AVCodecAudioDecoder> audioDecoder_;
-    std::list<OHOS::sptr<OH_AVMemory>> memoryObjList_;
+    NativeAVMemoryTable inputMemories_;
+    NativeAVMemoryTable outputMemories_;
     std::shared_ptr<AVCodecCallback> callback_ = nullptr;
     std::atomic<bool> isFlushing_ = false;
     std::atomic<bool> isStop_ = false;
@@ -115,17 +117,7 @@ private:
         std::shared_ptr<AVSharedMemory> memory = audioDecObj->audioDecoder_->GetInputBuffer(index);
         CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "get input buffer is nullptr!");
 
-        for (auto &memoryObj : audioDecObj->memoryObjList_) {
-            if (memoryObj->IsEqualMemory(memory)) {
-                return reinterpret_cast<OH_AVMemory *>(memoryObj.GetRefPtr());
-            }
-        }
-
-        OHOS::sptr<OH_AVMemory> object = new(std::nothrow) OH_AVMemory(memory);
-        CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVMemory");
-
-        audioDecObj->memoryObjList_.push_back(object);
-        return reinterpret_cast<OH_AVMemory *>(object.GetRefPtr());
+        return audioDecObj->inputMemories_.GetMemory(index, memory);
     }
 
     OH_AVMemory *GetOutputData(struct OH_AVCodec *codec, uint32_t index)
@@ -139,17 +131,7 @@ private:
         std::shared_ptr<AVSharedMemory> memory = audioDecObj->audioDecoder_->GetOutputBuffer(index);
         CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "get output buffer is nullptr!");
 
-        for (auto &memoryObj : audioDecObj->memoryObjList_) {
-            if (memoryObj->IsEqualMemory(memory)) {
-                return reinterpret_cast<OH_AVMemory *>(memoryObj.GetRefPtr());
-            }
-        }
-
-        OHOS::sptr<OH_AVMemory> object = new(std::nothrow) OH_AVMemory(memory);
-        CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVMemory");
-
-        audioDecObj->memoryObjList_.push_back(object);
-        return reinterpret_cast<OH_AVMemory *>(object.GetRefPtr());
+        return audioDecObj->outputMemories_.GetMemory(index, memory);
     }
 
     struct OH_AVCodec *codec_;
@@ -191,7 +173,8 @@ OH_AVErrCode OH_AudioDecoder_Destroy(struct OH_AVCodec *codec)
     struct AudioDecoderObject *audioDecObj = reinterpret_cast<AudioDecoderObject *>(codec);
 
     if (audioDecObj != nullptr && audioDecObj->audioDecoder_ != nullptr) {
-        audioDecObj->memoryObjList_.clear();
+        audioDecObj->inputMemories_.Reset();
+        audioDecObj->outputMemories_.Reset();
         audioDecObj->isStop_.store(true);
         int32_t ret = audioDecObj->audioDecoder_->Release();
         if (ret != MSERR_OK) {
@@ -269,7 +252,8 @@ OH_AVErrCode OH_AudioDecoder_Stop(struct OH_AVCodec *codec)
         MEDIA_LOGE("audioDecoder Stop failed!, set stop status to false");
         return AV_ERR_OPERATE_NOT_PERMIT;
     }
-    audioDecObj->memoryObjList_.clear();
+    audioDecObj->inputMemories_.Reset();
+    audioDecObj->outputMemories_.Reset();
 
     return AV_ERR_OK;
 }
@@ -290,7 +274,8 @@ OH_AVErrCode OH_AudioDecoder_Flush(struct OH_AVCodec *codec)
         return AV_ERR_OPERATE_NOT_PERMIT;
     }
 
-    audioDecObj->memoryObjList_.clear();
+    audioDecObj->inputMemories_.Reset();
+    audioDecObj->outputMemories_.Reset();
     audioDecObj->isFlushing_.store(false);
     MEDIA_LOGD("set flush status to false");
     return AV_ERR_OK;
@@ -313,7 +298,8 @@ OH_AVErrCode OH_AudioDecoder_Reset(struct OH_AVCodec *codec)
         return AV_ERR_OPERATE_NOT_PERMIT;
     }
 
-    audioDecObj->memoryObjList_.clear();
+    audioDecObj->inputMemories_.Reset();
+    audioDecObj->outputMemories_.Reset();
     return AV_ERR_OK;
 }
 
@@ -13,10 +13,11 @@
  * limitations under the License.
  */
 
-#include <list>
+#include <atomic>
 #include "native_avcodec_base.h"
 #include "native_avcodec_audioencoder.h"
 #include "native_avmagic.h"
+#include "native_avmemory_table.h"
 #include "avcodec_audio_encoder.h"
 #include "avsharedmemory.h"
 #include "media_log.h"
@@ -34,7 +35,8 @@ struct AudioEncoderObject : public OH_AVCodec {
     ~AudioEncoderObject() = default;
 
     const std::shared_ptr<AVCodecAudioEncoder> audioEncoder_;
-    std::list<OHOS::sptr<OH_AVMemory>> memoryObjList_;
+    NativeAVMemoryTable inputMemories_;
+    NativeAVMemoryTable outputMemories_;
     std::shared_ptr<AVCodecCallback> callback_ = nullptr;
     std::atomic<bool> isFlushing_ = false;
     std::atomic<bool> isStop_ = false;
@@ -114,17 +116,7 @@ private:
         std::shared_ptr<AVSharedMemory> memory = audioEncObj->audioEncoder_->GetInputBuffer(index);
         CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "get input buffer is nullptr!");
 
-        for (auto &memoryObj : audioEncObj->memoryObjList_) {
-            if (memoryObj->IsEqualMemory(memory)) {
-                return reinterpret_cast<OH_AVMemory *>(memoryObj.GetRefPtr());
-            }
-        }
-
-        OHOS::sptr<OH_AVMemory> object = new(std::nothrow) OH_AVMemory(memory);
-        CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVMemory");
-
-        audioEncObj->memoryObjList_.push_back(object);
-        return reinterpret_cast<OH_AVMemory *>(object.GetRefPtr());
+        return audioEncObj->inputMemories_.GetMemory(index, memory);
     }
 
     OH_AVMemory *GetOutputData(struct OH_AVCodec *codec, uint32_t index)
@@ -138,17 +130,7 @@ private:
         std::shared_ptr<AVSharedMemory> memory = audioEncObj->audioEncoder_->GetOutputBuffer(index);
         CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "get output buffer is nullptr!");
 
-        for (auto &memoryObj : audioEncObj->memoryObjList_) {
-            if (memoryObj->IsEqualMemory(memory)) {
-                return reinterpret_cast<OH_AVMemory *>(memoryObj.GetRefPtr());
-            }
-        }
-
-        OHOS::sptr<OH_AVMemory> object = new(std::nothrow) OH_AVMemory(memory);
-        CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVMemory");
-
-        audioEncObj->memoryObjList_.push_back(object);
-        return reinterpret_cast<OH_AVMemory *>(object.GetRefPtr());
+        return audioEncObj->outputMemories_.GetMemory(index, memory);
     }
 
     struct OH_AVCodec *codec_;
@@ -190,7 +172,8 @@ OH_AVErrCode OH_AudioEncoder_Destroy(struct OH_AVCodec *codec)
     struct AudioEncoderObject *audioEncObj = reinterpret_cast<AudioEncoderObject *>(codec);
 
     if (audioEncObj != nullptr && audioEncObj->audioEncoder_ != nullptr) {
-        audioEncObj->memoryObjList_.clear();
+        audioEncObj->inputMemories_.Reset();
+        audioEncObj->outputMemories_.Reset();
         int32_t ret = audioEncObj->audioEncoder_->Release();
         if (ret != MSERR_OK) {
             MEDIA_LOGE("audioEncoder Release failed!");
@@ -267,7 +250,8 @@ OH_AVErrCode OH_AudioEncoder_Stop(struct OH_AVCodec *codec)
         MEDIA_LOGE("audioEncoder Stop failed! Set stop status to false");
         return AV_ERR_OPERATE_NOT_PERMIT;
     }
-    audioEncObj->memoryObjList_.clear();
+    audioEncObj->inputMemories_.Reset();
+    audioEncObj->outputMemories_.Reset();
 
     return AV_ERR_OK;
 }
@@ -289,7 +273,8 @@ OH_AVErrCode OH_AudioEncoder_Flush(struct OH_AVCodec *codec)
         MEDIA_LOGE("audioEncObj Flush failed! Set flush status to false");
         return AV_ERR_OPERATE_NOT_PERMIT;
     }
-    audioEncObj->memoryObjList_.clear();
+    audioEncObj->inputMemories_.Reset();
+    audioEncObj->outputMemories_.Reset();
     audioEncObj->isFlushing_.store(false);
     MEDIA_LOGD("Set flush status to false");
     return AV_ERR_OK;
@@ -309,7 +294,8 @@ OH_AVErrCode OH_AudioEncoder_Reset(struct OH_AVCodec *codec)
         MEDIA_LOGE("audioEncoder Reset failed! Set stop status to false");
         return AV_ERR_OPERATE_NOT_PERMIT;
     }
-    audioEncObj->memoryObjList_.clear();
+    audioEncObj->inputMemories_.Reset();
+    audioEncObj->outputMemories_.Reset();
     return AV_ERR_OK;
 }
 
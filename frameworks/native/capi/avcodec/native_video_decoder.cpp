@@ -13,10 +13,11 @@
  * limitations under the License.
  */
 
-#include <list>
+#include <atomic>
 #include "native_avcodec_base.h"
 #include "native_avcodec_videodecoder.h"
 #include "native_avmagic.h"
+#include "native_avmemory_table.h"
 #include "native_window.h"
 #include "avcodec_video_decoder.h"
 #include "avsharedmemory.h"
@@ -35,7 +36,8 @@ struct VideoDecoderObject : public OH_AVCodec {
     ~VideoDecoderObject() = default;
 
     const std::shared_ptr<AVCodecVideoDecoder> videoDecoder_;
-    std::list<OHOS::sptr<OH_AVMemory>> memoryObjList_;
+    NativeAVMemoryTable inputMemories_;
+    NativeAVMemoryTable outputMemories_;
     std::shared_ptr<AVCodecCallback> callback_ = nullptr;
     std::atomic<bool> isFlushing_ = false;
     std::atomic<bool> isStop_ = false;
@@ -115,17 +117,7 @@ private:
         std::shared_ptr<AVSharedMemory> memory = videoDecObj->videoDecoder_->GetInputBuffer(index);
         CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "get input buffer is nullptr!");
 
-        for (auto &memoryObj : videoDecObj->memoryObjList_) {
-            if (memoryObj->IsEqualMemory(memory)) {
-                return reinterpret_cast<OH_AVMemory *>(memoryObj.GetRefPtr());
-            }
-        }
-
-        OHOS::sptr<OH_AVMemory> object = new(std::nothrow) OH_AVMemory(memory);
-        CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVMemory");
-
-        videoDecObj->memoryObjList_.push_back(object);
-        return reinterpret_cast<OH_AVMemory *>(object.GetRefPtr());
+        return videoDecObj->inputMemories_.GetMemory(index, memory);
     }
 
     OH_AVMemory *GetOutputData(struct OH_AVCodec *codec, uint32_t index)
@@ -139,17 +131,7 @@ private:
         std::shared_ptr<AVSharedMemory> memory = videoDecObj->videoDecoder_->GetOutputBuffer(index);
         CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "get output buffer is nullptr!");
 
-        for (auto &memoryObj : videoDecObj->memoryObjList_) {
-            if (memoryObj->IsEqualMemory(memory)) {
-                return reinterpret_cast<OH_AVMemory *>(memoryObj.GetRefPtr());
-            }
-        }
-
-        OHOS::sptr<OH_AVMemory> object = new(std::nothrow) OH_AVMemory(memory);
-        CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVMemory");
-
-        videoDecObj->memoryObjList_.push_back(object);
-        return reinterpret_cast<OH_AVMemory *>(object.GetRefPtr());
+        return videoDecObj->outputMemories_.GetMemory(index, memory);
     }
 
     struct OH_AVCodec *codec_;
@@ -191,7 +173,8 @@ OH_AVErrCode OH_VideoDecoder_Destroy(struct OH_AVCodec *codec)
     struct VideoDecoderObject *videoDecObj = reinterpret_cast<VideoDecoderObject *>(codec);
 
     if (videoDecObj != nullptr && videoDecObj->videoDecoder_ != nullptr) {
-        videoDecObj->memoryObjList_.clear();
+        videoDecObj->inputMemories_.Reset();
+        videoDecObj->outputMemories_.Reset();
         videoDecObj->isStop_.store(false);
         int32_t ret = videoDecObj->videoDecoder_->Release();
         if (ret != MSERR_OK) {
@@ -269,7 +252,8 @@ OH_AVErrCode OH_VideoDecoder_Stop(struct OH_AVCodec *codec)
         MEDIA_LOGE("videoDecoder Stop failed! Set stop status to false");
         return AV_ERR_OPERATE_NOT_PERMIT;
     }
-    videoDecObj->memoryObjList_.clear();
+    videoDecObj->inputMemories_.Reset();
+    videoDecObj->outputMemories_.Reset();
 
     return AV_ERR_OK;
 }
@@ -292,7 +276,8 @@ OH_AVErrCode OH_VideoDecoder_Flush(struct OH_AVCodec *codec)
         return AV_ERR_OPERATE_NOT_PERMIT;
     }
 
-    videoDecObj->memoryObjList_.clear();
+    videoDecObj->inputMemories_.Reset();
+    videoDecObj->outputMemories_.Reset();
     videoDecObj->isFlushing_.store(false);
     MEDIA_LOGD("Set flush status to false");
     return AV_ERR_OK;
@@ -314,7 +299,8 @@ OH_AVErrCode OH_VideoDecoder_Reset(struct OH_AVCodec *codec)
         return AV_ERR_OPERATE_NOT_PERMIT;
     }
 
-    videoDecObj->memoryObjList_.clear();
+    videoDecObj->inputMemories_.Reset();
+    videoDecObj->outputMemories_.Reset();
     return AV_ERR_OK;
 }
 
@@ -13,10 +13,11 @@
  * limitations under the License.
  */
 
-#include <list>
+#include <atomic>
 #include "native_avcodec_base.h"
 #include "native_avcodec_videoencoder.h"
 #include "native_avmagic.h"
+#include "native_avmemory_table.h"
 #include "native_window.h"
 #include "avcodec_video_encoder.h"
 #include "avsharedmemory.h"
@@ -35,7 +36,7 @@ struct VideoEncoderObject : public OH_AVCodec {
     ~VideoEncoderObject() = default;
 
     const std::shared_ptr<AVCodecVideoEncoder> videoEncoder_;
-    std::list<OHOS::sptr<OH_AVMemory>> memoryObjList_;
+    NativeAVMemoryTable outputMemories_;
     OHOS::sptr<OH_AVFormat> outputFormat_ = nullptr;
     std::shared_ptr<AVCodecCallback> callback_ = nullptr;
     std::atomic<bool> isFlushing_ = false;
@@ -115,17 +116,7 @@ private:
         std::shared_ptr<AVSharedMemory> memory = videoEncObj->videoEncoder_->GetOutputBuffer(index);
         CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "get output buffer is nullptr!");
 
-        for (auto &memoryObj : videoEncObj->memoryObjList_) {
-            if (memoryObj->IsEqualMemory(memory)) {
-                return reinterpret_cast<OH_AVMemory *>(memoryObj.GetRefPtr());
-            }
-        }
-
-        OHOS::sptr<OH_AVMemory> object = new(std::nothrow) OH_AVMemory(memory);
-        CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVMemory");
-
-        videoEncObj->memoryObjList_.push_back(object);
-        return reinterpret_cast<OH_AVMemory *>(object.GetRefPtr());
+        return videoEncObj->outputMemories_.GetMemory(index, memory);
     }
 
     struct OH_AVCodec *codec_;
@@ -167,7 +158,7 @@ OH_AVErrCode OH_VideoEncoder_Destroy(struct OH_AVCodec *codec)
     struct VideoEncoderObject *videoEncObj = reinterpret_cast<VideoEncoderObject *>(codec);
 
     if (videoEncObj != nullptr && videoEncObj->videoEncoder_ != nullptr) {
-        videoEncObj->memoryObjList_.clear();
+        videoEncObj->outputMemories_.Reset();
         videoEncObj->isStop_.store(true);
         int32_t ret = videoEncObj->videoEncoder_->Release();
         if (ret != MSERR_OK) {
@@ -244,7 +235,7 @@ OH_AVErrCode OH_VideoEncoder_Stop(struct OH_AVCodec *codec)
         MEDIA_LOGE("videoEncoder Stop failed! Set stop status to false");
         return AV_ERR_OPERATE_NOT_PERMIT;
     }
-    videoEncObj->memoryObjList_.clear();
+    videoEncObj->outputMemories_.Reset();
 
     return AV_ERR_OK;
 }
@@ -265,7 +256,7 @@ OH_AVErrCode OH_VideoEncoder_Flush(struct OH_AVCodec *codec)
         MEDIA_LOGD("videoEncoder Flush failed! Set flush status to false");
         return AV_ERR_OPERATE_NOT_PERMIT;
     }
-    videoEncObj->memoryObjList_.clear();
+    videoEncObj->outputMemories_.Reset();
     videoEncObj->isFlushing_.store(false);
     MEDIA_LOGD("set flush status to false");
     return AV_ERR_OK;
@@ -288,7 +279,7 @@ OH_AVErrCode OH_VideoEncoder_Reset(struct OH_AVCodec *codec)
         return AV_ERR_OPERATE_NOT_PERMIT;
     }
 
-    videoEncObj->memoryObjList_.clear();
+    videoEncObj->outputMemories_.Reset();
     return AV_ERR_OK;
 }
 
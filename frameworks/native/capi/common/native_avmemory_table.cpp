@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "native_avmemory_table.h"
+#include "media_log.h"
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "NativeAVMemoryTable"};
+// far beyond the buffer count of any codec port, only guards against a corrupted index
+constexpr uint32_t MAX_BUFFER_INDEX = 1024;
+}
+
+OH_AVMemory *NativeAVMemoryTable::GetMemory(uint32_t index,
+    const std::shared_ptr<OHOS::Media::AVSharedMemory> &memory)
+{
+    CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "memory is nullptr!");
+    CHECK_AND_RETURN_RET_LOG(index < MAX_BUFFER_INDEX, nullptr, "invalid buffer index %{public}u", index);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index < memories_.size() && memories_[index] != nullptr && memories_[index]->IsEqualMemory(memory)) {
+        return memories_[index].GetRefPtr();
+    }
+
+    OHOS::sptr<OH_AVMemory> object = new(std::nothrow) OH_AVMemory(memory);
+    CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "failed to new OH_AVMemory");
+    if (index >= memories_.size()) {
+        memories_.resize(index + 1);
+    }
+    memories_[index] = object;
+    return object.GetRefPtr();
+}
+
+void NativeAVMemoryTable::Reset()
+{
+    std::vector<OHOS::sptr<OH_AVMemory>> memories;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        memories_.swap(memories);
+    }
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NATIVE_AVMEMORY_TABLE_H
+#define NATIVE_AVMEMORY_TABLE_H
+
+#include <mutex>
+#include <vector>
+#include "native_avmagic.h"
+
+/**
+ * The OH_AVMemory wrappers of the codec buffers, indexed by the buffer index of one port. A wrapper is created
+ * the first time its buffer is reported and kept until the buffer at that index changes or the table is reset,
+ * so a buffer callback costs one array load and the table never grows beyond the buffer count.
+ */
+class NativeAVMemoryTable {
+public:
+    NativeAVMemoryTable() = default;
+    ~NativeAVMemoryTable() = default;
+
+    OH_AVMemory *GetMemory(uint32_t index, const std::shared_ptr<OHOS::Media::AVSharedMemory> &memory);
+    void Reset();
+
+private:
+    std::mutex mutex_;
+    std::vector<OHOS::sptr<OH_AVMemory>> memories_;
+};
+#endif // NATIVE_AVMEMORY_TABLE_H
@@ -16,9 +16,11 @@
 #ifndef AVMETADATAHELPER_H
 #define AVMETADATAHELPER_H
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 #include "pixel_map.h"
 #include "nocopyable.h"
 #include "avsharedmemory.h"
@@ -178,6 +180,95 @@ struct PixelMapParams {
     PixelFormat colorFormat = PixelFormat::RGB_565;
 };
 
+/**
+ * @brief The max count of the time positions fetched by one {@link AVMetadataHelper::FetchFramesAtTimes}.
+ */
+constexpr size_t MAX_FETCH_FRAMES_NUM = 64;
+
+/**
+ * @brief The callback to receive the frames fetched by {@link AVMetadataHelper::FetchFramesAtTimes}.
+ * The timeUs is one of the requested time positions, and the frame is null if the frame at
+ * this position can not be fetched.
+ */
+using FrameFetchedCallback = std::function<void(int64_t timeUs, const std::shared_ptr<PixelMap> &frame)>;
+
+/**
+ * @brief The max count of the sources resolved by one {@link AVMetadataHelper::ResolveMetadataBatch}.
+ */
+constexpr size_t MAX_BATCH_SOURCES_NUM = 256;
+
+/**
+ * @brief One media file descriptor source of {@link AVMetadataHelper::ResolveMetadataBatch}.
+ */
+struct AVMetadataBatchSource {
+    /**
+     * The file descriptor of the media source, it is only used during the call of
+     * {@link AVMetadataHelper::ResolveMetadataBatch}, and can be closed after that.
+     */
+    int32_t fd = -1;
+    /**
+     * The offset of the media source in the file descriptor.
+     */
+    int64_t offset = 0;
+    /**
+     * The size of the media source.
+     */
+    int64_t size = 0;
+};
+
+/**
+ * @brief What to resolve for every source of {@link AVMetadataHelper::ResolveMetadataBatch}.
+ */
+struct AVMetadataBatchParams {
+    /**
+     * The metadata keys to resolve, see {@link AVMetadataCode}. Empty means all keys.
+     */
+    std::vector<int32_t> keys;
+    /**
+     * Whether to fetch a thumbnail of the sources which have the video.
+     */
+    bool fetchThumbnail = false;
+    /**
+     * The time position in microseconds where the thumbnail will be fetched.
+     */
+    int64_t thumbnailTimeUs = 0;
+    /**
+     * The hint about how to fetch the thumbnail, see {@link AVMetadataQueryOption}.
+     */
+    int32_t thumbnailOption = AV_META_QUERY_NEXT_SYNC;
+    /**
+     * The desired configuration of the thumbnail, see {@link PixelMapParams}.
+     */
+    PixelMapParams thumbnailParams;
+};
+
+/**
+ * @brief The callback to receive the results of {@link AVMetadataHelper::ResolveMetadataBatch}.
+ * The methods are called from the ipc threads, one call at a time.
+ */
+class AVMetadataBatchCallback {
+public:
+    virtual ~AVMetadataBatchCallback() = default;
+
+    /**
+     * Called once for every source as soon as it is resolved, in the order of completion.
+     * @param index the index of the source in the submitted sources.
+     * @param errCode {@link MSERR_OK} if the source is resolved, an error code otherwise.
+     * @param metadata the requested metadata, empty if failed.
+     * @param thumbnail the thumbnail, null if not requested, or the source has no video, or failed.
+     */
+    virtual void OnResult(int32_t index, int32_t errCode, const std::unordered_map<int32_t, std::string> &metadata,
+        const std::shared_ptr<PixelMap> &thumbnail) = 0;
+
+    /**
+     * Called once after the last result of the batch.
+     * @param errCode {@link MSERR_OK} if every source has been reported, {@link MSERR_INVALID_STATE} if
+     * the batch is cancelled, in which case the sources not started are never reported, or
+     * {@link MSERR_SERVICE_DIED} if the media service died.
+     */
+    virtual void OnFinished(int32_t errCode) = 0;
+};
+
 /**
  * @brief Provides the interfaces to resolve metadata or fetch frame
  * from a given media resource.
@@ -253,6 +344,46 @@ public:
      */
     virtual std::shared_ptr<PixelMap> FetchFrameAtTime(int64_t timeUs, int32_t option, const PixelMapParams &param) = 0;
 
+    /**
+     * Fetch the video frames at a batch of given timestamps, such as the thumbnails of a timeline.
+     * The timestamps are sorted and the frames are decoded forward as far as possible instead of
+     * seeking for every frame, so it is much faster than calling {@link FetchFrameAtTime} repeatedly.
+     * This method must be called after the SetSource.
+     * @param timesUs The time positions in microseconds where the frames will be fetched, at most
+     * {@link MAX_FETCH_FRAMES_NUM} positions, and the negative positions are not allowed.
+     * @param option the hint about how to fetch the frames, see {@link AVMetadataQueryOption}
+     * @param param the desired configuration of returned pixelmaps, see {@link PixelMapParams}.
+     * @param callback It is called once for every requested time position in ascending order of
+     * the time as soon as the frame is fetched, before this method returns.
+     * @return Returns {@link MSERR_OK} if all frames are fetched, the callback may have been called
+     * for some positions when an error code is returned.
+     */
+    virtual int32_t FetchFramesAtTimes(const std::vector<int64_t> &timesUs, int32_t option,
+        const PixelMapParams &param, const FrameFetchedCallback &callback) = 0;
+
+    /**
+     * Resolve the metadata of a batch of sources in parallel, with an optional thumbnail for each
+     * of them. The sources are processed by a bounded pool of workers in the media service, sized
+     * to the cores and the memory, and the results are delivered through the callback as soon as
+     * each source completes, so the helper need not be created and set up again for every file.
+     * This method returns once the batch is accepted, and only one batch can be in progress on a
+     * helper at a time. It does not depend on the {@link SetSource}.
+     * @param sources the sources to resolve, at most {@link MAX_BATCH_SOURCES_NUM}.
+     * @param params what to resolve for every source, see {@link AVMetadataBatchParams}.
+     * @param callback the callback to receive the results, see {@link AVMetadataBatchCallback}.
+     * @return Returns {@link MSERR_OK} if the batch is accepted; returns an error code otherwise.
+     */
+    virtual int32_t ResolveMetadataBatch(const std::vector<AVMetadataBatchSource> &sources,
+        const AVMetadataBatchParams &params, const std::shared_ptr<AVMetadataBatchCallback> &callback) = 0;
+
+    /**
+     * Cancel the batch in progress. The sources being resolved are finished, but no more
+     * {@link AVMetadataBatchCallback::OnResult} is called after this method returns. The
+     * {@link AVMetadataBatchCallback::OnFinished} is still called later.
+     * @return Returns {@link MSERR_OK} if cancelled or there is no batch in progress.
+     */
+    virtual int32_t CancelBatch() = 0;
+
     /**
      * Release the internel resource. After this method called, the avmetadatahelper instance
      * can not be used again.
@@ -16,7 +16,9 @@
 #ifndef FORMAT_H
 #define FORMAT_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <map>
 #include <vector>
 
@@ -52,6 +54,11 @@ struct FormatData {
     size_t size = 0;
 };
 
+/**
+ * Format keeps its entries in a flat vector sorted by key, with inline room for the typical number of
+ * entries so that building and copying a Format does not touch the heap. Keys are interned, scalar values
+ * are stored in place, and string and buffer values are reference counted and shared between copies.
+ */
 class __attribute__((visibility("default"))) Format {
 public:
     Format() = default;
@@ -118,7 +125,10 @@ public:
     bool PutStringValue(const std::string_view &key, const std::string_view &value);
 
     /**
-     * @brief Sets metadata of the string type.
+     * @brief Sets metadata of the buffer type.
+     *
+     * The buffer is copied once and then shared by all copies of this Format, so it must not be
+     * modified through the address obtained by {@link GetBuffer}.
      *
      * @param key Indicates the metadata key.
      * @param addr Indicates the metadata addr, which is a uint8_t *.
@@ -222,6 +232,13 @@ public:
      */
     void RemoveKey(const std::string_view &key);
 
+    /**
+     * @brief Obtains all keys of this Format in ascending order.
+     *
+     * @return Returns the keys, which stay valid until this Format is modified or destroyed.
+     */
+    std::vector<std::string_view> GetKeys() const;
+
     /**
      * @brief A trick to enable the comparision between the std::string and std::string_view for
      * std::map, the trick called Transparent Comparator.
@@ -230,13 +247,16 @@ public:
     using FormatDataMap = std::map<std::string, FormatData, std::less<>>;
 
     /**
-     * @brief Obtains the metadata map.
+     * @brief Obtains a snapshot of the metadata as a map.
+     *
+     * The map is built on every call, prefer {@link GetKeys} and the typed getters on hot paths.
+     * Buffer addresses in the map point into this Format and stay valid until it is modified or destroyed.
      *
      * @return Returns the map object.
      * @since 1.0
      * @version 1.0
      */
-    const FormatDataMap &GetFormatMap() const;
+    FormatDataMap GetFormatMap() const;
 
     /**
      * @brief Convert the metadata map to string.
@@ -248,7 +268,30 @@ public:
     std::string Stringify() const;
 
 private:
-    FormatDataMap formatMap_;
+    struct Payload;
+    struct Entry {
+        std::string_view key;
+        Payload *keyOwner; // nullptr if the key is interned
+        Payload *payload; // string and buffer values
+        FormatDataType type;
+        FormatData::Val val;
+    };
+    static constexpr uint32_t INLINE_ENTRIES = 16;
+
+    Entry *Data();
+    const Entry *Data() const;
+    uint32_t LowerBound(const std::string_view &key) const;
+    const Entry *FindEntry(const std::string_view &key) const;
+    bool PutEntry(const std::string_view &key, FormatDataType type, FormatData::Val val, Payload *payload);
+    bool Reserve(uint32_t capacity);
+    void CopyFrom(const Format &rhs);
+    void MoveFrom(Format &rhs);
+    void Reset();
+
+    Entry *heapEntries_ = nullptr;
+    uint32_t size_ = 0;
+    uint32_t capacity_ = INLINE_ENTRIES;
+    alignas(Entry) uint8_t inlineEntries_[INLINE_ENTRIES * sizeof(Entry)];
 };
 } // namespace Media
 } // namespace OHOS
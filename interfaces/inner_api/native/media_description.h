@@ -117,6 +117,21 @@ public:
      */
     static constexpr std::string_view MD_KEY_CONTAINER_FORMAT = "container_format";
 
+    /**
+     * Key for batching the buffer exchange between the avcodec client and the media service through
+     * shared memory rings, value type is int32_t, 1 to enable. It takes effect when it is configured. In this
+     * mode QueueInputBuffer and ReleaseOutputBuffer return MSERR_OK once the buffer is posted, and a failure
+     * found by the service later is reported through OnError with AVCODEC_ERROR_INTERNAL.
+     */
+    static constexpr std::string_view MD_KEY_IPC_BATCHED_BUFFER = "ipc_batched_buffer";
+
+    /**
+     * Key for writing the avmuxer samples to the media service by one-way transactions, value type is
+     * int32_t, 1 to enable. It takes effect when it is configured to any track, and the errors of the
+     * written samples are returned by the following WriteTrackSample.
+     */
+    static constexpr std::string_view MD_KEY_IPC_ASYNC_WRITE = "ipc_async_write";
+
     /**
      * custom key prefix, media service will pass through to HAL.
      */
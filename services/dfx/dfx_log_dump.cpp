@@ -14,17 +14,127 @@
  */
 
 #include "dfx_log_dump.h"
+#include <chrono>
+#include <cstdarg>
+#include <cstring>
 #include <fstream>
 #include <unistd.h>
-#include <sys/time.h>
 #include "securec.h"
 
 namespace {
 constexpr int32_t FILE_MAX = 100;
 constexpr int32_t FILE_LINE_MAX = 50000;
+constexpr uint32_t RING_SLOT_COUNT = 256; // must be power of 2
+constexpr uint32_t RING_WAKE_THRESHOLD = RING_SLOT_COUNT / 2;
+constexpr size_t MAX_LOG_LEN = 255;
+// the formatted fallback keeps the full line length
+constexpr size_t RECORD_PAYLOAD_SIZE = MAX_LOG_LEN;
+constexpr int32_t DRAIN_INTERVAL_MS = 500;
+constexpr int32_t CHECK_ENABLE_INTERVAL_S = 60; // every 1 minute have a log
+constexpr size_t ARG_SIZE = sizeof(int64_t);
+
+enum class LogArgType : uint8_t {
+    NONE,
+    INT,
+    LONG,
+    LONG_LONG,
+    INTMAX,
+    SIZE,
+    PTRDIFF,
+    DOUBLE,
+    LONG_DOUBLE,
+    STRING,
+    POINTER,
+};
+
+struct LogSegment {
+    // the literal text followed by at most one conversion
+    std::string fmt;
+    LogArgType type = LogArgType::NONE;
+};
+
+struct LogRecord {
+    const OHOS::Media::DfxLogDump::LogFormat *format = nullptr;
+    const char *level = nullptr;
+    const char *tag = nullptr;
+    int64_t timeUs = 0;
+    // the payload is the formatted text instead of the raw args
+    bool formatted = false;
+    uint8_t payload[RECORD_PAYLOAD_SIZE] = {};
+};
 }
+
 namespace OHOS {
 namespace Media {
+struct DfxLogDump::LogFormat {
+    // the format without "{public}"
+    std::string stripped;
+    std::vector<LogSegment> segments;
+    // false if the args could not be saved as raw args, the log will be formatted by the caller
+    bool deferrable = true;
+};
+
+// single producer (the owner thread), single consumer (the TaskProcessor thread)
+class DfxLogDump::ThreadRing {
+public:
+    ThreadRing() : tid_(gettid()), records_(std::make_unique<LogRecord[]>(RING_SLOT_COUNT)) {}
+    ~ThreadRing() = default;
+
+    LogRecord *BeginWrite()
+    {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= RING_SLOT_COUNT) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &records_[head & (RING_SLOT_COUNT - 1)];
+    }
+
+    // return the count of records in the ring
+    uint64_t EndWrite()
+    {
+        uint64_t head = head_.load(std::memory_order_relaxed) + 1;
+        head_.store(head, std::memory_order_release);
+        return head - tail_.load(std::memory_order_relaxed);
+    }
+
+    const LogRecord *Front() const
+    {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &records_[tail & (RING_SLOT_COUNT - 1)];
+    }
+
+    void Pop()
+    {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool Empty() const
+    {
+        return tail_.load(std::memory_order_relaxed) == head_.load(std::memory_order_acquire);
+    }
+
+    uint64_t TakeDropped()
+    {
+        return dropped_.exchange(0, std::memory_order_relaxed);
+    }
+
+    int32_t GetTid() const
+    {
+        return tid_;
+    }
+
+private:
+    int32_t tid_;
+    std::unique_ptr<LogRecord[]> records_;
+    std::atomic<uint64_t> head_ = 0;
+    std::atomic<uint64_t> tail_ = 0;
+    std::atomic<uint64_t> dropped_ = 0;
+};
+
 DfxLogDump &DfxLogDump::GetInstance()
 {
     static DfxLogDump dfxLogDump;
@@ -55,15 +165,14 @@ void DfxLogDump::DumpLog()
     cond_.notify_all();
 }
 
-static void AddNewLog(const char *level, const OHOS::HiviewDFX::HiLogLabel &label, std::string &logStr)
+static void AddNewLog(const LogRecord &record, int32_t tid, std::string &logStr)
 {
-    struct timeval time = {};
-    (void)gettimeofday(&time, nullptr);
-    int64_t second = time.tv_sec % 60;
-    int64_t allMinute = time.tv_sec / 60;
+    int64_t allSecond = record.timeUs / 1000000; // 1000000: us to s
+    int64_t second = allSecond % 60;
+    int64_t allMinute = allSecond / 60;
     int64_t minute = allMinute % 60;
     int64_t hour = allMinute / 60 % 24;
-    int64_t mSecond = time.tv_usec / 1000;
+    int64_t mSecond = record.timeUs % 1000000 / 1000; // 1000000, 1000: us to ms
 
     logStr += std::to_string(hour);
     logStr += ":";
@@ -73,87 +182,411 @@ static void AddNewLog(const char *level, const OHOS::HiviewDFX::HiLogLabel &labe
     logStr += ":";
     logStr += std::to_string(mSecond);
     logStr += " ";
-    logStr += level;
+    logStr += record.level;
     logStr += " pid:";
     logStr += std::to_string(getpid());
     logStr += " tid:";
-    logStr += std::to_string(gettid());
+    logStr += std::to_string(tid);
     logStr += " ";
-    logStr += label.tag;
+    logStr += record.tag;
     logStr += ":";
 }
 
-void DfxLogDump::SaveLog(const char *level, const OHOS::HiviewDFX::HiLogLabel &label, const char *fmt, ...)
+static size_t ParseConversion(const std::string &fmt, size_t pos, LogArgType &type)
 {
-    std::unique_lock<std::mutex> lock(mutex_);
-    if (!isEnable_) {
-        return;
+    // pos is the index after '%'
+    pos = fmt.find_first_not_of("-+ #0", pos);
+    pos = fmt.find_first_not_of("0123456789", pos);
+    if (pos != std::string::npos && fmt[pos] == '.') {
+        pos = fmt.find_first_not_of("0123456789", pos + 1);
+    }
+    if (pos == std::string::npos) {
+        return pos;
+    }
+    std::string length;
+    while (pos < fmt.size() && strchr("hljztL", fmt[pos]) != nullptr) {
+        length += fmt[pos++];
+    }
+    if (pos >= fmt.size()) {
+        return std::string::npos;
+    }
+    static const std::unordered_map<std::string, LogArgType> intTypes = {
+        { "", LogArgType::INT }, { "hh", LogArgType::INT }, { "h", LogArgType::INT },
+        { "l", LogArgType::LONG }, { "ll", LogArgType::LONG_LONG }, { "j", LogArgType::INTMAX },
+        { "z", LogArgType::SIZE }, { "t", LogArgType::PTRDIFF },
+    };
+    char conversion = fmt[pos];
+    if (strchr("diouxXc", conversion) != nullptr) {
+        auto it = intTypes.find(length);
+        if (it == intTypes.end()) {
+            return std::string::npos;
+        }
+        type = it->second;
+    } else if (strchr("eEfFgGaA", conversion) != nullptr) {
+        type = length == "L" ? LogArgType::LONG_DOUBLE : LogArgType::DOUBLE;
+    } else if (conversion == 's' && length.empty()) {
+        type = LogArgType::STRING;
+    } else if (conversion == 'p' && length.empty()) {
+        type = LogArgType::POINTER;
+    } else {
+        // '*' width or precision, '%n' and the others are not supported to be deferred
+        return std::string::npos;
     }
-    std::string temp = "";
+    return pos + 1;
+}
+
+static std::unique_ptr<DfxLogDump::LogFormat> ParseLogFormat(const char *fmt)
+{
+    auto format = std::make_unique<DfxLogDump::LogFormat>();
     std::string fmtStr = fmt;
-    int32_t srcPos = 0;
+    size_t srcPos = 0;
     auto dtsPos = fmtStr.find("{public}", srcPos);
-    const int32_t pubLen = 8;
+    const size_t pubLen = 8;
     while (dtsPos != std::string::npos) {
-        temp += fmtStr.substr(srcPos, dtsPos - srcPos);
-        srcPos = static_cast<int32_t>(dtsPos) + pubLen;
+        format->stripped += fmtStr.substr(srcPos, dtsPos - srcPos);
+        srcPos = dtsPos + pubLen;
         dtsPos = fmtStr.find("{public}", srcPos);
     }
-    temp += fmtStr.substr(srcPos);
+    format->stripped += fmtStr.substr(srcPos);
+
+    const std::string &str = format->stripped;
+    size_t argSize = 0;
+    size_t begin = 0;
+    size_t pos = 0;
+    while ((pos = str.find('%', pos)) != std::string::npos) {
+        if (pos + 1 < str.size() && str[pos + 1] == '%') {
+            pos += 2; // 2: skip "%%"
+            continue;
+        }
+        LogSegment segment;
+        size_t end = ParseConversion(str, pos + 1, segment.type);
+        if (end == std::string::npos) {
+            format->deferrable = false;
+            return format;
+        }
+        segment.fmt = str.substr(begin, end - begin);
+        // the string is saved with a 2 bytes length, the others are saved as 8 bytes
+        argSize += segment.type == LogArgType::STRING ? sizeof(uint16_t) : ARG_SIZE;
+        format->segments.push_back(std::move(segment));
+        begin = end;
+        pos = end;
+    }
+    if (begin < str.size()) {
+        format->segments.push_back({ str.substr(begin), LogArgType::NONE });
+    }
+    format->deferrable = argSize <= RECORD_PAYLOAD_SIZE;
+    return format;
+}
 
+static void PackArgs(const DfxLogDump::LogFormat &format, LogRecord &record, va_list ap)
+{
+    size_t pos = 0;
+    // keep the space for the fixed size args, the strings will be truncated to the left space
+    size_t reserved = 0;
+    for (auto &segment : format.segments) {
+        reserved += segment.type == LogArgType::NONE ? 0 :
+            (segment.type == LogArgType::STRING ? sizeof(uint16_t) : ARG_SIZE);
+    }
+    for (auto &segment : format.segments) {
+        int64_t value = 0;
+        double dValue = 0.0;
+        bool isDouble = false;
+        switch (segment.type) {
+            case LogArgType::NONE:
+                continue;
+            case LogArgType::INT:
+                value = va_arg(ap, int);
+                break;
+            case LogArgType::LONG:
+                value = va_arg(ap, long);
+                break;
+            case LogArgType::LONG_LONG:
+                value = va_arg(ap, long long);
+                break;
+            case LogArgType::INTMAX:
+                value = static_cast<int64_t>(va_arg(ap, intmax_t));
+                break;
+            case LogArgType::SIZE:
+                value = static_cast<int64_t>(va_arg(ap, size_t));
+                break;
+            case LogArgType::PTRDIFF:
+                value = static_cast<int64_t>(va_arg(ap, ptrdiff_t));
+                break;
+            case LogArgType::DOUBLE:
+                dValue = va_arg(ap, double);
+                isDouble = true;
+                break;
+            case LogArgType::LONG_DOUBLE:
+                dValue = static_cast<double>(va_arg(ap, long double));
+                isDouble = true;
+                break;
+            case LogArgType::POINTER:
+                value = static_cast<int64_t>(reinterpret_cast<intptr_t>(va_arg(ap, void *)));
+                break;
+            case LogArgType::STRING: {
+                const char *str = va_arg(ap, const char *);
+                str = str == nullptr ? "(null)" : str;
+                reserved -= sizeof(uint16_t);
+                size_t left = RECORD_PAYLOAD_SIZE - pos - sizeof(uint16_t) - reserved;
+                uint16_t len = static_cast<uint16_t>(strnlen(str, left));
+                (void)memcpy_s(record.payload + pos, sizeof(uint16_t), &len, sizeof(uint16_t));
+                pos += sizeof(uint16_t);
+                if (len > 0) {
+                    (void)memcpy_s(record.payload + pos, RECORD_PAYLOAD_SIZE - pos, str, len);
+                }
+                pos += len;
+                continue;
+            }
+            default:
+                continue;
+        }
+        reserved -= ARG_SIZE;
+        if (isDouble) {
+            (void)memcpy_s(record.payload + pos, ARG_SIZE, &dValue, ARG_SIZE);
+        } else {
+            (void)memcpy_s(record.payload + pos, ARG_SIZE, &value, ARG_SIZE);
+        }
+        pos += ARG_SIZE;
+    }
+}
+
+// the formats are parsed from the code, not the user input
+static int32_t FormatArg(char *buf, size_t size, const char *fmt, ...)
+{
     va_list ap;
     va_start(ap, fmt);
-    constexpr uint8_t maxLogLen = 255;
-    char logBuf[maxLogLen];
-    auto ret = vsnprintf_s(logBuf, maxLogLen, maxLogLen - 1, temp.c_str(), ap);
+    int32_t ret = vsnprintf_s(buf, size, size - 1, fmt, ap);
     va_end(ap);
+    return ret;
+}
+
+static int32_t FormatSegment(char *buf, size_t size, const LogSegment &segment, const uint8_t *arg)
+{
+    const char *fmt = segment.fmt.c_str();
+    if (segment.type == LogArgType::STRING) {
+        uint16_t len = 0;
+        (void)memcpy_s(&len, sizeof(len), arg, sizeof(len));
+        char str[RECORD_PAYLOAD_SIZE + 1] = {};
+        if (len > 0) {
+            (void)memcpy_s(str, RECORD_PAYLOAD_SIZE, arg + sizeof(len), len);
+        }
+        return FormatArg(buf, size, fmt, str);
+    }
+    int64_t value = 0;
+    double dValue = 0.0;
+    if (segment.type == LogArgType::DOUBLE || segment.type == LogArgType::LONG_DOUBLE) {
+        (void)memcpy_s(&dValue, sizeof(dValue), arg, ARG_SIZE);
+    } else if (segment.type != LogArgType::NONE) {
+        (void)memcpy_s(&value, sizeof(value), arg, ARG_SIZE);
+    }
+    switch (segment.type) {
+        case LogArgType::INT:
+            return FormatArg(buf, size, fmt, static_cast<int>(value));
+        case LogArgType::LONG:
+            return FormatArg(buf, size, fmt, static_cast<long>(value));
+        case LogArgType::LONG_LONG:
+            return FormatArg(buf, size, fmt, static_cast<long long>(value));
+        case LogArgType::INTMAX:
+            return FormatArg(buf, size, fmt, static_cast<intmax_t>(value));
+        case LogArgType::SIZE:
+            return FormatArg(buf, size, fmt, static_cast<size_t>(value));
+        case LogArgType::PTRDIFF:
+            return FormatArg(buf, size, fmt, static_cast<ptrdiff_t>(value));
+        case LogArgType::DOUBLE:
+            return FormatArg(buf, size, fmt, dValue);
+        case LogArgType::LONG_DOUBLE:
+            return FormatArg(buf, size, fmt, static_cast<long double>(dValue));
+        case LogArgType::POINTER:
+            return FormatArg(buf, size, fmt, reinterpret_cast<void *>(static_cast<intptr_t>(value)));
+        default:
+            return FormatArg(buf, size, fmt);
+    }
+}
+
+static void FormatRecord(const LogRecord &record, std::string &logStr)
+{
+    if (record.formatted) {
+        logStr += reinterpret_cast<const char *>(record.payload);
+        return;
+    }
+    char logBuf[MAX_LOG_LEN] = {};
+    size_t len = 0;
+    size_t pos = 0;
+    for (auto &segment : record.format->segments) {
+        const uint8_t *arg = record.payload + pos;
+        if (segment.type == LogArgType::STRING) {
+            uint16_t strLen = 0;
+            (void)memcpy_s(&strLen, sizeof(strLen), arg, sizeof(strLen));
+            pos += sizeof(strLen) + strLen;
+        } else if (segment.type != LogArgType::NONE) {
+            pos += ARG_SIZE;
+        }
+        if (FormatSegment(logBuf + len, MAX_LOG_LEN - len, segment, arg) < 0) {
+            // truncated
+            break;
+        }
+        len += strlen(logBuf + len);
+        if (len + 1 >= MAX_LOG_LEN) {
+            break;
+        }
+    }
+    logStr += logBuf;
+}
 
-    AddNewLog(level, label, logString_);
-    if (ret < 0) {
-        logString_ += "dump log error";
+DfxLogDump::ThreadRing *DfxLogDump::GetThreadRing()
+{
+    // the ring is released by the TaskProcessor after the thread exits and the ring is drained
+    thread_local std::shared_ptr<ThreadRing> ring = nullptr;
+    if (ring == nullptr) {
+        ring = std::make_shared<ThreadRing>();
+        std::unique_lock<std::mutex> lock(ringMutex_);
+        rings_.push_back(ring);
+    }
+    return ring.get();
+}
+
+const DfxLogDump::LogFormat *DfxLogDump::GetLogFormat(const char *fmt)
+{
+    // the formats are string literals, cache the parsed formats by the address
+    thread_local std::unordered_map<const char *, const LogFormat *> localFormats;
+    auto it = localFormats.find(fmt);
+    if (it != localFormats.end()) {
+        return it->second;
+    }
+
+    std::unique_lock<std::mutex> lock(formatMutex_);
+    auto &format = formats_[fmt];
+    if (format == nullptr) {
+        format = ParseLogFormat(fmt);
+    }
+    localFormats.emplace(fmt, format.get());
+    return format.get();
+}
+
+void DfxLogDump::SaveLog(const char *level, const OHOS::HiviewDFX::HiLogLabel &label, const char *fmt, ...)
+{
+    if (!isEnable_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    ThreadRing *ring = GetThreadRing();
+    LogRecord *record = ring->BeginWrite();
+    if (record == nullptr) {
+        return;
+    }
+
+    record->format = GetLogFormat(fmt);
+    record->level = level;
+    record->tag = label.tag;
+    record->timeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    va_list ap;
+    va_start(ap, fmt);
+    if (record->format->deferrable) {
+        record->formatted = false;
+        PackArgs(*record->format, *record, ap);
     } else {
-        logString_ += logBuf;
+        record->formatted = true;
+        char *logBuf = reinterpret_cast<char *>(record->payload);
+        if (vsnprintf_s(logBuf, RECORD_PAYLOAD_SIZE, RECORD_PAYLOAD_SIZE - 1,
+            record->format->stripped.c_str(), ap) < 0 && logBuf[0] == '\0') {
+            (void)strcpy_s(logBuf, RECORD_PAYLOAD_SIZE, "dump log error");
+        }
     }
-    logString_ += "\n";
-    lineCount_++;
-    if (lineCount_ >= FILE_LINE_MAX) {
+    va_end(ap);
+
+    if (ring->EndWrite() == RING_WAKE_THRESHOLD) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        pending_.store(true, std::memory_order_relaxed);
         cond_.notify_all();
     }
 }
 
+int32_t DfxLogDump::DrainRings(std::string &logStr)
+{
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    {
+        std::unique_lock<std::mutex> lock(ringMutex_);
+        rings = rings_;
+    }
+
+    int32_t lineCount = 0;
+    for (auto &ring : rings) {
+        // only drain the records written before, the producer may keep writing
+        for (uint32_t i = 0; i < RING_SLOT_COUNT; i++) {
+            const LogRecord *record = ring->Front();
+            if (record == nullptr) {
+                break;
+            }
+            AddNewLog(*record, ring->GetTid(), logStr);
+            FormatRecord(*record, logStr);
+            logStr += "\n";
+            ring->Pop();
+            lineCount++;
+        }
+        uint64_t dropped = ring->TakeDropped();
+        if (dropped > 0) {
+            logStr += "tid:" + std::to_string(ring->GetTid()) + " dropped " + std::to_string(dropped) + " logs\n";
+            lineCount++;
+        }
+    }
+    rings.clear();
+
+    std::unique_lock<std::mutex> lock(ringMutex_);
+    for (auto it = rings_.begin(); it != rings_.end();) {
+        // the owner thread has exited
+        if (it->use_count() == 1 && (*it)->Empty()) {
+            it = rings_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return lineCount;
+}
+
 void DfxLogDump::UpdateCheckEnable()
 {
     std::string file = "/data/media/log/check.config";
     std::ofstream ofStream(file);
     if (!ofStream.is_open()) {
-        isEnable_ = false;
+        isEnable_.store(false);
         return;
     }
     ofStream.close();
-    isEnable_ = true;
+    isEnable_.store(true);
 }
 
 void DfxLogDump::TaskProcessor()
 {
+    auto lastCheckTime = std::chrono::steady_clock::now();
+    UpdateCheckEnable();
     while (true) {
-        std::string temp;
-        int32_t lineCount = 0;
         {
             std::unique_lock<std::mutex> lock(mutex_);
             if (isExit_) {
                 return;
             }
-            static constexpr int32_t timeout = 60; // every 1 minute have a log
-            cond_.wait_for(lock, std::chrono::seconds(timeout),
-                [this] {
-                    UpdateCheckEnable();
-                    return isExit_ || isDump_ || lineCount_ >= FILE_LINE_MAX || !logString_.empty();
-            });
+            cond_.wait_for(lock, std::chrono::milliseconds(DRAIN_INTERVAL_MS),
+                [this] { return isExit_ || isDump_ || pending_.load(std::memory_order_relaxed); });
+            if (isExit_) {
+                return;
+            }
             isDump_ = false;
-            lineCount = lineCount_;
-            lineCount_ = lineCount_ >= FILE_LINE_MAX ? 0 : lineCount_;
-            swap(logString_, temp);
+            // cleared before draining, a ring filled again meanwhile wakes the next round
+            pending_.store(false, std::memory_order_relaxed);
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastCheckTime >= std::chrono::seconds(CHECK_ENABLE_INTERVAL_S)) {
+            UpdateCheckEnable();
+            lastCheckTime = now;
+        }
+
+        std::string temp;
+        lineCount_ += DrainRings(temp);
+        if (temp.empty()) {
+            continue;
         }
+        int32_t lineCount = lineCount_;
+        lineCount_ = lineCount_ >= FILE_LINE_MAX ? 0 : lineCount_;
 
         std::string file = "/data/media/log/";
         file += std::to_string(getpid());
@@ -179,4 +612,4 @@ void DfxLogDump::TaskProcessor()
     }
 }
 } // namespace Media
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
@@ -12,38 +12,60 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+
 #ifndef DFX_LOG_DUMP_H
 #define DFX_LOG_DUMP_H
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <hilog/log.h>
 #include <thread>
 #include <mutex>
 
 namespace OHOS {
 namespace Media {
+/**
+ * The logs are saved as binary records into the ring of the calling thread, and formatted
+ * and written to the file by the TaskProcessor thread. The producers never block, the logs
+ * will be dropped and counted if the ring is full.
+ */
 class __attribute__((visibility("default"))) DfxLogDump {
 public:
     static DfxLogDump &GetInstance();
     void SaveLog(const char *level, const OHOS::HiviewDFX::HiLogLabel &label, const char *fmt, ...);
     void DumpLog();
+
+    struct LogFormat;
+    class ThreadRing;
 private:
     DfxLogDump();
     ~DfxLogDump();
     void UpdateCheckEnable();
+    ThreadRing *GetThreadRing();
+    const LogFormat *GetLogFormat(const char *fmt);
+    int32_t DrainRings(std::string &logStr);
     int32_t fileCount_ = 0;
     int32_t lineCount_ = 0;
     std::unique_ptr<std::thread> thread_;
     void TaskProcessor();
     std::mutex mutex_;
     std::condition_variable cond_;
-    std::string logString_;
+    std::mutex ringMutex_;
+    std::vector<std::shared_ptr<ThreadRing>> rings_;
+    std::mutex formatMutex_;
+    std::unordered_map<const char *, std::unique_ptr<LogFormat>> formats_;
     bool isDump_ = false;
     bool isExit_ = false;
-    bool isEnable_ = false;
+    // a ring is half full, set under the mutex_ so that the wakeup is not lost
+    std::atomic<bool> pending_ = false;
+    std::atomic<bool> isEnable_ = false;
     bool isNewFile_ = true;
 };
 } // namespace Media
 } // namespace OHOS
 
-#endif
\ No newline at end of file
+#endif
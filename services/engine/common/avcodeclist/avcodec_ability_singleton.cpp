@@ -66,6 +66,7 @@ bool AVCodecAbilitySingleton::ParseCodecXml()
     std::vector<CapabilityData> data = xmlParser.GetCapabilityDataArray();
     capabilityDataArray_.insert(capabilityDataArray_.end(), data.begin(), data.end());
     isParsered_ = true;
+    OnCapabilityChanged();
     return true;
 }
 
@@ -74,6 +75,7 @@ bool AVCodecAbilitySingleton::RegisterCapability(const std::vector<CapabilityDat
     std::lock_guard<std::mutex> lock(mutex_);
     capabilityDataArray_.insert(capabilityDataArray_.begin() + hdiCapLen_, registerCapabilityDataArray.begin(),
         registerCapabilityDataArray.end());
+    OnCapabilityChanged();
     MEDIA_LOGD("RegisterCapability success");
     return true;
 }
@@ -84,6 +86,7 @@ bool AVCodecAbilitySingleton::RegisterHdiCapability(const std::vector<Capability
     capabilityDataArray_.insert(capabilityDataArray_.begin(), registerCapabilityDataArray.begin(),
         registerCapabilityDataArray.end());
     hdiCapLen_ = registerCapabilityDataArray.size();
+    OnCapabilityChanged();
     MEDIA_LOGD("RegisterCapability success");
     return true;
 }
@@ -99,5 +102,25 @@ std::vector<CapabilityData> AVCodecAbilitySingleton::GetCapabilityDataArray()
     std::lock_guard<std::mutex> lock(mutex_);
     return capabilityDataArray_;
 }
+
+std::shared_ptr<const AVCodecCapabilityIndex> AVCodecAbilitySingleton::GetCapabilityIndex()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capabilityIndex_ == nullptr) {
+        std::vector<CapabilityData> capabilityDataArray = capabilityDataArray_;
+        capabilityIndex_ = std::make_shared<AVCodecCapabilityIndex>(std::move(capabilityDataArray),
+            capabilityVersion_);
+    }
+    return capabilityIndex_;
+}
+
+void AVCodecAbilitySingleton::OnCapabilityChanged()
+{
+    capabilityIndex_ = nullptr;
+    capabilityVersion_++;
+    if (capabilityVersion_ == 0) {
+        capabilityVersion_++;
+    }
+}
 } // namespace Media
 } // namespace OHOS
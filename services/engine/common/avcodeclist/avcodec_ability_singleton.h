@@ -16,9 +16,11 @@
 #ifndef AVCODEABILITY_SINGLETON_H
 #define AVCODEABILITY_SINGLETON_H
 
+#include <memory>
 #include <mutex>
 #include "format.h"
 #include "avcodec_info.h"
+#include "avcodec_capability_index.h"
 namespace OHOS {
 namespace Media {
 class __attribute__((visibility("default"))) AVCodecAbilitySingleton : public NoCopyable {
@@ -30,12 +32,17 @@ public:
     bool RegisterHdiCapability(const std::vector<CapabilityData> &registerCapabilityDataArray);
     bool IsParsered();
     std::vector<CapabilityData> GetCapabilityDataArray();
+    std::shared_ptr<const AVCodecCapabilityIndex> GetCapabilityIndex();
 
 private:
     bool isParsered_ = false;
     int32_t hdiCapLen_ = 0;
     AVCodecAbilitySingleton();
+    void OnCapabilityChanged();
     std::vector<CapabilityData> capabilityDataArray_;
+    // built lazily after the capabilities are changed, and shared by the queries until the next change
+    std::shared_ptr<const AVCodecCapabilityIndex> capabilityIndex_ = nullptr;
+    uint32_t capabilityVersion_ = 0;
     std::mutex mutex_;
 };
 } // namespace Media
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avcodec_capability_index.h"
+#include <algorithm>
+#include <cmath>
+#include "media_log.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVCodecCapabilityIndex"};
+    constexpr double EPSINON = 0.0001;
+}
+
+namespace OHOS {
+namespace Media {
+// the format keys are parsed once per query rather than once per candidate
+struct AVCodecCapabilityIndex::CodecQuery {
+    AVCodecType codecType = AVCODEC_TYPE_NONE;
+    bool hasBitrate = false;
+    int32_t bitrate = 0;
+    bool hasSize = false;
+    int32_t width = 0;
+    int32_t height = 0;
+    bool hasPixelFormat = false;
+    int32_t pixelFormat = 0;
+    FormatDataType frameRateType = FORMAT_TYPE_NONE;
+    int32_t frameRateInt = 0;
+    double frameRateDouble = 0.0;
+    bool hasChannel = false;
+    int32_t channel = 0;
+    bool hasSampleRate = false;
+    int32_t sampleRate = 0;
+};
+
+AVCodecCapabilityIndex::AVCodecCapabilityIndex(std::vector<CapabilityData> &&capabilityDataArray, uint32_t version)
+    : capabilityDataArray_(std::move(capabilityDataArray)), version_(version)
+{
+    for (size_t pos = 0; pos < capabilityDataArray_.size(); pos++) {
+        const CapabilityData &data = capabilityDataArray_[pos];
+        buckets_[std::make_pair(data.codecType, data.mimeType)].push_back(pos);
+    }
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create, version %{public}u, %{public}zu capabilities, "
+        "%{public}zu buckets", FAKE_POINTER(this), version_, capabilityDataArray_.size(), buckets_.size());
+}
+
+AVCodecCapabilityIndex::~AVCodecCapabilityIndex()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+void AVCodecCapabilityIndex::ParseQuery(const Format &format, CodecQuery &query)
+{
+    query.hasBitrate = format.GetIntValue("bitrate", query.bitrate);
+    query.hasSize = format.GetIntValue("width", query.width) && format.GetIntValue("height", query.height);
+    query.hasPixelFormat = format.GetIntValue("pixel_format", query.pixelFormat);
+    query.frameRateType = format.GetValueType(std::string_view("frame_rate"));
+    if (query.frameRateType == FORMAT_TYPE_INT32) {
+        (void)format.GetIntValue("frame_rate", query.frameRateInt);
+    } else if (query.frameRateType == FORMAT_TYPE_DOUBLE) {
+        (void)format.GetDoubleValue("frame_rate", query.frameRateDouble);
+    }
+    query.hasChannel = format.GetIntValue("channel_count", query.channel);
+    query.hasSampleRate = format.GetIntValue("samplerate", query.sampleRate);
+}
+
+bool AVCodecCapabilityIndex::IsSupport(const CodecQuery &query, const CapabilityData &data)
+{
+    if (query.hasBitrate && (data.bitrate.minVal > query.bitrate || data.bitrate.maxVal < query.bitrate)) {
+        return false;
+    }
+    if (query.hasSize && (data.width.minVal > query.width || data.width.maxVal < query.width ||
+        data.height.minVal > query.height || data.height.maxVal < query.height)) {
+        return false;
+    }
+    if (query.frameRateType == FORMAT_TYPE_INT32 &&
+        (data.frameRate.minVal > query.frameRateInt || data.frameRate.maxVal < query.frameRateInt)) {
+        return false;
+    }
+    if (query.frameRateType == FORMAT_TYPE_DOUBLE) {
+        double minVal = static_cast<double>(data.frameRate.minVal);
+        double maxVal = static_cast<double>(data.frameRate.maxVal);
+        if ((minVal > query.frameRateDouble && fabs(minVal - query.frameRateDouble) >= EPSINON) ||
+            (maxVal < query.frameRateDouble && fabs(maxVal - query.frameRateDouble) >= EPSINON)) {
+            return false;
+        }
+    }
+
+    bool isAudio = query.codecType == AVCODEC_TYPE_AUDIO_ENCODER || query.codecType == AVCODEC_TYPE_AUDIO_DECODER;
+    if (!isAudio) {
+        return !query.hasPixelFormat ||
+            std::find(data.format.begin(), data.format.end(), query.pixelFormat) != data.format.end();
+    }
+    if (query.hasChannel && (data.channels.minVal > query.channel || data.channels.maxVal < query.channel)) {
+        return false;
+    }
+    return !query.hasSampleRate ||
+        std::find(data.sampleRate.begin(), data.sampleRate.end(), query.sampleRate) != data.sampleRate.end();
+}
+
+std::string AVCodecCapabilityIndex::FindCodec(const Format &format, AVCodecType codecType) const
+{
+    std::string mimeType;
+    if (!format.GetStringValue("codec_mime", mimeType)) {
+        MEDIA_LOGD("Get MimeType from format failed");
+        return "";
+    }
+
+    auto bucket = buckets_.find(std::make_pair(static_cast<int32_t>(codecType), mimeType));
+    if (bucket == buckets_.end()) {
+        return "";
+    }
+
+    CodecQuery query;
+    query.codecType = codecType;
+    ParseQuery(format, query);
+    for (size_t pos : bucket->second) {
+        if (IsSupport(query, capabilityDataArray_[pos])) {
+            return capabilityDataArray_[pos].codecName;
+        }
+    }
+    return "";
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVCODEC_CAPABILITY_INDEX_H
+#define AVCODEC_CAPABILITY_INDEX_H
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "avcodec_info.h"
+#include "format.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * The immutable view of the registered codec capabilities. The capabilities are bucketed by the codec type
+ * and the mime type, so a query only visits the candidates which could match. The version is increased by
+ * the owner every time the capabilities are changed, it is never 0.
+ */
+class AVCodecCapabilityIndex : public NoCopyable {
+public:
+    AVCodecCapabilityIndex(std::vector<CapabilityData> &&capabilityDataArray, uint32_t version);
+    ~AVCodecCapabilityIndex();
+
+    /**
+     * Find the first codec which supports the format, in the order of the registered capabilities.
+     * @return the codec name, or empty string if not found.
+     */
+    std::string FindCodec(const Format &format, AVCodecType codecType) const;
+
+    const std::vector<CapabilityData> &GetCapabilityDataArray() const
+    {
+        return capabilityDataArray_;
+    }
+
+    uint32_t GetVersion() const
+    {
+        return version_;
+    }
+
+private:
+    struct CodecQuery;
+    static void ParseQuery(const Format &format, CodecQuery &query);
+    static bool IsSupport(const CodecQuery &query, const CapabilityData &data);
+
+    const std::vector<CapabilityData> capabilityDataArray_;
+    const uint32_t version_;
+    // (codecType, mimeType) to the ascending positions in capabilityDataArray_
+    std::map<std::pair<int32_t, std::string>, std::vector<size_t>> buckets_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVCODEC_CAPABILITY_INDEX_H
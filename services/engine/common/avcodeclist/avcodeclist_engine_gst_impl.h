@@ -31,17 +31,10 @@ public:
     std::string FindAudioDecoder(const Format &format) override;
     std::string FindAudioEncoder(const Format &format) override;
     std::vector<CapabilityData> GetCodecCapabilityInfos() override;
+    std::shared_ptr<const AVCodecCapabilityIndex> GetCapabilityIndex() override;
 
 private:
-    std::string FindTargetCodec(const Format &format,
-    const std::vector<CapabilityData> &capabilityDataArray, const AVCodecType &codecType);
-    bool IsSupportMimeType(const Format &format, const CapabilityData &data);
-    bool IsSupportBitrate(const Format &format, const CapabilityData &data);
-    bool IsSupportSize(const Format &format, const CapabilityData &data);
-    bool IsSupportPixelFormat(const Format &format, const CapabilityData &data);
-    bool IsSupportFrameRate(const Format &format, const CapabilityData &data);
-    bool IsSupportSampleRate(const Format &format, const CapabilityData &data);
-    bool IsSupportChannel(const Format &format, const CapabilityData &data);
+    std::string FindTargetCodec(const Format &format, const AVCodecType &codecType);
     std::mutex mutex_;
 };
 } // namespace Media
@@ -43,30 +43,19 @@ int32_t AVCodecEngineCtrl::Init(AVCodecType type, bool useSoftware, const std::s
     MEDIA_LOGD("Enter Init");
     codecType_ = type;
     isUseSoftWare_ = useSoftware;
-    gstPipeline_ = GST_PIPELINE_CAST(gst_object_ref_sink(gst_pipeline_new("codec-pipeline")));
-    CHECK_AND_RETURN_RET(gstPipeline_ != nullptr, MSERR_NO_MEMORY);
+    poolKey_ = { type, useSoftware, name };
 
-    bus_ = gst_pipeline_get_bus(gstPipeline_);
-    CHECK_AND_RETURN_RET(bus_ != nullptr, MSERR_UNKNOWN);
+    CodecPipeline pipeline;
+    if (!AVCodecPipelinePool::GetInstance().Acquire(poolKey_, pipeline)) {
+        int32_t ret = AVCodecPipelinePool::Build(poolKey_, pipeline);
+        CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+    }
+    gstPipeline_ = pipeline.pipeline;
+    bus_ = pipeline.bus;
+    codecBin_ = pipeline.codecBin;
     gst_bus_set_sync_handler(bus_, BusSyncHandler, this, nullptr);
 
-    codecBin_ = GST_ELEMENT_CAST(gst_object_ref_sink(gst_element_factory_make("codecbin", "the_codec_bin")));
-    CHECK_AND_RETURN_RET(codecBin_ != nullptr, MSERR_NO_MEMORY);
-
-    gboolean ret = gst_bin_add(GST_BIN_CAST(gstPipeline_), codecBin_);
-    CHECK_AND_RETURN_RET(ret == TRUE, MSERR_NO_MEMORY);
-
-    g_object_set(codecBin_, "use-software", static_cast<gboolean>(useSoftware), nullptr);
-    g_object_set(codecBin_, "type", static_cast<int32_t>(type), nullptr);
-    g_object_set(codecBin_, "coder-name", name.c_str(), nullptr);
-
     isEncoder_ = (type == AVCODEC_TYPE_VIDEO_ENCODER) || (type == AVCODEC_TYPE_AUDIO_ENCODER);
-    if (isEncoder_) {
-        g_object_set(codecBin_, "src-convert", static_cast<gboolean>(true), nullptr);
-    } else {
-        g_object_set(codecBin_, "sink-convert", static_cast<gboolean>(true), nullptr);
-    }
-
     return MSERR_OK;
 }
 
@@ -202,25 +191,26 @@ int32_t AVCodecEngineCtrl::NotifyEos()
 
 int32_t AVCodecEngineCtrl::Release()
 {
+    CodecPipeline pipeline = { gstPipeline_, bus_, codecBin_ };
+    bool recycled = false;
     if (gstPipeline_ != nullptr) {
         CHECK_AND_RETURN_RET(Stop() == MSERR_OK, MSERR_UNKNOWN);
-        (void)gst_element_set_state(GST_ELEMENT_CAST(gstPipeline_), GST_STATE_NULL);
+        gst_bus_set_sync_handler(bus_, nullptr, nullptr, nullptr);
+        // reset while the src and sink are alive, the codecbin drops its references to them
+        recycled = AVCodecPipelinePool::GetInstance().Recycle(poolKey_, pipeline);
+        if (!recycled) {
+            (void)gst_element_set_state(GST_ELEMENT_CAST(gstPipeline_), GST_STATE_NULL);
+        }
     }
 
     src_ = nullptr;
     sink_ = nullptr;
-    if (codecBin_ != nullptr) {
-        gst_object_unref(codecBin_);
-        codecBin_ = nullptr;
-    }
-    if (gstPipeline_ != nullptr) {
-        gst_object_unref(gstPipeline_);
-        gstPipeline_ = nullptr;
-    }
-    if (bus_ != nullptr) {
-        g_clear_object(&bus_);
-        bus_ = nullptr;
+    if (!recycled) {
+        AVCodecPipelinePool::Destroy(pipeline);
     }
+    gstPipeline_ = nullptr;
+    bus_ = nullptr;
+    codecBin_ = nullptr;
 
     MEDIA_LOGD("Release success");
     return MSERR_OK;
@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <mutex>
 #include "avcodec_engine_factory.h"
+#include "avcodec_pipeline_pool.h"
 #include "i_avcodec_engine.h"
 #include "nocopyable.h"
 
@@ -66,6 +67,7 @@ private:
     bool flushAtStart_ = false;
     bool isStart_ = false;
     bool isUseSoftWare_ = false;
+    CodecPipelineKey poolKey_;
 };
 } // namespace Media
 } // namespace OHOS
@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avcodec_pipeline_pool.h"
+#include <algorithm>
+#include <vector>
+#include "media_errors.h"
+#include "media_log.h"
+#include "param_wrapper.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVCodecPipelinePool"};
+    constexpr int32_t MAX_POOL_CAPACITY = 8;
+    constexpr int64_t IDLE_TIMEOUT_US = 30000000; // 30s
+    // below the max delay of the TaskQueue, the idle pipelines are checked again until they are evicted
+    constexpr int64_t EVICT_CHECK_INTERVAL_US = 5000000; // 5s
+}
+
+namespace OHOS {
+namespace Media {
+AVCodecPipelinePool &AVCodecPipelinePool::GetInstance()
+{
+    // never destroyed: the warm task may still be running when static destructors run
+    static AVCodecPipelinePool *instance = new AVCodecPipelinePool();
+    return *instance;
+}
+
+AVCodecPipelinePool::AVCodecPipelinePool()
+    : AVCodecPipelinePool(static_cast<uint32_t>(std::clamp(
+        OHOS::system::GetIntParameter("sys.media.codec.pool.capacity", 0), 0, MAX_POOL_CAPACITY)),
+        IDLE_TIMEOUT_US, &AVCodecPipelinePool::Build)
+{
+}
+
+AVCodecPipelinePool::AVCodecPipelinePool(uint32_t capacity, int64_t idleTimeoutUs, const Builder &builder)
+    : capacity_(capacity), idleTimeoutUs_(idleTimeoutUs), builder_(builder),
+      taskQue_("codec_warm_pool", TaskPriority::LOW)
+{
+    hitHandle_ = MediaMetrics::Inst().RegisterCounter("avcodec.pool.hit");
+    missHandle_ = MediaMetrics::Inst().RegisterCounter("avcodec.pool.miss");
+    evictHandle_ = MediaMetrics::Inst().RegisterCounter("avcodec.pool.evict");
+    recycleHandle_ = MediaMetrics::Inst().RegisterCounter("avcodec.pool.recycle");
+    sizeHandle_ = MediaMetrics::Inst().RegisterGauge("avcodec.pool.size");
+    if (capacity_ > 0) {
+        (void)taskQue_.Start();
+    }
+    MEDIA_LOGI("codec pipeline pool capacity: %{public}u", capacity_);
+}
+
+AVCodecPipelinePool::~AVCodecPipelinePool()
+{
+    (void)taskQue_.Stop();
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto &[key, pooled] : pipelines_) {
+        (void)key;
+        for (auto &item : pooled) {
+            Destroy(item.pipeline);
+        }
+    }
+    pipelines_.clear();
+    UpdateSizeLocked();
+}
+
+int32_t AVCodecPipelinePool::Build(const CodecPipelineKey &key, CodecPipeline &pipeline)
+{
+    CodecPipeline result;
+    result.pipeline = GST_PIPELINE_CAST(gst_object_ref_sink(gst_pipeline_new("codec-pipeline")));
+    CHECK_AND_RETURN_RET(result.pipeline != nullptr, MSERR_NO_MEMORY);
+
+    result.bus = gst_pipeline_get_bus(result.pipeline);
+    if (result.bus == nullptr) {
+        Destroy(result);
+        return MSERR_UNKNOWN;
+    }
+
+    result.codecBin = GST_ELEMENT_CAST(gst_object_ref_sink(gst_element_factory_make("codecbin", "the_codec_bin")));
+    if (result.codecBin == nullptr || gst_bin_add(GST_BIN_CAST(result.pipeline), result.codecBin) != TRUE) {
+        Destroy(result);
+        return MSERR_NO_MEMORY;
+    }
+
+    g_object_set(result.codecBin, "use-software", static_cast<gboolean>(key.useSoftware), nullptr);
+    g_object_set(result.codecBin, "type", static_cast<int32_t>(key.type), nullptr);
+    g_object_set(result.codecBin, "coder-name", key.name.c_str(), nullptr);
+
+    bool isEncoder = (key.type == AVCODEC_TYPE_VIDEO_ENCODER) || (key.type == AVCODEC_TYPE_AUDIO_ENCODER);
+    if (isEncoder) {
+        g_object_set(result.codecBin, "src-convert", static_cast<gboolean>(true), nullptr);
+    } else {
+        g_object_set(result.codecBin, "sink-convert", static_cast<gboolean>(true), nullptr);
+    }
+
+    pipeline = result;
+    return MSERR_OK;
+}
+
+void AVCodecPipelinePool::Destroy(CodecPipeline &pipeline)
+{
+    if (pipeline.pipeline != nullptr) {
+        (void)gst_element_set_state(GST_ELEMENT_CAST(pipeline.pipeline), GST_STATE_NULL);
+    }
+    if (pipeline.codecBin != nullptr) {
+        gst_object_unref(pipeline.codecBin);
+        pipeline.codecBin = nullptr;
+    }
+    if (pipeline.pipeline != nullptr) {
+        gst_object_unref(pipeline.pipeline);
+        pipeline.pipeline = nullptr;
+    }
+    if (pipeline.bus != nullptr) {
+        g_clear_object(&pipeline.bus);
+    }
+}
+
+bool AVCodecPipelinePool::Acquire(const CodecPipelineKey &key, CodecPipeline &pipeline)
+{
+    if (capacity_ == 0) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto iter = pipelines_.find(key);
+    if (iter == pipelines_.end() || iter->second.empty()) {
+        MediaMetrics::Inst().Add(missHandle_);
+        MEDIA_LOGD("pool miss: %{public}s", key.name.c_str());
+        return false;
+    }
+
+    // the most recently pooled one, older ones are the first to be evicted
+    pipeline = iter->second.back().pipeline;
+    iter->second.pop_back();
+    if (iter->second.empty()) {
+        pipelines_.erase(iter);
+    }
+    UpdateSizeLocked();
+    lock.unlock();
+
+    // drop the messages of the warm up or of the last session, nobody was listening
+    gst_bus_set_flushing(pipeline.bus, TRUE);
+    gst_bus_set_flushing(pipeline.bus, FALSE);
+    MediaMetrics::Inst().Add(hitHandle_);
+    MEDIA_LOGD("pool hit: %{public}s", key.name.c_str());
+    return true;
+}
+
+bool AVCodecPipelinePool::Recycle(const CodecPipelineKey &key, CodecPipeline &pipeline)
+{
+    if (capacity_ == 0 || pipeline.pipeline == nullptr) {
+        return false;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        CHECK_AND_RETURN_RET(size_ < capacity_, false);
+    }
+
+    // the streaming stops in PAUSED to READY, the coder stays opened
+    GstStateChangeReturn ret = gst_element_set_state(GST_ELEMENT_CAST(pipeline.pipeline), GST_STATE_READY);
+    if (ret == GST_STATE_CHANGE_FAILURE) {
+        MEDIA_LOGW("failed to reset %{public}s, warm a new one", key.name.c_str());
+        auto task = std::make_shared<TaskHandler<void>>([this, key] { Warm(key); });
+        CHECK_AND_RETURN_RET_LOG(taskQue_.EnqueueTask(task) == MSERR_OK, false,
+            "failed to queue the warm up of %{public}s", key.name.c_str());
+        return false;
+    }
+    if (pipeline.codecBin != nullptr) {
+        g_object_set(pipeline.codecBin, "reset", static_cast<gboolean>(true), nullptr);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        CHECK_AND_RETURN_RET(PushLocked(key, pipeline), false);
+    }
+    pipeline = CodecPipeline();
+    MediaMetrics::Inst().Add(recycleHandle_);
+    MEDIA_LOGD("recycled %{public}s", key.name.c_str());
+    return true;
+}
+
+uint32_t AVCodecPipelinePool::GetSize()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return size_;
+}
+
+void AVCodecPipelinePool::Warm(const CodecPipelineKey &key)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        CHECK_AND_RETURN(size_ < capacity_);
+    }
+
+    CodecPipeline pipeline;
+    CHECK_AND_RETURN_LOG(builder_(key, pipeline) == MSERR_OK, "failed to build %{public}s", key.name.c_str());
+    GstStateChangeReturn ret = gst_element_set_state(GST_ELEMENT_CAST(pipeline.pipeline), GST_STATE_READY);
+    if (ret == GST_STATE_CHANGE_FAILURE) {
+        MEDIA_LOGW("failed to warm %{public}s", key.name.c_str());
+        Destroy(pipeline);
+        return;
+    }
+
+    bool pushed = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        pushed = PushLocked(key, pipeline);
+    }
+    if (!pushed) {
+        Destroy(pipeline);
+        return;
+    }
+    MEDIA_LOGD("warmed %{public}s", key.name.c_str());
+}
+
+bool AVCodecPipelinePool::PushLocked(const CodecPipelineKey &key, const CodecPipeline &pipeline)
+{
+    if (size_ >= capacity_) {
+        return false;
+    }
+    pipelines_[key].push_back({ pipeline, MediaMetrics::GetTimeUs() });
+    UpdateSizeLocked();
+    ScheduleEvictLocked();
+    return true;
+}
+
+void AVCodecPipelinePool::ScheduleEvictLocked()
+{
+    if (evictScheduled_ || size_ == 0) {
+        return;
+    }
+
+    auto task = std::make_shared<TaskHandler<void>>([this] { EvictIdle(); });
+    int64_t delayUs = std::min(idleTimeoutUs_, EVICT_CHECK_INTERVAL_US);
+    int32_t ret = taskQue_.EnqueueTask(task, false, static_cast<uint64_t>(delayUs));
+    CHECK_AND_RETURN_LOG(ret == MSERR_OK, "failed to schedule the eviction of idle pipelines");
+    evictScheduled_ = true;
+}
+
+void AVCodecPipelinePool::EvictIdle()
+{
+    std::vector<CodecPipeline> evicted;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        evictScheduled_ = false;
+        int64_t nowUs = MediaMetrics::GetTimeUs();
+        for (auto iter = pipelines_.begin(); iter != pipelines_.end();) {
+            auto &pooled = iter->second;
+            while (!pooled.empty() && nowUs - pooled.front().idleSinceUs >= idleTimeoutUs_) {
+                evicted.push_back(pooled.front().pipeline);
+                pooled.pop_front();
+            }
+            iter = pooled.empty() ? pipelines_.erase(iter) : std::next(iter);
+        }
+        UpdateSizeLocked();
+        ScheduleEvictLocked();
+    }
+
+    for (auto &pipeline : evicted) {
+        Destroy(pipeline);
+    }
+    if (!evicted.empty()) {
+        MediaMetrics::Inst().Add(evictHandle_, static_cast<int64_t>(evicted.size()));
+        MEDIA_LOGD("evicted %{public}zu idle pipelines", evicted.size());
+    }
+}
+
+void AVCodecPipelinePool::UpdateSizeLocked()
+{
+    uint32_t size = 0;
+    for (auto &[key, pooled] : pipelines_) {
+        (void)key;
+        size += static_cast<uint32_t>(pooled.size());
+    }
+    size_ = size;
+    MediaMetrics::Inst().Set(sizeHandle_, static_cast<int64_t>(size_));
+}
+} // namespace Media
+} // namespace OHOS
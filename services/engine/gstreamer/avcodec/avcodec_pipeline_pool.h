@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVCODEC_PIPELINE_POOL_H
+#define AVCODEC_PIPELINE_POOL_H
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <gst/gst.h>
+#include "avcodec_info.h"
+#include "media_metrics.h"
+#include "nocopyable.h"
+#include "task_queue.h"
+
+namespace OHOS {
+namespace Media {
+struct CodecPipelineKey {
+    AVCodecType type = AVCODEC_TYPE_VIDEO_ENCODER;
+    bool useSoftware = false;
+    // the plugin name of the coder, which already tells the mime and the software or hardware variant
+    std::string name;
+
+    bool operator<(const CodecPipelineKey &rhs) const
+    {
+        if (type != rhs.type) {
+            return type < rhs.type;
+        }
+        if (useSoftware != rhs.useSoftware) {
+            return useSoftware < rhs.useSoftware;
+        }
+        return name < rhs.name;
+    }
+};
+
+struct CodecPipeline {
+    GstPipeline *pipeline = nullptr;
+    GstBus *bus = nullptr;
+    GstElement *codecBin = nullptr;
+};
+
+/**
+ * Opt-in pool of codec pipelines kept in READY, so that AVCodecEngineCtrl::Init gets a coder element
+ * which is already created and opened, the codecbin opens its coder in NULL to READY.
+ *
+ * A released pipeline is taken back at READY and reset: the src and sink of its session are removed
+ * and the opened coder is kept for the next Init of the same key. The pool is disabled unless
+ * "sys.media.codec.pool.capacity" is set, because a pooled hardware pipeline keeps holding a codec
+ * instance. For the same reason a pipeline left idle for the idle timeout is destroyed.
+ */
+class AVCodecPipelinePool : public NoCopyable {
+public:
+    using Builder = std::function<int32_t(const CodecPipelineKey &key, CodecPipeline &pipeline)>;
+
+    // the pool shared by the engines, its capacity is read from the system parameter
+    static AVCodecPipelinePool &GetInstance();
+    AVCodecPipelinePool(uint32_t capacity, int64_t idleTimeoutUs, const Builder &builder);
+    ~AVCodecPipelinePool();
+
+    // build a pipeline in NULL state, the surface or buffer mode is chosen later in Prepare
+    static int32_t Build(const CodecPipelineKey &key, CodecPipeline &pipeline);
+    static void Destroy(CodecPipeline &pipeline);
+
+    // take a warm pipeline of the key, returns false if there is none
+    bool Acquire(const CodecPipelineKey &key, CodecPipeline &pipeline);
+    // take back a released pipeline and reset it for the next Init of the key, returns false if it is
+    // not kept and the caller destroys it. A pipeline that fails to reset is replaced in the background
+    bool Recycle(const CodecPipelineKey &key, CodecPipeline &pipeline);
+    uint32_t GetSize();
+
+private:
+    struct PooledPipeline {
+        CodecPipeline pipeline;
+        int64_t idleSinceUs = 0;
+    };
+
+    AVCodecPipelinePool();
+    void Warm(const CodecPipelineKey &key);
+    bool PushLocked(const CodecPipelineKey &key, const CodecPipeline &pipeline);
+    void EvictIdle();
+    void ScheduleEvictLocked();
+    void UpdateSizeLocked();
+
+    std::mutex mutex_;
+    std::map<CodecPipelineKey, std::list<PooledPipeline>> pipelines_;
+    uint32_t capacity_ = 0;
+    uint32_t size_ = 0;
+    int64_t idleTimeoutUs_ = 0;
+    Builder builder_;
+    // an eviction check is queued, it queues the next one while any pipeline is idle
+    bool evictScheduled_ = false;
+    TaskQueue taskQue_;
+    MetricHandle hitHandle_;
+    MetricHandle missHandle_;
+    MetricHandle evictHandle_;
+    MetricHandle recycleHandle_;
+    MetricHandle sizeHandle_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVCODEC_PIPELINE_POOL_H
@@ -169,7 +169,7 @@ bool AVMetaElemMetaCollector::IsMetaCollected()
         if (!trackInfo.valid) {
             continue;
         }
-        if (trackInfo.innerMeta.GetFormatMap().empty()) {
+        if (trackInfo.innerMeta.GetKeys().empty()) {
             return false;
         }
     }
@@ -21,11 +21,12 @@
 #include "gst_utils.h"
 #include "gst_shmem_memory.h"
 #include "scope_guard.h"
-#include "time_perf.h"
+#include "media_metrics.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetaFrameConv"};
     static constexpr int32_t KEEP_ORIGINAL_WIDTH_OR_HEIGHT = -1;
+    static constexpr uint32_t DEFAULT_POOL_CAPACITY = 5;
 }
 
 namespace OHOS {
@@ -51,10 +52,9 @@ AVMetaFrameConverter::~AVMetaFrameConverter()
 {
     MEDIA_LOGD("enter dtor, instance: 0x%{public}06" PRIXPTR "", FAKE_POINTER(this));
     (void)Reset();
-    CLEAN_PERF_RECORD(this);
 }
 
-int32_t AVMetaFrameConverter::Init(const OutputConfiguration &config)
+int32_t AVMetaFrameConverter::Init(const OutputConfiguration &config, uint32_t maxFrames)
 {
     std::unique_lock<std::mutex> lock(mutex_);
 
@@ -64,7 +64,7 @@ int32_t AVMetaFrameConverter::Init(const OutputConfiguration &config)
     ret = SetupConvSrc();
     CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
-    ret = SetupConvSink(config);
+    ret = SetupConvSink(config, maxFrames);
     CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
     ret = SetupMsgProcessor();
@@ -75,7 +75,7 @@ int32_t AVMetaFrameConverter::Init(const OutputConfiguration &config)
 
 std::shared_ptr<AVSharedMemory> AVMetaFrameConverter::Convert(GstCaps &inCaps, GstBuffer &inBuf)
 {
-    AUTO_PERF(this, "ConvertFrame");
+    METRICS_AUTO_LATENCY("avmeta.convert_frame");
 
     std::unique_lock<std::mutex> lock(mutex_);
 
@@ -275,7 +275,7 @@ int32_t AVMetaFrameConverter::SetupConvSrc()
     return MSERR_OK;
 }
 
-int32_t AVMetaFrameConverter::SetupConvSink(const OutputConfiguration &outConfig)
+int32_t AVMetaFrameConverter::SetupConvSink(const OutputConfiguration &outConfig, uint32_t maxFrames)
 {
     if (PIXELFORMAT_INFO.count(outConfig.colorFormat) == 0) {
         MEDIA_LOGE("pixelformat unsupported: %{public}d", outConfig.colorFormat);
@@ -304,6 +304,10 @@ int32_t AVMetaFrameConverter::SetupConvSink(const OutputConfiguration &outConfig
     gst_caps_unref(caps);
     caps = nullptr;
     g_object_set(G_OBJECT(vidShMemSink_), "mem-prefix-size", sizeof(OutputFrame), nullptr);
+    // all results are held until the converter destroyed, one more buffer is needed for converting
+    if (maxFrames >= DEFAULT_POOL_CAPACITY) {
+        g_object_set(G_OBJECT(vidShMemSink_), "max-pool-capacity", maxFrames + 1, nullptr);
+    }
 
     GstMemSinkCallbacks callbacks = { nullptr, nullptr, OnNotifyNewSample };
     gst_mem_sink_set_callback(GST_MEM_SINK_CAST(vidShMemSink_), &callbacks, this, nullptr);
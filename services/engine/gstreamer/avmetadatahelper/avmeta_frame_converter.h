@@ -33,13 +33,17 @@ public:
     AVMetaFrameConverter();
     ~AVMetaFrameConverter();
 
-    int32_t Init(const OutputConfiguration &outConfig);
+    /**
+     * The returned memories are shared with the client and never be reused by the converter,
+     * so the maxFrames indicates how many frames will be converted by this converter at most.
+     */
+    int32_t Init(const OutputConfiguration &outConfig, uint32_t maxFrames = 1);
     std::shared_ptr<AVSharedMemory> Convert(GstCaps &inCaps, GstBuffer &inBuf);
 
 private:
     int32_t SetupConvPipeline();
     int32_t SetupConvSrc();
-    int32_t SetupConvSink(const OutputConfiguration &outConfig);
+    int32_t SetupConvSink(const OutputConfiguration &outConfig, uint32_t maxFrames);
     int32_t SetupMsgProcessor();
     void UninstallPipeline();
     int32_t ChangeState(GstState targetState);
@@ -14,13 +14,18 @@
  */
 
 #include "avmeta_frame_extractor.h"
+#include <algorithm>
 #include "media_errors.h"
 #include "media_log.h"
 #include "scope_guard.h"
-#include "time_perf.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetaFrameExtract"};
+    constexpr int32_t SEEK_TIMEOUT_MS = 5000;
+    constexpr int32_t STEP_TIMEOUT_MS = 1000;
+    // decode forward instead of seeking if the next time is not far away from the current frame
+    constexpr int64_t STEP_FORWARD_MAX_US = 2000000;
+    constexpr int32_t MAX_STEP_FRAMES = 120;
 }
 
 namespace OHOS {
@@ -88,6 +93,7 @@ void AVMetaFrameExtractor::Reset()
 {
     std::unique_lock<std::mutex> lock(mutex_);
 
+    StopBatch();
     StopExtract();
 
     decltype(signalIds_) tempSignalIds;
@@ -144,25 +150,41 @@ int32_t AVMetaFrameExtractor::StartExtract(
     (void)numFrames;
     std::unique_lock<std::mutex> lock(mutex_);
 
+    // the unfinished batch is abandoned
+    StopBatch();
     ON_SCOPE_EXIT(0) { StopExtract(); };
 
-    ClearCache();
     startExtracting_ = true;
 
-    IPlayBinCtrler::PlayBinSeekMode mode = IPlayBinCtrler::PlayBinSeekMode::PREV_SYNC;
-    if (SEEK_OPTION_MAPPING.find(option) != SEEK_OPTION_MAPPING.end()) {
-        mode = SEEK_OPTION_MAPPING.at(option);
-    }
-
-    int32_t ret = playbin_->Seek(timeUs, mode);
+    int32_t ret = SeekInternel(timeUs, option);
     CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "seek failed, cancel extract frames");
 
     frameConverter_ = std::make_unique<AVMetaFrameConverter>();
     ret = frameConverter_->Init(param);
     CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "init failed, cancel extract frames");
 
-    static constexpr int32_t timeout = 5;
-    cond_.wait_for(lock, std::chrono::seconds(timeout), [this]() {
+    ret = WaitSeekDone(lock, timeUs, option);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+    CANCEL_SCOPE_EXIT_GUARD(0);
+    return MSERR_OK;
+}
+
+int32_t AVMetaFrameExtractor::SeekInternel(int64_t timeUs, int32_t option)
+{
+    ClearCache();
+
+    IPlayBinCtrler::PlayBinSeekMode mode = IPlayBinCtrler::PlayBinSeekMode::PREV_SYNC;
+    if (SEEK_OPTION_MAPPING.find(option) != SEEK_OPTION_MAPPING.end()) {
+        mode = SEEK_OPTION_MAPPING.at(option);
+    }
+
+    return playbin_->Seek(timeUs, mode);
+}
+
+int32_t AVMetaFrameExtractor::WaitSeekDone(std::unique_lock<std::mutex> &lock, int64_t timeUs, int32_t option)
+{
+    cond_.wait_for(lock, std::chrono::milliseconds(SEEK_TIMEOUT_MS), [this]() {
         return seekDone_ || !startExtracting_;
     });
     CHECK_AND_RETURN_RET(startExtracting_, MSERR_INVALID_OPERATION);
@@ -170,15 +192,224 @@ int32_t AVMetaFrameExtractor::StartExtract(
     // no next sync frame, change to find the prev sync frame
     if (originalFrames_.empty() && option == AVMetadataQueryOption::AV_META_QUERY_NEXT_SYNC) {
         ClearCache();
-        mode = IPlayBinCtrler::PlayBinSeekMode::PREV_SYNC;
-        ret = playbin_->Seek(timeUs, mode);
+        int32_t ret = playbin_->Seek(timeUs, IPlayBinCtrler::PlayBinSeekMode::PREV_SYNC);
         CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "sek failed, cancel extract frames");
     }
 
+    return MSERR_OK;
+}
+
+int32_t AVMetaFrameExtractor::PrepareExtractFrames(
+    const std::vector<int64_t> &timesUs, int32_t option, const OutputConfiguration &param)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(playbin_ != nullptr, MSERR_INVALID_OPERATION, "not initialized");
+
+    StopExtract();
+    StopBatch();
+    ON_SCOPE_EXIT(0) { StopBatch(); };
+
+    // the converter is kept in PLAYING state during the whole batch
+    batchConverter_ = std::make_unique<AVMetaFrameConverter>();
+    int32_t ret = batchConverter_->Init(param, static_cast<uint32_t>(timesUs.size()));
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "init converter failed");
+
+    batchTimes_ = timesUs;
+    std::sort(batchTimes_.begin(), batchTimes_.end());
+    batchIndex_ = 0;
+    batchOption_ = option;
+    startExtracting_ = true;
+
     CANCEL_SCOPE_EXIT_GUARD(0);
+    MEDIA_LOGI("prepare to extract %{public}zu frames, option: %{public}d", batchTimes_.size(), option);
     return MSERR_OK;
 }
 
+std::shared_ptr<AVSharedMemory> AVMetaFrameExtractor::ExtractNextFrame(int64_t &timeUs)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    timeUs = -1;
+    CHECK_AND_RETURN_RET_LOG(batchIndex_ < batchTimes_.size(), nullptr, "no frame left to extract");
+
+    timeUs = batchTimes_[batchIndex_];
+    bool duplicated = (batchIndex_ > 0) && (batchTimes_[batchIndex_ - 1] == timeUs);
+    batchIndex_++;
+    ON_SCOPE_EXIT(0) {
+        if (batchIndex_ >= batchTimes_.size()) {
+            StopBatch();
+        }
+    };
+
+    if (duplicated) {
+        return lastResult_;
+    }
+    // the last result is kept only if this frame is extracted successfully
+    std::shared_ptr<AVSharedMemory> lastResult = std::move(lastResult_);
+
+    const DecodedFrame *selected = &sinkFrame_;
+    int32_t ret;
+    if (batchOption_ == AV_META_QUERY_CLOSEST) {
+        ret = StepToFrame(lock, timeUs, selected);
+    } else {
+        ret = SeekToFrame(lock, timeUs, batchOption_);
+    }
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK && selected->buffer != nullptr, nullptr,
+        "extract frame at %{public}" PRIi64 " failed", timeUs);
+
+    // the sync frames of the near positions are usually the same one
+    if (lastResult != nullptr && selected->ptsUs >= 0 && selected->ptsUs == lastResultPtsUs_) {
+        lastResult_ = lastResult;
+        return lastResult_;
+    }
+
+    GstBuffer *buffer = gst_buffer_ref(selected->buffer);
+    GstCaps *caps = gst_caps_ref(selected->caps);
+    int64_t ptsUs = selected->ptsUs;
+    lock.unlock();
+
+    auto result = batchConverter_->Convert(*caps, *buffer);
+    gst_buffer_unref(buffer);
+    gst_caps_unref(caps);
+
+    lock.lock();
+    CHECK_AND_RETURN_RET_LOG(result != nullptr, nullptr, "convert frame failed");
+
+    lastResult_ = result;
+    lastResultPtsUs_ = ptsUs;
+    return result;
+}
+
+int32_t AVMetaFrameExtractor::SeekToFrame(std::unique_lock<std::mutex> &lock, int64_t timeUs, int32_t option)
+{
+    ReleaseFrame(prevFrame_);
+    ReleaseFrame(sinkFrame_);
+
+    int32_t ret = SeekInternel(timeUs, option);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "seek failed");
+
+    ret = WaitSeekDone(lock, timeUs, option);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+    return WaitNewFrame(lock, SEEK_TIMEOUT_MS);
+}
+
+int32_t AVMetaFrameExtractor::StepToFrame(std::unique_lock<std::mutex> &lock, int64_t timeUs,
+    const DecodedFrame *&selected)
+{
+    // the frame whose pts is the nearest one not later than the timeUs is selected, as the accurate seek does
+    bool canStep = sinkFrame_.buffer != nullptr && sinkFrame_.ptsUs >= 0 &&
+        timeUs - sinkFrame_.ptsUs <= STEP_FORWARD_MAX_US;
+    if (canStep && prevFrame_.buffer != nullptr && prevFrame_.ptsUs >= 0 &&
+        prevFrame_.ptsUs <= timeUs && timeUs < sinkFrame_.ptsUs) {
+        selected = &prevFrame_;
+        return MSERR_OK;
+    }
+
+    if (canStep && timeUs >= sinkFrame_.ptsUs) {
+        int32_t steps = 0;
+        while (sinkFrame_.ptsUs < timeUs && steps < MAX_STEP_FRAMES) {
+            if (StepForward(lock) != MSERR_OK) {
+                // no more frame, such as the end of stream. The stepping state of the sink is unknown,
+                // so keep the last frame as the previous one to force the next position to seek.
+                ReleaseFrame(prevFrame_);
+                std::swap(prevFrame_, sinkFrame_);
+                selected = &prevFrame_;
+                return prevFrame_.buffer != nullptr ? MSERR_OK : MSERR_UNKNOWN;
+            }
+            steps++;
+            if (sinkFrame_.ptsUs < 0) {
+                break;
+            }
+        }
+
+        if (sinkFrame_.ptsUs == timeUs) {
+            selected = &sinkFrame_;
+            return MSERR_OK;
+        }
+        if (sinkFrame_.ptsUs > timeUs && prevFrame_.buffer != nullptr) {
+            selected = &prevFrame_;
+            return MSERR_OK;
+        }
+        MEDIA_LOGW("step to %{public}" PRIi64 " failed after %{public}d frames, seek instead", timeUs, steps);
+    }
+
+    int32_t ret = SeekToFrame(lock, timeUs, AV_META_QUERY_CLOSEST);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+    selected = &sinkFrame_;
+    return MSERR_OK;
+}
+
+int32_t AVMetaFrameExtractor::StepForward(std::unique_lock<std::mutex> &lock)
+{
+    ClearCache();
+    GstElement *sink = GST_ELEMENT_CAST(gst_object_ref(vidAppSink_));
+
+    // the preroll callback is called with the preroll lock of the sink held, unlock to avoid deadlock.
+    lock.unlock();
+    gboolean ret = gst_element_send_event(sink, gst_event_new_step(GST_FORMAT_BUFFERS, 1, 1.0, TRUE, FALSE));
+    gst_object_unref(sink);
+    lock.lock();
+    CHECK_AND_RETURN_RET_LOG(ret, MSERR_UNKNOWN, "send step event failed");
+
+    return WaitNewFrame(lock, STEP_TIMEOUT_MS);
+}
+
+int32_t AVMetaFrameExtractor::WaitNewFrame(std::unique_lock<std::mutex> &lock, int32_t timeoutMs)
+{
+    cond_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() {
+        return !originalFrames_.empty() || !startExtracting_;
+    });
+    CHECK_AND_RETURN_RET_LOG(startExtracting_, MSERR_INVALID_OPERATION, "cancelled, exit frame extract");
+    CHECK_AND_RETURN_RET_LOG(!originalFrames_.empty(), MSERR_UNKNOWN, "wait new frame timeout");
+
+    // only the latest preroll frame is what the video sink is prerolled on
+    while (originalFrames_.size() > 1) {
+        auto item = originalFrames_.front();
+        originalFrames_.pop();
+        gst_buffer_unref(item.first);
+        gst_caps_unref(item.second);
+    }
+
+    auto item = originalFrames_.front();
+    originalFrames_.pop();
+
+    ReleaseFrame(prevFrame_);
+    prevFrame_ = sinkFrame_;
+    sinkFrame_.buffer = item.first;
+    sinkFrame_.caps = item.second;
+    sinkFrame_.ptsUs = GST_BUFFER_PTS_IS_VALID(item.first) ?
+        static_cast<int64_t>(GST_BUFFER_PTS(item.first) / GST_USECOND) : -1;
+    return MSERR_OK;
+}
+
+void AVMetaFrameExtractor::ReleaseFrame(DecodedFrame &frame)
+{
+    if (frame.buffer != nullptr) {
+        gst_buffer_unref(frame.buffer);
+    }
+    if (frame.caps != nullptr) {
+        gst_caps_unref(frame.caps);
+    }
+    frame = DecodedFrame {};
+}
+
+void AVMetaFrameExtractor::StopBatch()
+{
+    if (batchConverter_ == nullptr && batchTimes_.empty()) {
+        return;
+    }
+
+    StopExtract();
+    ReleaseFrame(prevFrame_);
+    ReleaseFrame(sinkFrame_);
+    lastResult_ = nullptr;
+    lastResultPtsUs_ = -1;
+    batchTimes_.clear();
+    batchIndex_ = 0;
+    batchConverter_ = nullptr;
+}
+
 void AVMetaFrameExtractor::StopExtract()
 {
     ClearCache();
@@ -33,15 +33,31 @@ public:
 
     int32_t Init(const std::shared_ptr<IPlayBinCtrler> &playbin, GstElement &vidAppSink);
     std::shared_ptr<AVSharedMemory> ExtractFrame(int64_t timeUs, int32_t option, const OutputConfiguration &param);
+    int32_t PrepareExtractFrames(const std::vector<int64_t> &timesUs, int32_t option, const OutputConfiguration &param);
+    std::shared_ptr<AVSharedMemory> ExtractNextFrame(int64_t &timeUs);
     void Reset();
     void NotifyPlayBinMsg(const PlayBinMessage &msg);
 
 private:
+    struct DecodedFrame {
+        GstBuffer *buffer = nullptr;
+        GstCaps *caps = nullptr;
+        int64_t ptsUs = -1;
+    };
+
     int32_t SetupVideoSink();
     int32_t StartExtract(int32_t numFrames, int64_t timeUs, int32_t option, const OutputConfiguration &param);
     std::vector<std::shared_ptr<AVSharedMemory>> ExtractInternel();
     void StopExtract();
     void ClearCache();
+    int32_t SeekInternel(int64_t timeUs, int32_t option);
+    int32_t WaitSeekDone(std::unique_lock<std::mutex> &lock, int64_t timeUs, int32_t option);
+    int32_t SeekToFrame(std::unique_lock<std::mutex> &lock, int64_t timeUs, int32_t option);
+    int32_t StepToFrame(std::unique_lock<std::mutex> &lock, int64_t timeUs, const DecodedFrame *&selected);
+    int32_t StepForward(std::unique_lock<std::mutex> &lock);
+    int32_t WaitNewFrame(std::unique_lock<std::mutex> &lock, int32_t timeoutMs);
+    void StopBatch();
+    static void ReleaseFrame(DecodedFrame &frame);
 
     static GstFlowReturn OnNewPrerollArrived(GstElement *sink, AVMetaFrameExtractor *thiz);
 
@@ -54,6 +70,17 @@ private:
     bool startExtracting_ = false;
     std::unique_ptr<AVMetaFrameConverter> frameConverter_;
     std::vector<gulong> signalIds_;
+
+    // the state of the batch extracting, the frames are extracted in ascending order of the time
+    std::vector<int64_t> batchTimes_;
+    size_t batchIndex_ = 0;
+    int32_t batchOption_ = AV_META_QUERY_CLOSEST_SYNC;
+    std::unique_ptr<AVMetaFrameConverter> batchConverter_;
+    // the frame which the video sink is prerolled on, and the frame just before it when stepping
+    DecodedFrame sinkFrame_;
+    DecodedFrame prevFrame_;
+    std::shared_ptr<AVSharedMemory> lastResult_;
+    int64_t lastResultPtsUs_ = -1;
 };
 } // namespace Media
 } // namespace OHOS
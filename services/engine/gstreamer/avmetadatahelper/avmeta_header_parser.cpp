@@ -0,0 +1,1443 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmeta_header_parser.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <unistd.h>
+#include "avmetadatahelper.h"
+#include "gst_meta_parser.h"
+#include "media_errors.h"
+#include "media_log.h"
+#include "securec.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetaHeaderParser"};
+    constexpr size_t MAX_MOOV_SIZE = 16 * 1024 * 1024;
+    // the largest text frame, comment block or ebml master element to read
+    constexpr size_t MAX_ELEMENT_SIZE = 1024 * 1024;
+    constexpr size_t SCAN_CHUNK_SIZE = 64 * 1024;
+    // the trailing bytes not recognized as adts frames, e.g. an ape tag
+    constexpr uint64_t MAX_ADTS_TRAILING_SIZE = 4096;
+    constexpr uint64_t MSEC_PER_SEC = 1000;
+    constexpr uint64_t NSEC_PER_MSEC = 1000000;
+    constexpr uint64_t NSEC_PER_SEC = 1000000000;
+    constexpr size_t ID3V2_HEADER_SIZE = 10;
+    constexpr uint64_t ID3V1_SIZE = 128;
+    constexpr size_t MPEG_HEADER_SIZE = 4;
+    constexpr size_t ADTS_HEADER_SIZE = 7;
+    constexpr uint32_t ADTS_SAMPLES_PER_FRAME = 1024;
+    constexpr size_t FLAC_STREAMINFO_SIZE = 34;
+    constexpr size_t WAV_FMT_SIZE = 16;
+    constexpr uint32_t EBML_ID_HEADER = 0x1A45DFA3;
+    constexpr uint32_t EBML_ID_DOCTYPE = 0x4282;
+    constexpr uint32_t MKV_ID_SEGMENT = 0x18538067;
+    constexpr uint32_t MKV_ID_SEEKHEAD = 0x114D9B74;
+    constexpr uint32_t MKV_ID_SEEK = 0x4DBB;
+    constexpr uint32_t MKV_ID_SEEKID = 0x53AB;
+    constexpr uint32_t MKV_ID_SEEKPOSITION = 0x53AC;
+    constexpr uint32_t MKV_ID_INFO = 0x1549A966;
+    constexpr uint32_t MKV_ID_TIMECODESCALE = 0x2AD7B1;
+    constexpr uint32_t MKV_ID_DURATION = 0x4489;
+    constexpr uint32_t MKV_ID_TITLE = 0x7BA9;
+    constexpr uint32_t MKV_ID_DATEUTC = 0x4461;
+    constexpr uint32_t MKV_ID_TRACKS = 0x1654AE6B;
+    constexpr uint32_t MKV_ID_TRACKENTRY = 0xAE;
+    constexpr uint32_t MKV_ID_TRACKTYPE = 0x83;
+    constexpr uint32_t MKV_ID_NAME = 0x536E;
+    constexpr uint32_t MKV_ID_VIDEO = 0xE0;
+    constexpr uint32_t MKV_ID_PIXELWIDTH = 0xB0;
+    constexpr uint32_t MKV_ID_PIXELHEIGHT = 0xBA;
+    constexpr uint32_t MKV_ID_AUDIO = 0xE1;
+    constexpr uint32_t MKV_ID_SAMPLINGFREQUENCY = 0xB5;
+    constexpr uint32_t MKV_ID_TAGS = 0x1254C367;
+    constexpr uint32_t MKV_ID_TAG = 0x7373;
+    constexpr uint32_t MKV_ID_TARGETS = 0x63C0;
+    constexpr uint32_t MKV_ID_SIMPLETAG = 0x67C8;
+    constexpr uint32_t MKV_ID_CLUSTER = 0x1F43B675;
+    constexpr uint64_t MKV_TRACK_TYPE_VIDEO = 1;
+    constexpr uint64_t MKV_TRACK_TYPE_AUDIO = 2;
+    constexpr uint64_t MKV_TRACK_TYPE_SUBTITLE = 0x11;
+    constexpr uint64_t MKV_DEFAULT_TIMECODESCALE = 1000000;
+    // seconds from 1970-01-01 to 2001-01-01, the origin of DateUTC
+    constexpr int64_t MKV_DATE_ORIGIN_SEC = 978307200;
+    constexpr uint64_t EBML_UNKNOWN_SIZE = UINT64_MAX;
+}
+
+namespace OHOS {
+namespace Media {
+struct AVMetaHeaderInfo {
+    std::string fileMime;
+    int64_t durationMs = 0;
+    int32_t trackCount = 0;
+    bool hasAudio = false;
+    bool hasVideo = false;
+    int32_t sampleRate = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    // -1 if not reported by the container
+    int32_t rotation = -1;
+    bool hasId3 = false;
+    Metadata tags;
+};
+
+static constexpr uint32_t FourCC(const char (&str)[5])
+{
+    return (static_cast<uint32_t>(static_cast<uint8_t>(str[0])) << 24) | // 24: the first char
+        (static_cast<uint32_t>(static_cast<uint8_t>(str[1])) << 16) | // 16: the second char
+        (static_cast<uint32_t>(static_cast<uint8_t>(str[2])) << 8) | // 8: the third char
+        static_cast<uint32_t>(static_cast<uint8_t>(str[3])); // 3: the last char
+}
+
+static uint16_t U16BE(const uint8_t *data)
+{
+    return static_cast<uint16_t>((static_cast<uint32_t>(data[0]) << 8) | data[1]); // 8: bits of byte
+}
+
+static uint32_t U24BE(const uint8_t *data)
+{
+    return (static_cast<uint32_t>(data[0]) << 16) | (static_cast<uint32_t>(data[1]) << 8) | data[2]; // 2: 3 bytes
+}
+
+static uint32_t U32BE(const uint8_t *data)
+{
+    return (static_cast<uint32_t>(data[0]) << 24) | U24BE(data + 1); // 24: the highest byte
+}
+
+static uint64_t U64BE(const uint8_t *data)
+{
+    return (static_cast<uint64_t>(U32BE(data)) << 32) | U32BE(data + 4); // 32, 4: the high half
+}
+
+static uint32_t U32LE(const uint8_t *data)
+{
+    return (static_cast<uint32_t>(data[3]) << 24) | (static_cast<uint32_t>(data[2]) << 16) | // 3, 2: the high half
+        (static_cast<uint32_t>(data[1]) << 8) | data[0]; // 8: bits of byte
+}
+
+static uint32_t SyncSafe32(const uint8_t *data)
+{
+    return (static_cast<uint32_t>(data[0] & 0x7F) << 21) | (static_cast<uint32_t>(data[1] & 0x7F) << 14) | // 21, 14
+        (static_cast<uint32_t>(data[2] & 0x7F) << 7) | (data[3] & 0x7F); // 2, 3, 7: 7 bits per byte
+}
+
+static int64_t ScaleToMs(uint64_t value, uint64_t scale)
+{
+    if (scale == 0 || value / scale > static_cast<uint64_t>(INT64_MAX) / MSEC_PER_SEC) {
+        return 0;
+    }
+    return static_cast<int64_t>(value / scale * MSEC_PER_SEC + value % scale * MSEC_PER_SEC / scale);
+}
+
+static void AppendUtf8(std::string &out, uint32_t codePoint)
+{
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codePoint >> 6))); // 6: bits per continuation byte
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codePoint >> 12))); // 12: two continuation bytes
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F))); // 6: one continuation byte
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codePoint >> 18))); // 18: three continuation bytes
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F))); // 12: two continuation bytes
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F))); // 6: one continuation byte
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+static std::string CutAtNul(const uint8_t *data, size_t size)
+{
+    const uint8_t *end = std::find(data, data + size, 0);
+    return std::string(reinterpret_cast<const char *>(data), static_cast<size_t>(end - data));
+}
+
+static std::string Latin1ToUtf8(const uint8_t *data, size_t size)
+{
+    std::string out;
+    for (size_t i = 0; i < size && data[i] != 0; i++) {
+        AppendUtf8(out, data[i]);
+    }
+    return out;
+}
+
+static std::string Utf16ToUtf8(const uint8_t *data, size_t size, bool bigEndian)
+{
+    std::string out;
+    for (size_t i = 0; i + 1 < size; i += 2) { // 2: bytes per unit
+        uint32_t unit = bigEndian ? U16BE(data + i) : static_cast<uint32_t>(data[i] | (data[i + 1] << 8));
+        if (unit == 0) {
+            break;
+        }
+        if (unit >= 0xD800 && unit < 0xDC00 && i + 3 < size) { // 3: the last byte of the low surrogate
+            uint32_t low = bigEndian ? U16BE(data + i + 2) : static_cast<uint32_t>(data[i + 2] | (data[i + 3] << 8));
+            if (low >= 0xDC00 && low < 0xE000) {
+                AppendUtf8(out, 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00)); // 10: bits of the low part
+                i += 2; // 2: skip the low surrogate
+                continue;
+            }
+        }
+        AppendUtf8(out, unit);
+    }
+    return out;
+}
+
+/**
+ * Format the date as the pipeline does: "YYYY[-MM[-DD[ HH:MM[:SS]]]]".
+ */
+static std::string NormalizeDateTime(const std::string &value)
+{
+    static constexpr size_t yearLen = 4;
+    static constexpr size_t dateLen = 10;
+    static constexpr size_t dateTimeLen = 19;
+    if (value.size() < yearLen || !std::all_of(value.begin(), value.begin() + yearLen, ::isdigit)) {
+        return "";
+    }
+
+    std::string result = value.substr(0, dateTimeLen);
+    if (result.size() > dateLen && result[dateLen] == 'T') {
+        result[dateLen] = ' ';
+    }
+    auto end = std::find_if(result.begin(), result.end(), [](char c) {
+        return !::isdigit(c) && c != '-' && c != ':' && c != ' ';
+    });
+    result.erase(end, result.end());
+    while (!result.empty() && !::isdigit(result.back())) {
+        result.pop_back();
+    }
+    return result;
+}
+
+// the pipeline maps the numeric id3 genre to the name, leave it to the pipeline.
+static bool IsNumericGenre(const std::string &genre)
+{
+    return !genre.empty() && (genre[0] == '(' || std::all_of(genre.begin(), genre.end(), ::isdigit));
+}
+
+static void SetTag(Metadata &tags, int32_t key, const std::string &value)
+{
+    if (key == AV_KEY_DATE_TIME) {
+        std::string dateTime = NormalizeDateTime(value);
+        if (!dateTime.empty() && !tags.HasMeta(key)) {
+            tags.SetMeta(key, dateTime);
+        }
+        return;
+    }
+
+    if (!value.empty() && !tags.HasMeta(key)) {
+        tags.SetMeta(key, value);
+    }
+}
+
+/**
+ * MP4/MOV, only the moov box is read.
+ */
+struct Mp4Track {
+    uint32_t handler = 0;
+    int32_t rotation = -1;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t sampleRate = 0;
+};
+
+using Mp4BoxVisitor = std::function<bool(uint32_t type, const uint8_t *data, size_t size)>;
+
+static bool ForEachMp4Box(const uint8_t *data, size_t size, const Mp4BoxVisitor &visitor)
+{
+    static constexpr size_t boxHeaderSize = 8;
+    static constexpr size_t largeBoxHeaderSize = 16;
+    size_t pos = 0;
+    // some writers leave a 32 bits terminator at the end of the container
+    while (pos + boxHeaderSize <= size) {
+        uint64_t boxSize = U32BE(data + pos);
+        uint32_t type = U32BE(data + pos + 4); // 4: the type follows the size
+        size_t headerSize = boxHeaderSize;
+        if (boxSize == 1) {
+            CHECK_AND_RETURN_RET(pos + largeBoxHeaderSize <= size, false);
+            boxSize = U64BE(data + pos + boxHeaderSize);
+            headerSize = largeBoxHeaderSize;
+        } else if (boxSize == 0) {
+            boxSize = size - pos;
+        }
+        CHECK_AND_RETURN_RET(boxSize >= headerSize && boxSize <= size - pos, false);
+        CHECK_AND_RETURN_RET(visitor(type, data + pos + headerSize, static_cast<size_t>(boxSize) - headerSize), false);
+        pos += static_cast<size_t>(boxSize);
+    }
+    return true;
+}
+
+static bool IsMp4TopBox(uint32_t type)
+{
+    static const std::vector<uint32_t> types = {
+        FourCC("ftyp"), FourCC("moov"), FourCC("mdat"), FourCC("free"), FourCC("skip"), FourCC("wide"), FourCC("pnot"),
+    };
+    return std::find(types.begin(), types.end(), type) != types.end();
+}
+
+static int32_t Mp4TagKey(uint32_t type)
+{
+    static const std::unordered_map<uint32_t, int32_t> keys = {
+        { FourCC("\251nam"), AV_KEY_TITLE },
+        { FourCC("\251ART"), AV_KEY_ARTIST },
+        { FourCC("aART"), AV_KEY_ALBUM_ARTIST },
+        { FourCC("\251alb"), AV_KEY_ALBUM },
+        { FourCC("\251gen"), AV_KEY_GENRE },
+        { FourCC("\251wrt"), AV_KEY_COMPOSER },
+        { FourCC("\251day"), AV_KEY_DATE_TIME },
+    };
+    auto it = keys.find(type);
+    return it == keys.end() ? -1 : it->second;
+}
+
+static bool ParseMp4Ilst(const uint8_t *data, size_t size, Metadata &tags)
+{
+    return ForEachMp4Box(data, size, [&tags](uint32_t type, const uint8_t *item, size_t itemSize) {
+        if (type == FourCC("gnre")) {
+            return false; // numeric genre
+        }
+        int32_t key = Mp4TagKey(type);
+        if (key < 0) {
+            return true;
+        }
+        return ForEachMp4Box(item, itemSize, [&tags, key](uint32_t childType, const uint8_t *value, size_t valueSize) {
+            static constexpr size_t dataHeaderSize = 8; // type indicator and locale
+            static constexpr uint32_t utf8Type = 1;
+            if (childType == FourCC("data") && valueSize >= dataHeaderSize && (U32BE(value) & 0xFFFFFF) == utf8Type) {
+                SetTag(tags, key, CutAtNul(value + dataHeaderSize, valueSize - dataHeaderSize));
+            }
+            return true;
+        });
+    });
+}
+
+static bool ParseMp4Meta(const uint8_t *data, size_t size, Metadata &tags)
+{
+    // the quicktime meta box is not a full box, detect it by the handler box following.
+    static constexpr size_t fullBoxHeaderSize = 4;
+    size_t skip = fullBoxHeaderSize;
+    if (size >= 8 && U32BE(data + 4) == FourCC("hdlr")) { // 8, 4: the type of the first child
+        skip = 0;
+    }
+    CHECK_AND_RETURN_RET(size >= skip, false);
+
+    return ForEachMp4Box(data + skip, size - skip, [&tags](uint32_t type, const uint8_t *child, size_t childSize) {
+        return type != FourCC("ilst") || ParseMp4Ilst(child, childSize, tags);
+    });
+}
+
+static bool ParseMp4Udta(const uint8_t *data, size_t size, Metadata &tags)
+{
+    return ForEachMp4Box(data, size, [&tags](uint32_t type, const uint8_t *child, size_t childSize) {
+        static const std::vector<uint32_t> assetTypes = {
+            FourCC("titl"), FourCC("perf"), FourCC("auth"), FourCC("gnre"), FourCC("albm"), FourCC("yrrc"),
+        };
+        if (std::find(assetTypes.begin(), assetTypes.end(), type) != assetTypes.end()) {
+            return false; // the 3gpp asset boxes, leave them to the pipeline
+        }
+        if (type == FourCC("meta")) {
+            return ParseMp4Meta(child, childSize, tags);
+        }
+
+        // the quicktime text: 16 bits length, 16 bits language, and the text
+        static constexpr size_t textHeaderSize = 4;
+        int32_t key = Mp4TagKey(type);
+        if (key >= 0 && childSize >= textHeaderSize) {
+            size_t length = std::min<size_t>(U16BE(child), childSize - textHeaderSize);
+            SetTag(tags, key, CutAtNul(child + textHeaderSize, length));
+        }
+        return true;
+    });
+}
+
+static int32_t ParseMp4Rotation(const uint8_t *tkhd, size_t size)
+{
+    static constexpr size_t matrixOffsetV0 = 40;
+    static constexpr size_t matrixOffsetV1 = 52;
+    static constexpr size_t matrixSize = 36;
+    size_t offset = tkhd[0] == 1 ? matrixOffsetV1 : matrixOffsetV0;
+    if (size < offset + matrixSize) {
+        return -1;
+    }
+
+    // the integer parts of the 16.16 fixed point a, b, c, d, as qtdemux does.
+    const uint8_t *matrix = tkhd + offset;
+    uint16_t a = U16BE(matrix);
+    uint16_t b = U16BE(matrix + 4); // 4: the second element
+    uint16_t c = U16BE(matrix + 12); // 12: the fourth element
+    uint16_t d = U16BE(matrix + 16); // 16: the fifth element
+    static constexpr uint16_t minusOne = 0xFFFF;
+    if (a == 1 && b == 0 && c == 0 && d == 1) {
+        return 0;
+    } else if (a == 0 && b == 1 && c == minusOne && d == 0) {
+        return 90; // 90: degree
+    } else if (a == minusOne && b == 0 && c == 0 && d == minusOne) {
+        return 180; // 180: degree
+    } else if (a == 0 && b == minusOne && c == 1 && d == 0) {
+        return 270; // 270: degree
+    }
+    return -1;
+}
+
+static bool ParseMp4Stsd(const uint8_t *data, size_t size, Mp4Track &track)
+{
+    static constexpr size_t stsdHeaderSize = 8;
+    static constexpr size_t entryHeaderSize = 8;
+    static constexpr size_t sampleEntrySize = 28;
+    if (size < stsdHeaderSize + entryHeaderSize || U32BE(data + 4) == 0) { // 4: entry count
+        return true;
+    }
+
+    const uint8_t *entry = data + stsdHeaderSize;
+    size_t entrySize = U32BE(entry);
+    CHECK_AND_RETURN_RET(entrySize >= entryHeaderSize && entrySize <= size - stsdHeaderSize, false);
+    const uint8_t *payload = entry + entryHeaderSize;
+    size_t payloadSize = entrySize - entryHeaderSize;
+    if (payloadSize < sampleEntrySize) {
+        return true;
+    }
+
+    // parse as both the visual and the audio sample entry, select one by the handler later.
+    track.width = U16BE(payload + 24); // 24: width of the visual sample entry
+    track.height = U16BE(payload + 26); // 26: height of the visual sample entry
+
+    static constexpr uint16_t soundVersion2 = 2;
+    static constexpr size_t soundV2Size = 40;
+    if (U16BE(payload + 8) == soundVersion2 && payloadSize >= soundV2Size) { // 8: sound sample description version
+        uint64_t bits = U64BE(payload + 32); // 32: the float64 sample rate of version 2
+        double rate = 0;
+        CHECK_AND_RETURN_RET(memcpy_s(&rate, sizeof(rate), &bits, sizeof(bits)) == EOK, false);
+        track.sampleRate = (rate > 0 && rate < INT32_MAX) ? static_cast<int32_t>(rate) : 0;
+    } else {
+        track.sampleRate = static_cast<int32_t>(U32BE(payload + 24) >> 16); // 24, 16: the 16.16 sample rate
+    }
+    return true;
+}
+
+static bool ParseMp4Trak(const uint8_t *data, size_t size, Mp4Track &track)
+{
+    return ForEachMp4Box(data, size, [&track](uint32_t type, const uint8_t *child, size_t childSize) {
+        if (type == FourCC("tkhd")) {
+            track.rotation = childSize > 0 ? ParseMp4Rotation(child, childSize) : -1;
+            return true;
+        }
+        if (type != FourCC("mdia")) {
+            return true;
+        }
+        return ForEachMp4Box(child, childSize, [&track](uint32_t mdiaType, const uint8_t *box, size_t boxSize) {
+            static constexpr size_t hdlrSize = 12;
+            if (mdiaType == FourCC("hdlr") && boxSize >= hdlrSize) {
+                track.handler = U32BE(box + 8); // 8: after the version, flags and pre_defined
+            } else if (mdiaType == FourCC("minf")) {
+                return ForEachMp4Box(box, boxSize, [&track](uint32_t minfType, const uint8_t *stbl, size_t stblSize) {
+                    return minfType != FourCC("stbl") || ForEachMp4Box(stbl, stblSize,
+                        [&track](uint32_t stblType, const uint8_t *stsd, size_t stsdSize) {
+                            return stblType != FourCC("stsd") || ParseMp4Stsd(stsd, stsdSize, track);
+                        });
+                });
+            }
+            return true;
+        });
+    });
+}
+
+static bool ParseMp4Mvhd(const uint8_t *data, size_t size, uint64_t &duration, uint32_t &timescale)
+{
+    static constexpr size_t mvhdV0Size = 20;
+    static constexpr size_t mvhdV1Size = 32;
+    if (size > 0 && data[0] == 1) {
+        CHECK_AND_RETURN_RET(size >= mvhdV1Size, false);
+        timescale = U32BE(data + 20); // 20: after the 64 bits creation and modification time
+        duration = U64BE(data + 24); // 24: after the timescale
+    } else {
+        CHECK_AND_RETURN_RET(size >= mvhdV0Size, false);
+        timescale = U32BE(data + 12); // 12: after the 32 bits creation and modification time
+        duration = U32BE(data + 16); // 16: after the timescale
+        duration = (duration == UINT32_MAX) ? 0 : duration;
+    }
+    return true;
+}
+
+static bool ParseMp4Moov(const uint8_t *data, size_t size, AVMetaHeaderInfo &info);
+
+bool AVMetaHeaderParser::ParseMp4(AVMetaHeaderInfo &info)
+{
+    static constexpr size_t boxHeaderSize = 8;
+    static constexpr size_t largeBoxHeaderSize = 16;
+    uint64_t pos = 0;
+    while (pos + boxHeaderSize <= size_) {
+        uint8_t header[largeBoxHeaderSize] = {0};
+        CHECK_AND_RETURN_RET(ReadAt(pos, header, boxHeaderSize), false);
+        uint64_t boxSize = U32BE(header);
+        uint32_t type = U32BE(header + 4); // 4: the type follows the size
+        uint64_t headerSize = boxHeaderSize;
+        if (boxSize == 1) {
+            CHECK_AND_RETURN_RET(ReadAt(pos, header, largeBoxHeaderSize), false);
+            boxSize = U64BE(header + boxHeaderSize);
+            headerSize = largeBoxHeaderSize;
+        } else if (boxSize == 0) {
+            boxSize = size_ - pos;
+        }
+        CHECK_AND_RETURN_RET(boxSize >= headerSize && boxSize <= size_ - pos, false);
+        CHECK_AND_RETURN_RET(pos != 0 || IsMp4TopBox(type), false);
+
+        if (type == FourCC("moov")) {
+            CHECK_AND_RETURN_RET_LOG(boxSize - headerSize <= MAX_MOOV_SIZE, false, "moov too large");
+            std::vector<uint8_t> moov;
+            CHECK_AND_RETURN_RET(ReadAt(pos + headerSize, static_cast<size_t>(boxSize - headerSize), moov), false);
+            return ParseMp4Moov(moov.data(), moov.size(), info);
+        }
+        CHECK_AND_RETURN_RET(type != FourCC("moof"), false);
+        pos += boxSize;
+    }
+    return false;
+}
+
+static bool ParseMp4Moov(const uint8_t *data, size_t size, AVMetaHeaderInfo &info)
+{
+    uint64_t duration = 0;
+    uint32_t timescale = 0;
+    std::vector<Mp4Track> tracks;
+    bool ret = ForEachMp4Box(data, size, [&](uint32_t type, const uint8_t *child, size_t childSize) {
+        if (type == FourCC("mvhd")) {
+            return ParseMp4Mvhd(child, childSize, duration, timescale);
+        } else if (type == FourCC("trak")) {
+            Mp4Track track;
+            CHECK_AND_RETURN_RET(ParseMp4Trak(child, childSize, track), false);
+            tracks.push_back(track);
+        } else if (type == FourCC("udta")) {
+            return ParseMp4Udta(child, childSize, info.tags);
+        } else if (type == FourCC("meta")) {
+            return ParseMp4Meta(child, childSize, info.tags);
+        } else if (type == FourCC("mvex") || type == FourCC("cmov")) {
+            return false; // fragmented or compressed
+        }
+        return true;
+    });
+    CHECK_AND_RETURN_RET(ret, false);
+
+    for (auto &track : tracks) {
+        if (track.handler == FourCC("vide")) {
+            if (!info.hasVideo) {
+                info.width = track.width;
+                info.height = track.height;
+                info.rotation = track.rotation;
+            }
+            info.hasVideo = true;
+            info.trackCount++;
+        } else if (track.handler == FourCC("soun")) {
+            if (!info.hasAudio) {
+                info.sampleRate = track.sampleRate;
+            }
+            info.hasAudio = true;
+            info.trackCount++;
+        } else if (track.handler == FourCC("text") || track.handler == FourCC("sbtl") ||
+            track.handler == FourCC("subt")) {
+            info.trackCount++;
+        }
+    }
+
+    info.durationMs = ScaleToMs(duration, timescale);
+    info.fileMime = FILE_MIMETYPE_VIDEO_MP4;
+    return true;
+}
+
+/**
+ * MP3 and ADTS, with the optional id3v2 tag.
+ */
+static int32_t Id3FrameKey(const std::string &id)
+{
+    static const std::unordered_map<std::string, int32_t> keys = {
+        { "TIT2", AV_KEY_TITLE }, { "TT2", AV_KEY_TITLE },
+        { "TPE1", AV_KEY_ARTIST }, { "TP1", AV_KEY_ARTIST },
+        { "TPE2", AV_KEY_ALBUM_ARTIST }, { "TP2", AV_KEY_ALBUM_ARTIST },
+        { "TALB", AV_KEY_ALBUM }, { "TAL", AV_KEY_ALBUM },
+        { "TCON", AV_KEY_GENRE }, { "TCO", AV_KEY_GENRE },
+        { "TCOM", AV_KEY_COMPOSER }, { "TCM", AV_KEY_COMPOSER },
+        { "TDRC", AV_KEY_DATE_TIME }, { "TYER", AV_KEY_DATE_TIME }, { "TYE", AV_KEY_DATE_TIME },
+    };
+    auto it = keys.find(id);
+    return it == keys.end() ? -1 : it->second;
+}
+
+static std::string DecodeId3Text(const std::vector<uint8_t> &data)
+{
+    enum Id3Encoding : uint8_t { LATIN1 = 0, UTF16 = 1, UTF16BE = 2, UTF8 = 3 };
+    if (data.empty()) {
+        return "";
+    }
+
+    const uint8_t *text = data.data() + 1;
+    size_t size = data.size() - 1;
+    switch (data[0]) {
+        case LATIN1:
+            return Latin1ToUtf8(text, size);
+        case UTF16: {
+            static constexpr size_t bomSize = 2;
+            if (size >= bomSize && text[0] == 0xFE && text[1] == 0xFF) {
+                return Utf16ToUtf8(text + bomSize, size - bomSize, true);
+            }
+            if (size >= bomSize && text[0] == 0xFF && text[1] == 0xFE) {
+                return Utf16ToUtf8(text + bomSize, size - bomSize, false);
+            }
+            return Utf16ToUtf8(text, size, false);
+        }
+        case UTF16BE:
+            return Utf16ToUtf8(text, size, true);
+        case UTF8:
+            return CutAtNul(text, size);
+        default:
+            return "";
+    }
+}
+
+bool AVMetaHeaderParser::ParseId3v2(uint64_t &pos, AVMetaHeaderInfo &info)
+{
+    uint8_t header[ID3V2_HEADER_SIZE] = {0};
+    CHECK_AND_RETURN_RET(ReadAt(pos, header, sizeof(header)), false);
+
+    static constexpr uint8_t minVersion = 2;
+    static constexpr uint8_t maxVersion = 4;
+    static constexpr uint8_t flagUnsync = 0x80;
+    static constexpr uint8_t flagExtHeader = 0x40;
+    static constexpr uint8_t flagFooter = 0x10;
+    uint8_t version = header[3]; // 3: the major version
+    uint8_t flags = header[5]; // 5: the flags
+    CHECK_AND_RETURN_RET(version >= minVersion && version <= maxVersion, false);
+    CHECK_AND_RETURN_RET_LOG((flags & flagUnsync) == 0, false, "unsynchronized id3 tag");
+
+    uint64_t tagEnd = pos + ID3V2_HEADER_SIZE + SyncSafe32(header + 6); // 6: the size
+    uint64_t end = tagEnd + (((flags & flagFooter) != 0) ? ID3V2_HEADER_SIZE : 0);
+    CHECK_AND_RETURN_RET(end <= size_, false);
+
+    uint64_t framePos = pos + ID3V2_HEADER_SIZE;
+    if ((flags & flagExtHeader) != 0 && version > minVersion) {
+        uint8_t extSize[4] = {0};
+        CHECK_AND_RETURN_RET(ReadAt(framePos, extSize, sizeof(extSize)), false);
+        framePos += (version == maxVersion) ? SyncSafe32(extSize) : U32BE(extSize) + sizeof(extSize);
+    }
+
+    // v2.2: 3 bytes id and 3 bytes size, v2.3 and v2.4: 4 bytes id, 4 bytes size and 2 bytes flags
+    size_t frameHeaderSize = (version == minVersion) ? 6 : 10;
+    size_t idSize = (version == minVersion) ? 3 : 4;
+    std::string year;
+    std::string date;
+    std::string time;
+    while (framePos + frameHeaderSize <= tagEnd) {
+        uint8_t frameHeader[ID3V2_HEADER_SIZE] = {0};
+        CHECK_AND_RETURN_RET(ReadAt(framePos, frameHeader, frameHeaderSize), false);
+        if (frameHeader[0] == 0) {
+            break; // the padding
+        }
+
+        std::string id(reinterpret_cast<const char *>(frameHeader), idSize);
+        uint32_t frameSize = (version == minVersion) ? U24BE(frameHeader + idSize) :
+            ((version == maxVersion) ? SyncSafe32(frameHeader + idSize) : U32BE(frameHeader + idSize));
+        CHECK_AND_RETURN_RET(frameSize <= tagEnd - framePos - frameHeaderSize, false);
+
+        // v2.3: compressed or encrypted, v2.4: compressed, encrypted, unsynchronized or with the data length
+        uint8_t formatFlags = (version == minVersion) ? 0 : frameHeader[9]; // 9: the format flags
+        bool skip = (version == maxVersion) ? ((formatFlags & 0x0F) != 0) : ((formatFlags & 0xC0) != 0);
+        bool isDate = id == "TDAT" || id == "TDA";
+        bool isTime = id == "TIME" || id == "TIM";
+        int32_t key = Id3FrameKey(id);
+        if (!skip && (key >= 0 || isDate || isTime) && frameSize > 1 && frameSize <= MAX_ELEMENT_SIZE) {
+            std::vector<uint8_t> data;
+            CHECK_AND_RETURN_RET(ReadAt(framePos + frameHeaderSize, frameSize, data), false);
+            std::string text = DecodeId3Text(data);
+            if (isDate) {
+                date = text;
+            } else if (isTime) {
+                time = text;
+            } else if (id == "TYER" || id == "TYE") {
+                year = text;
+            } else if (key == AV_KEY_GENRE && IsNumericGenre(text)) {
+                return false;
+            } else {
+                SetTag(info.tags, key, text);
+            }
+        }
+        framePos += frameHeaderSize + frameSize;
+    }
+
+    // v2.3 splits the date into the year, DDMM and HHMM, merged as the pipeline does.
+    static constexpr size_t ddmmLen = 4;
+    if (!year.empty()) {
+        if (date.size() == ddmmLen) {
+            year += "-" + date.substr(2, 2) + "-" + date.substr(0, 2); // 2: the month follows the day
+            if (time.size() == ddmmLen) {
+                year += " " + time.substr(0, 2) + ":" + time.substr(2, 2); // 2: the minute follows the hour
+            }
+        }
+        SetTag(info.tags, AV_KEY_DATE_TIME, year);
+    }
+
+    info.hasId3 = true;
+    pos = end;
+    return true;
+}
+
+struct MpegAudioHeader {
+    uint32_t version = 0; // 1: mpeg1, 2: mpeg2, 25: mpeg2.5
+    uint32_t layer = 0;
+    uint32_t bitrate = 0; // kbps
+    uint32_t sampleRate = 0;
+    uint32_t frameSize = 0;
+    uint32_t samplesPerFrame = 0;
+    bool mono = false;
+};
+
+static bool ParseMpegAudioHeader(const uint8_t *data, MpegAudioHeader &header)
+{
+    static const uint32_t bitrates[2][3][15] = { // 2: mpeg1 or not, 3: layers, 15: bitrate indexes
+        {
+            { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448 },
+            { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384 },
+            { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 },
+        },
+        {
+            { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256 },
+            { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 },
+            { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 },
+        },
+    };
+    static const uint32_t sampleRates[3] = { 44100, 48000, 32000 }; // 3: sample rate indexes of mpeg1
+
+    if (data[0] != 0xFF || (data[1] & 0xE0) != 0xE0) {
+        return false;
+    }
+    uint32_t versionBits = (data[1] >> 3) & 0x3; // 3: the version bits
+    uint32_t layerBits = (data[1] >> 1) & 0x3;
+    uint32_t bitrateIndex = data[2] >> 4; // 4: the bitrate bits
+    uint32_t sampleRateIndex = (data[2] >> 2) & 0x3; // 2: the sample rate bits
+    static constexpr uint32_t reserved = 1;
+    static constexpr uint32_t badIndex = 15;
+    static constexpr uint32_t badSampleRateIndex = 3;
+    if (versionBits == reserved || layerBits == 0 || bitrateIndex == 0 || bitrateIndex == badIndex ||
+        sampleRateIndex == badSampleRateIndex) {
+        return false; // the free format is left to the pipeline
+    }
+
+    static constexpr uint32_t mpeg25 = 25;
+    static constexpr uint32_t mpeg2Bits = 2;
+    static constexpr uint32_t layer1 = 1;
+    static constexpr uint32_t layer3 = 3;
+    header.version = (versionBits == 3) ? 1 : ((versionBits == mpeg2Bits) ? 2 : mpeg25); // 3: mpeg1, 2: mpeg2
+    header.layer = 4 - layerBits; // 4: layer bits 3, 2, 1 are layer 1, 2, 3
+    header.bitrate = bitrates[header.version == 1 ? 0 : 1][header.layer - 1][bitrateIndex];
+    header.sampleRate = sampleRates[sampleRateIndex] >> (header.version == 1 ? 0 : (header.version == 2 ? 1 : 2));
+    bool padding = ((data[2] >> 1) & 0x1) != 0;
+    header.mono = (data[3] >> 6) == 0x3; // 6: the channel mode bits
+    static constexpr uint32_t bitsPerSlot = 8;
+    if (header.layer == layer1) {
+        static constexpr uint32_t slotBytes = 4;
+        header.samplesPerFrame = 384; // 384: samples per layer 1 frame
+        header.frameSize = (header.samplesPerFrame / bitsPerSlot / slotBytes * header.bitrate * MSEC_PER_SEC /
+            header.sampleRate + (padding ? 1 : 0)) * slotBytes;
+    } else {
+        header.samplesPerFrame = (header.layer == layer3 && header.version != 1) ? 576 : 1152; // 576, 1152: samples
+        header.frameSize = header.samplesPerFrame / bitsPerSlot * header.bitrate * MSEC_PER_SEC /
+            header.sampleRate + (padding ? 1 : 0);
+    }
+    return header.frameSize > MPEG_HEADER_SIZE;
+}
+
+bool AVMetaHeaderParser::ParseMpegAudio(AVMetaHeaderInfo &info)
+{
+    uint64_t pos = 0;
+    uint8_t magic[3] = {0};
+    CHECK_AND_RETURN_RET(ReadAt(pos, magic, sizeof(magic)), false);
+    if (memcmp(magic, "ID3", sizeof(magic)) == 0) {
+        CHECK_AND_RETURN_RET(ParseId3v2(pos, info), false);
+    }
+
+    uint8_t header[MPEG_HEADER_SIZE] = {0};
+    CHECK_AND_RETURN_RET(ReadAt(pos, header, sizeof(header)), false);
+    bool ret = false;
+    if (header[0] == 0xFF && (header[1] & 0xF6) == 0xF0) {
+        ret = ParseAdtsFrames(pos, info);
+    } else {
+        ret = ParseMp3Frames(pos, info);
+    }
+    CHECK_AND_RETURN_RET(ret, false);
+
+    // the same as the typefind of the pipeline: "application/x-id3" for the tagged one, otherwise "audio/mpeg".
+    info.fileMime = info.hasId3 ? FILE_MIMETYPE_AUDIO_MP3 : FILE_MIMETYPE_AUDIO_AAC;
+    info.trackCount = 1;
+    info.hasAudio = true;
+    return true;
+}
+
+bool AVMetaHeaderParser::ParseMp3Frames(uint64_t pos, AVMetaHeaderInfo &info)
+{
+    uint8_t header[MPEG_HEADER_SIZE] = {0};
+    MpegAudioHeader first;
+    CHECK_AND_RETURN_RET(ReadAt(pos, header, sizeof(header)) && ParseMpegAudioHeader(header, first), false);
+
+    // the second frame confirms the sync
+    MpegAudioHeader second;
+    if (pos + first.frameSize + MPEG_HEADER_SIZE <= size_) {
+        CHECK_AND_RETURN_RET(ReadAt(pos + first.frameSize, header, sizeof(header)), false);
+        CHECK_AND_RETURN_RET(ParseMpegAudioHeader(header, second), false);
+        CHECK_AND_RETURN_RET(second.version == first.version && second.layer == first.layer &&
+            second.sampleRate == first.sampleRate, false);
+    }
+
+    // the xing or info header of the layer 3 vbr, after the side information
+    uint64_t frames = 0;
+    std::vector<uint8_t> frame;
+    CHECK_AND_RETURN_RET(ReadAt(pos, std::min<size_t>(first.frameSize, size_ - pos), frame), false);
+    size_t sideInfoSize = (first.version == 1) ? (first.mono ? 17 : 32) : (first.mono ? 9 : 17); // 9, 17, 32: bytes
+    size_t xingPos = MPEG_HEADER_SIZE + sideInfoSize;
+    static constexpr size_t xingSize = 12;
+    static constexpr size_t vbriPos = 36;
+    static constexpr size_t vbriSize = 18;
+    static constexpr uint32_t layer3 = 3;
+    if (first.layer == layer3 && frame.size() >= xingPos + xingSize &&
+        (memcmp(frame.data() + xingPos, "Xing", 4) == 0 || memcmp(frame.data() + xingPos, "Info", 4) == 0)) { // 4
+        static constexpr uint32_t framesFlag = 0x1;
+        if ((U32BE(frame.data() + xingPos + 4) & framesFlag) != 0) { // 4: the flags
+            frames = U32BE(frame.data() + xingPos + 8); // 8: the frame count
+        }
+    } else if (frame.size() >= vbriPos + vbriSize && memcmp(frame.data() + vbriPos, "VBRI", 4) == 0) { // 4
+        frames = U32BE(frame.data() + vbriPos + 14); // 14: the frame count
+    }
+
+    if (frames != 0) {
+        info.durationMs = ScaleToMs(frames * first.samplesPerFrame, first.sampleRate);
+    } else {
+        uint64_t end = size_;
+        uint8_t tag[3] = {0};
+        if (size_ >= pos + ID3V1_SIZE && ReadAt(size_ - ID3V1_SIZE, tag, sizeof(tag)) &&
+            memcmp(tag, "TAG", sizeof(tag)) == 0) {
+            end -= ID3V1_SIZE;
+        }
+        static constexpr uint64_t bitsPerByte = 8;
+        info.durationMs = static_cast<int64_t>((end - pos) * bitsPerByte / first.bitrate);
+    }
+    info.sampleRate = static_cast<int32_t>(first.sampleRate);
+    return true;
+}
+
+bool AVMetaHeaderParser::ParseAdtsFrames(uint64_t pos, AVMetaHeaderInfo &info)
+{
+    static const uint32_t sampleRates[] = {
+        96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000, 11025, 8000, 7350
+    };
+
+    uint64_t end = size_;
+    uint8_t tag[3] = {0};
+    if (size_ >= pos + ID3V1_SIZE && ReadAt(size_ - ID3V1_SIZE, tag, sizeof(tag)) &&
+        memcmp(tag, "TAG", sizeof(tag)) == 0) {
+        end -= ID3V1_SIZE;
+    }
+
+    // no index in adts, walk through the frame headers.
+    std::vector<uint8_t> chunk;
+    uint64_t chunkPos = 0;
+    uint32_t sampleRateIndex = UINT32_MAX;
+    uint64_t samples = 0;
+    while (pos + ADTS_HEADER_SIZE <= end) {
+        if (pos < chunkPos || pos + ADTS_HEADER_SIZE > chunkPos + chunk.size()) {
+            CHECK_AND_RETURN_RET(ReadAt(pos, std::min<uint64_t>(SCAN_CHUNK_SIZE, end - pos), chunk), false);
+            chunkPos = pos;
+        }
+        const uint8_t *header = chunk.data() + (pos - chunkPos);
+        if (header[0] != 0xFF || (header[1] & 0xF6) != 0xF0) {
+            break;
+        }
+        uint32_t index = (header[2] >> 2) & 0xF; // 2: the sample rate bits
+        CHECK_AND_RETURN_RET(index < sizeof(sampleRates) / sizeof(sampleRates[0]), false);
+        CHECK_AND_RETURN_RET(sampleRateIndex == UINT32_MAX || sampleRateIndex == index, false);
+        sampleRateIndex = index;
+
+        uint32_t frameSize = (static_cast<uint32_t>(header[3] & 0x3) << 11) | // 3, 11: the high 2 bits
+            (static_cast<uint32_t>(header[4]) << 3) | (header[5] >> 5); // 4, 5, 3: the low 11 bits
+        CHECK_AND_RETURN_RET(frameSize >= ADTS_HEADER_SIZE, false);
+        samples += ADTS_SAMPLES_PER_FRAME * ((header[6] & 0x3) + 1); // 6: the raw data blocks
+        pos += frameSize;
+    }
+    CHECK_AND_RETURN_RET(samples != 0 && (pos >= end || end - pos <= MAX_ADTS_TRAILING_SIZE), false);
+
+    info.sampleRate = static_cast<int32_t>(sampleRates[sampleRateIndex]);
+    info.durationMs = ScaleToMs(samples, sampleRates[sampleRateIndex]);
+    return true;
+}
+
+/**
+ * FLAC, the STREAMINFO and VORBIS_COMMENT blocks.
+ */
+static void ParseVorbisComment(const uint8_t *data, size_t size, Metadata &tags)
+{
+    static const std::unordered_map<std::string, int32_t> keys = {
+        { "TITLE", AV_KEY_TITLE }, { "ARTIST", AV_KEY_ARTIST }, { "ALBUM", AV_KEY_ALBUM },
+        { "ALBUMARTIST", AV_KEY_ALBUM_ARTIST }, { "ALBUM ARTIST", AV_KEY_ALBUM_ARTIST },
+        { "GENRE", AV_KEY_GENRE }, { "COMPOSER", AV_KEY_COMPOSER }, { "DATE", AV_KEY_DATE_TIME },
+    };
+    static constexpr size_t lengthSize = 4;
+    CHECK_AND_RETURN(size >= lengthSize);
+    size_t pos = lengthSize + U32LE(data);
+    CHECK_AND_RETURN(pos >= lengthSize && pos <= size - lengthSize);
+    uint32_t count = U32LE(data + pos);
+    pos += lengthSize;
+
+    for (uint32_t i = 0; i < count && pos + lengthSize <= size; i++) {
+        uint32_t length = U32LE(data + pos);
+        pos += lengthSize;
+        CHECK_AND_RETURN(length <= size - pos);
+        std::string comment(reinterpret_cast<const char *>(data + pos), length);
+        pos += length;
+
+        size_t delim = comment.find('=');
+        if (delim == std::string::npos) {
+            continue;
+        }
+        std::string name = comment.substr(0, delim);
+        std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+        auto it = keys.find(name);
+        if (it != keys.end()) {
+            SetTag(tags, it->second, comment.substr(delim + 1));
+        }
+    }
+}
+
+bool AVMetaHeaderParser::ParseFlac(AVMetaHeaderInfo &info)
+{
+    static constexpr size_t blockHeaderSize = 4;
+    static constexpr uint8_t typeStreamInfo = 0;
+    static constexpr uint8_t typeVorbisComment = 4;
+    static constexpr uint8_t typeInvalid = 0x7F;
+    uint64_t pos = 4; // 4: after "fLaC"
+    bool last = false;
+    bool hasStreamInfo = false;
+    while (!last) {
+        uint8_t header[blockHeaderSize] = {0};
+        CHECK_AND_RETURN_RET(ReadAt(pos, header, sizeof(header)), false);
+        last = (header[0] & 0x80) != 0;
+        uint8_t type = header[0] & 0x7F;
+        uint32_t length = U24BE(header + 1);
+        pos += blockHeaderSize;
+        CHECK_AND_RETURN_RET(type != typeInvalid && length <= size_ - pos, false);
+
+        std::vector<uint8_t> block;
+        if (type == typeStreamInfo) {
+            CHECK_AND_RETURN_RET(length >= FLAC_STREAMINFO_SIZE, false);
+            CHECK_AND_RETURN_RET(ReadAt(pos, FLAC_STREAMINFO_SIZE, block), false);
+            uint32_t sampleRate = U24BE(block.data() + 10) >> 4; // 10, 4: the 20 bits sample rate
+            uint64_t samples = (static_cast<uint64_t>(block[13] & 0x0F) << 32) | U32BE(block.data() + 14); // 13, 14
+            CHECK_AND_RETURN_RET(sampleRate != 0 && samples != 0, false);
+            info.sampleRate = static_cast<int32_t>(sampleRate);
+            info.durationMs = ScaleToMs(samples, sampleRate);
+            hasStreamInfo = true;
+        } else if (type == typeVorbisComment && length <= MAX_ELEMENT_SIZE) {
+            CHECK_AND_RETURN_RET(ReadAt(pos, length, block), false);
+            ParseVorbisComment(block.data(), block.size(), info.tags);
+        }
+        pos += length;
+    }
+    CHECK_AND_RETURN_RET(hasStreamInfo, false);
+
+    info.fileMime = FILE_MIMETYPE_AUDIO_FLAC;
+    info.trackCount = 1;
+    info.hasAudio = true;
+    return true;
+}
+
+/**
+ * WAV, the fmt, data and LIST-INFO chunks.
+ */
+static void ParseRiffInfo(const uint8_t *data, size_t size, Metadata &tags)
+{
+    static const std::unordered_map<uint32_t, int32_t> keys = {
+        { FourCC("INAM"), AV_KEY_TITLE }, { FourCC("IART"), AV_KEY_ARTIST }, { FourCC("IPRD"), AV_KEY_ALBUM },
+        { FourCC("IGNR"), AV_KEY_GENRE }, { FourCC("ICRD"), AV_KEY_DATE_TIME },
+    };
+    static constexpr size_t chunkHeaderSize = 8;
+    size_t pos = 4; // 4: after "INFO"
+    while (pos + chunkHeaderSize <= size) {
+        uint32_t id = U32BE(data + pos);
+        uint32_t length = U32LE(data + pos + 4); // 4: the length follows the id
+        pos += chunkHeaderSize;
+        CHECK_AND_RETURN(length <= size - pos);
+        auto it = keys.find(id);
+        if (it != keys.end()) {
+            SetTag(tags, it->second, CutAtNul(data + pos, length));
+        }
+        pos += length + (length & 1);
+    }
+}
+
+bool AVMetaHeaderParser::ParseWav(AVMetaHeaderInfo &info)
+{
+    static constexpr size_t chunkHeaderSize = 8;
+    uint64_t pos = 12; // 12: after "RIFF", the size and "WAVE"
+    uint32_t sampleRate = 0;
+    uint32_t byteRate = 0;
+    uint64_t dataSize = 0;
+    bool hasFmt = false;
+    bool hasData = false;
+    while (pos + chunkHeaderSize <= size_) {
+        uint8_t header[chunkHeaderSize] = {0};
+        CHECK_AND_RETURN_RET(ReadAt(pos, header, sizeof(header)), false);
+        uint32_t id = U32BE(header);
+        uint64_t length = U32LE(header + 4); // 4: the length follows the id
+        pos += chunkHeaderSize;
+        // the data chunk of a growing or a truncated file
+        length = std::min<uint64_t>(length, size_ - pos);
+
+        std::vector<uint8_t> chunk;
+        if (id == FourCC("fmt ")) {
+            CHECK_AND_RETURN_RET(length >= WAV_FMT_SIZE && ReadAt(pos, WAV_FMT_SIZE, chunk), false);
+            sampleRate = U32LE(chunk.data() + 4); // 4: after the format and channels
+            byteRate = U32LE(chunk.data() + 8); // 8: after the sample rate
+            hasFmt = true;
+        } else if (id == FourCC("data")) {
+            dataSize = length;
+            hasData = true;
+        } else if (id == FourCC("LIST") && length >= 4 && length <= MAX_ELEMENT_SIZE) { // 4: the list type
+            CHECK_AND_RETURN_RET(ReadAt(pos, static_cast<size_t>(length), chunk), false);
+            if (U32BE(chunk.data()) == FourCC("INFO")) {
+                ParseRiffInfo(chunk.data(), chunk.size(), info.tags);
+            }
+        }
+        pos += length + (length & 1);
+    }
+    CHECK_AND_RETURN_RET(hasFmt && hasData && byteRate != 0, false);
+
+    info.fileMime = FILE_MIMETYPE_AUDIO_WAV;
+    info.durationMs = ScaleToMs(dataSize, byteRate);
+    info.sampleRate = static_cast<int32_t>(sampleRate);
+    info.trackCount = 1;
+    info.hasAudio = true;
+    return true;
+}
+
+/**
+ * Matroska and WebM, the Info, Tracks and Tags before the first Cluster or located by the SeekHead.
+ */
+static bool ReadEbmlVint(const uint8_t *data, size_t size, bool keepMarker, uint64_t &value, size_t &length)
+{
+    static constexpr size_t maxLength = 8;
+    CHECK_AND_RETURN_RET(size > 0 && data[0] != 0, false);
+    uint8_t mask = 0x80;
+    length = 1;
+    while ((data[0] & mask) == 0) {
+        mask >>= 1;
+        length++;
+    }
+    CHECK_AND_RETURN_RET(length <= maxLength && length <= size, false);
+
+    value = keepMarker ? data[0] : (data[0] & (mask - 1));
+    bool allOnes = (data[0] & (mask - 1)) == (mask - 1);
+    for (size_t i = 1; i < length; i++) {
+        value = (value << 8) | data[i]; // 8: bits of byte
+        allOnes = allOnes && data[i] == 0xFF;
+    }
+    if (!keepMarker && allOnes) {
+        value = EBML_UNKNOWN_SIZE;
+    }
+    return true;
+}
+
+static bool ReadEbmlElementHeader(const uint8_t *data, size_t size, uint32_t &id, uint64_t &elemSize,
+    size_t &headerSize)
+{
+    static constexpr size_t maxIdLength = 4;
+    uint64_t idValue = 0;
+    size_t idLength = 0;
+    size_t sizeLength = 0;
+    CHECK_AND_RETURN_RET(ReadEbmlVint(data, size, true, idValue, idLength) && idLength <= maxIdLength, false);
+    CHECK_AND_RETURN_RET(ReadEbmlVint(data + idLength, size - idLength, false, elemSize, sizeLength), false);
+    id = static_cast<uint32_t>(idValue);
+    headerSize = idLength + sizeLength;
+    return true;
+}
+
+using EbmlVisitor = std::function<bool(uint32_t id, const uint8_t *data, size_t size)>;
+
+static bool ForEachEbmlElement(const uint8_t *data, size_t size, const EbmlVisitor &visitor)
+{
+    size_t pos = 0;
+    while (pos < size) {
+        uint32_t id = 0;
+        uint64_t elemSize = 0;
+        size_t headerSize = 0;
+        CHECK_AND_RETURN_RET(ReadEbmlElementHeader(data + pos, size - pos, id, elemSize, headerSize), false);
+        CHECK_AND_RETURN_RET(elemSize != EBML_UNKNOWN_SIZE && elemSize <= size - pos - headerSize, false);
+        CHECK_AND_RETURN_RET(visitor(id, data + pos + headerSize, static_cast<size_t>(elemSize)), false);
+        pos += headerSize + static_cast<size_t>(elemSize);
+    }
+    return true;
+}
+
+static uint64_t EbmlUint(const uint8_t *data, size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < size && i < sizeof(value); i++) {
+        value = (value << 8) | data[i]; // 8: bits of byte
+    }
+    return value;
+}
+
+static double EbmlFloat(const uint8_t *data, size_t size)
+{
+    if (size == sizeof(float)) {
+        uint32_t bits = U32BE(data);
+        float value = 0;
+        CHECK_AND_RETURN_RET(memcpy_s(&value, sizeof(value), &bits, sizeof(bits)) == EOK, 0);
+        return value;
+    }
+    if (size == sizeof(double)) {
+        uint64_t bits = U64BE(data);
+        double value = 0;
+        CHECK_AND_RETURN_RET(memcpy_s(&value, sizeof(value), &bits, sizeof(bits)) == EOK, 0);
+        return value;
+    }
+    return 0;
+}
+
+struct MatroskaInfo {
+    uint64_t timecodeScale = MKV_DEFAULT_TIMECODESCALE;
+    double duration = 0;
+    bool hasInfo = false;
+    bool hasTracks = false;
+};
+
+static bool ParseMatroskaInfo(const uint8_t *data, size_t size, MatroskaInfo &mkv,
+    AVMetaHeaderInfo &info)
+{
+    mkv.hasInfo = true;
+    return ForEachEbmlElement(data, size, [&mkv, &info](uint32_t id, const uint8_t *value, size_t valueSize) {
+        if (id == MKV_ID_TIMECODESCALE) {
+            mkv.timecodeScale = EbmlUint(value, valueSize);
+        } else if (id == MKV_ID_DURATION) {
+            mkv.duration = EbmlFloat(value, valueSize);
+        } else if (id == MKV_ID_TITLE) {
+            SetTag(info.tags, AV_KEY_TITLE, CutAtNul(value, valueSize));
+        } else if (id == MKV_ID_DATEUTC && valueSize == sizeof(int64_t)) {
+            time_t seconds = static_cast<time_t>(static_cast<int64_t>(EbmlUint(value, valueSize)) /
+                static_cast<int64_t>(NSEC_PER_SEC) + MKV_DATE_ORIGIN_SEC);
+            struct tm utc = {};
+            char buffer[32] = {0}; // 32: enough for "YYYY-MM-DD HH:MM:SS"
+            if (gmtime_r(&seconds, &utc) != nullptr && strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &utc) > 0) {
+                SetTag(info.tags, AV_KEY_DATE_TIME, buffer);
+            }
+        }
+        return true;
+    });
+}
+
+static bool ParseMatroskaTracks(const uint8_t *data, size_t size, MatroskaInfo &mkv,
+    AVMetaHeaderInfo &info)
+{
+    mkv.hasTracks = true;
+    return ForEachEbmlElement(data, size, [&info](uint32_t id, const uint8_t *entry, size_t entrySize) {
+        if (id != MKV_ID_TRACKENTRY) {
+            return true;
+        }
+        uint64_t type = 0;
+        uint64_t width = 0;
+        uint64_t height = 0;
+        double sampleRate = 0;
+        bool hasName = false;
+        bool ret = ForEachEbmlElement(entry, entrySize, [&](uint32_t child, const uint8_t *value, size_t valueSize) {
+            if (child == MKV_ID_TRACKTYPE) {
+                type = EbmlUint(value, valueSize);
+            } else if (child == MKV_ID_NAME) {
+                hasName = valueSize != 0;
+            } else if (child == MKV_ID_VIDEO) {
+                return ForEachEbmlElement(value, valueSize, [&](uint32_t videoId, const uint8_t *v, size_t vSize) {
+                    if (videoId == MKV_ID_PIXELWIDTH) {
+                        width = EbmlUint(v, vSize);
+                    } else if (videoId == MKV_ID_PIXELHEIGHT) {
+                        height = EbmlUint(v, vSize);
+                    }
+                    return true;
+                });
+            } else if (child == MKV_ID_AUDIO) {
+                return ForEachEbmlElement(value, valueSize, [&](uint32_t audioId, const uint8_t *v, size_t vSize) {
+                    if (audioId == MKV_ID_SAMPLINGFREQUENCY) {
+                        sampleRate = EbmlFloat(v, vSize);
+                    }
+                    return true;
+                });
+            }
+            return true;
+        });
+        // the demuxer reports the track name as the title of the stream, leave it to the pipeline.
+        CHECK_AND_RETURN_RET(ret && !hasName, false);
+
+        if (type == MKV_TRACK_TYPE_VIDEO) {
+            if (!info.hasVideo) {
+                info.width = static_cast<int32_t>(std::min<uint64_t>(width, INT32_MAX));
+                info.height = static_cast<int32_t>(std::min<uint64_t>(height, INT32_MAX));
+            }
+            info.hasVideo = true;
+            info.trackCount++;
+        } else if (type == MKV_TRACK_TYPE_AUDIO) {
+            if (!info.hasAudio) {
+                info.sampleRate = (sampleRate > 0 && sampleRate < INT32_MAX) ? static_cast<int32_t>(sampleRate) : 0;
+            }
+            info.hasAudio = true;
+            info.trackCount++;
+        } else if (type == MKV_TRACK_TYPE_SUBTITLE) {
+            info.trackCount++;
+        }
+        return true;
+    });
+}
+
+static bool ParseMatroskaTags(const uint8_t *data, size_t size)
+{
+    // only the tags of the tracks are expected, e.g. the statistics written by mkvmerge. The targets of
+    // the global tags decide their meaning, e.g. an album or a track title, leave them to the pipeline.
+    return ForEachEbmlElement(data, size, [](uint32_t id, const uint8_t *tag, size_t tagSize) {
+        if (id != MKV_ID_TAG) {
+            return true;
+        }
+        bool hasTargetUid = false;
+        bool hasSimpleTag = false;
+        bool ret = ForEachEbmlElement(tag, tagSize, [&](uint32_t child, const uint8_t *value, size_t valueSize) {
+            if (child == MKV_ID_TARGETS) {
+                static constexpr uint32_t targetTypeValueId = 0x68CA;
+                static constexpr uint32_t targetTypeId = 0x63CA;
+                return ForEachEbmlElement(value, valueSize, [&](uint32_t targetId, const uint8_t *, size_t) {
+                    hasTargetUid = hasTargetUid || (targetId != targetTypeValueId && targetId != targetTypeId);
+                    return true;
+                });
+            }
+            hasSimpleTag = hasSimpleTag || child == MKV_ID_SIMPLETAG;
+            return true;
+        });
+        return ret && (hasTargetUid || !hasSimpleTag);
+    });
+}
+
+bool AVMetaHeaderParser::ReadEbmlHeader(uint64_t pos, uint32_t &id, uint64_t &size, uint64_t &headerSize) const
+{
+    static constexpr size_t maxHeaderSize = 12;
+    uint8_t header[maxHeaderSize] = {0};
+    CHECK_AND_RETURN_RET(pos < size_, false);
+    size_t length = static_cast<size_t>(std::min<uint64_t>(maxHeaderSize, size_ - pos));
+    CHECK_AND_RETURN_RET(ReadAt(pos, header, length), false);
+
+    size_t elemHeaderSize = 0;
+    CHECK_AND_RETURN_RET(ReadEbmlElementHeader(header, length, id, size, elemHeaderSize), false);
+    headerSize = elemHeaderSize;
+    return true;
+}
+
+bool AVMetaHeaderParser::ParseMatroska(AVMetaHeaderInfo &info)
+{
+    uint32_t id = 0;
+    uint64_t elemSize = 0;
+    uint64_t headerSize = 0;
+    std::vector<uint8_t> body;
+    CHECK_AND_RETURN_RET(ReadEbmlHeader(0, id, elemSize, headerSize) && id == EBML_ID_HEADER, false);
+    CHECK_AND_RETURN_RET(elemSize <= MAX_ELEMENT_SIZE && elemSize <= size_ - headerSize, false);
+    CHECK_AND_RETURN_RET(ReadAt(headerSize, static_cast<size_t>(elemSize), body), false);
+    std::string docType;
+    CHECK_AND_RETURN_RET(ForEachEbmlElement(body.data(), body.size(), [&docType](uint32_t child,
+        const uint8_t *value, size_t valueSize) {
+        if (child == EBML_ID_DOCTYPE) {
+            docType = CutAtNul(value, valueSize);
+        }
+        return true;
+    }), false);
+    CHECK_AND_RETURN_RET(docType == "matroska" || docType == "webm", false);
+
+    uint64_t pos = headerSize + elemSize;
+    CHECK_AND_RETURN_RET(ReadEbmlHeader(pos, id, elemSize, headerSize) && id == MKV_ID_SEGMENT, false);
+    uint64_t segmentStart = pos + headerSize;
+    uint64_t segmentEnd = (elemSize == EBML_UNKNOWN_SIZE) ? size_ : std::min(size_, segmentStart + elemSize);
+
+    MatroskaInfo mkv;
+    bool hasTags = false;
+    std::unordered_map<uint32_t, uint64_t> seeks;
+    auto parseElement = [&](uint32_t elemId, const std::vector<uint8_t> &data) {
+        if (elemId == MKV_ID_INFO) {
+            return ParseMatroskaInfo(data.data(), data.size(), mkv, info);
+        } else if (elemId == MKV_ID_TRACKS) {
+            return ParseMatroskaTracks(data.data(), data.size(), mkv, info);
+        } else if (elemId == MKV_ID_TAGS) {
+            hasTags = true;
+            return ParseMatroskaTags(data.data(), data.size());
+        }
+        return ForEachEbmlElement(data.data(), data.size(), [&seeks](uint32_t child, const uint8_t *seek,
+            size_t seekSize) {
+            uint64_t seekId = 0;
+            uint64_t seekPos = 0;
+            bool ret = child != MKV_ID_SEEK || ForEachEbmlElement(seek, seekSize, [&](uint32_t seekChild,
+                const uint8_t *value, size_t valueSize) {
+                if (seekChild == MKV_ID_SEEKID) {
+                    seekId = EbmlUint(value, valueSize);
+                } else if (seekChild == MKV_ID_SEEKPOSITION) {
+                    seekPos = EbmlUint(value, valueSize);
+                }
+                return true;
+            });
+            if (seekId != 0 && seeks.count(static_cast<uint32_t>(seekId)) == 0) {
+                seeks[static_cast<uint32_t>(seekId)] = seekPos;
+            }
+            return ret;
+        });
+    };
+
+    // the top level elements before the first cluster
+    pos = segmentStart;
+    while (pos < segmentEnd) {
+        CHECK_AND_RETURN_RET(ReadEbmlHeader(pos, id, elemSize, headerSize), false);
+        if (id == MKV_ID_CLUSTER) {
+            break;
+        }
+        CHECK_AND_RETURN_RET(elemSize != EBML_UNKNOWN_SIZE && elemSize <= segmentEnd - pos - headerSize, false);
+        if (id == MKV_ID_INFO || id == MKV_ID_TRACKS || id == MKV_ID_TAGS || id == MKV_ID_SEEKHEAD) {
+            CHECK_AND_RETURN_RET(elemSize <= MAX_ELEMENT_SIZE, false);
+            CHECK_AND_RETURN_RET(ReadAt(pos + headerSize, static_cast<size_t>(elemSize), body), false);
+            CHECK_AND_RETURN_RET(parseElement(id, body), false);
+        }
+        pos += headerSize + elemSize;
+    }
+
+    // the elements behind the clusters
+    for (uint32_t target : { MKV_ID_INFO, MKV_ID_TRACKS, MKV_ID_TAGS }) {
+        bool parsed = (target == MKV_ID_INFO) ? mkv.hasInfo : ((target == MKV_ID_TRACKS) ? mkv.hasTracks : hasTags);
+        auto it = seeks.find(target);
+        if (parsed || it == seeks.end()) {
+            continue;
+        }
+        pos = segmentStart + it->second;
+        CHECK_AND_RETURN_RET(ReadEbmlHeader(pos, id, elemSize, headerSize) && id == target, false);
+        CHECK_AND_RETURN_RET(elemSize <= MAX_ELEMENT_SIZE && elemSize <= segmentEnd - pos - headerSize, false);
+        CHECK_AND_RETURN_RET(ReadAt(pos + headerSize, static_cast<size_t>(elemSize), body), false);
+        CHECK_AND_RETURN_RET(parseElement(id, body), false);
+    }
+    CHECK_AND_RETURN_RET(mkv.hasInfo && mkv.hasTracks && mkv.duration > 0, false);
+
+    double durationMs = mkv.duration * static_cast<double>(mkv.timecodeScale) / NSEC_PER_MSEC;
+    CHECK_AND_RETURN_RET(durationMs < static_cast<double>(INT64_MAX), false);
+    info.durationMs = static_cast<int64_t>(durationMs);
+    if (docType == "webm") {
+        info.fileMime = info.hasVideo ? FILE_MIMETYPE_VIDEO_WEBM : FILE_MIMETYPE_AUDIO_WEBM;
+    } else {
+        info.fileMime = info.hasVideo ? FILE_MIMETYPE_VIDEO_MKV : FILE_MIMETYPE_AUDIO_MKV;
+    }
+    return true;
+}
+
+AVMetaHeaderParser::AVMetaHeaderParser(int32_t fd, int64_t offset, int64_t size)
+    : fd_(fd), offset_(static_cast<uint64_t>(std::max<int64_t>(offset, 0))),
+      size_(static_cast<uint64_t>(std::max<int64_t>(size, 0)))
+{
+    MEDIA_LOGD("enter ctor, instance: 0x%{public}06" PRIXPTR "", FAKE_POINTER(this));
+}
+
+AVMetaHeaderParser::~AVMetaHeaderParser()
+{
+    MEDIA_LOGD("enter dtor, instance: 0x%{public}06" PRIXPTR "", FAKE_POINTER(this));
+}
+
+bool AVMetaHeaderParser::ReadAt(uint64_t pos, uint8_t *data, size_t size) const
+{
+    CHECK_AND_RETURN_RET(pos <= size_ && size <= size_ - pos, false);
+
+    size_t done = 0;
+    while (done < size) {
+        ssize_t ret = pread(fd_, data + done, size - done, static_cast<off_t>(offset_ + pos + done));
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        CHECK_AND_RETURN_RET_LOG(ret > 0, false, "read failed at %{public}" PRIu64 ", errno: %{public}d",
+            pos + done, errno);
+        done += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+bool AVMetaHeaderParser::ReadAt(uint64_t pos, size_t size, std::vector<uint8_t> &data) const
+{
+    data.resize(size);
+    return ReadAt(pos, data.data(), size);
+}
+
+static void ExportMeta(const AVMetaHeaderInfo &info, Metadata &meta)
+{
+    meta = info.tags;
+
+    // the same as AVMetaMetaCollector::AdjustMimeType
+    std::string mimeType = info.fileMime;
+    if (mimeType == FILE_MIMETYPE_VIDEO_MP4 && !info.hasVideo && info.hasAudio) {
+        mimeType = FILE_MIMETYPE_AUDIO_MP4;
+    }
+    meta.SetMeta(AV_KEY_MIME_TYPE, mimeType);
+    meta.SetMeta(AV_KEY_DURATION, std::to_string(info.durationMs));
+    meta.SetMeta(AV_KEY_NUM_TRACKS, std::to_string(info.trackCount));
+    if (info.hasAudio) {
+        meta.SetMeta(AV_KEY_HAS_AUDIO, "yes");
+        if (info.sampleRate > 0) {
+            meta.SetMeta(AV_KEY_SAMPLE_RATE, std::to_string(info.sampleRate));
+        }
+    }
+    if (info.hasVideo) {
+        meta.SetMeta(AV_KEY_HAS_VIDEO, "yes");
+        if (info.width > 0 && info.height > 0) {
+            meta.SetMeta(AV_KEY_VIDEO_WIDTH, std::to_string(info.width));
+            meta.SetMeta(AV_KEY_VIDEO_HEIGHT, std::to_string(info.height));
+        }
+        if (info.rotation >= 0) {
+            meta.SetMeta(AV_KEY_VIDEO_ORIENTATION, std::to_string(info.rotation));
+        }
+    }
+    PopulateMeta(meta);
+}
+
+int32_t AVMetaHeaderParser::Parse(Metadata &meta)
+{
+    CHECK_AND_RETURN_RET(fd_ >= 0, MSERR_INVALID_VAL);
+
+    static constexpr size_t probeSize = 12;
+    uint8_t probe[probeSize] = {0};
+    CHECK_AND_RETURN_RET(ReadAt(0, probe, sizeof(probe)), MSERR_UNSUPPORT);
+
+    AVMetaHeaderInfo info;
+    bool ret = false;
+    if (IsMp4TopBox(U32BE(probe + 4))) { // 4: the type of the first box
+        ret = ParseMp4(info);
+    } else if (U32BE(probe) == EBML_ID_HEADER) {
+        ret = ParseMatroska(info);
+    } else if (U32BE(probe) == FourCC("RIFF") && U32BE(probe + 8) == FourCC("WAVE")) { // 8: the riff type
+        ret = ParseWav(info);
+    } else if (U32BE(probe) == FourCC("fLaC")) {
+        ret = ParseFlac(info);
+    } else {
+        ret = ParseMpegAudio(info);
+    }
+
+    if (!ret || info.fileMime.empty() || info.durationMs <= 0 || info.trackCount <= 0) {
+        MEDIA_LOGI("not resolved by the header, fall back to the pipeline");
+        return MSERR_UNSUPPORT;
+    }
+
+    ExportMeta(info, meta);
+    MEDIA_LOGI("resolved by the header, mime: %{public}s, duration: %{public}" PRIi64 ", tracks: %{public}d",
+        info.fileMime.c_str(), info.durationMs, info.trackCount);
+    return MSERR_OK;
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETA_HEADER_PARSER_H
+#define AVMETA_HEADER_PARSER_H
+
+#include <cstdint>
+#include <vector>
+#include "avmeta_elem_meta_collector.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+struct AVMetaHeaderInfo;
+
+/**
+ * Resolve the metadata by reading only the headers of the container through the fd, without
+ * building the pipeline. MP4/MOV, MP3, ADTS, FLAC, WAV and Matroska/WebM are recognized.
+ *
+ * The result is the same as the one collected from the pipeline, so anything not completely
+ * understood, e.g. a fragmented mp4 or a numeric id3 genre, is rejected, and the caller should
+ * fall back to the pipeline then. The art picture is never parsed.
+ */
+class AVMetaHeaderParser : public NoCopyable {
+public:
+    /**
+     * @param fd the fd to read, not owned by the parser.
+     * @param offset the start of the media in the fd.
+     * @param size the size of the media.
+     */
+    AVMetaHeaderParser(int32_t fd, int64_t offset, int64_t size);
+    ~AVMetaHeaderParser();
+
+    /**
+     * @return MSERR_OK if resolved, MSERR_UNSUPPORT if the pipeline is required.
+     */
+    int32_t Parse(Metadata &meta);
+
+private:
+    bool ReadAt(uint64_t pos, uint8_t *data, size_t size) const;
+    bool ReadAt(uint64_t pos, size_t size, std::vector<uint8_t> &data) const;
+    bool ParseMp4(AVMetaHeaderInfo &info);
+    bool ParseMpegAudio(AVMetaHeaderInfo &info);
+    bool ParseId3v2(uint64_t &pos, AVMetaHeaderInfo &info);
+    bool ParseMp3Frames(uint64_t pos, AVMetaHeaderInfo &info);
+    bool ParseAdtsFrames(uint64_t pos, AVMetaHeaderInfo &info);
+    bool ParseFlac(AVMetaHeaderInfo &info);
+    bool ParseWav(AVMetaHeaderInfo &info);
+    bool ParseMatroska(AVMetaHeaderInfo &info);
+    bool ReadEbmlHeader(uint64_t pos, uint32_t &id, uint64_t &size, uint64_t &headerSize) const;
+
+    int32_t fd_ = -1;
+    uint64_t offset_ = 0;
+    uint64_t size_ = 0;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMETA_HEADER_PARSER_H
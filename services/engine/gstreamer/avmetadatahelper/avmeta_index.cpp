@@ -0,0 +1,459 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmeta_index.h"
+#include <algorithm>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "avsharedmemorybase.h"
+#include "media_errors.h"
+#include "media_log.h"
+#include "param_wrapper.h"
+#include "securec.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetaIndex"};
+    constexpr const char *INDEX_PATH = "/data/media/avmeta_index";
+    constexpr const char *TMP_SUFFIX = ".tmp";
+    constexpr uint32_t FILE_MAGIC = 0x494D5641; // "AVMI"
+    // bump it when the metadata resolved for the same file may change
+    constexpr uint32_t FILE_VERSION = 1;
+    constexpr uint32_t RECORD_MAGIC = 0x52454D41; // "AMER"
+    constexpr uint32_t RECORD_ALIGN = 8;
+    constexpr uint32_t MAX_RECORD_SIZE = 4 * 1024 * 1024;
+    constexpr uint64_t MAX_FILE_SIZE = 32 * 1024 * 1024;
+    // not worth compacting a small file
+    constexpr uint64_t MIN_COMPACT_SIZE = 1024 * 1024;
+    constexpr uint32_t FNV_OFFSET_BASIS = 2166136261U;
+    constexpr uint32_t FNV_PRIME = 16777619U;
+    constexpr int64_t NSEC_PER_SEC = 1000000000;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t reserved;
+    };
+
+    uint32_t Checksum(const uint8_t *data, size_t size)
+    {
+        uint32_t hash = FNV_OFFSET_BASIS;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= data[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+}
+
+namespace OHOS {
+namespace Media {
+namespace {
+struct Record {
+    uint32_t magic;
+    // the whole record including this header and the padding
+    uint32_t size;
+    // of all the bytes following this header
+    uint32_t checksum;
+    uint32_t metaCount;
+    uint32_t artSize;
+    uint32_t reserved;
+    AVMetaIndexKey key;
+};
+}
+
+// the payload following the header: metaCount * {int32_t key, uint32_t length, char value[length]},
+// then the art picture of artSize bytes, then the padding to RECORD_ALIGN.
+static bool ParseRecord(const uint8_t *data, uint64_t avail, Record &record, uint32_t &artPos,
+    std::unordered_map<int32_t, std::string> *meta)
+{
+    CHECK_AND_RETURN_RET(avail >= sizeof(record), false);
+    CHECK_AND_RETURN_RET(memcpy_s(&record, sizeof(record), data, sizeof(record)) == EOK, false);
+    if (record.magic != RECORD_MAGIC || record.size < sizeof(record) || record.size > MAX_RECORD_SIZE ||
+        record.size > avail || record.size % RECORD_ALIGN != 0) {
+        return false;
+    }
+    if (Checksum(data + sizeof(record), record.size - sizeof(record)) != record.checksum) {
+        return false;
+    }
+
+    uint64_t pos = sizeof(record);
+    for (uint32_t i = 0; i < record.metaCount; i++) {
+        int32_t key = 0;
+        uint32_t length = 0;
+        CHECK_AND_RETURN_RET(pos + sizeof(key) + sizeof(length) <= record.size, false);
+        CHECK_AND_RETURN_RET(memcpy_s(&key, sizeof(key), data + pos, sizeof(key)) == EOK, false);
+        pos += sizeof(key);
+        CHECK_AND_RETURN_RET(memcpy_s(&length, sizeof(length), data + pos, sizeof(length)) == EOK, false);
+        pos += sizeof(length);
+        CHECK_AND_RETURN_RET(pos + length <= record.size, false);
+        if (meta != nullptr) {
+            (*meta)[key] = std::string(reinterpret_cast<const char *>(data + pos), length);
+        }
+        pos += length;
+    }
+
+    CHECK_AND_RETURN_RET(pos + record.artSize <= record.size, false);
+    artPos = static_cast<uint32_t>(pos);
+    return true;
+}
+
+static void AppendBytes(std::vector<uint8_t> &buffer, const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+bool AVMetaIndexKey::FromUri(const UriHelper &uri, AVMetaIndexKey &key)
+{
+    struct stat64 st;
+    int64_t offset = 0;
+    int64_t size = 0;
+    CHECK_AND_RETURN_RET(uri.GetFileRange(st, offset, size), false);
+
+    key.dev = static_cast<uint64_t>(st.st_dev);
+    key.ino = static_cast<uint64_t>(st.st_ino);
+    key.fileSize = static_cast<int64_t>(st.st_size);
+    key.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * NSEC_PER_SEC + static_cast<int64_t>(st.st_mtim.tv_nsec);
+    key.offset = offset;
+    key.size = size;
+    return true;
+}
+
+size_t AVMetaIndexKeyHash::operator()(const AVMetaIndexKey &key) const
+{
+    std::hash<uint64_t> hasher;
+    size_t hash = hasher(key.ino);
+    for (uint64_t value : { key.dev, static_cast<uint64_t>(key.fileSize), static_cast<uint64_t>(key.mtimeNs),
+        static_cast<uint64_t>(key.offset), static_cast<uint64_t>(key.size) }) {
+        hash = hash * FNV_PRIME ^ hasher(value);
+    }
+    return hash;
+}
+
+AVMetaIndex &AVMetaIndex::GetInstance()
+{
+    // never destroyed: the engines may still query it when static destructors run
+    static AVMetaIndex *instance = new AVMetaIndex();
+    return *instance;
+}
+
+AVMetaIndex::AVMetaIndex()
+    : AVMetaIndex(INDEX_PATH, MAX_FILE_SIZE, MIN_COMPACT_SIZE,
+        OHOS::system::GetIntParameter("sys.media.avmeta.index.enable", 1) != 0)
+{
+}
+
+AVMetaIndex::AVMetaIndex(const std::string &path, uint64_t maxFileSize, uint64_t minCompactSize, bool enable)
+    : path_(path), tmpPath_(path + TMP_SUFFIX), maxFileSize_(maxFileSize), minCompactSize_(minCompactSize)
+{
+    hitHandle_ = MediaMetrics::Inst().RegisterCounter("avmeta.index.hit");
+    missHandle_ = MediaMetrics::Inst().RegisterCounter("avmeta.index.miss");
+    storeHandle_ = MediaMetrics::Inst().RegisterCounter("avmeta.index.store");
+    compactHandle_ = MediaMetrics::Inst().RegisterCounter("avmeta.index.compact");
+    recordsHandle_ = MediaMetrics::Inst().RegisterGauge("avmeta.index.records");
+    bytesHandle_ = MediaMetrics::Inst().RegisterGauge("avmeta.index.bytes");
+
+    if (!enable) {
+        MEDIA_LOGI("avmeta index disabled");
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    enabled_ = (Open() == MSERR_OK);
+    MEDIA_LOGI("avmeta index enabled: %{public}d, records: %{public}zu", enabled_, entries_.size());
+}
+
+AVMetaIndex::~AVMetaIndex()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    Close();
+}
+
+bool AVMetaIndex::IsEnabled() const
+{
+    return enabled_;
+}
+
+int32_t AVMetaIndex::Open()
+{
+    fd_ = open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    CHECK_AND_RETURN_RET_LOG(fd_ >= 0, MSERR_OPEN_FILE_FAILED, "failed to open the index, errno: %{public}d", errno);
+
+    // the index is only shared by the threads of this process
+    if (flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+        MEDIA_LOGE("the index is locked by others");
+        Close();
+        return MSERR_INVALID_OPERATION;
+    }
+
+    int32_t ret = Load();
+    if (ret != MSERR_OK) {
+        Close();
+    }
+    return ret;
+}
+
+void AVMetaIndex::Close()
+{
+    if (base_ != nullptr) {
+        (void)munmap(base_, mappedSize_);
+        base_ = nullptr;
+        mappedSize_ = 0;
+    }
+    if (fd_ >= 0) {
+        (void)close(fd_);
+        fd_ = -1;
+    }
+    entries_.clear();
+    fileSize_ = 0;
+    deadBytes_ = 0;
+    UpdateGauges();
+}
+
+int32_t AVMetaIndex::Load()
+{
+    struct stat64 st;
+    CHECK_AND_RETURN_RET_LOG(fstat64(fd_, &st) == 0, MSERR_UNKNOWN, "can not get the index state");
+    uint64_t size = static_cast<uint64_t>(st.st_size);
+
+    FileHeader header = {};
+    bool valid = size >= sizeof(header) && pread(fd_, &header, sizeof(header), 0) == sizeof(header) &&
+        header.magic == FILE_MAGIC && header.version == FILE_VERSION;
+    if (!valid) {
+        MEDIA_LOGI("create the index, the old size: %{public}" PRIu64 "", size);
+        header = { FILE_MAGIC, FILE_VERSION, 0 };
+        CHECK_AND_RETURN_RET(ftruncate(fd_, 0) == 0, MSERR_UNKNOWN);
+        CHECK_AND_RETURN_RET(pwrite(fd_, &header, sizeof(header), 0) == sizeof(header), MSERR_UNKNOWN);
+        size = sizeof(header);
+    }
+
+    CHECK_AND_RETURN_RET(Map(size) == MSERR_OK, MSERR_UNKNOWN);
+    uint64_t offset = sizeof(header);
+    while (offset < size) {
+        Record record;
+        uint32_t artPos = 0;
+        if (!ParseRecord(base_ + offset, size - offset, record, artPos, nullptr)) {
+            break;
+        }
+        auto iter = entries_.find(record.key);
+        if (iter != entries_.end()) {
+            deadBytes_ += iter->second.size;
+        }
+        entries_[record.key] = { offset, record.size };
+        offset += record.size;
+    }
+
+    if (offset < size) {
+        // torn by a crash in the middle of the append
+        MEDIA_LOGW("cut off the index from %{public}" PRIu64 " to %{public}" PRIu64 "", size, offset);
+        CHECK_AND_RETURN_RET(ftruncate(fd_, static_cast<off_t>(offset)) == 0, MSERR_UNKNOWN);
+    }
+    fileSize_ = offset;
+    UpdateGauges();
+    return MSERR_OK;
+}
+
+int32_t AVMetaIndex::Map(size_t size)
+{
+    if (base_ != nullptr) {
+        (void)munmap(base_, mappedSize_);
+        base_ = nullptr;
+        mappedSize_ = 0;
+    }
+
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd_, 0);
+    CHECK_AND_RETURN_RET_LOG(addr != MAP_FAILED, MSERR_NO_MEMORY, "failed to map the index, errno: %{public}d", errno);
+    base_ = static_cast<uint8_t *>(addr);
+    mappedSize_ = size;
+    return MSERR_OK;
+}
+
+bool AVMetaIndex::Lookup(const AVMetaIndexKey &key, std::unordered_map<int32_t, std::string> &meta,
+    std::shared_ptr<AVSharedMemory> *artPicture)
+{
+    CHECK_AND_RETURN_RET(enabled_, false);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto iter = entries_.find(key);
+    if (iter == entries_.end() || !ReadRecord(iter->second.offset, meta, artPicture)) {
+        MediaMetrics::Inst().Add(missHandle_);
+        return false;
+    }
+
+    MediaMetrics::Inst().Add(hitHandle_);
+    return true;
+}
+
+bool AVMetaIndex::ReadRecord(uint64_t offset, std::unordered_map<int32_t, std::string> &meta,
+    std::shared_ptr<AVSharedMemory> *artPicture)
+{
+    if (fileSize_ > mappedSize_) {
+        // grown by the appends since mapped
+        CHECK_AND_RETURN_RET(Map(fileSize_) == MSERR_OK, false);
+    }
+
+    Record record;
+    uint32_t artPos = 0;
+    std::unordered_map<int32_t, std::string> result;
+    CHECK_AND_RETURN_RET_LOG(ParseRecord(base_ + offset, fileSize_ - offset, record, artPos, &result), false,
+        "invalid record at %{public}" PRIu64 "", offset);
+
+    if (artPicture != nullptr) {
+        *artPicture = nullptr;
+        if (record.artSize != 0) {
+            auto art = AVSharedMemoryBase::CreateFromLocal(
+                static_cast<int32_t>(record.artSize), AVSharedMemory::FLAGS_READ_ONLY, "artpic");
+            CHECK_AND_RETURN_RET_LOG(art != nullptr, false, "create art pic failed");
+            CHECK_AND_RETURN_RET(memcpy_s(art->GetBase(), static_cast<size_t>(art->GetSize()),
+                base_ + offset + artPos, record.artSize) == EOK, false);
+            *artPicture = art;
+        }
+    }
+
+    meta.swap(result);
+    return true;
+}
+
+void AVMetaIndex::Store(const AVMetaIndexKey &key, const std::unordered_map<int32_t, std::string> &meta,
+    const std::shared_ptr<AVSharedMemory> &artPicture)
+{
+    CHECK_AND_RETURN(enabled_ && !meta.empty());
+
+    Record record = {};
+    record.magic = RECORD_MAGIC;
+    record.metaCount = static_cast<uint32_t>(meta.size());
+    record.key = key;
+
+    std::vector<uint8_t> buffer(sizeof(record), 0);
+    for (auto &[metaKey, value] : meta) {
+        uint32_t length = static_cast<uint32_t>(value.size());
+        AppendBytes(buffer, &metaKey, sizeof(metaKey));
+        AppendBytes(buffer, &length, sizeof(length));
+        AppendBytes(buffer, value.data(), value.size());
+    }
+    if (artPicture != nullptr && artPicture->GetBase() != nullptr && artPicture->GetSize() > 0 &&
+        artPicture->GetSize() <= MAX_ART_PICTURE_SIZE) {
+        record.artSize = static_cast<uint32_t>(artPicture->GetSize());
+        AppendBytes(buffer, artPicture->GetBase(), record.artSize);
+    }
+    buffer.resize((buffer.size() + RECORD_ALIGN - 1) / RECORD_ALIGN * RECORD_ALIGN, 0);
+    CHECK_AND_RETURN_LOG(buffer.size() <= MAX_RECORD_SIZE, "record too large: %{public}zu", buffer.size());
+
+    record.size = static_cast<uint32_t>(buffer.size());
+    record.checksum = Checksum(buffer.data() + sizeof(record), buffer.size() - sizeof(record));
+    CHECK_AND_RETURN(memcpy_s(buffer.data(), buffer.size(), &record, sizeof(record)) == EOK);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN(fd_ >= 0);
+    uint64_t offset = 0;
+    CHECK_AND_RETURN(Append(buffer, offset) == MSERR_OK);
+
+    auto iter = entries_.find(key);
+    if (iter != entries_.end()) {
+        deadBytes_ += iter->second.size;
+    }
+    entries_[key] = { offset, record.size };
+    MediaMetrics::Inst().Add(storeHandle_);
+
+    CompactIfNeeded();
+    UpdateGauges();
+}
+
+int32_t AVMetaIndex::Append(const std::vector<uint8_t> &record, uint64_t &offset)
+{
+    ssize_t written = pwrite(fd_, record.data(), record.size(), static_cast<off_t>(fileSize_));
+    if (written != static_cast<ssize_t>(record.size())) {
+        MEDIA_LOGE("failed to append the index, errno: %{public}d", errno);
+        // never leave a torn record in the middle of the file
+        (void)ftruncate(fd_, static_cast<off_t>(fileSize_));
+        return MSERR_UNKNOWN;
+    }
+
+    offset = fileSize_;
+    fileSize_ += record.size();
+    return MSERR_OK;
+}
+
+void AVMetaIndex::CompactIfNeeded()
+{
+    if (fileSize_ <= maxFileSize_ && (fileSize_ < minCompactSize_ || deadBytes_ * 2 < fileSize_)) {
+        return;
+    }
+
+    MediaMetrics::Inst().Add(compactHandle_);
+    if (Compact() != MSERR_OK) {
+        MEDIA_LOGE("failed to compact the index, disable it");
+        Close();
+        enabled_ = false;
+    }
+}
+
+int32_t AVMetaIndex::Compact()
+{
+    if (fileSize_ > mappedSize_) {
+        CHECK_AND_RETURN_RET(Map(fileSize_) == MSERR_OK, MSERR_NO_MEMORY);
+    }
+
+    // keep the newest records within half of the limit, so that it is not compacted again soon
+    std::vector<Entry> live;
+    live.reserve(entries_.size());
+    for (auto &[key, entry] : entries_) {
+        (void)key;
+        live.push_back(entry);
+    }
+    std::sort(live.begin(), live.end(), [](const Entry &lhs, const Entry &rhs) { return lhs.offset > rhs.offset; });
+    uint64_t keepSize = sizeof(FileHeader);
+    size_t keepCount = 0;
+    while (keepCount < live.size() && keepSize + live[keepCount].size <= maxFileSize_ / 2) {
+        keepSize += live[keepCount].size;
+        keepCount++;
+    }
+    live.resize(keepCount);
+    std::reverse(live.begin(), live.end());
+
+    int32_t tmpFd = open(tmpPath_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    CHECK_AND_RETURN_RET_LOG(tmpFd >= 0, MSERR_OPEN_FILE_FAILED, "failed to open the tmp index");
+
+    FileHeader header = { FILE_MAGIC, FILE_VERSION, 0 };
+    bool ok = pwrite(tmpFd, &header, sizeof(header), 0) == sizeof(header);
+    uint64_t offset = sizeof(header);
+    for (size_t i = 0; ok && i < live.size(); i++) {
+        ok = pwrite(tmpFd, base_ + live[i].offset, live[i].size, static_cast<off_t>(offset)) ==
+            static_cast<ssize_t>(live[i].size);
+        offset += live[i].size;
+    }
+    ok = ok && fsync(tmpFd) == 0;
+    (void)close(tmpFd);
+    if (!ok || rename(tmpPath_.c_str(), path_.c_str()) != 0) {
+        MEDIA_LOGE("failed to write the tmp index, errno: %{public}d", errno);
+        (void)unlink(tmpPath_.c_str());
+        return MSERR_UNKNOWN;
+    }
+
+    MEDIA_LOGI("compacted the index from %{public}" PRIu64 " to %{public}" PRIu64 " bytes", fileSize_, offset);
+    Close();
+    return Open();
+}
+
+void AVMetaIndex::UpdateGauges()
+{
+    MediaMetrics::Inst().Set(recordsHandle_, static_cast<int64_t>(entries_.size()));
+    MediaMetrics::Inst().Set(bytesHandle_, static_cast<int64_t>(fileSize_));
+}
+} // namespace Media
+} // namespace OHOS
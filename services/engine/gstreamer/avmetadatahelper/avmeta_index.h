@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETA_INDEX_H
+#define AVMETA_INDEX_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "avsharedmemory.h"
+#include "media_metrics.h"
+#include "nocopyable.h"
+#include "uri_helper.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * The identity of the media in a file, it changes once the file is replaced or modified.
+ */
+struct AVMetaIndexKey {
+    uint64_t dev = 0;
+    uint64_t ino = 0;
+    int64_t fileSize = 0;
+    int64_t mtimeNs = 0;
+    int64_t offset = 0;
+    int64_t size = 0;
+
+    static bool FromUri(const UriHelper &uri, AVMetaIndexKey &key);
+
+    bool operator==(const AVMetaIndexKey &other) const
+    {
+        return dev == other.dev && ino == other.ino && fileSize == other.fileSize &&
+            mtimeNs == other.mtimeNs && offset == other.offset && size == other.size;
+    }
+};
+
+struct AVMetaIndexKeyHash {
+    size_t operator()(const AVMetaIndexKey &key) const;
+};
+
+/**
+ * The persistent index of the resolved metadata, so that the files queried again, e.g. by the media
+ * scanner after every boot, are answered without building the pipeline.
+ *
+ * The index is an append-only file mapped into the memory, a newer record of the same key overrides
+ * the older one. The file is compacted when the overridden records take too much of it, and the
+ * oldest records are dropped when it grows beyond the limit. A torn record left by a crash is cut
+ * off when the file is loaded.
+ */
+class AVMetaIndex : public NoCopyable {
+public:
+    static AVMetaIndex &GetInstance();
+
+    /**
+     * A private index at the path, the engines use the one of GetInstance().
+     *
+     * @param maxFileSize the oldest records are dropped beyond it.
+     * @param minCompactSize the file smaller than it is not compacted for the overridden records.
+     */
+    AVMetaIndex(const std::string &path, uint64_t maxFileSize, uint64_t minCompactSize, bool enable = true);
+    ~AVMetaIndex();
+
+    bool IsEnabled() const;
+
+    /**
+     * @param artPicture the art picture stored with the metadata, nullptr if not required.
+     * @return true if the key is found.
+     */
+    bool Lookup(const AVMetaIndexKey &key, std::unordered_map<int32_t, std::string> &meta,
+        std::shared_ptr<AVSharedMemory> *artPicture);
+    void Store(const AVMetaIndexKey &key, const std::unordered_map<int32_t, std::string> &meta,
+        const std::shared_ptr<AVSharedMemory> &artPicture);
+
+    // the art picture larger than it is not stored
+    static constexpr int32_t MAX_ART_PICTURE_SIZE = 1024 * 1024;
+
+private:
+    AVMetaIndex();
+
+    int32_t Open();
+    void Close();
+    int32_t Load();
+    int32_t Map(size_t size);
+    int32_t Append(const std::vector<uint8_t> &record, uint64_t &offset);
+    bool ReadRecord(uint64_t offset, std::unordered_map<int32_t, std::string> &meta,
+        std::shared_ptr<AVSharedMemory> *artPicture);
+    void CompactIfNeeded();
+    int32_t Compact();
+    void UpdateGauges();
+
+    std::mutex mutex_;
+    std::string path_;
+    std::string tmpPath_;
+    uint64_t maxFileSize_;
+    uint64_t minCompactSize_;
+    bool enabled_ = false;
+    int32_t fd_ = -1;
+    uint8_t *base_ = nullptr;
+    size_t mappedSize_ = 0;
+    uint64_t fileSize_ = 0;
+    uint64_t deadBytes_ = 0;
+    struct Entry {
+        uint64_t offset;
+        uint32_t size;
+    };
+    std::unordered_map<AVMetaIndexKey, Entry, AVMetaIndexKeyHash> entries_;
+
+    MetricHandle hitHandle_;
+    MetricHandle missHandle_;
+    MetricHandle storeHandle_;
+    MetricHandle compactHandle_;
+    MetricHandle recordsHandle_;
+    MetricHandle bytesHandle_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMETA_INDEX_H
@@ -14,6 +14,7 @@
  */
 
 #include "avmetadatahelper_engine_gst_impl.h"
+#include <unistd.h>
 #include <gst/gst.h>
 #include "media_errors.h"
 #include "media_log.h"
@@ -21,10 +22,12 @@
 #include "avmeta_sinkprovider.h"
 #include "avmeta_frame_extractor.h"
 #include "avmeta_meta_collector.h"
+#include "avmeta_header_parser.h"
 #include "scope_guard.h"
 #include "uri_helper.h"
-#include "time_perf.h"
+#include "media_metrics.h"
 #include "media_dfx.h"
+#include "param_wrapper.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetaEngineGstImpl"};
@@ -86,7 +89,6 @@ AVMetadataHelperEngineGstImpl::~AVMetadataHelperEngineGstImpl()
 {
     MEDIA_LOGD("enter dtor, instance: 0x%{public}06" PRIXPTR "", FAKE_POINTER(this));
     Reset();
-    CLEAN_PERF_RECORD(this);
 }
 
 int32_t AVMetadataHelperEngineGstImpl::SetSource(const std::string &uri, int32_t usage)
@@ -106,12 +108,29 @@ int32_t AVMetadataHelperEngineGstImpl::SetSource(const std::string &uri, int32_t
     MEDIA_LOGI("uri: %{public}s, usage: %{public}d", uri.c_str(), usage);
 
     if (usage == AVMetadataUsage::AV_META_USAGE_PIXEL_MAP) {
-        ASYNC_PERF_START(this, "FirstFetchFrame");
+        firstFetchStartUs_ = MediaMetrics::GetTimeUs();
+    }
+
+    // the frames can not be served by the index, so the pipeline is always required for them.
+    AVMetaIndexKey indexKey;
+    bool useIndex = usage == AVMetadataUsage::AV_META_USAGE_META_ONLY && AVMetaIndex::GetInstance().IsEnabled() &&
+        AVMetaIndexKey::FromUri(uriHelper, indexKey);
+    if (useIndex && SetSourceFromIndex(indexKey)) {
+        MEDIA_LOGI("set source from index success");
+        return MSERR_OK;
+    }
+
+    if (usage == AVMetadataUsage::AV_META_USAGE_META_ONLY && SetSourceFromHeader(uriHelper)) {
+        MEDIA_LOGI("set source from header success");
+        return MSERR_OK;
     }
 
     int32_t ret = SetSourceInternel(uri, usage);
     CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
+    indexKey_ = indexKey;
+    needStoreIndex_ = useIndex;
+
     MEDIA_LOGI("set source success");
     return MSERR_OK;
 }
@@ -152,6 +171,21 @@ std::shared_ptr<AVSharedMemory> AVMetadataHelperEngineGstImpl::FetchArtPicture()
     int32_t ret = ExtractMetadata();
     CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
 
+    if (metaCollector_ == nullptr && headerSource_ != nullptr) {
+        // the art picture is not parsed from the header, build the pipeline for it now.
+        // the source is cleared by the reset in SetSourceInternel, but its fd must outlive the pipeline.
+        std::unique_ptr<UriHelper> source = std::move(headerSource_);
+        ret = SetSourceInternel(source->FormattedUri(), usage_);
+        CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, nullptr, "set source for the art picture failed");
+        headerSource_ = std::move(source);
+        ret = ExtractMetadata();
+        CHECK_AND_RETURN_RET(ret == MSERR_OK, nullptr);
+    }
+
+    if (metaCollector_ == nullptr) {
+        return indexedArtPicture_;
+    }
+
     auto result = metaCollector_->FetchArtPicture();
     MEDIA_LOGD("exit");
     return result;
@@ -255,6 +289,76 @@ int32_t AVMetadataHelperEngineGstImpl::SetSourceInternel(const std::string &uri,
     return MSERR_OK;
 }
 
+bool AVMetadataHelperEngineGstImpl::SetSourceFromIndex(const AVMetaIndexKey &key)
+{
+    std::unordered_map<int32_t, std::string> meta;
+    std::shared_ptr<AVSharedMemory> artPicture;
+    if (!AVMetaIndex::GetInstance().Lookup(key, meta, &artPicture)) {
+        return false;
+    }
+
+    Reset();
+    collectedMeta_.swap(meta);
+    indexedArtPicture_ = artPicture;
+    hasCollectMeta_ = true;
+    usage_ = AVMetadataUsage::AV_META_USAGE_META_ONLY;
+    return true;
+}
+
+bool AVMetadataHelperEngineGstImpl::SetSourceFromHeader(const UriHelper &uriHelper)
+{
+    static const bool enabled = OHOS::system::GetIntParameter("sys.media.avmeta.header_parser.enable", 1) != 0;
+    if (!enabled) {
+        return false;
+    }
+
+    // dup the fd of the source for building the pipeline later
+    auto source = std::make_unique<UriHelper>(uriHelper.FormattedUri());
+    CHECK_AND_RETURN_RET_LOG(source->UriType() == uriHelper.UriType(), false, "failed to hold the source");
+
+    int64_t offset = 0;
+    int64_t size = 0;
+    int32_t fd = source->OpenFile(offset, size);
+    CHECK_AND_RETURN_RET(fd >= 0, false);
+
+    Metadata meta;
+    int32_t ret = MSERR_OK;
+    {
+        METRICS_AUTO_LATENCY("avmeta.header_parse");
+        AVMetaHeaderParser parser(fd, offset, size);
+        ret = parser.Parse(meta);
+    }
+    (void)close(fd);
+
+    if (ret != MSERR_OK) {
+        METRICS_COUNTER_ADD("avmeta.header_parser.fallback", 1);
+        return false;
+    }
+    METRICS_COUNTER_ADD("avmeta.header_parser.resolved", 1);
+
+    Reset();
+    collectedMeta_.swap(meta.tbl_);
+    hasCollectMeta_ = true;
+    headerSource_ = std::move(source);
+    usage_ = AVMetadataUsage::AV_META_USAGE_META_ONLY;
+    return true;
+}
+
+void AVMetadataHelperEngineGstImpl::StoreToIndex()
+{
+    if (!needStoreIndex_) {
+        return;
+    }
+    needStoreIndex_ = false;
+
+    // the metadata collected partly before the timeout is not worth persisting
+    if (!metaCollector_->IsCollecteCompleted()) {
+        return;
+    }
+
+    AVMetaIndex::GetInstance().Store(indexKey_, collectedMeta_, metaCollector_->FetchArtPicture());
+}
+
 int32_t AVMetadataHelperEngineGstImpl::PrepareInternel(bool async)
 {
     CHECK_AND_RETURN_RET_LOG(playBinCtrler_ != nullptr, MSERR_INVALID_OPERATION, "set source firstly");
@@ -287,13 +391,70 @@ int32_t AVMetadataHelperEngineGstImpl::FetchFrameInternel(int64_t timeUsOrIndex,
 {
     (void)numFrames;
 
-    AUTO_PERF(this, "FetchFrame");
+    METRICS_AUTO_LATENCY("avmeta.fetch_frame");
 
     if (!CheckFrameFetchParam(timeUsOrIndex, option, param)) {
         MEDIA_LOGE("fetch frame's param invalid");
         return MSERR_INVALID_OPERATION;
     }
 
+    int32_t ret = PrepareFrameExtract();
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+    auto frame = frameExtractor_->ExtractFrame(timeUsOrIndex, option, param);
+    if (frame == nullptr) {
+        MEDIA_LOGE("fetch frame failed");
+        return MSERR_UNKNOWN;
+    }
+
+    UpdateFirstFetchMetric();
+    outFrames.push_back(frame);
+    return MSERR_OK;
+}
+
+int32_t AVMetadataHelperEngineGstImpl::PrepareFetchFrames(
+    const std::vector<int64_t> &timesUs, int32_t option, const OutputConfiguration &param)
+{
+    MEDIA_LOGD("enter");
+
+    if (usage_ != AVMetadataUsage::AV_META_USAGE_PIXEL_MAP) {
+        MEDIA_LOGE("current instance is unavailable for fetch frame, check usage !");
+        return MSERR_INVALID_OPERATION;
+    }
+
+    for (auto timeUs : timesUs) {
+        if (timeUs < 0 || !CheckFrameFetchParam(timeUs, option, param)) {
+            MEDIA_LOGE("fetch frames's param invalid, time: %{public}" PRIi64 "", timeUs);
+            return MSERR_INVALID_VAL;
+        }
+    }
+
+    int32_t ret = PrepareFrameExtract();
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+    ret = frameExtractor_->PrepareExtractFrames(timesUs, option, param);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "prepare extract frames failed");
+
+    MEDIA_LOGD("exit");
+    return MSERR_OK;
+}
+
+std::shared_ptr<AVSharedMemory> AVMetadataHelperEngineGstImpl::FetchNextFrame(int64_t &timeUs)
+{
+    METRICS_AUTO_LATENCY("avmeta.fetch_next_frame");
+
+    timeUs = -1;
+    CHECK_AND_RETURN_RET_LOG(frameExtractor_ != nullptr, nullptr, "frameExtractor is nullptr");
+
+    auto frame = frameExtractor_->ExtractNextFrame(timeUs);
+    if (frame != nullptr) {
+        UpdateFirstFetchMetric();
+    }
+    return frame;
+}
+
+int32_t AVMetadataHelperEngineGstImpl::PrepareFrameExtract()
+{
     CHECK_AND_RETURN_RET_LOG(frameExtractor_ != nullptr, MSERR_INVALID_OPERATION, "frameExtractor is nullptr");
 
     int32_t ret = ExtractMetadata();
@@ -310,32 +471,32 @@ int32_t AVMetadataHelperEngineGstImpl::FetchFrameInternel(int64_t timeUsOrIndex,
         return MSERR_UNKNOWN;
     }
 
-    ret = PrepareInternel(false);
-    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
-
-    auto frame = frameExtractor_->ExtractFrame(timeUsOrIndex, option, param);
-    if (frame == nullptr) {
-        MEDIA_LOGE("fetch frame failed");
-        return MSERR_UNKNOWN;
-    }
+    return PrepareInternel(false);
+}
 
+void AVMetadataHelperEngineGstImpl::UpdateFirstFetchMetric()
+{
     if (firstFetch_) {
-        ASYNC_PERF_STOP(this, "FirstFetchFrame");
+        if (firstFetchStartUs_ >= 0) {
+            static const MetricHandle handle = MediaMetrics::Inst().RegisterHistogram("avmeta.first_fetch_frame");
+            MediaMetrics::Inst().Record(handle, MediaMetrics::GetTimeUs() - firstFetchStartUs_);
+            firstFetchStartUs_ = -1;
+        }
         firstFetch_ = false;
     }
-
-    outFrames.push_back(frame);
-    return MSERR_OK;
 }
 
 int32_t AVMetadataHelperEngineGstImpl::ExtractMetadata()
 {
+    if (hasCollectMeta_) {
+        return MSERR_OK;
+    }
+
     CHECK_AND_RETURN_RET_LOG(metaCollector_ != nullptr, MSERR_INVALID_OPERATION, "metaCollector is nullptr");
 
-    if (!hasCollectMeta_) {
-        collectedMeta_ = metaCollector_->GetMetadata();
-        hasCollectMeta_ = true;
-    }
+    collectedMeta_ = metaCollector_->GetMetadata();
+    hasCollectMeta_ = true;
+    StoreToIndex();
     return MSERR_OK;
 }
 
@@ -345,8 +506,10 @@ void AVMetadataHelperEngineGstImpl::Reset()
 
     if (metaCollector_ != nullptr) {
         metaCollector_->Stop();
-        hasCollectMeta_ = false;
     }
+    hasCollectMeta_ = false;
+    indexedArtPicture_ = nullptr;
+    needStoreIndex_ = false;
 
     if (frameExtractor_ != nullptr) {
         frameExtractor_->Reset();
@@ -368,11 +531,14 @@ void AVMetadataHelperEngineGstImpl::Reset()
     sinkProvider_ = nullptr;
     metaCollector_ = nullptr;
     frameExtractor_ = nullptr;
+    // after the pipeline reading from its fd is destroyed
+    headerSource_ = nullptr;
 
     errHappened_ = false;
     status_ = PLAYBIN_STATE_IDLE;
 
     firstFetch_ = true;
+    firstFetchStartUs_ = -1;
 
     lock.unlock();
     lock.lock();
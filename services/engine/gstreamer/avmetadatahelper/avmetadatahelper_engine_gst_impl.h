@@ -22,6 +22,7 @@
 #include "i_avmetadatahelper_engine.h"
 #include "i_playbin_ctrler.h"
 #include "gst_utils.h"
+#include "avmeta_index.h"
 
 namespace OHOS {
 namespace Media {
@@ -39,15 +40,23 @@ public:
     std::shared_ptr<AVSharedMemory> FetchFrameAtTime(
         int64_t timeUs, int32_t option, const OutputConfiguration &param) override;
     std::shared_ptr<AVSharedMemory> FetchArtPicture() override;
+    int32_t PrepareFetchFrames(
+        const std::vector<int64_t> &timesUs, int32_t option, const OutputConfiguration &param) override;
+    std::shared_ptr<AVSharedMemory> FetchNextFrame(int64_t &timeUs) override;
 
 private:
     void OnNotifyMessage(const PlayBinMessage &msg);
     GValueArray *OnNotifyAutoPlugSort(GValueArray &factories);
     int32_t SetSourceInternel(const std::string &uri, int32_t usage);
+    bool SetSourceFromIndex(const AVMetaIndexKey &key);
+    bool SetSourceFromHeader(const UriHelper &uriHelper);
+    void StoreToIndex();
     int32_t InitConverter(const OutputConfiguration &config);
     int32_t PrepareInternel(bool async);
     int32_t FetchFrameInternel(int64_t timeUsOrIndex, int32_t option, int32_t numFrames,
         const OutputConfiguration &param, std::vector<std::shared_ptr<AVSharedMemory>> &outFrames);
+    int32_t PrepareFrameExtract();
+    void UpdateFirstFetchMetric();
     int32_t ExtractMetadata();
     void OnNotifyElemSetup(GstElement &elem);
     const std::string &GetStatusDescription(OHOS::Media::PlayBinState status);
@@ -59,6 +68,13 @@ private:
     std::unique_ptr<AVMetaMetaCollector> metaCollector_;
     std::unordered_map<int32_t, std::string> collectedMeta_;
     bool hasCollectMeta_ = false;
+    // the art picture resolved from the index, there is no meta collector then
+    std::shared_ptr<AVSharedMemory> indexedArtPicture_;
+    AVMetaIndexKey indexKey_;
+    bool needStoreIndex_ = false;
+    // the source resolved by the header parser, the pipeline is built only if the art picture is fetched.
+    // it holds its own fd, the one of the caller may be closed once the source is set.
+    std::unique_ptr<UriHelper> headerSource_;
     int32_t usage_ = AVMetadataUsage::AV_META_USAGE_PIXEL_MAP;
 
     std::mutex mutex_;
@@ -66,6 +82,7 @@ private:
     bool errHappened_ = false;
     int32_t status_ = PLAYBIN_STATE_IDLE;
     bool firstFetch_ = true;
+    int64_t firstFetchStartUs_ = -1;
 };
 } // namespace Media
 } // namespace OHOS
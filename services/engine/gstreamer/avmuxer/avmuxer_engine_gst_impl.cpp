@@ -37,33 +37,6 @@ namespace {
 
 namespace OHOS {
 namespace Media {
-static void StartFeed(GstElement *src, guint length, gpointer userData)
-{
-    (void)length;
-    CHECK_AND_RETURN_LOG(src != nullptr, "AppSrc does not exist");
-    CHECK_AND_RETURN_LOG(userData != nullptr, "User data does not exist");
-    std::map<int32_t, TrackInfo> trackInfo = *reinterpret_cast<std::map<int32_t, TrackInfo> *>(userData);
-    for (auto& info : trackInfo) {
-        if (info.second.src_ == src) {
-            info.second.needData_ = true;
-            break;
-        }
-    }
-}
-
-static void StopFeed(GstElement *src, gpointer userData)
-{
-    CHECK_AND_RETURN_LOG(src != nullptr, "AppSrc does not exist");
-    CHECK_AND_RETURN_LOG(userData != nullptr, "User data does not exist");
-    std::map<int32_t, TrackInfo> trackInfo = *reinterpret_cast<std::map<int32_t, TrackInfo> *>(userData);
-    for (auto& info : trackInfo) {
-        if (info.second.src_ == src) {
-            info.second.needData_ = false;
-            break;
-        }
-    }
-}
-
 AVMuxerEngineGstImpl::AVMuxerEngineGstImpl()
 {
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
@@ -230,8 +203,6 @@ int32_t AVMuxerEngineGstImpl::Start()
         name += static_cast<char>('0' + info.first);
         GstElement *src = gst_bin_get_by_name(GST_BIN_CAST(muxBin_), name.c_str());
         CHECK_AND_RETURN_RET_LOG(src != nullptr, MSERR_INVALID_OPERATION, "src does not exist");
-        g_signal_connect(src, "need-data", G_CALLBACK(StartFeed), reinterpret_cast<gpointer *>(&trackInfo_));
-        g_signal_connect(src, "enough-data", G_CALLBACK(StopFeed), reinterpret_cast<gpointer *>(&trackInfo_));
         info.second.src_ = src;
     }
 
@@ -279,8 +250,6 @@ int32_t AVMuxerEngineGstImpl::WriteTrackSample(std::shared_ptr<AVSharedMemory> s
     CHECK_AND_RETURN_RET_LOG(errHappened_ != true, MSERR_INVALID_OPERATION, "Error happend");
     CHECK_AND_RETURN_RET_LOG(muxBin_ != nullptr, MSERR_INVALID_OPERATION, "Muxbin does not exist");
     CHECK_AND_RETURN_RET_LOG(sampleData != nullptr, MSERR_INVALID_VAL, "sampleData is nullptr");
-    CHECK_AND_RETURN_RET_LOG(trackInfo_[sampleInfo.trackIdx].needData_ == true, MSERR_INVALID_OPERATION,
-        "Failed to push data, the queue is full");
     CHECK_AND_RETURN_RET_LOG(sampleInfo.timeUs >= 0, MSERR_INVALID_VAL, "Failed to check dts, dts muxt >= 0");
 
     int32_t ret;
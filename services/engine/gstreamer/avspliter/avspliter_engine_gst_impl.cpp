@@ -0,0 +1,920 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avspliter_engine_gst_impl.h"
+#include <algorithm>
+#include <unordered_map>
+#include "securec.h"
+#include "avcodec_info.h"
+#include "gst_utils.h"
+#include "media_errors.h"
+#include "media_log.h"
+#include "uri_helper.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVSpliterEngineGstImpl"};
+    constexpr int32_t PREPARE_TIMEOUT_SECOND = 5;
+    constexpr uint32_t SINK_MAX_BUFFERS = 256;
+    constexpr guint64 PULL_SLICE_TIMEOUT = 50 * GST_MSECOND;
+    constexpr int32_t PULL_MAX_RETRY_TIMES = 100;
+    constexpr int64_t NS_PER_US = 1000;
+    // the samples queued in the engine for the tracks waiting behind a poorly interleaved track
+    constexpr size_t MAX_QUEUED_BYTES = 64 * 1024 * 1024;
+}
+
+namespace OHOS {
+namespace Media {
+struct CapsMimeInfo {
+    std::string_view mime;
+    MediaType mediaType;
+    std::string_view versionField;
+    int32_t version;
+};
+
+// gst caps name to codec mime, the same caps name may be mapped to different mime by the version field.
+static const std::unordered_multimap<std::string_view, CapsMimeInfo> CAPS_MIME_TABLE = {
+    { "video/x-h264", { CodecMimeType::VIDEO_AVC, MEDIA_TYPE_VID, "", 0 } },
+    { "video/x-h265", { CodecMimeType::VIDEO_HEVC, MEDIA_TYPE_VID, "", 0 } },
+    { "video/x-h263", { CodecMimeType::VIDEO_H263, MEDIA_TYPE_VID, "", 0 } },
+    { "video/mpeg", { CodecMimeType::VIDEO_MPEG4, MEDIA_TYPE_VID, "mpegversion", 4 } },
+    { "video/mpeg", { CodecMimeType::VIDEO_MPEG2, MEDIA_TYPE_VID, "mpegversion", 2 } },
+    { "video/x-vp8", { CodecMimeType::VIDEO_VP8, MEDIA_TYPE_VID, "", 0 } },
+    { "video/x-vp9", { CodecMimeType::VIDEO_VP9, MEDIA_TYPE_VID, "", 0 } },
+    { "audio/mpeg", { CodecMimeType::AUDIO_AAC, MEDIA_TYPE_AUD, "mpegversion", 4 } },
+    { "audio/mpeg", { CodecMimeType::AUDIO_AAC, MEDIA_TYPE_AUD, "mpegversion", 2 } },
+    { "audio/mpeg", { CodecMimeType::AUDIO_MPEG, MEDIA_TYPE_AUD, "mpegversion", 1 } },
+    { "audio/x-vorbis", { CodecMimeType::AUDIO_VORBIS, MEDIA_TYPE_AUD, "", 0 } },
+    { "audio/x-opus", { CodecMimeType::AUDIO_OPUS, MEDIA_TYPE_AUD, "", 0 } },
+    { "audio/x-flac", { CodecMimeType::AUDIO_FLAC, MEDIA_TYPE_AUD, "", 0 } },
+    { "audio/AMR", { CodecMimeType::AUDIO_AMR_NB, MEDIA_TYPE_AUD, "", 0 } },
+    { "audio/AMR-WB", { CodecMimeType::AUDIO_AMR_WB, MEDIA_TYPE_AUD, "", 0 } },
+    { "text/x-raw", { "text/plain", MEDIA_TYPE_SUBTITLE, "", 0 } },
+};
+
+static const std::unordered_map<std::string_view, std::string_view> CONTAINER_FORMAT_TABLE = {
+    { "video/quicktime", ContainerFormatType::CFT_MPEG_4 },
+    { "audio/x-m4a", ContainerFormatType::CFT_MPEG_4A },
+    { "video/mpegts", ContainerFormatType::CFT_MPEG_TS },
+    { "video/x-matroska", ContainerFormatType::CFT_MKV },
+    { "video/webm", ContainerFormatType::CFT_WEBM },
+    { "audio/webm", ContainerFormatType::CFT_WEBM },
+    { "application/ogg", ContainerFormatType::CFT_OGG },
+    { "audio/x-wav", ContainerFormatType::CFT_WAV },
+    { "audio/mpeg", ContainerFormatType::CFT_AAC },
+    { "audio/x-flac", ContainerFormatType::CFT_FLAC },
+};
+
+static bool ParseCapsToDesc(const GstCaps &caps, MediaDescription &desc, MediaType &mediaType)
+{
+    const GstStructure *struc = gst_caps_get_structure(&caps, 0);
+    CHECK_AND_RETURN_RET(struc != nullptr, false);
+    std::string_view capsName = STRUCTURE_NAME(struc);
+
+    auto range = CAPS_MIME_TABLE.equal_range(capsName);
+    auto found = CAPS_MIME_TABLE.end();
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.versionField.empty()) {
+            found = it;
+            break;
+        }
+        gint version = 0;
+        if (gst_structure_get_int(struc, it->second.versionField.data(), &version) &&
+            version == it->second.version) {
+            found = it;
+            break;
+        }
+    }
+    if (found == CAPS_MIME_TABLE.end()) {
+        MEDIA_LOGW("unsupported caps: %{public}s", capsName.data());
+        return false;
+    }
+
+    mediaType = found->second.mediaType;
+    (void)desc.PutIntValue(MediaDescriptionKey::MD_KEY_TRACK_TYPE, static_cast<int32_t>(mediaType));
+    (void)desc.PutStringValue(MediaDescriptionKey::MD_KEY_CODEC_MIME, found->second.mime);
+
+    gint intVal = 0;
+    if (mediaType == MEDIA_TYPE_VID) {
+        if (gst_structure_get_int(struc, "width", &intVal)) {
+            (void)desc.PutIntValue(MediaDescriptionKey::MD_KEY_WIDTH, intVal);
+        }
+        if (gst_structure_get_int(struc, "height", &intVal)) {
+            (void)desc.PutIntValue(MediaDescriptionKey::MD_KEY_HEIGHT, intVal);
+        }
+        gint num = 0;
+        gint den = 0;
+        if (gst_structure_get_fraction(struc, "framerate", &num, &den) && den != 0) {
+            (void)desc.PutDoubleValue(MediaDescriptionKey::MD_KEY_FRAME_RATE,
+                static_cast<double>(num) / static_cast<double>(den));
+        }
+    } else if (mediaType == MEDIA_TYPE_AUD) {
+        if (gst_structure_get_int(struc, "channels", &intVal)) {
+            (void)desc.PutIntValue(MediaDescriptionKey::MD_KEY_CHANNEL_COUNT, intVal);
+        }
+        if (gst_structure_get_int(struc, "rate", &intVal)) {
+            (void)desc.PutIntValue(MediaDescriptionKey::MD_KEY_SAMPLE_RATE, intVal);
+        }
+    }
+
+    return true;
+}
+
+void AVSpliterEngineGstImpl::SourcePadAdded(const GstElement *elem, GstPad *pad, gpointer userData)
+{
+    (void)elem;
+    CHECK_AND_RETURN(pad != nullptr && userData != nullptr);
+    auto thizStrong = reinterpret_cast<AVSpliterEngineGstImpl *>(userData);
+    thizStrong->OnSourcePadAdded(*pad);
+}
+
+void AVSpliterEngineGstImpl::ParseBinPadAdded(const GstElement *elem, GstPad *pad, gpointer userData)
+{
+    (void)elem;
+    CHECK_AND_RETURN(pad != nullptr && userData != nullptr);
+    auto thizStrong = reinterpret_cast<AVSpliterEngineGstImpl *>(userData);
+    thizStrong->OnParseBinPadAdded(*pad);
+}
+
+void AVSpliterEngineGstImpl::NoMorePads(const GstElement *elem, gpointer userData)
+{
+    (void)elem;
+    CHECK_AND_RETURN(userData != nullptr);
+    auto thizStrong = reinterpret_cast<AVSpliterEngineGstImpl *>(userData);
+    thizStrong->OnNoMorePads();
+}
+
+void AVSpliterEngineGstImpl::DeepElementAdded(const GstBin *bin, const GstBin *subBin,
+    GstElement *elem, gpointer userData)
+{
+    (void)bin;
+    (void)subBin;
+    CHECK_AND_RETURN(elem != nullptr && userData != nullptr);
+    auto thizStrong = reinterpret_cast<AVSpliterEngineGstImpl *>(userData);
+    thizStrong->OnElementAdded(*elem);
+}
+
+void AVSpliterEngineGstImpl::HaveType(const GstElement *elem, guint probability,
+    const GstCaps *caps, gpointer userData)
+{
+    (void)elem;
+    (void)probability;
+    CHECK_AND_RETURN(caps != nullptr && userData != nullptr);
+    auto thizStrong = reinterpret_cast<AVSpliterEngineGstImpl *>(userData);
+    thizStrong->OnHaveType(*caps);
+}
+
+AVSpliterEngineGstImpl::AVSpliterEngineGstImpl()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVSpliterEngineGstImpl::~AVSpliterEngineGstImpl()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+    Reset();
+}
+
+int32_t AVSpliterEngineGstImpl::SetSource(const std::string &uri, TrackSelectMode mode)
+{
+    UriHelper uriHelper(uri);
+    if (uriHelper.UriType() == UriHelper::URI_TYPE_UNKNOWN) {
+        MEDIA_LOGE("Unsupported uri type : %{public}s", uri.c_str());
+        return MSERR_UNSUPPORT;
+    }
+
+    MEDIA_LOGI("uri: %{public}s, mode: %{public}d", uri.c_str(), mode);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(pipeline_ == nullptr, MSERR_INVALID_OPERATION, "source already set");
+
+    GstElement *source = gst_element_factory_make("urisourcebin", "spliter_source");
+    CHECK_AND_RETURN_RET_LOG(source != nullptr, MSERR_UNKNOWN, "Failed to create urisourcebin");
+    g_object_set(source, "uri", uriHelper.FormattedUri().c_str(), nullptr);
+
+    selectMode_ = mode;
+    int32_t ret = BuildPipeline(source);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+    return PrepareInternel(lock);
+}
+
+int32_t AVSpliterEngineGstImpl::SetSource(const std::shared_ptr<IMediaDataSource> &dataSource, TrackSelectMode mode)
+{
+    CHECK_AND_RETURN_RET_LOG(dataSource != nullptr, MSERR_INVALID_VAL, "dataSource is nullptr");
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(pipeline_ == nullptr, MSERR_INVALID_OPERATION, "source already set");
+
+    appsrcWrap_ = GstAppsrcWrap::Create(dataSource);
+    CHECK_AND_RETURN_RET_LOG(appsrcWrap_ != nullptr, MSERR_NO_MEMORY, "Failed to create appsrc wrap");
+
+    GstElement *source = gst_element_factory_make("appsrc", "spliter_source");
+    CHECK_AND_RETURN_RET_LOG(source != nullptr, MSERR_UNKNOWN, "Failed to create appsrc");
+    (void)appsrcWrap_->SetAppsrc(source);
+
+    selectMode_ = mode;
+    int32_t ret = BuildPipeline(source);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+    ret = appsrcWrap_->Prepare();
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Failed to prepare appsrc wrap");
+
+    return PrepareInternel(lock);
+}
+
+int32_t AVSpliterEngineGstImpl::BuildPipeline(GstElement *source)
+{
+    pipeline_ = GST_ELEMENT_CAST(gst_object_ref_sink(gst_pipeline_new("avspliter")));
+    if (pipeline_ == nullptr) {
+        gst_object_unref(gst_object_ref_sink(source));
+        MEDIA_LOGE("Failed to create pipeline");
+        return MSERR_UNKNOWN;
+    }
+    gst_bin_add(GST_BIN_CAST(pipeline_), source);
+
+    parseBin_ = gst_element_factory_make("parsebin", "spliter_parsebin");
+    CHECK_AND_RETURN_RET_LOG(parseBin_ != nullptr, MSERR_UNKNOWN, "Failed to create parsebin");
+    gst_bin_add(GST_BIN_CAST(pipeline_), parseBin_);
+
+    (void)g_signal_connect(pipeline_, "deep-element-added", G_CALLBACK(DeepElementAdded), this);
+    (void)g_signal_connect(parseBin_, "pad-added", G_CALLBACK(ParseBinPadAdded), this);
+    (void)g_signal_connect(parseBin_, "no-more-pads", G_CALLBACK(NoMorePads), this);
+
+    GstPad *srcPad = gst_element_get_static_pad(source, "src");
+    if (srcPad != nullptr) {
+        // appsrc has the always src pad, urisourcebin exposes the src pad later.
+        OnSourcePadAdded(*srcPad);
+        gst_object_unref(srcPad);
+    } else {
+        (void)g_signal_connect(source, "pad-added", G_CALLBACK(SourcePadAdded), this);
+    }
+
+    return SetupMsgProcessor();
+}
+
+int32_t AVSpliterEngineGstImpl::SetupMsgProcessor()
+{
+    GstBus *bus = gst_pipeline_get_bus(GST_PIPELINE_CAST(pipeline_));
+    CHECK_AND_RETURN_RET_LOG(bus != nullptr, MSERR_INVALID_OPERATION, "Failed to create GstBus");
+
+    auto msgNotifier = std::bind(&AVSpliterEngineGstImpl::OnNotifyMessage, this, std::placeholders::_1);
+    msgProcessor_ = std::make_unique<GstMsgProcessor>(*bus, msgNotifier);
+    gst_object_unref(bus);
+    bus = nullptr;
+
+    int32_t ret = msgProcessor_->Init();
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+    msgProcessor_->AddMsgFilter(ELEM_NAME(pipeline_));
+    return MSERR_OK;
+}
+
+int32_t AVSpliterEngineGstImpl::PrepareInternel(std::unique_lock<std::mutex> &lock)
+{
+    // the pad-added callbacks acquire the lock from the streaming threads, release it during the state change.
+    GstElement *pipeline = pipeline_;
+    lock.unlock();
+    GstStateChangeReturn stateRet = gst_element_set_state(pipeline, GST_STATE_PAUSED);
+    lock.lock();
+    CHECK_AND_RETURN_RET_LOG(stateRet != GST_STATE_CHANGE_FAILURE, MSERR_DEMUXER_FAILED, "Failed to preroll");
+
+    bool ok = cond_.wait_for(lock, std::chrono::seconds(PREPARE_TIMEOUT_SECOND), [this]() {
+        return (noMorePads_ && prerolled_) || errHappened_.load();
+    });
+    CHECK_AND_RETURN_RET_LOG(ok, MSERR_DEMUXER_FAILED, "Prepare timeout");
+    CHECK_AND_RETURN_RET_LOG(!errHappened_, MSERR_DEMUXER_FAILED, "Failed to demux the source");
+    CHECK_AND_RETURN_RET_LOG(!tracks_.empty(), MSERR_UNSUPPORT, "No track found in the source");
+
+    int64_t duration = 0;
+    if (gst_element_query_duration(pipeline_, GST_FORMAT_TIME, &duration)) {
+        for (auto &track : tracks_) {
+            (void)track.desc.PutLongValue(MediaDescriptionKey::MD_KEY_DURATION, duration / NS_PER_US);
+        }
+    }
+
+    // appsink only outputs samples in playing state, there is no clock sync because the "sync" is disabled.
+    stateRet = gst_element_set_state(pipeline_, GST_STATE_PLAYING);
+    CHECK_AND_RETURN_RET_LOG(stateRet != GST_STATE_CHANGE_FAILURE, MSERR_DEMUXER_FAILED, "Failed to start");
+
+    prepared_ = true;
+    MEDIA_LOGI("prepare success, track count: %{public}zu", tracks_.size());
+    return MSERR_OK;
+}
+
+void AVSpliterEngineGstImpl::OnSourcePadAdded(GstPad &pad)
+{
+    CHECK_AND_RETURN(parseBin_ != nullptr);
+    GstPad *sinkPad = gst_element_get_static_pad(parseBin_, "sink");
+    CHECK_AND_RETURN_LOG(sinkPad != nullptr, "parsebin has no sink pad");
+    if (!gst_pad_is_linked(sinkPad)) {
+        GstPadLinkReturn ret = gst_pad_link(&pad, sinkPad);
+        if (ret != GST_PAD_LINK_OK) {
+            MEDIA_LOGE("link %{public}s to parsebin failed, ret = %{public}d", PAD_NAME(&pad), ret);
+        }
+    }
+    gst_object_unref(sinkPad);
+}
+
+void AVSpliterEngineGstImpl::OnParseBinPadAdded(GstPad &pad)
+{
+    GstCaps *caps = gst_pad_get_current_caps(&pad);
+    if (caps == nullptr) {
+        caps = gst_pad_query_caps(&pad, nullptr);
+    }
+    CHECK_AND_RETURN_LOG(caps != nullptr, "no caps for pad %{public}s", PAD_NAME(&pad));
+
+    SpliterTrackInfo track;
+    if (!ParseCapsToDesc(*caps, track.desc, track.mediaType)) {
+        gst_caps_unref(caps);
+        return;
+    }
+    track.caps = caps;
+
+    GstElement *sink = gst_element_factory_make("appsink", nullptr);
+    if (sink == nullptr) {
+        gst_caps_unref(caps);
+        MEDIA_LOGE("Failed to create appsink");
+        return;
+    }
+    g_object_set(sink, "sync", FALSE, "emit-signals", FALSE, "enable-last-sample", FALSE,
+        "max-buffers", SINK_MAX_BUFFERS, "drop", FALSE, nullptr);
+    track.sink = GST_ELEMENT_CAST(gst_object_ref(sink));
+
+    gst_bin_add(GST_BIN_CAST(pipeline_), sink);
+    GstPad *sinkPad = gst_element_get_static_pad(sink, "sink");
+    if (sinkPad != nullptr) {
+        (void)gst_pad_link(&pad, sinkPad);
+        gst_object_unref(sinkPad);
+    }
+    (void)gst_element_sync_state_with_parent(sink);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    (void)track.desc.PutIntValue(MediaDescriptionKey::MD_KEY_TRACK_INDEX, static_cast<int32_t>(tracks_.size()));
+    MEDIA_LOGI("add track %{public}zu, caps: %{public}s", tracks_.size(),
+        STRUCTURE_NAME(gst_caps_get_structure(caps, 0)));
+    tracks_.push_back(track);
+}
+
+void AVSpliterEngineGstImpl::OnNoMorePads()
+{
+    MEDIA_LOGD("no more pads");
+    std::unique_lock<std::mutex> lock(mutex_);
+    noMorePads_ = true;
+    cond_.notify_all();
+}
+
+void AVSpliterEngineGstImpl::OnElementAdded(GstElement &elem)
+{
+    GstElementFactory *factory = gst_element_get_factory(&elem);
+    CHECK_AND_RETURN(factory != nullptr);
+    const gchar *factoryName = gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory));
+    if (factoryName != nullptr && strcmp(factoryName, "typefind") == 0) {
+        (void)g_signal_connect(&elem, "have-type", G_CALLBACK(HaveType), this);
+    }
+}
+
+void AVSpliterEngineGstImpl::OnHaveType(const GstCaps &caps)
+{
+    const GstStructure *struc = gst_caps_get_structure(&caps, 0);
+    CHECK_AND_RETURN(struc != nullptr);
+    std::string_view capsName = STRUCTURE_NAME(struc);
+    MEDIA_LOGI("container caps: %{public}s", capsName.data());
+
+    auto it = CONTAINER_FORMAT_TABLE.find(capsName);
+    if (it != CONTAINER_FORMAT_TABLE.end()) {
+        containerFormat_ = it->second;
+    }
+}
+
+void AVSpliterEngineGstImpl::OnNotifyMessage(const InnerMessage &msg)
+{
+    switch (msg.type) {
+        case InnerMsgType::INNER_MSG_ERROR: {
+            MEDIA_LOGE("Error happened, errcode: %{public}d", msg.detail1);
+            // set before locking, the reader checks it while waiting for samples with the lock held.
+            errHappened_ = true;
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.notify_all();
+            break;
+        }
+        case InnerMsgType::INNER_MSG_ASYNC_DONE: {
+            MEDIA_LOGD("async done");
+            std::unique_lock<std::mutex> lock(mutex_);
+            prerolled_ = true;
+            cond_.notify_all();
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+int32_t AVSpliterEngineGstImpl::GetContainerDescription(MediaDescription &desc)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(prepared_, MSERR_INVALID_OPERATION, "Source is not set");
+
+    (void)desc.PutIntValue(MediaDescriptionKey::MD_KEY_TRACK_COUNT, static_cast<int32_t>(tracks_.size()));
+    if (!containerFormat_.empty()) {
+        (void)desc.PutStringValue(MediaDescriptionKey::MD_KEY_CONTAINER_FORMAT, containerFormat_);
+    }
+    int64_t duration = 0;
+    if (gst_element_query_duration(pipeline_, GST_FORMAT_TIME, &duration)) {
+        (void)desc.PutLongValue(MediaDescriptionKey::MD_KEY_DURATION, duration / NS_PER_US);
+    }
+    return MSERR_OK;
+}
+
+int32_t AVSpliterEngineGstImpl::GetTrackDescription(uint32_t trackIdx, MediaDescription &desc)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(prepared_, MSERR_INVALID_OPERATION, "Source is not set");
+    CHECK_AND_RETURN_RET_LOG(trackIdx < tracks_.size(), MSERR_INVALID_VAL, "Invalid track index %{public}u", trackIdx);
+
+    desc = tracks_[trackIdx].desc;
+    return MSERR_OK;
+}
+
+int32_t AVSpliterEngineGstImpl::SelectTrack(uint32_t trackIdx)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(prepared_, MSERR_INVALID_OPERATION, "Source is not set");
+    CHECK_AND_RETURN_RET_LOG(trackIdx < tracks_.size(), MSERR_INVALID_VAL, "Invalid track index %{public}u", trackIdx);
+
+    SpliterTrackInfo &track = tracks_[trackIdx];
+    if (track.selected) {
+        return MSERR_OK;
+    }
+
+    bool othersSelected = false;
+    for (auto &other : tracks_) {
+        othersSelected = othersSelected || other.selected;
+    }
+
+    track.selected = true;
+    ClearSamples(track);
+    track.eos = false;
+    ApplySelection();
+
+    if (selectMode_ == TRACK_TIME_SYNC) {
+        if (othersSelected) {
+            // the sink of an unselected track may still hold the samples older than the read position.
+            track.startTimeUs = lastReadTimeUs_;
+            return MSERR_OK;
+        }
+        // The first selected track is read from where the reading started, the demuxer has to be
+        // moved back if the previously selected tracks have been read.
+        if (readStarted_) {
+            int32_t ret = SeekInternel(seekTimeUs_, GST_SEEK_FLAG_SNAP_BEFORE);
+            CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+        }
+        track.startTimeUs = 0;
+        return MSERR_OK;
+    }
+
+    // The demuxer is shared by all tracks, so restoring the independent position is only
+    // possible by seeking when no other track is consuming the stream.
+    int64_t resumeTimeUs = track.lastTimeUs + 1;
+    if (!othersSelected && resumeTimeUs < lastReadTimeUs_) {
+        int32_t ret = SeekInternel(resumeTimeUs, GST_SEEK_FLAG_SNAP_BEFORE);
+        CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+    } else if (othersSelected && resumeTimeUs < lastReadTimeUs_) {
+        MEDIA_LOGW("track %{public}u resumes at %{public}" PRId64 " instead of %{public}" PRId64,
+            trackIdx, lastReadTimeUs_, resumeTimeUs);
+    }
+    track.startTimeUs = resumeTimeUs;
+    return MSERR_OK;
+}
+
+int32_t AVSpliterEngineGstImpl::UnSelectTrack(uint32_t trackIdx)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(prepared_, MSERR_INVALID_OPERATION, "Source is not set");
+    CHECK_AND_RETURN_RET_LOG(trackIdx < tracks_.size(), MSERR_INVALID_VAL, "Invalid track index %{public}u", trackIdx);
+
+    SpliterTrackInfo &track = tracks_[trackIdx];
+    if (!track.selected) {
+        return MSERR_OK;
+    }
+
+    track.selected = false;
+    ClearSamples(track);
+    ApplySelection();
+    return MSERR_OK;
+}
+
+void AVSpliterEngineGstImpl::SelectDefaultTrack()
+{
+    uint32_t defaultIdx = 0;
+    for (uint32_t idx = 0; idx < tracks_.size(); idx++) {
+        if (tracks_[idx].mediaType == MEDIA_TYPE_VID) {
+            defaultIdx = idx;
+            break;
+        }
+    }
+    MEDIA_LOGI("no track selected, select the default track %{public}u", defaultIdx);
+    tracks_[defaultIdx].selected = true;
+    ApplySelection();
+}
+
+void AVSpliterEngineGstImpl::ApplySelection()
+{
+    // Unselected tracks must not block the demuxer, their appsink keeps dropping the oldest samples.
+    for (auto &track : tracks_) {
+        g_object_set(track.sink, "drop", track.selected ? FALSE : TRUE, nullptr);
+    }
+}
+
+static GstClockTime GetSamplePts(GstSample *sample)
+{
+    GstBuffer *buffer = gst_sample_get_buffer(sample);
+    return (buffer != nullptr && GST_BUFFER_PTS_IS_VALID(buffer)) ? GST_BUFFER_PTS(buffer) : 0;
+}
+
+int32_t AVSpliterEngineGstImpl::QueueSample(SpliterTrackInfo &track, GstSample *sample)
+{
+    GstBuffer *buffer = gst_sample_get_buffer(sample);
+    if (buffer != nullptr && GST_BUFFER_PTS_IS_VALID(buffer) &&
+        static_cast<int64_t>(GST_BUFFER_PTS(buffer)) / NS_PER_US < track.startTimeUs) {
+        gst_sample_unref(sample);
+        return MSERR_OK;
+    }
+
+    size_t size = (buffer != nullptr) ? gst_buffer_get_size(buffer) : 0;
+    if (queuedBytes_ + size > MAX_QUEUED_BYTES) {
+        gst_sample_unref(sample);
+        MEDIA_LOGE("the selected tracks are interleaved too far apart, %{public}zu bytes queued", queuedBytes_);
+        return MSERR_DEMUXER_FAILED;
+    }
+    queuedBytes_ += size;
+    track.samples.push_back(sample);
+    return MSERR_OK;
+}
+
+void AVSpliterEngineGstImpl::PopSample(SpliterTrackInfo &track)
+{
+    CHECK_AND_RETURN(!track.samples.empty());
+    GstSample *sample = track.samples.front();
+    track.samples.pop_front();
+    GstBuffer *buffer = gst_sample_get_buffer(sample);
+    size_t size = (buffer != nullptr) ? gst_buffer_get_size(buffer) : 0;
+    queuedBytes_ -= std::min(size, queuedBytes_);
+    gst_sample_unref(sample);
+}
+
+void AVSpliterEngineGstImpl::ClearSamples(SpliterTrackInfo &track)
+{
+    while (!track.samples.empty()) {
+        PopSample(track);
+    }
+}
+
+int32_t AVSpliterEngineGstImpl::DrainSelectedSinks(uint32_t exceptIdx, bool &progressed)
+{
+    // The demuxer feeds all the tracks from one streaming thread. While waiting for one track, the samples of
+    // the others are moved out of their sinks, so that a full sink never stops the demuxer.
+    for (uint32_t idx = 0; idx < tracks_.size(); idx++) {
+        SpliterTrackInfo &track = tracks_[idx];
+        if (idx == exceptIdx || !track.selected || track.eos) {
+            continue;
+        }
+        while (true) {
+            GstSample *sample = nullptr;
+            g_signal_emit_by_name(track.sink, "try-pull-sample", static_cast<guint64>(0), &sample);
+            if (sample == nullptr) {
+                break;
+            }
+            progressed = true;
+            int32_t ret = QueueSample(track, sample);
+            CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+        }
+    }
+    return MSERR_OK;
+}
+
+int32_t AVSpliterEngineGstImpl::PullSample(std::unique_lock<std::mutex> &lock, uint32_t trackIdx, bool &progressed)
+{
+    int32_t ret = DrainSelectedSinks(trackIdx, progressed);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+    // The pull waits for a slice at most, it is done without the lock so that Seek, SelectTrack and Reset
+    // are not blocked. The tracks are not cleared meanwhile since Reset waits for the reader.
+    SpliterTrackInfo &track = tracks_[trackIdx];
+    GstElement *sink = GST_ELEMENT_CAST(gst_object_ref(track.sink));
+    uint64_t flushSeq = flushSeq_;
+    lock.unlock();
+
+    GstSample *sample = nullptr;
+    g_signal_emit_by_name(sink, "try-pull-sample", PULL_SLICE_TIMEOUT, &sample);
+    gboolean isEos = FALSE;
+    if (sample == nullptr) {
+        g_object_get(sink, "eos", &isEos, nullptr);
+    }
+    gst_object_unref(sink);
+
+    lock.lock();
+    if (flushSeq != flushSeq_ || !track.selected) {
+        // seeked or unselected during the pull, the caller looks at the tracks again.
+        if (sample != nullptr) {
+            gst_sample_unref(sample);
+        }
+        progressed = true;
+        return MSERR_OK;
+    }
+    if (sample != nullptr) {
+        progressed = true;
+        return QueueSample(track, sample);
+    }
+    if (isEos) {
+        progressed = true;
+        track.eos = true;
+    }
+    return MSERR_OK;
+}
+
+int32_t AVSpliterEngineGstImpl::PickEarliestTrack(std::unique_lock<std::mutex> &lock, int32_t &chosen)
+{
+    int32_t retryTimes = 0;
+    while (true) {
+        CHECK_AND_RETURN_RET_LOG(prepared_, MSERR_INVALID_OPERATION, "Source is reset");
+        CHECK_AND_RETURN_RET_LOG(!errHappened_, MSERR_DEMUXER_FAILED, "Error happened");
+
+        // All samples are output in timestamp order, so every selected track needs a queued sample or the eos.
+        int32_t waiting = -1;
+        chosen = -1;
+        bool anySelected = false;
+        GstClockTime minPts = GST_CLOCK_TIME_NONE;
+        for (uint32_t idx = 0; idx < tracks_.size(); idx++) {
+            SpliterTrackInfo &track = tracks_[idx];
+            if (!track.selected) {
+                continue;
+            }
+            anySelected = true;
+            if (track.samples.empty()) {
+                if (!track.eos) {
+                    waiting = static_cast<int32_t>(idx);
+                    break;
+                }
+                continue;
+            }
+            GstClockTime pts = GetSamplePts(track.samples.front());
+            if (chosen < 0 || pts < minPts) {
+                chosen = static_cast<int32_t>(idx);
+                minPts = pts;
+            }
+        }
+        CHECK_AND_RETURN_RET_LOG(anySelected, MSERR_INVALID_OPERATION, "All tracks are unselected");
+        if (waiting < 0) {
+            return MSERR_OK;
+        }
+
+        bool progressed = false;
+        int32_t ret = PullSample(lock, static_cast<uint32_t>(waiting), progressed);
+        CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+        if (progressed) {
+            retryTimes = 0;
+            continue;
+        }
+        CHECK_AND_RETURN_RET_LOG(++retryTimes < PULL_MAX_RETRY_TIMES, MSERR_DEMUXER_FAILED, "Pull sample timeout");
+    }
+}
+
+int32_t AVSpliterEngineGstImpl::FillCodecData(SpliterTrackInfo &track, uint32_t trackIdx,
+    std::shared_ptr<AVSharedMemory> &buffer, TrackSampleInfo &info)
+{
+    track.codecDataSent = true;
+    info.flags = AVCODEC_BUFFER_FLAG_NONE;
+
+    const GstStructure *struc = gst_caps_get_structure(track.caps, 0);
+    CHECK_AND_RETURN_RET(struc != nullptr, MSERR_UNKNOWN);
+    const GValue *value = gst_structure_get_value(struc, "codec_data");
+    if (value == nullptr || !G_VALUE_HOLDS(value, GST_TYPE_BUFFER)) {
+        return MSERR_OK;
+    }
+    GstBuffer *codecData = gst_value_get_buffer(value);
+    CHECK_AND_RETURN_RET(codecData != nullptr, MSERR_OK);
+
+    gsize size = gst_buffer_get_size(codecData);
+    info.trackIdx = trackIdx;
+    info.timeUs = 0;
+    info.size = static_cast<uint32_t>(size);
+    info.flags = AVCODEC_BUFFER_FLAG_CODEC_DATA;
+    if (size > static_cast<gsize>(buffer->GetSize())) {
+        track.codecDataSent = false;
+        MEDIA_LOGE("buffer is too small, need %{public}zu bytes", static_cast<size_t>(size));
+        return MSERR_NO_MEMORY;
+    }
+    (void)gst_buffer_extract(codecData, 0, buffer->GetBase(), size);
+    return MSERR_OK;
+}
+
+int32_t AVSpliterEngineGstImpl::FillSample(SpliterTrackInfo &track, uint32_t trackIdx,
+    std::shared_ptr<AVSharedMemory> &buffer, TrackSampleInfo &info)
+{
+    GstBuffer *gstBuffer = gst_sample_get_buffer(track.samples.front());
+    CHECK_AND_RETURN_RET_LOG(gstBuffer != nullptr, MSERR_UNKNOWN, "sample has no buffer");
+
+    gsize size = gst_buffer_get_size(gstBuffer);
+    int64_t timeUs = GST_BUFFER_PTS_IS_VALID(gstBuffer) ?
+        static_cast<int64_t>(GST_BUFFER_PTS(gstBuffer)) / NS_PER_US : std::max<int64_t>(track.lastTimeUs, 0);
+    info.trackIdx = trackIdx;
+    info.timeUs = timeUs;
+    info.size = static_cast<uint32_t>(size);
+    info.flags = GST_BUFFER_FLAG_IS_SET(gstBuffer, GST_BUFFER_FLAG_DELTA_UNIT) ?
+        AVCODEC_BUFFER_FLAG_NONE : AVCODEC_BUFFER_FLAG_SYNC_FRAME;
+    if (size > static_cast<gsize>(buffer->GetSize())) {
+        // keep the sample queued, the caller could retry with a larger buffer.
+        MEDIA_LOGE("buffer is too small, need %{public}zu bytes", static_cast<size_t>(size));
+        return MSERR_NO_MEMORY;
+    }
+
+    (void)gst_buffer_extract(gstBuffer, 0, buffer->GetBase(), size);
+    PopSample(track);
+    track.lastTimeUs = timeUs;
+    lastReadTimeUs_ = timeUs;
+    readStarted_ = true;
+    return MSERR_OK;
+}
+
+int32_t AVSpliterEngineGstImpl::ReadTrackSample(std::shared_ptr<AVSharedMemory> buffer, TrackSampleInfo &info)
+{
+    CHECK_AND_RETURN_RET_LOG(buffer != nullptr && buffer->GetBase() != nullptr, MSERR_INVALID_VAL, "Invalid buffer");
+
+    std::unique_lock<std::mutex> readLock(readMutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(prepared_, MSERR_INVALID_OPERATION, "Source is not set");
+
+    bool anySelected = false;
+    for (auto &track : tracks_) {
+        anySelected = anySelected || track.selected;
+    }
+    if (!anySelected) {
+        SelectDefaultTrack();
+    }
+
+    int32_t chosen = -1;
+    int32_t ret = PickEarliestTrack(lock, chosen);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+
+    if (chosen < 0) {
+        MEDIA_LOGI("all selected tracks reach the end of stream");
+        info.trackIdx = 0;
+        info.timeUs = lastReadTimeUs_;
+        info.size = 0;
+        info.flags = AVCODEC_BUFFER_FLAG_EOS;
+        return MSERR_OK;
+    }
+
+    uint32_t trackIdx = static_cast<uint32_t>(chosen);
+    SpliterTrackInfo &track = tracks_[trackIdx];
+    if (!track.codecDataSent) {
+        ret = FillCodecData(track, trackIdx, buffer, info);
+        CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+        if (track.codecDataSent && info.flags == AVCODEC_BUFFER_FLAG_CODEC_DATA) {
+            return MSERR_OK;
+        }
+    }
+
+    return FillSample(track, trackIdx, buffer, info);
+}
+
+int32_t AVSpliterEngineGstImpl::Seek(int64_t timeUs, AVSeekMode mode)
+{
+    CHECK_AND_RETURN_RET_LOG(timeUs >= 0, MSERR_INVALID_VAL, "Invalid seek time");
+
+    static const std::unordered_map<int32_t, GstSeekFlags> SEEK_FLAGS_TABLE = {
+        { AV_SEEK_PREV_SYNC, GST_SEEK_FLAG_SNAP_BEFORE },
+        { AV_SEEK_NEXT_SYNC, GST_SEEK_FLAG_SNAP_AFTER },
+        { AV_SEEK_CLOSEST_SYNC, GST_SEEK_FLAG_SNAP_NEAREST },
+        { AV_SEEK_CLOSEST, GST_SEEK_FLAG_ACCURATE },
+    };
+    auto it = SEEK_FLAGS_TABLE.find(mode);
+    CHECK_AND_RETURN_RET_LOG(it != SEEK_FLAGS_TABLE.end(), MSERR_INVALID_VAL, "Invalid seek mode %{public}d", mode);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(prepared_, MSERR_INVALID_OPERATION, "Source is not set");
+    int32_t ret = SeekInternel(timeUs, it->second);
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+    seekTimeUs_ = timeUs;
+    return MSERR_OK;
+}
+
+int32_t AVSpliterEngineGstImpl::SeekInternel(int64_t timeUs, GstSeekFlags snapFlags)
+{
+    MEDIA_LOGI("seek to %{public}" PRId64 " us", timeUs);
+
+    GstSeekFlags flags = static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH | snapFlags);
+    if (snapFlags != GST_SEEK_FLAG_ACCURATE) {
+        flags = static_cast<GstSeekFlags>(flags | GST_SEEK_FLAG_KEY_UNIT);
+    }
+    gboolean ret = gst_element_seek_simple(pipeline_, GST_FORMAT_TIME, flags, timeUs * NS_PER_US);
+    CHECK_AND_RETURN_RET_LOG(ret, MSERR_SEEK_FAILED, "Failed to seek");
+
+    flushSeq_++;
+    for (auto &track : tracks_) {
+        ClearSamples(track);
+        track.eos = false;
+        track.startTimeUs = 0;
+    }
+    lastReadTimeUs_ = timeUs;
+    readStarted_ = false;
+    return MSERR_OK;
+}
+
+int32_t AVSpliterEngineGstImpl::GetCacheState(int64_t &durationUs, bool &endOfStream)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(prepared_, MSERR_INVALID_OPERATION, "Source is not set");
+
+    GstQuery *query = gst_query_new_buffering(GST_FORMAT_TIME);
+    CHECK_AND_RETURN_RET(query != nullptr, MSERR_NO_MEMORY);
+    if (!gst_element_query(pipeline_, query)) {
+        gst_query_unref(query);
+        MEDIA_LOGW("the source is not a network stream");
+        return MSERR_UNSUPPORT;
+    }
+
+    GstFormat format = GST_FORMAT_TIME;
+    gint64 start = 0;
+    gint64 stop = 0;
+    gint64 estimatedTotal = 0;
+    gst_query_parse_buffering_range(query, &format, &start, &stop, &estimatedTotal);
+    gst_query_unref(query);
+
+    gint64 position = lastReadTimeUs_ * NS_PER_US;
+    gint64 duration = -1;
+    (void)gst_element_query_duration(pipeline_, GST_FORMAT_TIME, &duration);
+
+    durationUs = (format == GST_FORMAT_TIME && stop > position) ? (stop - position) / NS_PER_US : 0;
+    endOfStream = (duration > 0 && stop >= duration);
+    return MSERR_OK;
+}
+
+void AVSpliterEngineGstImpl::ClearTracks()
+{
+    for (auto &track : tracks_) {
+        ClearSamples(track);
+        if (track.caps != nullptr) {
+            gst_caps_unref(track.caps);
+            track.caps = nullptr;
+        }
+        GST_OBJECT_UNREF_IF_NOT_NULL(track.sink);
+    }
+    tracks_.clear();
+    queuedBytes_ = 0;
+}
+
+void AVSpliterEngineGstImpl::Reset()
+{
+    GstElement *pipeline = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        pipeline = pipeline_;
+        pipeline_ = nullptr;
+        prepared_ = false;
+        flushSeq_++;
+    }
+
+    // the streaming threads may still call back, so stop the pipeline without holding the lock.
+    if (appsrcWrap_ != nullptr) {
+        appsrcWrap_->Stop();
+    }
+    if (pipeline != nullptr) {
+        (void)gst_element_set_state(pipeline, GST_STATE_NULL);
+    }
+    if (msgProcessor_ != nullptr) {
+        msgProcessor_->Reset();
+        msgProcessor_ = nullptr;
+    }
+
+    // the reader is woken up by the state change, wait for it to leave before the tracks are cleared.
+    std::unique_lock<std::mutex> readLock(readMutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    ClearTracks();
+    if (pipeline != nullptr) {
+        gst_object_unref(pipeline);
+    }
+    parseBin_ = nullptr;
+    appsrcWrap_ = nullptr;
+    containerFormat_.clear();
+    lastReadTimeUs_ = 0;
+    seekTimeUs_ = 0;
+    readStarted_ = false;
+    noMorePads_ = false;
+    prerolled_ = false;
+    errHappened_ = false;
+}
+} // namespace Media
+} // namespace OHOS
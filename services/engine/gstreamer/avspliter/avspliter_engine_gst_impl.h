@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVSPLITER_ENGINE_GST_IMPL_H
+#define AVSPLITER_ENGINE_GST_IMPL_H
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <condition_variable>
+#include <gst/gst.h>
+#include "nocopyable.h"
+#include "i_avspliter_engine.h"
+#include "gst_msg_processor.h"
+#include "gst_appsrc_wrap.h"
+
+namespace OHOS {
+namespace Media {
+struct SpliterTrackInfo {
+    GstElement *sink = nullptr;
+    GstCaps *caps = nullptr;
+    MediaDescription desc;
+    MediaType mediaType = MEDIA_TYPE_AUD;
+    // the samples pulled from appsink but not yet returned to the caller, the front one is returned first.
+    std::deque<GstSample *> samples;
+    bool selected = false;
+    bool codecDataSent = false;
+    bool eos = false;
+    // samples earlier than this position will be discarded, see {@link TrackSelectMode}.
+    int64_t startTimeUs = 0;
+    // the position of the last sample returned for this track, -1 if nothing is returned yet.
+    int64_t lastTimeUs = -1;
+};
+
+/**
+ * The avspliter engine only demuxes and parses the source through "parsebin", every
+ * elementary stream is terminated by an appsink and no decoder will be plugged.
+ */
+class AVSpliterEngineGstImpl : public IAVSpliterEngine, public NoCopyable {
+public:
+    AVSpliterEngineGstImpl();
+    ~AVSpliterEngineGstImpl();
+
+    int32_t SetSource(const std::string &uri, TrackSelectMode mode) override;
+    int32_t SetSource(const std::shared_ptr<IMediaDataSource> &dataSource, TrackSelectMode mode) override;
+    int32_t GetContainerDescription(MediaDescription &desc) override;
+    int32_t GetTrackDescription(uint32_t trackIdx, MediaDescription &desc) override;
+    int32_t SelectTrack(uint32_t trackIdx) override;
+    int32_t UnSelectTrack(uint32_t trackIdx) override;
+    int32_t ReadTrackSample(std::shared_ptr<AVSharedMemory> buffer, TrackSampleInfo &info) override;
+    int32_t Seek(int64_t timeUs, AVSeekMode mode) override;
+    int32_t GetCacheState(int64_t &durationUs, bool &endOfStream) override;
+    void Reset() override;
+
+private:
+    int32_t BuildPipeline(GstElement *source);
+    int32_t SetupMsgProcessor();
+    int32_t PrepareInternel(std::unique_lock<std::mutex> &lock);
+    void OnNotifyMessage(const InnerMessage &msg);
+    void OnSourcePadAdded(GstPad &pad);
+    void OnParseBinPadAdded(GstPad &pad);
+    void OnNoMorePads();
+    void OnElementAdded(GstElement &elem);
+    void OnHaveType(const GstCaps &caps);
+    void SelectDefaultTrack();
+    void ApplySelection();
+    int32_t SeekInternel(int64_t timeUs, GstSeekFlags snapFlags);
+    int32_t PickEarliestTrack(std::unique_lock<std::mutex> &lock, int32_t &chosen);
+    int32_t PullSample(std::unique_lock<std::mutex> &lock, uint32_t trackIdx, bool &progressed);
+    int32_t DrainSelectedSinks(uint32_t exceptIdx, bool &progressed);
+    int32_t QueueSample(SpliterTrackInfo &track, GstSample *sample);
+    void PopSample(SpliterTrackInfo &track);
+    void ClearSamples(SpliterTrackInfo &track);
+    int32_t FillCodecData(SpliterTrackInfo &track, uint32_t trackIdx,
+        std::shared_ptr<AVSharedMemory> &buffer, TrackSampleInfo &info);
+    int32_t FillSample(SpliterTrackInfo &track, uint32_t trackIdx,
+        std::shared_ptr<AVSharedMemory> &buffer, TrackSampleInfo &info);
+    void ClearTracks();
+
+    static void SourcePadAdded(const GstElement *elem, GstPad *pad, gpointer userData);
+    static void ParseBinPadAdded(const GstElement *elem, GstPad *pad, gpointer userData);
+    static void NoMorePads(const GstElement *elem, gpointer userData);
+    static void DeepElementAdded(const GstBin *bin, const GstBin *subBin, GstElement *elem, gpointer userData);
+    static void HaveType(const GstElement *elem, guint probability, const GstCaps *caps, gpointer userData);
+
+    // serializes the readers, the other calls only take mutex_ so that they are not blocked by a waiting reader.
+    std::mutex readMutex_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    GstElement *pipeline_ = nullptr;
+    GstElement *parseBin_ = nullptr;
+    std::unique_ptr<GstMsgProcessor> msgProcessor_;
+    std::shared_ptr<GstAppsrcWrap> appsrcWrap_ = nullptr;
+    std::vector<SpliterTrackInfo> tracks_;
+    TrackSelectMode selectMode_ = TRACK_TIME_SYNC;
+    std::string containerFormat_;
+    int64_t lastReadTimeUs_ = 0;
+    // the position where the reading started, 0 or the last seek position.
+    int64_t seekTimeUs_ = 0;
+    // any sample is returned since the reading started.
+    bool readStarted_ = false;
+    // increased by every flush, the samples pulled before it are discarded.
+    uint64_t flushSeq_ = 0;
+    size_t queuedBytes_ = 0;
+    bool noMorePads_ = false;
+    bool prerolled_ = false;
+    std::atomic<bool> errHappened_ = false;
+    bool prepared_ = false;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVSPLITER_ENGINE_GST_IMPL_H
@@ -14,16 +14,32 @@
  */
 
 #include "gst_appsrc_wrap.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include "avsharedmemorybase.h"
 #include "media_log.h"
 #include "media_errors.h"
-#include "securec.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "GstAppsrcWrap"};
     constexpr int32_t BUFFERS_NUM = 5;
+    constexpr int32_t MAX_BUFFERS_NUM = 32;
     constexpr int32_t BUFFER_SIZE = 81920;
+    // at most 4 blocks are coalesced into one ReadAt
+    constexpr int32_t MAX_BUFFER_SIZE = BUFFER_SIZE * 4;
+    constexpr int32_t MIN_READ_AHEAD_SIZE = BUFFER_SIZE * BUFFERS_NUM;
+    constexpr int32_t MAX_READ_AHEAD_SIZE = 4 * 1024 * 1024;
+    // keep the data consumed in this duration filled ahead
+    constexpr int64_t READ_AHEAD_DURATION_US = 1000000;
+    constexpr int64_t RATE_SAMPLE_US = 200000;
     constexpr int64_t INVALID_SIZE = -1;
+
+    int64_t GetCurrentTimeUs()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
 }
 
 namespace OHOS {
@@ -43,10 +59,11 @@ std::shared_ptr<GstAppsrcWrap> GstAppsrcWrap::Create(const std::shared_ptr<IMedi
 GstAppsrcWrap::GstAppsrcWrap(const std::shared_ptr<IMediaDataSource> &dataSrc, const int64_t size)
     : dataSrc_(dataSrc),
       size_(size),
-      fillTaskQue_("fillbufferTask"),
-      emptyTaskQue_("emptybufferTask"),
+      fillTaskQue_("fillbufferTask", TaskPriority::NORMAL, true),
+      emptyTaskQue_("emptybufferTask", TaskPriority::NORMAL, true),
       bufferSize_(BUFFER_SIZE),
-      buffersNum_(BUFFERS_NUM)
+      buffersNum_(BUFFERS_NUM),
+      readAheadSize_(MIN_READ_AHEAD_SIZE)
 {
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create and size %{public}" PRId64 "", FAKE_POINTER(this), size);
     streamType_ = size == INVALID_SIZE ? GST_APP_STREAM_TYPE_STREAM : GST_APP_STREAM_TYPE_RANDOM_ACCESS;
@@ -67,7 +84,7 @@ int32_t GstAppsrcWrap::Init()
         appSrcMem->mem = AVSharedMemoryBase::CreateFromLocal(
             bufferSize_, AVSharedMemory::Flags::FLAGS_READ_WRITE, "appsrc");
         CHECK_AND_RETURN_RET_LOG(appSrcMem->mem != nullptr, MSERR_NO_MEMORY, "init AVSharedMemory failed");
-        (void)emptyBuffers_.emplace(appSrcMem);
+        (void)emptyBuffers_.emplace_back(appSrcMem);
     }
     return MSERR_OK;
 }
@@ -89,8 +106,9 @@ int32_t GstAppsrcWrap::Prepare()
     while (!filledBuffers_.empty()) {
         std::shared_ptr<AppsrcMemWrap> appSrcMem = filledBuffers_.front();
         filledBuffers_.pop();
-        emptyBuffers_.push(appSrcMem);
+        emptyBuffers_.push_back(appSrcMem);
     }
+    ResetReadAhead();
     CHECK_AND_RETURN_RET_LOG(fillTaskQue_.Start() == MSERR_OK, MSERR_INVALID_OPERATION, "init task failed");
     CHECK_AND_RETURN_RET_LOG(emptyTaskQue_.Start() == MSERR_OK, MSERR_INVALID_OPERATION, "init task failed");
     auto task = std::make_shared<TaskHandler<void>>([this] {
@@ -193,9 +211,14 @@ void GstAppsrcWrap::NeedDataInner(uint32_t size)
         }
     } else {
         needData_ = true;
+        if (!atEos_ && sequentialBytes_ > readAheadSize_) {
+            // the consumer caught up with the reader during sequential playback
+            SetReadAheadSize(readAheadSize_ * 2); // 2: double the window on underrun
+        }
         if (!filledBuffers_.empty()) {
             emptyCond_.notify_all();
         }
+        fillCond_.notify_all();
     }
 }
 
@@ -242,7 +265,7 @@ void GstAppsrcWrap::SeekAndFreeBuffers(uint64_t pos)
         CHECK_AND_RETURN_LOG(appSrcMem != nullptr, "appSrcMem is nullptr");
         if (appSrcMem->size < 0) {
             filledBuffers_.pop();
-            emptyBuffers_.push(appSrcMem);
+            emptyBuffers_.push_back(appSrcMem);
             continue;
         }
         if (appSrcMem->pos <= pos && appSrcMem->pos + static_cast<uint64_t>(appSrcMem->size) > pos) {
@@ -254,9 +277,13 @@ void GstAppsrcWrap::SeekAndFreeBuffers(uint64_t pos)
         }
         filledBufferSize_ = filledBufferSize_ - (appSrcMem->size - appSrcMem->offset);
         filledBuffers_.pop();
-        emptyBuffers_.push(appSrcMem);
+        emptyBuffers_.push_back(appSrcMem);
     }
     if (filledBuffers_.empty()) {
+        if (curPos_ != pos) {
+            // the first read after a jump returns quickly, the window grows again if the reading goes on
+            ResetReadAhead();
+        }
         curPos_ = pos;
         atEos_ = false;
     }
@@ -274,22 +301,29 @@ int32_t GstAppsrcWrap::ReadAndGetMem()
     int32_t ret = MSERR_OK;
     while (ret == MSERR_OK) {
         int32_t size = 0;
+        int32_t readSize = 0;
         std::shared_ptr<AppsrcMemWrap> appSrcMem = nullptr;
         {
             std::unique_lock<std::mutex> lock(mutex_);
-            fillCond_.wait(lock, [this] { return (!emptyBuffers_.empty() && !atEos_) || isExit_; });
+            fillCond_.wait(lock, [this] { return NeedFill() || isExit_; });
             if (isExit_) {
                 break;
             }
-            appSrcMem = emptyBuffers_.front();
-            CHECK_AND_RETURN_RET_LOG(appSrcMem != nullptr && appSrcMem->mem != nullptr, MSERR_NO_MEMORY, "no mem");
+            appSrcMem = GetIdleMem();
+            CHECK_AND_RETURN_RET_LOG(appSrcMem != nullptr, MSERR_NO_MEMORY, "no mem");
             appSrcMem->pos = curPos_;
-            emptyBuffers_.pop();
+            readSize = bufferSize_;
+        }
+        if (appSrcMem->mem == nullptr || appSrcMem->mem->GetSize() < readSize) {
+            appSrcMem->mem = AVSharedMemoryBase::CreateFromLocal(
+                readSize, AVSharedMemory::Flags::FLAGS_READ_WRITE, "appsrc");
+            CHECK_AND_RETURN_RET_LOG(appSrcMem->mem != nullptr, MSERR_NO_MEMORY, "no mem");
         }
         if (size_ == INVALID_SIZE) {
-            size = dataSrc_->ReadAt(bufferSize_, appSrcMem->mem);
+            size = dataSrc_->ReadAt(static_cast<uint32_t>(readSize), appSrcMem->mem);
         } else {
-            size = dataSrc_->ReadAt(static_cast<int64_t>(appSrcMem->pos), bufferSize_, appSrcMem->mem);
+            size = dataSrc_->ReadAt(static_cast<int64_t>(appSrcMem->pos), static_cast<uint32_t>(readSize),
+                appSrcMem->mem);
         }
         if (size > appSrcMem->mem->GetSize()) {
             ret = MSERR_INVALID_VAL;
@@ -297,7 +331,7 @@ int32_t GstAppsrcWrap::ReadAndGetMem()
         {
             std::unique_lock<std::mutex> lock(mutex_);
             if (size == 0 || curPos_ != appSrcMem->pos) {
-                emptyBuffers_.push(appSrcMem);
+                emptyBuffers_.push_back(appSrcMem);
             } else if (size < 0) {
                 appSrcMem->size = size;
                 atEos_ = true;
@@ -341,9 +375,15 @@ int32_t GstAppsrcWrap::GetAndPushMem()
     std::shared_ptr<AppsrcMemWrap> appSrcMem = filledBuffers_.front();
     CHECK_AND_RETURN_RET_LOG(appSrcMem != nullptr && appSrcMem->mem != nullptr, MSERR_NO_MEMORY, "no mem");
     if (size == 0) {
+        if (bufferWrap_ != nullptr && bufferWrap_->buffer != nullptr && bufferWrap_->offset > 0) {
+            // the stream ends before the need-data is satisfied, push the data got
+            PushData(bufferWrap_->buffer);
+            gst_buffer_unref(bufferWrap_->buffer);
+            bufferWrap_ = nullptr;
+        }
         EosAndCheckSize(appSrcMem->size);
         filledBuffers_.pop();
-        emptyBuffers_.push(appSrcMem);
+        emptyBuffers_.push_back(appSrcMem);
         needData_ = false;
         return MSERR_OK;
     }
@@ -353,27 +393,21 @@ int32_t GstAppsrcWrap::GetAndPushMem()
     } else {
         bufferWrap_ = std::make_shared<AppsrcBufferWrap>();
         int32_t allocSize = streamType_ == GST_APP_STREAM_TYPE_STREAM ? size : needDataSize_;
-        buffer = gst_buffer_new_allocate(nullptr, static_cast<gsize>(allocSize), nullptr);
+        buffer = gst_buffer_new();
         CHECK_AND_RETURN_RET_LOG(buffer != nullptr, MSERR_NO_MEMORY, "no mem");
         GST_BUFFER_OFFSET(buffer) = appSrcMem->pos + static_cast<uint64_t>(appSrcMem->offset);
         bufferWrap_->buffer = buffer;
         bufferWrap_->offset = 0;
         bufferWrap_->size = allocSize;
     }
-    GstMapInfo info = GST_MAP_INFO_INIT;
-    if (gst_buffer_map(buffer, &info, GST_MAP_WRITE) == FALSE) {
-        gst_buffer_unref(buffer);
-        MEDIA_LOGE("map buffer failed");
-        return MSERR_NO_MEMORY;
-    }
-    bool copyRet = CopyToGstBuffer(info);
-    gst_buffer_unmap(buffer, &info);
-    if (!copyRet) {
-        MEDIA_LOGE("copy buffer failed");
+    if (!WrapToGstBuffer(buffer)) {
+        MEDIA_LOGE("wrap buffer failed");
         gst_buffer_unref(buffer);
+        bufferWrap_ = nullptr;
         return MSERR_NO_MEMORY;
     }
-    if (bufferWrap_->size == bufferWrap_->offset) {
+    // at the end of stream, the need-data could never be satisfied after all the data is taken
+    if (bufferWrap_->size == bufferWrap_->offset || (atEos_ && filledBufferSize_ == size)) {
         bufferWrap_ = nullptr;
         PushData(buffer);
         needDataSize_ = 0;
@@ -383,34 +417,37 @@ int32_t GstAppsrcWrap::GetAndPushMem()
         needDataSize_ = bufferWrap_->size - bufferWrap_->offset;
     }
     filledBufferSize_ -= size;
+    UpdateReadAhead(size);
+    fillCond_.notify_all();
     return MSERR_OK;
 }
 
-bool GstAppsrcWrap::CopyToGstBuffer(const GstMapInfo &info)
+bool GstAppsrcWrap::WrapToGstBuffer(GstBuffer *buffer)
 {
-    guint8 *data = info.data + bufferWrap_->offset;
-    int32_t size = static_cast<int32_t>(info.size) - bufferWrap_->offset;
+    int32_t size = bufferWrap_->size - bufferWrap_->offset;
     while (size > 0 && !filledBuffers_.empty()) {
         std::shared_ptr<AppsrcMemWrap> appSrcMem = filledBuffers_.front();
+        if (appSrcMem != nullptr && appSrcMem->size < 0) {
+            // the end of stream, the rest of the need-data is pushed partially
+            return true;
+        }
         CHECK_AND_BREAK_LOG(appSrcMem != nullptr && appSrcMem->mem != nullptr
             && appSrcMem->mem->GetBase() != nullptr
             && (appSrcMem->size - appSrcMem->offset) > 0,
             "get mem is nullptr");
         int32_t lastSize = appSrcMem->size - appSrcMem->offset;
-        int32_t copySize = std::min(lastSize, size);
-        CHECK_AND_BREAK_LOG(memcpy_s(data, static_cast<size_t>(size),
-            appSrcMem->mem->GetBase() + appSrcMem->offset, static_cast<size_t>(copySize)) == EOK,
-            "get mem is nullptr");
+        int32_t wrapSize = std::min(lastSize, size);
+        GstMemory *memory = WrapAppsrcMem(appSrcMem, wrapSize);
+        CHECK_AND_BREAK_LOG(memory != nullptr, "wrap mem failed");
+        gst_buffer_append_memory(buffer, memory);
         if (lastSize <= size) {
             filledBuffers_.pop();
-            emptyBuffers_.push(appSrcMem);
-            fillCond_.notify_all();
+            emptyBuffers_.push_back(appSrcMem);
         } else {
-            appSrcMem->offset += copySize;
+            appSrcMem->offset += wrapSize;
         }
-        data = data + copySize;
-        bufferWrap_->offset += copySize;
-        size -= copySize;
+        bufferWrap_->offset += wrapSize;
+        size -= wrapSize;
     }
     if (size != 0 && !filledBuffers_.empty()) {
         return false;
@@ -418,6 +455,111 @@ bool GstAppsrcWrap::CopyToGstBuffer(const GstMapInfo &info)
     return true;
 }
 
+GstMemory *GstAppsrcWrap::WrapAppsrcMem(const std::shared_ptr<AppsrcMemWrap> &appSrcMem, int32_t size)
+{
+    auto memRef = new (std::nothrow) std::shared_ptr<AVSharedMemory>(appSrcMem->mem);
+    CHECK_AND_RETURN_RET_LOG(memRef != nullptr, nullptr, "no mem");
+    GstMemory *memory = gst_memory_new_wrapped(GST_MEMORY_FLAG_READONLY, appSrcMem->mem->GetBase(),
+        static_cast<gsize>(appSrcMem->mem->GetSize()), static_cast<gsize>(appSrcMem->offset),
+        static_cast<gsize>(size), memRef, ReleaseAppsrcMem);
+    if (memory == nullptr) {
+        delete memRef;
+    }
+    return memory;
+}
+
+void GstAppsrcWrap::ReleaseAppsrcMem(gpointer mem)
+{
+    // called by any thread holding the last GstMemory, only drops the reference
+    delete static_cast<std::shared_ptr<AVSharedMemory> *>(mem);
+}
+
+std::shared_ptr<AppsrcMemWrap> GstAppsrcWrap::GetIdleMem()
+{
+    // the blocks return in order, the oldest one is the most likely to be released downstream
+    auto iter = std::find_if(emptyBuffers_.begin(), emptyBuffers_.end(),
+        [](const std::shared_ptr<AppsrcMemWrap> &appSrcMem) {
+            return appSrcMem->mem == nullptr || appSrcMem->mem.use_count() == 1;
+        });
+    std::shared_ptr<AppsrcMemWrap> appSrcMem = nullptr;
+    if (iter != emptyBuffers_.end()) {
+        appSrcMem = *iter;
+        (void)emptyBuffers_.erase(iter);
+        // pairs with the release of the last downstream reference before the block is written again
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return appSrcMem;
+    }
+    if (buffersNum_ < MAX_BUFFERS_NUM) {
+        appSrcMem = std::make_shared<AppsrcMemWrap>();
+        CHECK_AND_RETURN_RET_LOG(appSrcMem != nullptr, nullptr, "init AppsrcMemWrap failed");
+        buffersNum_++;
+        return appSrcMem;
+    }
+    // downstream holds all the blocks, leave the oldest one to it and read into a new memory
+    appSrcMem = emptyBuffers_.front();
+    emptyBuffers_.pop_front();
+    appSrcMem->mem = nullptr;
+    return appSrcMem;
+}
+
+bool GstAppsrcWrap::NeedFill() const
+{
+    if (atEos_ || (emptyBuffers_.empty() && buffersNum_ >= MAX_BUFFERS_NUM)) {
+        return false;
+    }
+    return filledBufferSize_ < readAheadSize_ || (needData_ && filledBufferSize_ < needDataSize_);
+}
+
+void GstAppsrcWrap::ResetReadAhead()
+{
+    rateStartUs_ = -1;
+    rateBytes_ = 0;
+    sequentialBytes_ = 0;
+    SetReadAheadSize(MIN_READ_AHEAD_SIZE);
+}
+
+void GstAppsrcWrap::UpdateReadAhead(int32_t size)
+{
+    // the live stream reads what it needs only, a larger read may wait for data never coming soon
+    if (streamType_ == GST_APP_STREAM_TYPE_STREAM || size <= 0) {
+        return;
+    }
+    sequentialBytes_ += size;
+    int64_t nowUs = GetCurrentTimeUs();
+    if (rateStartUs_ < 0) {
+        rateStartUs_ = nowUs;
+        rateBytes_ = 0;
+        return;
+    }
+    rateBytes_ += size;
+    int64_t elapsedUs = nowUs - rateStartUs_;
+    if (elapsedUs < RATE_SAMPLE_US) {
+        return;
+    }
+    int64_t target = rateBytes_ * READ_AHEAD_DURATION_US / elapsedUs;
+    target = std::min(target, static_cast<int64_t>(MAX_READ_AHEAD_SIZE));
+    if (target < readAheadSize_) {
+        // shrink slowly, a short pause of the consumer should not drop the window
+        target = (target + readAheadSize_) / 2; // 2: halve the distance
+    }
+    SetReadAheadSize(static_cast<int32_t>(target));
+    rateStartUs_ = nowUs;
+    rateBytes_ = 0;
+}
+
+void GstAppsrcWrap::SetReadAheadSize(int32_t size)
+{
+    int32_t readAheadSize = std::clamp(size, MIN_READ_AHEAD_SIZE, MAX_READ_AHEAD_SIZE);
+    if (readAheadSize != readAheadSize_) {
+        MEDIA_LOGD("read ahead %{public}d -> %{public}d", readAheadSize_, readAheadSize);
+    }
+    readAheadSize_ = readAheadSize;
+    // split the window into about BUFFERS_NUM reads, each coalesces several blocks
+    int32_t blocks = (readAheadSize_ / BUFFERS_NUM + BUFFER_SIZE - 1) / BUFFER_SIZE;
+    bufferSize_ = std::clamp(blocks * BUFFER_SIZE, BUFFER_SIZE, MAX_BUFFER_SIZE);
+    fillCond_.notify_all();
+}
+
 void GstAppsrcWrap::OnError(int32_t errorCode)
 {
     if (notifier_ != nullptr) {
@@ -17,6 +17,7 @@
 #define GST_APPSRC_WRAP_H
 
 #include <gst/gst.h>
+#include <deque>
 #include <queue>
 #include "task_queue.h"
 #include "media_data_source.h"
@@ -26,6 +27,7 @@
 namespace OHOS {
 namespace Media {
 struct AppsrcMemWrap {
+    // the GstMemory pushed to appsrc holds another reference, mem is refilled only when it is released
     std::shared_ptr<AVSharedMemory> mem;
     // position of mem in file
     uint64_t pos;
@@ -71,7 +73,14 @@ private:
     void FillTask();
     void EmptyTask();
     void EosAndCheckSize(int32_t size);
-    bool CopyToGstBuffer(const GstMapInfo &info);
+    bool WrapToGstBuffer(GstBuffer *buffer);
+    static GstMemory *WrapAppsrcMem(const std::shared_ptr<AppsrcMemWrap> &appSrcMem, int32_t size);
+    static void ReleaseAppsrcMem(gpointer mem);
+    std::shared_ptr<AppsrcMemWrap> GetIdleMem();
+    bool NeedFill() const;
+    void ResetReadAhead();
+    void UpdateReadAhead(int32_t size);
+    void SetReadAheadSize(int32_t size);
     std::shared_ptr<IMediaDataSource> dataSrc_ = nullptr;
     const int64_t size_;
     uint64_t curPos_ = 0;
@@ -84,15 +93,22 @@ private:
     GstAppStreamType streamType_ = GST_APP_STREAM_TYPE_STREAM;
     AppsrcErrorNotifier notifier_;
     std::vector<gulong> callbackIds_;
-    std::queue<std::shared_ptr<AppsrcMemWrap>> emptyBuffers_;
+    std::deque<std::shared_ptr<AppsrcMemWrap>> emptyBuffers_;
     std::queue<std::shared_ptr<AppsrcMemWrap>> filledBuffers_;
     bool atEos_ = false;
     bool needData_ = false;
     int32_t needDataSize_ = 0;
     bool isExit_ = true;
     int32_t filledBufferSize_ = 0;
+    // the length of one ReadAt, grows with the read-ahead window to coalesce several blocks
     int32_t bufferSize_;
+    // the number of blocks allocated
     int32_t buffersNum_;
+    // the bytes kept filled ahead of the consumer
+    int32_t readAheadSize_;
+    int64_t rateStartUs_ = -1;
+    int64_t rateBytes_ = 0;
+    int64_t sequentialBytes_ = 0;
     std::shared_ptr<AppsrcBufferWrap> bufferWrap_;
 };
 } // namespace Media
@@ -28,7 +28,7 @@ GstMsgProcessor::GstMsgProcessor(
     GstBus &gstBus,
     const InnerMsgNotifier &notifier,
     const std::shared_ptr<IGstMsgConverter> &converter)
-    : notifier_(notifier), guardTask_("msg_loop_guard"), msgConverter_(converter)
+    : notifier_(notifier), guardTask_("msg_loop_guard", TaskPriority::NORMAL, true), msgConverter_(converter)
 {
     gstBus_ = GST_BUS_CAST(gst_object_ref(&gstBus));
     MEDIA_LOGD("enter ctor, instance: 0x%{public}06" PRIXPTR "", FAKE_POINTER(this));
@@ -23,6 +23,7 @@
 #include "playbin_msg_define.h"
 #include "playbin_sink_provider.h"
 #include "gst_appsrc_wrap.h"
+#include "player_position_page.h"
 
 namespace OHOS {
 namespace Media {
@@ -49,6 +50,8 @@ public:
         PlayBinRenderMode renderMode;
         PlayBinMsgNotifier notifier;
         std::shared_ptr<PlayBinSinkProvider> sinkProvider;
+        // optional, the position anchors are published to it
+        std::shared_ptr<PlayerPositionPage> positionPage;
     };
 
     virtual ~IPlayBinCtrler() = default;
@@ -26,6 +26,7 @@
 #include "playbin_state.h"
 #include "gst_utils.h"
 #include "media_dfx.h"
+#include "task_executor.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "PlayBinCtrlerBase"};
@@ -107,7 +108,8 @@ void PlayBinCtrlerBase::SourceSetup(const GstElement *playbin, GstElement *elem,
 PlayBinCtrlerBase::PlayBinCtrlerBase(const PlayBinCreateParam &createParam)
     : renderMode_(createParam.renderMode),
     notifier_(createParam.notifier),
-    sinkProvider_(createParam.sinkProvider)
+    sinkProvider_(createParam.sinkProvider),
+    positionPage_(createParam.positionPage)
 {
     MEDIA_LOGD("enter ctor, instance: 0x%{public}06" PRIXPTR "", FAKE_POINTER(this));
 }
@@ -183,6 +185,8 @@ int32_t PlayBinCtrlerBase::Prepare()
     CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
     {
+        // the network source may stall for long, do not hold the pool worker of the caller's strand
+        TaskExecutor::BlockingScope blocking;
         std::unique_lock<std::mutex> condLock(condMutex_);
         stateCond_.wait(condLock, [this]() {
             return GetCurrState() == preparedState_ || isErrorHappened_;
@@ -293,6 +297,7 @@ int32_t PlayBinCtrlerBase::StopInternal()
     int32_t ret = currState->Stop();
     CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Stop failed");
     {
+        TaskExecutor::BlockingScope blocking;
         std::unique_lock<std::mutex> condLock(condMutex_);
         MEDIA_LOGD("Stop Start");
         stateCond_.wait(condLock, [this]() {
@@ -362,6 +367,7 @@ int32_t PlayBinCtrlerBase::SetRateInternal(double rate)
     int64_t stop = rate > 0 ? static_cast<int64_t>(GST_CLOCK_TIME_NONE) : position;
 
     isRating_ = true;
+    PublishPosition(lastTime_);
     GstEvent *event = gst_event_new_seek(rate, GST_FORMAT_TIME, flags,
         GST_SEEK_TYPE_SET, start, GST_SEEK_TYPE_SET, stop);
     CHECK_AND_RETURN_RET_LOG(event != nullptr, MSERR_NO_MEMORY, "set rate failed");
@@ -665,6 +671,7 @@ int32_t PlayBinCtrlerBase::SeekInternal(int64_t timeUs, int32_t seekOption)
     int64_t timeNs = timeUs * usecToNanoSec;
     seekPos_ = timeUs;
     isSeeking_ = true;
+    PublishPosition(lastTime_);
     GstEvent *event = gst_event_new_seek(rate_, GST_FORMAT_TIME, static_cast<GstSeekFlags>(seekFlags),
         GST_SEEK_TYPE_SET, timeNs, GST_SEEK_TYPE_SET, GST_CLOCK_TIME_NONE);
     CHECK_AND_RETURN_RET_LOG(event != nullptr, MSERR_NO_MEMORY, "seek failed");
@@ -820,19 +827,20 @@ int64_t PlayBinCtrlerBase::QueryPosition()
 {
     auto state = GetCurrState();
     if (state == playbackCompletedState_) {
-        if (IsLiveSource()) {
-            return lastTime_;
-        }
-        return duration_;
+        int64_t position = IsLiveSource() ? lastTime_ : duration_;
+        PublishPosition(position);
+        return position;
     }
 
     if (state != preparedState_ && state != playingState_ && state != pausedState_) {
         MEDIA_LOGD("get position at state: %{public}s, return 0", state->GetStateName().c_str());
+        PublishPosition(0);
         return 0;
     }
 
     if (isSeeking_ || isRating_) {
         MEDIA_LOGI("in seeking or speeding, reuse the last postion: %{public}" PRIi64 "", lastTime_);
+        PublishPosition(lastTime_);
         return lastTime_;
     }
 
@@ -856,9 +864,34 @@ int64_t PlayBinCtrlerBase::QueryPositionInternal(bool isSeekDone)
     curTime = std::min(curTime, duration_);
     lastTime_ = curTime;
     MEDIA_LOGI("update the position: %{public}" PRIi64 " microsecond", curTime);
+    PublishPosition(curTime);
     return curTime;
 }
 
+void PlayBinCtrlerBase::PublishPosition(int64_t positionUs)
+{
+    if (positionPage_ == nullptr) {
+        return;
+    }
+
+    PlayerPositionAnchor anchor;
+    anchor.positionUs = positionUs;
+    anchor.clockNs = PlayerPositionPage::GetClockNs();
+    if (duration_ > 0 && !IsLiveSource()) {
+        anchor.maxPositionUs = duration_;
+    }
+    anchor.rate = rate_;
+    // the position only moves while the pipeline is really playing
+    anchor.running = GetCurrState() == playingState_ && !isSeeking_ && !isRating_ && !isBuffering_;
+    positionPage_->Publish(anchor);
+}
+
+void PlayBinCtrlerBase::OnStateChanged()
+{
+    // re-anchor at the state change, the page would go on or stop extrapolating by the old state otherwise
+    (void)QueryPosition();
+}
+
 void PlayBinCtrlerBase::ProcessEndOfStream()
 {
     MEDIA_LOGD("End of stream");
@@ -920,6 +953,7 @@ void PlayBinCtrlerBase::HandleCacheCtrlWhenNoBuffering(int32_t percent)
     if (percent < static_cast<float>(BUFFER_LOW_PERCENT_DEFAULT) / BUFFER_HIGH_PERCENT_DEFAULT *
         BUFFER_PERCENT_THRESHOLD && !isSeeking_ && !isRating_ && !isUserSetPause_) {
         isBuffering_ = true;
+        (void)QueryPositionInternal(false);
         {
             std::unique_lock<std::mutex> lock(cacheCtrlMutex_);
             g_object_set(playbin_, "state-change", GST_PLAYER_STATUS_BUFFERING, nullptr);
@@ -958,6 +992,7 @@ void PlayBinCtrlerBase::HandleCacheCtrlWhenBuffering(int32_t percent)
             g_object_set(playbin_, "state-change", GST_PLAYER_STATUS_PAUSED, nullptr);
         }
 
+        (void)QueryPositionInternal(false);
         PlayBinMessage msg = { PLAYBIN_MSG_SUBTYPE, PLAYBIN_SUB_MSG_BUFFERING_END, 0, {} };
         ReportMessage(msg);
     }
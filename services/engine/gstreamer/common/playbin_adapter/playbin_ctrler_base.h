@@ -98,6 +98,8 @@ private:
     void QueryDuration();
     int64_t QueryPosition();
     int64_t QueryPositionInternal(bool isSeekDone);
+    void PublishPosition(int64_t positionUs);
+    void OnStateChanged() override;
     void ProcessEndOfStream();
     static void ElementSetup(const GstElement *playbin, GstElement *elem, gpointer userdata);
     static void ElementUnSetup(const GstElement *playbin, GstElement *subbin, GstElement *child, gpointer userdata);
@@ -145,6 +147,7 @@ private:
     ElemSetupListener elemUnSetupListener_;
     AutoPlugSortListener autoPlugSortListener_;
     std::shared_ptr<PlayBinSinkProvider> sinkProvider_;
+    std::shared_ptr<PlayerPositionPage> positionPage_;
     std::unique_ptr<GstMsgProcessor> msgProcessor_;
     std::string uri_;
 
@@ -162,6 +162,7 @@ void PlayBinCtrlerBase::BaseState::HandleAsyncDone(const InnerMessage &msg)
             if (ctrler_.isSeeking_) {
                 int64_t position = ctrler_.seekPos_ / USEC_PER_MSEC;
                 ctrler_.isSeeking_ = false;
+                ctrler_.PublishPosition(ctrler_.seekPos_);
                 ctrler_.isDuration_ = (position == ctrler_.duration_ / USEC_PER_MSEC) ? true : false;
                 MEDIA_LOGI("asyncdone after seek done, pos = %{public}" PRIi64 "ms", position);
                 PlayBinMessage playBinMsg { PLAYBIN_MSG_SEEKDONE, 0, static_cast<int32_t>(position), {} };
@@ -414,6 +415,7 @@ void PlayBinCtrlerBase::PlayingState::ProcessStateChange(const InnerMessage &msg
             if (ctrler_.isSeeking_) {
                 int64_t position = ctrler_.seekPos_ / USEC_PER_MSEC;
                 ctrler_.isSeeking_ = false;
+                ctrler_.PublishPosition(ctrler_.seekPos_);
                 ctrler_.isDuration_ = (position == ctrler_.duration_ / USEC_PER_MSEC) ? true : false;
                 MEDIA_LOGI("playing after seek done, pos = %{public}" PRIi64 "ms", position);
                 PlayBinMessage playBinMsg { PLAYBIN_MSG_SEEKDONE, 0, static_cast<int32_t>(position), {} };
@@ -577,6 +579,7 @@ void PlayBinCtrlerBase::PlaybackCompletedState::ProcessStateChange(const InnerMe
     if (msg.detail2 == GST_STATE_PLAYING && ctrler_.isSeeking_) {
         ctrler_.ChangeState(ctrler_.playingState_);
         ctrler_.isSeeking_ = false;
+        ctrler_.PublishPosition(ctrler_.seekPos_);
     }
 }
 
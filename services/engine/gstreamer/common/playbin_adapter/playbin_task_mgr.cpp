@@ -41,20 +41,10 @@ int32_t PlayBinTaskMgr::Init()
         return MSERR_OK;
     }
 
-    taskThread_ = std::make_unique<TaskQueue>("playbin_task_mgr");
+    taskThread_ = std::make_unique<TaskQueue>("playbin_task_mgr", TaskPriority::HIGH);
     int32_t ret = taskThread_->Start();
     CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "task thread start failed");
 
-    auto dummyTask = std::make_shared<TaskHandler<void>>([this]() {
-        taskThreadId_ = std::this_thread::get_id();
-    });
-
-    ret = taskThread_->EnqueueTask(dummyTask);
-    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "try get thread id failed");
-
-    auto result = dummyTask->GetResult();
-    CHECK_AND_RETURN_RET_LOG(result.HasResult(), MSERR_INVALID_OPERATION, "try get thread id failed");
-
     isInited_ = true;
 
     return MSERR_OK;
@@ -103,7 +93,8 @@ int32_t PlayBinTaskMgr::MarkSecondPhase()
     std::unique_lock<std::mutex> lock(mutex_);
     CHECK_AND_RETURN_RET_LOG(isInited_, MSERR_INVALID_OPERATION, "not init");
 
-    if (std::this_thread::get_id() != taskThreadId_) {
+    // tasks run on shared workers, so the check is about the task context rather than a thread id
+    if (!taskThread_->IsInTaskThread()) {
         MEDIA_LOGE("not in the task thread, ignored");
         return MSERR_INVALID_OPERATION;
     }
@@ -59,6 +59,7 @@ void StateMachine::ChangeState(const std::shared_ptr<State> &state)
         currState_ = state;
     }
     state->StateEnter();
+    OnStateChanged();
 }
 
 std::shared_ptr<State> StateMachine::GetCurrState()
@@ -55,6 +55,8 @@ protected:
     void HandleMessage(const InnerMessage &msg);
     void ChangeState(const std::shared_ptr<State> &state);
     std::shared_ptr<State> GetCurrState();
+    // called after the new state is entered
+    virtual void OnStateChanged() {}
 
 private:
     std::recursive_mutex recMutex_;
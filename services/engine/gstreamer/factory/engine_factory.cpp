@@ -24,6 +24,7 @@
 #include "player_engine_gst_impl.h"
 #include "recorder_engine_gst_impl.h"
 #include "avmuxer_engine_gst_impl.h"
+#include "avspliter_engine_gst_impl.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "GstEngineFactory"};
@@ -43,6 +44,7 @@ public:
     std::unique_ptr<IAVCodecEngine> CreateAVCodecEngine() override;
     std::unique_ptr<IAVCodecListEngine> CreateAVCodecListEngine() override;
     std::unique_ptr<IAVMuxerEngine> CreateAVMuxerEngine() override;
+    std::unique_ptr<IAVSpliterEngine> CreateAVSpliterEngine() override;
 };
 
 int32_t GstEngineFactory::Score(Scene scene, const std::string &uri)
@@ -94,6 +96,12 @@ std::unique_ptr<IAVMuxerEngine> GstEngineFactory::CreateAVMuxerEngine()
     GstLoader::Instance().UpdateLogLevel();
     return std::make_unique<AVMuxerEngineGstImpl>();
 }
+
+std::unique_ptr<IAVSpliterEngine> GstEngineFactory::CreateAVSpliterEngine()
+{
+    GstLoader::Instance().UpdateLogLevel();
+    return std::make_unique<AVSpliterEngineGstImpl>();
+}
 } // namespace Media
 } // namespace OHOS
 
@@ -14,6 +14,7 @@
  */
 
 #include "gst_loader.h"
+#include <chrono>
 #include <string>
 #include <map>
 #include <queue>
@@ -46,6 +47,17 @@ namespace {
         "--gst-plugin-path=/system/lib/media/plugins"
 #endif
     };
+    constexpr const char *GST_REGISTRY_ENV = "GST_REGISTRY_1_0";
+#ifdef __aarch64__
+    constexpr const char *GST_REGISTRY_PATH = "/data/media/gst_registry.aarch64.bin";
+#else
+    constexpr const char *GST_REGISTRY_PATH = "/data/media/gst_registry.arm.bin";
+#endif
+    // the plugin_init of them registers the elements by the codec capabilities probed from the hdi
+    const std::vector<const gchar *> GST_EAGER_PLUGINS = {
+        "_hdi_codec",
+        "_codec_plugin_hdi",
+    };
 }
 
 namespace OHOS {
@@ -254,6 +266,33 @@ static void SetGstLogLevelFromSysPara()
     }
 }
 
+static void SetGstRegistryPath()
+{
+    // Without a registry file surviving the restart, gst_init scans and loads every plugin in the plugin path.
+    // With it, only the plugins whose files are changed are scanned, and the others are not loaded until one
+    // of their features is used. A stale or broken registry file is rebuilt by gst_init.
+    if (OHOS::system::GetIntParameter("sys.media.gst.registry.enable", 1) == 0) {
+        MEDIA_LOGI("gst registry cache is disabled");
+        return;
+    }
+    // an existing value is kept, so that another registry file can be set for debugging
+    if (!g_setenv(GST_REGISTRY_ENV, GST_REGISTRY_PATH, FALSE)) {
+        MEDIA_LOGW("set gst registry path failed");
+    }
+}
+
+static void LoadEagerPlugins()
+{
+    for (const gchar *name : GST_EAGER_PLUGINS) {
+        GstPlugin *plugin = gst_plugin_load_by_name(name);
+        if (plugin == nullptr) {
+            MEDIA_LOGD("plugin %{public}s is not loaded", name);
+            continue;
+        }
+        gst_object_unref(plugin);
+    }
+}
+
 static gchar ***CreateGstInitArgv()
 {
     gchar ***argv = nullptr;
@@ -298,17 +337,21 @@ int32_t GstLoader::SetUp()
     gst_debug_remove_log_function(gst_debug_log_default);
     gst_debug_add_log_function(GstLogCallbackFunc, nullptr, nullptr);
     SetGstLogLevelFromSysPara();
+    SetGstRegistryPath();
     int32_t argc = static_cast<int32_t>(GST_ARGS.size());
     MEDIA_LOGI("SetUp GstLoader argc=%{public}d", argc);
     gchar ***argv = CreateGstInitArgv();
     if (argv == nullptr) {
         return MSERR_NO_MEMORY;
     }
+    auto begin = std::chrono::steady_clock::now();
     gst_init(&argc, argv);
     DestroyGstInitArgv(argv);
+    LoadEagerPlugins();
     isInit_ = true;
 
-    MEDIA_LOGI("SetUp GstLoader finished!");
+    auto cost = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+    MEDIA_LOGI("SetUp GstLoader finished, cost %{public}" PRId64 " ms", static_cast<int64_t>(cost.count()));
 
     return MSERR_OK;
 }
@@ -509,7 +509,7 @@ int32_t PlayerEngineGstImpl::PlayBinCtrlerPrepare()
     }
 
     IPlayBinCtrler::PlayBinCreateParam createParam = {
-        static_cast<IPlayBinCtrler::PlayBinRenderMode>(renderMode), notifier, sinkProvider_
+        static_cast<IPlayBinCtrler::PlayBinRenderMode>(renderMode), notifier, sinkProvider_, positionPage_
     };
     playBinCtrler_ = IPlayBinCtrler::Create(IPlayBinCtrler::PlayBinKind::PLAYBIN2, createParam);
     CHECK_AND_RETURN_RET_LOG(playBinCtrler_ != nullptr, MSERR_INVALID_VAL, "playBinCtrler_ is nullptr");
@@ -803,6 +803,14 @@ int32_t PlayerEngineGstImpl::SetAudioInterruptMode(const int32_t interruptMode)
     return MSERR_OK;
 }
 
+int32_t PlayerEngineGstImpl::SetPositionPage(const std::shared_ptr<PlayerPositionPage> &positionPage)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    // taken by the playbin created in the next prepare
+    positionPage_ = positionPage;
+    return MSERR_OK;
+}
+
 GValueArray *PlayerEngineGstImpl::OnNotifyAutoPlugSort(GValueArray &factories)
 {
     if (isPlaySinkFlagsSet_) {
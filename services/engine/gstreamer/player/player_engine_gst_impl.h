@@ -61,6 +61,7 @@ public:
     int32_t SetAudioRendererInfo(const int32_t contentType, const int32_t streamUsage,
         const int32_t rendererFlag) override;
     int32_t SetAudioInterruptMode(const int32_t interruptMode) override;
+    int32_t SetPositionPage(const std::shared_ptr<PlayerPositionPage> &positionPage) override;
 
 private:
     void OnNotifyMessage(const PlayBinMessage &msg);
@@ -97,6 +98,7 @@ private:
     std::mutex trackParseMutex_;
     std::shared_ptr<IPlayBinCtrler> playBinCtrler_ = nullptr;
     std::shared_ptr<PlayBinSinkProvider> sinkProvider_;
+    std::shared_ptr<PlayerPositionPage> positionPage_;
     std::weak_ptr<IPlayerEngineObs> obs_;
     sptr<Surface> producerSurface_ = nullptr;
     std::string url_ = "";
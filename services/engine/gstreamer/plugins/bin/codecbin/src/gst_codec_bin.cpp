@@ -37,6 +37,7 @@ enum {
     PROP_CODEC_QUALITY,
     PROP_I_FRAME_INTREVAL,
     PROP_CODEC_PROFILE,
+    PROP_RESET,
 };
 
 #define gst_codec_bin_parent_class parent_class
@@ -156,6 +157,10 @@ static void gst_codec_bin_init_config(GObjectClass *gobject_class)
     g_object_class_install_property(gobject_class, PROP_CODEC_PROFILE,
         g_param_spec_int("codec-profile", "Codec profile", "Codec profile for video encoder",
             0, G_MAXINT32, 0, (GParamFlags)(G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(gobject_class, PROP_RESET,
+        g_param_spec_boolean("reset", "Reset", "Remove the elements of the session in READY, keep the coder opened",
+            FALSE, (GParamFlags)(G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS)));
 }
 
 static void gst_codec_bin_init(GstCodecBin *bin)
@@ -180,6 +185,7 @@ static void gst_codec_bin_init(GstCodecBin *bin)
     bin->bitrate_mode = -1;
     bin->codec_quality = -1;
     bin->i_frame_interval = -1;
+    bin->codec_profile = -1;
 }
 
 static void gst_codec_bin_finalize(GObject *object)
@@ -191,6 +197,10 @@ static void gst_codec_bin_finalize(GObject *object)
         g_free(bin->coder_name);
         bin->coder_name = nullptr;
     }
+    if (bin->coder != nullptr) {
+        gst_object_unref(bin->coder);
+        bin->coder = nullptr;
+    }
     G_OBJECT_CLASS(parent_class)->finalize(object);
 }
 
@@ -266,6 +276,11 @@ static void gst_codec_bin_set_property(GObject *object, guint prop_id,
         case PROP_USE_SURFACE_OUTPUT:
             bin->is_output_surface = g_value_get_boolean(value);
             break;
+        case PROP_RESET:
+            if (g_value_get_boolean(value)) {
+                reset_element(bin);
+            }
+            break;
         default:
             break;
     }
@@ -302,13 +317,87 @@ static void gst_codec_bin_get_property(GObject *object, guint prop_id,
 static gboolean create_coder(GstCodecBin *bin)
 {
     g_return_val_if_fail(bin != nullptr, FALSE);
+    if (bin->coder != nullptr) {
+        return TRUE;
+    }
     g_return_val_if_fail(bin->coder_name != nullptr, FALSE);
     g_return_val_if_fail(bin->type != CODEC_BIN_TYPE_UNKNOWN, FALSE);
-    bin->coder = gst_element_factory_make(bin->coder_name, "coder");
-    g_return_val_if_fail(bin->coder != nullptr, FALSE);
+    GstElement *coder = gst_element_factory_make(bin->coder_name, "coder");
+    g_return_val_if_fail(coder != nullptr, FALSE);
+    bin->coder = GST_ELEMENT_CAST(gst_object_ref_sink(coder));
+
+    // open the coder before it is linked, so that the codec instance is created in NULL to READY
+    if (gst_element_set_state(bin->coder, GST_STATE_READY) == GST_STATE_CHANGE_FAILURE) {
+        GST_ERROR_OBJECT(bin, "Failed to open the coder");
+        (void)gst_element_set_state(bin->coder, GST_STATE_NULL);
+        gst_object_unref(bin->coder);
+        bin->coder = nullptr;
+        return FALSE;
+    }
     return TRUE;
 }
 
+static gboolean is_in_bin(GstCodecBin *bin, GstElement *element)
+{
+    return element != nullptr && GST_OBJECT_PARENT(element) == GST_OBJECT_CAST(bin);
+}
+
+static void remove_element(GstCodecBin *bin, GstElement **element)
+{
+    if (*element == nullptr) {
+        return;
+    }
+    if (is_in_bin(bin, *element)) {
+        (void)gst_element_set_state(*element, GST_STATE_NULL);
+        (void)gst_bin_remove(GST_BIN_CAST(bin), *element);
+    }
+    *element = nullptr;
+}
+
+static void release_coder(GstCodecBin *bin)
+{
+    if (bin->coder == nullptr) {
+        return;
+    }
+    (void)gst_element_set_state(bin->coder, GST_STATE_NULL);
+    if (is_in_bin(bin, bin->coder)) {
+        (void)gst_bin_remove(GST_BIN_CAST(bin), bin->coder);
+    }
+    gst_object_unref(bin->coder);
+    bin->coder = nullptr;
+}
+
+static void reset_element(GstCodecBin *bin)
+{
+    GstState state = GST_STATE_VOID_PENDING;
+    GST_OBJECT_LOCK(bin);
+    state = GST_STATE(bin);
+    GST_OBJECT_UNLOCK(bin);
+    g_return_if_fail(state == GST_STATE_READY);
+
+    // the src and sink are owned by the session, the bin only drops its references
+    remove_element(bin, &bin->src);
+    remove_element(bin, &bin->parser);
+    remove_element(bin, &bin->src_convert);
+    remove_element(bin, &bin->sink_convert);
+    remove_element(bin, &bin->sink);
+
+    // the surface pool of the session has been handed to a hardware decoder, it can not be taken back
+    if (bin->type == CODEC_BIN_TYPE_VIDEO_DECODER && bin->use_software == FALSE && bin->is_output_surface) {
+        release_coder(bin);
+    }
+
+    bin->is_start = FALSE;
+    bin->need_parser = FALSE;
+    bin->is_input_surface = FALSE;
+    bin->is_output_surface = FALSE;
+    bin->bitrate_mode = -1;
+    bin->codec_quality = -1;
+    bin->i_frame_interval = -1;
+    bin->codec_profile = -1;
+    GST_INFO_OBJECT(bin, "reset_element success");
+}
+
 static void add_dump_probe(GstCodecBin *bin)
 {
     if (!OHOS::Media::Dumper::IsEnableDumpGstBuffer()) {
@@ -442,8 +531,11 @@ static gboolean add_element_to_bin(GstCodecBin *bin)
     ret = add_convert_if_necessary(bin);
     g_return_val_if_fail(ret == TRUE, FALSE);
 
-    ret = gst_bin_add(GST_BIN_CAST(bin), bin->coder);
-    g_return_val_if_fail(ret == TRUE, FALSE);
+    // a reset bin keeps the opened coder
+    if (!is_in_bin(bin, bin->coder)) {
+        ret = gst_bin_add(GST_BIN_CAST(bin), bin->coder);
+        g_return_val_if_fail(ret == TRUE, FALSE);
+    }
 
     return gst_bin_add(GST_BIN_CAST(bin), bin->sink);
 }
@@ -488,6 +580,10 @@ static GstStateChangeReturn gst_codec_bin_change_state(GstElement *element, GstS
             break;
         case GST_STATE_CHANGE_READY_TO_PAUSED:
             if (bin->is_start == FALSE) {
+                if (create_coder(bin) == FALSE) {
+                    GST_ERROR_OBJECT(bin, "Failed to create_coder");
+                    return GST_STATE_CHANGE_FAILURE;
+                }
                 if (add_element_to_bin(bin) == FALSE) {
                     GST_ERROR_OBJECT(bin, "Failed to add_element_to_bin");
                     return GST_STATE_CHANGE_FAILURE;
@@ -506,7 +602,13 @@ static GstStateChangeReturn gst_codec_bin_change_state(GstElement *element, GstS
         default:
             break;
     }
-    return GST_ELEMENT_CLASS(parent_class)->change_state(element, transition);
+
+    GstStateChangeReturn ret = GST_ELEMENT_CLASS(parent_class)->change_state(element, transition);
+    if (transition == GST_STATE_CHANGE_READY_TO_NULL && bin->coder != nullptr && !is_in_bin(bin, bin->coder)) {
+        // opened in NULL to READY but never linked, the bin does not close it
+        (void)gst_element_set_state(bin->coder, GST_STATE_NULL);
+    }
+    return ret;
 }
 
 static gboolean plugin_init(GstPlugin *plugin)
@@ -20,6 +20,7 @@
 #include "buffer_type_meta.h"
 #include "scope_guard.h"
 #include "gst_codec_video_common.h"
+#include "video_plane_copy.h"
 #include "param_wrapper.h"
 #include "media_dfx.h"
 #include "media_log.h"
@@ -35,8 +36,11 @@ GST_DEBUG_CATEGORY_STATIC(gst_vdec_base_debug_category);
 #define DEFAULT_HEIGHT 1080
 #define DEFAULT_SEEK_FRAME_RATE 1000
 #define BLOCKING_ACQUIRE_BUFFER_THRESHOLD 5
+// the max dpb size of avc and hevc is 16, plus the input and output buffers in flight
+#define DEFAULT_PTS_HEAP_CAPACITY 64
 
 static void gst_vdec_base_set_property(GObject *object, guint property_id, const GValue *value, GParamSpec *pspec);
+static void gst_vdec_base_get_property(GObject *object, guint property_id, GValue *value, GParamSpec *pspec);
 static gboolean gst_vdec_base_open(GstVideoDecoder *decoder);
 static gboolean gst_vdec_base_close(GstVideoDecoder *decoder);
 static gboolean gst_vdec_base_start(GstVideoDecoder *decoder);
@@ -59,6 +63,7 @@ static GstStateChangeReturn gst_vdec_base_change_state(GstElement *element, GstS
 static gboolean gst_vdec_base_update_out_port_def(GstVdecBase *self, guint *size);
 static void gst_vdec_base_update_out_pool(GstVdecBase *self, GstBufferPool **pool, GstCaps *outcaps, gint size);
 static void gst_vdec_base_post_resolution_changed_message(GstVdecBase *self);
+static void gst_vdec_base_release_nostride_pool(GstVdecBase *self);
 
 enum {
     PROP_0,
@@ -68,6 +73,8 @@ enum {
     PROP_PERFORMANCE_MODE,
     PROP_ENABLE_SLICE_CAT,
     PROP_SEEK,
+    PROP_INPUT_COPY_FRAMES,
+    PROP_INPUT_ZERO_COPY_FRAMES,
 };
 
 G_DEFINE_ABSTRACT_TYPE(GstVdecBase, gst_vdec_base, GST_TYPE_VIDEO_DECODER);
@@ -81,6 +88,7 @@ static void gst_vdec_base_class_init(GstVdecBaseClass *klass)
     GstVideoDecoderClass *video_decoder_class = GST_VIDEO_DECODER_CLASS(klass);
     GST_DEBUG_CATEGORY_INIT (gst_vdec_base_debug_category, "vdecbase", 0, "video decoder base class");
     gobject_class->set_property = gst_vdec_base_set_property;
+    gobject_class->get_property = gst_vdec_base_get_property;
     gobject_class->finalize = gst_vdec_base_finalize;
     video_decoder_class->open = gst_vdec_base_open;
     video_decoder_class->close = gst_vdec_base_close;
@@ -121,6 +129,16 @@ static void gst_vdec_base_class_init(GstVdecBaseClass *klass)
         g_param_spec_boolean("seeking", "Seeking", "Whether the decoder is in seek",
             FALSE, (GParamFlags)(G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS)));
 
+    g_object_class_install_property(gobject_class, PROP_INPUT_COPY_FRAMES,
+        g_param_spec_uint64("input-copy-frames", "Input copy frames",
+            "Number of input frames copied into shared memory before queued to the codec",
+            0, G_MAXUINT64, 0, (GParamFlags)(G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(gobject_class, PROP_INPUT_ZERO_COPY_FRAMES,
+        g_param_spec_uint64("input-zero-copy-frames", "Input zero copy frames",
+            "Number of input frames queued to the codec without copy",
+            0, G_MAXUINT64, 0, (GParamFlags)(G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
+
     const gchar *src_caps_string = GST_VIDEO_CAPS_MAKE(GST_VDEC_BASE_SUPPORTED_FORMATS);
     GST_DEBUG_OBJECT(klass, "Pad template caps %s", src_caps_string);
 
@@ -178,6 +196,27 @@ static void gst_vdec_base_set_property(GObject *object, guint prop_id, const GVa
     }
 }
 
+static void gst_vdec_base_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+    (void)pspec;
+    g_return_if_fail(object != nullptr && value != nullptr);
+    GstVdecBase *self = GST_VDEC_BASE(object);
+    switch (prop_id) {
+        case PROP_INPUT_COPY_FRAMES:
+            GST_OBJECT_LOCK(self);
+            g_value_set_uint64(value, self->input_copy_cnt);
+            GST_OBJECT_UNLOCK(self);
+            break;
+        case PROP_INPUT_ZERO_COPY_FRAMES:
+            GST_OBJECT_LOCK(self);
+            g_value_set_uint64(value, self->input_zero_copy_cnt);
+            GST_OBJECT_UNLOCK(self);
+            break;
+        default:
+            break;
+    }
+}
+
 static void gst_vdec_base_check_input_need_copy(GstVdecBase *self)
 {
     GstVdecBaseClass *base_class = GST_VDEC_BASE_GET_CLASS(self);
@@ -206,6 +245,9 @@ static void gst_vdec_base_property_init(GstVdecBase *self)
     self->coding_outbuf_cnt = 0;
     self->input_state = nullptr;
     self->output_state = nullptr;
+    self->pts_heap = g_new(GstClockTime, DEFAULT_PTS_HEAP_CAPACITY);
+    self->pts_heap_len = 0;
+    self->pts_heap_capacity = DEFAULT_PTS_HEAP_CAPACITY;
     self->last_pts = GST_CLOCK_TIME_NONE;
     self->flushing_stoping = FALSE;
     self->decoder_start = FALSE;
@@ -222,7 +264,13 @@ static void gst_vdec_base_property_init(GstVdecBase *self)
     self->enable_slice_cat = FALSE;
     self->resolution_changed = FALSE;
     self->input_need_ashmem = FALSE;
+    self->input_copy_cnt = 0;
+    self->input_zero_copy_cnt = 0;
     self->has_set_format = FALSE;
+    self->nostride_pool = nullptr;
+    self->nostride_width = 0;
+    self->nostride_height = 0;
+    self->nostride_format = GST_VIDEO_FORMAT_UNKNOWN;
 }
 
 static void gst_vdec_base_init(GstVdecBase *self)
@@ -279,13 +327,16 @@ static void gst_vdec_base_finalize(GObject *object)
         gst_object_unref(self->outpool);
         self->outpool = nullptr;
     }
+    gst_vdec_base_release_nostride_pool(self);
     if (self->sink_caps) {
         gst_caps_unref(self->sink_caps);
         self->sink_caps = nullptr;
     }
 
-    std::list<GstClockTime> tempList;
-    tempList.swap(self->pts_list);
+    g_free(self->pts_heap);
+    self->pts_heap = nullptr;
+    self->pts_heap_len = 0;
+    self->pts_heap_capacity = 0;
     std::vector<GstVideoFormat> tempVec;
     tempVec.swap(self->formats);
 
@@ -408,9 +459,10 @@ static gboolean gst_vdec_base_start(GstVideoDecoder *decoder)
     self->output.frame_cnt = 0;
     self->output.first_frame_time = 0;
     self->output.last_frame_time = 0;
-    std::list<GstClockTime> empty;
-    self->pts_list.swap(empty);
+    g_mutex_lock(&self->lock);
+    self->pts_heap_len = 0;
     self->last_pts = GST_CLOCK_TIME_NONE;
+    g_mutex_unlock(&self->lock);
     gst_vdec_base_dump_from_sys_param(self);
     return TRUE;
 }
@@ -426,6 +478,12 @@ static void gst_vdec_base_stop_after(GstVdecBase *self)
     self->performance_mode = FALSE;
     self->resolution_changed = FALSE;
     self->has_set_format = FALSE;
+    GST_OBJECT_LOCK(self);
+    GST_INFO_OBJECT(self, "Input frames copied %" G_GUINT64_FORMAT ", zero copy %" G_GUINT64_FORMAT,
+        self->input_copy_cnt, self->input_zero_copy_cnt);
+    self->input_copy_cnt = 0;
+    self->input_zero_copy_cnt = 0;
+    GST_OBJECT_UNLOCK(self);
     gst_vdec_base_set_flushing(self, FALSE);
     if (self->input.dump_file != nullptr) {
         fclose(self->input.dump_file);
@@ -478,6 +536,7 @@ static gboolean gst_vdec_base_stop(GstVideoDecoder *decoder)
         gst_object_unref(self->outpool);
         self->outpool = nullptr;
     }
+    gst_vdec_base_release_nostride_pool(self);
     gst_vdec_base_stop_after(self);
     GST_DEBUG_OBJECT(self, "Stop decoder end");
     return TRUE;
@@ -867,29 +926,68 @@ static void gst_vdec_base_dump_output_buffer(GstVdecBase *self, GstBuffer *buffe
     gst_buffer_unmap(buffer, &info);
 }
 
-static void gst_vdec_base_input_frame_pts_to_list(GstVdecBase *self, GstVideoCodecFrame *frame)
+static void gst_vdec_base_pts_heap_push(GstVdecBase *self, GstClockTime pts)
 {
-    GST_DEBUG_OBJECT(self, "Input frame pts %" G_GUINT64_FORMAT, frame->pts);
-    g_mutex_lock(&self->lock);
-    if (frame->pts == GST_CLOCK_TIME_NONE) {
-        g_mutex_unlock(&self->lock);
-        return;
+    if (self->pts_heap_len == self->pts_heap_capacity) {
+        // only happens with abnormal streams, the capacity is kept until finalize
+        self->pts_heap_capacity = self->pts_heap_capacity == 0 ? DEFAULT_PTS_HEAP_CAPACITY :
+            self->pts_heap_capacity * 2; // 2: double the capacity
+        self->pts_heap = g_renew(GstClockTime, self->pts_heap, self->pts_heap_capacity);
+        GST_WARNING_OBJECT(self, "Pts heap grows to %u", self->pts_heap_capacity);
     }
-    if (self->pts_list.empty() || frame->pts > self->pts_list.back()) {
-        self->pts_list.push_back(frame->pts);
-        self->last_pts = frame->pts;
-        g_mutex_unlock(&self->lock);
-        return;
+    GstClockTime *heap = self->pts_heap;
+    guint pos = self->pts_heap_len++;
+    while (pos > 0) {
+        guint parent = (pos - 1) / 2; // 2: binary heap
+        if (heap[parent] <= pts) {
+            break;
+        }
+        heap[pos] = heap[parent];
+        pos = parent;
     }
-    for (auto iter = self->pts_list.begin(); iter != self->pts_list.end(); ++iter) {
-        if ((*iter) == frame->pts) {
+    heap[pos] = pts;
+}
+
+static GstClockTime gst_vdec_base_pts_heap_pop(GstVdecBase *self)
+{
+    GstClockTime *heap = self->pts_heap;
+    GstClockTime top = heap[0];
+    GstClockTime last = heap[--self->pts_heap_len];
+    guint len = self->pts_heap_len;
+    guint pos = 0;
+    while (true) {
+        guint child = pos * 2 + 1; // 2: binary heap
+        if (child >= len) {
             break;
         }
-        if ((*iter) > frame->pts) {
-            self->pts_list.insert(iter, frame->pts);
+        if (child + 1 < len && heap[child + 1] < heap[child]) {
+            child++;
+        }
+        if (last <= heap[child]) {
             break;
         }
+        heap[pos] = heap[child];
+        pos = child;
+    }
+    if (len > 0) {
+        heap[pos] = last;
+    }
+    return top;
+}
+
+static void gst_vdec_base_input_frame_pts_to_list(GstVdecBase *self, GstVideoCodecFrame *frame)
+{
+    GST_DEBUG_OBJECT(self, "Input frame pts %" G_GUINT64_FORMAT, frame->pts);
+    if (frame->pts == GST_CLOCK_TIME_NONE) {
+        return;
+    }
+    g_mutex_lock(&self->lock);
+    // the last_pts is the max pts in the heap if it is not empty
+    if (self->pts_heap_len == 0 || frame->pts > self->last_pts) {
+        self->last_pts = frame->pts;
     }
+    // the duplicated pts will be dropped when popped
+    gst_vdec_base_pts_heap_push(self, frame->pts);
     g_mutex_unlock(&self->lock);
 }
 
@@ -930,11 +1028,13 @@ static int32_t gst_vdec_base_push_input_buffer_with_copy(GstVdecBase *self, GstB
     return codec_ret;
 }
 
+// only the buffers acquired from the proposed input pool could be queued to the codec without copy,
+// which are shmem buffers with the buffer type meta.
 static gboolean gst_vdec_check_ashmem_buffer(GstBuffer *buffer)
 {
     g_return_val_if_fail(buffer != nullptr, FALSE);
     GstMemory *memory = gst_buffer_peek_memory(buffer, 0);
-    return gst_is_shmem_memory(memory);
+    return gst_is_shmem_memory(memory) && gst_buffer_get_buffer_type_meta(buffer) != nullptr;
 }
 
 static GstFlowReturn gst_vdec_base_push_input_buffer(GstVideoDecoder *decoder, GstVideoCodecFrame *frame)
@@ -963,7 +1063,15 @@ static GstFlowReturn gst_vdec_base_push_input_buffer(GstVideoDecoder *decoder, G
     GST_VIDEO_DECODER_STREAM_UNLOCK(self);
 
     gint codec_ret = GST_CODEC_OK;
-    if (!gst_vdec_check_ashmem_buffer(buf) && self->input_need_ashmem) {
+    gboolean need_copy = !gst_vdec_check_ashmem_buffer(buf) && self->input_need_ashmem;
+    GST_OBJECT_LOCK(self);
+    if (need_copy) {
+        self->input_copy_cnt++;
+    } else {
+        self->input_zero_copy_cnt++;
+    }
+    GST_OBJECT_UNLOCK(self);
+    if (need_copy) {
         codec_ret = gst_vdec_base_push_input_buffer_with_copy(self, buf);
     } else {
         gst_vdec_base_dump_input_buffer(self, buf);
@@ -1061,13 +1169,15 @@ static GstVideoCodecFrame *gst_vdec_base_new_frame(GstVdecBase *self)
     frame->decode_frame_number = 0;
     frame->dts = GST_CLOCK_TIME_NONE;
     g_mutex_lock(&self->lock);
-    if (self->pts_list.empty()) {
+    if (self->pts_heap_len == 0) {
         frame->pts = self->last_pts;
         GST_WARNING_OBJECT(self, "No pts available");
     } else {
-        frame->pts = self->pts_list.front();
+        frame->pts = gst_vdec_base_pts_heap_pop(self);
+        while (self->pts_heap_len > 0 && self->pts_heap[0] == frame->pts) {
+            (void)gst_vdec_base_pts_heap_pop(self);
+        }
         GST_DEBUG_OBJECT(self, "Pts %" G_GUINT64_FORMAT, frame->pts);
-        self->pts_list.pop_front();
     }
     g_mutex_unlock(&self->lock);
     frame->duration = GST_CLOCK_TIME_NONE;
@@ -1075,6 +1185,48 @@ static GstVideoCodecFrame *gst_vdec_base_new_frame(GstVdecBase *self)
 
     return frame;
 }
+static void gst_vdec_base_release_nostride_pool(GstVdecBase *self)
+{
+    if (self->nostride_pool != nullptr) {
+        (void)gst_buffer_pool_set_active(self->nostride_pool, FALSE);
+        gst_object_unref(self->nostride_pool);
+        self->nostride_pool = nullptr;
+    }
+    self->nostride_width = 0;
+    self->nostride_height = 0;
+    self->nostride_format = GST_VIDEO_FORMAT_UNKNOWN;
+}
+
+// the no stride buffers are recycled until the width, height or format changes
+static GstBuffer *gst_vdec_base_acquire_nostride_buffer(GstVdecBase *self, guint size)
+{
+    if (self->nostride_pool == nullptr || self->nostride_width != self->width ||
+        self->nostride_height != self->height || self->nostride_format != self->format) {
+        gst_vdec_base_release_nostride_pool(self);
+        GstBufferPool *pool = gst_buffer_pool_new();
+        g_return_val_if_fail(pool != nullptr, nullptr);
+        GstStructure *config = gst_buffer_pool_get_config(pool);
+        gst_buffer_pool_config_set_params(config, nullptr, size, 0, 0);
+        if (gst_buffer_pool_set_config(pool, config) != TRUE || gst_buffer_pool_set_active(pool, TRUE) != TRUE) {
+            GST_WARNING_OBJECT(self, "Failed to activate no stride pool, fallback to allocate");
+            gst_object_unref(pool);
+            return gst_buffer_new_allocate(nullptr, size, nullptr);
+        }
+        self->nostride_pool = pool;
+        self->nostride_width = self->width;
+        self->nostride_height = self->height;
+        self->nostride_format = self->format;
+        GST_DEBUG_OBJECT(self, "No stride pool created, buffer size %u", size);
+    }
+
+    GstBuffer *buffer = nullptr;
+    if (gst_buffer_pool_acquire_buffer(self->nostride_pool, &buffer, nullptr) != GST_FLOW_OK || buffer == nullptr) {
+        GST_WARNING_OBJECT(self, "Failed to acquire no stride buffer, fallback to allocate");
+        return gst_buffer_new_allocate(nullptr, size, nullptr);
+    }
+    return buffer;
+}
+
 // copy for avshmem
 static void copy_to_no_stride_buffer(GstVdecBase *self, GstVideoCodecFrame *frame)
 {
@@ -1089,7 +1241,7 @@ static void copy_to_no_stride_buffer(GstVdecBase *self, GstVideoCodecFrame *fram
     guint stride = (guint)(self->real_stride == 0 ? self->stride : self->real_stride);
     guint stride_height = (guint)(self->real_stride_height == 0 ? self->stride_height : self->real_stride_height);
     guint offset = stride * stride_height;
-    GstBuffer *dts_buffer = gst_buffer_new_allocate(nullptr, size, nullptr);
+    GstBuffer *dts_buffer = gst_vdec_base_acquire_nostride_buffer(self, size);
     g_return_if_fail(dts_buffer != nullptr);
     frame->output_buffer = dts_buffer;
 
@@ -1105,22 +1257,15 @@ static void copy_to_no_stride_buffer(GstVdecBase *self, GstVideoCodecFrame *fram
     ON_SCOPE_EXIT(2) { gst_buffer_unmap(src_buffer, &src_map); };
     // yuv buffer size
     g_return_if_fail(src_map.size >= offset * 3 / 2);
-    errno_t ret = EOK;
-    guint src_offset = 0;
-    guint dts_offset = 0;
-    for (int pos = 0; pos < self->height; pos++) {
-        ret = memcpy_s(dts_map.data + dts_offset, dts_map.size - dts_offset, src_map.data + src_offset, self->width);
-        g_return_if_fail(ret == EOK);
-        dts_offset += (guint)self->width;
-        src_offset += stride;
-    }
-    src_offset = offset;
-    for (int pos = 0; pos < self->height / 2; pos++) {
-        ret = memcpy_s(dts_map.data + dts_offset, dts_map.size - dts_offset, src_map.data + src_offset, self->width);
-        g_return_if_fail(ret == EOK);
-        dts_offset += self->width;
-        src_offset += stride;
-    }
+    guint width = (guint)self->width;
+    guint y_size = width * (guint)self->height;
+    g_return_if_fail(dts_map.size >= y_size);
+    // y plane
+    g_return_if_fail(CopyVideoPlane(dts_map.data, dts_map.size, width,
+        src_map.data, src_map.size, stride, width, (guint)self->height));
+    // uv plane, interleaved with half height
+    g_return_if_fail(CopyVideoPlane(dts_map.data + y_size, dts_map.size - y_size, width,
+        src_map.data + offset, src_map.size - offset, stride, width, (guint)self->height / 2));
     gint rst_stride[GST_VIDEO_MAX_PLANES] = { self->width, self->width, 0, 0 };
     gsize rst_offset[GST_VIDEO_MAX_PLANES] = { 0, self->width * self->height, 0, 0 };
     static const gint nplane = 2; // nv12 or nv21 planes count
@@ -1554,8 +1699,7 @@ static gboolean gst_vdec_base_event(GstVideoDecoder *decoder, GstEvent *event)
             ret = GST_VIDEO_DECODER_CLASS(parent_class)->sink_event(decoder, event);
             {
                 g_mutex_lock(&self->lock);
-                std::list<GstClockTime> empty;
-                self->pts_list.swap(empty);
+                self->pts_heap_len = 0;
                 self->last_pts = GST_CLOCK_TIME_NONE;
                 g_mutex_unlock(&self->lock);
             }
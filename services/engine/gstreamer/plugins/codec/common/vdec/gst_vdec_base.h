@@ -17,7 +17,6 @@
 #define GST_VDEC_BASE_H
 
 #include <vector>
-#include <list>
 #include <gst/video/gstvideodecoder.h>
 #include "gst_shmem_allocator.h"
 #include "gst_shmem_pool.h"
@@ -100,7 +99,10 @@ struct _GstVdecBase {
     guint coding_outbuf_cnt;
     guint out_buffer_cnt;
     guint out_buffer_max_cnt;
-    std::list<GstClockTime> pts_list;
+    // min-heap of the pts of the frames queued to the codec, guarded by lock
+    GstClockTime *pts_heap;
+    guint pts_heap_len;
+    guint pts_heap_capacity;
     GstClockTime last_pts;
     gboolean flushing_stoping;
     gboolean decoder_start;
@@ -115,7 +117,13 @@ struct _GstVdecBase {
     gboolean resolution_changed;
     GstCaps *sink_caps;
     gboolean input_need_ashmem;
+    guint64 input_copy_cnt;
+    guint64 input_zero_copy_cnt;
     gboolean has_set_format;
+    GstBufferPool *nostride_pool;
+    gint nostride_width;
+    gint nostride_height;
+    GstVideoFormat nostride_format;
 };
 
 struct _GstVdecBaseClass {
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "video_plane_copy.h"
+#include "securec.h"
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define VIDEO_PLANE_COPY_NEON
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define VIDEO_PLANE_COPY_AVX2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define VIDEO_PLANE_COPY_SSE2
+#endif
+
+namespace {
+    constexpr size_t BLOCK_SIZE = 64; // bytes copied by one iteration of the vector loop
+}
+
+namespace OHOS {
+namespace Media {
+static inline void CopyRow(uint8_t *dst, const uint8_t *src, size_t width)
+{
+    size_t pos = 0;
+#if defined(VIDEO_PLANE_COPY_NEON)
+    for (; pos + BLOCK_SIZE <= width; pos += BLOCK_SIZE) {
+        uint8x16_t r0 = vld1q_u8(src + pos);
+        uint8x16_t r1 = vld1q_u8(src + pos + 16); // 16: second 16 bytes
+        uint8x16_t r2 = vld1q_u8(src + pos + 32); // 32: third 16 bytes
+        uint8x16_t r3 = vld1q_u8(src + pos + 48); // 48: fourth 16 bytes
+        vst1q_u8(dst + pos, r0);
+        vst1q_u8(dst + pos + 16, r1); // 16: second 16 bytes
+        vst1q_u8(dst + pos + 32, r2); // 32: third 16 bytes
+        vst1q_u8(dst + pos + 48, r3); // 48: fourth 16 bytes
+    }
+#elif defined(VIDEO_PLANE_COPY_AVX2)
+    for (; pos + BLOCK_SIZE <= width; pos += BLOCK_SIZE) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + pos));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + pos + sizeof(__m256i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + pos), lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + pos + sizeof(__m256i)), hi);
+    }
+#elif defined(VIDEO_PLANE_COPY_SSE2)
+    for (; pos + BLOCK_SIZE <= width; pos += BLOCK_SIZE) {
+        const __m128i *in = reinterpret_cast<const __m128i *>(src + pos);
+        __m128i *out = reinterpret_cast<__m128i *>(dst + pos);
+        __m128i r0 = _mm_loadu_si128(in);
+        __m128i r1 = _mm_loadu_si128(in + 1); // 1: second 16 bytes
+        __m128i r2 = _mm_loadu_si128(in + 2); // 2: third 16 bytes
+        __m128i r3 = _mm_loadu_si128(in + 3); // 3: fourth 16 bytes
+        _mm_storeu_si128(out, r0);
+        _mm_storeu_si128(out + 1, r1); // 1: second 16 bytes
+        _mm_storeu_si128(out + 2, r2); // 2: third 16 bytes
+        _mm_storeu_si128(out + 3, r3); // 3: fourth 16 bytes
+    }
+#endif
+    if (pos < width) {
+        // the bounds have been checked by the caller
+        (void)memcpy_s(dst + pos, width - pos, src + pos, width - pos);
+    }
+}
+
+bool CopyVideoPlane(uint8_t *dst, size_t dstSize, uint32_t dstStride,
+    const uint8_t *src, size_t srcSize, uint32_t srcStride, uint32_t width, uint32_t rows)
+{
+    if (dst == nullptr || src == nullptr || dstStride < width || srcStride < width) {
+        return false;
+    }
+    if (width == 0 || rows == 0) {
+        return true;
+    }
+    // the last row does not need the padding after the width
+    size_t dstNeed = static_cast<size_t>(dstStride) * (rows - 1) + width;
+    size_t srcNeed = static_cast<size_t>(srcStride) * (rows - 1) + width;
+    if (dstSize < dstNeed || srcSize < srcNeed) {
+        return false;
+    }
+
+    if (dstStride == width && srcStride == width) {
+        return memcpy_s(dst, dstSize, src, dstNeed) == EOK;
+    }
+
+    for (uint32_t row = 0; row < rows; row++) {
+        CopyRow(dst, src, width);
+        dst += dstStride;
+        src += srcStride;
+    }
+    return true;
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VIDEO_PLANE_COPY_H
+#define VIDEO_PLANE_COPY_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace OHOS {
+namespace Media {
+/**
+ * Copy @rows rows of @width bytes from a strided plane to another strided plane.
+ * If both strides equal to the width, the plane is contiguous and will be copied at once,
+ * otherwise every row is copied by the vectorized row kernel (NEON/AVX2/SSE2 if available).
+ *
+ * @return false if either buffer is too small to hold the plane, nothing is copied in this case.
+ */
+bool CopyVideoPlane(uint8_t *dst, size_t dstSize, uint32_t dstStride,
+    const uint8_t *src, size_t srcSize, uint32_t srcStride, uint32_t width, uint32_t rows);
+} // namespace Media
+} // namespace OHOS
+#endif // VIDEO_PLANE_COPY_H
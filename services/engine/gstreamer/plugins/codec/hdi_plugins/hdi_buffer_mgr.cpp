@@ -21,6 +21,7 @@
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "HdiBufferMgr"};
+    constexpr uint32_t BITS_PER_WORD = 64;
 }
 
 namespace OHOS {
@@ -54,38 +55,29 @@ void HdiBufferMgr::Init(CodecComponentType *handle, int32_t index, const CompVer
     mPortDef_.nPortIndex = (uint32_t)index;
 }
 
-std::shared_ptr<HdiBufferWrap> HdiBufferMgr::GetCodecBuffer(GstBuffer *buffer)
+HdiBufferWrap *HdiBufferMgr::GetCodecBuffer(GstBuffer *buffer)
 {
     MEDIA_LOGD("Enter GetCodecBuffer");
-    std::shared_ptr<HdiBufferWrap> codecBuffer = nullptr;
     GstBufferTypeMeta *bufferType = gst_buffer_get_buffer_type_meta(buffer);
     CHECK_AND_RETURN_RET_LOG(bufferType != nullptr, nullptr, "bufferType is nullptr");
-    for (auto iter = availableBuffers_.begin(); iter != availableBuffers_.end(); ++iter) {
-        if (*iter != nullptr) {
-            if ((*iter)->buf == bufferType->buf) {
-                codecBuffer = *iter;
-                codingBuffers_.push_back(std::make_pair(codecBuffer, buffer));
-                gst_buffer_ref(buffer);
-                (void)availableBuffers_.erase(iter);
-                UpdateCodecMeta(bufferType, codecBuffer);
-                codecBuffer->hdiBuffer.pts = (int64_t)(GST_BUFFER_PTS(buffer));
-                break;
-            }
-        }
-    }
+    uint32_t slot = FindAvailableSlot(bufferType->buf);
+    CHECK_AND_RETURN_RET_LOG(slot != INVALID_SLOT, nullptr, "buffer is not available");
+    HdiBufferWrap *codecBuffer = AcquireCodecBuffer(slot, buffer);
+    gst_buffer_ref(buffer);
+    UpdateCodecMeta(bufferType, *codecBuffer);
+    codecBuffer->hdiBuffer.pts = (int64_t)(GST_BUFFER_PTS(buffer));
     return codecBuffer;
 }
 
-void HdiBufferMgr::UpdateCodecMeta(GstBufferTypeMeta *bufferType, std::shared_ptr<HdiBufferWrap> &codecBuffer)
+void HdiBufferMgr::UpdateCodecMeta(GstBufferTypeMeta *bufferType, HdiBufferWrap &codecBuffer)
 {
     MEDIA_LOGD("Enter UpdateCodecMeta");
-    CHECK_AND_RETURN_LOG(codecBuffer != nullptr, "bufferType is nullptr");
     CHECK_AND_RETURN_LOG(bufferType != nullptr, "bufferType is nullptr");
-    codecBuffer->hdiBuffer.allocLen = bufferType->totalSize;
-    codecBuffer->hdiBuffer.offset = bufferType->offset;
-    codecBuffer->hdiBuffer.filledLen = bufferType->length;
-    codecBuffer->hdiBuffer.fenceFd = bufferType->fenceFd;
-    codecBuffer->hdiBuffer.type = bufferType->memFlag == FLAGS_READ_ONLY ? READ_ONLY_TYPE : READ_WRITE_TYPE;
+    codecBuffer.hdiBuffer.allocLen = bufferType->totalSize;
+    codecBuffer.hdiBuffer.offset = bufferType->offset;
+    codecBuffer.hdiBuffer.filledLen = bufferType->length;
+    codecBuffer.hdiBuffer.fenceFd = bufferType->fenceFd;
+    codecBuffer.hdiBuffer.type = bufferType->memFlag == FLAGS_READ_ONLY ? READ_ONLY_TYPE : READ_WRITE_TYPE;
 }
 
 std::vector<std::shared_ptr<HdiBufferWrap>> HdiBufferMgr::PreUseAshareMems(std::vector<GstBuffer *> &buffers)
@@ -126,7 +118,7 @@ int32_t HdiBufferMgr::UseHdiBuffers(std::vector<std::shared_ptr<HdiBufferWrap>>
         auto ret = handle_->UseBuffer(handle_, (uint32_t)mPortIndex_, &buffer->hdiBuffer);
         CHECK_AND_RETURN_RET_LOG(ret == HDF_SUCCESS, GST_CODEC_ERROR, "UseBuffer failed");
         MEDIA_LOGD("Enter buffer id %{public}d", buffer->hdiBuffer.bufferId);
-        availableBuffers_.push_back(buffer);
+        AddCodecBuffer(buffer);
     }
     return GST_CODEC_OK;
 }
@@ -134,13 +126,21 @@ int32_t HdiBufferMgr::UseHdiBuffers(std::vector<std::shared_ptr<HdiBufferWrap>>
 void HdiBufferMgr::FreeCodecBuffers()
 {
     MEDIA_LOGD("Enter FreeCodecBuffers");
-    for (auto codecBuffer : availableBuffers_) {
+    for (uint32_t slot = 0; slot < slots_.size(); slot++) {
+        if (!IsSlotAvailable(slot)) {
+            continue;
+        }
+        std::shared_ptr<HdiBufferWrap> &codecBuffer = slots_[slot].codecBuffer;
         auto ret = handle_->FreeBuffer(handle_, mPortIndex_, &codecBuffer->hdiBuffer);
         if (ret != HDF_SUCCESS) {
             MEDIA_LOGE("free buffer %{public}u fail", codecBuffer->hdiBuffer.bufferId);
         }
     }
-    EmptyList(availableBuffers_);
+    EmptyList(slots_);
+    EmptyList(freeSlots_);
+    availableCount_ = 0;
+    idSlots_.clear();
+    bufSlots_.clear();
     MEDIA_LOGD("Enter FreeCodecBuffers End");
 }
 
@@ -157,14 +157,20 @@ int32_t HdiBufferMgr::Stop()
 int32_t HdiBufferMgr::Flush(bool enable)
 {
     MEDIA_LOGD("Enter Flush %{public}d", enable);
-    std::unique_lock<std::mutex> lock(mutex_);
-    isFlushing_ = enable;
-    if (isFlushing_) {
-        bufferCond_.notify_all();
-        isFlushed_ = true;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        isFlushing_ = enable;
+        if (isFlushing_) {
+            bufferCond_.notify_all();
+            isFlushed_ = true;
+        }
+        if (!isFlushing_) {
+            flushCond_.notify_all();
+        }
     }
-    if (!isFlushing_) {
-        flushCond_.notify_all();
+    if (enable) {
+        // the submission in progress must reach the codec before the flush command does
+        std::unique_lock<std::mutex> submitLock(submitMutex_);
     }
     return GST_CODEC_OK;
 }
@@ -178,9 +184,79 @@ void HdiBufferMgr::WaitFlushed()
 
 void HdiBufferMgr::NotifyAvailable()
 {
-    if (isStart_ == false && availableBuffers_.size() == mPortDef_.nBufferCountActual) {
+    if (isStart_ == false && availableCount_ == mPortDef_.nBufferCountActual) {
         freeCond_.notify_all();
     }
 }
+
+void HdiBufferMgr::AddCodecBuffer(const std::shared_ptr<HdiBufferWrap> &codecBuffer)
+{
+    uint32_t slot = static_cast<uint32_t>(slots_.size());
+    slots_.push_back({codecBuffer, nullptr});
+    freeSlots_.resize(slot / BITS_PER_WORD + 1, 0);
+    SetSlotAvailable(slot, true);
+    idSlots_[codecBuffer->hdiBuffer.bufferId] = slot;
+    if (codecBuffer->buf != 0) {
+        bufSlots_[codecBuffer->buf] = slot;
+    }
+}
+
+uint32_t HdiBufferMgr::FindAvailableSlot(intptr_t buf) const
+{
+    auto iter = bufSlots_.find(buf);
+    if (iter == bufSlots_.end() || !IsSlotAvailable(iter->second)) {
+        return INVALID_SLOT;
+    }
+    return iter->second;
+}
+
+uint32_t HdiBufferMgr::FirstAvailableSlot() const
+{
+    for (uint32_t word = 0; word < freeSlots_.size(); word++) {
+        if (freeSlots_[word] != 0) {
+            return word * BITS_PER_WORD + static_cast<uint32_t>(__builtin_ctzll(freeSlots_[word]));
+        }
+    }
+    return INVALID_SLOT;
+}
+
+HdiBufferWrap *HdiBufferMgr::AcquireCodecBuffer(uint32_t slot, GstBuffer *buffer)
+{
+    SetSlotAvailable(slot, false);
+    slots_[slot].gstBuffer = buffer;
+    return slots_[slot].codecBuffer.get();
+}
+
+HdiBufferWrap *HdiBufferMgr::ReleaseCodecBuffer(uint32_t bufferId, GstBuffer *&buffer)
+{
+    auto iter = idSlots_.find(bufferId);
+    if (iter == idSlots_.end() || IsSlotAvailable(iter->second)) {
+        MEDIA_LOGW("buffer %{public}u is not coding", bufferId);
+        return nullptr;
+    }
+    BufferSlot &slot = slots_[iter->second];
+    buffer = slot.gstBuffer;
+    slot.gstBuffer = nullptr;
+    SetSlotAvailable(iter->second, true);
+    return slot.codecBuffer.get();
+}
+
+bool HdiBufferMgr::IsSlotAvailable(uint32_t slot) const
+{
+    return ((freeSlots_[slot / BITS_PER_WORD] >> (slot % BITS_PER_WORD)) & 1) != 0;
+}
+
+void HdiBufferMgr::SetSlotAvailable(uint32_t slot, bool available)
+{
+    uint64_t bit = 1ULL << (slot % BITS_PER_WORD);
+    uint64_t &word = freeSlots_[slot / BITS_PER_WORD];
+    if (available && (word & bit) == 0) {
+        word |= bit;
+        availableCount_++;
+    } else if (!available && (word & bit) != 0) {
+        word &= ~bit;
+        availableCount_--;
+    }
+}
 }  // namespace Media
 }  // namespace OHOS
@@ -19,6 +19,7 @@
 #include <mutex>
 #include <list>
 #include <vector>
+#include <unordered_map>
 #include <condition_variable>
 #include <gst/gst.h>
 #include <OMX_Core.h>
@@ -87,25 +88,55 @@ public:
     virtual void WaitFlushed();
 
 protected:
+    static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+    // the codec buffers stay in their slots from UseBuffer to FreeBuffer, a buffer is moved between available
+    // and coding by flipping its bit in freeSlots_, so the transitions never search a list or allocate.
+    struct BufferSlot {
+        std::shared_ptr<HdiBufferWrap> codecBuffer = nullptr;
+        GstBuffer *gstBuffer = nullptr;
+    };
     void FreeCodecBuffers();
+    void AddCodecBuffer(const std::shared_ptr<HdiBufferWrap> &codecBuffer);
+    uint32_t FindAvailableSlot(intptr_t buf) const;
+    uint32_t FirstAvailableSlot() const;
+    HdiBufferWrap *AcquireCodecBuffer(uint32_t slot, GstBuffer *buffer);
+    HdiBufferWrap *ReleaseCodecBuffer(uint32_t bufferId, GstBuffer *&buffer);
+    uint32_t AvailableCount() const
+    {
+        return availableCount_;
+    }
+    uint32_t CodingCount() const
+    {
+        return static_cast<uint32_t>(slots_.size()) - availableCount_;
+    }
     bool isFlushing_ = false;
     bool isFlushed_ = false;
     bool isStart_ = false;
     int32_t mPortIndex_ = 0;
     CompVerInfo verInfo_ = {};
     std::mutex mutex_;
+    // serializes the submissions to the codec, which are made without mutex_ so the callbacks are not blocked
+    std::mutex submitMutex_;
     std::condition_variable flushCond_;
     std::condition_variable bufferCond_;
     std::condition_variable freeCond_;
     OMX_PARAM_PORTDEFINITIONTYPE mPortDef_ = {};
     CodecComponentType *handle_ = nullptr;
-    std::list<std::shared_ptr<HdiBufferWrap>> availableBuffers_;
-    std::list<std::pair<std::shared_ptr<HdiBufferWrap>, GstBuffer *>> codingBuffers_;
     std::vector<std::shared_ptr<HdiBufferWrap>> PreUseAshareMems(std::vector<GstBuffer *> &buffers);
     int32_t UseHdiBuffers(std::vector<std::shared_ptr<HdiBufferWrap>> &buffers);
-    virtual std::shared_ptr<HdiBufferWrap> GetCodecBuffer(GstBuffer *buffer);
-    virtual void UpdateCodecMeta(GstBufferTypeMeta *bufferType, std::shared_ptr<HdiBufferWrap> &codecBuffer);
+    virtual HdiBufferWrap *GetCodecBuffer(GstBuffer *buffer);
+    virtual void UpdateCodecMeta(GstBufferTypeMeta *bufferType, HdiBufferWrap &codecBuffer);
     void NotifyAvailable();
+
+private:
+    bool IsSlotAvailable(uint32_t slot) const;
+    void SetSlotAvailable(uint32_t slot, bool available);
+    std::vector<BufferSlot> slots_;
+    // one bit per slot, set if the buffer is available
+    std::vector<uint64_t> freeSlots_;
+    uint32_t availableCount_ = 0;
+    std::unordered_map<uint32_t, uint32_t> idSlots_;
+    std::unordered_map<intptr_t, uint32_t> bufSlots_;
 };
 } // namespace Media
 } // namespace OHOS
@@ -37,36 +37,39 @@ HdiInBufferMgr::~HdiInBufferMgr()
     EmptyList(preBuffers_);
 }
 
-std::shared_ptr<HdiBufferWrap> HdiInBufferMgr::GetHdiEosBuffer()
+HdiBufferWrap *HdiInBufferMgr::GetHdiEosBuffer()
 {
-    std::shared_ptr<HdiBufferWrap> codecBuffer = nullptr;
-    if (!availableBuffers_.empty()) {
-        MEDIA_LOGD("Init eos buffer");
-        codecBuffer = availableBuffers_.front();
-        availableBuffers_.pop_front();
-        codecBuffer->hdiBuffer.filledLen = 0;
-        codecBuffer->hdiBuffer.flag |= OMX_BUFFERFLAG_EOS;
-        codingBuffers_.push_back(std::make_pair(codecBuffer, nullptr));
+    uint32_t slot = FirstAvailableSlot();
+    if (slot == INVALID_SLOT) {
+        return nullptr;
     }
+    MEDIA_LOGD("Init eos buffer");
+    HdiBufferWrap *codecBuffer = AcquireCodecBuffer(slot, nullptr);
+    codecBuffer->hdiBuffer.filledLen = 0;
+    codecBuffer->hdiBuffer.flag |= OMX_BUFFERFLAG_EOS;
     return codecBuffer;
 }
 
 int32_t HdiInBufferMgr::PushBuffer(GstBuffer *buffer)
 {
     MEDIA_LOGD("PushBuffer start");
-    std::unique_lock<std::mutex> lock(mutex_);
-    bufferCond_.wait(lock, [this]() {return !availableBuffers_.empty() || isFlushed_ || !isStart_;});
-    if (isFlushed_ || !isStart_) {
-        return GST_CODEC_FLUSH;
-    }
-    std::shared_ptr<HdiBufferWrap> codecBuffer = nullptr;
-    if (buffer == nullptr) {
-        codecBuffer = GetHdiEosBuffer();
-    } else {
-        codecBuffer = GetCodecBuffer(buffer);
+    std::unique_lock<std::mutex> submitLock(submitMutex_);
+    HdiBufferWrap *codecBuffer = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        bufferCond_.wait(lock, [this]() {return AvailableCount() > 0 || isFlushed_ || !isStart_;});
+        if (isFlushed_ || !isStart_) {
+            return GST_CODEC_FLUSH;
+        }
+        if (buffer == nullptr) {
+            codecBuffer = GetHdiEosBuffer();
+        } else {
+            codecBuffer = GetCodecBuffer(buffer);
+        }
+        CHECK_AND_RETURN_RET_LOG(codecBuffer != nullptr, GST_CODEC_ERROR, "Push buffer failed");
     }
-    CHECK_AND_RETURN_RET_LOG(codecBuffer != nullptr, GST_CODEC_ERROR, "Push buffer failed");
     MEDIA_LOGD("id %{public}d fillLen %{public}d", codecBuffer->hdiBuffer.bufferId, codecBuffer->hdiBuffer.filledLen);
+    // EmptyBufferDone may come before this returns, so mutex_ is not held here
     auto ret = HdiEmptyThisBuffer(handle_, &codecBuffer->hdiBuffer);
     CHECK_AND_RETURN_RET_LOG(ret == HDF_SUCCESS, GST_CODEC_ERROR, "EmptyThisBuffer failed");
     MEDIA_LOGD("PushBuffer end");
@@ -81,7 +84,7 @@ int32_t HdiInBufferMgr::FreeBuffers()
         EmptyList(preBuffers_);
         return GST_CODEC_OK;
     }
-    freeCond_.wait(lock, [this]() { return availableBuffers_.size() == mPortDef_.nBufferCountActual; });
+    freeCond_.wait(lock, [this]() { return AvailableCount() == mPortDef_.nBufferCountActual; });
     FreeCodecBuffers();
     return GST_CODEC_OK;
 }
@@ -90,18 +93,20 @@ int32_t HdiInBufferMgr::CodecBufferAvailable(const OmxCodecBuffer *buffer)
 {
     MEDIA_LOGD("Enter CodecBufferAvailable");
     CHECK_AND_RETURN_RET_LOG(buffer != nullptr, GST_CODEC_ERROR, "EmptyBufferDone failed");
-    std::unique_lock<std::mutex> lock(mutex_);
-    for (auto iter = codingBuffers_.begin(); iter != codingBuffers_.end(); ++iter) {
-        if (iter->first != nullptr && iter->first->hdiBuffer.bufferId == buffer->bufferId) {
-            availableBuffers_.push_back(iter->first);
-            iter->first->hdiBuffer.flag = 0;
-            gst_buffer_unref(iter->second);
-            (void)codingBuffers_.erase(iter);
-            break;
+    GstBuffer *gstBuffer = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        HdiBufferWrap *codecBuffer = ReleaseCodecBuffer(buffer->bufferId, gstBuffer);
+        if (codecBuffer != nullptr) {
+            codecBuffer->hdiBuffer.flag = 0;
         }
+        NotifyAvailable();
+        bufferCond_.notify_all();
+    }
+    // the eos buffer is not backed by a gst buffer
+    if (gstBuffer != nullptr) {
+        gst_buffer_unref(gstBuffer);
     }
-    NotifyAvailable();
-    bufferCond_.notify_all();
     return GST_CODEC_OK;
 }
 }  // namespace Media
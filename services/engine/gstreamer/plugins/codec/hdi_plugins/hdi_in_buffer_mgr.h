@@ -34,7 +34,7 @@ public:
 
 protected:
     std::vector<std::shared_ptr<HdiBufferWrap>> preBuffers_;
-    std::shared_ptr<HdiBufferWrap> GetHdiEosBuffer();
+    HdiBufferWrap *GetHdiEosBuffer();
 };
 } // namespace Media
 } // namespace OHOS
@@ -40,18 +40,23 @@ HdiOutBufferMgr::~HdiOutBufferMgr()
 
 int32_t HdiOutBufferMgr::Start()
 {
-    MEDIA_LOGD("Enter Start mBuffers size %{public}zu", mBuffers.size());
+    std::unique_lock<std::mutex> submitLock(submitMutex_);
     std::unique_lock<std::mutex> lock(mutex_);
+    MEDIA_LOGD("Enter Start mBuffers size %{public}zu", mBuffers.size());
     isStart_ = true;
     isFlushed_ = false;
-    while (!mBuffers.empty()) {
-        GstBufferWrap buffer = mBuffers.front();
-        std::shared_ptr<HdiBufferWrap> codecBuffer = GetCodecBuffer(buffer.gstBuffer);
+    // the buffers filled while submitting are queued behind these, and must not be submitted again
+    size_t count = mBuffers.size();
+    for (size_t i = 0; i < count; i++) {
+        // the ready buffer is kept queued if it could not be submitted
+        HdiBufferWrap *codecBuffer = GetCodecBuffer(mBuffers.front().gstBuffer);
         CHECK_AND_RETURN_RET_LOG(codecBuffer != nullptr, GST_CODEC_ERROR, "Push buffer failed");
+        GstBufferWrap buffer = PopReadyBuffer();
+        gst_buffer_unref(buffer.gstBuffer);
+        lock.unlock();
         auto ret = HdiFillThisBuffer(handle_, &codecBuffer->hdiBuffer);
+        lock.lock();
         CHECK_AND_RETURN_RET_LOG(ret == HDF_SUCCESS, GST_CODEC_ERROR, "FillThisBuffer failed");
-        mBuffers.pop_front();
-        gst_buffer_unref(buffer.gstBuffer);
     }
     MEDIA_LOGD("Quit Start");
     return GST_CODEC_OK;
@@ -59,17 +64,21 @@ int32_t HdiOutBufferMgr::Start()
 
 int32_t HdiOutBufferMgr::PushBuffer(GstBuffer *buffer)
 {
-    MEDIA_LOGD("mBuffers %{public}zu, available %{public}zu, codingBuffers %{public}zu",
-        mBuffers.size(), availableBuffers_.size(), codingBuffers_.size());
-    std::unique_lock<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> submitLock(submitMutex_);
     ON_SCOPE_EXIT(0) { gst_buffer_unref(buffer); };
-    if (isFlushed_ || !isStart_) {
-        MEDIA_LOGD("isFlush %{public}d isStart %{public}d", isFlushed_, isStart_);
-        return GST_CODEC_FLUSH;
+    HdiBufferWrap *codecBuffer = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        MEDIA_LOGD("mBuffers %{public}zu, available %{public}u, codingBuffers %{public}u",
+            mBuffers.size(), AvailableCount(), CodingCount());
+        if (isFlushed_ || !isStart_) {
+            MEDIA_LOGD("isFlush %{public}d isStart %{public}d", isFlushed_, isStart_);
+            return GST_CODEC_FLUSH;
+        }
+        codecBuffer = GetCodecBuffer(buffer);
+        CHECK_AND_RETURN_RET_LOG(codecBuffer != nullptr, GST_CODEC_ERROR, "Push buffer failed");
     }
-    std::shared_ptr<HdiBufferWrap> codecBuffer = nullptr;
-    codecBuffer = GetCodecBuffer(buffer);
-    CHECK_AND_RETURN_RET_LOG(codecBuffer != nullptr, GST_CODEC_ERROR, "Push buffer failed");
+    // FillBufferDone may come before this returns, so mutex_ is not held here
     auto ret = HdiFillThisBuffer(handle_, &codecBuffer->hdiBuffer);
     CHECK_AND_RETURN_RET_LOG(ret == HDF_SUCCESS, GST_CODEC_ERROR, "FillThisBuffer failed");
     return GST_CODEC_OK;
@@ -86,9 +95,8 @@ int32_t HdiOutBufferMgr::PullBuffer(GstBuffer **buffer)
         return GST_CODEC_FLUSH;
     }
     if (!mBuffers.empty()) {
-        MEDIA_LOGD("mBuffers %{public}zu, available %{public}zu", mBuffers.size(), availableBuffers_.size());
-        GstBufferWrap bufferWarp = mBuffers.front();
-        mBuffers.pop_front();
+        MEDIA_LOGD("mBuffers %{public}zu, available %{public}u", mBuffers.size(), AvailableCount());
+        GstBufferWrap bufferWarp = PopReadyBuffer();
         if (bufferWarp.isEos) {
             gst_buffer_unref(bufferWarp.gstBuffer);
             MEDIA_LOGD("buffer is in eos");
@@ -104,10 +112,11 @@ int32_t HdiOutBufferMgr::FreeBuffers()
 {
     MEDIA_LOGD("FreeBuffers");
     std::unique_lock<std::mutex> lock(mutex_);
-    freeCond_.wait(lock, [this]() { return availableBuffers_.size() == mPortDef_.nBufferCountActual; });
+    freeCond_.wait(lock, [this]() { return AvailableCount() == mPortDef_.nBufferCountActual; });
     FreeCodecBuffers();
     std::for_each(mBuffers.begin(), mBuffers.end(), [&](GstBufferWrap buffer) { gst_buffer_unref(buffer.gstBuffer); });
     EmptyList(mBuffers);
+    EmptyList(spareBuffers_);
     return GST_CODEC_OK;
 }
 
@@ -116,27 +125,40 @@ int32_t HdiOutBufferMgr::CodecBufferAvailable(const OmxCodecBuffer *buffer)
     MEDIA_LOGD("codecBufferAvailable");
     CHECK_AND_RETURN_RET_LOG(buffer != nullptr, GST_CODEC_ERROR, "FillBufferDone failed");
     std::unique_lock<std::mutex> lock(mutex_);
-    MEDIA_LOGD("mBuffers %{public}zu, available %{public}zu codingBuffers %{public}zu",
-        mBuffers.size(), availableBuffers_.size(), codingBuffers_.size());
-    for (auto iter = codingBuffers_.begin(); iter != codingBuffers_.end(); ++iter) {
-        if (iter->first != nullptr && iter->first->hdiBuffer.bufferId == buffer->bufferId) {
-            availableBuffers_.push_back(iter->first);
-            GstBufferWrap bufferWarp = {};
-            if (buffer->flag & OMX_BUFFERFLAG_EOS) {
-                MEDIA_LOGD("Bufferavailable, but buffer is eos");
-                bufferWarp.isEos = true;
-            } else {
-                gst_buffer_resize(iter->second, buffer->offset, buffer->filledLen);
-            }
-            bufferWarp.gstBuffer = iter->second;
-            mBuffers.push_back(bufferWarp);
-            (void)codingBuffers_.erase(iter);
-            break;
+    MEDIA_LOGD("mBuffers %{public}zu, available %{public}u codingBuffers %{public}u",
+        mBuffers.size(), AvailableCount(), CodingCount());
+    GstBuffer *gstBuffer = nullptr;
+    if (ReleaseCodecBuffer(buffer->bufferId, gstBuffer) != nullptr && gstBuffer != nullptr) {
+        GstBufferWrap bufferWarp = {};
+        if (buffer->flag & OMX_BUFFERFLAG_EOS) {
+            MEDIA_LOGD("Bufferavailable, but buffer is eos");
+            bufferWarp.isEos = true;
+        } else {
+            gst_buffer_resize(gstBuffer, buffer->offset, buffer->filledLen);
         }
+        bufferWarp.gstBuffer = gstBuffer;
+        PushReadyBuffer(bufferWarp);
     }
     NotifyAvailable();
     bufferCond_.notify_all();
     return GST_CODEC_OK;
 }
+
+void HdiOutBufferMgr::PushReadyBuffer(const GstBufferWrap &buffer)
+{
+    if (spareBuffers_.empty()) {
+        mBuffers.push_back(buffer);
+        return;
+    }
+    mBuffers.splice(mBuffers.end(), spareBuffers_, spareBuffers_.begin());
+    mBuffers.back() = buffer;
+}
+
+GstBufferWrap HdiOutBufferMgr::PopReadyBuffer()
+{
+    GstBufferWrap buffer = mBuffers.front();
+    spareBuffers_.splice(spareBuffers_.end(), mBuffers, mBuffers.begin());
+    return buffer;
+}
 }  // namespace Media
 }  // namespace OHOS
@@ -37,6 +37,12 @@ public:
 
 protected:
     std::list<GstBufferWrap> mBuffers;
+
+private:
+    // the nodes popped from mBuffers are kept and spliced back, so the callbacks do not allocate
+    void PushReadyBuffer(const GstBufferWrap &buffer);
+    GstBufferWrap PopReadyBuffer();
+    std::list<GstBufferWrap> spareBuffers_;
 };
 } // namespace Media
 } // namespace OHOS
@@ -55,7 +55,7 @@ int32_t HdiVdecOutBufferMgr::UseHandleMems(std::vector<GstBuffer *> &buffers)
         codecBuffer->hdiBuffer.bufferLen = bufferType->bufLen;
         auto ret = handle_->UseBuffer(handle_, (uint32_t)mPortIndex_, &codecBuffer->hdiBuffer);
         CHECK_AND_RETURN_RET_LOG(ret == HDF_SUCCESS, GST_CODEC_ERROR, "UseBuffer failed");
-        availableBuffers_.push_back(codecBuffer);
+        AddCodecBuffer(codecBuffer);
         GstBufferWrap bufferWarp = {};
         bufferWarp.gstBuffer = buffer;
         mBuffers.push_back(bufferWarp);
@@ -86,13 +86,12 @@ int32_t HdiVdecOutBufferMgr::UseBuffers(std::vector<GstBuffer *> buffers)
     return GST_CODEC_OK;
 }
 
-void HdiVdecOutBufferMgr::UpdateCodecMeta(GstBufferTypeMeta *bufferType, std::shared_ptr<HdiBufferWrap> &codecBuffer)
+void HdiVdecOutBufferMgr::UpdateCodecMeta(GstBufferTypeMeta *bufferType, HdiBufferWrap &codecBuffer)
 {
     MEDIA_LOGD("Enter UpdateCodecMeta");
-    CHECK_AND_RETURN_LOG(codecBuffer != nullptr, "bufferType is nullptr");
     CHECK_AND_RETURN_LOG(bufferType != nullptr, "bufferType is nullptr");
     if (enableNativeBuffer_) {
-        codecBuffer->hdiBuffer.fenceFd = bufferType->fenceFd;
+        codecBuffer.hdiBuffer.fenceFd = bufferType->fenceFd;
     } else {
         HdiBufferMgr::UpdateCodecMeta(bufferType, codecBuffer);
     }
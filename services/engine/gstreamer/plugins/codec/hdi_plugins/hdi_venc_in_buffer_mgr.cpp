@@ -75,15 +75,15 @@ int32_t HdiVencInBufferMgr::UseBuffers(std::vector<GstBuffer *> buffers)
     return GST_CODEC_OK;
 }
 
-std::shared_ptr<HdiBufferWrap> HdiVencInBufferMgr::GetCodecBuffer(GstBuffer *buffer)
+HdiBufferWrap *HdiVencInBufferMgr::GetCodecBuffer(GstBuffer *buffer)
 {
     MEDIA_LOGD("Enter GetCodecBuffer");
     if (enableNativeBuffer_) {
         GstBufferTypeMeta *bufferType = gst_buffer_get_buffer_type_meta(buffer);
         CHECK_AND_RETURN_RET_LOG(bufferType != nullptr, nullptr, "bufferType is nullptr");
-        std::shared_ptr<HdiBufferWrap> codecBuffer = availableBuffers_.front();
-        availableBuffers_.pop_front();
-        codingBuffers_.push_back(std::make_pair(codecBuffer, buffer));
+        uint32_t slot = FirstAvailableSlot();
+        CHECK_AND_RETURN_RET_LOG(slot != INVALID_SLOT, nullptr, "no available buffer");
+        HdiBufferWrap *codecBuffer = AcquireCodecBuffer(slot, buffer);
         gst_buffer_ref(buffer);
         codecBuffer->hdiBuffer.size = sizeof(OmxCodecBuffer);
         codecBuffer->hdiBuffer.version = verInfo_.compVersion;
@@ -28,7 +28,7 @@ public:
     int32_t Preprocessing() override;
 
 protected:
-    std::shared_ptr<HdiBufferWrap> GetCodecBuffer(GstBuffer *buffer) override;
+    HdiBufferWrap *GetCodecBuffer(GstBuffer *buffer) override;
 
 private:
     std::vector<std::shared_ptr<HdiBufferWrap>> PreUseHandleMems(std::vector<GstBuffer *> &buffers);
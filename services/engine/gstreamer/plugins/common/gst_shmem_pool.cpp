@@ -255,6 +255,7 @@ static gboolean gst_shmem_pool_start(GstBufferPool *pool)
         .memSize = spool->size + alignedPrefix,
         .maxMemCnt = spool->maxBuffers,
         .notifier = notifier,
+        .enableSizeClass = true,
     };
 
     int32_t ret = spool->avshmempool->Init(option);
@@ -19,19 +19,23 @@
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include "audio_capture.h"
+#include "audio_capture_ring.h"
 #include "audio_capturer.h"
 #include "nocopyable.h"
 
 namespace OHOS {
 namespace Media {
 struct AudioCacheCtrl {
-    std::mutex captureMutex_;
-    std::condition_variable captureCond_;
+    static constexpr uint32_t CAPTURE_RING_SIZE = 128;
+
     std::condition_variable pauseCond_;
-    std::queue<std::shared_ptr<AudioBuffer>> captureQueue_;
+    AudioCaptureRing captureRing_ { CAPTURE_RING_SIZE };
+    // the times that the capture loop waited for the full ring
+    std::atomic<uint32_t> overrunCount_ = 0;
+    // the times that the audio capturer returned less than a period
+    std::atomic<uint32_t> underrunCount_ = 0;
     uint64_t lastTimeStamp_ = 0;
     uint64_t pausedTime_ = 1; // the timestamp when audio pause called
     uint64_t resumeTime_ = 0; // the timestamp when audio resume called
@@ -70,10 +74,15 @@ private:
         RECORDER_STOP,
     };
 
-    static constexpr int MAX_QUEUE_SIZE = 100;
-
     void GetAudioCaptureBuffer();
+    int32_t ReadAudioCaptureBuffer(AudioBuffer &audioBuffer);
+    void DropCaptureBuffers();
+    int32_t CreateBufferPool();
+    void DestroyBufferPool();
     std::unique_ptr<AudioCacheCtrl> audioCacheCtrl_;
+    GstBufferPool *bufferPool_ = nullptr;
+    // reused for every GetBuffer unless the caller still holds it
+    std::shared_ptr<AudioBuffer> outBuffer_ = nullptr;
     std::unique_ptr<std::thread> captureLoop_;
     std::mutex pauseMutex_;
     std::atomic<int32_t> curState_ = RECORDER_INITIALIZED;
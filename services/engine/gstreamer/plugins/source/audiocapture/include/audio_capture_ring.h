@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_CAPTURE_RING_H
+#define AUDIO_CAPTURE_RING_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "common_utils.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * Fixed capacity single-producer single-consumer ring of the captured audio buffers. Pushing and
+ * popping are lock free, the mutex is only taken when one side has to sleep for the other.
+ */
+class AudioCaptureRing : public NoCopyable {
+public:
+    /**
+     * @param capacity the number of slots, must be the power of two.
+     */
+    explicit AudioCaptureRing(uint32_t capacity);
+    ~AudioCaptureRing();
+
+    /**
+     * Producer: wait until there is a free slot.
+     * @param overrun set to true if the ring was full and the producer had to wait.
+     * @return false if the ring is closed.
+     */
+    bool WaitWritable(bool &overrun);
+    void Push(const AudioBuffer &buffer);
+
+    /**
+     * Consumer: wait until there is a buffer.
+     * @return false if the ring is closed.
+     */
+    bool WaitReadable();
+    bool Pop(AudioBuffer &buffer);
+
+    uint32_t Size() const;
+    /**
+     * Wake up and reject both sides, the buffers left in the ring could still be popped.
+     */
+    void Close();
+
+private:
+    void Notify(std::atomic<bool> &waiting);
+
+    std::vector<AudioBuffer> slots_;
+    uint32_t mask_;
+    // written by the consumer only
+    std::atomic<uint32_t> head_ = 0;
+    // written by the producer only
+    std::atomic<uint32_t> tail_ = 0;
+    std::atomic<bool> closed_ = false;
+    std::atomic<bool> producerWaiting_ = false;
+    std::atomic<bool> consumerWaiting_ = false;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AUDIO_CAPTURE_RING_H
@@ -17,6 +17,7 @@
 #include <vector>
 #include <cmath>
 #include "media_log.h"
+#include "media_metrics.h"
 #include "audio_errors.h"
 #include "media_errors.h"
 
@@ -24,6 +25,8 @@ namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AudioCaptureAsImpl"};
     constexpr size_t MAXIMUM_BUFFER_SIZE = 100000;
     constexpr uint64_t SEC_TO_NANOSECOND = 1000000000;
+    // the buffers allocated by the pool in advance, it grows if the downstream holds more buffers.
+    constexpr guint PREALLOC_BUFFER_NUM = 16;
 }
 
 namespace OHOS {
@@ -38,6 +41,7 @@ AudioCaptureAsImpl::~AudioCaptureAsImpl()
         (void)audioCapturer_->Release();
         audioCapturer_ = nullptr;
     }
+    DestroyBufferPool();
 }
 
 int32_t AudioCaptureAsImpl::SetCaptureParameter(uint32_t bitrate, uint32_t channels, uint32_t sampleRate,
@@ -134,6 +138,71 @@ int32_t AudioCaptureAsImpl::GetSegmentInfo(uint64_t &start)
     return MSERR_OK;
 }
 
+int32_t AudioCaptureAsImpl::CreateBufferPool()
+{
+    CHECK_AND_RETURN_RET(bufferSize_ > 0 && bufferSize_ < MAXIMUM_BUFFER_SIZE, MSERR_INVALID_OPERATION);
+    bufferPool_ = gst_buffer_pool_new();
+    CHECK_AND_RETURN_RET_LOG(bufferPool_ != nullptr, MSERR_NO_MEMORY, "create buffer pool failed");
+
+    GstStructure *config = gst_buffer_pool_get_config(bufferPool_);
+    CHECK_AND_RETURN_RET(config != nullptr, MSERR_NO_MEMORY);
+    gst_buffer_pool_config_set_params(config, nullptr, static_cast<guint>(bufferSize_), PREALLOC_BUFFER_NUM, 0);
+    CHECK_AND_RETURN_RET_LOG(gst_buffer_pool_set_config(bufferPool_, config), MSERR_UNKNOWN, "set pool config failed");
+    CHECK_AND_RETURN_RET_LOG(gst_buffer_pool_set_active(bufferPool_, TRUE), MSERR_NO_MEMORY, "active pool failed");
+    return MSERR_OK;
+}
+
+void AudioCaptureAsImpl::DestroyBufferPool()
+{
+    if (bufferPool_ != nullptr) {
+        // the buffers still held by the downstream keep the pool alive until they are released.
+        (void)gst_buffer_pool_set_active(bufferPool_, FALSE);
+        gst_object_unref(bufferPool_);
+        bufferPool_ = nullptr;
+    }
+}
+
+int32_t AudioCaptureAsImpl::ReadAudioCaptureBuffer(AudioBuffer &audioBuffer)
+{
+    CHECK_AND_RETURN_RET(audioCapturer_ != nullptr && bufferPool_ != nullptr, MSERR_INVALID_OPERATION);
+    GstBuffer *buffer = nullptr;
+    GstFlowReturn ret = gst_buffer_pool_acquire_buffer(bufferPool_, &buffer, nullptr);
+    CHECK_AND_RETURN_RET_LOG(ret == GST_FLOW_OK && buffer != nullptr, MSERR_NO_MEMORY, "acquire buffer failed");
+
+    GstMapInfo map = GST_MAP_INFO_INIT;
+    if (gst_buffer_map(buffer, &map, GST_MAP_WRITE) != TRUE) {
+        gst_buffer_unref(buffer);
+        return MSERR_UNKNOWN;
+    }
+    bool isBlocking = true;
+    int32_t bytesRead = audioCapturer_->Read(*(map.data), map.size, isBlocking);
+    gst_buffer_unmap(buffer, &map);
+    if (bytesRead <= 0) {
+        gst_buffer_unref(buffer);
+        return MSERR_UNKNOWN;
+    }
+    uint64_t duration = bufferDurationNs_;
+    if (static_cast<size_t>(bytesRead) < bufferSize_) {
+        audioCacheCtrl_->underrunCount_++;
+        METRICS_COUNTER_ADD("audiocapture.underrun", 1);
+        // the pooled buffer still holds an earlier period behind the read bytes, the pool restores the size
+        gst_buffer_set_size(buffer, bytesRead);
+        duration = bufferDurationNs_ * static_cast<uint64_t>(bytesRead) / bufferSize_;
+    }
+
+    uint64_t curTimeStamp = 0;
+    if (GetSegmentInfo(curTimeStamp) != MSERR_OK) {
+        gst_buffer_unref(buffer);
+        return MSERR_UNKNOWN;
+    }
+
+    audioBuffer.timestamp = curTimeStamp;
+    audioBuffer.duration = duration;
+    audioBuffer.dataLen = static_cast<uint32_t>(bytesRead);
+    audioBuffer.gstBuffer = buffer;
+    return MSERR_OK;
+}
+
 void AudioCaptureAsImpl::GetAudioCaptureBuffer()
 {
     while (true) {
@@ -153,90 +222,63 @@ void AudioCaptureAsImpl::GetAudioCaptureBuffer()
             break;
         }
 
-        if (audioCacheCtrl_->captureQueue_.size() >= MAX_QUEUE_SIZE) {
-            MEDIA_LOGD("audio cache queue size is %{public}zu", audioCacheCtrl_->captureQueue_.size());
-            audioCacheCtrl_->captureCond_.notify_all();
-            continue;
-        }
-
-        CHECK_AND_BREAK(audioCapturer_ != nullptr);
-        std::shared_ptr<AudioBuffer> tempBuffer = std::make_shared<AudioBuffer>();
-        CHECK_AND_BREAK(bufferSize_ > 0 && bufferSize_ < MAXIMUM_BUFFER_SIZE);
-        tempBuffer->gstBuffer = gst_buffer_new_allocate(nullptr, bufferSize_, nullptr);
-        CHECK_AND_BREAK(tempBuffer->gstBuffer != nullptr);
-
-        GstMapInfo map = GST_MAP_INFO_INIT;
-        if (gst_buffer_map(tempBuffer->gstBuffer, &map, GST_MAP_READ) != TRUE) {
-            gst_buffer_unref(tempBuffer->gstBuffer);
+        bool overrun = false;
+        if (!audioCacheCtrl_->captureRing_.WaitWritable(overrun)) {
             break;
         }
-        bool isBlocking = true;
-        int32_t bytesRead = audioCapturer_->Read(*(map.data), map.size, isBlocking);
-        gst_buffer_unmap(tempBuffer->gstBuffer, &map);
-        if (bytesRead <= 0) {
-            gst_buffer_unref(tempBuffer->gstBuffer);
-            break;
-        }
-        uint64_t curTimeStamp = 0;
-        if (GetSegmentInfo(curTimeStamp) != MSERR_OK) {
-            gst_buffer_unref(tempBuffer->gstBuffer);
-            break;
+        if (overrun) {
+            audioCacheCtrl_->overrunCount_++;
+            METRICS_COUNTER_ADD("audiocapture.overrun", 1);
+            MEDIA_LOGD("audio cache ring is full, overrun count %{public}u", audioCacheCtrl_->overrunCount_.load());
         }
 
-        tempBuffer->timestamp = curTimeStamp;
-        tempBuffer->duration = bufferDurationNs_;
-        tempBuffer->dataLen = bufferSize_;
+        AudioBuffer audioBuffer = {};
+        CHECK_AND_BREAK(ReadAudioCaptureBuffer(audioBuffer) == MSERR_OK);
+        audioCacheCtrl_->captureRing_.Push(audioBuffer);
+        MEDIA_LOGD("audio cache ring size is %{public}u", audioCacheCtrl_->captureRing_.Size());
+    }
+}
 
-        {
-            std::unique_lock<std::mutex> loopLock(audioCacheCtrl_->captureMutex_);
-            audioCacheCtrl_->captureQueue_.push(tempBuffer);
-            MEDIA_LOGD("audio cache queue size is %{public}zu", audioCacheCtrl_->captureQueue_.size());
-            audioCacheCtrl_->captureCond_.notify_all();
+void AudioCaptureAsImpl::DropCaptureBuffers()
+{
+    uint32_t dropped = 0;
+    AudioBuffer audioBuffer = {};
+    while (audioCacheCtrl_->captureRing_.Pop(audioBuffer)) {
+        if (audioBuffer.gstBuffer != nullptr) {
+            gst_buffer_unref(audioBuffer.gstBuffer);
         }
+        dropped++;
     }
+    MEDIA_LOGD("%{public}u audio buffer has been dropped", dropped);
 }
 
 std::shared_ptr<AudioBuffer> AudioCaptureAsImpl::GetBuffer()
 {
-    std::unique_lock<std::mutex> loopLock(audioCacheCtrl_->captureMutex_);
-    audioCacheCtrl_->captureCond_.wait(loopLock, [this]() { return audioCacheCtrl_->captureQueue_.size() > 0; });
-
-    if (curState_.load() == RECORDER_STOP) {
+    AudioCaptureRing &captureRing = audioCacheCtrl_->captureRing_;
+    if (!captureRing.WaitReadable() || curState_.load() == RECORDER_STOP) {
         return nullptr;
     }
 
     if (curState_.load() == RECORDER_RESUME && audioCacheCtrl_->pausedTime_ == 1) {
         audioCacheCtrl_->pausedTime_ = audioCacheCtrl_->lastTimeStamp_;
         MEDIA_LOGD("audio pause timestamp %{public}" PRIu64 "", audioCacheCtrl_->pausedTime_);
-        MEDIA_LOGD("%{public}zu audio buffer has been dropped", audioCacheCtrl_->captureQueue_.size());
-        while (!audioCacheCtrl_->captureQueue_.empty()) {
-            auto iter = audioCacheCtrl_->captureQueue_.front();
-            if (iter != nullptr) {
-                gst_buffer_unref(iter->gstBuffer);
-            }
-            audioCacheCtrl_->captureQueue_.pop();
+        DropCaptureBuffers();
+        if (!captureRing.WaitReadable() || curState_.load() == RECORDER_STOP) {
+            return nullptr;
         }
-        audioCacheCtrl_->captureCond_.wait(loopLock, [this]() { return audioCacheCtrl_->captureQueue_.size() > 0; });
     }
 
-    std::shared_ptr<AudioBuffer> bufferOut = audioCacheCtrl_->captureQueue_.front();
-    audioCacheCtrl_->captureQueue_.pop();
+    AudioBuffer audioBuffer = {};
+    CHECK_AND_RETURN_RET(captureRing.Pop(audioBuffer), nullptr);
 
     if (curState_.load() == RECORDER_PAUSED) {
-        audioCacheCtrl_->pausedTime_ = bufferOut->timestamp;
+        audioCacheCtrl_->pausedTime_ = audioBuffer.timestamp;
         MEDIA_LOGD("audio pause timestamp %{public}" PRIu64 "", audioCacheCtrl_->pausedTime_);
-        MEDIA_LOGD("%{public}zu audio buffer has been dropped", audioCacheCtrl_->captureQueue_.size());
-        while (!audioCacheCtrl_->captureQueue_.empty()) {
-            auto iter = audioCacheCtrl_->captureQueue_.front();
-            if (iter != nullptr) {
-                gst_buffer_unref(iter->gstBuffer);
-            }
-            audioCacheCtrl_->captureQueue_.pop();
-        }
+        DropCaptureBuffers();
     }
     if (curState_.load() == RECORDER_RESUME) {
         curState_.store(RECORDER_RUNNING);
-        audioCacheCtrl_->resumeTime_ = bufferOut->timestamp;
+        audioCacheCtrl_->resumeTime_ = audioBuffer.timestamp;
         MEDIA_LOGD("audio resume timestamp %{public}" PRIu64 "", audioCacheCtrl_->resumeTime_);
         audioCacheCtrl_->persistTime_ = std::fabs(audioCacheCtrl_->resumeTime_ - audioCacheCtrl_->pausedTime_);
         audioCacheCtrl_->pausedTime_ = 1; // reset the pause time
@@ -244,9 +286,15 @@ std::shared_ptr<AudioBuffer> AudioCaptureAsImpl::GetBuffer()
         MEDIA_LOGD("audio has %{public}d times pause, total PauseTime: %{public}" PRIu64 "",
             audioCacheCtrl_->pausedCount_, audioCacheCtrl_->totalPauseTime_);
     }
-    audioCacheCtrl_->lastTimeStamp_ = bufferOut->timestamp;
-    bufferOut->timestamp -= audioCacheCtrl_->totalPauseTime_;
-    return bufferOut;
+    audioCacheCtrl_->lastTimeStamp_ = audioBuffer.timestamp;
+    audioBuffer.timestamp -= audioCacheCtrl_->totalPauseTime_;
+
+    if (outBuffer_ == nullptr || outBuffer_.use_count() > 1) {
+        outBuffer_ = std::make_shared<AudioBuffer>();
+        CHECK_AND_RETURN_RET(outBuffer_ != nullptr, nullptr);
+    }
+    *outBuffer_ = audioBuffer;
+    return outBuffer_;
 }
 
 int32_t AudioCaptureAsImpl::StartAudioCapture()
@@ -254,6 +302,13 @@ int32_t AudioCaptureAsImpl::StartAudioCapture()
     MEDIA_LOGD("StartAudioCapture");
 
     CHECK_AND_RETURN_RET(audioCapturer_ != nullptr, MSERR_INVALID_OPERATION);
+    if (bufferPool_ == nullptr) {
+        int32_t ret = CreateBufferPool();
+        if (ret != MSERR_OK) {
+            DestroyBufferPool();
+            return ret;
+        }
+    }
     CHECK_AND_RETURN_RET(audioCapturer_->Start(), MSERR_UNKNOWN);
 
     curState_.store(RECORDER_RUNNING);
@@ -269,11 +324,11 @@ int32_t AudioCaptureAsImpl::StopAudioCapture()
     curState_.store(RECORDER_STOP);
 
     if (captureLoop_ != nullptr && captureLoop_->joinable()) {
-        std::unique_lock<std::mutex> loopLock(audioCacheCtrl_->captureMutex_);
-        audioCacheCtrl_->captureQueue_.push(nullptr); // to wake up the loop thread
-        audioCacheCtrl_->captureCond_.notify_all();
-        audioCacheCtrl_->pauseCond_.notify_all();
-        loopLock.unlock();
+        audioCacheCtrl_->captureRing_.Close(); // to wake up the loop thread
+        {
+            std::unique_lock<std::mutex> lock(pauseMutex_);
+            audioCacheCtrl_->pauseCond_.notify_all();
+        }
         captureLoop_->join();
         captureLoop_.reset();
     }
@@ -286,16 +341,14 @@ int32_t AudioCaptureAsImpl::StopAudioCapture()
         CHECK_AND_RETURN_RET(audioCapturer_->Release(), MSERR_UNKNOWN);
     }
 
-    while (!audioCacheCtrl_->captureQueue_.empty()) {
-        auto iter = audioCacheCtrl_->captureQueue_.front();
-        if (iter != nullptr) {
-            gst_buffer_unref(iter->gstBuffer);
-        }
-        audioCacheCtrl_->captureQueue_.pop();
-    }
+    DropCaptureBuffers();
+    MEDIA_LOGI("audio capture stopped, overrun count: %{public}u, underrun count: %{public}u",
+        audioCacheCtrl_->overrunCount_.load(), audioCacheCtrl_->underrunCount_.load());
+    DestroyBufferPool();
 
     audioCapturer_ = nullptr;
     audioCacheCtrl_ = nullptr;
+    outBuffer_ = nullptr;
     curState_.store(RECORDER_INITIALIZED);
     return MSERR_OK;
 }
@@ -348,12 +401,7 @@ int32_t AudioCaptureAsImpl::WakeUpAudioThreads()
         audioCacheCtrl_->pauseCond_.notify_all();
     }
 
-    {
-        std::unique_lock<std::mutex> loopLock(audioCacheCtrl_->captureMutex_);
-        audioCacheCtrl_->captureQueue_.push(nullptr); // to wake up the loop thread
-        audioCacheCtrl_->captureCond_.notify_all();
-    }
-
+    audioCacheCtrl_->captureRing_.Close(); // to wake up the loop thread
     return MSERR_OK;
 }
 } // namespace Media
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio_capture_ring.h"
+
+namespace OHOS {
+namespace Media {
+AudioCaptureRing::AudioCaptureRing(uint32_t capacity)
+    : slots_(capacity), mask_(capacity - 1)
+{
+}
+
+AudioCaptureRing::~AudioCaptureRing()
+{
+}
+
+bool AudioCaptureRing::WaitWritable(bool &overrun)
+{
+    overrun = false;
+    if (Size() <= mask_) {
+        return !closed_.load();
+    }
+
+    overrun = true;
+    std::unique_lock<std::mutex> lock(mutex_);
+    producerWaiting_.store(true);
+    cond_.wait(lock, [this]() { return Size() <= mask_ || closed_.load(); });
+    producerWaiting_.store(false);
+    return !closed_.load();
+}
+
+void AudioCaptureRing::Push(const AudioBuffer &buffer)
+{
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    slots_[tail & mask_] = buffer;
+    tail_.store(tail + 1);
+    Notify(consumerWaiting_);
+}
+
+bool AudioCaptureRing::WaitReadable()
+{
+    if (Size() > 0) {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    consumerWaiting_.store(true);
+    cond_.wait(lock, [this]() { return Size() > 0 || closed_.load(); });
+    consumerWaiting_.store(false);
+    return !closed_.load();
+}
+
+bool AudioCaptureRing::Pop(AudioBuffer &buffer)
+{
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    if (tail_.load() == head) {
+        return false;
+    }
+    buffer = slots_[head & mask_];
+    head_.store(head + 1);
+    Notify(producerWaiting_);
+    return true;
+}
+
+uint32_t AudioCaptureRing::Size() const
+{
+    return tail_.load() - head_.load();
+}
+
+void AudioCaptureRing::Close()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    closed_.store(true);
+    cond_.notify_all();
+}
+
+void AudioCaptureRing::Notify(std::atomic<bool> &waiting)
+{
+    // the waiter raises the flag before checking the ring under the mutex, so it could not miss this.
+    if (waiting.load()) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.notify_all();
+    }
+}
+} // namespace Media
+} // namespace OHOS
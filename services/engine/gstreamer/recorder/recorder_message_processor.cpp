@@ -127,7 +127,7 @@ gboolean RecorderMsgProcessor::BusCallback(GstBus *bus, GstMessage *msg, gpointe
 }
 
 RecorderMsgProcessor::RecorderMsgProcessor(GstBus &gstBus, const MessageResCb &resCb)
-    : mainLoopGuard_("rec-pipe-guard"), msgResultCb_(resCb)
+    : mainLoopGuard_("rec-pipe-guard", TaskPriority::NORMAL, true), msgResultCb_(resCb)
 {
     gstBus_ = GST_BUS_CAST(gst_object_ref(&gstBus));
 }
@@ -21,6 +21,7 @@
 #include "i_recorder_engine.h"
 #include "recorder_private_param.h"
 #include "scope_guard.h"
+#include "task_executor.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "RecorderPipeline"};
@@ -200,6 +201,8 @@ int32_t RecorderPipeline::SyncWaitChangeState(GstState targetState)
     }
 
     MEDIA_LOGI("begin sync wait gstpipeline state change to %{public}d..........", targetState);
+    // runs on the strand of the pipeline ctrler, do not hold its pool worker while waiting
+    TaskExecutor::BlockingScope blocking;
     std::unique_lock<std::mutex> lock(gstPipeMutex_);
     gstPipeCond_.wait(lock, [this, targetState] { return currState_ == targetState || errorState_.load(); });
     if (errorState_.load()) {
@@ -268,6 +271,7 @@ int32_t RecorderPipeline::PostAndSyncWaitEOS()
 bool RecorderPipeline::SyncWaitEOS()
 {
     MEDIA_LOGI("Wait EOS finished........................");
+    TaskExecutor::BlockingScope blocking;
     std::unique_lock<std::mutex> lock(gstPipeMutex_);
     if (errorState_.load()) {
         static constexpr int32_t timeout = 1; // wait 1s for eos finished
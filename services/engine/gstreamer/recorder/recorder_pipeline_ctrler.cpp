@@ -67,7 +67,7 @@ void RecorderPipelineCtrler::SetPipeline(std::shared_ptr<RecorderPipeline> pipel
 
 int32_t RecorderPipelineCtrler::Init()
 {
-    cmdQ_ = std::make_unique<TaskQueue>("rec-pipe-ctrler-cmd");
+    cmdQ_ = std::make_unique<TaskQueue>("rec-pipe-ctrler-cmd", TaskPriority::HIGH);
     int32_t ret = cmdQ_->Start();
     CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
 
@@ -21,6 +21,8 @@
 
 namespace OHOS {
 namespace Media {
+class AVCodecCapabilityIndex;
+
 class IAVCodecListService {
 public:
     // AVCodecList
@@ -30,6 +32,11 @@ public:
     virtual std::string FindAudioDecoder(const Format &format) = 0;
     virtual std::string FindAudioEncoder(const Format &format) = 0;
     virtual std::vector<CapabilityData> GetCodecCapabilityInfos() = 0;
+    /**
+     * Get the immutable index of all capabilities, which answers the queries in the local process.
+     * @return nullptr if the index is unavailable, the caller should fall back to the queries above.
+     */
+    virtual std::shared_ptr<const AVCodecCapabilityIndex> GetCapabilityIndex() = 0;
 };
 } // namespace Media
 } // namespace OHOS
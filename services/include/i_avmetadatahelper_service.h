@@ -55,6 +55,22 @@ struct OutputConfiguration {
     PixelFormat colorFormat = PixelFormat::RGB_565;
 };
 
+struct AVMetadataBatchConfig {
+    std::vector<int32_t> keys;
+    bool fetchThumbnail = false;
+    int64_t thumbnailTimeUs = 0;
+    int32_t thumbnailOption = AV_META_QUERY_NEXT_SYNC;
+    OutputConfiguration thumbnailConfig;
+};
+
+class AVMetadataBatchServiceCallback {
+public:
+    virtual ~AVMetadataBatchServiceCallback() = default;
+    virtual void OnBatchResult(int32_t index, int32_t errCode, const std::unordered_map<int32_t, std::string> &metadata,
+        const std::shared_ptr<AVSharedMemory> &thumbnail) = 0;
+    virtual void OnBatchFinished(int32_t errCode) = 0;
+};
+
 class IAVMetadataHelperService {
 public:
     virtual ~IAVMetadataHelperService() = default;
@@ -126,6 +142,44 @@ public:
     virtual std::shared_ptr<AVSharedMemory> FetchFrameAtTime(
         int64_t timeUs, int32_t option, const OutputConfiguration &param) = 0;
 
+    /**
+     * Prepare to fetch the video frames at a batch of timestamps. The frames are fetched one by
+     * one in ascending order of the time by {@link FetchNextFrame} after this method called.
+     * @param timesUs the time positions in microseconds, at most {@link MAX_FETCH_FRAMES_NUM}.
+     * @param option the hint about how to fetch the frames, see {@link AVMetadataQueryOption}
+     * @param param the desired configuration of returned video frames, see {@link OutputConfiguration}.
+     * @return Returns {@link MSERR_OK} if the batch is accepted; returns an error code otherwise.
+     */
+    virtual int32_t PrepareFetchFrames(
+        const std::vector<int64_t> &timesUs, int32_t option, const OutputConfiguration &param) = 0;
+
+    /**
+     * Fetch the next video frame of the batch prepared by {@link PrepareFetchFrames}.
+     * @param timeUs output, the requested time position which the returned frame is fetched for.
+     * @return Returns a chunk of shared memory containing a scaled video frame, which can be
+     * null if such a frame cannot be fetched, or there is no frame left, in which case the timeUs
+     * is set to -1.
+     */
+    virtual std::shared_ptr<AVSharedMemory> FetchNextFrame(int64_t &timeUs) = 0;
+
+    /**
+     * Resolve the metadata of a batch of sources in parallel, the results are delivered through the
+     * callback as soon as each source completes. It does not depend on the {@link SetSource}.
+     * @param sources the sources to resolve, at most {@link MAX_BATCH_SOURCES_NUM}. The fds are
+     * duplicated, the caller keeps the ownership of them.
+     * @param config what to resolve for every source, see {@link AVMetadataBatchConfig}.
+     * @param callback the callback to receive the results.
+     * @return Returns {@link MSERR_OK} if the batch is accepted; returns an error code otherwise.
+     */
+    virtual int32_t ResolveMetadataBatch(const std::vector<AVMetadataBatchSource> &sources,
+        const AVMetadataBatchConfig &config, const std::shared_ptr<AVMetadataBatchServiceCallback> &callback) = 0;
+
+    /**
+     * Cancel the batch in progress, no result is delivered after this method returns.
+     * @return Returns {@link MSERR_OK} if cancelled or there is no batch in progress.
+     */
+    virtual int32_t CancelBatch() = 0;
+
     /**
      * Release the internel resource. After this method called, the service instance
      * can not be used again.
@@ -24,6 +24,7 @@
 #include "i_avcodeclist_service.h"
 #include "i_recorder_profiles_service.h"
 #include "i_avmuxer_service.h"
+#include "i_avspliter_service.h"
 
 namespace OHOS {
 namespace Media {
@@ -108,6 +109,17 @@ public:
      */
     virtual std::shared_ptr<IAVMuxerService> CreateAVMuxerService() = 0;
 
+    /**
+     * @brief Create an avspliter service.
+     *
+     * All avspliter functions must be created and obtained first.
+     *
+     * @return Returns a valid pointer if the setting is successful;
+     * @since 3.2
+     * @version 3.2
+     */
+    virtual std::shared_ptr<IAVSpliterService> CreateAVSpliterService() = 0;
+
     /**
      * @brief Destroy a recorder service.
      *
@@ -191,6 +203,18 @@ public:
      * @version 3.2
      */
     virtual int32_t DestroyAVMuxerService(std::shared_ptr<IAVMuxerService> avmuxer) = 0;
+
+    /**
+     * @brief Destroy a avspliter service.
+     *
+     * call the API to destroy the avspliter service.
+     *
+     * @param pointer to the avspliter service.
+     * @return Returns a valid pointer if the setting is successful;
+     * @since 3.2
+     * @version 3.2
+     */
+    virtual int32_t DestroyAVSpliterService(std::shared_ptr<IAVSpliterService> avspliter) = 0;
 };
 
 class __attribute__((visibility("default"))) MediaServiceFactory {
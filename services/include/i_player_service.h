@@ -21,6 +21,8 @@
 
 namespace OHOS {
 namespace Media {
+class AVSharedMemory;
+
 class IPlayerService {
 public:
     virtual ~IPlayerService() = default;
@@ -323,6 +325,19 @@ public:
      * @version 1.0
      */
     virtual int32_t SetPlayerCallback(const std::shared_ptr<PlayerCallback> &callback) = 0;
+
+    /**
+     * @brief Method to get the shared page where the playback position is published, so that the client
+     * could get the current time without the IPC.
+     *
+     * @return Returns the read-only memory of the page, or nullptr if it is not supported.
+     * @since 1.0
+     * @version 1.0
+     */
+    virtual std::shared_ptr<AVSharedMemory> GetPositionPage()
+    {
+        return nullptr;
+    }
 };
 } // namespace Media
 } // namespace OHOS
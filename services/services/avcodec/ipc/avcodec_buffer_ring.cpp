@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avcodec_buffer_ring.h"
+#include <new>
+#include "avsharedmemory_ipc.h"
+#include "avsharedmemorybase.h"
+#include "media_errors.h"
+#include "media_log.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVCodecBufferRing"};
+}
+
+namespace OHOS {
+namespace Media {
+struct AVCodecBufferRing::RingHeader {
+    // written by the consumer only
+    std::atomic<uint32_t> head = 0;
+    // written by the producer only
+    std::atomic<uint32_t> tail = 0;
+    // set by the consumer when it waits for the doorbell, cleared by whom rings or cancels it.
+    std::atomic<uint32_t> armed = 1;
+    uint32_t reserved = 0;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "ring header is shared between processes");
+
+std::shared_ptr<AVCodecBufferRing> AVCodecBufferRing::Create(uint32_t capacity, const std::string &name)
+{
+    CHECK_AND_RETURN_RET_LOG(capacity != 0 && (capacity & (capacity - 1)) == 0, nullptr,
+        "invalid ring capacity: %{public}u", capacity);
+
+    int32_t size = static_cast<int32_t>(sizeof(RingHeader) + sizeof(AVCodecBufferDesc) * capacity);
+    auto memory = AVSharedMemoryBase::CreateFromLocal(size, AVSharedMemory::FLAGS_READ_WRITE, name);
+    CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "failed to create ring memory");
+
+    auto ring = std::make_shared<AVCodecBufferRing>(memory);
+    CHECK_AND_RETURN_RET_LOG(ring != nullptr, nullptr, "failed to new AVCodecBufferRing");
+    CHECK_AND_RETURN_RET(ring->Init() == MSERR_OK, nullptr);
+
+    // the memory is only visible to this process now, construct the header in place.
+    ring->header_ = new (ring->memory_->GetBase()) RingHeader();
+    return ring;
+}
+
+std::shared_ptr<AVCodecBufferRing> AVCodecBufferRing::CreateFromParcel(MessageParcel &parcel)
+{
+    auto memory = ReadAVSharedMemoryFromParcel(parcel);
+    CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "failed to read ring memory");
+
+    auto ring = std::make_shared<AVCodecBufferRing>(memory);
+    CHECK_AND_RETURN_RET_LOG(ring != nullptr, nullptr, "failed to new AVCodecBufferRing");
+    CHECK_AND_RETURN_RET(ring->Init() == MSERR_OK, nullptr);
+    return ring;
+}
+
+AVCodecBufferRing::AVCodecBufferRing(const std::shared_ptr<AVSharedMemory> &memory)
+    : memory_(memory)
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVCodecBufferRing::~AVCodecBufferRing()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+int32_t AVCodecBufferRing::Init()
+{
+    CHECK_AND_RETURN_RET(memory_ != nullptr && memory_->GetBase() != nullptr, MSERR_INVALID_VAL);
+    int32_t size = memory_->GetSize();
+    CHECK_AND_RETURN_RET_LOG(size > static_cast<int32_t>(sizeof(RingHeader)), MSERR_INVALID_VAL,
+        "ring memory is too small: %{public}d", size);
+
+    uint32_t slots = (static_cast<uint32_t>(size) - sizeof(RingHeader)) / sizeof(AVCodecBufferDesc);
+    CHECK_AND_RETURN_RET_LOG(slots != 0, MSERR_INVALID_VAL, "ring memory is too small: %{public}d", size);
+    capacity_ = 1;
+    while ((capacity_ << 1) != 0 && (capacity_ << 1) <= slots) {
+        capacity_ <<= 1;
+    }
+
+    header_ = reinterpret_cast<RingHeader *>(memory_->GetBase());
+    descs_ = reinterpret_cast<AVCodecBufferDesc *>(memory_->GetBase() + sizeof(RingHeader));
+    return MSERR_OK;
+}
+
+int32_t AVCodecBufferRing::WriteToParcel(MessageParcel &parcel) const
+{
+    return WriteAVSharedMemoryToParcel(memory_, parcel);
+}
+
+bool AVCodecBufferRing::Push(const AVCodecBufferDesc &desc, uint32_t reservedSlots)
+{
+    uint32_t tail = header_->tail.load(std::memory_order_relaxed);
+    uint32_t head = header_->head.load(std::memory_order_acquire);
+    uint32_t used = tail - head;
+    if (used > capacity_ || capacity_ - used <= reservedSlots) {
+        return false;
+    }
+
+    descs_[tail & (capacity_ - 1)] = desc;
+    header_->tail.store(tail + 1, std::memory_order_seq_cst);
+    return true;
+}
+
+bool AVCodecBufferRing::TakeDoorbell()
+{
+    return header_->armed.exchange(0, std::memory_order_seq_cst) != 0;
+}
+
+bool AVCodecBufferRing::Front(AVCodecBufferDesc &desc)
+{
+    uint32_t head = header_->head.load(std::memory_order_relaxed);
+    uint32_t tail = header_->tail.load(std::memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+    if (tail - head > capacity_) {
+        MEDIA_LOGE("ring corrupted, head: %{public}u, tail: %{public}u", head, tail);
+        header_->head.store(tail, std::memory_order_release);
+        return false;
+    }
+
+    desc = descs_[head & (capacity_ - 1)];
+    return true;
+}
+
+void AVCodecBufferRing::Pop()
+{
+    uint32_t head = header_->head.load(std::memory_order_relaxed);
+    header_->head.store(head + 1, std::memory_order_release);
+}
+
+bool AVCodecBufferRing::Arm()
+{
+    header_->armed.store(1, std::memory_order_seq_cst);
+    uint32_t head = header_->head.load(std::memory_order_relaxed);
+    return header_->tail.load(std::memory_order_seq_cst) == head;
+}
+
+void AVCodecBufferRing::Disarm()
+{
+    header_->armed.store(0, std::memory_order_relaxed);
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVCODEC_BUFFER_RING_H
+#define AVCODEC_BUFFER_RING_H
+
+#include <atomic>
+#include <memory>
+#include "avcodec_common.h"
+#include "avsharedmemory.h"
+#include "message_parcel.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+struct AVCodecBufferDesc {
+    enum Kind : uint32_t {
+        INPUT_BUFFER = 0,
+        OUTPUT_BUFFER,
+        // orders the following descriptors behind an out-of-band message, the index is the barrier's sequence.
+        BARRIER,
+    };
+
+    uint32_t kind = INPUT_BUFFER;
+    uint32_t index = 0;
+    int64_t presentationTimeUs = 0;
+    int32_t size = 0;
+    int32_t offset = 0;
+    // AVCodecBufferFlag for the buffer descriptors, the render flag for the released output buffers.
+    uint32_t flag = 0;
+    uint32_t reserved = 0;
+};
+
+/**
+ * Single-producer single-consumer ring of AVCodecBufferDesc living in a shared memory, which is used
+ * to batch the buffer exchange of the avcodec between the client and the server. The producer only
+ * needs to ring the doorbell (an IPC transaction) when the consumer has armed it after draining the
+ * ring to empty, so that a burst of N buffers costs one transaction instead of N.
+ */
+class AVCodecBufferRing : public NoCopyable {
+public:
+    /**
+     * Create the ring in the local process, the capacity must be the power of two.
+     */
+    static std::shared_ptr<AVCodecBufferRing> Create(uint32_t capacity, const std::string &name);
+    /**
+     * Map the ring created by the peer process from the memory written by {@link WriteToParcel}.
+     */
+    static std::shared_ptr<AVCodecBufferRing> CreateFromParcel(MessageParcel &parcel);
+
+    explicit AVCodecBufferRing(const std::shared_ptr<AVSharedMemory> &memory);
+    ~AVCodecBufferRing();
+
+    int32_t WriteToParcel(MessageParcel &parcel) const;
+
+    /**
+     * Producer: publish the descriptor if there are more than the reservedSlots free slots.
+     * @return false if the ring is full.
+     */
+    bool Push(const AVCodecBufferDesc &desc, uint32_t reservedSlots = 0);
+
+    /**
+     * Producer: check whether the consumer is waiting for the doorbell after published descriptors,
+     * the doorbell is disarmed once this returns true.
+     */
+    bool TakeDoorbell();
+
+    /**
+     * Consumer: read the oldest descriptor without consuming it. A corrupted ring is dropped.
+     * @return false if the ring is empty or corrupted.
+     */
+    bool Front(AVCodecBufferDesc &desc);
+    void Pop();
+
+    /**
+     * Consumer: ask the producer to ring the doorbell for the next descriptor.
+     * @return true if the ring is still empty after armed, otherwise the caller should continue draining.
+     */
+    bool Arm();
+    void Disarm();
+
+private:
+    int32_t Init();
+
+    struct RingHeader;
+    std::shared_ptr<AVSharedMemory> memory_;
+    RingHeader *header_ = nullptr;
+    AVCodecBufferDesc *descs_ = nullptr;
+    // calculated from the memory size locally, never trust the value written by the peer.
+    uint32_t capacity_ = 0;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVCODEC_BUFFER_RING_H
@@ -20,6 +20,8 @@
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVCodecListenerProxy"};
+    // keep some slots for the barriers once the ring is nearly full, so that the fallback stays in order.
+    constexpr uint32_t RING_RESERVED_SLOTS = 8;
 }
 
 namespace OHOS {
@@ -46,6 +48,7 @@ void AVCodecListenerProxy::OnError(AVCodecErrorType errorType, int32_t errorCode
     }
     data.WriteInt32(static_cast<int32_t>(errorType));
     data.WriteInt32(errorCode);
+    data.WriteUint32(PushBarrier());
     int error = Remote()->SendRequest(AVCodecListenerMsg::ON_ERROR, data, reply, option);
     if (error != MSERR_OK) {
         MEDIA_LOGE("OnError failed, error: %{public}d", error);
@@ -62,6 +65,7 @@ void AVCodecListenerProxy::OnOutputFormatChanged(const Format &format)
         return;
     }
     (void)MediaParcel::Marshalling(data, format);
+    data.WriteUint32(PushBarrier());
     int error = Remote()->SendRequest(AVCodecListenerMsg::ON_OUTPUT_FORMAT_CHANGED, data, reply, option);
     if (error != MSERR_OK) {
         MEDIA_LOGE("OnOutputFormatChanged failed, error: %{public}d", error);
@@ -70,6 +74,13 @@ void AVCodecListenerProxy::OnOutputFormatChanged(const Format &format)
 
 void AVCodecListenerProxy::OnInputBufferAvailable(uint32_t index)
 {
+    AVCodecBufferDesc desc;
+    desc.kind = AVCodecBufferDesc::INPUT_BUFFER;
+    desc.index = index;
+    if (PushToRing(desc)) {
+        return;
+    }
+
     MessageParcel data;
     MessageParcel reply;
     MessageOption option(MessageOption::TF_ASYNC);
@@ -78,6 +89,7 @@ void AVCodecListenerProxy::OnInputBufferAvailable(uint32_t index)
         return;
     }
     data.WriteUint32(index);
+    data.WriteUint32(PushBarrier());
     int error = Remote()->SendRequest(AVCodecListenerMsg::ON_INPUT_BUFFER_AVAILABLE, data, reply, option);
     if (error != MSERR_OK) {
         MEDIA_LOGE("OnInputBufferAvailable failed, error: %{public}d", error);
@@ -86,6 +98,17 @@ void AVCodecListenerProxy::OnInputBufferAvailable(uint32_t index)
 
 void AVCodecListenerProxy::OnOutputBufferAvailable(uint32_t index, AVCodecBufferInfo info, AVCodecBufferFlag flag)
 {
+    AVCodecBufferDesc desc;
+    desc.kind = AVCodecBufferDesc::OUTPUT_BUFFER;
+    desc.index = index;
+    desc.presentationTimeUs = info.presentationTimeUs;
+    desc.size = info.size;
+    desc.offset = info.offset;
+    desc.flag = static_cast<uint32_t>(flag);
+    if (PushToRing(desc)) {
+        return;
+    }
+
     MessageParcel data;
     MessageParcel reply;
     MessageOption option(MessageOption::TF_ASYNC);
@@ -98,12 +121,72 @@ void AVCodecListenerProxy::OnOutputBufferAvailable(uint32_t index, AVCodecBuffer
     data.WriteInt32(info.size);
     data.WriteInt32(info.offset);
     data.WriteInt32(static_cast<int32_t>(flag));
+    data.WriteUint32(PushBarrier());
     int error = Remote()->SendRequest(AVCodecListenerMsg::ON_OUTPUT_BUFFER_AVAILABLE, data, reply, option);
     if (error != MSERR_OK) {
         MEDIA_LOGE("OnOutputBufferAvailable failed, error: %{public}d", error);
     }
 }
 
+void AVCodecListenerProxy::SetBufferRing(const std::shared_ptr<AVCodecBufferRing> &ring)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    bufferRing_ = ring;
+}
+
+bool AVCodecListenerProxy::PushToRing(const AVCodecBufferDesc &desc)
+{
+    bool doorbell = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (bufferRing_ == nullptr || !bufferRing_->Push(desc, RING_RESERVED_SLOTS)) {
+            return false;
+        }
+        doorbell = bufferRing_->TakeDoorbell();
+    }
+
+    if (doorbell) {
+        RingDoorbell();
+    }
+    return true;
+}
+
+uint32_t AVCodecListenerProxy::PushBarrier()
+{
+    // the messages sent directly must not overtake the descriptors queued before them, the stub
+    // stops draining at the barrier until the message carrying the same sequence is handled.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (bufferRing_ == nullptr) {
+        return 0;
+    }
+
+    uint32_t seq = (barrierSeq_ + 1 == 0) ? 1 : (barrierSeq_ + 1);
+    AVCodecBufferDesc desc;
+    desc.kind = AVCodecBufferDesc::BARRIER;
+    desc.index = seq;
+    if (!bufferRing_->Push(desc)) {
+        MEDIA_LOGW("buffer ring is full, the message may overtake the queued buffers");
+        return 0;
+    }
+    barrierSeq_ = seq;
+    return seq;
+}
+
+void AVCodecListenerProxy::RingDoorbell()
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option(MessageOption::TF_ASYNC);
+    if (!data.WriteInterfaceToken(AVCodecListenerProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return;
+    }
+    int error = Remote()->SendRequest(AVCodecListenerMsg::BUFFER_RING_DOORBELL, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("RingDoorbell failed, error: %{public}d", error);
+    }
+}
+
 AVCodecListenerCallback::AVCodecListenerCallback(const sptr<IStandardAVCodecListener> &listener)
     : listener_(listener)
 {
@@ -16,6 +16,7 @@
 #ifndef AVCODEC_LISTENER_PROXY_H
 #define AVCODEC_LISTENER_PROXY_H
 
+#include <mutex>
 #include "i_standard_avcodec_listener.h"
 #include "media_death_recipient.h"
 #include "nocopyable.h"
@@ -45,9 +46,17 @@ public:
     void OnOutputFormatChanged(const Format &format) override;
     void OnInputBufferAvailable(uint32_t index) override;
     void OnOutputBufferAvailable(uint32_t index, AVCodecBufferInfo info, AVCodecBufferFlag flag) override;
+    void SetBufferRing(const std::shared_ptr<AVCodecBufferRing> &ring) override;
 
 private:
+    bool PushToRing(const AVCodecBufferDesc &desc);
+    uint32_t PushBarrier();
+    void RingDoorbell();
+
     static inline BrokerDelegator<AVCodecListenerProxy> delegator_;
+    std::mutex mutex_;
+    std::shared_ptr<AVCodecBufferRing> bufferRing_ = nullptr;
+    uint32_t barrierSeq_ = 0;
 };
 } // namespace Media
 } // namespace OHOS
@@ -16,6 +16,7 @@
 #include "avcodec_listener_stub.h"
 #include "media_errors.h"
 #include "media_log.h"
+#include "media_metrics.h"
 #include "media_parcel.h"
 
 namespace {
@@ -42,23 +43,34 @@ int AVCodecListenerStub::OnRemoteRequest(uint32_t code, MessageParcel &data, Mes
         MEDIA_LOGE("Invalid descriptor");
         return MSERR_INVALID_OPERATION;
     }
+    // every binder transaction from the service
+    METRICS_COUNTER_ADD("avcodec.ipc.notify", 1);
 
     switch (code) {
         case AVCodecListenerMsg::ON_ERROR: {
             int32_t errorType = data.ReadInt32();
             int32_t errorCode = data.ReadInt32();
+            uint32_t barrier = data.ReadUint32();
+            ReachBarrier(barrier);
             OnError(static_cast<AVCodecErrorType>(errorType), errorCode);
+            ReleaseBarrier(barrier);
             return MSERR_OK;
         }
         case AVCodecListenerMsg::ON_OUTPUT_FORMAT_CHANGED: {
             Format format;
             (void)MediaParcel::Unmarshalling(data, format);
+            uint32_t barrier = data.ReadUint32();
+            ReachBarrier(barrier);
             OnOutputFormatChanged(format);
+            ReleaseBarrier(barrier);
             return MSERR_OK;
         }
         case AVCodecListenerMsg::ON_INPUT_BUFFER_AVAILABLE: {
             uint32_t index = data.ReadUint32();
+            uint32_t barrier = data.ReadUint32();
+            ReachBarrier(barrier);
             OnInputBufferAvailable(index);
+            ReleaseBarrier(barrier);
             return MSERR_OK;
         }
         case AVCodecListenerMsg::ON_OUTPUT_BUFFER_AVAILABLE: {
@@ -68,7 +80,14 @@ int AVCodecListenerStub::OnRemoteRequest(uint32_t code, MessageParcel &data, Mes
             info.size = data.ReadInt32();
             info.offset = data.ReadInt32();
             AVCodecBufferFlag flag = static_cast<AVCodecBufferFlag>(data.ReadInt32());
+            uint32_t barrier = data.ReadUint32();
+            ReachBarrier(barrier);
             OnOutputBufferAvailable(index, info, flag);
+            ReleaseBarrier(barrier);
+            return MSERR_OK;
+        }
+        case AVCodecListenerMsg::BUFFER_RING_DOORBELL: {
+            DrainBufferRing(false);
             return MSERR_OK;
         }
         default: {
@@ -106,6 +125,72 @@ void AVCodecListenerStub::OnOutputBufferAvailable(uint32_t index, AVCodecBufferI
     }
 }
 
+void AVCodecListenerStub::SetBufferRing(const std::shared_ptr<AVCodecBufferRing> &ring)
+{
+    // deliver whatever left in the previous ring before switching
+    DrainBufferRing(true);
+    {
+        std::lock_guard<std::recursive_mutex> lock(ringMutex_);
+        bufferRing_ = ring;
+    }
+    DrainBufferRing(false);
+}
+
+void AVCodecListenerStub::ReachBarrier(uint32_t barrier)
+{
+    if (barrier == 0) {
+        return;
+    }
+    // deliver the buffers queued before the message, the draining stops at its barrier
+    DrainBufferRing(false);
+}
+
+void AVCodecListenerStub::ReleaseBarrier(uint32_t barrier)
+{
+    if (barrier == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::recursive_mutex> lock(ringMutex_);
+        releasedBarrier_ = barrier;
+    }
+    DrainBufferRing(false);
+}
+
+void AVCodecListenerStub::DrainBufferRing(bool ignoreBarrier)
+{
+    std::lock_guard<std::recursive_mutex> lock(ringMutex_);
+    std::shared_ptr<AVCodecBufferRing> ring = bufferRing_;
+    CHECK_AND_RETURN(ring != nullptr);
+
+    AVCodecBufferDesc desc;
+    while (true) {
+        while (ring->Front(desc)) {
+            if (desc.kind == AVCodecBufferDesc::BARRIER && !ignoreBarrier &&
+                static_cast<int32_t>(desc.index - releasedBarrier_) > 0) {
+                // the message of this barrier is not handled yet, it will continue draining.
+                ring->Disarm();
+                return;
+            }
+            ring->Pop();
+
+            if (desc.kind == AVCodecBufferDesc::INPUT_BUFFER) {
+                OnInputBufferAvailable(desc.index);
+            } else if (desc.kind == AVCodecBufferDesc::OUTPUT_BUFFER) {
+                AVCodecBufferInfo info;
+                info.presentationTimeUs = desc.presentationTimeUs;
+                info.size = desc.size;
+                info.offset = desc.offset;
+                OnOutputBufferAvailable(desc.index, info, static_cast<AVCodecBufferFlag>(desc.flag));
+            }
+        }
+        if (ring->Arm()) {
+            return;
+        }
+        ring->Disarm();
+    }
+}
+
 void AVCodecListenerStub::SetCallback(const std::shared_ptr<AVCodecCallback> &callback)
 {
     callback_ = callback;
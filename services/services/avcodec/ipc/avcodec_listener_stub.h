@@ -16,6 +16,7 @@
 #ifndef AVCODEC_LISTENER_STUB_H
 #define AVCODEC_LISTENER_STUB_H
 
+#include <mutex>
 #include "i_standard_avcodec_listener.h"
 #include "avcodec_common.h"
 
@@ -30,10 +31,19 @@ public:
     void OnOutputFormatChanged(const Format &format) override;
     void OnInputBufferAvailable(uint32_t index) override;
     void OnOutputBufferAvailable(uint32_t index, AVCodecBufferInfo info, AVCodecBufferFlag flag) override;
+    void SetBufferRing(const std::shared_ptr<AVCodecBufferRing> &ring) override;
     void SetCallback(const std::shared_ptr<AVCodecCallback> &callback);
 
 private:
+    void ReachBarrier(uint32_t barrier);
+    void ReleaseBarrier(uint32_t barrier);
+    void DrainBufferRing(bool ignoreBarrier);
+
     std::shared_ptr<AVCodecCallback> callback_ = nullptr;
+    // recursive, the callback may reset the codec and detach the ring while draining.
+    std::recursive_mutex ringMutex_;
+    std::shared_ptr<AVCodecBufferRing> bufferRing_ = nullptr;
+    uint32_t releasedBarrier_ = 0;
 };
 } // namespace Media
 } // namespace OHOS
@@ -16,12 +16,15 @@
 #include "avcodec_service_proxy.h"
 #include "avcodec_listener_stub.h"
 #include "avsharedmemory_ipc.h"
+#include "media_description.h"
 #include "media_errors.h"
 #include "media_log.h"
+#include "media_metrics.h"
 #include "media_parcel.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVCodecServiceProxy"};
+    constexpr uint32_t BUFFER_RING_CAPACITY = 256;
 }
 
 namespace OHOS {
@@ -100,7 +103,9 @@ int32_t AVCodecServiceProxy::SetListenerObject(const sptr<IRemoteObject> &object
     }
 
     (void)data.WriteRemoteObject(object);
-    int32_t ret = Remote()->SendRequest(SET_LISTENER_OBJ, data, reply, option);
+    // the object is the local stub, iface_cast gives the stub itself.
+    listener_ = iface_cast<IStandardAVCodecListener>(object);
+    int32_t ret = SendCountedRequest(SET_LISTENER_OBJ, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("Set listener obj failed, error: %{public}d", ret);
         return ret;
@@ -122,7 +127,7 @@ int32_t AVCodecServiceProxy::InitParameter(AVCodecType type, bool isMimeType, co
     data.WriteInt32(static_cast<int32_t>(type));
     data.WriteBool(isMimeType);
     data.WriteString(name);
-    int32_t ret = Remote()->SendRequest(INIT_PARAMETER, data, reply, option);
+    int32_t ret = SendCountedRequest(INIT_PARAMETER, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("Init parameter failed, error: %{public}d", ret);
         return ret;
@@ -132,6 +137,9 @@ int32_t AVCodecServiceProxy::InitParameter(AVCodecType type, bool isMimeType, co
 
 int32_t AVCodecServiceProxy::Configure(const Format &format)
 {
+    int32_t batched = 0;
+    batchedBuffer_ = format.GetIntValue(MediaDescriptionKey::MD_KEY_IPC_BATCHED_BUFFER, batched) && batched != 0;
+
     MessageParcel data;
     MessageParcel reply;
     MessageOption option;
@@ -142,7 +150,7 @@ int32_t AVCodecServiceProxy::Configure(const Format &format)
     }
 
     (void)MediaParcel::Marshalling(data, format);
-    int32_t ret = Remote()->SendRequest(CONFIGURE, data, reply, option);
+    int32_t ret = SendCountedRequest(CONFIGURE, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("Set listener obj failed, error: %{public}d", ret);
         return ret;
@@ -169,12 +177,90 @@ int32_t AVCodecServiceProxy::Prepare()
         return MSERR_UNKNOWN;
     }
 
-    int32_t ret = Remote()->SendRequest(PREPARE, data, reply, option);
+    int32_t ret = SendCountedRequest(PREPARE, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("Prepare failed, error: %{public}d", ret);
         return ret;
     }
-    return reply.ReadInt32();
+
+    ret = reply.ReadInt32();
+    if (ret == MSERR_OK && batchedBuffer_ && bufferRing_ == nullptr) {
+        // the batched buffer exchange is optional, keep the per-buffer transactions if it failed.
+        (void)SetupBufferRing();
+    }
+    return ret;
+}
+
+int32_t AVCodecServiceProxy::SetupBufferRing()
+{
+    CHECK_AND_RETURN_RET_LOG(listener_ != nullptr, MSERR_INVALID_OPERATION, "listener is nullptr");
+
+    auto requestRing = AVCodecBufferRing::Create(BUFFER_RING_CAPACITY, "AVCodecRequestRing");
+    CHECK_AND_RETURN_RET_LOG(requestRing != nullptr, MSERR_NO_MEMORY, "failed to create request ring");
+    auto notifyRing = AVCodecBufferRing::Create(BUFFER_RING_CAPACITY, "AVCodecNotifyRing");
+    CHECK_AND_RETURN_RET_LOG(notifyRing != nullptr, MSERR_NO_MEMORY, "failed to create notify ring");
+
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVCodecServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    CHECK_AND_RETURN_RET(requestRing->WriteToParcel(data) == MSERR_OK, MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(notifyRing->WriteToParcel(data) == MSERR_OK, MSERR_UNKNOWN);
+
+    // attach the notify ring before the server starts producing into it
+    listener_->SetBufferRing(notifyRing);
+    int32_t ret = SendCountedRequest(SET_BUFFER_RING, data, reply, option);
+    if (ret == MSERR_OK) {
+        ret = reply.ReadInt32();
+    }
+    if (ret != MSERR_OK) {
+        MEDIA_LOGE("Set buffer ring failed, error: %{public}d", ret);
+        listener_->SetBufferRing(nullptr);
+        return ret;
+    }
+
+    bufferRing_ = requestRing;
+    MEDIA_LOGI("batched buffer exchange enabled");
+    return MSERR_OK;
+}
+
+void AVCodecServiceProxy::DetachBufferRing()
+{
+    // only called after the server has stopped producing into the notify ring
+    if (listener_ != nullptr) {
+        listener_->SetBufferRing(nullptr);
+    }
+}
+
+bool AVCodecServiceProxy::PushToRing(const AVCodecBufferDesc &desc)
+{
+    if (bufferRing_ == nullptr || !bufferRing_->Push(desc)) {
+        return false;
+    }
+    if (!bufferRing_->TakeDoorbell()) {
+        return true;
+    }
+
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option(MessageOption::TF_ASYNC);
+
+    if (!data.WriteInterfaceToken(AVCodecServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return true;
+    }
+
+    // the server drains the ring before any request, the next request delivers the descriptor if failed.
+    int32_t ret = SendCountedRequest(BUFFER_RING_DOORBELL, data, reply, option);
+    if (ret != MSERR_OK) {
+        MEDIA_LOGE("Ring doorbell failed, error: %{public}d", ret);
+    }
+    return true;
 }
 
 int32_t AVCodecServiceProxy::Start()
@@ -188,7 +274,7 @@ int32_t AVCodecServiceProxy::Start()
         return MSERR_UNKNOWN;
     }
 
-    int32_t ret = Remote()->SendRequest(START, data, reply, option);
+    int32_t ret = SendCountedRequest(START, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("Start failed, error: %{public}d", ret);
         return ret;
@@ -207,7 +293,7 @@ int32_t AVCodecServiceProxy::Stop()
         return MSERR_UNKNOWN;
     }
 
-    int32_t ret = Remote()->SendRequest(STOP, data, reply, option);
+    int32_t ret = SendCountedRequest(STOP, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("Stop failed, error: %{public}d", ret);
         return ret;
@@ -226,7 +312,7 @@ int32_t AVCodecServiceProxy::Flush()
         return MSERR_UNKNOWN;
     }
 
-    int32_t ret = Remote()->SendRequest(FLUSH, data, reply, option);
+    int32_t ret = SendCountedRequest(FLUSH, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("Flush failed, error: %{public}d", ret);
         return ret;
@@ -245,7 +331,7 @@ int32_t AVCodecServiceProxy::NotifyEos()
         return MSERR_UNKNOWN;
     }
 
-    int32_t ret = Remote()->SendRequest(NOTIFY_EOS, data, reply, option);
+    int32_t ret = SendCountedRequest(NOTIFY_EOS, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("NotifyEos failed, error: %{public}d", ret);
         return ret;
@@ -257,6 +343,7 @@ int32_t AVCodecServiceProxy::Reset()
 {
     inputBufferCache_ = nullptr;
     outputBufferCache_ = nullptr;
+    bufferRing_ = nullptr;
 
     MessageParcel data;
     MessageParcel reply;
@@ -267,7 +354,8 @@ int32_t AVCodecServiceProxy::Reset()
         return MSERR_UNKNOWN;
     }
 
-    int32_t ret = Remote()->SendRequest(RESET, data, reply, option);
+    int32_t ret = SendCountedRequest(RESET, data, reply, option);
+    DetachBufferRing();
     if (ret != MSERR_OK) {
         MEDIA_LOGE("Reset failed, error: %{public}d", ret);
         return ret;
@@ -279,6 +367,7 @@ int32_t AVCodecServiceProxy::Release()
 {
     inputBufferCache_ = nullptr;
     outputBufferCache_ = nullptr;
+    bufferRing_ = nullptr;
 
     MessageParcel data;
     MessageParcel reply;
@@ -289,7 +378,8 @@ int32_t AVCodecServiceProxy::Release()
         return MSERR_UNKNOWN;
     }
 
-    int32_t ret = Remote()->SendRequest(RELEASE, data, reply, option);
+    int32_t ret = SendCountedRequest(RELEASE, data, reply, option);
+    DetachBufferRing();
     if (ret != MSERR_OK) {
         MEDIA_LOGE("Release failed, error: %{public}d", ret);
         return ret;
@@ -308,7 +398,7 @@ sptr<OHOS::Surface> AVCodecServiceProxy::CreateInputSurface()
         return nullptr;
     }
 
-    int32_t ret = Remote()->SendRequest(CREATE_INPUT_SURFACE, data, reply, option);
+    int32_t ret = SendCountedRequest(CREATE_INPUT_SURFACE, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("CreateInputSurface failed, error: %{public}d", ret);
         return nullptr;
@@ -353,7 +443,7 @@ int32_t AVCodecServiceProxy::SetOutputSurface(sptr<OHOS::Surface> surface)
 
     (void)data.WriteRemoteObject(object);
     data.WriteString(format);
-    int32_t error = Remote()->SendRequest(SET_OUTPUT_SURFACE, data, reply, option);
+    int32_t error = SendCountedRequest(SET_OUTPUT_SURFACE, data, reply, option);
     if (error != MSERR_OK) {
         MEDIA_LOGE("SetOutputSurface failed, error: %{public}d", error);
         return error;
@@ -373,7 +463,7 @@ std::shared_ptr<AVSharedMemory> AVCodecServiceProxy::GetInputBuffer(uint32_t ind
     }
 
     data.WriteUint32(index);
-    int32_t ret = Remote()->SendRequest(GET_INPUT_BUFFER, data, reply, option);
+    int32_t ret = SendCountedRequest(GET_INPUT_BUFFER, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("GetInputBuffer failed, error: %{public}d", ret);
         return nullptr;
@@ -393,6 +483,17 @@ std::shared_ptr<AVSharedMemory> AVCodecServiceProxy::GetInputBuffer(uint32_t ind
 
 int32_t AVCodecServiceProxy::QueueInputBuffer(uint32_t index, AVCodecBufferInfo info, AVCodecBufferFlag flag)
 {
+    AVCodecBufferDesc desc;
+    desc.kind = AVCodecBufferDesc::INPUT_BUFFER;
+    desc.index = index;
+    desc.presentationTimeUs = info.presentationTimeUs;
+    desc.size = info.size;
+    desc.offset = info.offset;
+    desc.flag = static_cast<uint32_t>(flag);
+    if (PushToRing(desc)) {
+        return MSERR_OK;
+    }
+
     MessageParcel data;
     MessageParcel reply;
     MessageOption option;
@@ -407,7 +508,7 @@ int32_t AVCodecServiceProxy::QueueInputBuffer(uint32_t index, AVCodecBufferInfo
     data.WriteInt32(info.size);
     data.WriteInt32(info.offset);
     data.WriteInt32(static_cast<int32_t>(flag));
-    int32_t ret = Remote()->SendRequest(QUEUE_INPUT_BUFFER, data, reply, option);
+    int32_t ret = SendCountedRequest(QUEUE_INPUT_BUFFER, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("QueueInputBuffer failed, error: %{public}d", ret);
         return ret;
@@ -427,7 +528,7 @@ std::shared_ptr<AVSharedMemory> AVCodecServiceProxy::GetOutputBuffer(uint32_t in
     }
 
     data.WriteUint32(index);
-    int32_t ret = Remote()->SendRequest(GET_OUTPUT_BUFFER, data, reply, option);
+    int32_t ret = SendCountedRequest(GET_OUTPUT_BUFFER, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("GetOutputBuffer failed, error: %{public}d", ret);
         return nullptr;
@@ -456,7 +557,7 @@ int32_t AVCodecServiceProxy::GetOutputFormat(Format &format)
         return MSERR_UNKNOWN;
     }
 
-    int32_t ret = Remote()->SendRequest(GET_OUTPUT_FORMAT, data, reply, option);
+    int32_t ret = SendCountedRequest(GET_OUTPUT_FORMAT, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("GetOutputFormat failed, error: %{public}d", ret);
         return ret;
@@ -468,6 +569,14 @@ int32_t AVCodecServiceProxy::GetOutputFormat(Format &format)
 
 int32_t AVCodecServiceProxy::ReleaseOutputBuffer(uint32_t index, bool render)
 {
+    AVCodecBufferDesc desc;
+    desc.kind = AVCodecBufferDesc::OUTPUT_BUFFER;
+    desc.index = index;
+    desc.flag = render ? 1 : 0;
+    if (PushToRing(desc)) {
+        return MSERR_OK;
+    }
+
     MessageParcel data;
     MessageParcel reply;
     MessageOption option;
@@ -479,7 +588,7 @@ int32_t AVCodecServiceProxy::ReleaseOutputBuffer(uint32_t index, bool render)
 
     data.WriteUint32(index);
     data.WriteBool(render);
-    int32_t ret = Remote()->SendRequest(RELEASE_OUTPUT_BUFFER, data, reply, option);
+    int32_t ret = SendCountedRequest(RELEASE_OUTPUT_BUFFER, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("ReleaseOutputBuffer failed, error: %{public}d", ret);
         return ret;
@@ -499,7 +608,7 @@ int32_t AVCodecServiceProxy::SetParameter(const Format &format)
     }
 
     (void)MediaParcel::Marshalling(data, format);
-    int32_t ret = Remote()->SendRequest(SET_PARAMETER, data, reply, option);
+    int32_t ret = SendCountedRequest(SET_PARAMETER, data, reply, option);
     if (ret != MSERR_OK) {
         MEDIA_LOGE("SetParameter failed, error: %{public}d", ret);
         return ret;
@@ -511,6 +620,7 @@ int32_t AVCodecServiceProxy::DestroyStub()
 {
     inputBufferCache_ = nullptr;
     outputBufferCache_ = nullptr;
+    bufferRing_ = nullptr;
 
     MessageParcel data;
     MessageParcel reply;
@@ -521,7 +631,8 @@ int32_t AVCodecServiceProxy::DestroyStub()
         return MSERR_UNKNOWN;
     }
 
-    int32_t ret = Remote()->SendRequest(DESTROY, data, reply, option);
+    int32_t ret = SendCountedRequest(DESTROY, data, reply, option);
+    DetachBufferRing();
     if (ret != MSERR_OK) {
         MEDIA_LOGE("destroy failed, error: %{public}d", ret);
         return ret;
@@ -529,5 +640,13 @@ int32_t AVCodecServiceProxy::DestroyStub()
 
     return reply.ReadInt32();
 }
+
+int32_t AVCodecServiceProxy::SendCountedRequest(uint32_t code, MessageParcel &data, MessageParcel &reply,
+    MessageOption &option)
+{
+    // every binder transaction to the service, the batched buffers cost only the doorbells
+    METRICS_COUNTER_ADD("avcodec.ipc.request", 1);
+    return Remote()->SendRequest(code, data, reply, option);
+}
 } // namespace Media
 } // namespace OHOS
@@ -17,6 +17,7 @@
 #define AVCODEC_SERVICE_PROXY_H
 
 #include "i_standard_avcodec_service.h"
+#include "i_standard_avcodec_listener.h"
 #include "nocopyable.h"
 
 namespace OHOS {
@@ -47,11 +48,21 @@ public:
     int32_t DestroyStub() override;
 
 private:
+    int32_t SetupBufferRing();
+    void DetachBufferRing();
+    bool PushToRing(const AVCodecBufferDesc &desc);
+    int32_t SendCountedRequest(uint32_t code, MessageParcel &data, MessageParcel &reply, MessageOption &option);
+
     static inline BrokerDelegator<AVCodecServiceProxy> delegator_;
 
     class AVCodecBufferCache;
     std::unique_ptr<AVCodecBufferCache> inputBufferCache_;
     std::unique_ptr<AVCodecBufferCache> outputBufferCache_;
+
+    // the local listener stub, which consumes the notify ring
+    sptr<IStandardAVCodecListener> listener_ = nullptr;
+    std::shared_ptr<AVCodecBufferRing> bufferRing_ = nullptr;
+    bool batchedBuffer_ = false;
 };
 } // namespace Media
 } // namespace OHOS
@@ -122,11 +122,14 @@ int32_t AVCodecServiceStub::Init()
     recFuncs_[GET_OUTPUT_FORMAT] = &AVCodecServiceStub::GetOutputFormat;
     recFuncs_[SET_PARAMETER] = &AVCodecServiceStub::SetParameter;
     recFuncs_[DESTROY] = &AVCodecServiceStub::DestroyStub;
+    recFuncs_[SET_BUFFER_RING] = &AVCodecServiceStub::SetBufferRing;
+    recFuncs_[BUFFER_RING_DOORBELL] = &AVCodecServiceStub::BufferRingDoorbell;
     return MSERR_OK;
 }
 
 int32_t AVCodecServiceStub::DestroyStub()
 {
+    ResetBufferRing();
     codecServer_ = nullptr;
     outputBufferCache_ = nullptr;
     inputBufferCache_ = nullptr;
@@ -148,6 +151,8 @@ int AVCodecServiceStub::OnRemoteRequest(uint32_t code, MessageParcel &data, Mess
     if (itFunc != recFuncs_.end()) {
         auto memberFunc = itFunc->second;
         if (memberFunc != nullptr) {
+            // the buffers batched in the ring are always queued before this request
+            DrainBufferRing();
             int32_t ret = (this->*memberFunc)(data, reply);
             if (ret != MSERR_OK) {
                 MEDIA_LOGE("calling memberFunc is failed.");
@@ -169,6 +174,7 @@ int32_t AVCodecServiceStub::SetListenerObject(const sptr<IRemoteObject> &object)
 
     std::shared_ptr<AVCodecCallback> callback = std::make_shared<AVCodecListenerCallback>(listener);
     CHECK_AND_RETURN_RET_LOG(callback != nullptr, MSERR_NO_MEMORY, "failed to new AVCodecListenerCallback");
+    listener_ = listener;
 
     CHECK_AND_RETURN_RET_LOG(codecServer_ != nullptr, MSERR_NO_MEMORY, "avcodec server is nullptr");
     (void)codecServer_->SetCallback(callback);
@@ -222,6 +228,7 @@ int32_t AVCodecServiceStub::Reset()
     CHECK_AND_RETURN_RET_LOG(codecServer_ != nullptr, MSERR_NO_MEMORY, "avcodec server is nullptr");
     inputBufferCache_ = nullptr;
     outputBufferCache_ = nullptr;
+    ResetBufferRing();
     return codecServer_->Reset();
 }
 
@@ -230,6 +237,7 @@ int32_t AVCodecServiceStub::Release()
     CHECK_AND_RETURN_RET_LOG(codecServer_ != nullptr, MSERR_NO_MEMORY, "avcodec server is nullptr");
     inputBufferCache_ = nullptr;
     outputBufferCache_ = nullptr;
+    ResetBufferRing();
     return codecServer_->Release();
 }
 
@@ -287,6 +295,63 @@ int32_t AVCodecServiceStub::SetParameter(const Format &format)
     return codecServer_->SetParameter(format);
 }
 
+int32_t AVCodecServiceStub::SetBufferRing(const std::shared_ptr<AVCodecBufferRing> &requestRing,
+    const std::shared_ptr<AVCodecBufferRing> &notifyRing)
+{
+    CHECK_AND_RETURN_RET_LOG(requestRing != nullptr && notifyRing != nullptr, MSERR_INVALID_VAL, "invalid ring");
+    CHECK_AND_RETURN_RET_LOG(listener_ != nullptr, MSERR_INVALID_OPERATION, "listener is nullptr");
+
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    bufferRing_ = requestRing;
+    listener_->SetBufferRing(notifyRing);
+    return MSERR_OK;
+}
+
+void AVCodecServiceStub::ResetBufferRing()
+{
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    bufferRing_ = nullptr;
+    if (listener_ != nullptr) {
+        listener_->SetBufferRing(nullptr);
+    }
+}
+
+void AVCodecServiceStub::DrainBufferRing()
+{
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    CHECK_AND_RETURN(bufferRing_ != nullptr);
+
+    AVCodecBufferDesc desc;
+    while (true) {
+        while (bufferRing_->Front(desc)) {
+            bufferRing_->Pop();
+
+            int32_t ret = MSERR_OK;
+            if (desc.kind == AVCodecBufferDesc::INPUT_BUFFER) {
+                AVCodecBufferInfo info;
+                info.presentationTimeUs = desc.presentationTimeUs;
+                info.size = desc.size;
+                info.offset = desc.offset;
+                ret = QueueInputBuffer(desc.index, info, static_cast<AVCodecBufferFlag>(desc.flag));
+            } else if (desc.kind == AVCodecBufferDesc::OUTPUT_BUFFER) {
+                ret = ReleaseOutputBuffer(desc.index, desc.flag != 0);
+            }
+            if (ret != MSERR_OK) {
+                MEDIA_LOGE("batched buffer failed, kind: %{public}u, index: %{public}u, ret: %{public}d",
+                    desc.kind, desc.index, ret);
+                // the caller got MSERR_OK when it posted the buffer, so the failure is reported here
+                if (listener_ != nullptr) {
+                    listener_->OnError(AVCODEC_ERROR_INTERNAL, ret);
+                }
+            }
+        }
+        if (bufferRing_->Arm()) {
+            return;
+        }
+        bufferRing_->Disarm();
+    }
+}
+
 int32_t AVCodecServiceStub::DumpInfo(int32_t fd)
 {
     CHECK_AND_RETURN_RET_LOG(codecServer_ != nullptr, MSERR_NO_MEMORY, "codec server is nullptr");
@@ -451,6 +516,22 @@ int32_t AVCodecServiceStub::SetParameter(MessageParcel &data, MessageParcel &rep
     return MSERR_OK;
 }
 
+int32_t AVCodecServiceStub::SetBufferRing(MessageParcel &data, MessageParcel &reply)
+{
+    auto requestRing = AVCodecBufferRing::CreateFromParcel(data);
+    auto notifyRing = AVCodecBufferRing::CreateFromParcel(data);
+    reply.WriteInt32(SetBufferRing(requestRing, notifyRing));
+    return MSERR_OK;
+}
+
+int32_t AVCodecServiceStub::BufferRingDoorbell(MessageParcel &data, MessageParcel &reply)
+{
+    // nothing left to do, the ring has been drained before dispatching any request
+    (void)data;
+    (void)reply;
+    return MSERR_OK;
+}
+
 int32_t AVCodecServiceStub::DestroyStub(MessageParcel &data, MessageParcel &reply)
 {
     (void)data;
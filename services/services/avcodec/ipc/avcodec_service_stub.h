@@ -75,6 +75,12 @@ private:
     int32_t ReleaseOutputBuffer(MessageParcel &data, MessageParcel &reply);
     int32_t SetParameter(MessageParcel &data, MessageParcel &reply);
     int32_t DestroyStub(MessageParcel &data, MessageParcel &reply);
+    int32_t SetBufferRing(MessageParcel &data, MessageParcel &reply);
+    int32_t BufferRingDoorbell(MessageParcel &data, MessageParcel &reply);
+    int32_t SetBufferRing(const std::shared_ptr<AVCodecBufferRing> &requestRing,
+        const std::shared_ptr<AVCodecBufferRing> &notifyRing);
+    void ResetBufferRing();
+    void DrainBufferRing();
 
     std::shared_ptr<IAVCodecService> codecServer_ = nullptr;
     std::map<uint32_t, AVCodecStubFunc> recFuncs_;
@@ -83,6 +89,10 @@ private:
     class AVCodecBufferCache;
     std::unique_ptr<AVCodecBufferCache> inputBufferCache_;
     std::unique_ptr<AVCodecBufferCache> outputBufferCache_;
+
+    sptr<IStandardAVCodecListener> listener_ = nullptr;
+    std::mutex ringMutex_;
+    std::shared_ptr<AVCodecBufferRing> bufferRing_ = nullptr;
 };
 } // namespace Media
 } // namespace OHOS
@@ -21,6 +21,7 @@
 #include "iremote_proxy.h"
 #include "iremote_stub.h"
 #include "avcodec_common.h"
+#include "avcodec_buffer_ring.h"
 
 namespace OHOS {
 namespace Media {
@@ -31,6 +32,12 @@ public:
     virtual void OnOutputFormatChanged(const Format &format) = 0;
     virtual void OnInputBufferAvailable(uint32_t index) = 0;
     virtual void OnOutputBufferAvailable(uint32_t index, AVCodecBufferInfo info, AVCodecBufferFlag flag) = 0;
+    /**
+     * Deliver the buffer notifications through the ring instead of one transaction per buffer, nullptr
+     * to fall back to the per-buffer transactions. It is not a transaction, both the proxy and the stub
+     * are attached to the ring in their own process, see {@link IStandardAVCodecService::SET_BUFFER_RING}.
+     */
+    virtual void SetBufferRing(const std::shared_ptr<AVCodecBufferRing> &ring) = 0;
 
     /**
      * IPC code ID
@@ -39,7 +46,8 @@ public:
         ON_ERROR = 0,
         ON_OUTPUT_FORMAT_CHANGED,
         ON_INPUT_BUFFER_AVAILABLE,
-        ON_OUTPUT_BUFFER_AVAILABLE
+        ON_OUTPUT_BUFFER_AVAILABLE,
+        BUFFER_RING_DOORBELL,
     };
 
     DECLARE_INTERFACE_DESCRIPTOR(u"IStandardAVCodecListener");
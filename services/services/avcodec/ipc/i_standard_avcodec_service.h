@@ -73,7 +73,10 @@ public:
         GET_OUTPUT_FORMAT,
         RELEASE_OUTPUT_BUFFER,
         SET_PARAMETER,
-        DESTROY
+        DESTROY,
+        // carries the request ring (client to server) and the notify ring (server to client)
+        SET_BUFFER_RING,
+        BUFFER_RING_DOORBELL,
     };
 
     DECLARE_INTERFACE_DESCRIPTOR(u"IStandardAVCodecService");
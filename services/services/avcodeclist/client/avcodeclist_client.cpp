@@ -14,6 +14,8 @@
  */
 
 #include "avcodeclist_client.h"
+#include "avcodec_capability_index.h"
+#include "avcodeclist_snapshot.h"
 #include "media_log.h"
 #include "media_errors.h"
 
@@ -23,6 +25,9 @@ namespace {
 
 namespace OHOS {
 namespace Media {
+std::shared_ptr<const AVCodecCapabilityIndex> AVCodecListClient::cachedIndex_ = nullptr;
+std::mutex AVCodecListClient::cacheMutex_;
+
 std::shared_ptr<AVCodecListClient> AVCodecListClient::Create(const sptr<IStandardAVCodecListService> &ipcProxy)
 {
     CHECK_AND_RETURN_RET_LOG(ipcProxy != nullptr, nullptr, "ipcProxy is nullptr..");
@@ -52,6 +57,11 @@ void AVCodecListClient::MediaServerDied()
 {
     std::lock_guard<std::mutex> lock(mutex_);
     codecListProxy_ = nullptr;
+    capabilityIndex_ = nullptr;
+
+    // the version restarts with the new media service
+    std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+    cachedIndex_ = nullptr;
 }
 
 std::string AVCodecListClient::FindVideoDecoder(const Format &format)
@@ -89,5 +99,30 @@ std::vector<CapabilityData> AVCodecListClient::GetCodecCapabilityInfos()
         "codeclist service does not exist.");
     return codecListProxy_->GetCodecCapabilityInfos();
 }
+
+std::shared_ptr<const AVCodecCapabilityIndex> AVCodecListClient::GetCapabilityIndex()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capabilityIndex_ != nullptr) {
+        return capabilityIndex_;
+    }
+    CHECK_AND_RETURN_RET_LOG(codecListProxy_ != nullptr, nullptr, "codeclist service does not exist.");
+
+    std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+    uint32_t knownVersion = (cachedIndex_ == nullptr) ? 0 : cachedIndex_->GetVersion();
+    uint32_t version = 0;
+    std::shared_ptr<AVSharedMemory> snapshot = nullptr;
+    int32_t ret = codecListProxy_->GetCapabilitySnapshot(knownVersion, version, snapshot);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, nullptr, "GetCapabilitySnapshot failed, ret: %{public}d", ret);
+
+    if (snapshot != nullptr) {
+        std::vector<CapabilityData> capabilityDataArray;
+        ret = AVCodecListSnapshot::Read(snapshot, capabilityDataArray, version);
+        CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, nullptr, "failed to read the snapshot, ret: %{public}d", ret);
+        cachedIndex_ = std::make_shared<AVCodecCapabilityIndex>(std::move(capabilityDataArray), version);
+    }
+    capabilityIndex_ = cachedIndex_;
+    return capabilityIndex_;
+}
 } // namespace Media
 } // namespace OHOS
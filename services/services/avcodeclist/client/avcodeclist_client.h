@@ -34,10 +34,15 @@ public:
     std::string FindAudioDecoder(const Format &format) override;
     std::string FindAudioEncoder(const Format &format) override;
     std::vector<CapabilityData> GetCodecCapabilityInfos() override;
+    std::shared_ptr<const AVCodecCapabilityIndex> GetCapabilityIndex() override;
 
 private:
     sptr<IStandardAVCodecListService> codecListProxy_ = nullptr;
+    std::shared_ptr<const AVCodecCapabilityIndex> capabilityIndex_ = nullptr;
     std::mutex mutex_;
+    // the latest index received by this process, shared by all clients while its version is not changed
+    static std::shared_ptr<const AVCodecCapabilityIndex> cachedIndex_;
+    static std::mutex cacheMutex_;
 };
 } // namespace Media
 } // namespace OHOS
@@ -144,5 +144,33 @@ int32_t AVCodecListServiceProxy::DestroyStub()
     }
     return reply.ReadInt32();
 }
+
+int32_t AVCodecListServiceProxy::GetCapabilitySnapshot(uint32_t knownVersion, uint32_t &version,
+    std::shared_ptr<AVSharedMemory> &snapshot)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVCodecListServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    (void)data.WriteUint32(knownVersion);
+    int32_t ret = Remote()->SendRequest(GET_CAPABILITY_SNAPSHOT, data, reply, option);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, MSERR_INVALID_OPERATION,
+        "GetCapabilitySnapshot failed, error: %{public}d", ret);
+
+    ret = reply.ReadInt32();
+    CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+    version = reply.ReadUint32();
+    snapshot = nullptr;
+    if (reply.ReadBool()) {
+        snapshot = ReadAVSharedMemoryFromParcel(reply);
+        CHECK_AND_RETURN_RET_LOG(snapshot != nullptr, MSERR_NO_MEMORY, "failed to read the snapshot");
+    }
+    return MSERR_OK;
+}
 } // namespace Media
 } // namespace OHOS
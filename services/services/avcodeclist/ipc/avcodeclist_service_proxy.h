@@ -34,6 +34,8 @@ public:
     std::string FindAudioEncoder(const Format &format) override;
     std::vector<CapabilityData> GetCodecCapabilityInfos() override;
     int32_t DestroyStub() override;
+    int32_t GetCapabilitySnapshot(uint32_t knownVersion, uint32_t &version,
+        std::shared_ptr<AVSharedMemory> &snapshot) override;
 
 private:
     static inline BrokerDelegator<AVCodecListServiceProxy> delegator_;
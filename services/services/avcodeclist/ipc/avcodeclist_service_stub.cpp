@@ -15,6 +15,7 @@
 
 #include "avcodeclist_service_stub.h"
 #include <unistd.h>
+#include "avcodeclist_snapshot.h"
 #include "avsharedmemory_ipc.h"
 #include "media_errors.h"
 #include "media_log.h"
@@ -56,6 +57,7 @@ int32_t AVCodecListServiceStub::Init()
     codecListFuncs_[FIND_AUDIO_ENCODER] = &AVCodecListServiceStub::FindAudioEncoder;
     codecListFuncs_[GET_CAPABILITY_INFOS] = &AVCodecListServiceStub::GetCodecCapabilityInfos;
     codecListFuncs_[DESTROY] = &AVCodecListServiceStub::DestroyStub;
+    codecListFuncs_[GET_CAPABILITY_SNAPSHOT] = &AVCodecListServiceStub::GetCapabilitySnapshot;
     return MSERR_OK;
 }
 
@@ -125,6 +127,23 @@ std::vector<CapabilityData> AVCodecListServiceStub::GetCodecCapabilityInfos()
     return codecListServer_->GetCodecCapabilityInfos();
 }
 
+int32_t AVCodecListServiceStub::GetCapabilitySnapshot(uint32_t knownVersion, uint32_t &version,
+    std::shared_ptr<AVSharedMemory> &snapshot)
+{
+    CHECK_AND_RETURN_RET_LOG(codecListServer_ != nullptr, MSERR_INVALID_OPERATION, "avcodeclist server is nullptr");
+    std::shared_ptr<const AVCodecCapabilityIndex> capabilityIndex = codecListServer_->GetCapabilityIndex();
+    CHECK_AND_RETURN_RET_LOG(capabilityIndex != nullptr, MSERR_UNKNOWN, "capability index is nullptr");
+
+    version = capabilityIndex->GetVersion();
+    snapshot = nullptr;
+    if (version == knownVersion) {
+        return MSERR_OK;
+    }
+    snapshot = AVCodecListSnapshot::Publish(*capabilityIndex);
+    CHECK_AND_RETURN_RET_LOG(snapshot != nullptr, MSERR_NO_MEMORY, "failed to publish the snapshot");
+    return MSERR_OK;
+}
+
 int32_t AVCodecListServiceStub::FindVideoDecoder(MessageParcel &data, MessageParcel &reply)
 {
     Format format;
@@ -172,5 +191,23 @@ int32_t AVCodecListServiceStub::DestroyStub(MessageParcel &data, MessageParcel &
     reply.WriteInt32(DestroyStub());
     return MSERR_OK;
 }
+
+int32_t AVCodecListServiceStub::GetCapabilitySnapshot(MessageParcel &data, MessageParcel &reply)
+{
+    uint32_t knownVersion = data.ReadUint32();
+    uint32_t version = 0;
+    std::shared_ptr<AVSharedMemory> snapshot = nullptr;
+    int32_t ret = GetCapabilitySnapshot(knownVersion, version, snapshot);
+    reply.WriteInt32(ret);
+    if (ret != MSERR_OK) {
+        return ret;
+    }
+    reply.WriteUint32(version);
+    reply.WriteBool(snapshot != nullptr);
+    if (snapshot != nullptr) {
+        return WriteAVSharedMemoryToParcel(snapshot, reply);
+    }
+    return MSERR_OK;
+}
 } // namespace Media
 } // namespace OHOS
@@ -38,6 +38,8 @@ public:
     std::string FindAudioEncoder(const Format &format) override;
     std::vector<CapabilityData>  GetCodecCapabilityInfos() override;
     int32_t DestroyStub() override;
+    int32_t GetCapabilitySnapshot(uint32_t knownVersion, uint32_t &version,
+        std::shared_ptr<AVSharedMemory> &snapshot) override;
 
 private:
     AVCodecListServiceStub();
@@ -48,6 +50,7 @@ private:
     int32_t FindAudioEncoder(MessageParcel &data, MessageParcel &reply);
     int32_t GetCodecCapabilityInfos(MessageParcel &data, MessageParcel &reply);
     int32_t DestroyStub(MessageParcel &data, MessageParcel &reply);
+    int32_t GetCapabilitySnapshot(MessageParcel &data, MessageParcel &reply);
     std::shared_ptr<IAVCodecListService> codecListServer_ = nullptr;
     using AVCodecListStubFunc = int32_t(AVCodecListServiceStub::*)(MessageParcel &data, MessageParcel &reply);
     std::map<uint32_t, AVCodecListStubFunc> codecListFuncs_;
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avcodeclist_snapshot.h"
+#include <cstdlib>
+#include <mutex>
+#include "avcodeclist_parcel.h"
+#include "avsharedmemorybase.h"
+#include "media_errors.h"
+#include "media_log.h"
+#include "securec.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVCodecListSnapshot"};
+    constexpr uint32_t SNAPSHOT_MAGIC = 0x4C435641; // "AVCL"
+    constexpr size_t MAX_SNAPSHOT_SIZE = 4 * 1024 * 1024;
+
+    struct SnapshotHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t dataSize;
+    };
+}
+
+namespace OHOS {
+namespace Media {
+std::shared_ptr<AVSharedMemory> AVCodecListSnapshot::Publish(const AVCodecCapabilityIndex &index)
+{
+    static std::mutex mutex;
+    static uint32_t version = 0;
+    static std::shared_ptr<AVSharedMemory> snapshot = nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (snapshot != nullptr && version == index.GetVersion()) {
+        return snapshot;
+    }
+
+    MessageParcel parcel;
+    (void)AVCodecListParcel::Marshalling(parcel, index.GetCapabilityDataArray());
+    size_t dataSize = parcel.GetDataSize();
+    CHECK_AND_RETURN_RET_LOG(dataSize <= MAX_SNAPSHOT_SIZE, nullptr, "capabilities too large: %{public}zu", dataSize);
+
+    std::shared_ptr<AVSharedMemory> memory = AVSharedMemoryBase::CreateFromLocal(
+        static_cast<int32_t>(sizeof(SnapshotHeader) + dataSize), AVSharedMemory::FLAGS_READ_ONLY,
+        "AVCodecListSnapshot");
+    CHECK_AND_RETURN_RET_LOG(memory != nullptr && memory->GetBase() != nullptr, nullptr, "no memory");
+
+    SnapshotHeader *header = reinterpret_cast<SnapshotHeader *>(memory->GetBase());
+    header->magic = SNAPSHOT_MAGIC;
+    header->version = index.GetVersion();
+    header->dataSize = static_cast<uint32_t>(dataSize);
+    errno_t rc = memcpy_s(memory->GetBase() + sizeof(SnapshotHeader), dataSize,
+        reinterpret_cast<const void *>(parcel.GetData()), dataSize);
+    CHECK_AND_RETURN_RET_LOG(rc == EOK, nullptr, "memcpy_s failed");
+
+    MEDIA_LOGI("publish capability snapshot, version %{public}u, size %{public}zu", header->version, dataSize);
+    version = header->version;
+    snapshot = memory;
+    return snapshot;
+}
+
+int32_t AVCodecListSnapshot::Read(const std::shared_ptr<AVSharedMemory> &memory,
+    std::vector<CapabilityData> &capabilityDataArray, uint32_t &version)
+{
+    CHECK_AND_RETURN_RET_LOG(memory != nullptr && memory->GetBase() != nullptr, MSERR_INVALID_VAL, "no memory");
+    CHECK_AND_RETURN_RET_LOG(static_cast<size_t>(memory->GetSize()) >= sizeof(SnapshotHeader),
+        MSERR_INVALID_VAL, "invalid snapshot size");
+
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader *>(memory->GetBase());
+    size_t dataSize = header->dataSize;
+    CHECK_AND_RETURN_RET_LOG(header->magic == SNAPSHOT_MAGIC &&
+        dataSize <= static_cast<size_t>(memory->GetSize()) - sizeof(SnapshotHeader) &&
+        dataSize <= MAX_SNAPSHOT_SIZE, MSERR_INVALID_VAL, "invalid snapshot header");
+
+    // the parcel takes the ownership of the buffer once it is parsed
+    uint8_t *buffer = static_cast<uint8_t *>(malloc(dataSize));
+    CHECK_AND_RETURN_RET_LOG(buffer != nullptr, MSERR_NO_MEMORY, "no memory");
+    if (memcpy_s(buffer, dataSize, memory->GetBase() + sizeof(SnapshotHeader), dataSize) != EOK) {
+        free(buffer);
+        MEDIA_LOGE("memcpy_s failed");
+        return MSERR_NO_MEMORY;
+    }
+
+    MessageParcel parcel;
+    if (!parcel.ParseFrom(reinterpret_cast<uintptr_t>(buffer), dataSize)) {
+        free(buffer);
+        MEDIA_LOGE("failed to parse the snapshot");
+        return MSERR_INVALID_VAL;
+    }
+    (void)AVCodecListParcel::Unmarshalling(parcel, capabilityDataArray);
+    version = header->version;
+    return MSERR_OK;
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVCODECLIST_SNAPSHOT_H
+#define AVCODECLIST_SNAPSHOT_H
+
+#include <memory>
+#include <vector>
+#include "avcodec_capability_index.h"
+#include "avsharedmemory.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * The read-only shared memory snapshot of the codec capabilities, which is serialized once per index
+ * version by the server and mapped by all clients, so the client could answer the queries locally.
+ */
+class AVCodecListSnapshot {
+public:
+    AVCodecListSnapshot() = delete;
+    ~AVCodecListSnapshot() = delete;
+
+    /**
+     * Server: get the snapshot of the index, it is created only if the version of the index is changed.
+     */
+    static std::shared_ptr<AVSharedMemory> Publish(const AVCodecCapabilityIndex &index);
+
+    /**
+     * Client: read the capabilities and the version from the snapshot created by {@link Publish}.
+     */
+    static int32_t Read(const std::shared_ptr<AVSharedMemory> &memory,
+        std::vector<CapabilityData> &capabilityDataArray, uint32_t &version);
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVCODECLIST_SNAPSHOT_H
@@ -34,6 +34,11 @@ public:
     virtual std::string FindAudioEncoder(const Format &format) = 0;
     virtual std::vector<CapabilityData>  GetCodecCapabilityInfos() = 0;
     virtual int32_t DestroyStub() = 0;
+    /**
+     * Get the capability snapshot if its version differs from the known one, otherwise the snapshot is nullptr.
+     */
+    virtual int32_t GetCapabilitySnapshot(uint32_t knownVersion, uint32_t &version,
+        std::shared_ptr<AVSharedMemory> &snapshot) = 0;
 
     /**
      * IPC code ID
@@ -45,7 +50,8 @@ public:
         FIND_AUDIO_DECODER,
         FIND_AUDIO_ENCODER,
         GET_CAPABILITY_INFOS,
-        DESTROY
+        DESTROY,
+        GET_CAPABILITY_SNAPSHOT,
     };
 
     DECLARE_INTERFACE_DESCRIPTOR(u"IStandardAVCodecListService");
@@ -92,5 +92,13 @@ std::vector<CapabilityData> AVCodecListServer::GetCodecCapabilityInfos()
     std::lock_guard<std::mutex> lock(mutex_);
     return codecListEngine_->GetCodecCapabilityInfos();
 }
+
+std::shared_ptr<const AVCodecCapabilityIndex> AVCodecListServer::GetCapabilityIndex()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(codecListEngine_ != nullptr, nullptr, "engine is nullptr");
+
+    return codecListEngine_->GetCapabilityIndex();
+}
 } // namespace Media
 } // namespace OHOS
@@ -34,6 +34,7 @@ public:
     std::string FindAudioDecoder(const Format &format) override;
     std::string FindAudioEncoder(const Format &format) override;
     std::vector<CapabilityData>  GetCodecCapabilityInfos() override;
+    std::shared_ptr<const AVCodecCapabilityIndex> GetCapabilityIndex() override;
 
 private:
     int32_t Init();
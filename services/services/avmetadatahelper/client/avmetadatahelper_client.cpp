@@ -42,13 +42,40 @@ AVMetadataHelperClient::~AVMetadataHelperClient()
     if (avMetadataHelperProxy_ != nullptr) {
         (void)avMetadataHelperProxy_->DestroyStub();
     }
+    listenerStub_ = nullptr;
+    batchCallback_ = nullptr;
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
 }
 
+int32_t AVMetadataHelperClient::CreateListenerObject(const std::shared_ptr<AVMetadataBatchServiceCallback> &callback)
+{
+    sptr<AVMetadataHelperListenerStub> listenerStub = new(std::nothrow) AVMetadataHelperListenerStub();
+    CHECK_AND_RETURN_RET_LOG(listenerStub != nullptr, MSERR_NO_MEMORY,
+        "failed to new AVMetadataHelperListenerStub object");
+    listenerStub->SetBatchCallback(callback);
+
+    sptr<IRemoteObject> object = listenerStub->AsObject();
+    CHECK_AND_RETURN_RET_LOG(object != nullptr, MSERR_NO_MEMORY, "listener object is nullptr..");
+
+    MEDIA_LOGD("SetListenerObject");
+    int32_t ret = avMetadataHelperProxy_->SetListenerObject(object);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "failed to set listener object..");
+    listenerStub_ = listenerStub;
+    return MSERR_OK;
+}
+
 void AVMetadataHelperClient::MediaServerDied()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    avMetadataHelperProxy_ = nullptr;
+    std::shared_ptr<AVMetadataBatchServiceCallback> batchCallback = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        avMetadataHelperProxy_ = nullptr;
+        listenerStub_ = nullptr;
+        batchCallback.swap(batchCallback_);
+    }
+    if (batchCallback != nullptr) {
+        batchCallback->OnBatchFinished(MSERR_SERVICE_DIED);
+    }
 }
 
 int32_t AVMetadataHelperClient::SetSource(const std::string &uri, int32_t usage)
@@ -96,6 +123,48 @@ std::shared_ptr<AVSharedMemory> AVMetadataHelperClient::FetchFrameAtTime(int64_t
     return avMetadataHelperProxy_->FetchFrameAtTime(timeUs, option, param);
 }
 
+int32_t AVMetadataHelperClient::PrepareFetchFrames(const std::vector<int64_t> &timesUs, int32_t option,
+    const OutputConfiguration &param)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperProxy_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper service does not exist.");
+    return avMetadataHelperProxy_->PrepareFetchFrames(timesUs, option, param);
+}
+
+std::shared_ptr<AVSharedMemory> AVMetadataHelperClient::FetchNextFrame(int64_t &timeUs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    timeUs = -1;
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperProxy_ != nullptr, nullptr, "avmetadatahelper service does not exist.");
+    return avMetadataHelperProxy_->FetchNextFrame(timeUs);
+}
+
+int32_t AVMetadataHelperClient::ResolveMetadataBatch(const std::vector<AVMetadataBatchSource> &sources,
+    const AVMetadataBatchConfig &config, const std::shared_ptr<AVMetadataBatchServiceCallback> &callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperProxy_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper service does not exist.");
+    CHECK_AND_RETURN_RET_LOG(callback != nullptr, MSERR_INVALID_VAL, "callback is nullptr");
+
+    int32_t ret = CreateListenerObject(callback);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "failed to create listener object..");
+
+    ret = avMetadataHelperProxy_->ResolveMetadataBatch(sources, config);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "failed to start the batch");
+    batchCallback_ = callback;
+    return MSERR_OK;
+}
+
+int32_t AVMetadataHelperClient::CancelBatch()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperProxy_ != nullptr, MSERR_NO_MEMORY,
+        "avmetadatahelper service does not exist.");
+    return avMetadataHelperProxy_->CancelBatch();
+}
+
 void AVMetadataHelperClient::Release()
 {
     std::lock_guard<std::mutex> lock(mutex_);
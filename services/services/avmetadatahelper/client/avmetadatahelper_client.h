@@ -18,6 +18,7 @@
 
 #include "i_avmetadatahelper_service.h"
 #include "i_standard_avmetadatahelper_service.h"
+#include "avmetadatahelper_listener_stub.h"
 
 namespace OHOS {
 namespace Media {
@@ -35,12 +36,23 @@ public:
     std::shared_ptr<AVSharedMemory> FetchArtPicture() override;
     std::shared_ptr<AVSharedMemory> FetchFrameAtTime(int64_t timeUs,
         int32_t option, const OutputConfiguration &param) override;
+    int32_t PrepareFetchFrames(const std::vector<int64_t> &timesUs,
+        int32_t option, const OutputConfiguration &param) override;
+    std::shared_ptr<AVSharedMemory> FetchNextFrame(int64_t &timeUs) override;
+    int32_t ResolveMetadataBatch(const std::vector<AVMetadataBatchSource> &sources,
+        const AVMetadataBatchConfig &config, const std::shared_ptr<AVMetadataBatchServiceCallback> &callback) override;
+    int32_t CancelBatch() override;
     void Release() override;
 
     // AVMetadataHelperClient
     void MediaServerDied();
 private:
+    int32_t CreateListenerObject(const std::shared_ptr<AVMetadataBatchServiceCallback> &callback);
+
     sptr<IStandardAVMetadataHelperService> avMetadataHelperProxy_ = nullptr;
+    // every batch has its own listener, so the late results of the previous batch never reach the next one
+    sptr<AVMetadataHelperListenerStub> listenerStub_ = nullptr;
+    std::shared_ptr<AVMetadataBatchServiceCallback> batchCallback_ = nullptr;
     std::mutex mutex_;
 };
 } // namespace Media
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmetadatahelper_listener_proxy.h"
+#include "avsharedmemory_ipc.h"
+#include "media_log.h"
+#include "media_errors.h"
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetadataHelperListenerProxy"};
+}
+
+namespace OHOS {
+namespace Media {
+AVMetadataHelperListenerProxy::AVMetadataHelperListenerProxy(const sptr<IRemoteObject> &impl)
+    : IRemoteProxy<IStandardAVMetadataHelperListener>(impl)
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVMetadataHelperListenerProxy::~AVMetadataHelperListenerProxy()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+void AVMetadataHelperListenerProxy::OnBatchResult(int32_t index, int32_t errCode,
+    const std::unordered_map<int32_t, std::string> &metadata, const std::shared_ptr<AVSharedMemory> &thumbnail)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option(MessageOption::TF_ASYNC);
+
+    if (!data.WriteInterfaceToken(AVMetadataHelperListenerProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return;
+    }
+
+    std::vector<int32_t> keys;
+    std::vector<std::string> values;
+    for (auto it = metadata.begin(); it != metadata.end(); it++) {
+        keys.push_back(it->first);
+        values.push_back(it->second);
+    }
+
+    data.WriteInt32(index);
+    data.WriteInt32(errCode);
+    data.WriteInt32Vector(keys);
+    data.WriteStringVector(values);
+    data.WriteBool(thumbnail != nullptr);
+    if (thumbnail != nullptr) {
+        (void)WriteAVSharedMemoryToParcel(thumbnail, data);
+    }
+
+    int error = Remote()->SendRequest(AVMetadataHelperListenerMsg::ON_BATCH_RESULT, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("on batch result failed, error: %{public}d", error);
+    }
+}
+
+void AVMetadataHelperListenerProxy::OnBatchFinished(int32_t errCode)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option(MessageOption::TF_ASYNC);
+
+    if (!data.WriteInterfaceToken(AVMetadataHelperListenerProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return;
+    }
+
+    data.WriteInt32(errCode);
+    int error = Remote()->SendRequest(AVMetadataHelperListenerMsg::ON_BATCH_FINISHED, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("on batch finished failed, error: %{public}d", error);
+    }
+}
+
+AVMetadataHelperListenerCallback::AVMetadataHelperListenerCallback(
+    const sptr<IStandardAVMetadataHelperListener> &listener) : listener_(listener)
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVMetadataHelperListenerCallback::~AVMetadataHelperListenerCallback()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+void AVMetadataHelperListenerCallback::OnBatchResult(int32_t index, int32_t errCode,
+    const std::unordered_map<int32_t, std::string> &metadata, const std::shared_ptr<AVSharedMemory> &thumbnail)
+{
+    if (listener_ != nullptr) {
+        listener_->OnBatchResult(index, errCode, metadata, thumbnail);
+    }
+}
+
+void AVMetadataHelperListenerCallback::OnBatchFinished(int32_t errCode)
+{
+    if (listener_ != nullptr) {
+        listener_->OnBatchFinished(errCode);
+    }
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmetadatahelper_listener_stub.h"
+#include "avsharedmemory_ipc.h"
+#include "media_log.h"
+#include "media_errors.h"
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetadataHelperListenerStub"};
+}
+
+namespace OHOS {
+namespace Media {
+AVMetadataHelperListenerStub::AVMetadataHelperListenerStub()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVMetadataHelperListenerStub::~AVMetadataHelperListenerStub()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+int AVMetadataHelperListenerStub::OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply,
+    MessageOption &option)
+{
+    auto remoteDescriptor = data.ReadInterfaceToken();
+    if (AVMetadataHelperListenerStub::GetDescriptor() != remoteDescriptor) {
+        MEDIA_LOGE("Invalid descriptor");
+        return MSERR_INVALID_OPERATION;
+    }
+
+    switch (code) {
+        case AVMetadataHelperListenerMsg::ON_BATCH_RESULT: {
+            int32_t index = data.ReadInt32();
+            int32_t errCode = data.ReadInt32();
+            std::vector<int32_t> keys;
+            std::vector<std::string> values;
+            (void)data.ReadInt32Vector(&keys);
+            (void)data.ReadStringVector(&values);
+            CHECK_AND_RETURN_RET_LOG(keys.size() == values.size(), MSERR_INVALID_VAL, "invalid metadata");
+
+            std::unordered_map<int32_t, std::string> metadata;
+            for (size_t i = 0; i < keys.size(); i++) {
+                metadata.emplace(keys[i], values[i]);
+            }
+            std::shared_ptr<AVSharedMemory> thumbnail = nullptr;
+            if (data.ReadBool()) {
+                thumbnail = ReadAVSharedMemoryFromParcel(data);
+            }
+            OnBatchResult(index, errCode, metadata, thumbnail);
+            return MSERR_OK;
+        }
+        case AVMetadataHelperListenerMsg::ON_BATCH_FINISHED: {
+            int32_t errCode = data.ReadInt32();
+            OnBatchFinished(errCode);
+            return MSERR_OK;
+        }
+        default: {
+            MEDIA_LOGE("default case, need check AVMetadataHelperListenerStub");
+            return IPCObjectStub::OnRemoteRequest(code, data, reply, option);
+        }
+    }
+}
+
+void AVMetadataHelperListenerStub::OnBatchResult(int32_t index, int32_t errCode,
+    const std::unordered_map<int32_t, std::string> &metadata, const std::shared_ptr<AVSharedMemory> &thumbnail)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (callback_ != nullptr) {
+        callback_->OnBatchResult(index, errCode, metadata, thumbnail);
+    }
+}
+
+void AVMetadataHelperListenerStub::OnBatchFinished(int32_t errCode)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (callback_ != nullptr) {
+        callback_->OnBatchFinished(errCode);
+    }
+}
+
+void AVMetadataHelperListenerStub::SetBatchCallback(const std::shared_ptr<AVMetadataBatchServiceCallback> &callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    callback_ = callback;
+}
+} // namespace Media
+} // namespace OHOS
@@ -207,6 +207,130 @@ std::shared_ptr<AVSharedMemory> AVMetadataHelperServiceProxy::FetchFrameAtTime(i
     return ReadAVSharedMemoryFromParcel(reply);
 }
 
+int32_t AVMetadataHelperServiceProxy::PrepareFetchFrames(const std::vector<int64_t> &timesUs,
+    int32_t option, const OutputConfiguration &param)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption opt;
+
+    if (!data.WriteInterfaceToken(AVMetadataHelperServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    (void)data.WriteInt64Vector(timesUs);
+    (void)data.WriteInt32(option);
+    (void)data.WriteInt32(param.dstWidth);
+    (void)data.WriteInt32(param.dstHeight);
+    (void)data.WriteInt32(static_cast<int32_t>(param.colorFormat));
+
+    int error = Remote()->SendRequest(PREPARE_FETCH_FRAMES, data, reply, opt);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("PrepareFetchFrames failed, error: %{public}d", error);
+        return error;
+    }
+    return reply.ReadInt32();
+}
+
+std::shared_ptr<AVSharedMemory> AVMetadataHelperServiceProxy::FetchNextFrame(int64_t &timeUs)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    timeUs = -1;
+
+    if (!data.WriteInterfaceToken(AVMetadataHelperServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return nullptr;
+    }
+
+    int error = Remote()->SendRequest(FETCH_NEXT_FRAME, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("FetchNextFrame failed, error: %{public}d", error);
+        return nullptr;
+    }
+
+    timeUs = reply.ReadInt64();
+    if (!reply.ReadBool()) {
+        return nullptr;
+    }
+    return ReadAVSharedMemoryFromParcel(reply);
+}
+
+int32_t AVMetadataHelperServiceProxy::SetListenerObject(const sptr<IRemoteObject> &object)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVMetadataHelperServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_INVALID_OPERATION;
+    }
+
+    (void)data.WriteRemoteObject(object);
+    int error = Remote()->SendRequest(SET_LISTENER_OBJ, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("SetListenerObject failed, error: %{public}d", error);
+        return error;
+    }
+    return reply.ReadInt32();
+}
+
+int32_t AVMetadataHelperServiceProxy::ResolveMetadataBatch(const std::vector<AVMetadataBatchSource> &sources,
+    const AVMetadataBatchConfig &config)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVMetadataHelperServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_INVALID_OPERATION;
+    }
+
+    (void)data.WriteUint32(static_cast<uint32_t>(sources.size()));
+    for (auto &source : sources) {
+        (void)data.WriteFileDescriptor(source.fd);
+        (void)data.WriteInt64(source.offset);
+        (void)data.WriteInt64(source.size);
+    }
+    (void)data.WriteInt32Vector(config.keys);
+    (void)data.WriteBool(config.fetchThumbnail);
+    (void)data.WriteInt64(config.thumbnailTimeUs);
+    (void)data.WriteInt32(config.thumbnailOption);
+    (void)data.WriteInt32(config.thumbnailConfig.dstWidth);
+    (void)data.WriteInt32(config.thumbnailConfig.dstHeight);
+    (void)data.WriteInt32(static_cast<int32_t>(config.thumbnailConfig.colorFormat));
+
+    int error = Remote()->SendRequest(RESOLVE_METADATA_BATCH, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("ResolveMetadataBatch failed, error: %{public}d", error);
+        return error;
+    }
+    return reply.ReadInt32();
+}
+
+int32_t AVMetadataHelperServiceProxy::CancelBatch()
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVMetadataHelperServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_INVALID_OPERATION;
+    }
+
+    int error = Remote()->SendRequest(CANCEL_BATCH, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("CancelBatch failed, error: %{public}d", error);
+        return error;
+    }
+    return reply.ReadInt32();
+}
+
 void AVMetadataHelperServiceProxy::Release()
 {
     MessageParcel data;
@@ -32,6 +32,13 @@ public:
     std::shared_ptr<AVSharedMemory> FetchArtPicture() override;
     std::shared_ptr<AVSharedMemory> FetchFrameAtTime(int64_t timeUs,
         int32_t option, const OutputConfiguration &param) override;
+    int32_t PrepareFetchFrames(const std::vector<int64_t> &timesUs,
+        int32_t option, const OutputConfiguration &param) override;
+    std::shared_ptr<AVSharedMemory> FetchNextFrame(int64_t &timeUs) override;
+    int32_t SetListenerObject(const sptr<IRemoteObject> &object) override;
+    int32_t ResolveMetadataBatch(const std::vector<AVMetadataBatchSource> &sources,
+        const AVMetadataBatchConfig &config) override;
+    int32_t CancelBatch() override;
     void Release() override;
     int32_t DestroyStub() override;
 private:
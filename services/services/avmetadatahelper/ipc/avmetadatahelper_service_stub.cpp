@@ -18,6 +18,7 @@
 #include "media_log.h"
 #include "media_errors.h"
 #include "avsharedmemory_ipc.h"
+#include "avmetadatahelper_listener_proxy.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetadataHelperServiceStub"};
@@ -57,6 +58,11 @@ int32_t AVMetadataHelperServiceStub::Init()
     avMetadataHelperFuncs_[RESOLVE_METADATA_MAP] = &AVMetadataHelperServiceStub::ResolveMetadataMap;
     avMetadataHelperFuncs_[FETCH_ART_PICTURE] = &AVMetadataHelperServiceStub::FetchArtPicture;
     avMetadataHelperFuncs_[FETCH_FRAME_AT_TIME] = &AVMetadataHelperServiceStub::FetchFrameAtTime;
+    avMetadataHelperFuncs_[PREPARE_FETCH_FRAMES] = &AVMetadataHelperServiceStub::PrepareFetchFrames;
+    avMetadataHelperFuncs_[FETCH_NEXT_FRAME] = &AVMetadataHelperServiceStub::FetchNextFrame;
+    avMetadataHelperFuncs_[SET_LISTENER_OBJ] = &AVMetadataHelperServiceStub::SetListenerObject;
+    avMetadataHelperFuncs_[RESOLVE_METADATA_BATCH] = &AVMetadataHelperServiceStub::ResolveMetadataBatch;
+    avMetadataHelperFuncs_[CANCEL_BATCH] = &AVMetadataHelperServiceStub::CancelBatch;
     avMetadataHelperFuncs_[RELEASE] = &AVMetadataHelperServiceStub::Release;
     avMetadataHelperFuncs_[DESTROY] = &AVMetadataHelperServiceStub::DestroyStub;
     return MSERR_OK;
@@ -65,6 +71,7 @@ int32_t AVMetadataHelperServiceStub::Init()
 int32_t AVMetadataHelperServiceStub::DestroyStub()
 {
     avMetadateHelperServer_ = nullptr;
+    batchCallback_ = nullptr;
     MediaServerManager::GetInstance().DestroyStubObject(MediaServerManager::AVMETADATAHELPER, AsObject());
     return MSERR_OK;
 }
@@ -133,6 +140,50 @@ std::shared_ptr<AVSharedMemory> AVMetadataHelperServiceStub::FetchFrameAtTime(in
     return avMetadateHelperServer_->FetchFrameAtTime(timeUs, option, param);
 }
 
+int32_t AVMetadataHelperServiceStub::PrepareFetchFrames(const std::vector<int64_t> &timesUs,
+    int32_t option, const OutputConfiguration &param)
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadateHelperServer_ != nullptr, MSERR_NO_MEMORY, "avmetadatahelper server is nullptr");
+    return avMetadateHelperServer_->PrepareFetchFrames(timesUs, option, param);
+}
+
+std::shared_ptr<AVSharedMemory> AVMetadataHelperServiceStub::FetchNextFrame(int64_t &timeUs)
+{
+    timeUs = -1;
+    CHECK_AND_RETURN_RET_LOG(avMetadateHelperServer_ != nullptr, nullptr, "avmetadatahelper server is nullptr");
+    return avMetadateHelperServer_->FetchNextFrame(timeUs);
+}
+
+int32_t AVMetadataHelperServiceStub::SetListenerObject(const sptr<IRemoteObject> &object)
+{
+    CHECK_AND_RETURN_RET_LOG(object != nullptr, MSERR_NO_MEMORY, "set listener object is nullptr");
+
+    sptr<IStandardAVMetadataHelperListener> listener = iface_cast<IStandardAVMetadataHelperListener>(object);
+    CHECK_AND_RETURN_RET_LOG(listener != nullptr, MSERR_NO_MEMORY,
+        "failed to convert IStandardAVMetadataHelperListener");
+
+    std::shared_ptr<AVMetadataBatchServiceCallback> callback =
+        std::make_shared<AVMetadataHelperListenerCallback>(listener);
+    CHECK_AND_RETURN_RET_LOG(callback != nullptr, MSERR_NO_MEMORY, "failed to new AVMetadataHelperListenerCallback");
+
+    batchCallback_ = callback;
+    return MSERR_OK;
+}
+
+int32_t AVMetadataHelperServiceStub::ResolveMetadataBatch(const std::vector<AVMetadataBatchSource> &sources,
+    const AVMetadataBatchConfig &config)
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadateHelperServer_ != nullptr, MSERR_NO_MEMORY, "avmetadatahelper server is nullptr");
+    CHECK_AND_RETURN_RET_LOG(batchCallback_ != nullptr, MSERR_INVALID_OPERATION, "listener object is not set");
+    return avMetadateHelperServer_->ResolveMetadataBatch(sources, config, batchCallback_);
+}
+
+int32_t AVMetadataHelperServiceStub::CancelBatch()
+{
+    CHECK_AND_RETURN_RET_LOG(avMetadateHelperServer_ != nullptr, MSERR_NO_MEMORY, "avmetadatahelper server is nullptr");
+    return avMetadateHelperServer_->CancelBatch();
+}
+
 void AVMetadataHelperServiceStub::Release()
 {
     CHECK_AND_RETURN_LOG(avMetadateHelperServer_ != nullptr, "avmetadatahelper server is nullptr");
@@ -204,6 +255,82 @@ int32_t AVMetadataHelperServiceStub::FetchFrameAtTime(MessageParcel &data, Messa
     return WriteAVSharedMemoryToParcel(ashMem, reply);
 }
 
+int32_t AVMetadataHelperServiceStub::PrepareFetchFrames(MessageParcel &data, MessageParcel &reply)
+{
+    std::vector<int64_t> timesUs;
+    (void)data.ReadInt64Vector(&timesUs);
+    int32_t option = data.ReadInt32();
+    OutputConfiguration param = {data.ReadInt32(), data.ReadInt32(), static_cast<PixelFormat>(data.ReadInt32())};
+    reply.WriteInt32(PrepareFetchFrames(timesUs, option, param));
+    return MSERR_OK;
+}
+
+int32_t AVMetadataHelperServiceStub::FetchNextFrame(MessageParcel &data, MessageParcel &reply)
+{
+    (void)data;
+    int64_t timeUs = -1;
+    std::shared_ptr<AVSharedMemory> ashMem = FetchNextFrame(timeUs);
+
+    reply.WriteInt64(timeUs);
+    reply.WriteBool(ashMem != nullptr);
+    if (ashMem == nullptr) {
+        return MSERR_OK;
+    }
+    return WriteAVSharedMemoryToParcel(ashMem, reply);
+}
+
+int32_t AVMetadataHelperServiceStub::SetListenerObject(MessageParcel &data, MessageParcel &reply)
+{
+    sptr<IRemoteObject> object = data.ReadRemoteObject();
+    reply.WriteInt32(SetListenerObject(object));
+    return MSERR_OK;
+}
+
+int32_t AVMetadataHelperServiceStub::ResolveMetadataBatch(MessageParcel &data, MessageParcel &reply)
+{
+    uint32_t count = data.ReadUint32();
+    if (count == 0 || count > MAX_BATCH_SOURCES_NUM) {
+        MEDIA_LOGE("invalid sources count: %{public}u", count);
+        reply.WriteInt32(MSERR_INVALID_VAL);
+        return MSERR_OK;
+    }
+
+    std::vector<AVMetadataBatchSource> sources(count);
+    for (size_t i = 0; i < sources.size(); i++) {
+        AVMetadataBatchSource &source = sources[i];
+        // a negative fd is kept, so that the source is reported as failed at its own index
+        source.fd = data.ReadFileDescriptor();
+        if (source.fd < 0) {
+            MEDIA_LOGE("invalid fd of source %{public}zu", i);
+            source.fd = -1;
+        }
+        source.offset = data.ReadInt64();
+        source.size = data.ReadInt64();
+    }
+    AVMetadataBatchConfig config;
+    (void)data.ReadInt32Vector(&config.keys);
+    config.fetchThumbnail = data.ReadBool();
+    config.thumbnailTimeUs = data.ReadInt64();
+    config.thumbnailOption = data.ReadInt32();
+    config.thumbnailConfig = {data.ReadInt32(), data.ReadInt32(), static_cast<PixelFormat>(data.ReadInt32())};
+
+    reply.WriteInt32(ResolveMetadataBatch(sources, config));
+    // the server holds its own duplicates of the fds
+    for (auto &source : sources) {
+        if (source.fd >= 0) {
+            (void)::close(source.fd);
+        }
+    }
+    return MSERR_OK;
+}
+
+int32_t AVMetadataHelperServiceStub::CancelBatch(MessageParcel &data, MessageParcel &reply)
+{
+    (void)data;
+    reply.WriteInt32(CancelBatch());
+    return MSERR_OK;
+}
+
 int32_t AVMetadataHelperServiceStub::Release(MessageParcel &data, MessageParcel &reply)
 {
     (void)data;
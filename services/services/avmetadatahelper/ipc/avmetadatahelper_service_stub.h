@@ -36,6 +36,13 @@ public:
     std::shared_ptr<AVSharedMemory> FetchArtPicture() override;
     std::shared_ptr<AVSharedMemory> FetchFrameAtTime(int64_t timeUs,
         int32_t option, const OutputConfiguration &param) override;
+    int32_t PrepareFetchFrames(const std::vector<int64_t> &timesUs,
+        int32_t option, const OutputConfiguration &param) override;
+    std::shared_ptr<AVSharedMemory> FetchNextFrame(int64_t &timeUs) override;
+    int32_t SetListenerObject(const sptr<IRemoteObject> &object) override;
+    int32_t ResolveMetadataBatch(const std::vector<AVMetadataBatchSource> &sources,
+        const AVMetadataBatchConfig &config) override;
+    int32_t CancelBatch() override;
     void Release() override;
     int32_t DestroyStub() override;
 
@@ -48,11 +55,17 @@ private:
     int32_t ResolveMetadataMap(MessageParcel &data, MessageParcel &reply);
     int32_t FetchArtPicture(MessageParcel &data, MessageParcel &reply);
     int32_t FetchFrameAtTime(MessageParcel &data, MessageParcel &reply);
+    int32_t PrepareFetchFrames(MessageParcel &data, MessageParcel &reply);
+    int32_t FetchNextFrame(MessageParcel &data, MessageParcel &reply);
+    int32_t SetListenerObject(MessageParcel &data, MessageParcel &reply);
+    int32_t ResolveMetadataBatch(MessageParcel &data, MessageParcel &reply);
+    int32_t CancelBatch(MessageParcel &data, MessageParcel &reply);
     int32_t Release(MessageParcel &data, MessageParcel &reply);
     int32_t DestroyStub(MessageParcel &data, MessageParcel &reply);
 
     std::mutex mutex_;
     std::shared_ptr<IAVMetadataHelperService> avMetadateHelperServer_ = nullptr;
+    std::shared_ptr<AVMetadataBatchServiceCallback> batchCallback_ = nullptr;
     using AVMetadataHelperStubFunc = int32_t(AVMetadataHelperServiceStub::*)(MessageParcel &data, MessageParcel &reply);
     std::map<uint32_t, AVMetadataHelperStubFunc> avMetadataHelperFuncs_;
 };
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef I_STANDARD_AVMETADATAHELPER_LISTENER_H
+#define I_STANDARD_AVMETADATAHELPER_LISTENER_H
+
+#include "ipc_types.h"
+#include "iremote_broker.h"
+#include "iremote_proxy.h"
+#include "iremote_stub.h"
+#include "i_avmetadatahelper_service.h"
+
+namespace OHOS {
+namespace Media {
+class IStandardAVMetadataHelperListener : public IRemoteBroker {
+public:
+    virtual ~IStandardAVMetadataHelperListener() = default;
+    virtual void OnBatchResult(int32_t index, int32_t errCode, const std::unordered_map<int32_t, std::string> &metadata,
+        const std::shared_ptr<AVSharedMemory> &thumbnail) = 0;
+    virtual void OnBatchFinished(int32_t errCode) = 0;
+
+    /**
+     * IPC code ID
+     */
+    enum AVMetadataHelperListenerMsg {
+        ON_BATCH_RESULT = 0,
+        ON_BATCH_FINISHED,
+    };
+
+    DECLARE_INTERFACE_DESCRIPTOR(u"IStandardAVMetadataHelperListener");
+};
+} // namespace Media
+} // namespace OHOS
+#endif // I_STANDARD_AVMETADATAHELPER_LISTENER_H
@@ -35,6 +35,13 @@ public:
     virtual std::shared_ptr<AVSharedMemory> FetchArtPicture() = 0;
     virtual std::shared_ptr<AVSharedMemory> FetchFrameAtTime(
         int64_t timeUs, int32_t option, const OutputConfiguration &param) = 0;
+    virtual int32_t PrepareFetchFrames(
+        const std::vector<int64_t> &timesUs, int32_t option, const OutputConfiguration &param) = 0;
+    virtual std::shared_ptr<AVSharedMemory> FetchNextFrame(int64_t &timeUs) = 0;
+    virtual int32_t SetListenerObject(const sptr<IRemoteObject> &object) = 0;
+    virtual int32_t ResolveMetadataBatch(const std::vector<AVMetadataBatchSource> &sources,
+        const AVMetadataBatchConfig &config) = 0;
+    virtual int32_t CancelBatch() = 0;
     virtual void Release() = 0;
     virtual int32_t DestroyStub() = 0;
 
@@ -50,6 +57,11 @@ public:
         FETCH_FRAME_AT_TIME,
         RELEASE,
         DESTROY,
+        PREPARE_FETCH_FRAMES,
+        FETCH_NEXT_FRAME,
+        SET_LISTENER_OBJ,
+        RESOLVE_METADATA_BATCH,
+        CANCEL_BATCH,
     };
 
     DECLARE_INTERFACE_DESCRIPTOR(u"IStandardAVMetadataHelperService");
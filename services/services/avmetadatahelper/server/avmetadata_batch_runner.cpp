@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmetadata_batch_runner.h"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <pthread.h>
+#include <unistd.h>
+#include "engine_factory_repo.h"
+#include "media_dfx.h"
+#include "media_log.h"
+#include "media_metrics.h"
+
+namespace {
+constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMetadataBatchRunner"};
+constexpr uint32_t MIN_BATCH_WORKERS = 1;
+// more pipelines at once only contend for the storage and the decoders
+constexpr uint32_t MAX_BATCH_WORKERS = 8;
+// 16: the batch workers take at most 1/16 of the physical memory in total
+constexpr uint64_t BATCH_MEMORY_RATIO = 16;
+constexpr uint64_t DEFAULT_BATCH_MEMORY_BUDGET = 128 * 1024 * 1024;
+// the estimated peak memory of a pipeline resolving only the metadata, mostly the demuxer buffers
+constexpr uint64_t META_SOURCE_COST = 8 * 1024 * 1024;
+// the decoder buffers and the converted frame dominate when a thumbnail is fetched
+constexpr uint64_t THUMBNAIL_SOURCE_COST = 48 * 1024 * 1024;
+
+class AVMetadataBatchBudget {
+public:
+    static AVMetadataBatchBudget &GetInstance()
+    {
+        // never destroyed: the workers of a reaped batch may still be running when static destructors run
+        static AVMetadataBatchBudget *instance = new AVMetadataBatchBudget();
+        return *instance;
+    }
+
+    uint32_t GetMaxWorkers() const
+    {
+        return maxWorkers_;
+    }
+
+    // returns false if cancelled while waiting
+    bool Acquire(uint64_t cost, const std::atomic<bool> &cancelled)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this, cost, &cancelled]() { return cancelled.load() || CanAcquireLocked(cost); });
+        if (cancelled.load()) {
+            return false;
+        }
+        workers_++;
+        usedMemory_ += cost;
+        return true;
+    }
+
+    void Release(uint64_t cost)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        workers_--;
+        usedMemory_ -= cost;
+        cond_.notify_all();
+    }
+
+    void Wakeup()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cond_.notify_all();
+    }
+
+private:
+    AVMetadataBatchBudget()
+    {
+        maxWorkers_ = std::clamp(std::thread::hardware_concurrency(), MIN_BATCH_WORKERS, MAX_BATCH_WORKERS);
+        long pages = sysconf(_SC_PHYS_PAGES);
+        long pageSize = sysconf(_SC_PAGESIZE);
+        if (pages > 0 && pageSize > 0) {
+            memoryBudget_ = static_cast<uint64_t>(pages) * static_cast<uint64_t>(pageSize) / BATCH_MEMORY_RATIO;
+        }
+    }
+
+    // one worker is always allowed, or a batch could never make progress on a small device
+    bool CanAcquireLocked(uint64_t cost) const
+    {
+        return workers_ == 0 || (workers_ < maxWorkers_ && usedMemory_ + cost <= memoryBudget_);
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    uint32_t maxWorkers_ = MIN_BATCH_WORKERS;
+    uint64_t memoryBudget_ = DEFAULT_BATCH_MEMORY_BUDGET;
+    uint32_t workers_ = 0;
+    uint64_t usedMemory_ = 0;
+};
+}
+
+namespace OHOS {
+namespace Media {
+AVMetadataBatchRunner::AVMetadataBatchRunner(const AVMetadataBatchConfig &config,
+    const std::shared_ptr<AVMetadataBatchServiceCallback> &callback)
+    : config_(config), callback_(callback)
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVMetadataBatchRunner::~AVMetadataBatchRunner()
+{
+    Cancel();
+    for (auto &worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+void AVMetadataBatchRunner::AddSource(const AVMetadataBatchSource &source)
+{
+    Source item;
+    // the caller closes its fd once the batch is submitted, the workers read through a duplicate
+    int32_t fd = (source.fd >= 0) ? ::dup(source.fd) : -1;
+    if (fd < 0) {
+        MEDIA_LOGE("failed to dup the fd of source %{public}zu, errno: %{public}d", sources_.size(), errno);
+        item.errCode = MSERR_INVALID_VAL;
+        sources_.push_back(std::move(item));
+        return;
+    }
+    // the uri helper holds its own duplicate since then
+    item.uriHelper = std::make_unique<UriHelper>(fd, source.offset, source.size);
+    (void)::close(fd);
+    if (!item.uriHelper->AccessCheck(UriHelper::URI_READ)) {
+        MEDIA_LOGE("failed to read the fd of source %{public}zu", sources_.size());
+        item.errCode = MSERR_INVALID_VAL;
+        item.uriHelper = nullptr;
+    } else {
+        item.engineFactory = EngineFactoryRepo::Instance().GetEngineFactory(
+            IEngineFactory::Scene::SCENE_AVMETADATA, item.uriHelper->FormattedUri());
+        if (item.engineFactory == nullptr) {
+            item.errCode = MSERR_CREATE_AVMETADATAHELPER_ENGINE_FAILED;
+            item.uriHelper = nullptr;
+        }
+    }
+    sources_.push_back(std::move(item));
+}
+
+int32_t AVMetadataBatchRunner::Start()
+{
+    CHECK_AND_RETURN_RET_LOG(!sources_.empty() && workers_.empty(), MSERR_INVALID_OPERATION, "nothing to start");
+
+    uint32_t count = std::min(static_cast<uint32_t>(sources_.size()),
+        AVMetadataBatchBudget::GetInstance().GetMaxWorkers());
+    MEDIA_LOGI("start the batch of %{public}zu sources on %{public}u workers", sources_.size(), count);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        runningWorkers_ = count;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        workers_.emplace_back(&AVMetadataBatchRunner::WorkerLoop, this);
+    }
+    return MSERR_OK;
+}
+
+void AVMetadataBatchRunner::Cancel()
+{
+    {
+        // also waits for the result being delivered, if any
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+    }
+    AVMetadataBatchBudget::GetInstance().Wakeup();
+}
+
+bool AVMetadataBatchRunner::IsFinished()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return finished_;
+}
+
+void AVMetadataBatchRunner::Reap(std::unique_ptr<AVMetadataBatchRunner> runner)
+{
+    CHECK_AND_RETURN(runner != nullptr);
+    runner->Cancel();
+    if (runner->workers_.empty() || runner->IsFinished()) {
+        // the workers are leaving, the join does not wait for any source
+        runner = nullptr;
+        return;
+    }
+
+    std::thread reaper([batch = std::move(runner)]() mutable {
+        (void)pthread_setname_np(pthread_self(), "AVMetaReaper");
+        batch = nullptr;
+    });
+    reaper.detach();
+}
+
+void AVMetadataBatchRunner::WorkerLoop()
+{
+    (void)pthread_setname_np(pthread_self(), "AVMetaBatch");
+    AVMetadataBatchBudget &budget = AVMetadataBatchBudget::GetInstance();
+    uint64_t cost = config_.fetchThumbnail ? THUMBNAIL_SOURCE_COST : META_SOURCE_COST;
+
+    while (!cancelled_.load()) {
+        size_t index = nextSource_.fetch_add(1);
+        if (index >= sources_.size() || !budget.Acquire(cost, cancelled_)) {
+            break;
+        }
+
+        std::unordered_map<int32_t, std::string> metadata;
+        std::shared_ptr<AVSharedMemory> thumbnail = nullptr;
+        int32_t ret = Resolve(sources_[index], metadata, thumbnail);
+        budget.Release(cost);
+        // only this worker touches the source, close its fd as early as possible
+        sources_[index].uriHelper = nullptr;
+
+        Report(static_cast<int32_t>(index), ret, metadata, thumbnail);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    runningWorkers_--;
+    if (runningWorkers_ == 0) {
+        finished_ = true;
+        callback_->OnBatchFinished(cancelled_.load() ? MSERR_INVALID_STATE : MSERR_OK);
+    }
+}
+
+int32_t AVMetadataBatchRunner::Resolve(const Source &source, std::unordered_map<int32_t, std::string> &metadata,
+    std::shared_ptr<AVSharedMemory> &thumbnail)
+{
+    CHECK_AND_RETURN_RET(source.errCode == MSERR_OK, source.errCode);
+    MediaTrace trace("AVMetadataBatchRunner::Resolve");
+    METRICS_AUTO_LATENCY("avmeta.batch.source");
+
+    std::shared_ptr<IAVMetadataHelperEngine> engine = source.engineFactory->CreateAVMetadataHelperEngine();
+    CHECK_AND_RETURN_RET_LOG(engine != nullptr, MSERR_CREATE_AVMETADATAHELPER_ENGINE_FAILED,
+        "Failed to create avmetadatahelper engine");
+
+    int32_t usage = config_.fetchThumbnail ? AV_META_USAGE_PIXEL_MAP : AV_META_USAGE_META_ONLY;
+    int32_t ret = engine->SetSource(source.uriHelper->FormattedUri(), usage);
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "SetSource failed!");
+
+    std::unordered_map<int32_t, std::string> allMeta = engine->ResolveMetadata();
+    if (config_.keys.empty()) {
+        metadata.swap(allMeta);
+    } else {
+        for (int32_t key : config_.keys) {
+            auto it = allMeta.find(key);
+            if (it != allMeta.end()) {
+                metadata.emplace(key, it->second);
+            }
+        }
+    }
+
+    if (config_.fetchThumbnail) {
+        std::string hasVideo = engine->ResolveMetadata(AV_KEY_HAS_VIDEO);
+        if (hasVideo == "yes") {
+            thumbnail = engine->FetchFrameAtTime(config_.thumbnailTimeUs, config_.thumbnailOption,
+                config_.thumbnailConfig);
+        }
+    }
+    return MSERR_OK;
+}
+
+void AVMetadataBatchRunner::Report(int32_t index, int32_t errCode,
+    const std::unordered_map<int32_t, std::string> &metadata, const std::shared_ptr<AVSharedMemory> &thumbnail)
+{
+    if (errCode == MSERR_OK) {
+        METRICS_COUNTER_ADD("avmeta.batch.resolved", 1);
+    } else {
+        METRICS_COUNTER_ADD("avmeta.batch.failed", 1);
+        MEDIA_LOGW("failed to resolve source %{public}d, error: %{public}d", index, errCode);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cancelled_.load()) {
+        return;
+    }
+    callback_->OnBatchResult(index, errCode, metadata, thumbnail);
+}
+} // namespace Media
+} // namespace OHOS
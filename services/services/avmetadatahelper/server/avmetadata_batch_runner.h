@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETADATA_BATCH_RUNNER_H
+#define AVMETADATA_BATCH_RUNNER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "i_avmetadatahelper_service.h"
+#include "i_engine_factory.h"
+#include "media_errors.h"
+#include "nocopyable.h"
+#include "uri_helper.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * Resolve a batch of sources on a group of worker threads, each source with its own engine, and
+ * deliver the results as soon as each source completes.
+ *
+ * The workers of all batches in the process share one budget, bounded by the cores and by a share
+ * of the physical memory, so the concurrent batches do not multiply the pipelines running at once.
+ */
+class AVMetadataBatchRunner : public NoCopyable {
+public:
+    AVMetadataBatchRunner(const AVMetadataBatchConfig &config,
+        const std::shared_ptr<AVMetadataBatchServiceCallback> &callback);
+    ~AVMetadataBatchRunner();
+
+    /**
+     * The fd is duplicated, a source which can not be read is reported as failed when it is reached.
+     */
+    void AddSource(const AVMetadataBatchSource &source);
+    int32_t Start();
+    /**
+     * No result is delivered after it returns, the sources being resolved are left to finish.
+     */
+    void Cancel();
+    bool IsFinished();
+    /**
+     * Cancel the batch and destroy the runner on a detached thread. A source being resolved is not
+     * interrupted and may take the prepare timeout of its engine, the caller does not wait for it.
+     */
+    static void Reap(std::unique_ptr<AVMetadataBatchRunner> runner);
+
+private:
+    struct Source {
+        int32_t errCode = MSERR_OK;
+        std::unique_ptr<UriHelper> uriHelper;
+        std::shared_ptr<IEngineFactory> engineFactory;
+    };
+    void WorkerLoop();
+    int32_t Resolve(const Source &source, std::unordered_map<int32_t, std::string> &metadata,
+        std::shared_ptr<AVSharedMemory> &thumbnail);
+    void Report(int32_t index, int32_t errCode, const std::unordered_map<int32_t, std::string> &metadata,
+        const std::shared_ptr<AVSharedMemory> &thumbnail);
+
+    AVMetadataBatchConfig config_;
+    std::shared_ptr<AVMetadataBatchServiceCallback> callback_;
+    std::vector<Source> sources_;
+    std::atomic<size_t> nextSource_ = 0;
+    std::atomic<bool> cancelled_ = false;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    uint32_t runningWorkers_ = 0;
+    bool finished_ = false;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMETADATA_BATCH_RUNNER_H
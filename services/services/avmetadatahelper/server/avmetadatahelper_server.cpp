@@ -42,6 +42,7 @@ AVMetadataHelperServer::~AVMetadataHelperServer()
 {
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
     std::lock_guard<std::mutex> lock(mutex_);
+    AVMetadataBatchRunner::Reap(std::move(batchRunner_));
     avMetadataHelperEngine_ = nullptr;
     uriHelper_ = nullptr;
 }
@@ -130,10 +131,67 @@ std::shared_ptr<AVSharedMemory> AVMetadataHelperServer::FetchFrameAtTime(int64_t
     return avMetadataHelperEngine_->FetchFrameAtTime(timeUs, option, param);
 }
 
+int32_t AVMetadataHelperServer::PrepareFetchFrames(const std::vector<int64_t> &timesUs, int32_t option,
+    const OutputConfiguration &param)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    MediaTrace trace("AVMetadataHelperServer::PrepareFetchFrames");
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperEngine_ != nullptr, MSERR_NO_MEMORY,
+        "avMetadataHelperEngine_ is nullptr");
+    CHECK_AND_RETURN_RET_LOG(!timesUs.empty() && timesUs.size() <= MAX_FETCH_FRAMES_NUM, MSERR_INVALID_VAL,
+        "invalid frames count: %{public}zu", timesUs.size());
+    return avMetadataHelperEngine_->PrepareFetchFrames(timesUs, option, param);
+}
+
+std::shared_ptr<AVSharedMemory> AVMetadataHelperServer::FetchNextFrame(int64_t &timeUs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    MediaTrace trace("AVMetadataHelperServer::FetchNextFrame");
+    timeUs = -1;
+    CHECK_AND_RETURN_RET_LOG(avMetadataHelperEngine_ != nullptr, nullptr, "avMetadataHelperEngine_ is nullptr");
+    return avMetadataHelperEngine_->FetchNextFrame(timeUs);
+}
+
+int32_t AVMetadataHelperServer::ResolveMetadataBatch(const std::vector<AVMetadataBatchSource> &sources,
+    const AVMetadataBatchConfig &config, const std::shared_ptr<AVMetadataBatchServiceCallback> &callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    MediaTrace trace("AVMetadataHelperServer::ResolveMetadataBatch");
+    CHECK_AND_RETURN_RET_LOG(callback != nullptr, MSERR_INVALID_VAL, "callback is nullptr");
+    CHECK_AND_RETURN_RET_LOG(!sources.empty() && sources.size() <= MAX_BATCH_SOURCES_NUM, MSERR_INVALID_VAL,
+        "invalid sources count: %{public}zu", sources.size());
+    CHECK_AND_RETURN_RET_LOG(batchRunner_ == nullptr || batchRunner_->IsFinished(), MSERR_INVALID_STATE,
+        "the previous batch is in progress");
+
+    batchRunner_ = nullptr;
+    auto runner = std::make_unique<AVMetadataBatchRunner>(config, callback);
+    CHECK_AND_RETURN_RET_LOG(runner != nullptr, MSERR_NO_MEMORY, "Failed to new AVMetadataBatchRunner");
+    for (auto &source : sources) {
+        runner->AddSource(source);
+    }
+    int32_t ret = runner->Start();
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Failed to start the batch");
+
+    batchRunner_ = std::move(runner);
+    return MSERR_OK;
+}
+
+int32_t AVMetadataHelperServer::CancelBatch()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    MediaTrace trace("AVMetadataHelperServer::CancelBatch");
+    if (batchRunner_ != nullptr) {
+        batchRunner_->Cancel();
+    }
+    return MSERR_OK;
+}
+
 void AVMetadataHelperServer::Release()
 {
     std::lock_guard<std::mutex> lock(mutex_);
     MediaTrace trace("AVMetadataHelperServer::Release");
+    // the binder thread does not wait for the sources being resolved
+    AVMetadataBatchRunner::Reap(std::move(batchRunner_));
     avMetadataHelperEngine_ = nullptr;
     uriHelper_ = nullptr;
 }
@@ -19,6 +19,7 @@
 #include <mutex>
 #include "i_avmetadatahelper_service.h"
 #include "i_avmetadatahelper_engine.h"
+#include "avmetadata_batch_runner.h"
 #include "nocopyable.h"
 #include "uri_helper.h"
 
@@ -37,11 +38,18 @@ public:
     std::shared_ptr<AVSharedMemory> FetchArtPicture() override;
     std::shared_ptr<AVSharedMemory> FetchFrameAtTime(int64_t timeUs,
         int32_t option, const OutputConfiguration &param) override;
+    int32_t PrepareFetchFrames(const std::vector<int64_t> &timesUs,
+        int32_t option, const OutputConfiguration &param) override;
+    std::shared_ptr<AVSharedMemory> FetchNextFrame(int64_t &timeUs) override;
+    int32_t ResolveMetadataBatch(const std::vector<AVMetadataBatchSource> &sources,
+        const AVMetadataBatchConfig &config, const std::shared_ptr<AVMetadataBatchServiceCallback> &callback) override;
+    int32_t CancelBatch() override;
     void Release() override;
 private:
     std::shared_ptr<IAVMetadataHelperEngine> avMetadataHelperEngine_ = nullptr;
     std::mutex mutex_;
     std::unique_ptr<UriHelper> uriHelper_;
+    std::unique_ptr<AVMetadataBatchRunner> batchRunner_;
 };
 } // namespace Media
 } // namespace OHOS
@@ -0,0 +1,331 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmuxer_sample_channel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include "securec.h"
+#include "avsharedmemory_ipc.h"
+#include "avsharedmemorybase.h"
+#include "media_errors.h"
+#include "media_log.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMuxerSampleChannel"};
+    constexpr int32_t SAMPLE_BLOCK_SIZE = 512 * 1024;
+    constexpr int32_t MAX_SAMPLE_SIZE = 64 * 1024 * 1024;
+    constexpr int32_t SAMPLE_ALIGN = 16;
+
+    int32_t AlignUp(int32_t size)
+    {
+        return (size + SAMPLE_ALIGN - 1) & ~(SAMPLE_ALIGN - 1);
+    }
+}
+
+namespace OHOS {
+namespace Media {
+struct AVMuxerSampleChannel::ChannelHeader {
+    // the samples received by the consumer, including the failed ones
+    std::atomic<uint32_t> received = 0;
+    // the first error of the one-way writes, cleared by the producer
+    std::atomic<int32_t> asyncError = MSERR_OK;
+    // the samples released by the consumer for every block
+    std::atomic<uint32_t> released[MAX_SAMPLE_BLOCKS] = {};
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "channel header is shared between processes");
+static_assert(std::atomic<int32_t>::is_always_lock_free, "channel header is shared between processes");
+
+enum CacheFlag : uint8_t {
+    HIT_CACHE = 1,
+    UPDATE_CACHE,
+};
+
+class AVMuxerSampleChannel::SampleMemory : public AVSharedMemory, public NoCopyable {
+public:
+    SampleMemory(const std::shared_ptr<AVMuxerSampleChannel> &channel, const std::shared_ptr<AVSharedMemory> &block,
+        uint32_t index, int32_t offset, int32_t size)
+        : channel_(channel), block_(block), index_(index), offset_(offset), size_(size)
+    {
+    }
+
+    ~SampleMemory()
+    {
+        channel_->OnSampleReleased(index_);
+    }
+
+    uint8_t *GetBase() const override
+    {
+        return block_->GetBase() + offset_;
+    }
+
+    int32_t GetSize() const override
+    {
+        return size_;
+    }
+
+    uint32_t GetFlags() const override
+    {
+        return block_->GetFlags();
+    }
+
+private:
+    std::shared_ptr<AVMuxerSampleChannel> channel_;
+    std::shared_ptr<AVSharedMemory> block_;
+    uint32_t index_;
+    int32_t offset_;
+    int32_t size_;
+};
+
+std::shared_ptr<AVMuxerSampleChannel> AVMuxerSampleChannel::Create()
+{
+    auto control = AVSharedMemoryBase::CreateFromLocal(static_cast<int32_t>(sizeof(ChannelHeader)),
+        AVSharedMemory::FLAGS_READ_WRITE, "AVMuxerSampleChannel");
+    CHECK_AND_RETURN_RET_LOG(control != nullptr, nullptr, "failed to create channel memory");
+
+    auto channel = std::make_shared<AVMuxerSampleChannel>(control);
+    CHECK_AND_RETURN_RET_LOG(channel != nullptr, nullptr, "failed to new AVMuxerSampleChannel");
+    CHECK_AND_RETURN_RET(channel->Init() == MSERR_OK, nullptr);
+
+    // the memory is only visible to this process now, construct the header in place.
+    channel->header_ = new (channel->control_->GetBase()) ChannelHeader();
+    return channel;
+}
+
+std::shared_ptr<AVMuxerSampleChannel> AVMuxerSampleChannel::CreateFromParcel(MessageParcel &parcel)
+{
+    auto control = ReadAVSharedMemoryFromParcel(parcel);
+    CHECK_AND_RETURN_RET_LOG(control != nullptr, nullptr, "failed to read channel memory");
+
+    auto channel = std::make_shared<AVMuxerSampleChannel>(control);
+    CHECK_AND_RETURN_RET_LOG(channel != nullptr, nullptr, "failed to new AVMuxerSampleChannel");
+    CHECK_AND_RETURN_RET(channel->Init() == MSERR_OK, nullptr);
+    return channel;
+}
+
+AVMuxerSampleChannel::AVMuxerSampleChannel(const std::shared_ptr<AVSharedMemory> &control)
+    : control_(control)
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVMuxerSampleChannel::~AVMuxerSampleChannel()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+int32_t AVMuxerSampleChannel::Init()
+{
+    CHECK_AND_RETURN_RET(control_ != nullptr && control_->GetBase() != nullptr, MSERR_INVALID_VAL);
+    int32_t size = control_->GetSize();
+    CHECK_AND_RETURN_RET_LOG(size >= static_cast<int32_t>(sizeof(ChannelHeader)), MSERR_INVALID_VAL,
+        "channel memory is too small: %{public}d", size);
+
+    header_ = reinterpret_cast<ChannelHeader *>(control_->GetBase());
+    return MSERR_OK;
+}
+
+int32_t AVMuxerSampleChannel::WriteToParcel(MessageParcel &parcel) const
+{
+    return WriteAVSharedMemoryToParcel(control_, parcel);
+}
+
+bool AVMuxerSampleChannel::IsDrained(uint32_t index) const
+{
+    return header_->released[index].load(std::memory_order_acquire) == blocks_[index].submitted;
+}
+
+int32_t AVMuxerSampleChannel::AcquireSpace(int32_t size, uint32_t &index, int32_t &offset)
+{
+    SampleBlock &current = blocks_[current_];
+    if (current.memory != nullptr && IsDrained(current_)) {
+        current.used = 0;
+    }
+    if (current.memory != nullptr && current.memory->GetSize() - current.used >= size) {
+        index = current_;
+        offset = current.used;
+        return MSERR_OK;
+    }
+
+    // move to the next drained block, the blocks in use are kept for the samples held by the consumer.
+    for (uint32_t i = 1; i <= MAX_SAMPLE_BLOCKS; i++) {
+        uint32_t next = (current_ + i) % MAX_SAMPLE_BLOCKS;
+        if (!IsDrained(next)) {
+            continue;
+        }
+        SampleBlock &block = blocks_[next];
+        block.used = 0;
+        if (block.memory == nullptr || block.memory->GetSize() < size) {
+            int32_t blockSize = std::max(SAMPLE_BLOCK_SIZE, AlignUp(size));
+            auto memory = AVSharedMemoryBase::CreateFromLocal(blockSize,
+                AVSharedMemory::FLAGS_READ_ONLY, "AVMuxerSampleBlock");
+            CHECK_AND_RETURN_RET_LOG(memory != nullptr, MSERR_NO_MEMORY, "failed to create sample block");
+            block.memory = memory;
+            block.cached = false;
+        }
+        current_ = next;
+        index = next;
+        offset = 0;
+        return MSERR_OK;
+    }
+    return MSERR_NO_MEMORY;
+}
+
+int32_t AVMuxerSampleChannel::WriteSample(const uint8_t *data, int32_t size, MessageParcel &parcel)
+{
+    CHECK_AND_RETURN_RET_LOG(size >= 0 && (data != nullptr || size == 0), MSERR_INVALID_VAL, "invalid sample");
+    CHECK_AND_RETURN_RET_LOG(size <= MAX_SAMPLE_SIZE, MSERR_NO_MEMORY, "sample is too large: %{public}d", size);
+
+    uint32_t index = MAX_SAMPLE_BLOCKS;
+    int32_t offset = 0;
+    int32_t ret = AcquireSpace(size, index, offset);
+    if (ret != MSERR_OK) {
+        return ret;
+    }
+
+    SampleBlock &block = blocks_[index];
+    if (size > 0) {
+        errno_t rc = memcpy_s(block.memory->GetBase() + offset, static_cast<size_t>(block.memory->GetSize() - offset),
+            data, static_cast<size_t>(size));
+        CHECK_AND_RETURN_RET_LOG(rc == EOK, MSERR_UNKNOWN, "memcpy_s failed");
+    }
+
+    CHECK_AND_RETURN_RET(parcel.WriteUint32(index), MSERR_UNKNOWN);
+    if (block.cached) {
+        CHECK_AND_RETURN_RET(parcel.WriteUint8(HIT_CACHE), MSERR_UNKNOWN);
+    } else {
+        CHECK_AND_RETURN_RET(parcel.WriteUint8(UPDATE_CACHE), MSERR_UNKNOWN);
+        CHECK_AND_RETURN_RET(WriteAVSharedMemoryToParcel(block.memory, parcel) == MSERR_OK, MSERR_UNKNOWN);
+    }
+    CHECK_AND_RETURN_RET(parcel.WriteInt32(offset), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(parcel.WriteInt32(size), MSERR_UNKNOWN);
+
+    pending_ = { index, offset, size };
+    return MSERR_OK;
+}
+
+void AVMuxerSampleChannel::CommitSample()
+{
+    CHECK_AND_RETURN(pending_.index < MAX_SAMPLE_BLOCKS);
+    SampleBlock &block = blocks_[pending_.index];
+    block.used = std::min(block.memory->GetSize(), pending_.offset + AlignUp(pending_.size));
+    block.submitted++;
+    block.cached = true;
+    committed_++;
+    pending_ = PendingSample();
+}
+
+bool AVMuxerSampleChannel::WriteSyncPoint(MessageParcel &parcel, bool waitCredit)
+{
+    uint32_t index = MAX_SAMPLE_BLOCKS;
+    uint32_t released = 0;
+    if (waitCredit) {
+        // the block next to the current one is the oldest in the round robin.
+        index = (current_ + 1) % MAX_SAMPLE_BLOCKS;
+        released = blocks_[index].submitted;
+    }
+    if (header_->received.load(std::memory_order_acquire) == committed_ &&
+        (index == MAX_SAMPLE_BLOCKS || IsDrained(index))) {
+        return false;
+    }
+
+    (void)parcel.WriteUint32(committed_);
+    (void)parcel.WriteUint32(index);
+    (void)parcel.WriteUint32(released);
+    return true;
+}
+
+int32_t AVMuxerSampleChannel::TakeAsyncError()
+{
+    return header_->asyncError.exchange(MSERR_OK, std::memory_order_acq_rel);
+}
+
+std::shared_ptr<AVSharedMemory> AVMuxerSampleChannel::ReadSample(MessageParcel &parcel)
+{
+    uint32_t index = parcel.ReadUint32();
+    CHECK_AND_RETURN_RET_LOG(index < MAX_SAMPLE_BLOCKS, nullptr, "invalid block index: %{public}u", index);
+
+    std::shared_ptr<AVSharedMemory> block = nullptr;
+    uint8_t flag = parcel.ReadUint8();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (flag == UPDATE_CACHE) {
+            block = ReadAVSharedMemoryFromParcel(parcel);
+            CHECK_AND_RETURN_RET_LOG(block != nullptr, nullptr, "failed to read block %{public}u", index);
+            caches_[index] = block;
+        } else {
+            auto iter = caches_.find(index);
+            CHECK_AND_RETURN_RET_LOG(flag == HIT_CACHE && iter != caches_.end(), nullptr,
+                "mark hit cache, but can not find the block: %{public}u, flag: %{public}hhu", index, flag);
+            block = iter->second;
+        }
+    }
+
+    int32_t offset = parcel.ReadInt32();
+    int32_t size = parcel.ReadInt32();
+    CHECK_AND_RETURN_RET_LOG(offset >= 0 && size >= 0 && offset <= block->GetSize() - size, nullptr,
+        "invalid sample, offset: %{public}d, size: %{public}d", offset, size);
+
+    auto sample = std::make_shared<SampleMemory>(shared_from_this(), block, index, offset, size);
+    CHECK_AND_RETURN_RET_LOG(sample != nullptr, nullptr, "failed to new SampleMemory");
+    return sample;
+}
+
+void AVMuxerSampleChannel::OnSampleReceived(int32_t ret, bool async)
+{
+    if (async && ret != MSERR_OK) {
+        int32_t expected = MSERR_OK;
+        (void)header_->asyncError.compare_exchange_strong(expected, ret, std::memory_order_acq_rel);
+    }
+    header_->received.fetch_add(1, std::memory_order_acq_rel);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    cond_.notify_all();
+}
+
+void AVMuxerSampleChannel::OnSampleReleased(uint32_t index)
+{
+    header_->released[index].fetch_add(1, std::memory_order_acq_rel);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    cond_.notify_all();
+}
+
+int32_t AVMuxerSampleChannel::WaitSyncPoint(MessageParcel &parcel, int32_t timeoutMs)
+{
+    uint32_t received = parcel.ReadUint32();
+    uint32_t index = parcel.ReadUint32();
+    uint32_t released = parcel.ReadUint32();
+    CHECK_AND_RETURN_RET_LOG(index <= MAX_SAMPLE_BLOCKS, MSERR_INVALID_VAL, "invalid block index: %{public}u", index);
+
+    // the counters wrap around, compare them by the distance.
+    auto reached = [this, received, index, released]() {
+        if (static_cast<int32_t>(header_->received.load(std::memory_order_acquire) - received) < 0) {
+            return false;
+        }
+        return index == MAX_SAMPLE_BLOCKS ||
+            static_cast<int32_t>(header_->released[index].load(std::memory_order_acquire) - released) >= 0;
+    };
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool ret = cond_.wait_for(lock, std::chrono::milliseconds(timeoutMs), reached);
+    CHECK_AND_RETURN_RET_LOG(ret, MSERR_UNKNOWN, "wait sync point timeout, received: %{public}u, "
+        "block: %{public}u, released: %{public}u", received, index, released);
+    return MSERR_OK;
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMUXER_SAMPLE_CHANNEL_H
+#define AVMUXER_SAMPLE_CHANNEL_H
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "avsharedmemory.h"
+#include "message_parcel.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * The channel of the avmuxer samples between the client and the server. The samples are copied into
+ * a fixed set of shared blocks, which are sent to the server only once and referenced by the block
+ * index, offset and size afterwards. The server counts the released samples of every block in a
+ * shared control page, so the client knows which block could be reused without any transaction.
+ */
+class AVMuxerSampleChannel : public std::enable_shared_from_this<AVMuxerSampleChannel>, public NoCopyable {
+public:
+    /**
+     * Producer: create the channel in the local process.
+     */
+    static std::shared_ptr<AVMuxerSampleChannel> Create();
+    /**
+     * Consumer: map the channel created by the peer process from the memory written by {@link WriteToParcel}.
+     */
+    static std::shared_ptr<AVMuxerSampleChannel> CreateFromParcel(MessageParcel &parcel);
+
+    explicit AVMuxerSampleChannel(const std::shared_ptr<AVSharedMemory> &control);
+    ~AVMuxerSampleChannel();
+
+    int32_t WriteToParcel(MessageParcel &parcel) const;
+
+    /**
+     * Producer: copy the sample into a drained block and write its reference to the parcel. The sample
+     * takes effect after {@link CommitSample} is called once the parcel is delivered.
+     * @return MSERR_NO_MEMORY if all blocks are still used by the peer or the sample is too large, the
+     * caller could wait for the credit by {@link WriteSyncPoint}.
+     */
+    int32_t WriteSample(const uint8_t *data, int32_t size, MessageParcel &parcel);
+    void CommitSample();
+
+    /**
+     * Producer: write the point for the consumer to wait, which is reached when all committed samples
+     * are received, and the oldest block is drained as well if waitCredit is true.
+     * @return false if the point is reached already.
+     */
+    bool WriteSyncPoint(MessageParcel &parcel, bool waitCredit);
+
+    /**
+     * Producer: take the first error of the one-way writes reported by the consumer.
+     */
+    int32_t TakeAsyncError();
+
+    /**
+     * Consumer: read the sample written by {@link WriteSample}, the block is released when the returned
+     * memory is destroyed.
+     */
+    std::shared_ptr<AVSharedMemory> ReadSample(MessageParcel &parcel);
+    void OnSampleReceived(int32_t ret, bool async);
+    int32_t WaitSyncPoint(MessageParcel &parcel, int32_t timeoutMs);
+
+    static constexpr uint32_t MAX_SAMPLE_BLOCKS = 8;
+
+private:
+    int32_t Init();
+    int32_t AcquireSpace(int32_t size, uint32_t &index, int32_t &offset);
+    bool IsDrained(uint32_t index) const;
+    void OnSampleReleased(uint32_t index);
+
+    struct ChannelHeader;
+    struct SampleBlock {
+        std::shared_ptr<AVSharedMemory> memory = nullptr;
+        // the samples committed into this block
+        uint32_t submitted = 0;
+        int32_t used = 0;
+        // whether the memory is cached by the consumer
+        bool cached = false;
+    };
+    struct PendingSample {
+        uint32_t index = MAX_SAMPLE_BLOCKS;
+        int32_t offset = 0;
+        int32_t size = 0;
+    };
+    class SampleMemory;
+
+    std::shared_ptr<AVSharedMemory> control_;
+    ChannelHeader *header_ = nullptr;
+
+    // producer
+    SampleBlock blocks_[MAX_SAMPLE_BLOCKS];
+    uint32_t current_ = 0;
+    uint32_t committed_ = 0;
+    PendingSample pending_;
+
+    // consumer
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::map<uint32_t, std::shared_ptr<AVSharedMemory>> caches_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMUXER_SAMPLE_CHANNEL_H
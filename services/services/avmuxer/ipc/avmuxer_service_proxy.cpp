@@ -14,9 +14,11 @@
  */
 
 #include "avmuxer_service_proxy.h"
+#include "securec.h"
 #include "media_log.h"
 #include "media_errors.h"
 #include "avsharedmemory_ipc.h"
+#include "avsharedmemorybase.h"
 #include "media_parcel.h"
 
 namespace {
@@ -139,7 +141,14 @@ int32_t AVMuxerServiceProxy::AddTrack(const MediaDescription &trackDesc, int32_t
     int error = Remote()->SendRequest(ADD_TRACK, data, reply, option);
     CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error, "Failed to call AddTrack, error: %{public}d", error);
     trackId = reply.ReadInt32();
-    return reply.ReadInt32();
+    int32_t ret = reply.ReadInt32();
+
+    int32_t asyncWrite = 0;
+    if (ret == MSERR_OK && trackDesc.GetIntValue(MediaDescriptionKey::MD_KEY_IPC_ASYNC_WRITE, asyncWrite) &&
+        asyncWrite != 0) {
+        asyncWrite_ = true;
+    }
+    return ret;
 }
 
 int32_t AVMuxerServiceProxy::Start()
@@ -155,13 +164,98 @@ int32_t AVMuxerServiceProxy::Start()
 
     int error = Remote()->SendRequest(START, data, reply, option);
     CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error, "Failed to call Start, error: %{public}d", error);
-    return reply.ReadInt32();
+    int32_t ret = reply.ReadInt32();
+    if (ret == MSERR_OK && sampleChannel_ == nullptr) {
+        // the sample channel is optional, keep the per-sample memory if it failed.
+        (void)SetupSampleChannel();
+    }
+    return ret;
+}
+
+int32_t AVMuxerServiceProxy::SetupSampleChannel()
+{
+    auto channel = AVMuxerSampleChannel::Create();
+    CHECK_AND_RETURN_RET_LOG(channel != nullptr, MSERR_NO_MEMORY, "failed to create sample channel");
+
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVMuxerServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    CHECK_AND_RETURN_RET(channel->WriteToParcel(data) == MSERR_OK, MSERR_UNKNOWN);
+    int error = Remote()->SendRequest(SET_SAMPLE_CHANNEL, data, reply, option);
+    CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error, "Failed to call SetSampleChannel, error: %{public}d", error);
+    int32_t ret = reply.ReadInt32();
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Failed to set sample channel");
+
+    sampleChannel_ = channel;
+    MEDIA_LOGI("sample channel is set, async write: %{public}d", asyncWrite_);
+    return MSERR_OK;
 }
 
 int32_t AVMuxerServiceProxy::WriteTrackSample(std::shared_ptr<AVSharedMemory> sampleData,
     const TrackSampleInfo &sampleInfo)
 {
     CHECK_AND_RETURN_RET_LOG(sampleData != nullptr, MSERR_INVALID_VAL, "sampleData is nullptr");
+    if (sampleChannel_ != nullptr) {
+        int32_t ret = sampleChannel_->TakeAsyncError();
+        CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Failed to write previous samples, error: %{public}d", ret);
+
+        ret = WriteChannelSample(sampleData, sampleInfo);
+        if (ret == MSERR_NO_MEMORY && SyncSampleChannel(true) == MSERR_OK) {
+            ret = WriteChannelSample(sampleData, sampleInfo);
+        }
+        if (ret != MSERR_NO_MEMORY) {
+            return ret;
+        }
+
+        // the blocks are still held by the muxer, keep the samples in order before sending it alone.
+        MEDIA_LOGW("no credit of the sample channel, write the sample by its own memory");
+        CHECK_AND_RETURN_RET_LOG(SyncSampleChannel(false) == MSERR_OK, MSERR_UNKNOWN, "Failed to sync samples");
+    }
+    return WriteSharedSample(sampleData, sampleInfo);
+}
+
+int32_t AVMuxerServiceProxy::WriteChannelSample(const std::shared_ptr<AVSharedMemory> &sampleData,
+    const TrackSampleInfo &sampleInfo)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option(asyncWrite_ ? MessageOption::TF_ASYNC : MessageOption::TF_SYNC);
+
+    if (!data.WriteInterfaceToken(AVMuxerServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    CHECK_AND_RETURN_RET(data.WriteBool(asyncWrite_), MSERR_UNKNOWN);
+    int32_t ret = sampleChannel_->WriteSample(sampleData->GetBase(), sampleData->GetSize(), data);
+    if (ret != MSERR_OK) {
+        return ret;
+    }
+    CHECK_AND_RETURN_RET(data.WriteInt32(sampleInfo.trackIdx), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(data.WriteInt64(sampleInfo.timeUs), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(data.WriteInt32(sampleInfo.size), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(data.WriteInt32(sampleInfo.flags), MSERR_UNKNOWN);
+    int error = Remote()->SendRequest(WRITE_CHANNEL_SAMPLE, data, reply, option);
+    CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error, "Failed to call WriteTrackSample, error: %{public}d", error);
+    sampleChannel_->CommitSample();
+    return asyncWrite_ ? MSERR_OK : reply.ReadInt32();
+}
+
+int32_t AVMuxerServiceProxy::WriteSharedSample(const std::shared_ptr<AVSharedMemory> &sampleData,
+    const TrackSampleInfo &sampleInfo)
+{
+    std::shared_ptr<AVSharedMemory> memory =
+        AVSharedMemoryBase::CreateFromLocal(sampleData->GetSize(), AVSharedMemory::FLAGS_READ_ONLY, "sampleData");
+    CHECK_AND_RETURN_RET_LOG(memory != nullptr, MSERR_NO_MEMORY, "Failed to create AVSharedMemoryBase");
+    errno_t rc = memcpy_s(memory->GetBase(), memory->GetSize(), sampleData->GetBase(), sampleData->GetSize());
+    CHECK_AND_RETURN_RET_LOG(rc == EOK, MSERR_UNKNOWN, "memcpy_s failed");
+
     MessageParcel data;
     MessageParcel reply;
     MessageOption option;
@@ -171,7 +265,7 @@ int32_t AVMuxerServiceProxy::WriteTrackSample(std::shared_ptr<AVSharedMemory> sa
         return MSERR_UNKNOWN;
     }
 
-    WriteAVSharedMemoryToParcel(sampleData, data);
+    WriteAVSharedMemoryToParcel(memory, data);
     CHECK_AND_RETURN_RET(data.WriteInt32(sampleInfo.trackIdx), MSERR_UNKNOWN);
     CHECK_AND_RETURN_RET(data.WriteInt64(sampleInfo.timeUs), MSERR_UNKNOWN);
     CHECK_AND_RETURN_RET(data.WriteInt32(sampleInfo.size), MSERR_UNKNOWN);
@@ -181,8 +275,40 @@ int32_t AVMuxerServiceProxy::WriteTrackSample(std::shared_ptr<AVSharedMemory> sa
     return reply.ReadInt32();
 }
 
+int32_t AVMuxerServiceProxy::SyncSampleChannel(bool waitCredit)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVMuxerServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    if (!sampleChannel_->WriteSyncPoint(data, waitCredit)) {
+        return MSERR_OK;
+    }
+    int error = Remote()->SendRequest(SYNC_SAMPLE_CHANNEL, data, reply, option);
+    CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error, "Failed to call SyncSampleChannel, error: %{public}d", error);
+    return reply.ReadInt32();
+}
+
 int32_t AVMuxerServiceProxy::Stop()
 {
+    if (sampleChannel_ != nullptr) {
+        // the one-way samples must be received before the end of stream.
+        if (asyncWrite_ && SyncSampleChannel(false) != MSERR_OK) {
+            MEDIA_LOGW("Failed to sync samples before stop");
+        }
+        int32_t ret = sampleChannel_->TakeAsyncError();
+        if (ret != MSERR_OK) {
+            MEDIA_LOGW("Failed to write samples, error: %{public}d", ret);
+        }
+        sampleChannel_ = nullptr;
+    }
+    asyncWrite_ = false;
+
     MessageParcel data;
     MessageParcel reply;
     MessageOption option;
@@ -199,6 +325,8 @@ int32_t AVMuxerServiceProxy::Stop()
 
 void AVMuxerServiceProxy::Release()
 {
+    sampleChannel_ = nullptr;
+
     MessageParcel data;
     MessageParcel reply;
     MessageOption option;
@@ -17,6 +17,7 @@
 #define AVMUXER_SERVICE_PROXY_H
 
 #include "i_standard_avmuxer_service.h"
+#include "avmuxer_sample_channel.h"
 
 namespace OHOS {
 namespace Media {
@@ -36,6 +37,13 @@ public:
     void Release() override;
     int32_t DestroyStub() override;
 private:
+    int32_t SetupSampleChannel();
+    int32_t WriteChannelSample(const std::shared_ptr<AVSharedMemory> &sampleData, const TrackSampleInfo &sampleInfo);
+    int32_t WriteSharedSample(const std::shared_ptr<AVSharedMemory> &sampleData, const TrackSampleInfo &sampleInfo);
+    int32_t SyncSampleChannel(bool waitCredit);
+
+    std::shared_ptr<AVMuxerSampleChannel> sampleChannel_ = nullptr;
+    bool asyncWrite_ = false;
     static inline BrokerDelegator<AVMuxerServiceProxy> delegator_;
 };
 }  // namespace Media
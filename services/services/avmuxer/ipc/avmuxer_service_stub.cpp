@@ -22,6 +22,7 @@
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVMuxerServiceStub"};
+    constexpr int32_t SYNC_SAMPLE_CHANNEL_TIMEOUT_MS = 200;
 }
 
 namespace OHOS {
@@ -61,11 +62,18 @@ int32_t AVMuxerServiceStub::Init()
     avmuxerFuncs_[STOP] = &AVMuxerServiceStub::Stop;
     avmuxerFuncs_[RELEASE] = &AVMuxerServiceStub::Release;
     avmuxerFuncs_[DESTROY] = &AVMuxerServiceStub::DestroyStub;
+    avmuxerFuncs_[SET_SAMPLE_CHANNEL] = &AVMuxerServiceStub::SetSampleChannel;
+    avmuxerFuncs_[WRITE_CHANNEL_SAMPLE] = &AVMuxerServiceStub::WriteChannelSample;
+    avmuxerFuncs_[SYNC_SAMPLE_CHANNEL] = &AVMuxerServiceStub::SyncSampleChannel;
     return MSERR_OK;
 }
 
 int32_t AVMuxerServiceStub::DestroyStub()
 {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sampleChannel_ = nullptr;
+    }
     avmuxerServer_ = nullptr;
     MediaServerManager::GetInstance().DestroyStubObject(MediaServerManager::AVMUXER, AsObject());
     return MSERR_OK;
@@ -140,12 +148,20 @@ int32_t AVMuxerServiceStub::WriteTrackSample(std::shared_ptr<AVSharedMemory> sam
 
 int32_t AVMuxerServiceStub::Stop()
 {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sampleChannel_ = nullptr;
+    }
     CHECK_AND_RETURN_RET_LOG(avmuxerServer_ != nullptr, MSERR_NO_MEMORY, "AVMuxer Service does not exist");
     return avmuxerServer_->Stop();
 }
 
 void AVMuxerServiceStub::Release()
 {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sampleChannel_ = nullptr;
+    }
     CHECK_AND_RETURN_LOG(avmuxerServer_ != nullptr, "AVMuxer Service does not exist");
     avmuxerServer_->Release();
 }
@@ -208,6 +224,60 @@ int32_t AVMuxerServiceStub::WriteTrackSample(MessageParcel &data, MessageParcel
     return MSERR_OK;
 }
 
+std::shared_ptr<AVMuxerSampleChannel> AVMuxerServiceStub::GetSampleChannel()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sampleChannel_;
+}
+
+int32_t AVMuxerServiceStub::SetSampleChannel(MessageParcel &data, MessageParcel &reply)
+{
+    auto channel = AVMuxerSampleChannel::CreateFromParcel(data);
+    if (channel == nullptr) {
+        CHECK_AND_RETURN_RET(reply.WriteInt32(MSERR_NO_MEMORY), MSERR_UNKNOWN);
+        return MSERR_OK;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sampleChannel_ = channel;
+    }
+    CHECK_AND_RETURN_RET(reply.WriteInt32(MSERR_OK), MSERR_UNKNOWN);
+    return MSERR_OK;
+}
+
+int32_t AVMuxerServiceStub::WriteChannelSample(MessageParcel &data, MessageParcel &reply)
+{
+    bool async = data.ReadBool();
+    auto channel = GetSampleChannel();
+    CHECK_AND_RETURN_RET_LOG(channel != nullptr, MSERR_INVALID_OPERATION, "sample channel does not exist");
+
+    int32_t ret = MSERR_INVALID_VAL;
+    std::shared_ptr<AVSharedMemory> sampleData = channel->ReadSample(data);
+    if (sampleData != nullptr) {
+        TrackSampleInfo sampleInfo = {data.ReadInt32(), data.ReadInt64(),
+            data.ReadInt32(), static_cast<AVCodecBufferFlag>(data.ReadInt32())};
+        ret = WriteTrackSample(sampleData, sampleInfo);
+        // the block is released once the muxer consumed the sample.
+        sampleData = nullptr;
+    }
+    channel->OnSampleReceived(ret, async);
+    if (!async) {
+        CHECK_AND_RETURN_RET(reply.WriteInt32(ret), MSERR_UNKNOWN);
+    }
+    return MSERR_OK;
+}
+
+int32_t AVMuxerServiceStub::SyncSampleChannel(MessageParcel &data, MessageParcel &reply)
+{
+    auto channel = GetSampleChannel();
+    int32_t ret = MSERR_INVALID_OPERATION;
+    if (channel != nullptr) {
+        ret = channel->WaitSyncPoint(data, SYNC_SAMPLE_CHANNEL_TIMEOUT_MS);
+    }
+    CHECK_AND_RETURN_RET(reply.WriteInt32(ret), MSERR_UNKNOWN);
+    return MSERR_OK;
+}
+
 int32_t AVMuxerServiceStub::Stop(MessageParcel &data, MessageParcel &reply)
 {
     (void)data;
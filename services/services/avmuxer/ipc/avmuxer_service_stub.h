@@ -18,6 +18,7 @@
 
 #include "i_standard_avmuxer_service.h"
 #include "avmuxer_server.h"
+#include "avmuxer_sample_channel.h"
 #include "iremote_stub.h"
 
 namespace OHOS {
@@ -52,8 +53,13 @@ private:
     int32_t Stop(MessageParcel &data, MessageParcel &reply);
     int32_t Release(MessageParcel &data, MessageParcel &reply);
     int32_t DestroyStub(MessageParcel &data, MessageParcel &reply);
+    int32_t SetSampleChannel(MessageParcel &data, MessageParcel &reply);
+    int32_t WriteChannelSample(MessageParcel &data, MessageParcel &reply);
+    int32_t SyncSampleChannel(MessageParcel &data, MessageParcel &reply);
+    std::shared_ptr<AVMuxerSampleChannel> GetSampleChannel();
 
     std::mutex mutex_;
+    std::shared_ptr<AVMuxerSampleChannel> sampleChannel_ = nullptr;
     std::shared_ptr<IAVMuxerService> avmuxerServer_ = nullptr;
     std::map<uint32_t, AVMuxerStubFunc> avmuxerFuncs_;
 };
@@ -46,6 +46,9 @@ public:
         STOP,
         RELEASE,
         DESTROY,
+        SET_SAMPLE_CHANNEL,
+        WRITE_CHANNEL_SAMPLE,
+        SYNC_SAMPLE_CHANNEL,
     };
 
     DECLARE_INTERFACE_DESCRIPTOR(u"IStandardAVMuxerServiceq1a");
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avspliter_client.h"
+#include "media_errors.h"
+#include "media_log.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVSpliterClient"};
+}
+
+namespace OHOS {
+namespace Media {
+std::shared_ptr<AVSpliterClient> AVSpliterClient::Create(const sptr<IStandardAVSpliterService> &ipcProxy)
+{
+    std::shared_ptr<AVSpliterClient> avspliterClient = std::make_shared<AVSpliterClient>(ipcProxy);
+    CHECK_AND_RETURN_RET_LOG(avspliterClient != nullptr, nullptr, "Failed to create avspliter client");
+    return avspliterClient;
+}
+
+AVSpliterClient::AVSpliterClient(const sptr<IStandardAVSpliterService> &ipcProxy)
+    : avspliterProxy_(ipcProxy)
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVSpliterClient::~AVSpliterClient()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (avspliterProxy_ != nullptr) {
+        (void)avspliterProxy_->DestroyStub();
+        avspliterProxy_ = nullptr;
+    }
+    dataSrcStub_ = nullptr;
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+void AVSpliterClient::MediaServerDied()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    avspliterProxy_ = nullptr;
+}
+
+int32_t AVSpliterClient::SetSource(const std::string &uri, TrackSelectMode mode)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avspliterProxy_ != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return avspliterProxy_->SetSource(uri, mode);
+}
+
+int32_t AVSpliterClient::SetSource(const std::shared_ptr<IMediaDataSource> &dataSource, TrackSelectMode mode)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avspliterProxy_ != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    CHECK_AND_RETURN_RET_LOG(dataSource != nullptr, MSERR_NO_MEMORY, "data source is nullptr");
+
+    dataSrcStub_ = new(std::nothrow) MediaDataSourceStub(dataSource);
+    CHECK_AND_RETURN_RET_LOG(dataSrcStub_ != nullptr, MSERR_NO_MEMORY, "failed to new dataSrcStub object");
+
+    sptr<IRemoteObject> object = dataSrcStub_->AsObject();
+    CHECK_AND_RETURN_RET_LOG(object != nullptr, MSERR_NO_MEMORY, "listener object is nullptr");
+    return avspliterProxy_->SetSource(object, mode);
+}
+
+int32_t AVSpliterClient::GetContainerDescription(MediaDescription &desc)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avspliterProxy_ != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return avspliterProxy_->GetContainerDescription(desc);
+}
+
+int32_t AVSpliterClient::GetTrackDescription(uint32_t trackIdx, MediaDescription &desc)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avspliterProxy_ != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return avspliterProxy_->GetTrackDescription(trackIdx, desc);
+}
+
+int32_t AVSpliterClient::SelectTrack(uint32_t trackIdx)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avspliterProxy_ != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return avspliterProxy_->SelectTrack(trackIdx);
+}
+
+int32_t AVSpliterClient::UnSelectTrack(uint32_t trackIdx)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avspliterProxy_ != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return avspliterProxy_->UnSelectTrack(trackIdx);
+}
+
+int32_t AVSpliterClient::ReadTrackSample(std::shared_ptr<AVSharedMemory> buffer, TrackSampleInfo &info)
+{
+    sptr<IStandardAVSpliterService> proxy = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        proxy = avspliterProxy_;
+    }
+    CHECK_AND_RETURN_RET_LOG(proxy != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    // not called with the lock held, the read may wait for the demuxer while the other calls go on.
+    return proxy->ReadTrackSample(buffer, info);
+}
+
+int32_t AVSpliterClient::Seek(int64_t timeUs, AVSeekMode mode)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avspliterProxy_ != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return avspliterProxy_->Seek(timeUs, mode);
+}
+
+int32_t AVSpliterClient::GetCacheState(int64_t &durationUs, bool &endOfStream)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avspliterProxy_ != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return avspliterProxy_->GetCacheState(durationUs, endOfStream);
+}
+
+void AVSpliterClient::Release()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_LOG(avspliterProxy_ != nullptr, "AVSpliter Service does not exist");
+    avspliterProxy_->Release();
+    dataSrcStub_ = nullptr;
+}
+}  // namespace Media
+}  // namespace OHOS
@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avspliter_service_proxy.h"
+#include "media_log.h"
+#include "media_errors.h"
+#include "avsharedmemory_ipc.h"
+#include "media_parcel.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVSpliterServiceProxy"};
+}
+
+namespace OHOS {
+namespace Media {
+AVSpliterServiceProxy::AVSpliterServiceProxy(const sptr<IRemoteObject> &impl)
+    : IRemoteProxy<IStandardAVSpliterService>(impl)
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVSpliterServiceProxy::~AVSpliterServiceProxy()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+int32_t AVSpliterServiceProxy::DestroyStub()
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVSpliterServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    int error = Remote()->SendRequest(DESTROY, data, reply, option);
+    CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error, "Failed to call DestroyStub, error: %{public}d", error);
+    return reply.ReadInt32();
+}
+
+int32_t AVSpliterServiceProxy::SetSource(const std::string &uri, TrackSelectMode mode)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVSpliterServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    CHECK_AND_RETURN_RET(data.WriteString(uri), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(data.WriteInt32(mode), MSERR_UNKNOWN);
+    int error = Remote()->SendRequest(SET_SOURCE, data, reply, option);
+    CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error, "Failed to call SetSource, error: %{public}d", error);
+    return reply.ReadInt32();
+}
+
+int32_t AVSpliterServiceProxy::SetSource(const sptr<IRemoteObject> &object, TrackSelectMode mode)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVSpliterServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    CHECK_AND_RETURN_RET(data.WriteRemoteObject(object), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(data.WriteInt32(mode), MSERR_UNKNOWN);
+    int error = Remote()->SendRequest(SET_MEDIA_DATA_SRC_OBJ, data, reply, option);
+    CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error, "Failed to call SetSource, error: %{public}d", error);
+    return reply.ReadInt32();
+}
+
+int32_t AVSpliterServiceProxy::GetContainerDescription(MediaDescription &desc)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVSpliterServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    int error = Remote()->SendRequest(GET_CONTAINER_DESCRIPTION, data, reply, option);
+    CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error,
+        "Failed to call GetContainerDescription, error: %{public}d", error);
+    (void)MediaParcel::Unmarshalling(reply, desc);
+    return reply.ReadInt32();
+}
+
+int32_t AVSpliterServiceProxy::GetTrackDescription(uint32_t trackIdx, MediaDescription &desc)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVSpliterServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    CHECK_AND_RETURN_RET(data.WriteUint32(trackIdx), MSERR_UNKNOWN);
+    int error = Remote()->SendRequest(GET_TRACK_DESCRIPTION, data, reply, option);
+    CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error,
+        "Failed to call GetTrackDescription, error: %{public}d", error);
+    (void)MediaParcel::Unmarshalling(reply, desc);
+    return reply.ReadInt32();
+}
+
+int32_t AVSpliterServiceProxy::SelectTrack(uint32_t trackIdx)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVSpliterServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    CHECK_AND_RETURN_RET(data.WriteUint32(trackIdx), MSERR_UNKNOWN);
+    int error = Remote()->SendRequest(SELECT_TRACK, data, reply, option);
+    CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error, "Failed to call SelectTrack, error: %{public}d", error);
+    return reply.ReadInt32();
+}
+
+int32_t AVSpliterServiceProxy::UnSelectTrack(uint32_t trackIdx)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVSpliterServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    CHECK_AND_RETURN_RET(data.WriteUint32(trackIdx), MSERR_UNKNOWN);
+    int error = Remote()->SendRequest(UNSELECT_TRACK, data, reply, option);
+    CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error, "Failed to call UnSelectTrack, error: %{public}d", error);
+    return reply.ReadInt32();
+}
+
+int32_t AVSpliterServiceProxy::ReadTrackSample(std::shared_ptr<AVSharedMemory> buffer, TrackSampleInfo &info)
+{
+    CHECK_AND_RETURN_RET_LOG(buffer != nullptr, MSERR_INVALID_VAL, "buffer is nullptr");
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVSpliterServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    std::lock_guard<std::mutex> lock(readMutex_);
+    if (buffer == sentReadMem_) {
+        CHECK_AND_RETURN_RET(data.WriteUint8(READ_MEM_HIT_CACHE), MSERR_UNKNOWN);
+    } else {
+        CHECK_AND_RETURN_RET(data.WriteUint8(READ_MEM_UPDATE_CACHE), MSERR_UNKNOWN);
+        CHECK_AND_RETURN_RET(WriteAVSharedMemoryToParcel(buffer, data) == MSERR_OK, MSERR_UNKNOWN);
+    }
+    int error = Remote()->SendRequest(READ_TRACK_SAMPLE, data, reply, option);
+    sentReadMem_ = (error == MSERR_OK) ? buffer : nullptr;
+    CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error, "Failed to call ReadTrackSample, error: %{public}d", error);
+    info.trackIdx = reply.ReadUint32();
+    info.timeUs = reply.ReadInt64();
+    info.size = reply.ReadUint32();
+    info.flags = static_cast<AVCodecBufferFlag>(reply.ReadUint32());
+    return reply.ReadInt32();
+}
+
+int32_t AVSpliterServiceProxy::Seek(int64_t timeUs, AVSeekMode mode)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVSpliterServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    CHECK_AND_RETURN_RET(data.WriteInt64(timeUs), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(data.WriteInt32(mode), MSERR_UNKNOWN);
+    int error = Remote()->SendRequest(SEEK, data, reply, option);
+    CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error, "Failed to call Seek, error: %{public}d", error);
+    return reply.ReadInt32();
+}
+
+int32_t AVSpliterServiceProxy::GetCacheState(int64_t &durationUs, bool &endOfStream)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVSpliterServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    int error = Remote()->SendRequest(GET_CACHE_STATE, data, reply, option);
+    CHECK_AND_RETURN_RET_LOG(error == MSERR_OK, error, "Failed to call GetCacheState, error: %{public}d", error);
+    durationUs = reply.ReadInt64();
+    endOfStream = reply.ReadBool();
+    return reply.ReadInt32();
+}
+
+void AVSpliterServiceProxy::Release()
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(AVSpliterServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return;
+    }
+
+    int error = Remote()->SendRequest(RELEASE, data, reply, option);
+    CHECK_AND_RETURN_LOG(error == MSERR_OK, "Failed to call Release, error: %{public}d", error);
+}
+}  // namespace Media
+}  // namespace OHOS
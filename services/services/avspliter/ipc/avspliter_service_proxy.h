@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVSPLITER_SERVICE_PROXY_H
+#define AVSPLITER_SERVICE_PROXY_H
+
+#include <mutex>
+#include "i_standard_avspliter_service.h"
+
+namespace OHOS {
+namespace Media {
+class AVSpliterServiceProxy : public IRemoteProxy<IStandardAVSpliterService>, public NoCopyable {
+public:
+    explicit AVSpliterServiceProxy(const sptr<IRemoteObject> &impl);
+    virtual ~AVSpliterServiceProxy();
+
+    int32_t SetSource(const std::string &uri, TrackSelectMode mode) override;
+    int32_t SetSource(const sptr<IRemoteObject> &object, TrackSelectMode mode) override;
+    int32_t GetContainerDescription(MediaDescription &desc) override;
+    int32_t GetTrackDescription(uint32_t trackIdx, MediaDescription &desc) override;
+    int32_t SelectTrack(uint32_t trackIdx) override;
+    int32_t UnSelectTrack(uint32_t trackIdx) override;
+    int32_t ReadTrackSample(std::shared_ptr<AVSharedMemory> buffer, TrackSampleInfo &info) override;
+    int32_t Seek(int64_t timeUs, AVSeekMode mode) override;
+    int32_t GetCacheState(int64_t &durationUs, bool &endOfStream) override;
+    void Release() override;
+    int32_t DestroyStub() override;
+private:
+    static inline BrokerDelegator<AVSpliterServiceProxy> delegator_;
+    std::mutex readMutex_;
+    // the sample memory already mapped by the stub.
+    std::shared_ptr<AVSharedMemory> sentReadMem_ = nullptr;
+};
+}  // namespace Media
+}  // namespace OHOS
+#endif  // AVSPLITER_SERVICE_PROXY_H
@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avspliter_service_stub.h"
+#include "media_server_manager.h"
+#include "media_data_source_proxy.h"
+#include "media_errors.h"
+#include "media_log.h"
+#include "avsharedmemory_ipc.h"
+#include "media_parcel.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVSpliterServiceStub"};
+}
+
+namespace OHOS {
+namespace Media {
+sptr<AVSpliterServiceStub> AVSpliterServiceStub::Create()
+{
+    sptr<AVSpliterServiceStub> avspliterStub = new(std::nothrow) AVSpliterServiceStub();
+    CHECK_AND_RETURN_RET_LOG(avspliterStub != nullptr, nullptr, "Failed to create avspliter service stub");
+
+    int32_t ret = avspliterStub->Init();
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, nullptr, "Failed to init AVSpliterServiceStub");
+    return avspliterStub;
+}
+
+AVSpliterServiceStub::AVSpliterServiceStub()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVSpliterServiceStub::~AVSpliterServiceStub()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+int32_t AVSpliterServiceStub::Init()
+{
+    avspliterServer_ = AVSpliterServer::Create();
+    CHECK_AND_RETURN_RET_LOG(avspliterServer_ != nullptr, MSERR_NO_MEMORY, "Failed to create spliter server");
+
+    avspliterFuncs_[SET_SOURCE] = &AVSpliterServiceStub::SetSource;
+    avspliterFuncs_[SET_MEDIA_DATA_SRC_OBJ] = &AVSpliterServiceStub::SetMediaDataSource;
+    avspliterFuncs_[GET_CONTAINER_DESCRIPTION] = &AVSpliterServiceStub::GetContainerDescription;
+    avspliterFuncs_[GET_TRACK_DESCRIPTION] = &AVSpliterServiceStub::GetTrackDescription;
+    avspliterFuncs_[SELECT_TRACK] = &AVSpliterServiceStub::SelectTrack;
+    avspliterFuncs_[UNSELECT_TRACK] = &AVSpliterServiceStub::UnSelectTrack;
+    avspliterFuncs_[READ_TRACK_SAMPLE] = &AVSpliterServiceStub::ReadTrackSample;
+    avspliterFuncs_[SEEK] = &AVSpliterServiceStub::Seek;
+    avspliterFuncs_[GET_CACHE_STATE] = &AVSpliterServiceStub::GetCacheState;
+    avspliterFuncs_[RELEASE] = &AVSpliterServiceStub::Release;
+    avspliterFuncs_[DESTROY] = &AVSpliterServiceStub::DestroyStub;
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServiceStub::DestroyStub()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        avspliterServer_ = nullptr;
+        readMem_ = nullptr;
+    }
+    MediaServerManager::GetInstance().DestroyStubObject(MediaServerManager::AVSPLITER, AsObject());
+    return MSERR_OK;
+}
+
+std::shared_ptr<IAVSpliterService> AVSpliterServiceStub::GetServer()
+{
+    // the server is taken out of the lock, so that a waiting read does not block the other calls.
+    std::lock_guard<std::mutex> lock(mutex_);
+    return avspliterServer_;
+}
+
+int AVSpliterServiceStub::OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply,
+    MessageOption &option)
+{
+    MEDIA_LOGI("Stub: OnRemoteRequest of code: %{public}u is received", code);
+
+    auto remoteDescriptor = data.ReadInterfaceToken();
+    if (AVSpliterServiceStub::GetDescriptor() != remoteDescriptor) {
+        MEDIA_LOGE("Invalid descriptor");
+        return MSERR_INVALID_OPERATION;
+    }
+
+    auto itFunc = avspliterFuncs_.find(code);
+    if (itFunc != avspliterFuncs_.end()) {
+        auto memberFunc = itFunc->second;
+        if (memberFunc != nullptr) {
+            int32_t ret = (this->*memberFunc)(data, reply);
+            CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Failed to call memberFunc");
+            return MSERR_OK;
+        }
+    }
+    MEDIA_LOGW("Failed to find corresponding function");
+    return IPCObjectStub::OnRemoteRequest(code, data, reply, option);
+}
+
+int32_t AVSpliterServiceStub::SetSource(const std::string &uri, TrackSelectMode mode)
+{
+    std::shared_ptr<IAVSpliterService> server = GetServer();
+    CHECK_AND_RETURN_RET_LOG(server != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return server->SetSource(uri, mode);
+}
+
+int32_t AVSpliterServiceStub::SetSource(const sptr<IRemoteObject> &object, TrackSelectMode mode)
+{
+    CHECK_AND_RETURN_RET_LOG(object != nullptr, MSERR_NO_MEMORY, "set mediadatasrc object is nullptr");
+    std::shared_ptr<IAVSpliterService> server = GetServer();
+    CHECK_AND_RETURN_RET_LOG(server != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+
+    sptr<IStandardMediaDataSource> proxy = iface_cast<IStandardMediaDataSource>(object);
+    CHECK_AND_RETURN_RET_LOG(proxy != nullptr, MSERR_NO_MEMORY, "failed to convert MediaDataSourceProxy");
+
+    std::shared_ptr<IMediaDataSource> mediaDataSrc = std::make_shared<MediaDataCallback>(proxy);
+    CHECK_AND_RETURN_RET_LOG(mediaDataSrc != nullptr, MSERR_NO_MEMORY, "failed to new MediaDataCallback");
+
+    return server->SetSource(mediaDataSrc, mode);
+}
+
+int32_t AVSpliterServiceStub::GetContainerDescription(MediaDescription &desc)
+{
+    std::shared_ptr<IAVSpliterService> server = GetServer();
+    CHECK_AND_RETURN_RET_LOG(server != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return server->GetContainerDescription(desc);
+}
+
+int32_t AVSpliterServiceStub::GetTrackDescription(uint32_t trackIdx, MediaDescription &desc)
+{
+    std::shared_ptr<IAVSpliterService> server = GetServer();
+    CHECK_AND_RETURN_RET_LOG(server != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return server->GetTrackDescription(trackIdx, desc);
+}
+
+int32_t AVSpliterServiceStub::SelectTrack(uint32_t trackIdx)
+{
+    std::shared_ptr<IAVSpliterService> server = GetServer();
+    CHECK_AND_RETURN_RET_LOG(server != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return server->SelectTrack(trackIdx);
+}
+
+int32_t AVSpliterServiceStub::UnSelectTrack(uint32_t trackIdx)
+{
+    std::shared_ptr<IAVSpliterService> server = GetServer();
+    CHECK_AND_RETURN_RET_LOG(server != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return server->UnSelectTrack(trackIdx);
+}
+
+int32_t AVSpliterServiceStub::ReadTrackSample(std::shared_ptr<AVSharedMemory> buffer, TrackSampleInfo &info)
+{
+    CHECK_AND_RETURN_RET_LOG(buffer != nullptr, MSERR_INVALID_VAL, "buffer is nullptr");
+    std::shared_ptr<IAVSpliterService> server = GetServer();
+    CHECK_AND_RETURN_RET_LOG(server != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return server->ReadTrackSample(buffer, info);
+}
+
+int32_t AVSpliterServiceStub::Seek(int64_t timeUs, AVSeekMode mode)
+{
+    std::shared_ptr<IAVSpliterService> server = GetServer();
+    CHECK_AND_RETURN_RET_LOG(server != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return server->Seek(timeUs, mode);
+}
+
+int32_t AVSpliterServiceStub::GetCacheState(int64_t &durationUs, bool &endOfStream)
+{
+    std::shared_ptr<IAVSpliterService> server = GetServer();
+    CHECK_AND_RETURN_RET_LOG(server != nullptr, MSERR_NO_MEMORY, "AVSpliter Service does not exist");
+    return server->GetCacheState(durationUs, endOfStream);
+}
+
+void AVSpliterServiceStub::Release()
+{
+    std::shared_ptr<IAVSpliterService> server = GetServer();
+    CHECK_AND_RETURN_LOG(server != nullptr, "AVSpliter Service does not exist");
+    server->Release();
+}
+
+int32_t AVSpliterServiceStub::SetSource(MessageParcel &data, MessageParcel &reply)
+{
+    std::string uri = data.ReadString();
+    TrackSelectMode mode = static_cast<TrackSelectMode>(data.ReadInt32());
+    CHECK_AND_RETURN_RET(reply.WriteInt32(SetSource(uri, mode)), MSERR_UNKNOWN);
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServiceStub::SetMediaDataSource(MessageParcel &data, MessageParcel &reply)
+{
+    sptr<IRemoteObject> object = data.ReadRemoteObject();
+    TrackSelectMode mode = static_cast<TrackSelectMode>(data.ReadInt32());
+    CHECK_AND_RETURN_RET(reply.WriteInt32(SetSource(object, mode)), MSERR_UNKNOWN);
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServiceStub::GetContainerDescription(MessageParcel &data, MessageParcel &reply)
+{
+    (void)data;
+    MediaDescription desc;
+    int32_t ret = GetContainerDescription(desc);
+    CHECK_AND_RETURN_RET(MediaParcel::Marshalling(reply, desc), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(reply.WriteInt32(ret), MSERR_UNKNOWN);
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServiceStub::GetTrackDescription(MessageParcel &data, MessageParcel &reply)
+{
+    uint32_t trackIdx = data.ReadUint32();
+    MediaDescription desc;
+    int32_t ret = GetTrackDescription(trackIdx, desc);
+    CHECK_AND_RETURN_RET(MediaParcel::Marshalling(reply, desc), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(reply.WriteInt32(ret), MSERR_UNKNOWN);
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServiceStub::SelectTrack(MessageParcel &data, MessageParcel &reply)
+{
+    uint32_t trackIdx = data.ReadUint32();
+    CHECK_AND_RETURN_RET(reply.WriteInt32(SelectTrack(trackIdx)), MSERR_UNKNOWN);
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServiceStub::UnSelectTrack(MessageParcel &data, MessageParcel &reply)
+{
+    uint32_t trackIdx = data.ReadUint32();
+    CHECK_AND_RETURN_RET(reply.WriteInt32(UnSelectTrack(trackIdx)), MSERR_UNKNOWN);
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServiceStub::ReadTrackSample(MessageParcel &data, MessageParcel &reply)
+{
+    std::shared_ptr<AVSharedMemory> buffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint8_t flag = data.ReadUint8();
+        if (flag == READ_MEM_UPDATE_CACHE) {
+            readMem_ = ReadAVSharedMemoryFromParcel(data);
+        } else if (flag != READ_MEM_HIT_CACHE) {
+            readMem_ = nullptr;
+        }
+        buffer = readMem_;
+    }
+    CHECK_AND_RETURN_RET_LOG(buffer != nullptr, MSERR_UNKNOWN, "no sample memory is mapped");
+    TrackSampleInfo info = {0, 0, 0, AVCODEC_BUFFER_FLAG_NONE};
+    int32_t ret = ReadTrackSample(buffer, info);
+    CHECK_AND_RETURN_RET(reply.WriteUint32(info.trackIdx), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(reply.WriteInt64(info.timeUs), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(reply.WriteUint32(info.size), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(reply.WriteUint32(info.flags), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(reply.WriteInt32(ret), MSERR_UNKNOWN);
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServiceStub::Seek(MessageParcel &data, MessageParcel &reply)
+{
+    int64_t timeUs = data.ReadInt64();
+    AVSeekMode mode = static_cast<AVSeekMode>(data.ReadInt32());
+    CHECK_AND_RETURN_RET(reply.WriteInt32(Seek(timeUs, mode)), MSERR_UNKNOWN);
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServiceStub::GetCacheState(MessageParcel &data, MessageParcel &reply)
+{
+    (void)data;
+    int64_t durationUs = 0;
+    bool endOfStream = false;
+    int32_t ret = GetCacheState(durationUs, endOfStream);
+    CHECK_AND_RETURN_RET(reply.WriteInt64(durationUs), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(reply.WriteBool(endOfStream), MSERR_UNKNOWN);
+    CHECK_AND_RETURN_RET(reply.WriteInt32(ret), MSERR_UNKNOWN);
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServiceStub::Release(MessageParcel &data, MessageParcel &reply)
+{
+    (void)data;
+    (void)reply;
+    Release();
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServiceStub::DestroyStub(MessageParcel &data, MessageParcel &reply)
+{
+    (void)data;
+    CHECK_AND_RETURN_RET(reply.WriteInt32(DestroyStub()), MSERR_UNKNOWN);
+    return MSERR_OK;
+}
+}  // namespace Media
+}  // namespace OHOS
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVSPLITER_SERVICE_STUB_H
+#define AVSPLITER_SERVICE_STUB_H
+
+#include <map>
+#include <mutex>
+#include "i_standard_avspliter_service.h"
+#include "avspliter_server.h"
+#include "iremote_stub.h"
+
+namespace OHOS {
+namespace Media {
+class AVSpliterServiceStub : public IRemoteStub<IStandardAVSpliterService>, public NoCopyable {
+public:
+    static sptr<AVSpliterServiceStub> Create();
+    virtual ~AVSpliterServiceStub();
+    int OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply, MessageOption &option) override;
+    using AVSpliterStubFunc = int32_t(AVSpliterServiceStub::*)(MessageParcel &data, MessageParcel &reply);
+
+    int32_t SetSource(const std::string &uri, TrackSelectMode mode) override;
+    int32_t SetSource(const sptr<IRemoteObject> &object, TrackSelectMode mode) override;
+    int32_t GetContainerDescription(MediaDescription &desc) override;
+    int32_t GetTrackDescription(uint32_t trackIdx, MediaDescription &desc) override;
+    int32_t SelectTrack(uint32_t trackIdx) override;
+    int32_t UnSelectTrack(uint32_t trackIdx) override;
+    int32_t ReadTrackSample(std::shared_ptr<AVSharedMemory> buffer, TrackSampleInfo &info) override;
+    int32_t Seek(int64_t timeUs, AVSeekMode mode) override;
+    int32_t GetCacheState(int64_t &durationUs, bool &endOfStream) override;
+    void Release() override;
+    int32_t DestroyStub() override;
+private:
+    AVSpliterServiceStub();
+    int32_t Init();
+    int32_t SetSource(MessageParcel &data, MessageParcel &reply);
+    int32_t SetMediaDataSource(MessageParcel &data, MessageParcel &reply);
+    int32_t GetContainerDescription(MessageParcel &data, MessageParcel &reply);
+    int32_t GetTrackDescription(MessageParcel &data, MessageParcel &reply);
+    int32_t SelectTrack(MessageParcel &data, MessageParcel &reply);
+    int32_t UnSelectTrack(MessageParcel &data, MessageParcel &reply);
+    int32_t ReadTrackSample(MessageParcel &data, MessageParcel &reply);
+    int32_t Seek(MessageParcel &data, MessageParcel &reply);
+    int32_t GetCacheState(MessageParcel &data, MessageParcel &reply);
+    int32_t Release(MessageParcel &data, MessageParcel &reply);
+    int32_t DestroyStub(MessageParcel &data, MessageParcel &reply);
+    std::shared_ptr<IAVSpliterService> GetServer();
+
+    std::mutex mutex_;
+    std::shared_ptr<IAVSpliterService> avspliterServer_ = nullptr;
+    // the sample memory mapped from the last update, reused while the client keeps the same memory.
+    std::shared_ptr<AVSharedMemory> readMem_ = nullptr;
+    std::map<uint32_t, AVSpliterStubFunc> avspliterFuncs_;
+};
+}  // namespace Media
+}  // namespace OHOS
+#endif
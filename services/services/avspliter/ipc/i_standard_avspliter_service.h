@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef I_STANDARD_AVSPLITER_SERVICE_H
+#define I_STANDARD_AVSPLITER_SERVICE_H
+
+#include "i_avspliter_service.h"
+#include "iremote_proxy.h"
+
+namespace OHOS {
+namespace Media {
+class IStandardAVSpliterService : public IRemoteBroker {
+public:
+    virtual ~IStandardAVSpliterService() = default;
+    virtual int32_t SetSource(const std::string &uri, TrackSelectMode mode) = 0;
+    virtual int32_t SetSource(const sptr<IRemoteObject> &object, TrackSelectMode mode) = 0;
+    virtual int32_t GetContainerDescription(MediaDescription &desc) = 0;
+    virtual int32_t GetTrackDescription(uint32_t trackIdx, MediaDescription &desc) = 0;
+    virtual int32_t SelectTrack(uint32_t trackIdx) = 0;
+    virtual int32_t UnSelectTrack(uint32_t trackIdx) = 0;
+    virtual int32_t ReadTrackSample(std::shared_ptr<AVSharedMemory> buffer, TrackSampleInfo &info) = 0;
+    virtual int32_t Seek(int64_t timeUs, AVSeekMode mode) = 0;
+    virtual int32_t GetCacheState(int64_t &durationUs, bool &endOfStream) = 0;
+    virtual void Release() = 0;
+    virtual int32_t DestroyStub() = 0;
+
+    enum AVSpliterServiceMsg {
+        SET_SOURCE = 0,
+        SET_MEDIA_DATA_SRC_OBJ,
+        GET_CONTAINER_DESCRIPTION,
+        GET_TRACK_DESCRIPTION,
+        SELECT_TRACK,
+        UNSELECT_TRACK,
+        READ_TRACK_SAMPLE,
+        SEEK,
+        GET_CACHE_STATE,
+        RELEASE,
+        DESTROY,
+    };
+
+    // the sample memory is sent again only when the client replaces it, the stub keeps the mapping otherwise.
+    enum ReadMemCacheFlag : uint8_t {
+        READ_MEM_HIT_CACHE = 1,
+        READ_MEM_UPDATE_CACHE,
+    };
+
+    DECLARE_INTERFACE_DESCRIPTOR(u"IStandardAVSpliterService");
+};
+}  // namespace Media
+}  // namespace OHOS
+#endif  // I_STANDARD_AVSPLITER_SERVICE_H
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avspliter_server.h"
+#include "media_errors.h"
+#include "media_log.h"
+#include "engine_factory_repo.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVSpliterServer"};
+}
+
+namespace OHOS {
+namespace Media {
+std::shared_ptr<IAVSpliterService> AVSpliterServer::Create()
+{
+    std::shared_ptr<AVSpliterServer> avspliterServer = std::make_shared<AVSpliterServer>();
+    CHECK_AND_RETURN_RET_LOG(avspliterServer != nullptr, nullptr, "AVSpliter Service does not exist");
+    int32_t ret = avspliterServer->Init();
+    CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, nullptr, "Failed to init avspliter server");
+    return avspliterServer;
+}
+
+AVSpliterServer::AVSpliterServer()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+AVSpliterServer::~AVSpliterServer()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+    std::lock_guard<std::mutex> lock(mutex_);
+    avspliterEngine_ = nullptr;
+}
+
+int32_t AVSpliterServer::Init()
+{
+    auto engineFactory = EngineFactoryRepo::Instance().GetEngineFactory(IEngineFactory::Scene::SCENE_AVSPLITER);
+    CHECK_AND_RETURN_RET_LOG(engineFactory != nullptr, MSERR_UNKNOWN, "Failed to get engine factory");
+    avspliterEngine_ = engineFactory->CreateAVSpliterEngine();
+    CHECK_AND_RETURN_RET_LOG(avspliterEngine_ != nullptr, MSERR_NO_MEMORY, "Failed to create avspliter engine");
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServer::SetSource(const std::string &uri, TrackSelectMode mode)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (curState_ != AVSPLITER_IDEL) {
+        MEDIA_LOGE("Failed to call SetSource, currentState is %{public}d", curState_);
+        return MSERR_INVALID_OPERATION;
+    }
+    CHECK_AND_RETURN_RET_LOG(avspliterEngine_ != nullptr, MSERR_INVALID_OPERATION, "AVSpliter engine does not exist");
+    int32_t ret = avspliterEngine_->SetSource(uri, mode);
+    if (ret != MSERR_OK) {
+        avspliterEngine_->Reset();
+        MEDIA_LOGE("Failed to call SetSource");
+        return ret;
+    }
+    curState_ = AVSPLITER_SOURCE_SET;
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServer::SetSource(const std::shared_ptr<IMediaDataSource> &dataSource, TrackSelectMode mode)
+{
+    CHECK_AND_RETURN_RET_LOG(dataSource != nullptr, MSERR_INVALID_VAL, "dataSource is nullptr");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (curState_ != AVSPLITER_IDEL) {
+        MEDIA_LOGE("Failed to call SetSource, currentState is %{public}d", curState_);
+        return MSERR_INVALID_OPERATION;
+    }
+    CHECK_AND_RETURN_RET_LOG(avspliterEngine_ != nullptr, MSERR_INVALID_OPERATION, "AVSpliter engine does not exist");
+    int32_t ret = avspliterEngine_->SetSource(dataSource, mode);
+    if (ret != MSERR_OK) {
+        avspliterEngine_->Reset();
+        MEDIA_LOGE("Failed to call SetSource");
+        return ret;
+    }
+    curState_ = AVSPLITER_SOURCE_SET;
+    return MSERR_OK;
+}
+
+int32_t AVSpliterServer::GetContainerDescription(MediaDescription &desc)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(curState_ == AVSPLITER_SOURCE_SET, MSERR_INVALID_OPERATION, "Source is not set");
+    CHECK_AND_RETURN_RET_LOG(avspliterEngine_ != nullptr, MSERR_INVALID_OPERATION, "AVSpliter engine does not exist");
+    return avspliterEngine_->GetContainerDescription(desc);
+}
+
+int32_t AVSpliterServer::GetTrackDescription(uint32_t trackIdx, MediaDescription &desc)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(curState_ == AVSPLITER_SOURCE_SET, MSERR_INVALID_OPERATION, "Source is not set");
+    CHECK_AND_RETURN_RET_LOG(avspliterEngine_ != nullptr, MSERR_INVALID_OPERATION, "AVSpliter engine does not exist");
+    return avspliterEngine_->GetTrackDescription(trackIdx, desc);
+}
+
+int32_t AVSpliterServer::SelectTrack(uint32_t trackIdx)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(curState_ == AVSPLITER_SOURCE_SET, MSERR_INVALID_OPERATION, "Source is not set");
+    CHECK_AND_RETURN_RET_LOG(avspliterEngine_ != nullptr, MSERR_INVALID_OPERATION, "AVSpliter engine does not exist");
+    return avspliterEngine_->SelectTrack(trackIdx);
+}
+
+int32_t AVSpliterServer::UnSelectTrack(uint32_t trackIdx)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(curState_ == AVSPLITER_SOURCE_SET, MSERR_INVALID_OPERATION, "Source is not set");
+    CHECK_AND_RETURN_RET_LOG(avspliterEngine_ != nullptr, MSERR_INVALID_OPERATION, "AVSpliter engine does not exist");
+    return avspliterEngine_->UnSelectTrack(trackIdx);
+}
+
+int32_t AVSpliterServer::ReadTrackSample(std::shared_ptr<AVSharedMemory> buffer, TrackSampleInfo &info)
+{
+    CHECK_AND_RETURN_RET_LOG(buffer != nullptr, MSERR_INVALID_VAL, "buffer is nullptr");
+    std::shared_ptr<IAVSpliterEngine> engine = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        CHECK_AND_RETURN_RET_LOG(curState_ == AVSPLITER_SOURCE_SET, MSERR_INVALID_OPERATION, "Source is not set");
+        engine = avspliterEngine_;
+    }
+    CHECK_AND_RETURN_RET_LOG(engine != nullptr, MSERR_INVALID_OPERATION, "AVSpliter engine does not exist");
+    // the read may wait for the demuxer, so the other calls are not serialized behind it.
+    return engine->ReadTrackSample(buffer, info);
+}
+
+int32_t AVSpliterServer::Seek(int64_t timeUs, AVSeekMode mode)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(curState_ == AVSPLITER_SOURCE_SET, MSERR_INVALID_OPERATION, "Source is not set");
+    CHECK_AND_RETURN_RET_LOG(avspliterEngine_ != nullptr, MSERR_INVALID_OPERATION, "AVSpliter engine does not exist");
+    return avspliterEngine_->Seek(timeUs, mode);
+}
+
+int32_t AVSpliterServer::GetCacheState(int64_t &durationUs, bool &endOfStream)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(curState_ == AVSPLITER_SOURCE_SET, MSERR_INVALID_OPERATION, "Source is not set");
+    CHECK_AND_RETURN_RET_LOG(avspliterEngine_ != nullptr, MSERR_INVALID_OPERATION, "AVSpliter engine does not exist");
+    return avspliterEngine_->GetCacheState(durationUs, endOfStream);
+}
+
+void AVSpliterServer::Release()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_LOG(avspliterEngine_ != nullptr, "AVSpliter engine does not exist");
+    avspliterEngine_->Reset();
+    avspliterEngine_ = nullptr;
+    curState_ = AVSPLITER_IDEL;
+}
+}  // namespace Media
+}  // namespace OHOS
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVSPLITER_SERVER_H
+#define AVSPLITER_SERVER_H
+
+#include <mutex>
+#include "i_avspliter_service.h"
+#include "i_avspliter_engine.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+enum AVSpliterStates : int32_t {
+    AVSPLITER_IDEL = 0,
+    AVSPLITER_SOURCE_SET,
+};
+
+class AVSpliterServer : public IAVSpliterService, public NoCopyable {
+public:
+    static std::shared_ptr<IAVSpliterService> Create();
+    AVSpliterServer();
+    ~AVSpliterServer();
+
+    int32_t SetSource(const std::string &uri, TrackSelectMode mode) override;
+    int32_t SetSource(const std::shared_ptr<IMediaDataSource> &dataSource, TrackSelectMode mode) override;
+    int32_t GetContainerDescription(MediaDescription &desc) override;
+    int32_t GetTrackDescription(uint32_t trackIdx, MediaDescription &desc) override;
+    int32_t SelectTrack(uint32_t trackIdx) override;
+    int32_t UnSelectTrack(uint32_t trackIdx) override;
+    int32_t ReadTrackSample(std::shared_ptr<AVSharedMemory> buffer, TrackSampleInfo &info) override;
+    int32_t Seek(int64_t timeUs, AVSeekMode mode) override;
+    int32_t GetCacheState(int64_t &durationUs, bool &endOfStream) override;
+    void Release() override;
+private:
+    int32_t Init();
+    std::mutex mutex_;
+    std::shared_ptr<IAVSpliterEngine> avspliterEngine_ = nullptr;
+    AVSpliterStates curState_ = AVSPLITER_IDEL;
+};
+}  // namespace Media
+}  // namespace OHOS
+#endif
@@ -28,6 +28,8 @@
 
 namespace OHOS {
 namespace Media {
+class AVCodecCapabilityIndex;
+
 class IAVCodecListEngine {
 public:
     virtual ~IAVCodecListEngine() = default;
@@ -36,6 +38,7 @@ public:
     virtual std::string FindAudioDecoder(const Format &format) = 0;
     virtual std::string FindAudioEncoder(const Format &format) = 0;
     virtual std::vector<CapabilityData> GetCodecCapabilityInfos() = 0;
+    virtual std::shared_ptr<const AVCodecCapabilityIndex> GetCapabilityIndex() = 0;
 };
 } // namespace Media
 } // namespace OHOS
@@ -77,6 +77,26 @@ public:
      */
     virtual std::shared_ptr<AVSharedMemory> FetchFrameAtTime(
         int64_t timeUs, int32_t option, const OutputConfiguration &param) = 0;
+
+    /**
+     * Prepare to fetch the video frames at a batch of timestamps. This method must be called
+     * after the SetSource.
+     * @param timesUs the time positions in microseconds, which are fetched in ascending order.
+     * @param option the hint about how to fetch the frames, see {@link AVMetadataQueryOption}
+     * @param param the desired configuration of returned video frames, see {@link OutputConfiguration}.
+     * @return Returns {@link MSERR_OK} if the batch is accepted; returns an error code otherwise.
+     */
+    virtual int32_t PrepareFetchFrames(
+        const std::vector<int64_t> &timesUs, int32_t option, const OutputConfiguration &param) = 0;
+
+    /**
+     * Fetch the next video frame of the batch prepared by {@link PrepareFetchFrames}.
+     * @param timeUs output, the requested time position which the returned frame is fetched for,
+     * -1 if there is no frame left.
+     * @return Returns a chunk of shared memory containing a scaled video frame, which
+     * can be null, if such a frame cannot be fetched.
+     */
+    virtual std::shared_ptr<AVSharedMemory> FetchNextFrame(int64_t &timeUs) = 0;
 };
 } // namespace Media
 } // namespace OHOS
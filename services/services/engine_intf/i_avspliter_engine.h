@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef I_AVSPLITER_ENGINE_H
+#define I_AVSPLITER_ENGINE_H
+
+#include <string>
+#include <memory>
+#include "avsharedmemory.h"
+#include "avspliter.h"
+
+namespace OHOS {
+namespace Media {
+class IAVSpliterEngine {
+public:
+    virtual ~IAVSpliterEngine() = default;
+
+    virtual int32_t SetSource(const std::string &uri, TrackSelectMode mode) = 0;
+    virtual int32_t SetSource(const std::shared_ptr<IMediaDataSource> &dataSource, TrackSelectMode mode) = 0;
+    virtual int32_t GetContainerDescription(MediaDescription &desc) = 0;
+    virtual int32_t GetTrackDescription(uint32_t trackIdx, MediaDescription &desc) = 0;
+    virtual int32_t SelectTrack(uint32_t trackIdx) = 0;
+    virtual int32_t UnSelectTrack(uint32_t trackIdx) = 0;
+    virtual int32_t ReadTrackSample(std::shared_ptr<AVSharedMemory> buffer, TrackSampleInfo &info) = 0;
+    virtual int32_t Seek(int64_t timeUs, AVSeekMode mode) = 0;
+    virtual int32_t GetCacheState(int64_t &durationUs, bool &endOfStream) = 0;
+    virtual void Reset() = 0;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // I_AVSPLITER_ENGINE_H
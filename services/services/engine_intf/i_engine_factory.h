@@ -24,6 +24,7 @@
 #include "i_avcodec_engine.h"
 #include "i_avcodeclist_engine.h"
 #include "i_avmuxer_engine.h"
+#include "i_avspliter_engine.h"
 
 namespace OHOS {
 namespace Media {
@@ -36,6 +37,7 @@ public:
         SCENE_AVCODEC,
         SCENE_AVCODECLIST,
         SCENE_AVMUXER,
+        SCENE_AVSPLITER,
     };
 
     virtual ~IEngineFactory() = default;
@@ -81,6 +83,11 @@ public:
         return nullptr;
     }
 
+    virtual std::unique_ptr<IAVSpliterEngine> CreateAVSpliterEngine()
+    {
+        return nullptr;
+    }
+
 protected:
     static constexpr int32_t MAX_SCORE = 100;
     static constexpr int32_t MIN_SCORE = 0;
@@ -27,6 +27,8 @@ namespace OHOS {
 class Surface;
 
 namespace Media {
+class PlayerPositionPage;
+
 class IPlayerEngineObs : public std::enable_shared_from_this<IPlayerEngineObs> {
 public:
     virtual ~IPlayerEngineObs() = default;
@@ -83,6 +85,11 @@ public:
         (void)interruptMode;
         return 0;
     }
+    virtual int32_t SetPositionPage(const std::shared_ptr<PlayerPositionPage> &positionPage)
+    {
+        (void)positionPage;
+        return 0;
+    }
 };
 } // namespace Media
 } // namespace OHOS
@@ -21,6 +21,7 @@
 #include "iremote_proxy.h"
 #include "iremote_stub.h"
 #include "media_data_source.h"
+#include "media_data_source_ring.h"
 #include "nocopyable.h"
 
 namespace OHOS {
@@ -32,10 +33,27 @@ public:
     virtual int32_t ReadAt(uint32_t length, const std::shared_ptr<AVSharedMemory> &mem) = 0;
     virtual int32_t GetSize(int64_t &size) = 0;
 
+    /**
+     * Let the app read ahead into the ring, the ReadAt with the pos is used if seekable. A nullptr
+     * ring stops the read-ahead.
+     */
+    virtual int32_t SetReadRing(const std::shared_ptr<MediaDataSourceRing> &ring, bool seekable) = 0;
+    /**
+     * Drop the data in the ring and read ahead from the pos, returns after the first read.
+     */
+    virtual int32_t SeekReadRing(int64_t pos) = 0;
+    /**
+     * Wake up the read-ahead, returns after one more read if wait is true.
+     */
+    virtual int32_t FillReadRing(bool wait) = 0;
+
     enum ListenerMsg {
         READ_AT = 0,
         READ_AT_POS,
         GET_SIZE,
+        SET_READ_RING,
+        SEEK_READ_RING,
+        FILL_READ_RING,
     };
 
     DECLARE_INTERFACE_DESCRIPTOR(u"IStandardMediaDataSource");
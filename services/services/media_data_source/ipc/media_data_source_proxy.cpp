@@ -14,12 +14,15 @@
  */
 
 #include "media_data_source_proxy.h"
+#include <algorithm>
 #include "media_log.h"
 #include "media_errors.h"
+#include "media_metrics.h"
 #include "avsharedmemory_ipc.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "MediaDataSourceProxy"};
+constexpr uint32_t READ_RING_CAPACITY = 1024 * 1024;
 }
 
 namespace OHOS {
@@ -32,19 +35,67 @@ MediaDataCallback::MediaDataCallback(const sptr<IStandardMediaDataSource> &ipcPr
 
 MediaDataCallback::~MediaDataCallback()
 {
+    if (ring_ != nullptr && callbackProxy_ != nullptr) {
+        (void)callbackProxy_->SetReadRing(nullptr, false);
+    }
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
 }
 
+bool MediaDataCallback::OpenRing(bool seekable)
+{
+    if (!ringTried_) {
+        ringTried_ = true;
+        auto ring = MediaDataSourceRing::Create(READ_RING_CAPACITY, "datasrc_ring");
+        CHECK_AND_RETURN_RET_LOG(ring != nullptr, false, "failed to create ring");
+        int32_t ret = callbackProxy_->SetReadRing(ring, seekable);
+        CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, false, "no read-ahead, use ReadAt instead: %{public}d", ret);
+        ring_ = ring;
+        ringSeekable_ = seekable;
+    }
+    return ring_ != nullptr && ringSeekable_ == seekable;
+}
+
+int32_t MediaDataCallback::ReadRing(uint32_t length, const std::shared_ptr<AVSharedMemory> &mem)
+{
+    CHECK_AND_RETURN_RET_LOG(mem != nullptr && mem->GetBase() != nullptr && mem->GetSize() > 0, SOURCE_ERROR_IO,
+        "invalid mem");
+    uint32_t size = std::min(length, static_cast<uint32_t>(mem->GetSize()));
+    int32_t ret = ring_->Read(mem->GetBase(), size);
+    if (ret == 0) {
+        // the read-ahead falls behind, wait for it as the per-call ReadAt does
+        METRICS_COUNTER_ADD("datasrc.ring.stall", 1);
+        CHECK_AND_RETURN_RET_LOG(callbackProxy_->FillReadRing(true) == MSERR_OK, 0, "FillReadRing failed");
+        ret = ring_->Read(mem->GetBase(), size);
+    }
+    if (ret > 0 && ring_->TakeDoorbell()) {
+        (void)callbackProxy_->FillReadRing(false);
+    }
+    return ret;
+}
+
 int32_t MediaDataCallback::ReadAt(uint32_t length, const std::shared_ptr<AVSharedMemory> &mem)
 {
     CHECK_AND_RETURN_RET_LOG(callbackProxy_ != nullptr, SOURCE_ERROR_IO, "callbackProxy_ is nullptr");
-    return callbackProxy_->ReadAt(length, mem);
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!OpenRing(false)) {
+        return callbackProxy_->ReadAt(length, mem);
+    }
+    return ReadRing(length, mem);
 }
 
 int32_t MediaDataCallback::ReadAt(int64_t pos, uint32_t length, const std::shared_ptr<AVSharedMemory> &mem)
 {
     CHECK_AND_RETURN_RET_LOG(callbackProxy_ != nullptr, SOURCE_ERROR_IO, "callbackProxy_ is nullptr");
-    return callbackProxy_->ReadAt(pos, length, mem);
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!OpenRing(true)) {
+        return callbackProxy_->ReadAt(pos, length, mem);
+    }
+    if (!ring_->Skip(pos)) {
+        METRICS_COUNTER_ADD("datasrc.ring.seek", 1);
+        int32_t ret = callbackProxy_->SeekReadRing(pos);
+        CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, 0, "SeekReadRing failed: %{public}d", ret);
+    }
+    return ReadRing(length, mem);
 }
 
 int32_t MediaDataCallback::GetSize(int64_t &size)
@@ -126,5 +177,70 @@ int32_t MediaDataSourceProxy::GetSize(int64_t &size)
     size = reply.ReadInt64();
     return reply.ReadInt32();
 }
+
+int32_t MediaDataSourceProxy::SetReadRing(const std::shared_ptr<MediaDataSourceRing> &ring, bool seekable)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option(MessageOption::TF_SYNC);
+
+    if (!data.WriteInterfaceToken(MediaDataSourceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    data.WriteBool(ring != nullptr);
+    data.WriteBool(seekable);
+    if (ring != nullptr) {
+        CHECK_AND_RETURN_RET_LOG(ring->WriteToParcel(data) == MSERR_OK, MSERR_UNKNOWN, "write parcel failed");
+    }
+    int error = Remote()->SendRequest(ListenerMsg::SET_READ_RING, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("SetReadRing failed, error: %{public}d", error);
+        return error;
+    }
+    return reply.ReadInt32();
+}
+
+int32_t MediaDataSourceProxy::SeekReadRing(int64_t pos)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option(MessageOption::TF_SYNC);
+
+    if (!data.WriteInterfaceToken(MediaDataSourceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    data.WriteInt64(pos);
+    int error = Remote()->SendRequest(ListenerMsg::SEEK_READ_RING, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("SeekReadRing failed, error: %{public}d", error);
+        return error;
+    }
+    return reply.ReadInt32();
+}
+
+int32_t MediaDataSourceProxy::FillReadRing(bool wait)
+{
+    MessageParcel data;
+    MessageParcel reply;
+    // the doorbell does not wait for the app to read
+    MessageOption option(wait ? MessageOption::TF_SYNC : MessageOption::TF_ASYNC);
+
+    if (!data.WriteInterfaceToken(MediaDataSourceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return MSERR_UNKNOWN;
+    }
+
+    data.WriteBool(wait);
+    int error = Remote()->SendRequest(ListenerMsg::FILL_READ_RING, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGE("FillReadRing failed, error: %{public}d", error);
+        return error;
+    }
+    return wait ? reply.ReadInt32() : MSERR_OK;
+}
 } // namespace Media
 } // namespace OHOS
\ No newline at end of file
@@ -16,6 +16,7 @@
 #ifndef MEDIA_DATA_SOURCE_PROXY_H
 #define MEDIA_DATA_SOURCE_PROXY_H
 
+#include <mutex>
 #include "i_standard_media_data_source.h"
 #include "media_death_recipient.h"
 #include "nocopyable.h"
@@ -32,7 +33,15 @@ public:
     int32_t GetSize(int64_t &size) override;
 
 private:
+    bool OpenRing(bool seekable);
+    int32_t ReadRing(uint32_t length, const std::shared_ptr<AVSharedMemory> &mem);
+
     sptr<IStandardMediaDataSource> callbackProxy_ = nullptr;
+    std::mutex mutex_;
+    // the data is read ahead by the app into the ring, the per-call ReadAt is used if it is not supported
+    std::shared_ptr<MediaDataSourceRing> ring_ = nullptr;
+    bool ringSeekable_ = false;
+    bool ringTried_ = false;
 };
 
 class MediaDataSourceProxy : public IRemoteProxy<IStandardMediaDataSource>, public NoCopyable {
@@ -43,6 +52,9 @@ public:
     int32_t ReadAt(int64_t pos, uint32_t length, const std::shared_ptr<AVSharedMemory> &mem) override;
     int32_t ReadAt(uint32_t length, const std::shared_ptr<AVSharedMemory> &mem) override;
     int32_t GetSize(int64_t &size) override;
+    int32_t SetReadRing(const std::shared_ptr<MediaDataSourceRing> &ring, bool seekable) override;
+    int32_t SeekReadRing(int64_t pos) override;
+    int32_t FillReadRing(bool wait) override;
 
 private:
     static inline BrokerDelegator<MediaDataSourceProxy> delegator_;
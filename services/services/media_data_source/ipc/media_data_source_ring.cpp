@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "media_data_source_ring.h"
+#include <algorithm>
+#include <new>
+#include "avsharedmemory_ipc.h"
+#include "avsharedmemorybase.h"
+#include "media_data_source.h"
+#include "media_errors.h"
+#include "media_log.h"
+#include "securec.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "MediaDataSourceRing"};
+    // the producer waits for the doorbell rather than reading the app in small pieces
+    constexpr uint32_t MIN_SPACE_DIVISOR = 8;
+}
+
+namespace OHOS {
+namespace Media {
+struct MediaDataSourceRing::RingHeader {
+    // written by the consumer only, except in Reset
+    std::atomic<uint64_t> readCount = 0;
+    // written by the producer only
+    std::atomic<uint64_t> writeCount = 0;
+    // the stream position of the first byte written since the last Reset
+    std::atomic<int64_t> startPos = 0;
+    // the MediaDataSourceError following the written data, 0 if the stream goes on
+    std::atomic<int32_t> status = 0;
+    // set by the producer when it waits for the space, cleared by whom rings or cancels it.
+    std::atomic<uint32_t> armed = 0;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring header is shared between processes");
+
+class MediaDataSourceRing::RingSpace : public AVSharedMemory, public NoCopyable {
+public:
+    RingSpace(const std::shared_ptr<AVSharedMemory> &memory, uint8_t *base, int32_t size)
+        : memory_(memory), base_(base), size_(size)
+    {
+    }
+
+    ~RingSpace() = default;
+
+    uint8_t *GetBase() const override
+    {
+        return base_;
+    }
+
+    int32_t GetSize() const override
+    {
+        return size_;
+    }
+
+    uint32_t GetFlags() const override
+    {
+        return memory_->GetFlags();
+    }
+
+private:
+    std::shared_ptr<AVSharedMemory> memory_;
+    uint8_t *base_;
+    int32_t size_;
+};
+
+std::shared_ptr<MediaDataSourceRing> MediaDataSourceRing::Create(uint32_t capacity, const std::string &name)
+{
+    CHECK_AND_RETURN_RET_LOG(capacity != 0 && (capacity & (capacity - 1)) == 0 &&
+        capacity <= static_cast<uint32_t>(INT32_MAX) - sizeof(RingHeader), nullptr,
+        "invalid ring capacity: %{public}u", capacity);
+
+    int32_t size = static_cast<int32_t>(sizeof(RingHeader) + capacity);
+    auto memory = AVSharedMemoryBase::CreateFromLocal(size, AVSharedMemory::FLAGS_READ_WRITE, name);
+    CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "failed to create ring memory");
+
+    auto ring = std::make_shared<MediaDataSourceRing>(memory);
+    CHECK_AND_RETURN_RET_LOG(ring != nullptr, nullptr, "failed to new MediaDataSourceRing");
+    CHECK_AND_RETURN_RET(ring->Init() == MSERR_OK, nullptr);
+
+    // the memory is only visible to this process now, construct the header in place.
+    ring->header_ = new (ring->memory_->GetBase()) RingHeader();
+    return ring;
+}
+
+std::shared_ptr<MediaDataSourceRing> MediaDataSourceRing::CreateFromParcel(MessageParcel &parcel)
+{
+    auto memory = ReadAVSharedMemoryFromParcel(parcel);
+    CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "failed to read ring memory");
+
+    auto ring = std::make_shared<MediaDataSourceRing>(memory);
+    CHECK_AND_RETURN_RET_LOG(ring != nullptr, nullptr, "failed to new MediaDataSourceRing");
+    CHECK_AND_RETURN_RET(ring->Init() == MSERR_OK, nullptr);
+    return ring;
+}
+
+MediaDataSourceRing::MediaDataSourceRing(const std::shared_ptr<AVSharedMemory> &memory)
+    : memory_(memory)
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+MediaDataSourceRing::~MediaDataSourceRing()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+int32_t MediaDataSourceRing::Init()
+{
+    CHECK_AND_RETURN_RET(memory_ != nullptr && memory_->GetBase() != nullptr, MSERR_INVALID_VAL);
+    int32_t size = memory_->GetSize();
+    CHECK_AND_RETURN_RET_LOG(size > static_cast<int32_t>(sizeof(RingHeader)), MSERR_INVALID_VAL,
+        "ring memory is too small: %{public}d", size);
+
+    uint32_t bytes = static_cast<uint32_t>(size) - sizeof(RingHeader);
+    capacity_ = 1;
+    while ((capacity_ << 1) != 0 && (capacity_ << 1) <= bytes) {
+        capacity_ <<= 1;
+    }
+
+    header_ = reinterpret_cast<RingHeader *>(memory_->GetBase());
+    data_ = memory_->GetBase() + sizeof(RingHeader);
+    return MSERR_OK;
+}
+
+int32_t MediaDataSourceRing::WriteToParcel(MessageParcel &parcel) const
+{
+    return WriteAVSharedMemoryToParcel(memory_, parcel);
+}
+
+bool MediaDataSourceRing::GetUsed(uint64_t &read, uint64_t &write) const
+{
+    read = header_->readCount.load(std::memory_order_seq_cst);
+    write = header_->writeCount.load(std::memory_order_acquire);
+    if (write - read > capacity_) {
+        MEDIA_LOGE("ring corrupted, read: %{public}" PRIu64 ", write: %{public}" PRIu64 "", read, write);
+        return false;
+    }
+    return true;
+}
+
+void MediaDataSourceRing::Reset(int64_t pos)
+{
+    header_->readCount.store(0, std::memory_order_relaxed);
+    header_->writeCount.store(0, std::memory_order_relaxed);
+    header_->startPos.store(pos, std::memory_order_relaxed);
+    header_->status.store(0, std::memory_order_relaxed);
+    header_->armed.store(0, std::memory_order_relaxed);
+    // published to the consumer by the reply of the seek
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+int64_t MediaDataSourceRing::GetWritePos() const
+{
+    return header_->startPos.load(std::memory_order_relaxed) +
+        static_cast<int64_t>(header_->writeCount.load(std::memory_order_relaxed));
+}
+
+std::shared_ptr<AVSharedMemory> MediaDataSourceRing::AcquireSpace(uint32_t maxSize)
+{
+    CHECK_AND_RETURN_RET(maxSize != 0 && header_->status.load(std::memory_order_relaxed) == 0, nullptr);
+
+    uint64_t read = 0;
+    uint64_t write = 0;
+    if (!GetUsed(read, write)) {
+        header_->status.store(SOURCE_ERROR_IO, std::memory_order_release);
+        return nullptr;
+    }
+    uint32_t minSpace = std::max(std::min(maxSize, capacity_ / MIN_SPACE_DIVISOR), 1U);
+    uint32_t space = capacity_ - static_cast<uint32_t>(write - read);
+    if (space < minSpace) {
+        header_->armed.store(1, std::memory_order_seq_cst);
+        // the consumer may free the space before it sees the doorbell armed
+        CHECK_AND_RETURN_RET(GetUsed(read, write), nullptr);
+        space = capacity_ - static_cast<uint32_t>(write - read);
+        if (space < minSpace) {
+            return nullptr;
+        }
+        header_->armed.store(0, std::memory_order_relaxed);
+    }
+
+    uint32_t offset = static_cast<uint32_t>(write & (capacity_ - 1));
+    uint32_t size = std::min({ maxSize, space, capacity_ - offset });
+    auto ringSpace = std::make_shared<RingSpace>(memory_, data_ + offset, static_cast<int32_t>(size));
+    CHECK_AND_RETURN_RET_LOG(ringSpace != nullptr, nullptr, "failed to new RingSpace");
+    return ringSpace;
+}
+
+void MediaDataSourceRing::Commit(int32_t size)
+{
+    if (size < 0) {
+        header_->status.store(size, std::memory_order_release);
+        return;
+    }
+    uint64_t write = header_->writeCount.load(std::memory_order_relaxed);
+    header_->writeCount.store(write + static_cast<uint64_t>(size), std::memory_order_release);
+}
+
+bool MediaDataSourceRing::IsEmpty() const
+{
+    return header_->writeCount.load(std::memory_order_acquire) == header_->readCount.load(std::memory_order_acquire);
+}
+
+int64_t MediaDataSourceRing::GetReadPos() const
+{
+    return header_->startPos.load(std::memory_order_relaxed) +
+        static_cast<int64_t>(header_->readCount.load(std::memory_order_relaxed));
+}
+
+bool MediaDataSourceRing::Skip(int64_t pos)
+{
+    int64_t readPos = GetReadPos();
+    uint64_t read = 0;
+    uint64_t write = 0;
+    if (pos < readPos || !GetUsed(read, write) || static_cast<uint64_t>(pos - readPos) > write - read) {
+        return false;
+    }
+    header_->readCount.store(read + static_cast<uint64_t>(pos - readPos), std::memory_order_seq_cst);
+    return true;
+}
+
+int32_t MediaDataSourceRing::Read(uint8_t *dst, uint32_t length)
+{
+    CHECK_AND_RETURN_RET(dst != nullptr && length != 0, 0);
+
+    // loaded before the counters, the data written before the status is never missed.
+    int32_t status = header_->status.load(std::memory_order_acquire);
+    uint64_t read = 0;
+    uint64_t write = 0;
+    CHECK_AND_RETURN_RET(GetUsed(read, write), SOURCE_ERROR_IO);
+    if (write == read) {
+        if (status == 0) {
+            return 0;
+        }
+        // the error of the app is passed through as the per-call ReadAt does
+        return status < 0 ? status : SOURCE_ERROR_IO;
+    }
+
+    uint32_t size = std::min({ static_cast<uint32_t>(write - read), length, static_cast<uint32_t>(INT32_MAX) });
+    uint32_t offset = static_cast<uint32_t>(read & (capacity_ - 1));
+    uint32_t first = std::min(size, capacity_ - offset);
+    CHECK_AND_RETURN_RET(memcpy_s(dst, length, data_ + offset, first) == EOK, SOURCE_ERROR_IO);
+    if (size > first) {
+        CHECK_AND_RETURN_RET(memcpy_s(dst + first, length - first, data_, size - first) == EOK, SOURCE_ERROR_IO);
+    }
+
+    header_->readCount.store(read + size, std::memory_order_seq_cst);
+    return static_cast<int32_t>(size);
+}
+
+bool MediaDataSourceRing::TakeDoorbell()
+{
+    return header_->armed.exchange(0, std::memory_order_seq_cst) != 0;
+}
+} // namespace Media
+} // namespace OHOS
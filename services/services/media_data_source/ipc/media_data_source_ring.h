@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEDIA_DATA_SOURCE_RING_H
+#define MEDIA_DATA_SOURCE_RING_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include "avsharedmemory.h"
+#include "message_parcel.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * Single-producer single-consumer byte ring living in a shared memory, which carries the stream of an
+ * IMediaDataSource from the app to the server. The app reads ahead into the ring without being asked,
+ * the server takes the bytes from it, and a transaction is only needed when the ring runs dry, a seek
+ * moves the stream away from the ring, or the producer waits for the space freed by the consumer.
+ */
+class MediaDataSourceRing : public NoCopyable {
+public:
+    /**
+     * Consumer: create the ring in the local process, the capacity must be the power of two.
+     */
+    static std::shared_ptr<MediaDataSourceRing> Create(uint32_t capacity, const std::string &name);
+    /**
+     * Producer: map the ring created by the peer process from the memory written by {@link WriteToParcel}.
+     */
+    static std::shared_ptr<MediaDataSourceRing> CreateFromParcel(MessageParcel &parcel);
+
+    explicit MediaDataSourceRing(const std::shared_ptr<AVSharedMemory> &memory);
+    ~MediaDataSourceRing();
+
+    int32_t WriteToParcel(MessageParcel &parcel) const;
+
+    /**
+     * Producer: drop all the data and restart the ring at the stream position. Only called while the
+     * consumer is waiting for the reply of the seek.
+     */
+    void Reset(int64_t pos);
+
+    /**
+     * Producer: the stream position of the next byte to write.
+     */
+    int64_t GetWritePos() const;
+
+    /**
+     * Producer: get the contiguous free space of at most maxSize bytes, which stays valid until
+     * {@link Commit} or {@link Reset} is called.
+     * @return nullptr if the ring is full or the stream has ended. When full, the consumer rings the
+     * doorbell after it frees some space.
+     */
+    std::shared_ptr<AVSharedMemory> AcquireSpace(uint32_t maxSize);
+
+    /**
+     * Producer: publish the size bytes written into the space, a negative size is the
+     * MediaDataSourceError which ends the stream after the published data.
+     */
+    void Commit(int32_t size);
+
+    /**
+     * Whether all the data written has been read.
+     */
+    bool IsEmpty() const;
+
+    /**
+     * Consumer: the stream position of the next byte to read.
+     */
+    int64_t GetReadPos() const;
+
+    /**
+     * Consumer: drop the data before the pos if it is already in the ring.
+     * @return false if the pos is not in the ring.
+     */
+    bool Skip(int64_t pos);
+
+    /**
+     * Consumer: copy at most length bytes out of the ring.
+     * @return the bytes copied, 0 if the ring is empty, or the MediaDataSourceError once all the data
+     * before it is read.
+     */
+    int32_t Read(uint8_t *dst, uint32_t length);
+
+    /**
+     * Consumer: check whether the producer is waiting for the doorbell after some space is freed,
+     * the doorbell is disarmed once this returns true.
+     */
+    bool TakeDoorbell();
+
+private:
+    int32_t Init();
+    bool GetUsed(uint64_t &read, uint64_t &write) const;
+
+    struct RingHeader;
+    class RingSpace;
+    std::shared_ptr<AVSharedMemory> memory_;
+    RingHeader *header_ = nullptr;
+    uint8_t *data_ = nullptr;
+    // calculated from the memory size locally, never trust the value written by the peer.
+    uint32_t capacity_ = 0;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // MEDIA_DATA_SOURCE_RING_H
@@ -21,18 +21,21 @@
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "MediaDataSourceStub"};
+constexpr uint32_t READ_AHEAD_SIZE = 128 * 1024;
 }
 
 namespace OHOS {
 namespace Media {
 MediaDataSourceStub::MediaDataSourceStub(const std::shared_ptr<IMediaDataSource> &dataSrc)
-    : dataSrc_(dataSrc)
+    : dataSrc_(dataSrc),
+      fillTaskQue_("DataSrcReadAhead", TaskPriority::NORMAL, true)
 {
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
 }
 
 MediaDataSourceStub::~MediaDataSourceStub()
 {
+    (void)fillTaskQue_.Stop();
     MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
 }
 
@@ -68,6 +71,27 @@ int MediaDataSourceStub::OnRemoteRequest(uint32_t code, MessageParcel &data, Mes
             reply.WriteInt32(ret);
             return MSERR_OK;
         }
+        case ListenerMsg::SET_READ_RING: {
+            bool hasRing = data.ReadBool();
+            bool seekable = data.ReadBool();
+            std::shared_ptr<MediaDataSourceRing> ring = nullptr;
+            if (hasRing) {
+                ring = MediaDataSourceRing::CreateFromParcel(data);
+                CHECK_AND_RETURN_RET_LOG(ring != nullptr, MSERR_INVALID_VAL, "failed to read ring");
+            }
+            reply.WriteInt32(SetReadRing(ring, seekable));
+            return MSERR_OK;
+        }
+        case ListenerMsg::SEEK_READ_RING: {
+            int64_t pos = data.ReadInt64();
+            reply.WriteInt32(SeekReadRing(pos));
+            return MSERR_OK;
+        }
+        case ListenerMsg::FILL_READ_RING: {
+            bool wait = data.ReadBool();
+            reply.WriteInt32(FillReadRing(wait));
+            return MSERR_OK;
+        }
         default: {
             MEDIA_LOGE("default case, need check MediaDataSourceStub");
             return IPCObjectStub::OnRemoteRequest(code, data, reply, option);
@@ -92,5 +116,108 @@ int32_t MediaDataSourceStub::GetSize(int64_t &size)
     CHECK_AND_RETURN_RET_LOG(dataSrc_ != nullptr, MSERR_INVALID_OPERATION, "dataSrc_ is nullptr");
     return dataSrc_->GetSize(size);
 }
+
+int32_t MediaDataSourceStub::SetReadRing(const std::shared_ptr<MediaDataSourceRing> &ring, bool seekable)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    (void)fillTaskQue_.Stop();
+    ring_ = ring;
+    seekable_ = seekable;
+    fillScheduled_ = false;
+    CHECK_AND_RETURN_RET(ring_ != nullptr, MSERR_OK);
+    CHECK_AND_RETURN_RET_LOG(dataSrc_ != nullptr, MSERR_INVALID_OPERATION, "dataSrc_ is nullptr");
+
+    // the first read waits for the consumer, which tells where to start
+    int32_t ret = fillTaskQue_.Start();
+    if (ret != MSERR_OK) {
+        ring_ = nullptr;
+    }
+    MEDIA_LOGI("read-ahead %{public}s, seekable: %{public}d", ret == MSERR_OK ? "on" : "off", seekable);
+    return ret;
+}
+
+int32_t MediaDataSourceStub::SeekReadRing(int64_t pos)
+{
+    auto task = std::make_shared<TaskHandler<int32_t>>([this, pos] {
+        CHECK_AND_RETURN_RET(ring_ != nullptr, MSERR_INVALID_OPERATION);
+        ring_->Reset(pos);
+        // the canceled read-ahead never clears the flag itself
+        fillScheduled_ = false;
+        if (FillOnce()) {
+            ScheduleFill();
+        }
+        return MSERR_OK;
+    });
+    // the data read ahead for the old position is useless
+    return RunFillTask(task, true);
+}
+
+int32_t MediaDataSourceStub::FillReadRing(bool wait)
+{
+    if (!wait) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        CHECK_AND_RETURN_RET(ring_ != nullptr, MSERR_INVALID_OPERATION);
+        ScheduleFill();
+        return MSERR_OK;
+    }
+
+    auto task = std::make_shared<TaskHandler<int32_t>>([this] {
+        CHECK_AND_RETURN_RET(ring_ != nullptr, MSERR_INVALID_OPERATION);
+        // the read-ahead queued before may have filled the ring already
+        if (!ring_->IsEmpty() || FillOnce()) {
+            ScheduleFill();
+        }
+        return MSERR_OK;
+    });
+    return RunFillTask(task, false);
+}
+
+int32_t MediaDataSourceStub::RunFillTask(const std::shared_ptr<TaskHandler<int32_t>> &task, bool cancelNotExecuted)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        CHECK_AND_RETURN_RET_LOG(ring_ != nullptr, MSERR_INVALID_OPERATION, "no read ring");
+        int32_t ret = fillTaskQue_.EnqueueTask(task, cancelNotExecuted);
+        CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "enqueue fill task failed");
+    }
+    auto result = task->GetResult();
+    return result.HasResult() ? result.Value() : MSERR_INVALID_OPERATION;
+}
+
+void MediaDataSourceStub::ScheduleFill()
+{
+    if (fillScheduled_.exchange(true)) {
+        return;
+    }
+    auto task = std::make_shared<TaskHandler<void>>([this] {
+        fillScheduled_ = false;
+        if (FillOnce()) {
+            ScheduleFill();
+        }
+    });
+    if (fillTaskQue_.EnqueueTask(task) != MSERR_OK) {
+        fillScheduled_ = false;
+    }
+}
+
+bool MediaDataSourceStub::FillOnce()
+{
+    CHECK_AND_RETURN_RET(ring_ != nullptr, false);
+    // one piece a time, so that a seek or a waiting consumer is not queued behind the whole ring
+    std::shared_ptr<AVSharedMemory> space = ring_->AcquireSpace(READ_AHEAD_SIZE);
+    if (space == nullptr) {
+        return false;
+    }
+
+    uint32_t length = static_cast<uint32_t>(space->GetSize());
+    int32_t size = seekable_ ? ReadAt(ring_->GetWritePos(), length, space) : ReadAt(length, space);
+    if (size > space->GetSize()) {
+        MEDIA_LOGE("ReadAt returns %{public}d more than %{public}u", size, length);
+        size = SOURCE_ERROR_IO;
+    }
+    ring_->Commit(size);
+    // nothing is read, the consumer asks for it again when the ring runs dry
+    return size > 0;
+}
 } // namespace Media
 } // namespace OHOS
\ No newline at end of file
@@ -16,9 +16,12 @@
 #ifndef MEDIA_DATA_SOURCE_STUB_H
 #define MEDIA_DATA_SOURCE_STUB_H
 
+#include <atomic>
+#include <mutex>
 #include "i_standard_media_data_source.h"
 #include "media_death_recipient.h"
 #include "nocopyable.h"
+#include "task_queue.h"
 
 namespace OHOS {
 namespace Media {
@@ -31,9 +34,22 @@ public:
     int32_t ReadAt(int64_t pos, uint32_t length, const std::shared_ptr<AVSharedMemory> &mem) override;
     int32_t ReadAt(uint32_t length, const std::shared_ptr<AVSharedMemory> &mem) override;
     int32_t GetSize(int64_t &size) override;
+    int32_t SetReadRing(const std::shared_ptr<MediaDataSourceRing> &ring, bool seekable) override;
+    int32_t SeekReadRing(int64_t pos) override;
+    int32_t FillReadRing(bool wait) override;
 
 private:
+    bool FillOnce();
+    void ScheduleFill();
+    int32_t RunFillTask(const std::shared_ptr<TaskHandler<int32_t>> &task, bool cancelNotExecuted);
+
     std::shared_ptr<IMediaDataSource> dataSrc_ = nullptr;
+    std::mutex mutex_;
+    // only accessed by the fill task after set
+    std::shared_ptr<MediaDataSourceRing> ring_ = nullptr;
+    bool seekable_ = false;
+    std::atomic<bool> fillScheduled_ = false;
+    TaskQueue fillTaskQue_;
 };
 } // namespace Media
 } // namespace OHOS
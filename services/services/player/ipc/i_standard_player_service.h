@@ -21,6 +21,7 @@
 #include "iremote_proxy.h"
 #include "iremote_stub.h"
 #include "player.h"
+#include "avsharedmemory.h"
 
 namespace OHOS {
 namespace Media {
@@ -56,6 +57,7 @@ public:
     virtual int32_t DestroyStub() = 0;
     virtual int32_t SetPlayerCallback() = 0;
     virtual int32_t SelectBitRate(uint32_t bitRate) = 0;
+    virtual std::shared_ptr<AVSharedMemory> GetPositionPage() = 0;
     /**
      * IPC code ID
      */
@@ -88,7 +90,8 @@ public:
         GET_AUDIO_TRACK_INFO,
         GET_VIDEO_WIDTH,
         GET_VIDEO_HEIGHT,
-        SELECT_BIT_RATE
+        SELECT_BIT_RATE,
+        GET_POSITION_PAGE
     };
 
     DECLARE_INTERFACE_DESCRIPTOR(u"IStandardPlayerService");
@@ -18,6 +18,7 @@
 #include "media_log.h"
 #include "media_errors.h"
 #include "media_parcel.h"
+#include "avsharedmemory_ipc.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "PlayerServiceProxy"};
@@ -295,8 +296,28 @@ int32_t PlayerServiceProxy::Seek(int32_t mSeconds, PlayerSeekMode mode)
     return reply.ReadInt32();
 }
 
+std::shared_ptr<PlayerPositionPage> PlayerServiceProxy::GetLocalPositionPage()
+{
+    std::lock_guard<std::mutex> lock(positionMutex_);
+    if (!positionPageQueried_) {
+        // asked only once, the server without the page always falls back to the IPC
+        positionPageQueried_ = true;
+        auto memory = GetPositionPage();
+        if (memory != nullptr) {
+            positionPage_ = PlayerPositionPage::Create(memory);
+        }
+    }
+    return positionPage_;
+}
+
 int32_t PlayerServiceProxy::GetCurrentTime(int32_t &currentTime)
 {
+    auto page = GetLocalPositionPage();
+    if (page != nullptr && page->GetCurrentTime(currentTime)) {
+        return MSERR_OK;
+    }
+
+    // the page is stale or invalid, ask the server which re-anchors the page as well
     MessageParcel data;
     MessageParcel reply;
     MessageOption option;
@@ -485,6 +506,26 @@ int32_t PlayerServiceProxy::SelectBitRate(uint32_t bitRate)
     return reply.ReadInt32();
 }
 
+std::shared_ptr<AVSharedMemory> PlayerServiceProxy::GetPositionPage()
+{
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(PlayerServiceProxy::GetDescriptor())) {
+        MEDIA_LOGE("Failed to write descriptor");
+        return nullptr;
+    }
+
+    int error = Remote()->SendRequest(GET_POSITION_PAGE, data, reply, option);
+    if (error != MSERR_OK) {
+        MEDIA_LOGW("Get position page failed, error: %{public}d", error);
+        return nullptr;
+    }
+
+    return ReadAVSharedMemoryFromParcel(reply);
+}
+
 int32_t PlayerServiceProxy::SetVideoSurface(sptr<Surface> surface)
 {
     MessageParcel data;
@@ -16,8 +16,10 @@
 #ifndef PLAYER_SERVICE_PROXY_H
 #define PLAYER_SERVICE_PROXY_H
 
+#include <mutex>
 #include "i_standard_player_service.h"
 #include "media_parcel.h"
+#include "player_position_page.h"
 
 namespace OHOS {
 namespace Media {
@@ -54,9 +56,15 @@ public:
     int32_t DestroyStub() override;
     int32_t SetPlayerCallback() override;
     int32_t SelectBitRate(uint32_t bitRate) override;
+    std::shared_ptr<AVSharedMemory> GetPositionPage() override;
 
 private:
+    std::shared_ptr<PlayerPositionPage> GetLocalPositionPage();
+
     static inline BrokerDelegator<PlayerServiceProxy> delegator_;
+    std::mutex positionMutex_;
+    std::shared_ptr<PlayerPositionPage> positionPage_;
+    bool positionPageQueried_ = false;
 };
 } // namespace Media
 } // namespace OHOS
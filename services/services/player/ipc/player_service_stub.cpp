@@ -21,6 +21,7 @@
 #include "media_log.h"
 #include "media_errors.h"
 #include "media_parcel.h"
+#include "avsharedmemory_ipc.h"
 #include "parameter.h"
 #include "media_dfx.h"
 
@@ -91,6 +92,7 @@ int32_t PlayerServiceStub::Init()
     playerFuncs_[GET_VIDEO_WIDTH] = &PlayerServiceStub::GetVideoWidth;
     playerFuncs_[GET_VIDEO_HEIGHT] = &PlayerServiceStub::GetVideoHeight;
     playerFuncs_[SELECT_BIT_RATE] = &PlayerServiceStub::SelectBitRate;
+    playerFuncs_[GET_POSITION_PAGE] = &PlayerServiceStub::GetPositionPage;
     return MSERR_OK;
 }
 
@@ -298,6 +300,12 @@ int32_t PlayerServiceStub::SelectBitRate(uint32_t bitRate)
     return playerServer_->SelectBitRate(bitRate);
 }
 
+std::shared_ptr<AVSharedMemory> PlayerServiceStub::GetPositionPage()
+{
+    CHECK_AND_RETURN_RET_LOG(playerServer_ != nullptr, nullptr, "player server is nullptr");
+    return playerServer_->GetPositionPage();
+}
+
 int32_t PlayerServiceStub::SetVideoSurface(sptr<Surface> surface)
 {
     MediaTrace Trace("binder::SetVideoSurface");
@@ -534,6 +542,17 @@ int32_t PlayerServiceStub::SelectBitRate(MessageParcel &data, MessageParcel &rep
     return MSERR_OK;
 }
 
+int32_t PlayerServiceStub::GetPositionPage(MessageParcel &data, MessageParcel &reply)
+{
+    (void)data;
+    auto page = GetPositionPage();
+    if (page == nullptr) {
+        return MSERR_UNSUPPORT;
+    }
+
+    return WriteAVSharedMemoryToParcel(page, reply);
+}
+
 int32_t PlayerServiceStub::SetVideoSurface(MessageParcel &data, MessageParcel &reply)
 {
     sptr<IRemoteObject> object = data.ReadRemoteObject();
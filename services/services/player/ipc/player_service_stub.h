@@ -61,6 +61,7 @@ public:
     int32_t SetPlayerCallback() override;
     int32_t DumpInfo(int32_t fd);
     int32_t SelectBitRate(uint32_t bitRate) override;
+    std::shared_ptr<AVSharedMemory> GetPositionPage() override;
 
 private:
     PlayerServiceStub();
@@ -94,6 +95,7 @@ private:
     int32_t DestroyStub(MessageParcel &data, MessageParcel &reply);
     int32_t SetPlayerCallback(MessageParcel &data, MessageParcel &reply);
     int32_t SelectBitRate(MessageParcel &data, MessageParcel &reply);
+    int32_t GetPositionPage(MessageParcel &data, MessageParcel &reply);
 
     std::mutex mutex_;
     std::shared_ptr<PlayerCallback> playerCallback_ = nullptr;
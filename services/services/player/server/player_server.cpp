@@ -89,6 +89,11 @@ int32_t PlayerServer::Init()
     pausedState_ = std::make_shared<PausedState>(*this);
     stoppedState_ = std::make_shared<StoppedState>(*this);
     playbackCompletedState_ = std::make_shared<PlaybackCompletedState>(*this);
+
+    positionPage_ = PlayerPositionPage::Create();
+    if (positionPage_ == nullptr) {
+        MEDIA_LOGW("failed to create position page, the current time is only got by the IPC");
+    }
     return MSERR_OK;
 }
 
@@ -156,6 +161,9 @@ int32_t PlayerServer::InitPlayEngine(const std::string &url)
     playerEngine_ = engineFactory->CreatePlayerEngine(appUid, appPid);
     CHECK_AND_RETURN_RET_LOG(playerEngine_ != nullptr, MSERR_CREATE_PLAYER_ENGINE_FAILED,
         "failed to create player engine");
+    if (positionPage_ != nullptr) {
+        (void)playerEngine_->SetPositionPage(positionPage_);
+    }
 
     if (dataSrc_ == nullptr) {
         ret = playerEngine_->SetSource(url);
@@ -170,6 +178,9 @@ int32_t PlayerServer::InitPlayEngine(const std::string &url)
 
     lastOpStatus_ = PLAYER_INITIALIZED;
     ChangeState(initializedState_);
+    if (positionPage_ != nullptr) {
+        positionPage_->SetActive(true);
+    }
 
     return MSERR_OK;
 }
@@ -377,6 +388,9 @@ int32_t PlayerServer::OnReset()
     (void)idleTask->GetResult();
     (void)taskMgr_.Reset();
     lastOpStatus_ = PLAYER_IDLE;
+    if (positionPage_ != nullptr) {
+        positionPage_->SetActive(false);
+    }
 
     return MSERR_OK;
 }
@@ -692,6 +706,12 @@ int32_t PlayerServer::SelectBitRate(uint32_t bitRate)
     return MSERR_OK;
 }
 
+std::shared_ptr<AVSharedMemory> PlayerServer::GetPositionPage()
+{
+    CHECK_AND_RETURN_RET(positionPage_ != nullptr, nullptr);
+    return positionPage_->GetMemory();
+}
+
 int32_t PlayerServer::SetVideoSurface(sptr<Surface> surface)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -847,6 +867,10 @@ int32_t PlayerServer::DumpInfo(int32_t fd)
 
 void PlayerServer::OnError(PlayerErrorType errorType, int32_t errorCode)
 {
+    if (positionPage_ != nullptr) {
+        // the client asks the server, which rejects it in the error state
+        positionPage_->SetActive(false);
+    }
     std::lock_guard<std::mutex> lockCb(mutexCb_);
     lastErrMsg_ = MSErrorToExtErrorString(static_cast<MediaServiceErrCode>(errorCode));
     FaultEventWrite(lastErrMsg_, "Player");
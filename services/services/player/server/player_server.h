@@ -22,6 +22,7 @@
 #include "nocopyable.h"
 #include "uri_helper.h"
 #include "player_server_task_mgr.h"
+#include "player_position_page.h"
 
 namespace OHOS {
 namespace Media {
@@ -100,6 +101,7 @@ public:
     int32_t SetPlayerCallback(const std::shared_ptr<PlayerCallback> &callback) override;
     int32_t DumpInfo(int32_t fd);
     int32_t SelectBitRate(uint32_t bitRate) override;
+    std::shared_ptr<AVSharedMemory> GetPositionPage() override;
 
     // IPlayerEngineObs override
     void OnError(PlayerErrorType errorType, int32_t errorCode) override;
@@ -136,6 +138,7 @@ private:
     void OnInfoNoChangeStatus(PlayerOnInfoType type, int32_t extra, const Format &infoBody = {});
 
     std::unique_ptr<IPlayerEngine> playerEngine_ = nullptr;
+    std::shared_ptr<PlayerPositionPage> positionPage_ = nullptr;
     std::shared_ptr<PlayerCallback> playerCb_ = nullptr;
     sptr<Surface> surface_ = nullptr;
     PlayerStates lastOpStatus_ = PLAYER_IDLE;
@@ -41,7 +41,7 @@ int32_t PlayerServerTaskMgr::Init()
         return MSERR_OK;
     }
 
-    taskThread_ = std::make_unique<TaskQueue>("player_server_task_mgr");
+    taskThread_ = std::make_unique<TaskQueue>("player_server_task_mgr", TaskPriority::HIGH);
     int32_t ret = taskThread_->Start();
     CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "task thread start failed");
 
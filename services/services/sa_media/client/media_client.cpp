@@ -22,6 +22,7 @@
 #include "i_standard_player_service.h"
 #include "i_standard_avmetadatahelper_service.h"
 #include "i_standard_avmuxer_service.h"
+#include "i_standard_avspliter_service.h"
 #include "media_log.h"
 #include "media_errors.h"
 
@@ -211,6 +212,28 @@ std::shared_ptr<IAVMuxerService> MediaClient::CreateAVMuxerService()
     return avmuxer;
 }
 
+std::shared_ptr<IAVSpliterService> MediaClient::CreateAVSpliterService()
+{
+    if (!IsAlived()) {
+        MEDIA_LOGE("media service does not exist.");
+        return nullptr;
+    }
+
+    sptr<IRemoteObject> object = mediaProxy_->GetSubSystemAbility(
+        IStandardMediaService::MediaSystemAbility::MEDIA_AVSPLITER, listenerStub_->AsObject());
+    CHECK_AND_RETURN_RET_LOG(object != nullptr, nullptr, "avspliter proxy object is nullptr.");
+
+    sptr<IStandardAVSpliterService> avspliterProxy = iface_cast<IStandardAVSpliterService>(object);
+    CHECK_AND_RETURN_RET_LOG(avspliterProxy != nullptr, nullptr, "spliter proxy is nullptr.");
+
+    std::shared_ptr<AVSpliterClient> avspliter = AVSpliterClient::Create(avspliterProxy);
+    CHECK_AND_RETURN_RET_LOG(avspliter != nullptr, nullptr, "failed to create avspliter client.");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    avspliterClientList_.push_back(avspliter);
+    return avspliter;
+}
+
 int32_t MediaClient::DestroyRecorderService(std::shared_ptr<IRecorderService> recorder)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -268,6 +291,14 @@ int32_t MediaClient::DestroyAVMuxerService(std::shared_ptr<IAVMuxerService> avmu
     return MSERR_OK;
 }
 
+int32_t MediaClient::DestroyAVSpliterService(std::shared_ptr<IAVSpliterService> avspliter)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET_LOG(avspliter != nullptr, MSERR_NO_MEMORY, "input avspliter is nullptr.");
+    avspliterClientList_.remove(avspliter);
+    return MSERR_OK;
+}
+
 sptr<IStandardMediaService> MediaClient::GetMediaProxy()
 {
     MEDIA_LOGD("enter");
@@ -360,6 +391,13 @@ void MediaClient::DoMediaServerDied()
             avmuxer->MediaServerDied();
         }
     }
+
+    for (auto &it : avspliterClientList_) {
+        auto avspliter = std::static_pointer_cast<AVSpliterClient>(it);
+        if (avspliter != nullptr) {
+            avspliter->MediaServerDied();
+        }
+    }
 }
 } // namespace Media
 } // namespace OHOS
@@ -27,6 +27,7 @@
 #include "avmetadatahelper_client.h"
 #include "avcodec_client.h"
 #include "avmuxer_client.h"
+#include "avspliter_client.h"
 #include "nocopyable.h"
 
 namespace OHOS {
@@ -43,6 +44,7 @@ public:
     std::shared_ptr<IAVCodecListService> CreateAVCodecListService() override;
     std::shared_ptr<IRecorderProfilesService> CreateRecorderProfilesService() override;
     std::shared_ptr<IAVMuxerService> CreateAVMuxerService() override;
+    std::shared_ptr<IAVSpliterService> CreateAVSpliterService() override;
     int32_t DestroyRecorderService(std::shared_ptr<IRecorderService> recorder) override;
     int32_t DestroyPlayerService(std::shared_ptr<IPlayerService> player) override;
     int32_t DestroyAVMetadataHelperService(std::shared_ptr<IAVMetadataHelperService> avMetadataHelper) override;
@@ -50,6 +52,7 @@ public:
     int32_t DestroyAVCodecListService(std::shared_ptr<IAVCodecListService> avCodecList) override;
     int32_t DestroyMediaProfileService(std::shared_ptr<IRecorderProfilesService> recorderProfiles) override;
     int32_t DestroyAVMuxerService(std::shared_ptr<IAVMuxerService> avmuxer) override;
+    int32_t DestroyAVSpliterService(std::shared_ptr<IAVSpliterService> avspliter) override;
 
 private:
     sptr<IStandardMediaService> GetMediaProxy();
@@ -67,6 +70,7 @@ private:
     std::list<std::shared_ptr<IAVCodecListService>> avCodecListClientList_;
     std::list<std::shared_ptr<IRecorderProfilesService>> recorderProfilesClientList_;
     std::list<std::shared_ptr<IAVMuxerService>> avmuxerClientList_;
+    std::list<std::shared_ptr<IAVSpliterService>> avspliterClientList_;
     std::mutex mutex_;
 };
 } // namespace Media
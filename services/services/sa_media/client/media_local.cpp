@@ -23,6 +23,7 @@
 #include "avcodeclist_server.h"
 #include "recorder_profiles_server.h"
 #include "avmuxer_server.h"
+#include "avspliter_server.h"
 
 namespace OHOS {
 namespace Media {
@@ -67,6 +68,11 @@ std::shared_ptr<IAVMuxerService> MediaLocal::CreateAVMuxerService()
     return AVMuxerServer::Create();
 }
 
+std::shared_ptr<IAVSpliterService> MediaLocal::CreateAVSpliterService()
+{
+    return AVSpliterServer::Create();
+}
+
 int32_t MediaLocal::DestroyRecorderService(std::shared_ptr<IRecorderService> recorder)
 {
     (void)recorder;
@@ -108,5 +114,11 @@ int32_t MediaLocal::DestroyAVMuxerService(std::shared_ptr<IAVMuxerService> avmux
     (void)avmuxer;
     return MSERR_OK;
 }
+
+int32_t MediaLocal::DestroyAVSpliterService(std::shared_ptr<IAVSpliterService> avspliter)
+{
+    (void)avspliter;
+    return MSERR_OK;
+}
 } // namespace Media
 } // namespace OHOS
@@ -33,6 +33,7 @@ public:
     std::shared_ptr<IAVCodecListService> CreateAVCodecListService() override;
     std::shared_ptr<IRecorderProfilesService> CreateRecorderProfilesService() override;
     std::shared_ptr<IAVMuxerService> CreateAVMuxerService() override;
+    std::shared_ptr<IAVSpliterService> CreateAVSpliterService() override;
     int32_t DestroyRecorderService(std::shared_ptr<IRecorderService> recorder) override;
     int32_t DestroyPlayerService(std::shared_ptr<IPlayerService> player) override;
     int32_t DestroyAVMetadataHelperService(std::shared_ptr<IAVMetadataHelperService> avMetadataHelper) override;
@@ -40,6 +41,7 @@ public:
     int32_t DestroyAVCodecListService(std::shared_ptr<IAVCodecListService> avCodecList) override;
     int32_t DestroyMediaProfileService(std::shared_ptr<IRecorderProfilesService> recorderProfiles) override;
     int32_t DestroyAVMuxerService(std::shared_ptr<IAVMuxerService> avmuxer) override;
+    int32_t DestroyAVSpliterService(std::shared_ptr<IAVSpliterService> avspliter) override;
 };
 } // namespace Media
 } // namespace OHOS
@@ -24,36 +24,56 @@ namespace OHOS {
 namespace Media {
 bool MediaParcel::Marshalling(MessageParcel &parcel, const Format &format)
 {
-    auto dataMap = format.GetFormatMap();
-    (void)parcel.WriteUint32(dataMap.size());
-    for (auto it = dataMap.begin(); it != dataMap.end(); ++it) {
-        (void)parcel.WriteString(it->first);
-        (void)parcel.WriteUint32(it->second.type);
-        switch (it->second.type) {
-            case FORMAT_TYPE_INT32:
-                (void)parcel.WriteInt32(it->second.val.int32Val);
+    std::vector<std::string_view> keys = format.GetKeys();
+    (void)parcel.WriteUint32(keys.size());
+    for (const auto &key : keys) {
+        FormatDataType type = format.GetValueType(key);
+        (void)parcel.WriteString(std::string(key));
+        (void)parcel.WriteUint32(type);
+        switch (type) {
+            case FORMAT_TYPE_INT32: {
+                int32_t value = 0;
+                (void)format.GetIntValue(key, value);
+                (void)parcel.WriteInt32(value);
                 break;
-            case FORMAT_TYPE_INT64:
-                (void)parcel.WriteInt64(it->second.val.int64Val);
+            }
+            case FORMAT_TYPE_INT64: {
+                int64_t value = 0;
+                (void)format.GetLongValue(key, value);
+                (void)parcel.WriteInt64(value);
                 break;
-            case FORMAT_TYPE_FLOAT:
-                (void)parcel.WriteFloat(it->second.val.floatVal);
+            }
+            case FORMAT_TYPE_FLOAT: {
+                float value = 0.0f;
+                (void)format.GetFloatValue(key, value);
+                (void)parcel.WriteFloat(value);
                 break;
-            case FORMAT_TYPE_DOUBLE:
-                (void)parcel.WriteDouble(it->second.val.doubleVal);
+            }
+            case FORMAT_TYPE_DOUBLE: {
+                double value = 0.0;
+                (void)format.GetDoubleValue(key, value);
+                (void)parcel.WriteDouble(value);
                 break;
-            case FORMAT_TYPE_STRING:
-                (void)parcel.WriteString(it->second.stringVal);
+            }
+            case FORMAT_TYPE_STRING: {
+                std::string value;
+                (void)format.GetStringValue(key, value);
+                (void)parcel.WriteString(value);
                 break;
-            case FORMAT_TYPE_ADDR:
-                (void)parcel.WriteInt32(static_cast<int32_t>(it->second.size));
-                (void)parcel.WriteBuffer(reinterpret_cast<const void *>(it->second.addr), it->second.size);
+            }
+            case FORMAT_TYPE_ADDR: {
+                uint8_t *addr = nullptr;
+                size_t size = 0;
+                (void)format.GetBuffer(key, &addr, size);
+                (void)parcel.WriteInt32(static_cast<int32_t>(size));
+                (void)parcel.WriteBuffer(reinterpret_cast<const void *>(addr), size);
                 break;
+            }
             default:
-                MEDIA_LOGE("fail to Marshalling Key: %{public}s", it->first.c_str());
+                MEDIA_LOGE("fail to Marshalling Key: %{public}s", key.data());
                 return false;
         }
-        MEDIA_LOGD("success to Marshalling Key: %{public}s", it->first.c_str());
+        MEDIA_LOGD("success to Marshalling Key: %{public}s", key.data());
     }
     return true;
 }
@@ -21,6 +21,8 @@
 #include "avcodeclist_service_stub.h"
 #include "recorder_profiles_service_stub.h"
 #include "avmuxer_service_stub.h"
+#include "avspliter_service_stub.h"
+#include "media_metrics.h"
 #include "media_log.h"
 #include "media_errors.h"
 
@@ -102,6 +104,17 @@ int32_t MediaServerManager::Dump(int32_t fd, const std::vector<std::u16string> &
         return OHOS::INVALID_OPERATION;
     }
 
+    if (argSets.find(u"metrics") != argSets.end()) {
+        dumpString += "------------------Metrics------------------\n";
+        MediaMetrics::Inst().Dump(dumpString);
+        if (fd != -1) {
+            write(fd, dumpString.c_str(), dumpString.size());
+        } else {
+            MEDIA_LOGI("%{public}s", dumpString.c_str());
+        }
+        dumpString.clear();
+    }
+
     return OHOS::NO_ERROR;
 }
 
@@ -140,6 +153,9 @@ sptr<IRemoteObject> MediaServerManager::CreateStubObject(StubType type)
         case AVMUXER: {
             return CreateAVMuxerStubObject();
         }
+        case AVSPLITER: {
+            return CreateAVSpliterStubObject();
+        }
         default: {
             MEDIA_LOGE("default case, media server manager failed");
             return nullptr;
@@ -345,6 +361,27 @@ sptr<IRemoteObject> MediaServerManager::CreateAVMuxerStubObject()
     return object;
 }
 
+sptr<IRemoteObject> MediaServerManager::CreateAVSpliterStubObject()
+{
+    if (avspliterStubMap_.size() >= SERVER_MAX_NUMBER) {
+        MEDIA_LOGE("The number of avspliter services(%{public}zu) has reached the upper limit."
+            "Please release the applied resources.", avspliterStubMap_.size());
+        return nullptr;
+    }
+    sptr<AVSpliterServiceStub> avspliterStub = AVSpliterServiceStub::Create();
+    if (avspliterStub == nullptr) {
+        MEDIA_LOGE("failed to create AVSpliterServiceStub");
+        return nullptr;
+    }
+    sptr<IRemoteObject> object = avspliterStub->AsObject();
+    if (object != nullptr) {
+        pid_t pid = IPCSkeleton::GetCallingPid();
+        avspliterStubMap_[object] = pid;
+        MEDIA_LOGD("The number of avspliter services(%{public}zu).", avspliterStubMap_.size());
+    }
+    return object;
+}
+
 void MediaServerManager::DestroyStubObject(StubType type, sptr<IRemoteObject> object)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -435,6 +472,18 @@ void MediaServerManager::DestroyStubObject(StubType type, sptr<IRemoteObject> ob
             MEDIA_LOGE("find avmuxer object failed, pid(%{public}d).", pid);
             break;
         }
+        case AVSPLITER: {
+            for (auto it = avspliterStubMap_.begin(); it != avspliterStubMap_.end(); it++) {
+                if (it->first == object) {
+                    MEDIA_LOGD("destroy avspliter stub services(%{public}zu) pid(%{public}d).",
+                        avspliterStubMap_.size(), pid);
+                    (void)avspliterStubMap_.erase(it);
+                    return;
+                }
+            }
+            MEDIA_LOGE("find avspliter object failed, pid(%{public}d).", pid);
+            break;
+        }
         default: {
             MEDIA_LOGE("default case, media server manager failed, pid(%{public}d).", pid);
             break;
@@ -515,6 +564,16 @@ void MediaServerManager::DestroyStubObjectForPid(pid_t pid)
         }
     }
     MEDIA_LOGD("avmuxer stub services(%{public}zu).", avmuxerStubMap_.size());
+
+    MEDIA_LOGD("avspliter stub services(%{public}zu) pid(%{public}d).", avspliterStubMap_.size(), pid);
+    for (auto itAVSpliter = avspliterStubMap_.begin(); itAVSpliter != avspliterStubMap_.end();) {
+        if (itAVSpliter->second == pid) {
+            itAVSpliter = avspliterStubMap_.erase(itAVSpliter);
+        } else {
+            itAVSpliter++;
+        }
+    }
+    MEDIA_LOGD("avspliter stub services(%{public}zu).", avspliterStubMap_.size());
 }
 
 void MediaServerManager::DestroyDumper(StubType type, sptr<IRemoteObject> object)
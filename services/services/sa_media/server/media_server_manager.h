@@ -47,6 +47,7 @@ public:
         AVCODEC,
         AVMUXER,
         RECORDERPROFILES,
+        AVSPLITER,
     };
     sptr<IRemoteObject> CreateStubObject(StubType type);
     void DestroyStubObject(StubType type, sptr<IRemoteObject> object);
@@ -64,6 +65,7 @@ private:
     sptr<IRemoteObject> CreateAVCodecStubObject();
     sptr<IRemoteObject> CreateRecorderProfilesStubObject();
     sptr<IRemoteObject> CreateAVMuxerStubObject();
+    sptr<IRemoteObject> CreateAVSpliterStubObject();
     std::map<sptr<IRemoteObject>, pid_t> recorderStubMap_;
     std::map<sptr<IRemoteObject>, pid_t> playerStubMap_;
     std::map<sptr<IRemoteObject>, pid_t> avMetadataHelperStubMap_;
@@ -71,6 +73,7 @@ private:
     std::map<sptr<IRemoteObject>, pid_t> avCodecStubMap_;
     std::map<sptr<IRemoteObject>, pid_t> recorderProfilesStubMap_;
     std::map<sptr<IRemoteObject>, pid_t> avmuxerStubMap_;
+    std::map<sptr<IRemoteObject>, pid_t> avspliterStubMap_;
     std::map<StubType, std::vector<Dumper>> dumperTbl_;
 
     std::mutex mutex_;
@@ -14,6 +14,9 @@
  */
 
 #include "avsharedmemorypool.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include "avsharedmemorybase.h"
 #include "media_log.h"
 #include "media_errors.h"
@@ -21,10 +24,303 @@
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "AVShMemPool"};
     constexpr int32_t MAX_MEM_SIZE = 100 * 1024 * 1024;
+    // size classes are split into 4 steps between the power of two, starting from 4KB up to MAX_MEM_SIZE.
+    constexpr uint32_t SIZE_CLASS_MIN_SHIFT = 11;
+    constexpr uint32_t SIZE_CLASS_STEP_SHIFT = 2;
+    constexpr uint32_t SIZE_CLASS_STEPS = 1 << SIZE_CLASS_STEP_SHIFT;
+    constexpr uint32_t SIZE_CLASS_NUM = 64;
+    // a block at most 2 times of the acquired size is acceptable before allocating a new one.
+    constexpr uint32_t SIZE_CLASS_SEARCH_RANGE = SIZE_CLASS_STEPS;
+    constexpr uint32_t INVALID_SLOT = 0;
+
+    uint32_t GetSizeClass(int32_t size)
+    {
+        uint32_t value = static_cast<uint32_t>(std::max(size, 1 << (SIZE_CLASS_MIN_SHIFT + 1))) - 1;
+        uint32_t shift = 31 - static_cast<uint32_t>(__builtin_clz(value));
+        uint32_t step = (value >> (shift - SIZE_CLASS_STEP_SHIFT)) & (SIZE_CLASS_STEPS - 1);
+        uint32_t sizeClass = (shift - SIZE_CLASS_MIN_SHIFT) * SIZE_CLASS_STEPS + step;
+        return std::min(sizeClass, SIZE_CLASS_NUM - 1);
+    }
+
+    int32_t GetSizeClassSize(uint32_t sizeClass)
+    {
+        uint32_t shift = sizeClass / SIZE_CLASS_STEPS + SIZE_CLASS_MIN_SHIFT;
+        uint32_t step = sizeClass % SIZE_CLASS_STEPS + 1;
+        return static_cast<int32_t>((SIZE_CLASS_STEPS + step) << (shift - SIZE_CLASS_STEP_SHIFT));
+    }
 }
 
 namespace OHOS {
 namespace Media {
+static AVSharedMemory *AllocMemoryBlock(int32_t size, uint32_t flags, const std::string &name)
+{
+    AVSharedMemoryBase *memory = new (std::nothrow) AVSharedMemoryBase(size, flags, name);
+    CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "create object failed");
+
+    if (memory->Init() != MSERR_OK) {
+        delete memory;
+        memory = nullptr;
+        MEDIA_LOGE("init avsharedmemorybase failed");
+    }
+
+    return memory;
+}
+
+static bool CheckAcquireSize(const AVSharedMemoryPool::InitializeOption &option, int32_t size)
+{
+    if (size <= 0 && size != -1) {
+        return false;
+    }
+
+    if (!option.enableFixedSize && size == -1) {
+        return false;
+    }
+
+    if (option.enableFixedSize) {
+        if (size > option.memSize) {
+            return false;
+        }
+
+        if (size <= 0 && size != -1) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * The memory blocks are indexed by the slots allocated at initialization, the slot id is stored
+ * in the release callback of the acquired memory, so that the release is O(1). The idle slots are
+ * linked into per size class free lists, each is an intrusive lock-free stack with a tagged head to
+ * avoid the ABA problem. The slots without a memory block are linked into the empty slot list,
+ * which bounds the total number of memory blocks to the maxMemCnt.
+ */
+class AVSharedMemoryPool::SizeClassCache
+    : public std::enable_shared_from_this<AVSharedMemoryPool::SizeClassCache>, public NoCopyable {
+public:
+    SizeClassCache(const InitializeOption &option, const std::string &name)
+        : option_(option), name_(name)
+    {
+        MEDIA_LOGD("enter ctor, 0x%{public}06" PRIXPTR ", name: %{public}s", FAKE_POINTER(this), name_.c_str());
+    }
+
+    ~SizeClassCache()
+    {
+        MEDIA_LOGD("enter dtor, 0x%{public}06" PRIXPTR ", name: %{public}s", FAKE_POINTER(this), name_.c_str());
+        // the busy memory blocks will be deleted by themselves when released.
+        uint32_t slot = INVALID_SLOT;
+        for (auto &freeList : freeLists_) {
+            while (freeList.Pop(blocks_.get(), slot)) {
+                delete blocks_[slot].memory;
+                blocks_[slot].memory = nullptr;
+            }
+        }
+    }
+
+    int32_t Init()
+    {
+        // slot 0 is reserved as the end of the free lists
+        blocks_ = std::make_unique<Block[]>(option_.maxMemCnt + 1);
+        CHECK_AND_RETURN_RET(blocks_ != nullptr, MSERR_NO_MEMORY);
+        for (uint32_t slot = option_.maxMemCnt; slot > INVALID_SLOT; --slot) {
+            emptySlots_.Push(blocks_.get(), slot);
+        }
+
+        // a block is filed under the class it can fully serve, so it is allocated at the class size.
+        uint32_t sizeClass = GetSizeClass(option_.memSize);
+        int32_t allocSize = option_.enableFixedSize ? option_.memSize : GetSizeClassSize(sizeClass);
+        uint32_t slot = INVALID_SLOT;
+        for (uint32_t i = 0; i < option_.preAllocMemCnt; ++i) {
+            CHECK_AND_RETURN_RET(emptySlots_.Pop(blocks_.get(), slot), MSERR_INVALID_VAL);
+            blocks_[slot].memory = AllocMemoryBlock(allocSize, option_.flags, name_);
+            if (blocks_[slot].memory == nullptr) {
+                MEDIA_LOGE("alloc memory failed");
+                emptySlots_.Push(blocks_.get(), slot);
+                return MSERR_NO_MEMORY;
+            }
+            blocks_[slot].sizeClass = sizeClass;
+            freeLists_[sizeClass].Push(blocks_.get(), slot);
+        }
+        return MSERR_OK;
+    }
+
+    std::shared_ptr<AVSharedMemory> Acquire(int32_t size, bool blocking)
+    {
+        if (!CheckAcquireSize(option_, size) || size >= MAX_MEM_SIZE) {
+            MEDIA_LOGE("invalid size: %{public}d", size);
+            return nullptr;
+        }
+        if (option_.enableFixedSize) {
+            size = option_.memSize;
+        }
+
+        uint32_t slot = INVALID_SLOT;
+        AVSharedMemory *memory = nullptr;
+        if (TryAcquire(size, slot, memory) && memory == nullptr && blocking) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            waiters_.fetch_add(1);
+            // retry after registered as a waiter, so that the wakeup from a concurrent release is never lost.
+            while (!closed_ && !nonBlocking_) {
+                if (!TryAcquire(size, slot, memory) || memory != nullptr) {
+                    break;
+                }
+                cond_.wait(lock);
+            }
+            waiters_.fetch_sub(1);
+        }
+
+        if (memory == nullptr) {
+            MEDIA_LOGD("acquire memory failed for size: %{public}d", size);
+            return nullptr;
+        }
+
+        MEDIA_LOGD("0x%{public}06" PRIXPTR " acquired from pool", FAKE_POINTER(memory));
+        return std::shared_ptr<AVSharedMemory>(memory, [weakCache = weak_from_this(), slot](AVSharedMemory *memory) {
+            std::shared_ptr<SizeClassCache> cache = weakCache.lock();
+            if (cache != nullptr) {
+                cache->Release(slot);
+            } else {
+                MEDIA_LOGI("release memory 0x%{public}06" PRIXPTR ", but the pool is reseted", FAKE_POINTER(memory));
+                delete memory;
+            }
+        });
+    }
+
+    void SetNonBlocking(bool enable)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        nonBlocking_ = enable;
+        if (nonBlocking_) {
+            cond_.notify_all();
+        }
+    }
+
+    void Close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        cond_.notify_all();
+    }
+
+private:
+    struct Block {
+        AVSharedMemory *memory = nullptr;
+        uint32_t sizeClass = 0;
+        std::atomic<uint32_t> next = INVALID_SLOT;
+    };
+
+    class FreeList {
+    public:
+        void Push(Block *blocks, uint32_t slot)
+        {
+            uint64_t head = head_.load(std::memory_order_relaxed);
+            uint64_t newHead = 0;
+            do {
+                blocks[slot].next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+                newHead = (NextTag(head) << TAG_SHIFT) | slot;
+            } while (!head_.compare_exchange_weak(head, newHead, std::memory_order_release,
+                std::memory_order_relaxed));
+        }
+
+        bool Pop(Block *blocks, uint32_t &slot)
+        {
+            uint64_t head = head_.load(std::memory_order_acquire);
+            while (static_cast<uint32_t>(head) != INVALID_SLOT) {
+                uint32_t top = static_cast<uint32_t>(head);
+                uint64_t newHead = (NextTag(head) << TAG_SHIFT) | blocks[top].next.load(std::memory_order_relaxed);
+                if (head_.compare_exchange_weak(head, newHead, std::memory_order_acquire,
+                    std::memory_order_acquire)) {
+                    slot = top;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        static constexpr uint32_t TAG_SHIFT = 32;
+        static uint64_t NextTag(uint64_t head)
+        {
+            return ((head >> TAG_SHIFT) + 1) & std::numeric_limits<uint32_t>::max();
+        }
+
+        // the higher 32 bits are the tag increased at every update, the lower 32 bits are the top slot.
+        std::atomic<uint64_t> head_ = INVALID_SLOT;
+    };
+
+    // return false if failed to allocate a new memory block, or output nullptr if no memory block available.
+    bool TryAcquire(int32_t size, uint32_t &slot, AVSharedMemory *&memory)
+    {
+        uint32_t sizeClass = GetSizeClass(size);
+        uint32_t lastClass = option_.enableFixedSize ? sizeClass :
+            std::min(sizeClass + SIZE_CLASS_SEARCH_RANGE, SIZE_CLASS_NUM - 1);
+        for (uint32_t i = sizeClass; i <= lastClass; ++i) {
+            if (freeLists_[i].Pop(blocks_.get(), slot)) {
+                memory = blocks_[slot].memory;
+                return true;
+            }
+        }
+
+        int32_t allocSize = option_.enableFixedSize ? size : GetSizeClassSize(sizeClass);
+        if (emptySlots_.Pop(blocks_.get(), slot)) {
+            return AllocToSlot(slot, allocSize, sizeClass, memory);
+        }
+
+        if (option_.enableFixedSize) {
+            return true;
+        }
+
+        // free the smallest idle memory block which can not satisfy the acquired size, and reallocate it.
+        for (uint32_t i = 0; i < SIZE_CLASS_NUM; ++i) {
+            if ((i < sizeClass || i > lastClass) && freeLists_[i].Pop(blocks_.get(), slot)) {
+                delete blocks_[slot].memory;
+                blocks_[slot].memory = nullptr;
+                return AllocToSlot(slot, allocSize, sizeClass, memory);
+            }
+        }
+        return true;
+    }
+
+    bool AllocToSlot(uint32_t slot, int32_t size, uint32_t sizeClass, AVSharedMemory *&memory)
+    {
+        memory = AllocMemoryBlock(size, option_.flags, name_);
+        if (memory == nullptr) {
+            emptySlots_.Push(blocks_.get(), slot);
+            return false;
+        }
+        blocks_[slot].memory = memory;
+        blocks_[slot].sizeClass = sizeClass;
+        return true;
+    }
+
+    void Release(uint32_t slot)
+    {
+        MEDIA_LOGD("0x%{public}06" PRIXPTR " released back to pool %{public}s",
+                   FAKE_POINTER(blocks_[slot].memory), name_.c_str());
+        freeLists_[blocks_[slot].sizeClass].Push(blocks_.get(), slot);
+
+        if (waiters_.load() > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cond_.notify_one();
+        }
+        if (option_.notifier != nullptr) {
+            option_.notifier();
+        }
+    }
+
+    const InitializeOption option_;
+    const std::string name_;
+    std::unique_ptr<Block[]> blocks_;
+    FreeList freeLists_[SIZE_CLASS_NUM];
+    FreeList emptySlots_;
+    std::atomic<uint32_t> waiters_ = 0;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool nonBlocking_ = false;
+    bool closed_ = false;
+};
+
 AVSharedMemoryPool::AVSharedMemoryPool(const std::string &name) : name_(name)
 {
     MEDIA_LOGD("enter ctor, 0x%{public}06" PRIXPTR ", name: %{public}s", FAKE_POINTER(this), name_.c_str());
@@ -50,9 +346,21 @@ int32_t AVSharedMemoryPool::Init(const InitializeOption &option)
     }
 
     MEDIA_LOGI("name: %{public}s, init option: preAllocMemCnt = %{public}u, memSize = %{public}d, "
-               "maxMemCnt = %{public}u, enableFixedSize = %{public}d",
+               "maxMemCnt = %{public}u, enableFixedSize = %{public}d, enableSizeClass = %{public}d",
                name_.c_str(), option_.preAllocMemCnt, option_.memSize, option_.maxMemCnt,
-               option_.enableFixedSize);
+               option_.enableFixedSize, option_.enableSizeClass);
+    if (option_.enableSizeClass) {
+        auto cache = std::make_shared<SizeClassCache>(option_, name_);
+        CHECK_AND_RETURN_RET_LOG(cache != nullptr, MSERR_NO_MEMORY, "create size class cache failed");
+        int32_t ret = cache->Init();
+        CHECK_AND_RETURN_RET(ret == MSERR_OK, ret);
+        cache->SetNonBlocking(forceNonBlocking_);
+        std::atomic_store(&sizeClassCache_, cache);
+        inited_ = true;
+        notifier_ = option.notifier;
+        return MSERR_OK;
+    }
+
     bool ret = true;
     for (uint32_t i = 0; i < option_.preAllocMemCnt; ++i) {
         auto memory = AllocMemory(option_.memSize);
@@ -79,16 +387,7 @@ int32_t AVSharedMemoryPool::Init(const InitializeOption &option)
 
 AVSharedMemory *AVSharedMemoryPool::AllocMemory(int32_t size)
 {
-    AVSharedMemoryBase *memory = new (std::nothrow) AVSharedMemoryBase(size, option_.flags, name_);
-    CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "create object failed");
-
-    if (memory->Init() != MSERR_OK) {
-        delete memory;
-        memory = nullptr;
-        MEDIA_LOGE("init avsharedmemorybase failed");
-    }
-
-    return memory;
+    return AllocMemoryBlock(size, option_.flags, name_);
 }
 
 void AVSharedMemoryPool::ReleaseMemory(AVSharedMemory *memory)
@@ -162,25 +461,7 @@ bool AVSharedMemoryPool::DoAcquireMemory(int32_t size, AVSharedMemory **outMemor
 
 bool AVSharedMemoryPool::CheckSize(int32_t size)
 {
-    if (size <= 0 && size != -1) {
-        return false;
-    }
-
-    if (!option_.enableFixedSize && size == -1) {
-        return false;
-    }
-
-    if (option_.enableFixedSize) {
-        if (size > option_.memSize) {
-            return false;
-        }
-
-        if (size <= 0 && size != -1) {
-            return false;
-        }
-    }
-
-    return true;
+    return CheckAcquireSize(option_, size);
 }
 
 std::shared_ptr<AVSharedMemory> AVSharedMemoryPool::AcquireMemory(int32_t size, bool blocking)
@@ -188,6 +469,11 @@ std::shared_ptr<AVSharedMemory> AVSharedMemoryPool::AcquireMemory(int32_t size,
     MEDIA_LOGD("acquire memory for size: %{public}d from pool %{public}s, blocking: %{public}d",
                size, name_.c_str(), blocking);
 
+    std::shared_ptr<SizeClassCache> cache = std::atomic_load(&sizeClassCache_);
+    if (cache != nullptr) {
+        return cache->Acquire(size, blocking);
+    }
+
     std::unique_lock<std::mutex> lock(mutex_);
     if (!CheckSize(size)) {
         MEDIA_LOGE("invalid size: %{public}d", size);
@@ -240,6 +526,10 @@ void AVSharedMemoryPool::SetNonBlocking(bool enable)
     if (forceNonBlocking_) {
         cond_.notify_all();
     }
+    std::shared_ptr<SizeClassCache> cache = std::atomic_load(&sizeClassCache_);
+    if (cache != nullptr) {
+        cache->SetNonBlocking(enable);
+    }
 }
 
 void AVSharedMemoryPool::Reset()
@@ -252,6 +542,11 @@ void AVSharedMemoryPool::Reset()
         memory = nullptr;
     }
     idleList_.clear();
+    // the idle memory blocks of the size class cache are freed after the acquisitions in progress returned.
+    auto cache = std::atomic_exchange(&sizeClassCache_, std::shared_ptr<SizeClassCache>());
+    if (cache != nullptr) {
+        cache->Close();
+    }
     inited_ = false;
     forceNonBlocking_ = false;
     notifier_ = nullptr;
@@ -14,75 +14,137 @@
  */
 
 #include "format.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <shared_mutex>
+#include <unordered_set>
 #include "securec.h"
 #include "media_log.h"
 #include "media_errors.h"
 
 namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "Format"};
+constexpr size_t BUFFER_SIZE_MAX = 1 * 1024 * 1024;
+// keys normally come from a small fixed vocabulary, the limits only bound what arbitrary keys can cost
+constexpr size_t INTERNED_KEY_COUNT_MAX = 4096;
+constexpr size_t INTERNED_KEY_LEN_MAX = 128;
+
+class FormatKeyPool {
+public:
+    static FormatKeyPool &GetInstance()
+    {
+        // never destroyed: static Formats may still refer to interned keys during exit
+        static FormatKeyPool *instance = new FormatKeyPool();
+        return *instance;
+    }
+
+    bool Intern(const std::string_view &key, std::string_view &interned)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto iter = keys_.find(key);
+            if (iter != keys_.end()) {
+                interned = *iter;
+                return true;
+            }
+        }
+        if (key.size() > INTERNED_KEY_LEN_MAX) {
+            return false;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto iter = keys_.find(key);
+        if (iter != keys_.end()) {
+            interned = *iter;
+            return true;
+        }
+        if (keys_.size() >= INTERNED_KEY_COUNT_MAX) {
+            return false;
+        }
+        auto buffer = std::make_unique<char[]>(key.size() + 1);
+        if (!key.empty() && memcpy_s(buffer.get(), key.size() + 1, key.data(), key.size()) != EOK) {
+            return false;
+        }
+        buffer[key.size()] = '\0';
+        interned = std::string_view(buffer.get(), key.size());
+        storage_.push_back(std::move(buffer));
+        (void)keys_.insert(interned);
+        return true;
+    }
+
+private:
+    FormatKeyPool() = default;
+    ~FormatKeyPool() = default;
+
+    std::shared_mutex mutex_;
+    std::unordered_set<std::string_view> keys_;
+    std::vector<std::unique_ptr<char[]>> storage_;
+};
 }
 
 namespace OHOS {
 namespace Media {
-void CopyFormatDataMap(const Format::FormatDataMap &from, Format::FormatDataMap &to)
-{
-    for (auto it = to.begin(); it != to.end(); ++it) {
-        if (it->second.type == FORMAT_TYPE_ADDR && it->second.addr != nullptr) {
-            free(it->second.addr);
-            it->second.addr = nullptr;
-        }
+// immutable once created, so sharing it between copies of a Format is copy-on-write for free
+struct Format::Payload {
+    std::atomic<uint32_t> refCount;
+    size_t size;
+
+    uint8_t *Data()
+    {
+        return reinterpret_cast<uint8_t *>(this + 1);
     }
 
-    to = from;
+    std::string_view View()
+    {
+        return std::string_view(reinterpret_cast<const char *>(Data()), size);
+    }
 
-    for (auto it = to.begin(); it != to.end();) {
-        if (it->second.type != FORMAT_TYPE_ADDR || it->second.addr == nullptr) {
-            ++it;
-            continue;
+    static Payload *Create(const void *data, size_t dataSize)
+    {
+        // one extra byte keeps string payloads nul-terminated
+        void *mem = malloc(sizeof(Payload) + dataSize + 1);
+        CHECK_AND_RETURN_RET_LOG(mem != nullptr, nullptr, "malloc payload failed, size: %{public}zu", dataSize);
+        Payload *payload = new (mem) Payload { {1}, dataSize };
+        if (dataSize > 0 && memcpy_s(payload->Data(), dataSize, data, dataSize) != EOK) {
+            MEDIA_LOGE("memcpy payload failed, size: %{public}zu", dataSize);
+            Unref(payload);
+            return nullptr;
         }
+        payload->Data()[dataSize] = 0;
+        return payload;
+    }
 
-        it->second.addr = reinterpret_cast<uint8_t *>(malloc(it->second.size));
-        if (it->second.addr == nullptr) {
-            MEDIA_LOGE("malloc addr failed. Key: %{public}s", it->first.c_str());
-            it = to.erase(it);
-            continue;
+    static void Ref(Payload *payload)
+    {
+        if (payload != nullptr) {
+            payload->refCount.fetch_add(1, std::memory_order_relaxed);
         }
+    }
 
-        errno_t err = memcpy_s(reinterpret_cast<void *>(it->second.addr),
-            it->second.size, reinterpret_cast<const void *>(from.at(it->first).addr), it->second.size);
-        if (err != EOK) {
-            MEDIA_LOGE("memcpy addr failed. Key: %{public}s", it->first.c_str());
-            free(it->second.addr);
-            it->second.addr = nullptr;
-            it = to.erase(it);
-            continue;
+    static void Unref(Payload *payload)
+    {
+        if (payload != nullptr && payload->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            payload->~Payload();
+            free(payload);
         }
-        ++it;
     }
-}
+};
 
 Format::~Format()
 {
-    for (auto it = formatMap_.begin(); it != formatMap_.end(); ++it) {
-        if (it->second.type == FORMAT_TYPE_ADDR && it->second.addr != nullptr) {
-            free(it->second.addr);
-            it->second.addr = nullptr;
-        }
-    }
+    Reset();
 }
 
 Format::Format(const Format &rhs)
 {
-    if (&rhs == this) {
-        return;
-    }
-
-    CopyFormatDataMap(rhs.formatMap_, formatMap_);
+    CopyFrom(rhs);
 }
 
 Format::Format(Format &&rhs) noexcept
 {
-    std::swap(formatMap_, rhs.formatMap_);
+    MoveFrom(rhs);
 }
 
 Format &Format::operator=(const Format &rhs)
@@ -91,7 +153,8 @@ Format &Format::operator=(const Format &rhs)
         return *this;
     }
 
-    CopyFormatDataMap(rhs.formatMap_, this->formatMap_);
+    Reset();
+    CopyFrom(rhs);
     return *this;
 }
 
@@ -101,112 +164,232 @@ Format &Format::operator=(Format &&rhs) noexcept
         return *this;
     }
 
-    std::swap(this->formatMap_, rhs.formatMap_);
+    Reset();
+    MoveFrom(rhs);
     return *this;
 }
 
+Format::Entry *Format::Data()
+{
+    return heapEntries_ != nullptr ? heapEntries_ : reinterpret_cast<Entry *>(inlineEntries_);
+}
+
+const Format::Entry *Format::Data() const
+{
+    return heapEntries_ != nullptr ? heapEntries_ : reinterpret_cast<const Entry *>(inlineEntries_);
+}
+
+void Format::Reset()
+{
+    Entry *entries = Data();
+    for (uint32_t i = 0; i < size_; i++) {
+        Payload::Unref(entries[i].keyOwner);
+        Payload::Unref(entries[i].payload);
+    }
+    size_ = 0;
+    free(heapEntries_);
+    heapEntries_ = nullptr;
+    capacity_ = INLINE_ENTRIES;
+}
+
+void Format::CopyFrom(const Format &rhs)
+{
+    if (!Reserve(rhs.size_)) {
+        return;
+    }
+
+    Entry *entries = Data();
+    const Entry *rhsEntries = rhs.Data();
+    for (uint32_t i = 0; i < rhs.size_; i++) {
+        entries[i] = rhsEntries[i];
+        Payload::Ref(entries[i].keyOwner);
+        Payload::Ref(entries[i].payload);
+    }
+    size_ = rhs.size_;
+}
+
+void Format::MoveFrom(Format &rhs)
+{
+    if (rhs.heapEntries_ != nullptr) {
+        heapEntries_ = rhs.heapEntries_;
+        capacity_ = rhs.capacity_;
+        rhs.heapEntries_ = nullptr;
+        rhs.capacity_ = INLINE_ENTRIES;
+    } else {
+        std::copy(rhs.Data(), rhs.Data() + rhs.size_, Data());
+    }
+    size_ = rhs.size_;
+    rhs.size_ = 0;
+}
+
+bool Format::Reserve(uint32_t capacity)
+{
+    if (capacity <= capacity_) {
+        return true;
+    }
+
+    uint32_t newCapacity = std::max(capacity, capacity_ * 2); // 2: grow geometrically
+    Entry *newEntries = reinterpret_cast<Entry *>(malloc(newCapacity * sizeof(Entry)));
+    CHECK_AND_RETURN_RET_LOG(newEntries != nullptr, false, "malloc entries failed, count: %{public}u", newCapacity);
+
+    std::copy(Data(), Data() + size_, newEntries);
+    free(heapEntries_);
+    heapEntries_ = newEntries;
+    capacity_ = newCapacity;
+    return true;
+}
+
+uint32_t Format::LowerBound(const std::string_view &key) const
+{
+    const Entry *entries = Data();
+    const Entry *iter = std::lower_bound(entries, entries + size_, key,
+        [](const Entry &entry, const std::string_view &target) { return entry.key < target; });
+    return static_cast<uint32_t>(iter - entries);
+}
+
+const Format::Entry *Format::FindEntry(const std::string_view &key) const
+{
+    const Entry *entries = Data();
+    if (size_ <= INLINE_ENTRIES) {
+        // most keys differ in length, so a linear scan rarely gets to compare characters
+        for (uint32_t i = 0; i < size_; i++) {
+            if (entries[i].key.size() == key.size() && entries[i].key == key) {
+                return &entries[i];
+            }
+        }
+        return nullptr;
+    }
+    uint32_t index = LowerBound(key);
+    if (index < size_ && entries[index].key == key) {
+        return &entries[index];
+    }
+    return nullptr;
+}
+
+bool Format::PutEntry(const std::string_view &key, FormatDataType type, FormatData::Val val, Payload *payload)
+{
+    uint32_t index = LowerBound(key);
+    Entry *entries = Data();
+    if (index < size_ && entries[index].key == key) {
+        Payload::Unref(entries[index].payload);
+        entries[index].type = type;
+        entries[index].val = val;
+        entries[index].payload = payload;
+        return true;
+    }
+
+    Entry entry = { std::string_view(), nullptr, payload, type, val };
+    if (!FormatKeyPool::GetInstance().Intern(key, entry.key)) {
+        entry.keyOwner = Payload::Create(key.data(), key.size());
+        if (entry.keyOwner == nullptr) {
+            Payload::Unref(payload);
+            return false;
+        }
+        entry.key = entry.keyOwner->View();
+    }
+
+    if (!Reserve(size_ + 1)) {
+        Payload::Unref(entry.keyOwner);
+        Payload::Unref(payload);
+        return false;
+    }
+    entries = Data();
+    std::copy_backward(entries + index, entries + size_, entries + size_ + 1);
+    entries[index] = entry;
+    size_++;
+    return true;
+}
+
 bool Format::PutIntValue(const std::string_view &key, int32_t value)
 {
-    FormatData data;
-    data.type = FORMAT_TYPE_INT32;
-    data.val.int32Val = value;
-    RemoveKey(key);
-    auto ret = formatMap_.insert(std::make_pair(key, data));
-    return ret.second;
+    FormatData::Val val = {0};
+    val.int32Val = value;
+    return PutEntry(key, FORMAT_TYPE_INT32, val, nullptr);
 }
 
 bool Format::PutLongValue(const std::string_view &key, int64_t value)
 {
-    FormatData data;
-    data.type = FORMAT_TYPE_INT64;
-    data.val.int64Val = value;
-    RemoveKey(key);
-    auto ret = formatMap_.insert(std::make_pair(key, data));
-    return ret.second;
+    FormatData::Val val = {0};
+    val.int64Val = value;
+    return PutEntry(key, FORMAT_TYPE_INT64, val, nullptr);
 }
 
 bool Format::PutFloatValue(const std::string_view &key, float value)
 {
-    FormatData data;
-    data.type = FORMAT_TYPE_FLOAT;
-    data.val.floatVal = value;
-    RemoveKey(key);
-    auto ret = formatMap_.insert(std::make_pair(key, data));
-    return ret.second;
+    FormatData::Val val = {0};
+    val.floatVal = value;
+    return PutEntry(key, FORMAT_TYPE_FLOAT, val, nullptr);
 }
 
 bool Format::PutDoubleValue(const std::string_view &key, double value)
 {
-    FormatData data;
-    data.type = FORMAT_TYPE_DOUBLE;
-    data.val.doubleVal = value;
-    RemoveKey(key);
-    auto ret = formatMap_.insert(std::make_pair(key, data));
-    return ret.second;
+    FormatData::Val val = {0};
+    val.doubleVal = value;
+    return PutEntry(key, FORMAT_TYPE_DOUBLE, val, nullptr);
 }
 
 bool Format::PutStringValue(const std::string_view &key, const std::string_view &value)
 {
-    FormatData data;
-    data.type = FORMAT_TYPE_STRING;
-    data.stringVal = value;
-    RemoveKey(key);
-    auto ret = formatMap_.insert(std::make_pair(key, data));
-    return ret.second;
+    Payload *payload = Payload::Create(value.data(), value.size());
+    if (payload == nullptr) {
+        MEDIA_LOGE("PutStringValue failed. Key: %{public}s", key.data());
+        return false;
+    }
+    return PutEntry(key, FORMAT_TYPE_STRING, FormatData::Val {0}, payload);
 }
 
 bool Format::GetStringValue(const std::string_view &key, std::string &value) const
 {
-    auto iter = formatMap_.find(key);
-    if (iter == formatMap_.end() || iter->second.type != FORMAT_TYPE_STRING) {
+    const Entry *entry = FindEntry(key);
+    if (entry == nullptr || entry->type != FORMAT_TYPE_STRING) {
         MEDIA_LOGE("Format::GetFormat failed. Key: %{public}s", key.data());
         return false;
     }
-    value = iter->second.stringVal;
+    value = entry->payload->View();
     return true;
 }
 
 bool Format::GetIntValue(const std::string_view &key, int32_t &value) const
 {
-    auto iter = formatMap_.find(key);
-    if (iter == formatMap_.end() || iter->second.type != FORMAT_TYPE_INT32) {
+    const Entry *entry = FindEntry(key);
+    if (entry == nullptr || entry->type != FORMAT_TYPE_INT32) {
         MEDIA_LOGE("Format::GetFormat failed. Key: %{public}s", key.data());
         return false;
     }
-    value = iter->second.val.int32Val;
+    value = entry->val.int32Val;
     return true;
 }
 
 bool Format::GetLongValue(const std::string_view &key, int64_t &value) const
 {
-    auto iter = formatMap_.find(key);
-    if (iter == formatMap_.end() || iter->second.type != FORMAT_TYPE_INT64) {
+    const Entry *entry = FindEntry(key);
+    if (entry == nullptr || entry->type != FORMAT_TYPE_INT64) {
         MEDIA_LOGE("Format::GetFormat failed. Key: %{public}s", key.data());
         return false;
     }
-    value = iter->second.val.int64Val;
+    value = entry->val.int64Val;
     return true;
 }
 
 bool Format::GetFloatValue(const std::string_view &key, float &value) const
 {
-    auto iter = formatMap_.find(key);
-    if (iter == formatMap_.end() || iter->second.type != FORMAT_TYPE_FLOAT) {
+    const Entry *entry = FindEntry(key);
+    if (entry == nullptr || entry->type != FORMAT_TYPE_FLOAT) {
         MEDIA_LOGE("Format::GetFormat failed. Key: %{public}s", key.data());
         return false;
     }
-    value = iter->second.val.floatVal;
+    value = entry->val.floatVal;
     return true;
 }
 
 bool Format::GetDoubleValue(const std::string_view &key, double &value) const
 {
-    auto iter = formatMap_.find(key);
-    if (iter == formatMap_.end() || iter->second.type != FORMAT_TYPE_DOUBLE) {
+    const Entry *entry = FindEntry(key);
+    if (entry == nullptr || entry->type != FORMAT_TYPE_DOUBLE) {
         MEDIA_LOGE("Format::GetFormat failed. Key: %{public}s", key.data());
         return false;
     }
-    value = iter->second.val.doubleVal;
+    value = entry->val.doubleVal;
     return true;
 }
 
@@ -217,110 +400,118 @@ bool Format::PutBuffer(const std::string_view &key, const uint8_t *addr, size_t
         return false;
     }
 
-    constexpr size_t sizeMax = 1 * 1024 * 1024;
-    if (size > sizeMax) {
+    if (size > BUFFER_SIZE_MAX) {
         MEDIA_LOGE("PutBuffer input size failed. Key: %{public}s", key.data());
         return false;
     }
 
-    FormatData data;
-    data.type = FORMAT_TYPE_ADDR;
-    data.addr = reinterpret_cast<uint8_t *>(malloc(size));
-    if (data.addr == nullptr) {
-        MEDIA_LOGE("malloc addr failed. Key: %{public}s", key.data());
+    Payload *payload = Payload::Create(addr, size);
+    if (payload == nullptr) {
+        MEDIA_LOGE("PutBuffer copy addr failed. Key: %{public}s", key.data());
         return false;
     }
-
-    errno_t err = memcpy_s(reinterpret_cast<void *>(data.addr), size, reinterpret_cast<const void *>(addr), size);
-    if (err != EOK) {
-        MEDIA_LOGE("PutBuffer memcpy addr failed. Key: %{public}s", key.data());
-        free(data.addr);
-        return false;
-    }
-
-    RemoveKey(key);
-
-    data.size = size;
-    auto ret = formatMap_.insert(std::make_pair(key, data));
-    return ret.second;
+    return PutEntry(key, FORMAT_TYPE_ADDR, FormatData::Val {0}, payload);
 }
 
 bool Format::GetBuffer(const std::string_view &key, uint8_t **addr, size_t &size) const
 {
-    auto iter = formatMap_.find(key);
-    if (iter == formatMap_.end() || iter->second.type != FORMAT_TYPE_ADDR) {
+    const Entry *entry = FindEntry(key);
+    if (entry == nullptr || entry->type != FORMAT_TYPE_ADDR) {
         MEDIA_LOGE("Format::GetBuffer failed. Key: %{public}s", key.data());
         return false;
     }
-    *addr = iter->second.addr;
-    size = iter->second.size;
+    *addr = entry->payload->Data();
+    size = entry->payload->size;
     return true;
 }
 
 bool Format::ContainKey(const std::string_view &key) const
 {
-    auto iter = formatMap_.find(key);
-    if (iter != formatMap_.end()) {
-        return true;
-    }
-
-    return false;
+    return FindEntry(key) != nullptr;
 }
 
 FormatDataType Format::GetValueType(const std::string_view &key) const
 {
-    auto iter = formatMap_.find(key);
-    if (iter == formatMap_.end()) {
+    const Entry *entry = FindEntry(key);
+    if (entry == nullptr) {
         return FORMAT_TYPE_NONE;
     }
 
-    return iter->second.type;
+    return entry->type;
 }
 
 void Format::RemoveKey(const std::string_view &key)
 {
-    auto iter = formatMap_.find(key);
-    if (iter != formatMap_.end()) {
-        if (iter->second.type == FORMAT_TYPE_ADDR && iter->second.addr != nullptr) {
-            free(iter->second.addr);
-            iter->second.addr = nullptr;
-        }
-        formatMap_.erase(iter);
+    uint32_t index = LowerBound(key);
+    Entry *entries = Data();
+    if (index < size_ && entries[index].key == key) {
+        Payload::Unref(entries[index].keyOwner);
+        Payload::Unref(entries[index].payload);
+        std::copy(entries + index + 1, entries + size_, entries + index);
+        size_--;
     }
 }
 
-const Format::FormatDataMap &Format::GetFormatMap() const
+std::vector<std::string_view> Format::GetKeys() const
 {
-    return formatMap_;
+    std::vector<std::string_view> keys;
+    keys.reserve(size_);
+    const Entry *entries = Data();
+    for (uint32_t i = 0; i < size_; i++) {
+        keys.push_back(entries[i].key);
+    }
+    return keys;
+}
+
+Format::FormatDataMap Format::GetFormatMap() const
+{
+    FormatDataMap formatMap;
+    const Entry *entries = Data();
+    for (uint32_t i = 0; i < size_; i++) {
+        FormatData data;
+        data.type = entries[i].type;
+        data.val = entries[i].val;
+        if (entries[i].type == FORMAT_TYPE_STRING) {
+            data.stringVal = entries[i].payload->View();
+        } else if (entries[i].type == FORMAT_TYPE_ADDR) {
+            data.addr = entries[i].payload->Data();
+            data.size = entries[i].payload->size;
+        }
+        // entries are already sorted, so every insertion lands at the end
+        (void)formatMap.emplace_hint(formatMap.end(), entries[i].key, data);
+    }
+    return formatMap;
 }
 
 std::string Format::Stringify() const
 {
     std::string outString;
-    for (auto iter = formatMap_.begin(); iter != formatMap_.end(); iter++) {
-        switch (GetValueType(iter->first)) {
+    const Entry *entries = Data();
+    for (uint32_t i = 0; i < size_; i++) {
+        const Entry &entry = entries[i];
+        switch (entry.type) {
             case FORMAT_TYPE_INT32:
-                outString += iter->first + " = " + std::to_string(iter->second.val.int32Val) + "\n";
+                outString.append(entry.key).append(" = ").append(std::to_string(entry.val.int32Val)) += "\n";
                 break;
             case FORMAT_TYPE_INT64:
-                outString += iter->first + " = " + std::to_string(iter->second.val.int64Val) + "\n";
+                outString.append(entry.key).append(" = ").append(std::to_string(entry.val.int64Val)) += "\n";
                 break;
             case FORMAT_TYPE_FLOAT:
-                outString += iter->first + " = " + std::to_string(iter->second.val.floatVal) + "\n";
+                outString.append(entry.key).append(" = ").append(std::to_string(entry.val.floatVal)) += "\n";
                 break;
             case FORMAT_TYPE_DOUBLE:
-                outString += iter->first + " = " + std::to_string(iter->second.val.doubleVal) + "\n";
+                outString.append(entry.key).append(" = ").append(std::to_string(entry.val.doubleVal)) += "\n";
                 break;
             case FORMAT_TYPE_STRING:
-                outString += iter->first + " = " + iter->second.stringVal + "\n";
+                outString.append(entry.key).append(" = ").append(entry.payload->View()) += "\n";
                 break;
             case FORMAT_TYPE_ADDR:
                 break;
             default:
-                MEDIA_LOGE("Format::Stringify failed. Key: %{public}s", iter->first.c_str());
+                MEDIA_LOGE("Format::Stringify failed. Key: %{public}s", entry.key.data());
         }
     }
     return outString;
 }
 } // namespace Media
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
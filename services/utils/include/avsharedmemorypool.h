@@ -40,6 +40,12 @@ namespace Media {
  *                  satisfy the acqiured size and reallocate a new memory block with the acquired size.
  * @notifier: the callback will be called to notify there are any available memory. It will be useful for
  *            non-blocking memory acquisition.
+ * @enableSizeClass: if true, the idle memory blocks are kept in per size class lock-free free lists, the
+ *                   acquisition and the release will not contend on the pool's lock, and only one waiter
+ *                   will be awaken up for each released memory block. The memory blocks still busy are
+ *                   freed once they are released after the pool is reseted. Without the enableFixedSize,
+ *                   the memory blocks are allocated at the size of their class, which may be larger than
+ *                   the acquired size or the memSize.
  */
 class __attribute__((visibility("default"))) AVSharedMemoryPool
     : public std::enable_shared_from_this<AVSharedMemoryPool>, public NoCopyable {
@@ -56,6 +62,7 @@ public:
         uint32_t flags = AVSharedMemory::Flags::FLAGS_READ_WRITE;
         bool enableFixedSize = true;
         MemoryAvailableNotifier notifier;
+        bool enableSizeClass = false;
     };
 
     /**
@@ -95,6 +102,9 @@ private:
     void ReleaseMemory(AVSharedMemory *memory);
     bool CheckSize(int32_t size);
 
+    class SizeClassCache;
+    std::shared_ptr<SizeClassCache> sizeClassCache_;
+
     InitializeOption option_ {};
     std::list<AVSharedMemory *> idleList_;
     std::list<AVSharedMemory *> busyList_;
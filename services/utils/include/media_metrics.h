@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEDIA_METRICS_H
+#define MEDIA_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+#define METRICS_SPLICE_IMPL(a, b) a ## b
+#define METRICS_SPLICE(a, b) METRICS_SPLICE_IMPL(a, b)
+
+/**
+ * Record the latency of the current scope into the histogram @name. The histogram is registered
+ * only once for every call site.
+ */
+#define METRICS_AUTO_LATENCY(name)                                                                      \
+    static const OHOS::Media::MetricHandle METRICS_SPLICE(metricHandle, __LINE__) =                    \
+        OHOS::Media::MediaMetrics::Inst().RegisterHistogram(name);                                      \
+    OHOS::Media::MetricLatencyScope METRICS_SPLICE(metricScope, __LINE__)(METRICS_SPLICE(metricHandle, __LINE__))
+
+#define METRICS_COUNTER_ADD(name, delta)                                                                \
+    do {                                                                                                \
+        static const OHOS::Media::MetricHandle handle = OHOS::Media::MediaMetrics::Inst().RegisterCounter(name); \
+        OHOS::Media::MediaMetrics::Inst().Add(handle, delta);                                          \
+    } while (0)
+
+enum MetricType : uint8_t {
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM,
+};
+
+/**
+ * The handle of a registered metric, it is only an index and could be copied freely. The invalid
+ * handle is returned when there are too many metrics, updating it takes no effect.
+ */
+struct MetricHandle {
+    MetricType type = METRIC_COUNTER;
+    uint16_t slot = UINT16_MAX;
+};
+
+/**
+ * The low overhead metrics registry for the hot paths. The counters and histograms are updated
+ * in the shard of the calling thread without any lock, and the shards are merged when dumped.
+ * The gauges are process wide atomic values.
+ */
+class __attribute__((visibility("default"))) MediaMetrics : public NoCopyable {
+public:
+    static MediaMetrics &Inst();
+
+    /**
+     * Register the metric by name, the same handle will be returned if the name is already
+     * registered with the same type.
+     */
+    MetricHandle RegisterCounter(std::string_view name);
+    MetricHandle RegisterGauge(std::string_view name);
+    // the histogram of the latency in microseconds, which reports p50/p99/p999
+    MetricHandle RegisterHistogram(std::string_view name);
+
+    void Add(const MetricHandle &handle, int64_t delta = 1);
+    void Set(const MetricHandle &handle, int64_t value);
+    void Record(const MetricHandle &handle, int64_t valueUs);
+
+    // the value merged from all threads, 0 for the handle which is not a counter
+    int64_t GetCounter(const MetricHandle &handle);
+    void Dump(std::string &dumpString);
+
+    static int64_t GetTimeUs()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    struct Shard;
+    struct ShardHolder;
+private:
+    MediaMetrics();
+    ~MediaMetrics();
+    MetricHandle Register(std::string_view name, MetricType type);
+    Shard &GetShard();
+    void RetireShard(Shard *shard);
+    int64_t MergeCounter(uint16_t slot);
+
+    std::mutex mutex_;
+    std::vector<std::pair<std::string, MetricHandle>> names_;
+    std::vector<Shard *> shards_;
+    // the values of the exited threads
+    Shard *retired_ = nullptr;
+    std::atomic<int64_t> *gauges_ = nullptr;
+    uint16_t slotCount_[METRIC_HISTOGRAM + 1] = { 0 };
+};
+
+class __attribute__((visibility("default"))) MetricLatencyScope : public NoCopyable {
+public:
+    explicit MetricLatencyScope(const MetricHandle &handle) : handle_(handle), startUs_(MediaMetrics::GetTimeUs()) {}
+    ~MetricLatencyScope()
+    {
+        MediaMetrics::Inst().Record(handle_, MediaMetrics::GetTimeUs() - startUs_);
+    }
+
+private:
+    MetricHandle handle_;
+    int64_t startUs_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // MEDIA_METRICS_H
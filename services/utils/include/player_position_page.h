@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PLAYER_POSITION_PAGE_H
+#define PLAYER_POSITION_PAGE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "avsharedmemory.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+struct PlayerPositionAnchor {
+    // the playback position at the anchor
+    int64_t positionUs = 0;
+    // the CLOCK_MONOTONIC time of the anchor, which is the same clock in every process
+    int64_t clockNs = 0;
+    // the extrapolated position is clamped to it, as the engine does to the queried one
+    int64_t maxPositionUs = INT64_MAX;
+    double rate = 1.0;
+    // whether the position moves at the rate after the anchor
+    bool running = false;
+};
+
+/**
+ * A shared page holding the last playback position anchor published by the player engine, so that the
+ * client could extrapolate the current position without asking the server. The page is a seqlock with
+ * a single writer at a time, readers retry when they race with a publish.
+ *
+ * The engine re-anchors at every state, seek and rate change and on the periodic position update, an
+ * anchor older than {@link MAX_ANCHOR_AGE_NS} is considered stale and the reader should ask the server
+ * instead, which re-anchors the page as a side effect.
+ */
+class __attribute__((visibility("default"))) PlayerPositionPage : public NoCopyable {
+public:
+    /**
+     * Writer: create the page in the local process, it is read-only to the peers.
+     */
+    static std::shared_ptr<PlayerPositionPage> Create();
+    /**
+     * Reader: use the page created by the peer process.
+     */
+    static std::shared_ptr<PlayerPositionPage> Create(const std::shared_ptr<AVSharedMemory> &memory);
+
+    explicit PlayerPositionPage(const std::shared_ptr<AVSharedMemory> &memory);
+    ~PlayerPositionPage();
+
+    std::shared_ptr<AVSharedMemory> GetMemory() const;
+
+    /**
+     * Writer: the publishes are dropped and the page stays invalid while inactive.
+     */
+    void SetActive(bool active);
+    void Publish(const PlayerPositionAnchor &anchor);
+
+    /**
+     * Reader: get the current position in milliseconds extrapolated from the anchor.
+     * @return false if the page is invalid or stale.
+     */
+    bool GetCurrentTime(int32_t &currentTime) const;
+
+    static int64_t GetClockNs();
+
+    // a bit longer than the 1s interval of the position update in the playing state
+    static constexpr int64_t MAX_ANCHOR_AGE_NS = 1500000000;
+
+private:
+    int32_t Init();
+    bool Read(PlayerPositionAnchor &anchor) const;
+
+    struct PageData;
+    std::shared_ptr<AVSharedMemory> memory_;
+    PageData *page_ = nullptr;
+    // writer only
+    std::mutex mutex_;
+    bool active_ = false;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // PLAYER_POSITION_PAGE_H
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TASK_EXECUTOR_H
+#define TASK_EXECUTOR_H
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace Media {
+enum class TaskPriority : int32_t {
+    HIGH = 0,   // user-facing control, e.g. player and recorder commands
+    NORMAL,
+    LOW,        // background work such as metadata extraction
+    COUNT,
+};
+
+/**
+ * A serial execution context scheduled on the shared TaskExecutor. The executor may hand the same
+ * strand to several workers, RunOnce must itself make sure at most one of them runs a task.
+ */
+class ITaskStrand {
+public:
+    virtual ~ITaskStrand() = default;
+    virtual void RunOnce() = 0;
+};
+
+/**
+ * Process-wide bounded worker pool shared by all TaskQueues.
+ *
+ * Workers are created on demand up to the configured limit and exit after staying idle for a while,
+ * so idle sessions cost no threads. Ready strands are served by priority, FIFO within a priority.
+ * A worker that blocks on another task's result (see BlockingScope) does not count against the limit,
+ * which keeps chains of synchronous calls between queues from starving the pool.
+ */
+class __attribute__((visibility("default"))) TaskExecutor : public NoCopyable {
+public:
+    static TaskExecutor &GetInstance();
+
+    void SetMaxWorkers(uint32_t maxWorkers);
+    uint32_t GetMaxWorkers();
+    uint32_t GetWorkerCount();
+
+    void Schedule(const std::shared_ptr<ITaskStrand> &strand, TaskPriority priority);
+    void ScheduleAt(const std::weak_ptr<ITaskStrand> &strand, TaskPriority priority, uint64_t executeTimeNs);
+
+    static bool IsWorkerThread();
+
+    class BlockingScope : public NoCopyable {
+    public:
+        BlockingScope();
+        ~BlockingScope();
+    private:
+        bool active_ = false;
+    };
+
+private:
+    struct TimerItem {
+        std::weak_ptr<ITaskStrand> strand_;
+        TaskPriority priority_ { TaskPriority::NORMAL };
+    };
+    TaskExecutor();
+    ~TaskExecutor() = default;
+    void WorkerLoop();
+    void FireTimersLocked(uint64_t nowNs);
+    std::shared_ptr<ITaskStrand> PopReadyLocked();
+    void WakeOrSpawnLocked();
+    bool CanSpawnLocked() const;
+    void OnWorkerBlocked();
+    void OnWorkerUnblocked();
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::array<std::deque<std::shared_ptr<ITaskStrand>>, static_cast<size_t>(TaskPriority::COUNT)> readyStrands_;
+    std::multimap<uint64_t, TimerItem> timers_;
+    uint32_t maxWorkers_ = 0;
+    uint32_t workers_ = 0;
+    uint32_t idleWorkers_ = 0;
+    uint32_t blockedWorkers_ = 0;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // TASK_EXECUTOR_H
@@ -26,6 +26,7 @@
 #include <type_traits>
 #include "media_errors.h"
 #include "nocopyable.h"
+#include "task_executor.h"
 
 namespace OHOS {
 namespace Media {
@@ -147,8 +148,12 @@ public:
     TaskResult<T> GetResult()
     {
         std::unique_lock<std::mutex> lock(mutex_);
-        while ((state_ != TaskState::FINISHED) && (state_ != TaskState::CANCELED)) {
-            cond_.wait(lock);
+        if ((state_ != TaskState::FINISHED) && (state_ != TaskState::CANCELED)) {
+            // waiting on a pool worker must not shrink the pool the awaited task needs
+            TaskExecutor::BlockingScope blocking;
+            while ((state_ != TaskState::FINISHED) && (state_ != TaskState::CANCELED)) {
+                cond_.wait(lock);
+            }
         }
 
         return ClearResult();
@@ -211,9 +216,16 @@ private:
     ITaskHandler::Attribute attribute_; // task execute attribute.
 };
 
+/**
+ * A TaskQueue is a strand: its tasks run one at a time in enqueue order (by execute time for delayed
+ * tasks), but on the workers of the shared TaskExecutor rather than on a thread of its own. Queues whose
+ * tasks never return, such as a task running a GMainLoop, must ask for a dedicated thread instead so
+ * they do not pin a pool worker for their whole lifetime.
+ */
 class __attribute__((visibility("default"))) TaskQueue : public NoCopyable {
 public:
-    explicit TaskQueue(const std::string &name) : name_(name) {}
+    explicit TaskQueue(const std::string &name, TaskPriority priority = TaskPriority::NORMAL,
+        bool dedicatedThread = false);
     ~TaskQueue();
 
     int32_t Start();
@@ -223,20 +235,12 @@ public:
     int32_t EnqueueTask(const std::shared_ptr<ITaskHandler> &task,
         bool cancelNotExecuted = false, uint64_t delayUs = 0ULL);
 
-private:
-    struct TaskHandlerItem {
-        std::shared_ptr<ITaskHandler> task_ { nullptr };
-        uint64_t executeTimeNs_ { 0ULL };
-    };
-    void TaskProcessor();
-    void CancelNotExecutedTaskLocked();
+    // true when called from a task of this queue, the replacement for comparing thread ids
+    bool IsInTaskThread();
 
-    bool isExit_ = true;
-    std::unique_ptr<std::thread> thread_;
-    std::list<TaskHandlerItem> taskList_;
-    std::mutex mutex_;
-    std::condition_variable cond_;
-    std::string name_;
+private:
+    class Strand;
+    std::shared_ptr<Strand> strand_;
 };
 } // namespace Media
 } // namespace OHOS
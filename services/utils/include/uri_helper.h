@@ -22,6 +22,7 @@
 #include <map>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/stat.h>
 
 namespace OHOS {
 namespace Media {
@@ -54,6 +55,15 @@ public:
     uint8_t UriType() const;
     std::string FormattedUri() const;
     bool AccessCheck(uint8_t flag) const;
+    /**
+     * Get the state of the regular file behind the file or fd uri, and the range of the media in it.
+     */
+    bool GetFileRange(struct stat64 &st, int64_t &offset, int64_t &size) const;
+    /**
+     * Open the file behind the file or fd uri for read, the caller owns the returned fd.
+     * @return the new fd, or -1 if failed.
+     */
+    int32_t OpenFile(int64_t &offset, int64_t &size) const;
 
 private:
     void FormatMeForUri(const std::string_view &uri) noexcept;
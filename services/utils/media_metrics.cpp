@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "media_metrics.h"
+#include <algorithm>
+#include "media_log.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "MediaMetrics"};
+    constexpr uint16_t MAX_COUNTERS = 256;
+    constexpr uint16_t MAX_GAUGES = 64;
+    constexpr uint16_t MAX_HISTOGRAMS = 64;
+    // log-linear buckets: every power of 2 is divided into 4 sub-buckets, the values less than
+    // 4us have their own buckets, and the values larger than 2^40us fall into the last bucket.
+    constexpr uint32_t SUB_BUCKET_BITS = 2;
+    constexpr uint32_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    constexpr uint32_t MAX_EXPONENT = 40;
+    constexpr uint32_t BUCKET_COUNT = SUB_BUCKET_COUNT + (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+    constexpr uint16_t MAX_SLOTS[] = { MAX_COUNTERS, MAX_GAUGES, MAX_HISTOGRAMS };
+    constexpr const char *TYPE_NAMES[] = { "counter", "gauge", "histogram" };
+
+    uint32_t GetBucket(int64_t value)
+    {
+        if (value < static_cast<int64_t>(SUB_BUCKET_COUNT)) {
+            return value < 0 ? 0 : static_cast<uint32_t>(value);
+        }
+        uint32_t exponent = 63 - static_cast<uint32_t>(__builtin_clzll(static_cast<uint64_t>(value))); // 63: bits
+        if (exponent > MAX_EXPONENT) {
+            return BUCKET_COUNT - 1;
+        }
+        uint32_t sub = static_cast<uint32_t>(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+        return SUB_BUCKET_COUNT + (exponent - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT + sub;
+    }
+
+    // the upper bound of the values in the bucket
+    int64_t GetBucketValue(uint32_t bucket)
+    {
+        if (bucket < SUB_BUCKET_COUNT) {
+            return static_cast<int64_t>(bucket);
+        }
+        uint32_t exponent = (bucket - SUB_BUCKET_COUNT) / SUB_BUCKET_COUNT + SUB_BUCKET_BITS;
+        uint32_t sub = (bucket - SUB_BUCKET_COUNT) % SUB_BUCKET_COUNT;
+        int64_t step = static_cast<int64_t>(1) << (exponent - SUB_BUCKET_BITS);
+        return (static_cast<int64_t>(1) << exponent) + step * (sub + 1) - 1;
+    }
+}
+
+namespace OHOS {
+namespace Media {
+struct HistogramShard {
+    std::atomic<uint64_t> buckets[BUCKET_COUNT] = {};
+    std::atomic<uint64_t> count = 0;
+    std::atomic<int64_t> sum = 0;
+    std::atomic<int64_t> max = 0;
+};
+
+// written only by the owner thread, read by the dumper
+struct MediaMetrics::Shard {
+    std::atomic<int64_t> counters[MAX_COUNTERS] = {};
+    // allocated at the first record of the histogram in this thread
+    std::atomic<HistogramShard *> histograms[MAX_HISTOGRAMS] = {};
+
+    ~Shard()
+    {
+        for (auto &histogram : histograms) {
+            delete histogram.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+struct MediaMetrics::ShardHolder {
+    Shard *shard = nullptr;
+    ~ShardHolder()
+    {
+        if (shard != nullptr) {
+            MediaMetrics::Inst().RetireShard(shard);
+        }
+    }
+};
+
+MediaMetrics &MediaMetrics::Inst()
+{
+    static MediaMetrics inst;
+    return inst;
+}
+
+MediaMetrics::MediaMetrics()
+{
+    retired_ = new Shard();
+    gauges_ = new std::atomic<int64_t>[MAX_GAUGES]();
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+MediaMetrics::~MediaMetrics()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+    std::lock_guard<std::mutex> lock(mutex_);
+    delete retired_;
+    retired_ = nullptr;
+    delete[] gauges_;
+    gauges_ = nullptr;
+    // the shards of the alive threads are leaked intentionally, the threads may still update them.
+    shards_.clear();
+}
+
+MetricHandle MediaMetrics::Register(std::string_view name, MetricType type)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &[registered, handle] : names_) {
+        if (registered == name) {
+            CHECK_AND_RETURN_RET_LOG(handle.type == type, MetricHandle {},
+                "metric %{public}s is already registered as %{public}s", registered.c_str(), TYPE_NAMES[handle.type]);
+            return handle;
+        }
+    }
+
+    CHECK_AND_RETURN_RET_LOG(slotCount_[type] < MAX_SLOTS[type], MetricHandle {},
+        "too many %{public}s, %{public}s is not registered", TYPE_NAMES[type], std::string(name).c_str());
+    MetricHandle handle { type, slotCount_[type]++ };
+    names_.emplace_back(std::string(name), handle);
+    return handle;
+}
+
+MetricHandle MediaMetrics::RegisterCounter(std::string_view name)
+{
+    return Register(name, METRIC_COUNTER);
+}
+
+MetricHandle MediaMetrics::RegisterGauge(std::string_view name)
+{
+    return Register(name, METRIC_GAUGE);
+}
+
+MetricHandle MediaMetrics::RegisterHistogram(std::string_view name)
+{
+    return Register(name, METRIC_HISTOGRAM);
+}
+
+MediaMetrics::Shard &MediaMetrics::GetShard()
+{
+    thread_local ShardHolder holder;
+    if (holder.shard == nullptr) {
+        holder.shard = new Shard();
+        std::lock_guard<std::mutex> lock(mutex_);
+        shards_.push_back(holder.shard);
+    }
+    return *holder.shard;
+}
+
+void MediaMetrics::RetireShard(Shard *shard)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = std::find(shards_.begin(), shards_.end(), shard);
+    if (iter == shards_.end() || retired_ == nullptr) {
+        return;
+    }
+    (void)shards_.erase(iter);
+
+    for (uint16_t i = 0; i < MAX_COUNTERS; i++) {
+        retired_->counters[i].fetch_add(shard->counters[i].load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    }
+    for (uint16_t i = 0; i < MAX_HISTOGRAMS; i++) {
+        HistogramShard *from = shard->histograms[i].load(std::memory_order_relaxed);
+        if (from == nullptr) {
+            continue;
+        }
+        HistogramShard *to = retired_->histograms[i].load(std::memory_order_relaxed);
+        if (to == nullptr) {
+            // the ownership is transferred to the retired shard
+            retired_->histograms[i].store(from, std::memory_order_relaxed);
+            shard->histograms[i].store(nullptr, std::memory_order_relaxed);
+            continue;
+        }
+        for (uint32_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+            to->buckets[bucket].fetch_add(from->buckets[bucket].load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+        }
+        to->count.fetch_add(from->count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to->sum.fetch_add(from->sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to->max.store(std::max(to->max.load(std::memory_order_relaxed), from->max.load(std::memory_order_relaxed)),
+            std::memory_order_relaxed);
+    }
+    delete shard;
+}
+
+void MediaMetrics::Add(const MetricHandle &handle, int64_t delta)
+{
+    if (handle.type == METRIC_GAUGE && handle.slot < MAX_GAUGES) {
+        gauges_[handle.slot].fetch_add(delta, std::memory_order_relaxed);
+        return;
+    }
+    if (handle.type != METRIC_COUNTER || handle.slot >= MAX_COUNTERS) {
+        return;
+    }
+    // only the owner thread writes the shard, so a plain load and store is enough.
+    std::atomic<int64_t> &counter = GetShard().counters[handle.slot];
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+void MediaMetrics::Set(const MetricHandle &handle, int64_t value)
+{
+    if (handle.type != METRIC_GAUGE || handle.slot >= MAX_GAUGES) {
+        return;
+    }
+    gauges_[handle.slot].store(value, std::memory_order_relaxed);
+}
+
+void MediaMetrics::Record(const MetricHandle &handle, int64_t valueUs)
+{
+    if (handle.type != METRIC_HISTOGRAM || handle.slot >= MAX_HISTOGRAMS) {
+        return;
+    }
+    Shard &shard = GetShard();
+    HistogramShard *histogram = shard.histograms[handle.slot].load(std::memory_order_relaxed);
+    if (histogram == nullptr) {
+        histogram = new (std::nothrow) HistogramShard();
+        CHECK_AND_RETURN(histogram != nullptr);
+        shard.histograms[handle.slot].store(histogram, std::memory_order_release);
+    }
+
+    valueUs = valueUs < 0 ? 0 : valueUs;
+    std::atomic<uint64_t> &bucket = histogram->buckets[GetBucket(valueUs)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    histogram->sum.store(histogram->sum.load(std::memory_order_relaxed) + valueUs, std::memory_order_relaxed);
+    if (valueUs > histogram->max.load(std::memory_order_relaxed)) {
+        histogram->max.store(valueUs, std::memory_order_relaxed);
+    }
+    histogram->count.store(histogram->count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+static void MergeHistogram(const HistogramShard *from, std::vector<uint64_t> &buckets,
+    uint64_t &count, int64_t &sum, int64_t &max)
+{
+    if (from == nullptr) {
+        return;
+    }
+    for (uint32_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+        buckets[bucket] += from->buckets[bucket].load(std::memory_order_relaxed);
+    }
+    count += from->count.load(std::memory_order_relaxed);
+    sum += from->sum.load(std::memory_order_relaxed);
+    max = std::max(max, from->max.load(std::memory_order_relaxed));
+}
+
+static int64_t GetPercentile(const std::vector<uint64_t> &buckets, uint64_t total, double percent, int64_t max)
+{
+    // the buckets may be updated while merging, so the total is counted from the merged buckets
+    auto target = static_cast<uint64_t>(static_cast<double>(total) * percent);
+    uint64_t count = 0;
+    for (uint32_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+        count += buckets[bucket];
+        if (count > target) {
+            return std::min(GetBucketValue(bucket), max);
+        }
+    }
+    return max;
+}
+
+int64_t MediaMetrics::MergeCounter(uint16_t slot)
+{
+    int64_t value = retired_->counters[slot].load(std::memory_order_relaxed);
+    for (auto shard : shards_) {
+        value += shard->counters[slot].load(std::memory_order_relaxed);
+    }
+    return value;
+}
+
+int64_t MediaMetrics::GetCounter(const MetricHandle &handle)
+{
+    if (handle.type != METRIC_COUNTER || handle.slot >= MAX_COUNTERS) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN_RET(retired_ != nullptr, 0);
+    return MergeCounter(handle.slot);
+}
+
+void MediaMetrics::Dump(std::string &dumpString)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN(retired_ != nullptr);
+    for (auto &[name, handle] : names_) {
+        dumpString += TYPE_NAMES[handle.type];
+        dumpString += " " + name + ": ";
+        if (handle.type == METRIC_COUNTER) {
+            dumpString += std::to_string(MergeCounter(handle.slot)) + "\n";
+            continue;
+        }
+        if (handle.type == METRIC_GAUGE) {
+            dumpString += std::to_string(gauges_[handle.slot].load(std::memory_order_relaxed)) + "\n";
+            continue;
+        }
+
+        std::vector<uint64_t> buckets(BUCKET_COUNT, 0);
+        uint64_t count = 0;
+        int64_t sum = 0;
+        int64_t max = 0;
+        MergeHistogram(retired_->histograms[handle.slot].load(std::memory_order_relaxed), buckets, count, sum, max);
+        for (auto shard : shards_) {
+            MergeHistogram(shard->histograms[handle.slot].load(std::memory_order_acquire), buckets, count, sum, max);
+        }
+        uint64_t total = 0;
+        for (auto value : buckets) {
+            total += value;
+        }
+        dumpString += "count = " + std::to_string(count);
+        dumpString += ", avg = " + std::to_string(count == 0 ? 0 : sum / static_cast<int64_t>(count)) + "us";
+        dumpString += ", p50 = " + std::to_string(GetPercentile(buckets, total, 0.5, max)) + "us"; // 0.5: p50
+        dumpString += ", p99 = " + std::to_string(GetPercentile(buckets, total, 0.99, max)) + "us"; // 0.99: p99
+        dumpString += ", p999 = " + std::to_string(GetPercentile(buckets, total, 0.999, max)) + "us"; // 0.999: p999
+        dumpString += ", max = " + std::to_string(max) + "us\n";
+    }
+}
+} // namespace Media
+} // namespace OHOS
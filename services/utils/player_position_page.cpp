@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "player_position_page.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <new>
+#include "avsharedmemorybase.h"
+#include "media_errors.h"
+#include "media_log.h"
+#include "securec.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "PlayerPositionPage"};
+    constexpr uint32_t MAX_READ_RETRIES = 8;
+    constexpr double MAX_RATE = 64.0;
+    constexpr int64_t NSEC_PER_USEC = 1000;
+    constexpr int64_t USEC_PER_MSEC = 1000;
+    constexpr int64_t NSEC_PER_SEC = 1000000000;
+}
+
+namespace OHOS {
+namespace Media {
+struct PlayerPositionPage::PageData {
+    // odd while the writer is updating the anchor
+    std::atomic<uint32_t> seq = 0;
+    std::atomic<uint32_t> valid = 0;
+    std::atomic<int64_t> positionUs = 0;
+    std::atomic<int64_t> clockNs = 0;
+    std::atomic<int64_t> maxPositionUs = 0;
+    std::atomic<uint64_t> rateBits = 0;
+    std::atomic<uint32_t> running = 0;
+};
+
+static_assert(std::atomic<int64_t>::is_always_lock_free, "position page is shared between processes");
+
+std::shared_ptr<PlayerPositionPage> PlayerPositionPage::Create()
+{
+    auto memory = AVSharedMemoryBase::CreateFromLocal(static_cast<int32_t>(sizeof(PageData)),
+        AVSharedMemory::FLAGS_READ_ONLY, "player_position");
+    CHECK_AND_RETURN_RET_LOG(memory != nullptr, nullptr, "failed to create position page");
+
+    auto page = std::make_shared<PlayerPositionPage>(memory);
+    CHECK_AND_RETURN_RET_LOG(page != nullptr, nullptr, "failed to new PlayerPositionPage");
+    CHECK_AND_RETURN_RET(page->Init() == MSERR_OK, nullptr);
+
+    // the memory is only visible to this process now, construct the page in place.
+    page->page_ = new (page->memory_->GetBase()) PageData();
+    return page;
+}
+
+std::shared_ptr<PlayerPositionPage> PlayerPositionPage::Create(const std::shared_ptr<AVSharedMemory> &memory)
+{
+    auto page = std::make_shared<PlayerPositionPage>(memory);
+    CHECK_AND_RETURN_RET_LOG(page != nullptr, nullptr, "failed to new PlayerPositionPage");
+    CHECK_AND_RETURN_RET(page->Init() == MSERR_OK, nullptr);
+    return page;
+}
+
+PlayerPositionPage::PlayerPositionPage(const std::shared_ptr<AVSharedMemory> &memory)
+    : memory_(memory)
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances create", FAKE_POINTER(this));
+}
+
+PlayerPositionPage::~PlayerPositionPage()
+{
+    MEDIA_LOGD("0x%{public}06" PRIXPTR " Instances destroy", FAKE_POINTER(this));
+}
+
+int32_t PlayerPositionPage::Init()
+{
+    CHECK_AND_RETURN_RET(memory_ != nullptr && memory_->GetBase() != nullptr, MSERR_INVALID_VAL);
+    CHECK_AND_RETURN_RET_LOG(memory_->GetSize() >= static_cast<int32_t>(sizeof(PageData)), MSERR_INVALID_VAL,
+        "position page is too small: %{public}d", memory_->GetSize());
+    page_ = reinterpret_cast<PageData *>(memory_->GetBase());
+    return MSERR_OK;
+}
+
+std::shared_ptr<AVSharedMemory> PlayerPositionPage::GetMemory() const
+{
+    return memory_;
+}
+
+int64_t PlayerPositionPage::GetClockNs()
+{
+    struct timespec now = {0, 0};
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<int64_t>(now.tv_sec) * NSEC_PER_SEC + static_cast<int64_t>(now.tv_nsec);
+}
+
+void PlayerPositionPage::SetActive(bool active)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    active_ = active;
+    if (!active_) {
+        page_->valid.store(0, std::memory_order_release);
+    }
+}
+
+void PlayerPositionPage::Publish(const PlayerPositionAnchor &anchor)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_AND_RETURN(active_);
+
+    uint64_t rateBits = 0;
+    static_assert(sizeof(rateBits) == sizeof(anchor.rate), "rate is stored by bits");
+    CHECK_AND_RETURN(memcpy_s(&rateBits, sizeof(rateBits), &anchor.rate, sizeof(anchor.rate)) == EOK);
+
+    uint32_t seq = page_->seq.load(std::memory_order_relaxed);
+    page_->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    page_->positionUs.store(anchor.positionUs, std::memory_order_relaxed);
+    page_->clockNs.store(anchor.clockNs, std::memory_order_relaxed);
+    page_->maxPositionUs.store(anchor.maxPositionUs, std::memory_order_relaxed);
+    page_->rateBits.store(rateBits, std::memory_order_relaxed);
+    page_->running.store(anchor.running ? 1 : 0, std::memory_order_relaxed);
+    page_->valid.store(1, std::memory_order_relaxed);
+    page_->seq.store(seq + 2, std::memory_order_release);
+}
+
+bool PlayerPositionPage::Read(PlayerPositionAnchor &anchor) const
+{
+    for (uint32_t i = 0; i < MAX_READ_RETRIES; i++) {
+        uint32_t seq = page_->seq.load(std::memory_order_acquire);
+        if ((seq & 1) != 0) {
+            continue;
+        }
+        bool valid = page_->valid.load(std::memory_order_relaxed) != 0;
+        anchor.positionUs = page_->positionUs.load(std::memory_order_relaxed);
+        anchor.clockNs = page_->clockNs.load(std::memory_order_relaxed);
+        anchor.maxPositionUs = page_->maxPositionUs.load(std::memory_order_relaxed);
+        uint64_t rateBits = page_->rateBits.load(std::memory_order_relaxed);
+        anchor.running = page_->running.load(std::memory_order_relaxed) != 0;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (page_->seq.load(std::memory_order_relaxed) != seq) {
+            continue;
+        }
+        CHECK_AND_RETURN_RET(memcpy_s(&anchor.rate, sizeof(anchor.rate), &rateBits, sizeof(rateBits)) == EOK, false);
+        return valid;
+    }
+    // the writer keeps publishing, the server knows the position anyway
+    return false;
+}
+
+bool PlayerPositionPage::GetCurrentTime(int32_t &currentTime) const
+{
+    PlayerPositionAnchor anchor;
+    CHECK_AND_RETURN_RET(Read(anchor), false);
+    CHECK_AND_RETURN_RET(std::isfinite(anchor.rate) && std::fabs(anchor.rate) <= MAX_RATE, false);
+
+    int64_t elapsedNs = GetClockNs() - anchor.clockNs;
+    if (elapsedNs < 0 || elapsedNs > MAX_ANCHOR_AGE_NS) {
+        return false;
+    }
+
+    int64_t positionUs = anchor.positionUs;
+    if (anchor.running) {
+        positionUs += static_cast<int64_t>(static_cast<double>(elapsedNs / NSEC_PER_USEC) * anchor.rate);
+    }
+    positionUs = std::max<int64_t>(std::min(positionUs, anchor.maxPositionUs), 0);
+    currentTime = static_cast<int32_t>(std::min<int64_t>(positionUs / USEC_PER_MSEC, INT32_MAX));
+    return true;
+}
+} // namespace Media
+} // namespace OHOS
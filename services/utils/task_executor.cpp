@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "task_executor.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <pthread.h>
+#include "media_log.h"
+#include "parameter.h"
+
+namespace {
+    constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "TaskExecutor"};
+    constexpr uint32_t MIN_WORKERS = 2;
+    constexpr uint32_t DEFAULT_MAX_WORKERS = 8;
+    constexpr uint32_t MAX_WORKERS_LIMIT = 64;
+    constexpr uint64_t IDLE_TIMEOUT_NS = 10000000000ULL; // 10s
+    constexpr uint32_t PARAM_VALUE_LEN = 16;
+    thread_local bool g_isWorkerThread = false;
+    thread_local bool g_isBlocking = false;
+
+    uint64_t GetNowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+}
+
+namespace OHOS {
+namespace Media {
+TaskExecutor &TaskExecutor::GetInstance()
+{
+    // never destroyed: detached workers may still be draining when static destructors run
+    static TaskExecutor *instance = new TaskExecutor();
+    return *instance;
+}
+
+TaskExecutor::TaskExecutor()
+{
+    uint32_t maxWorkers = std::clamp(std::thread::hardware_concurrency(), MIN_WORKERS, DEFAULT_MAX_WORKERS);
+    char value[PARAM_VALUE_LEN] = {0};
+    int32_t res = GetParameter("debug.media_service.task_workers", "0", value, sizeof(value));
+    if (res > 0) {
+        uint32_t configured = static_cast<uint32_t>(std::strtoul(value, nullptr, 10)); // 10: decimal
+        if (configured > 0) {
+            maxWorkers = std::clamp(configured, MIN_WORKERS, MAX_WORKERS_LIMIT);
+        }
+    }
+    maxWorkers_ = maxWorkers;
+    MEDIA_LOGI("task executor created, max workers: %{public}u", maxWorkers_);
+}
+
+void TaskExecutor::SetMaxWorkers(uint32_t maxWorkers)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    maxWorkers_ = std::clamp(maxWorkers, MIN_WORKERS, MAX_WORKERS_LIMIT);
+    // idle workers above a lowered limit exit on wakeup
+    cond_.notify_all();
+    WakeOrSpawnLocked();
+}
+
+uint32_t TaskExecutor::GetMaxWorkers()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return maxWorkers_;
+}
+
+uint32_t TaskExecutor::GetWorkerCount()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return workers_;
+}
+
+bool TaskExecutor::IsWorkerThread()
+{
+    return g_isWorkerThread;
+}
+
+void TaskExecutor::Schedule(const std::shared_ptr<ITaskStrand> &strand, TaskPriority priority)
+{
+    CHECK_AND_RETURN(strand != nullptr && priority < TaskPriority::COUNT);
+    std::unique_lock<std::mutex> lock(mutex_);
+    readyStrands_[static_cast<size_t>(priority)].push_back(strand);
+    WakeOrSpawnLocked();
+}
+
+void TaskExecutor::ScheduleAt(const std::weak_ptr<ITaskStrand> &strand, TaskPriority priority,
+    uint64_t executeTimeNs)
+{
+    CHECK_AND_RETURN(priority < TaskPriority::COUNT);
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool isEarliest = timers_.empty() || executeTimeNs < timers_.begin()->first;
+    (void)timers_.emplace(executeTimeNs, TimerItem { strand, priority });
+    if (workers_ == 0) {
+        WakeOrSpawnLocked();
+    } else if (isEarliest) {
+        // an idle worker may be sleeping towards a later deadline
+        cond_.notify_one();
+    }
+}
+
+bool TaskExecutor::CanSpawnLocked() const
+{
+    return workers_ - blockedWorkers_ < maxWorkers_;
+}
+
+void TaskExecutor::WakeOrSpawnLocked()
+{
+    if (idleWorkers_ > 0) {
+        cond_.notify_one();
+        return;
+    }
+    if (!CanSpawnLocked()) {
+        return;
+    }
+    std::thread worker(&TaskExecutor::WorkerLoop, this);
+    worker.detach();
+    workers_++;
+    // counted idle until it really starts, so a burst of Schedule calls does not spawn a thread each
+    idleWorkers_++;
+}
+
+void TaskExecutor::FireTimersLocked(uint64_t nowNs)
+{
+    while (!timers_.empty() && timers_.begin()->first <= nowNs) {
+        TimerItem item = timers_.begin()->second;
+        timers_.erase(timers_.begin());
+        std::shared_ptr<ITaskStrand> strand = item.strand_.lock();
+        if (strand != nullptr) {
+            readyStrands_[static_cast<size_t>(item.priority_)].push_back(strand);
+        }
+    }
+}
+
+std::shared_ptr<ITaskStrand> TaskExecutor::PopReadyLocked()
+{
+    for (auto &queue : readyStrands_) {
+        if (!queue.empty()) {
+            std::shared_ptr<ITaskStrand> strand = queue.front();
+            queue.pop_front();
+            return strand;
+        }
+    }
+    return nullptr;
+}
+
+void TaskExecutor::WorkerLoop()
+{
+    (void)pthread_setname_np(pthread_self(), "MediaTaskWorker");
+    g_isWorkerThread = true;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t idleSinceNs = GetNowNs();
+    while (true) {
+        uint64_t nowNs = GetNowNs();
+        FireTimersLocked(nowNs);
+        std::shared_ptr<ITaskStrand> strand = PopReadyLocked();
+        if (strand != nullptr) {
+            idleWorkers_--;
+            lock.unlock();
+            strand->RunOnce();
+            strand = nullptr;
+            lock.lock();
+            idleWorkers_++;
+            idleSinceNs = GetNowNs();
+            continue;
+        }
+
+        // the last worker stays while timers are pending, someone has to fire them
+        bool canExit = workers_ > 1 || timers_.empty();
+        bool overLimit = workers_ - blockedWorkers_ > maxWorkers_;
+        if (canExit && (overLimit || nowNs - idleSinceNs >= IDLE_TIMEOUT_NS)) {
+            break;
+        }
+        uint64_t deadlineNs = idleSinceNs + IDLE_TIMEOUT_NS;
+        if (!timers_.empty()) {
+            deadlineNs = canExit ? std::min(deadlineNs, timers_.begin()->first) : timers_.begin()->first;
+        }
+        (void)cond_.wait_for(lock, std::chrono::nanoseconds(deadlineNs > nowNs ? deadlineNs - nowNs : 0));
+    }
+    idleWorkers_--;
+    workers_--;
+    MEDIA_LOGD("idle task worker exit, %{public}u left", workers_);
+}
+
+void TaskExecutor::OnWorkerBlocked()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    blockedWorkers_++;
+    bool hasReady = std::any_of(readyStrands_.begin(), readyStrands_.end(),
+        [](const auto &queue) { return !queue.empty(); });
+    if (hasReady) {
+        WakeOrSpawnLocked();
+    }
+}
+
+void TaskExecutor::OnWorkerUnblocked()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    blockedWorkers_--;
+}
+
+TaskExecutor::BlockingScope::BlockingScope()
+{
+    // the scopes may nest, e.g. a task result awaited inside an engine wait, only the outermost one counts
+    if (g_isWorkerThread && !g_isBlocking) {
+        g_isBlocking = true;
+        active_ = true;
+        TaskExecutor::GetInstance().OnWorkerBlocked();
+    }
+}
+
+TaskExecutor::BlockingScope::~BlockingScope()
+{
+    if (active_) {
+        g_isBlocking = false;
+        TaskExecutor::GetInstance().OnWorkerUnblocked();
+    }
+}
+} // namespace Media
+} // namespace OHOS
@@ -14,34 +14,75 @@
  */
 
 #include "task_queue.h"
+#include <algorithm>
 #include "media_log.h"
 #include "media_errors.h"
 
 namespace {
     constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, LOG_DOMAIN, "TaskQueue"};
+    constexpr uint64_t MAX_DELAY_US = 10000000ULL; // max delay.
+    constexpr uint32_t US_TO_NS = 1000; // 1000 is ns to us.
+
+    uint64_t GetNowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
 }
 
 namespace OHOS {
 namespace Media {
-TaskQueue::~TaskQueue()
-{
-    (void)Stop();
-}
+class TaskQueue::Strand : public ITaskStrand, public std::enable_shared_from_this<TaskQueue::Strand> {
+public:
+    Strand(const std::string &name, TaskPriority priority, bool dedicatedThread)
+        : name_(name), priority_(priority), dedicatedThread_(dedicatedThread) {}
+    ~Strand() override = default;
 
-int32_t TaskQueue::Start()
+    int32_t Start();
+    int32_t Stop() noexcept;
+    int32_t Enqueue(const std::shared_ptr<ITaskHandler> &task, bool cancelNotExecuted, uint64_t delayUs);
+    bool IsInTaskThread();
+    void RunOnce() override;
+
+private:
+    struct TaskHandlerItem {
+        std::shared_ptr<ITaskHandler> task_ { nullptr };
+        uint64_t executeTimeNs_ { 0ULL };
+    };
+    void TaskProcessor();
+    void ExecuteTask(const TaskHandlerItem &item);
+    void ScheduleLocked();
+    void CancelNotExecutedTaskLocked();
+
+    std::string name_;
+    TaskPriority priority_;
+    bool dedicatedThread_;
+    bool isExit_ = true;
+    bool isRunning_ = false;
+    bool isQueued_ = false;
+    uint64_t timerNs_ = 0;
+    std::thread::id runningThreadId_;
+    std::unique_ptr<std::thread> thread_;
+    std::list<TaskHandlerItem> taskList_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+
+int32_t TaskQueue::Strand::Start()
 {
     std::unique_lock<std::mutex> lock(mutex_);
-    if (thread_ != nullptr) {
+    if (!isExit_) {
         MEDIA_LOGW("Started already, ignore ! [%{public}s]", name_.c_str());
         return MSERR_OK;
     }
     isExit_ = false;
-    thread_ = std::make_unique<std::thread>(&TaskQueue::TaskProcessor, this);
+    if (dedicatedThread_) {
+        thread_ = std::make_unique<std::thread>(&TaskQueue::Strand::TaskProcessor, this);
+    }
 
     return MSERR_OK;
 }
 
-int32_t TaskQueue::Stop() noexcept
+int32_t TaskQueue::Strand::Stop() noexcept
 {
     std::unique_lock<std::mutex> lock(mutex_);
     if (isExit_) {
@@ -49,41 +90,33 @@ int32_t TaskQueue::Stop() noexcept
         return MSERR_OK;
     }
 
-    if (std::this_thread::get_id() == thread_->get_id()) {
+    if (isRunning_ && std::this_thread::get_id() == runningThreadId_) {
         MEDIA_LOGI("Stop at the task thread, reject");
         return MSERR_INVALID_OPERATION;
     }
 
-    std::unique_ptr<std::thread> t;
     isExit_ = true;
     cond_.notify_all();
-    std::swap(thread_, t);
-    lock.unlock();
-
-    if (t != nullptr && t->joinable()) {
-        t->join();
+    if (dedicatedThread_) {
+        std::unique_ptr<std::thread> t;
+        std::swap(thread_, t);
+        lock.unlock();
+        if (t != nullptr && t->joinable()) {
+            t->join();
+        }
+        lock.lock();
+    } else {
+        // the executor may still hold this strand, it finds isExit_ set and returns without running anything
+        cond_.wait(lock, [this] { return !isRunning_; });
     }
 
-    lock.lock();
     CancelNotExecutedTaskLocked();
     return MSERR_OK;
 }
 
-// cancelNotExecuted = false, delayUs = 0ULL.
-int32_t TaskQueue::EnqueueTask(const std::shared_ptr<ITaskHandler> &task, bool cancelNotExecuted, uint64_t delayUs)
+int32_t TaskQueue::Strand::Enqueue(const std::shared_ptr<ITaskHandler> &task, bool cancelNotExecuted,
+    uint64_t delayUs)
 {
-    constexpr uint64_t MAX_DELAY_US = 10000000ULL; // max delay.
-
-    CHECK_AND_RETURN_RET_LOG(task != nullptr, MSERR_INVALID_VAL,
-        "Enqueue task when taskqueue task is nullptr.[%{public}s]", name_.c_str());
-
-    task->Clear();
-
-    CHECK_AND_RETURN_RET_LOG(delayUs < MAX_DELAY_US, MSERR_INVALID_VAL,
-        "Enqueue task when taskqueue delayUs[%{public}" PRIu64 "] is >= max delayUs[ %{public}" PRIu64
-        "], invalid! [%{public}s]",
-        delayUs, MAX_DELAY_US, name_.c_str());
-
     std::unique_lock<std::mutex> lock(mutex_);
     CHECK_AND_RETURN_RET_LOG(!isExit_, MSERR_INVALID_OPERATION,
         "Enqueue task when taskqueue is stopped, failed ! [%{public}s]", name_.c_str());
@@ -92,9 +125,7 @@ int32_t TaskQueue::EnqueueTask(const std::shared_ptr<ITaskHandler> &task, bool c
         CancelNotExecutedTaskLocked();
     }
 
-    // 1000 is ns to us.
-    constexpr uint32_t US_TO_NS = 1000;
-    uint64_t curTimeNs = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    uint64_t curTimeNs = GetNowNs();
     CHECK_AND_RETURN_RET_LOG(curTimeNs < UINT64_MAX - delayUs * US_TO_NS, MSERR_INVALID_OPERATION,
         "Enqueue task but timestamp is overflow, why? [%{public}s]", name_.c_str());
 
@@ -103,12 +134,69 @@ int32_t TaskQueue::EnqueueTask(const std::shared_ptr<ITaskHandler> &task, bool c
         return (item.executeTimeNs_ > executeTimeNs);
     });
     (void)taskList_.insert(iter, {task, executeTimeNs});
-    cond_.notify_all();
+    if (dedicatedThread_) {
+        cond_.notify_all();
+    } else {
+        ScheduleLocked();
+    }
 
     return 0;
 }
 
-void TaskQueue::CancelNotExecutedTaskLocked()
+bool TaskQueue::Strand::IsInTaskThread()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return isRunning_ && std::this_thread::get_id() == runningThreadId_;
+}
+
+void TaskQueue::Strand::ScheduleLocked()
+{
+    // while a task runs the worker reschedules on completion, that keeps the strand serial
+    if (isExit_ || isRunning_ || isQueued_ || taskList_.empty()) {
+        return;
+    }
+    uint64_t executeTimeNs = taskList_.front().executeTimeNs_;
+    if (executeTimeNs <= GetNowNs()) {
+        isQueued_ = true;
+        TaskExecutor::GetInstance().Schedule(shared_from_this(), priority_);
+    } else if (timerNs_ == 0 || executeTimeNs < timerNs_) {
+        timerNs_ = executeTimeNs;
+        TaskExecutor::GetInstance().ScheduleAt(weak_from_this(), priority_, executeTimeNs);
+    }
+}
+
+void TaskQueue::Strand::RunOnce()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    isQueued_ = false;
+    uint64_t curTimeNs = GetNowNs();
+    if (timerNs_ != 0 && timerNs_ <= curTimeNs) {
+        timerNs_ = 0;
+    }
+    // a fired timer may race with a regular schedule, only one of them gets to run a task
+    if (isExit_ || isRunning_ || taskList_.empty()) {
+        return;
+    }
+    if (taskList_.front().executeTimeNs_ > curTimeNs) {
+        ScheduleLocked();
+        return;
+    }
+    TaskHandlerItem item = taskList_.front();
+    taskList_.pop_front();
+    isRunning_ = true;
+    runningThreadId_ = std::this_thread::get_id();
+    lock.unlock();
+
+    ExecuteTask(item);
+
+    lock.lock();
+    isRunning_ = false;
+    runningThreadId_ = std::thread::id();
+    cond_.notify_all();
+    ScheduleLocked();
+}
+
+void TaskQueue::Strand::CancelNotExecutedTaskLocked()
 {
     MEDIA_LOGI("All task not executed are being cancelled..........[%{public}s]", name_.c_str());
     while (!taskList_.empty()) {
@@ -120,7 +208,25 @@ void TaskQueue::CancelNotExecutedTaskLocked()
     }
 }
 
-void TaskQueue::TaskProcessor()
+void TaskQueue::Strand::ExecuteTask(const TaskHandlerItem &item)
+{
+    if (item.task_ == nullptr || item.task_->IsCanceled()) {
+        MEDIA_LOGD("task is nullptr or task canceled. [%{public}s]", name_.c_str());
+        return;
+    }
+
+    item.task_->Execute();
+    if (item.task_->GetAttribute().periodicTimeUs_ == UINT64_MAX) {
+        return;
+    }
+    item.task_->Clear();
+    int32_t res = Enqueue(item.task_, false, item.task_->GetAttribute().periodicTimeUs_);
+    if (res != MSERR_OK) {
+        MEDIA_LOGW("enqueue periodic task failed:%d, why? [%{public}s]", res, name_.c_str());
+    }
+}
+
+void TaskQueue::Strand::TaskProcessor()
 {
     MEDIA_LOGI("Enter TaskProcessor [%{public}s]", name_.c_str());
     while (true) {
@@ -131,7 +237,7 @@ void TaskQueue::TaskProcessor()
             return;
         }
         TaskHandlerItem item = taskList_.front();
-        uint64_t curTimeNs = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        uint64_t curTimeNs = GetNowNs();
         if (curTimeNs >= item.executeTimeNs_) {
             taskList_.pop_front();
         } else {
@@ -139,23 +245,56 @@ void TaskQueue::TaskProcessor()
             (void)cond_.wait_for(lock, std::chrono::nanoseconds(diff));
             continue;
         }
+        isRunning_ = true;
+        runningThreadId_ = std::this_thread::get_id();
         lock.unlock();
 
-        if (item.task_ == nullptr || item.task_->IsCanceled()) {
-            MEDIA_LOGD("task is nullptr or task canceled. [%{public}s]", name_.c_str());
-            continue;
-        }
+        ExecuteTask(item);
 
-        item.task_->Execute();
-        if (item.task_->GetAttribute().periodicTimeUs_ == UINT64_MAX) {
-            continue;
-        }
-        int32_t res = EnqueueTask(item.task_, false, item.task_->GetAttribute().periodicTimeUs_);
-        if (res != MSERR_OK) {
-            MEDIA_LOGW("enqueue periodic task failed:%d, why? [%{public}s]", res, name_.c_str());
-        }
+        lock.lock();
+        isRunning_ = false;
+        runningThreadId_ = std::thread::id();
     }
     MEDIA_LOGI("Leave TaskProcessor [%{public}s]", name_.c_str());
 }
+
+TaskQueue::TaskQueue(const std::string &name, TaskPriority priority, bool dedicatedThread)
+    : strand_(std::make_shared<Strand>(name, priority, dedicatedThread))
+{
+}
+
+TaskQueue::~TaskQueue()
+{
+    (void)Stop();
+}
+
+int32_t TaskQueue::Start()
+{
+    return strand_->Start();
+}
+
+int32_t TaskQueue::Stop() noexcept
+{
+    return strand_->Stop();
+}
+
+// cancelNotExecuted = false, delayUs = 0ULL.
+int32_t TaskQueue::EnqueueTask(const std::shared_ptr<ITaskHandler> &task, bool cancelNotExecuted, uint64_t delayUs)
+{
+    CHECK_AND_RETURN_RET_LOG(task != nullptr, MSERR_INVALID_VAL, "Enqueue task when taskqueue task is nullptr.");
+
+    task->Clear();
+
+    CHECK_AND_RETURN_RET_LOG(delayUs < MAX_DELAY_US, MSERR_INVALID_VAL,
+        "Enqueue task when taskqueue delayUs[%{public}" PRIu64 "] is >= max delayUs[ %{public}" PRIu64
+        "], invalid!", delayUs, MAX_DELAY_US);
+
+    return strand_->Enqueue(task, cancelNotExecuted, delayUs);
+}
+
+bool TaskQueue::IsInTaskThread()
+{
+    return strand_->IsInTaskThread();
+}
 } // namespace Media
 } // namespace OHOS
@@ -14,6 +14,7 @@
  */
 
 #include "uri_helper.h"
+#include <cerrno>
 #include <cstring>
 #include <climits>
 #include <sys/types.h>
@@ -242,11 +243,15 @@ void UriHelper::FormatMeForFd() noexcept
 
 bool UriHelper::CorrectFdParam()
 {
-    int flags = fcntl(fd_, F_GETFL);
+    // only the duplicate is owned, the given fd is left to its owner even if failed
+    int32_t fd = fd_;
+    fd_ = -1;
+
+    int flags = fcntl(fd, F_GETFL);
     CHECK_AND_RETURN_RET_LOG(flags != -1, false, "Fail to get File Status Flags");
 
     struct stat64 st;
-    if (fstat64(fd_, &st) != 0) {
+    if (fstat64(fd, &st) != 0) {
         MEDIA_LOGE("can not get file state");
         return false;
     }
@@ -260,7 +265,8 @@ bool UriHelper::CorrectFdParam()
         size_ = fdSize - offset_;
     }
 
-    fd_ = ::dup(fd_);
+    fd_ = ::dup(fd);
+    CHECK_AND_RETURN_RET_LOG(fd_ >= 0, false, "Fail to dup the fd, errno: %{public}d", errno);
     formattedUri_ = std::string("fd://") + std::to_string(fd_) + "?offset=" +
         std::to_string(offset_) + "&size=" + std::to_string(size_);
     return true;
@@ -307,6 +313,38 @@ bool UriHelper::AccessCheck(uint8_t flag) const
     return true; // Not implemented, defaultly return true.
 }
 
+bool UriHelper::GetFileRange(struct stat64 &st, int64_t &offset, int64_t &size) const
+{
+    if (type_ == URI_TYPE_FILE) {
+        CHECK_AND_RETURN_RET_LOG(stat64(rawFileUri_.data(), &st) == 0, false, "can not get file state");
+        offset = 0;
+        size = static_cast<int64_t>(st.st_size);
+    } else if (type_ == URI_TYPE_FD) {
+        CHECK_AND_RETURN_RET_LOG(fd_ > 0 && fstat64(fd_, &st) == 0, false, "can not get file state");
+        offset = offset_;
+        size = size_;
+    } else {
+        return false;
+    }
+
+    return S_ISREG(st.st_mode);
+}
+
+int32_t UriHelper::OpenFile(int64_t &offset, int64_t &size) const
+{
+    struct stat64 st;
+    CHECK_AND_RETURN_RET(GetFileRange(st, offset, size), -1);
+
+    int32_t fd = -1;
+    if (type_ == URI_TYPE_FILE) {
+        fd = ::open(rawFileUri_.data(), O_RDONLY | O_CLOEXEC);
+    } else {
+        fd = ::dup(fd_);
+    }
+    CHECK_AND_RETURN_RET_LOG(fd >= 0, -1, "can not open the file, errno: %{public}d", errno);
+    return fd;
+}
+
 bool UriHelper::ParseFdUri(std::string_view uri)
 {
     static constexpr std::string_view::size_type delim1Len = std::string_view("?offset=").size();
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "codec_component_mock.h"
+#include <hdf_base.h>
+#include <OMX_Component.h>
+
+namespace {
+    // the ids are sparse, as the ones assigned by the codec HDI are not the slot indexes
+    constexpr uint32_t FIRST_BUFFER_ID = 1000;
+    constexpr uint32_t BUFFER_ID_STEP = 7;
+}
+
+namespace OHOS {
+namespace Media {
+CodecComponentMock::CodecComponentMock(uint32_t bufferCount)
+    : bufferCount_(bufferCount), nextBufferId_(FIRST_BUFFER_ID)
+{
+    wrap_.mock = this;
+    wrap_.component.GetParameter = GetParameter;
+    wrap_.component.UseBuffer = UseBuffer;
+    wrap_.component.FreeBuffer = FreeBuffer;
+    wrap_.component.EmptyThisBuffer = EmptyThisBuffer;
+    wrap_.component.FillThisBuffer = FillThisBuffer;
+}
+
+CodecComponentMock::~CodecComponentMock()
+{
+}
+
+CodecComponentType *CodecComponentMock::GetComponent()
+{
+    return &wrap_.component;
+}
+
+void CodecComponentMock::SetBufferDone(std::function<void(const OmxCodecBuffer &)> bufferDone)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    bufferDone_ = bufferDone;
+}
+
+bool CodecComponentMock::PopSubmitted(OmxCodecBuffer &buffer)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (submitted_.empty()) {
+        return false;
+    }
+    buffer = submitted_.front();
+    submitted_.pop_front();
+    return true;
+}
+
+size_t CodecComponentMock::GetSubmittedCount()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return submitted_.size();
+}
+
+uint32_t CodecComponentMock::GetUsedCount()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return usedCount_;
+}
+
+uint32_t CodecComponentMock::GetFreedCount()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return freedCount_;
+}
+
+CodecComponentMock *CodecComponentMock::GetMock(CodecComponentType *self)
+{
+    return reinterpret_cast<ComponentWrap *>(self)->mock;
+}
+
+int32_t CodecComponentMock::GetParameter(CodecComponentType *self, uint32_t paramIndex, int8_t *paramStruct,
+    uint32_t paramStructLen)
+{
+    if (paramIndex != OMX_IndexParamPortDefinition || paramStruct == nullptr ||
+        paramStructLen < sizeof(OMX_PARAM_PORTDEFINITIONTYPE)) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    auto portDef = reinterpret_cast<OMX_PARAM_PORTDEFINITIONTYPE *>(paramStruct);
+    portDef->nBufferCountActual = GetMock(self)->bufferCount_;
+    return HDF_SUCCESS;
+}
+
+int32_t CodecComponentMock::UseBuffer(CodecComponentType *self, uint32_t portIndex, OmxCodecBuffer *buffer)
+{
+    (void)portIndex;
+    CodecComponentMock *mock = GetMock(self);
+    std::unique_lock<std::mutex> lock(mock->mutex_);
+    if (buffer == nullptr || mock->usedCount_ >= mock->bufferCount_) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    buffer->bufferId = mock->nextBufferId_;
+    mock->nextBufferId_ += BUFFER_ID_STEP;
+    mock->usedCount_++;
+    return HDF_SUCCESS;
+}
+
+int32_t CodecComponentMock::FreeBuffer(CodecComponentType *self, uint32_t portIndex, const OmxCodecBuffer *buffer)
+{
+    (void)portIndex;
+    (void)buffer;
+    CodecComponentMock *mock = GetMock(self);
+    std::unique_lock<std::mutex> lock(mock->mutex_);
+    mock->freedCount_++;
+    return HDF_SUCCESS;
+}
+
+int32_t CodecComponentMock::EmptyThisBuffer(CodecComponentType *self, const OmxCodecBuffer *buffer)
+{
+    return GetMock(self)->Submit(buffer);
+}
+
+int32_t CodecComponentMock::FillThisBuffer(CodecComponentType *self, const OmxCodecBuffer *buffer)
+{
+    return GetMock(self)->Submit(buffer);
+}
+
+int32_t CodecComponentMock::Submit(const OmxCodecBuffer *buffer)
+{
+    if (buffer == nullptr) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (bufferDone_ == nullptr) {
+        submitted_.push_back(*buffer);
+        return HDF_SUCCESS;
+    }
+    auto bufferDone = bufferDone_;
+    lock.unlock();
+    bufferDone(*buffer);
+    return HDF_SUCCESS;
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CODEC_COMPONENT_MOCK_H
+#define CODEC_COMPONENT_MOCK_H
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include "nocopyable.h"
+#include "codec_component_if.h"
+#include "codec_omx_ext.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * The in-process CodecComponentType which only keeps the buffer bookkeeping of an OMX component, so the
+ * HDI buffer managers could be tested and benchmarked without the codec HDI service.
+ */
+class CodecComponentMock : public NoCopyable {
+public:
+    explicit CodecComponentMock(uint32_t bufferCount);
+    ~CodecComponentMock();
+
+    CodecComponentType *GetComponent();
+
+    /**
+     * Once set, the buffers submitted by EmptyThisBuffer or FillThisBuffer are returned through the callback
+     * before the submission returns, as a codec answering on another thread could do. Otherwise they are
+     * kept until {@link PopSubmitted}.
+     */
+    void SetBufferDone(std::function<void(const OmxCodecBuffer &)> bufferDone);
+    bool PopSubmitted(OmxCodecBuffer &buffer);
+    size_t GetSubmittedCount();
+    uint32_t GetUsedCount();
+    uint32_t GetFreedCount();
+
+private:
+    struct ComponentWrap {
+        CodecComponentType component;
+        CodecComponentMock *mock;
+    };
+    static CodecComponentMock *GetMock(CodecComponentType *self);
+    static int32_t GetParameter(CodecComponentType *self, uint32_t paramIndex, int8_t *paramStruct,
+        uint32_t paramStructLen);
+    static int32_t UseBuffer(CodecComponentType *self, uint32_t portIndex, OmxCodecBuffer *buffer);
+    static int32_t FreeBuffer(CodecComponentType *self, uint32_t portIndex, const OmxCodecBuffer *buffer);
+    static int32_t EmptyThisBuffer(CodecComponentType *self, const OmxCodecBuffer *buffer);
+    static int32_t FillThisBuffer(CodecComponentType *self, const OmxCodecBuffer *buffer);
+    int32_t Submit(const OmxCodecBuffer *buffer);
+
+    ComponentWrap wrap_ = {};
+    uint32_t bufferCount_ = 0;
+    uint32_t nextBufferId_;
+    uint32_t usedCount_ = 0;
+    uint32_t freedCount_ = 0;
+    std::mutex mutex_;
+    std::deque<OmxCodecBuffer> submitted_;
+    std::function<void(const OmxCodecBuffer &)> bufferDone_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // CODEC_COMPONENT_MOCK_H
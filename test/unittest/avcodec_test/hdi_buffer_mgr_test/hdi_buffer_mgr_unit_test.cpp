@@ -0,0 +1,403 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "codec_component_mock.h"
+#include "hdi_vdec_in_buffer_mgr.h"
+#include "hdi_venc_out_buffer_mgr.h"
+
+using namespace std;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace testing::ext;
+
+namespace {
+    constexpr uint32_t BUFFER_COUNT = 8;
+    constexpr uint32_t BUFFER_SIZE = 1024;
+    constexpr uint32_t REENTRANT_ROUNDS = 100;
+    constexpr uint32_t BENCH_ROUNDS = 20000;
+    constexpr uint32_t BENCH_BUFFER_COUNTS[] = { 4, 16, 64, 100 };
+    constexpr intptr_t FIRST_FD = 100;
+    constexpr double NS_PER_S = 1000000000.0;
+
+    GstBuffer *CreateBuffer(intptr_t fd)
+    {
+        GstBuffer *buffer = gst_buffer_new_allocate(nullptr, BUFFER_SIZE, nullptr);
+        GstBufferFdConfig config = { BUFFER_SIZE, 0, BUFFER_SIZE, BUFFER_SIZE, FLAGS_READ_WRITE, 0 };
+        (void)gst_buffer_add_buffer_fd_meta(buffer, fd, config);
+        return buffer;
+    }
+
+    vector<GstBuffer *> CreateBuffers(uint32_t count)
+    {
+        vector<GstBuffer *> buffers;
+        for (uint32_t i = 0; i < count; i++) {
+            buffers.push_back(CreateBuffer(FIRST_FD + i));
+        }
+        return buffers;
+    }
+
+    void ReleaseBuffers(vector<GstBuffer *> &buffers)
+    {
+        for (auto buffer : buffers) {
+            gst_buffer_unref(buffer);
+        }
+        buffers.clear();
+    }
+
+    int32_t RefCount(GstBuffer *buffer)
+    {
+        return GST_MINI_OBJECT_REFCOUNT_VALUE(buffer);
+    }
+
+    vector<OmxCodecBuffer> PopAllSubmitted(CodecComponentMock &component)
+    {
+        vector<OmxCodecBuffer> submitted;
+        OmxCodecBuffer buffer = {};
+        while (component.PopSubmitted(buffer)) {
+            submitted.push_back(buffer);
+        }
+        return submitted;
+    }
+
+    void SetUpInput(CodecComponentMock &component, HdiVdecInBufferMgr &mgr, vector<GstBuffer *> &buffers)
+    {
+        CompVerInfo verInfo = {};
+        mgr.Init(component.GetComponent(), 0, verInfo);
+        ASSERT_EQ(mgr.UseBuffers(buffers), GST_CODEC_OK);
+        ASSERT_EQ(mgr.Preprocessing(), GST_CODEC_OK);
+        ASSERT_EQ(mgr.Start(), GST_CODEC_OK);
+    }
+
+    void TearDownInput(CodecComponentMock &component, HdiVdecInBufferMgr &mgr)
+    {
+        ASSERT_EQ(mgr.Stop(), GST_CODEC_OK);
+        ASSERT_EQ(mgr.FreeBuffers(), GST_CODEC_OK);
+        EXPECT_EQ(component.GetFreedCount(), component.GetUsedCount());
+    }
+}
+
+namespace OHOS {
+namespace Media {
+class HdiVencOutBufferMgrTest : public HdiVencOutBufferMgr {
+public:
+    void QueueReadyFront(GstBuffer *buffer)
+    {
+        mBuffers.push_front({ false, buffer });
+    }
+
+    size_t ReadyCount() const
+    {
+        return mBuffers.size();
+    }
+};
+
+class HdiBufferMgrUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void)
+    {
+        gst_init(nullptr, nullptr);
+    }
+    static void TearDownTestCase(void) {}
+    void SetUp(void) {}
+    void TearDown(void) {}
+};
+
+/**
+ * @tc.name: HdiBufferMgr_Input_0100
+ * @tc.desc: push all input buffers, return them in the reverse order, and push them again
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdiBufferMgrUnitTest, HdiBufferMgr_Input_0100, TestSize.Level0)
+{
+    CodecComponentMock component(BUFFER_COUNT);
+    HdiVdecInBufferMgr mgr;
+    vector<GstBuffer *> buffers = CreateBuffers(BUFFER_COUNT);
+    SetUpInput(component, mgr, buffers);
+    EXPECT_EQ(component.GetUsedCount(), BUFFER_COUNT);
+
+    for (uint32_t round = 0; round < 2; round++) { // 2: the returned buffers could be pushed again
+        for (auto buffer : buffers) {
+            ASSERT_EQ(mgr.PushBuffer(buffer), GST_CODEC_OK);
+            EXPECT_EQ(RefCount(buffer), 2); // 2: held by the test and the codec
+        }
+        vector<OmxCodecBuffer> submitted = PopAllSubmitted(component);
+        ASSERT_EQ(submitted.size(), BUFFER_COUNT);
+        for (auto iter = submitted.rbegin(); iter != submitted.rend(); ++iter) {
+            EXPECT_EQ(iter->filledLen, BUFFER_SIZE);
+            ASSERT_EQ(mgr.CodecBufferAvailable(&(*iter)), GST_CODEC_OK);
+        }
+        for (auto buffer : buffers) {
+            EXPECT_EQ(RefCount(buffer), 1);
+        }
+    }
+
+    TearDownInput(component, mgr);
+    ReleaseBuffers(buffers);
+}
+
+/**
+ * @tc.name: HdiBufferMgr_Input_0200
+ * @tc.desc: reject the unknown buffers, and ignore the unknown or repeated buffer dones
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdiBufferMgrUnitTest, HdiBufferMgr_Input_0200, TestSize.Level0)
+{
+    CodecComponentMock component(BUFFER_COUNT);
+    HdiVdecInBufferMgr mgr;
+    vector<GstBuffer *> buffers = CreateBuffers(BUFFER_COUNT);
+    SetUpInput(component, mgr, buffers);
+
+    GstBuffer *unknown = CreateBuffer(FIRST_FD + BUFFER_COUNT);
+    EXPECT_EQ(mgr.PushBuffer(unknown), GST_CODEC_ERROR);
+    EXPECT_EQ(RefCount(unknown), 1);
+    gst_buffer_unref(unknown);
+
+    ASSERT_EQ(mgr.PushBuffer(buffers[0]), GST_CODEC_OK);
+    EXPECT_EQ(mgr.PushBuffer(buffers[0]), GST_CODEC_ERROR);
+    vector<OmxCodecBuffer> submitted = PopAllSubmitted(component);
+    ASSERT_EQ(submitted.size(), 1u);
+
+    OmxCodecBuffer stranger = submitted[0];
+    stranger.bufferId += 1;
+    ASSERT_EQ(mgr.CodecBufferAvailable(&stranger), GST_CODEC_OK);
+    EXPECT_EQ(RefCount(buffers[0]), 2); // 2: held by the test and the codec
+    ASSERT_EQ(mgr.CodecBufferAvailable(&submitted[0]), GST_CODEC_OK);
+    EXPECT_EQ(RefCount(buffers[0]), 1);
+    ASSERT_EQ(mgr.CodecBufferAvailable(&submitted[0]), GST_CODEC_OK);
+    EXPECT_EQ(RefCount(buffers[0]), 1);
+
+    TearDownInput(component, mgr);
+    ReleaseBuffers(buffers);
+}
+
+/**
+ * @tc.name: HdiBufferMgr_Input_0300
+ * @tc.desc: the eos buffer is sent empty with the eos flag, which is cleared once it is returned
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdiBufferMgrUnitTest, HdiBufferMgr_Input_0300, TestSize.Level0)
+{
+    CodecComponentMock component(1);
+    HdiVdecInBufferMgr mgr;
+    vector<GstBuffer *> buffers = CreateBuffers(1);
+    SetUpInput(component, mgr, buffers);
+
+    ASSERT_EQ(mgr.PushBuffer(nullptr), GST_CODEC_OK);
+    vector<OmxCodecBuffer> submitted = PopAllSubmitted(component);
+    ASSERT_EQ(submitted.size(), 1u);
+    EXPECT_EQ(submitted[0].filledLen, 0u);
+    EXPECT_NE(submitted[0].flag & OMX_BUFFERFLAG_EOS, 0u);
+    ASSERT_EQ(mgr.CodecBufferAvailable(&submitted[0]), GST_CODEC_OK);
+
+    ASSERT_EQ(mgr.PushBuffer(buffers[0]), GST_CODEC_OK);
+    submitted = PopAllSubmitted(component);
+    ASSERT_EQ(submitted.size(), 1u);
+    EXPECT_EQ(submitted[0].flag & OMX_BUFFERFLAG_EOS, 0u);
+    ASSERT_EQ(mgr.CodecBufferAvailable(&submitted[0]), GST_CODEC_OK);
+
+    TearDownInput(component, mgr);
+    ReleaseBuffers(buffers);
+}
+
+/**
+ * @tc.name: HdiBufferMgr_Input_0400
+ * @tc.desc: the codec returns the buffer before EmptyThisBuffer returns
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdiBufferMgrUnitTest, HdiBufferMgr_Input_0400, TestSize.Level0)
+{
+    CodecComponentMock component(BUFFER_COUNT);
+    HdiVdecInBufferMgr mgr;
+    vector<GstBuffer *> buffers = CreateBuffers(BUFFER_COUNT);
+    SetUpInput(component, mgr, buffers);
+    component.SetBufferDone([&mgr](const OmxCodecBuffer &buffer) { (void)mgr.CodecBufferAvailable(&buffer); });
+
+    for (uint32_t round = 0; round < REENTRANT_ROUNDS; round++) {
+        for (auto buffer : buffers) {
+            ASSERT_EQ(mgr.PushBuffer(buffer), GST_CODEC_OK);
+        }
+    }
+    for (auto buffer : buffers) {
+        EXPECT_EQ(RefCount(buffer), 1);
+    }
+
+    TearDownInput(component, mgr);
+    ReleaseBuffers(buffers);
+}
+
+/**
+ * @tc.name: HdiBufferMgr_Input_0500
+ * @tc.desc: flush wakes up the push waiting for an available buffer
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdiBufferMgrUnitTest, HdiBufferMgr_Input_0500, TestSize.Level0)
+{
+    CodecComponentMock component(1);
+    HdiVdecInBufferMgr mgr;
+    vector<GstBuffer *> buffers = CreateBuffers(1);
+    SetUpInput(component, mgr, buffers);
+
+    ASSERT_EQ(mgr.PushBuffer(buffers[0]), GST_CODEC_OK);
+    int32_t ret = GST_CODEC_OK;
+    std::thread pusher([&mgr, &buffers, &ret]() { ret = mgr.PushBuffer(buffers[0]); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10)); // 10: let the push wait
+    ASSERT_EQ(mgr.Flush(true), GST_CODEC_OK);
+    pusher.join();
+    EXPECT_EQ(ret, GST_CODEC_FLUSH);
+    EXPECT_EQ(mgr.PushBuffer(buffers[0]), GST_CODEC_FLUSH);
+
+    vector<OmxCodecBuffer> submitted = PopAllSubmitted(component);
+    ASSERT_EQ(submitted.size(), 1u);
+    ASSERT_EQ(mgr.CodecBufferAvailable(&submitted[0]), GST_CODEC_OK);
+    ASSERT_EQ(mgr.Flush(false), GST_CODEC_OK);
+    mgr.WaitFlushed();
+    ASSERT_EQ(mgr.Start(), GST_CODEC_OK);
+    ASSERT_EQ(mgr.PushBuffer(buffers[0]), GST_CODEC_OK);
+    submitted = PopAllSubmitted(component);
+    ASSERT_EQ(submitted.size(), 1u);
+    ASSERT_EQ(mgr.CodecBufferAvailable(&submitted[0]), GST_CODEC_OK);
+
+    TearDownInput(component, mgr);
+    ReleaseBuffers(buffers);
+}
+
+/**
+ * @tc.name: HdiBufferMgr_Output_0100
+ * @tc.desc: the filled output buffers are pulled in the order they are returned by the codec
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdiBufferMgrUnitTest, HdiBufferMgr_Output_0100, TestSize.Level0)
+{
+    constexpr uint32_t filledLen = 100;
+    CodecComponentMock component(BUFFER_COUNT);
+    HdiVencOutBufferMgr mgr;
+    CompVerInfo verInfo = {};
+    mgr.Init(component.GetComponent(), 1, verInfo);
+    vector<GstBuffer *> buffers = CreateBuffers(BUFFER_COUNT);
+    ASSERT_EQ(mgr.UseBuffers(buffers), GST_CODEC_OK);
+    ASSERT_EQ(mgr.Start(), GST_CODEC_OK);
+    vector<OmxCodecBuffer> submitted = PopAllSubmitted(component);
+    ASSERT_EQ(submitted.size(), BUFFER_COUNT);
+
+    submitted[1].filledLen = filledLen;
+    ASSERT_EQ(mgr.CodecBufferAvailable(&submitted[1]), GST_CODEC_OK);
+    submitted[0].flag |= OMX_BUFFERFLAG_EOS;
+    ASSERT_EQ(mgr.CodecBufferAvailable(&submitted[0]), GST_CODEC_OK);
+
+    GstBuffer *buffer = nullptr;
+    ASSERT_EQ(mgr.PullBuffer(&buffer), GST_CODEC_OK);
+    ASSERT_EQ(buffer, buffers[1]);
+    EXPECT_EQ(gst_buffer_get_size(buffer), filledLen);
+    EXPECT_EQ(mgr.PullBuffer(&buffer), GST_CODEC_EOS);
+
+    // the pulled buffer is given back with the reference taken by PullBuffer
+    ASSERT_EQ(mgr.PushBuffer(buffer), GST_CODEC_OK);
+    vector<OmxCodecBuffer> refilled = PopAllSubmitted(component);
+    ASSERT_EQ(refilled.size(), 1u);
+    ASSERT_EQ(mgr.CodecBufferAvailable(&refilled[0]), GST_CODEC_OK);
+    for (uint32_t i = 2; i < BUFFER_COUNT; i++) { // 2: the first two buffers are returned
+        ASSERT_EQ(mgr.CodecBufferAvailable(&submitted[i]), GST_CODEC_OK);
+    }
+
+    ASSERT_EQ(mgr.Stop(), GST_CODEC_OK);
+    ASSERT_EQ(mgr.FreeBuffers(), GST_CODEC_OK);
+    EXPECT_EQ(component.GetFreedCount(), BUFFER_COUNT);
+    for (auto gstBuffer : buffers) {
+        EXPECT_EQ(RefCount(gstBuffer), 1);
+    }
+    ReleaseBuffers(buffers);
+}
+
+/**
+ * @tc.name: HdiBufferMgr_Output_0200
+ * @tc.desc: a ready output buffer which can not be submitted at start is kept queued
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdiBufferMgrUnitTest, HdiBufferMgr_Output_0200, TestSize.Level0)
+{
+    CodecComponentMock component(BUFFER_COUNT);
+    HdiVencOutBufferMgrTest mgr;
+    CompVerInfo verInfo = {};
+    mgr.Init(component.GetComponent(), 1, verInfo);
+    vector<GstBuffer *> buffers = CreateBuffers(BUFFER_COUNT);
+    ASSERT_EQ(mgr.UseBuffers(buffers), GST_CODEC_OK);
+
+    // no fd meta, so no codec buffer is found for it
+    GstBuffer *unknown = gst_buffer_new_allocate(nullptr, BUFFER_SIZE, nullptr);
+    mgr.QueueReadyFront(gst_buffer_ref(unknown));
+    EXPECT_EQ(mgr.Start(), GST_CODEC_ERROR);
+    EXPECT_EQ(mgr.ReadyCount(), BUFFER_COUNT + 1);
+    EXPECT_EQ(RefCount(unknown), 2); // 2: held by the test and the ready queue
+    EXPECT_TRUE(PopAllSubmitted(component).empty());
+
+    ASSERT_EQ(mgr.Stop(), GST_CODEC_OK);
+    ASSERT_EQ(mgr.FreeBuffers(), GST_CODEC_OK);
+    EXPECT_EQ(RefCount(unknown), 1);
+    gst_buffer_unref(unknown);
+    ReleaseBuffers(buffers);
+}
+
+/**
+ * @tc.name: HdiBufferMgr_Benchmark_0100
+ * @tc.desc: report the cost of an input buffer round trip, pushed and returned in the reverse order
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(HdiBufferMgrUnitTest, HdiBufferMgr_Benchmark_0100, TestSize.Level1)
+{
+    for (uint32_t count : BENCH_BUFFER_COUNTS) {
+        CodecComponentMock component(count);
+        HdiVdecInBufferMgr mgr;
+        vector<GstBuffer *> buffers = CreateBuffers(count);
+        SetUpInput(component, mgr, buffers);
+        vector<OmxCodecBuffer> submitted;
+        submitted.reserve(count);
+
+        auto start = chrono::steady_clock::now();
+        for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+            for (auto buffer : buffers) {
+                ASSERT_EQ(mgr.PushBuffer(buffer), GST_CODEC_OK);
+            }
+            OmxCodecBuffer codecBuffer = {};
+            while (component.PopSubmitted(codecBuffer)) {
+                submitted.push_back(codecBuffer);
+            }
+            for (auto iter = submitted.rbegin(); iter != submitted.rend(); ++iter) {
+                ASSERT_EQ(mgr.CodecBufferAvailable(&(*iter)), GST_CODEC_OK);
+            }
+            submitted.clear();
+        }
+        chrono::duration<double> cost = chrono::steady_clock::now() - start;
+        cout << "hdi input buffer round trip, " << count << " buffers: " <<
+            cost.count() * NS_PER_S / (static_cast<double>(BENCH_ROUNDS) * count) << " ns/buffer" << endl;
+
+        TearDownInput(component, mgr);
+        ReleaseBuffers(buffers);
+    }
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "gtest/gtest.h"
+#include "avcodec_pipeline_pool.h"
+#include "media_errors.h"
+
+using namespace std;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace testing::ext;
+
+namespace {
+    constexpr uint32_t POOL_CAPACITY = 2;
+    constexpr int64_t IDLE_TIMEOUT_US = 200000; // 200ms
+    constexpr int64_t LONG_IDLE_TIMEOUT_US = 60000000; // 60s, not reached by the cases
+    constexpr int32_t WAIT_STEP_MS = 10;
+    constexpr int32_t WAIT_TIMEOUT_MS = 3000;
+    constexpr int64_t OVER_MAX_DELAY_TIMEOUT_US = 11000000; // 11s, the TaskQueue rejects delays from 10s
+    constexpr int32_t OVER_MAX_DELAY_WAIT_MS = 20000;
+
+    // an empty pipeline, it reaches READY without any coder plugin
+    int32_t BuildEmpty(const CodecPipelineKey &key, CodecPipeline &pipeline)
+    {
+        (void)key;
+        pipeline.pipeline = GST_PIPELINE_CAST(gst_object_ref_sink(gst_pipeline_new("test-pipeline")));
+        if (pipeline.pipeline == nullptr) {
+            return MSERR_NO_MEMORY;
+        }
+        pipeline.bus = gst_pipeline_get_bus(pipeline.pipeline);
+        return MSERR_OK;
+    }
+
+    bool WaitForSize(AVCodecPipelinePool &pool, uint32_t size, int32_t timeoutMs = WAIT_TIMEOUT_MS)
+    {
+        for (int32_t waitedMs = 0; waitedMs < timeoutMs; waitedMs += WAIT_STEP_MS) {
+            if (pool.GetSize() == size) {
+                return true;
+            }
+            this_thread::sleep_for(chrono::milliseconds(WAIT_STEP_MS));
+        }
+        return pool.GetSize() == size;
+    }
+
+    // a pipeline released by a session of the key, taken back by the pool
+    bool Release(AVCodecPipelinePool &pool, const CodecPipelineKey &key)
+    {
+        CodecPipeline pipeline;
+        if (BuildEmpty(key, pipeline) != MSERR_OK) {
+            return false;
+        }
+        if (pool.Recycle(key, pipeline)) {
+            return true;
+        }
+        AVCodecPipelinePool::Destroy(pipeline);
+        return false;
+    }
+
+    CodecPipelineKey MakeKey(const string &name)
+    {
+        CodecPipelineKey key;
+        key.type = AVCODEC_TYPE_VIDEO_DECODER;
+        key.name = name;
+        return key;
+    }
+}
+
+namespace OHOS {
+namespace Media {
+class AVCodecPipelinePoolUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void)
+    {
+        gst_init(nullptr, nullptr);
+    }
+    static void TearDownTestCase(void) {}
+    void SetUp(void) {}
+    void TearDown(void) {}
+};
+
+/**
+ * @tc.name: AVCodecPipelinePool_Acquire_0100
+ * @tc.desc: a released pipeline is kept in READY and taken by the next acquire of its key
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVCodecPipelinePoolUnitTest, AVCodecPipelinePool_Acquire_0100, TestSize.Level0)
+{
+    AVCodecPipelinePool pool(POOL_CAPACITY, LONG_IDLE_TIMEOUT_US, BuildEmpty);
+    CodecPipelineKey key = MakeKey("dec0");
+    CodecPipeline pipeline;
+    EXPECT_FALSE(pool.Acquire(key, pipeline));
+
+    ASSERT_EQ(BuildEmpty(key, pipeline), MSERR_OK);
+    GstPipeline *released = pipeline.pipeline;
+    ASSERT_TRUE(pool.Recycle(key, pipeline));
+    EXPECT_EQ(pipeline.pipeline, nullptr);
+    EXPECT_EQ(pool.GetSize(), 1u);
+
+    EXPECT_FALSE(pool.Acquire(MakeKey("dec1"), pipeline));
+    ASSERT_TRUE(pool.Acquire(key, pipeline));
+    EXPECT_EQ(pipeline.pipeline, released);
+    GstState state = GST_STATE_VOID_PENDING;
+    (void)gst_element_get_state(GST_ELEMENT_CAST(pipeline.pipeline), &state, nullptr, 0);
+    EXPECT_EQ(state, GST_STATE_READY);
+    EXPECT_EQ(pool.GetSize(), 0u);
+    AVCodecPipelinePool::Destroy(pipeline);
+}
+
+/**
+ * @tc.name: AVCodecPipelinePool_Recycle_0100
+ * @tc.desc: a disabled pool does not take back the released pipelines
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVCodecPipelinePoolUnitTest, AVCodecPipelinePool_Recycle_0100, TestSize.Level0)
+{
+    AVCodecPipelinePool pool(0, LONG_IDLE_TIMEOUT_US, BuildEmpty);
+    CodecPipelineKey key = MakeKey("dec0");
+    EXPECT_FALSE(Release(pool, key));
+    EXPECT_EQ(pool.GetSize(), 0u);
+    CodecPipeline pipeline;
+    EXPECT_FALSE(pool.Acquire(key, pipeline));
+}
+
+/**
+ * @tc.name: AVCodecPipelinePool_Capacity_0100
+ * @tc.desc: no more pipelines than the capacity are kept warm
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVCodecPipelinePoolUnitTest, AVCodecPipelinePool_Capacity_0100, TestSize.Level0)
+{
+    AVCodecPipelinePool pool(POOL_CAPACITY, LONG_IDLE_TIMEOUT_US, BuildEmpty);
+    for (uint32_t i = 0; i < POOL_CAPACITY; i++) {
+        EXPECT_TRUE(Release(pool, MakeKey("dec" + to_string(i))));
+    }
+    EXPECT_FALSE(Release(pool, MakeKey("dec" + to_string(POOL_CAPACITY))));
+    EXPECT_EQ(pool.GetSize(), POOL_CAPACITY);
+}
+
+/**
+ * @tc.name: AVCodecPipelinePool_Evict_0100
+ * @tc.desc: the idle pipelines are evicted after the idle timeout, also those released after the first check
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVCodecPipelinePoolUnitTest, AVCodecPipelinePool_Evict_0100, TestSize.Level0)
+{
+    AVCodecPipelinePool pool(POOL_CAPACITY, IDLE_TIMEOUT_US, BuildEmpty);
+    ASSERT_TRUE(Release(pool, MakeKey("dec0")));
+    this_thread::sleep_for(chrono::microseconds(IDLE_TIMEOUT_US / 2)); // 2: release the next one half way
+    ASSERT_TRUE(Release(pool, MakeKey("dec1")));
+
+    // the check for the first one finds the second one still fresh, and queues the next check for it
+    ASSERT_TRUE(WaitForSize(pool, 0));
+    CodecPipeline pipeline;
+    EXPECT_FALSE(pool.Acquire(MakeKey("dec0"), pipeline));
+    EXPECT_FALSE(pool.Acquire(MakeKey("dec1"), pipeline));
+}
+
+/**
+ * @tc.name: AVCodecPipelinePool_Evict_0200
+ * @tc.desc: an idle timeout longer than the max delay of the TaskQueue still evicts the idle pipelines
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVCodecPipelinePoolUnitTest, AVCodecPipelinePool_Evict_0200, TestSize.Level1)
+{
+    AVCodecPipelinePool pool(POOL_CAPACITY, OVER_MAX_DELAY_TIMEOUT_US, BuildEmpty);
+    ASSERT_TRUE(Release(pool, MakeKey("dec0")));
+    this_thread::sleep_for(chrono::milliseconds(WAIT_STEP_MS));
+    EXPECT_EQ(pool.GetSize(), 1u);
+
+    ASSERT_TRUE(WaitForSize(pool, 0, OVER_MAX_DELAY_WAIT_MS));
+}
+} // namespace Media
+} // namespace OHOS
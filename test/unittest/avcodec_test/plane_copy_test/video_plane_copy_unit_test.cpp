@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include "gtest/gtest.h"
+#include "video_plane_copy.h"
+
+using namespace std;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace testing::ext;
+
+namespace {
+    constexpr uint32_t STRIDE_ALIGN = 256;
+    constexpr uint32_t HEIGHT_ALIGN = 32;
+    constexpr uint32_t BENCH_FRAMES = 100;
+    constexpr double BYTES_PER_GB = 1024.0 * 1024.0 * 1024.0;
+
+    struct Resolution {
+        const char *name;
+        uint32_t width;
+        uint32_t height;
+    };
+    constexpr Resolution BENCH_RESOLUTIONS[] = {
+        { "720p", 1280, 720 },
+        { "1080p", 1920, 1080 },
+        { "4K", 3840, 2160 },
+    };
+
+    uint32_t Align(uint32_t value, uint32_t align)
+    {
+        return (value + align - 1) / align * align;
+    }
+
+    void FillPattern(vector<uint8_t> &buffer)
+    {
+        for (size_t i = 0; i < buffer.size(); i++) {
+            buffer[i] = static_cast<uint8_t>(i * 31 + 7); // 31, 7: arbitrary pattern
+        }
+    }
+
+    // copy a strided nv12 frame into a no stride frame as the vdec does for avshmem output
+    bool CopyNv12(vector<uint8_t> &dst, const vector<uint8_t> &src, uint32_t width, uint32_t height,
+        uint32_t stride, uint32_t strideHeight)
+    {
+        size_t ySize = static_cast<size_t>(width) * height;
+        size_t offset = static_cast<size_t>(stride) * strideHeight;
+        return CopyVideoPlane(dst.data(), dst.size(), width, src.data(), src.size(), stride, width, height) &&
+            CopyVideoPlane(dst.data() + ySize, dst.size() - ySize, width,
+                src.data() + offset, src.size() - offset, stride, width, height / 2); // 2: uv half height
+    }
+}
+
+namespace OHOS {
+namespace Media {
+class VideoPlaneCopyUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+    static void TearDownTestCase(void) {}
+    void SetUp(void) {}
+    void TearDown(void) {}
+};
+
+/**
+ * @tc.name: VideoPlaneCopy_Strided_0100
+ * @tc.desc: copy strided rows of widths around the vector block size
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(VideoPlaneCopyUnitTest, VideoPlaneCopy_Strided_0100, TestSize.Level0)
+{
+    constexpr uint32_t rows = 5;
+    for (uint32_t width = 1; width <= 200; width++) { // 200: covers several 64 bytes blocks and tails
+        uint32_t srcStride = width + 13; // 13: odd padding
+        vector<uint8_t> src(srcStride * rows);
+        FillPattern(src);
+        vector<uint8_t> dst(width * rows, 0);
+        ASSERT_TRUE(CopyVideoPlane(dst.data(), dst.size(), width, src.data(), src.size(), srcStride, width, rows));
+        for (uint32_t row = 0; row < rows; row++) {
+            for (uint32_t col = 0; col < width; col++) {
+                ASSERT_EQ(dst[row * width + col], src[row * srcStride + col]);
+            }
+        }
+    }
+}
+
+/**
+ * @tc.name: VideoPlaneCopy_Contiguous_0100
+ * @tc.desc: copy a full width plane which is copied at once
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(VideoPlaneCopyUnitTest, VideoPlaneCopy_Contiguous_0100, TestSize.Level0)
+{
+    constexpr uint32_t width = 1920;
+    constexpr uint32_t rows = 1080;
+    vector<uint8_t> src(width * rows);
+    FillPattern(src);
+    vector<uint8_t> dst(width * rows, 0);
+    ASSERT_TRUE(CopyVideoPlane(dst.data(), dst.size(), width, src.data(), src.size(), width, width, rows));
+    EXPECT_EQ(dst, src);
+}
+
+/**
+ * @tc.name: VideoPlaneCopy_Invalid_0100
+ * @tc.desc: reject buffers too small to hold the plane and strides narrower than the width
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(VideoPlaneCopyUnitTest, VideoPlaneCopy_Invalid_0100, TestSize.Level0)
+{
+    constexpr uint32_t width = 64;
+    constexpr uint32_t stride = 128;
+    constexpr uint32_t rows = 4;
+    vector<uint8_t> src(stride * (rows - 1) + width);
+    vector<uint8_t> dst(width * rows, 0);
+    EXPECT_TRUE(CopyVideoPlane(dst.data(), dst.size(), width, src.data(), src.size(), stride, width, rows));
+    EXPECT_FALSE(CopyVideoPlane(dst.data(), dst.size(), width, src.data(), src.size() - 1, stride, width, rows));
+    EXPECT_FALSE(CopyVideoPlane(dst.data(), dst.size() - 1, width, src.data(), src.size(), stride, width, rows));
+    EXPECT_FALSE(CopyVideoPlane(dst.data(), dst.size(), width, src.data(), src.size(), width - 1, width, rows));
+    EXPECT_FALSE(CopyVideoPlane(nullptr, dst.size(), width, src.data(), src.size(), stride, width, rows));
+}
+
+/**
+ * @tc.name: VideoPlaneCopy_Benchmark_0100
+ * @tc.desc: report the de-stride throughput of nv12 frames for common resolutions
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(VideoPlaneCopyUnitTest, VideoPlaneCopy_Benchmark_0100, TestSize.Level1)
+{
+    for (const auto &res : BENCH_RESOLUTIONS) {
+        uint32_t stride = Align(res.width, STRIDE_ALIGN);
+        uint32_t strideHeight = Align(res.height, HEIGHT_ALIGN);
+        vector<uint8_t> src(static_cast<size_t>(stride) * strideHeight * 3 / 2); // 3 / 2: nv12 size
+        FillPattern(src);
+        vector<uint8_t> dst(static_cast<size_t>(res.width) * res.height * 3 / 2); // 3 / 2: nv12 size
+
+        ASSERT_TRUE(CopyNv12(dst, src, res.width, res.height, stride, strideHeight));
+        auto start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_FRAMES; i++) {
+            ASSERT_TRUE(CopyNv12(dst, src, res.width, res.height, stride, strideHeight));
+        }
+        chrono::duration<double> cost = chrono::steady_clock::now() - start;
+        double gbps = static_cast<double>(dst.size()) * BENCH_FRAMES / BYTES_PER_GB / cost.count();
+        cout << "de-stride " << res.name << " (" << res.width << "x" << res.height << ", stride " << stride <<
+            "): " << gbps << " GB/s, " << cost.count() * 1000 / BENCH_FRAMES << " ms/frame" << endl; // 1000: ms
+    }
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,687 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vcodec_bench.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <sync_fence.h>
+#include "av_common.h"
+#include "avcodec_common.h"
+#include "media_description.h"
+#include "media_errors.h"
+#include "media_metrics.h"
+#include "securec.h"
+#include "surface_native_mock.h"
+#include "unittest_log.h"
+
+using namespace std;
+
+namespace OHOS {
+namespace Media {
+namespace {
+    constexpr int64_t WAIT_SLICE_MS = 1;
+    constexpr int32_t FENCE_WAIT_MS = 100;
+    constexpr int32_t STRIDE_ALIGN = 8;
+    constexpr int64_t US_PER_SEC = 1000000;
+    constexpr int64_t US_PER_MS = 1000;
+    constexpr int64_t NS_PER_US = 1000;
+    constexpr uint32_t PERCENT_50 = 50;
+    constexpr uint32_t PERCENT_90 = 90;
+    constexpr uint32_t PERCENT_99 = 99;
+    constexpr uint32_t PERCENT_FULL = 100;
+    constexpr uint32_t KEY_FRAME_INTERVAL = 30;
+    constexpr uint32_t PATTERN_STEP = 3;
+    constexpr uint8_t CHROMA_NEUTRAL = 128;
+    const std::string SERVICE_PROCESS_NAME = "media_service";
+}
+
+void VBenchCallback::OnError(int32_t errorCode)
+{
+    cout << "VBench Error errorCode=" << errorCode << endl;
+    if (signal_ == nullptr) {
+        return;
+    }
+    signal_->callbacks_.fetch_add(1);
+    signal_->hasError_.store(true);
+    signal_->cond_.notify_all();
+}
+
+void VBenchCallback::OnStreamChanged(std::shared_ptr<FormatMock> format)
+{
+    (void)format;
+    if (signal_ != nullptr) {
+        signal_->callbacks_.fetch_add(1);
+    }
+}
+
+void VBenchCallback::OnNeedInputData(uint32_t index, std::shared_ptr<AVMemoryMock> data)
+{
+    if (signal_ == nullptr) {
+        return;
+    }
+    signal_->callbacks_.fetch_add(1);
+    unique_lock<mutex> lock(signal_->mutex_);
+    if (!signal_->isRunning_.load()) {
+        return;
+    }
+    signal_->inIndexQueue_.push(index);
+    signal_->inBufferQueue_.push(data);
+    signal_->cond_.notify_all();
+}
+
+void VBenchCallback::OnNewOutputData(uint32_t index, std::shared_ptr<AVMemoryMock> data, AVCodecBufferAttrMock attr)
+{
+    if (signal_ == nullptr) {
+        return;
+    }
+    signal_->callbacks_.fetch_add(1);
+    unique_lock<mutex> lock(signal_->mutex_);
+    if (!signal_->isRunning_.load()) {
+        return;
+    }
+    signal_->outIndexQueue_.push(index);
+    signal_->outBufferQueue_.push(data);
+    signal_->outAttrQueue_.push(attr);
+    signal_->cond_.notify_all();
+}
+
+void VBenchLatency::OnQueued()
+{
+    queued_.push(VBenchInstance::GetNowUs());
+}
+
+void VBenchLatency::OnOutput()
+{
+    if (queued_.empty()) {
+        return;
+    }
+    samples_.push_back(VBenchInstance::GetNowUs() - queued_.front());
+    queued_.pop();
+}
+
+void VBenchLatency::Fill(VBenchResult &result)
+{
+    if (samples_.empty()) {
+        return;
+    }
+    std::sort(samples_.begin(), samples_.end());
+    auto percentile = [this](uint32_t percent) {
+        return samples_[(samples_.size() - 1) * percent / PERCENT_FULL];
+    };
+    result.latencyP50Us = percentile(PERCENT_50);
+    result.latencyP90Us = percentile(PERCENT_90);
+    result.latencyP99Us = percentile(PERCENT_99);
+    result.latencyMaxUs = samples_.back();
+}
+
+VBenchInstance::VBenchInstance(uint32_t id, const VBenchConfig &config)
+    : id_(id), config_(config)
+{
+    signal_ = std::make_shared<VBenchSignal>();
+    callback_ = std::make_shared<VBenchCallback>(signal_);
+}
+
+VBenchInstance::~VBenchInstance()
+{
+}
+
+int64_t VBenchInstance::GetNowUs()
+{
+    auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+}
+
+std::shared_ptr<FormatMock> VBenchInstance::CreateFormat() const
+{
+    std::shared_ptr<FormatMock> format = AVCodecMockFactory::CreateFormat();
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(format != nullptr, nullptr, "CreateFormat failed");
+    (void)format->PutIntValue(MediaDescriptionKey::MD_KEY_WIDTH, config_.width);
+    (void)format->PutIntValue(MediaDescriptionKey::MD_KEY_HEIGHT, config_.height);
+    (void)format->PutIntValue(MediaDescriptionKey::MD_KEY_PIXEL_FORMAT, NV12);
+    (void)format->PutIntValue(MediaDescriptionKey::MD_KEY_FRAME_RATE, config_.frameRate);
+    return format;
+}
+
+bool VBenchInstance::PopInput(uint32_t &index, std::shared_ptr<AVMemoryMock> &data)
+{
+    unique_lock<mutex> lock(signal_->mutex_);
+    if (signal_->inIndexQueue_.empty()) {
+        return false;
+    }
+    index = signal_->inIndexQueue_.front();
+    data = signal_->inBufferQueue_.front();
+    signal_->inIndexQueue_.pop();
+    signal_->inBufferQueue_.pop();
+    return true;
+}
+
+VBenchResult VBenchInstance::Run()
+{
+    VBenchResult result;
+    result.instanceId = id_;
+    result.codecName = codecName_;
+    signal_->isRunning_.store(true);
+    if (Start() != MSERR_OK) {
+        cout << "VBench instance " << id_ << " start failed" << endl;
+        signal_->isRunning_.store(false);
+        return result;
+    }
+    apiCalls_++;
+
+    int64_t startUs = GetNowUs();
+    int64_t lastProgressUs = startUs;
+    while (!eos_ && !signal_->hasError_.load()) {
+        bool progress = FeedInput();
+
+        uint32_t index = 0;
+        std::shared_ptr<AVMemoryMock> data = nullptr;
+        AVCodecBufferAttrMock attr;
+        bool hasOutput = false;
+        {
+            unique_lock<mutex> lock(signal_->mutex_);
+            if (!progress) {
+                signal_->cond_.wait_for(lock, std::chrono::milliseconds(WAIT_SLICE_MS), [this]() {
+                    return !signal_->outIndexQueue_.empty() || HasPendingInput() || signal_->hasError_.load();
+                });
+            }
+            if (!signal_->outIndexQueue_.empty()) {
+                index = signal_->outIndexQueue_.front();
+                data = signal_->outBufferQueue_.front();
+                attr = signal_->outAttrQueue_.front();
+                signal_->outIndexQueue_.pop();
+                signal_->outBufferQueue_.pop();
+                signal_->outAttrQueue_.pop();
+                hasOutput = true;
+            }
+        }
+        if (hasOutput) {
+            UNITTEST_CHECK_AND_BREAK_LOG(DrainOutput(index, data, attr), "drain output failed");
+            progress = true;
+        }
+
+        int64_t nowUs = GetNowUs();
+        if (progress) {
+            lastProgressUs = nowUs;
+        } else if (nowUs - lastProgressUs > VCodecBenchParam::STALL_TIMEOUT_MS * US_PER_MS) {
+            cout << "VBench instance " << id_ << " stalled after " << outFrames_ << " frames" << endl;
+            break;
+        }
+    }
+    result.elapsedUs = GetNowUs() - startUs;
+    signal_->isRunning_.store(false);
+    (void)Stop();
+    apiCalls_++;
+
+    result.completed = eos_ && !signal_->hasError_.load();
+    result.frames = outFrames_;
+    if (result.elapsedUs > 0) {
+        result.fps = static_cast<double>(outFrames_) * US_PER_SEC / result.elapsedUs;
+    }
+    latency_.Fill(result);
+    result.apiCalls = apiCalls_ + signal_->callbacks_.load();
+    if (outFrames_ > 0) {
+        result.apiPerFrame = static_cast<double>(result.apiCalls) / outFrames_;
+    }
+    return result;
+}
+
+VDecBenchInstance::VDecBenchInstance(uint32_t id, const VBenchConfig &config,
+    std::shared_ptr<const VBenchStream> stream)
+    : VBenchInstance(id, config), stream_(stream)
+{
+    codecName_ = config.decoderName;
+}
+
+VDecBenchInstance::~VDecBenchInstance()
+{
+    (void)Release();
+}
+
+int32_t VDecBenchInstance::Init()
+{
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(stream_ != nullptr && !stream_->frames.empty(), MSERR_INVALID_VAL,
+        "no stream to decode");
+    videoDec_ = AVCodecMockFactory::CreateVideoDecMockByName(codecName_);
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(videoDec_ != nullptr, MSERR_UNKNOWN, "create decoder failed");
+    int32_t ret = videoDec_->SetCallback(callback_);
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "SetCallback failed");
+
+    std::shared_ptr<FormatMock> format = CreateFormat();
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(format != nullptr, MSERR_NO_MEMORY, "create format failed");
+    ret = videoDec_->Configure(format);
+    format->Destroy();
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Configure failed");
+
+    surface_ = AVCodecMockFactory::CreateSurface();
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(surface_ != nullptr, MSERR_NO_MEMORY, "create surface failed");
+    ret = videoDec_->SetOutputSurface(surface_);
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "SetOutputSurface failed");
+    ret = videoDec_->Prepare();
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Prepare failed");
+    return MSERR_OK;
+}
+
+int32_t VDecBenchInstance::Start()
+{
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(videoDec_ != nullptr, MSERR_INVALID_OPERATION, "decoder not created");
+    return videoDec_->Start();
+}
+
+int32_t VDecBenchInstance::Stop()
+{
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(videoDec_ != nullptr, MSERR_INVALID_OPERATION, "decoder not created");
+    return videoDec_->Stop();
+}
+
+int32_t VDecBenchInstance::Release()
+{
+    if (videoDec_ == nullptr) {
+        return MSERR_OK;
+    }
+    int32_t ret = videoDec_->Release();
+    videoDec_ = nullptr;
+    return ret;
+}
+
+bool VDecBenchInstance::HasPendingInput() const
+{
+    return !eosSent_ && !signal_->inIndexQueue_.empty();
+}
+
+bool VDecBenchInstance::FeedInput()
+{
+    bool progress = false;
+    uint32_t index = 0;
+    std::shared_ptr<AVMemoryMock> data = nullptr;
+    while (!eosSent_ && PopInput(index, data)) {
+        UNITTEST_CHECK_AND_RETURN_RET_LOG(data != nullptr, progress, "input buffer is nullptr");
+        AVCodecBufferAttrMock attr;
+        const std::vector<uint8_t> *payload = nullptr;
+        if (!codecDataSent_ && !stream_->codecData.empty()) {
+            payload = &stream_->codecData;
+            attr.flags = AVCODEC_BUFFER_FLAG_CODEC_DATA;
+            codecDataSent_ = true;
+        } else if (inFrames_ < stream_->frames.size()) {
+            payload = &stream_->frames[inFrames_];
+            attr.pts = static_cast<int64_t>(inFrames_) * US_PER_SEC / config_.frameRate;
+            attr.flags = AVCODEC_BUFFER_FLAG_NONE;
+            inFrames_++;
+        } else {
+            attr.flags = AVCODEC_BUFFER_FLAG_EOS;
+            eosSent_ = true;
+        }
+        if (payload != nullptr) {
+            UNITTEST_CHECK_AND_RETURN_RET_LOG(data->GetSize() >= static_cast<int32_t>(payload->size()), progress,
+                "input buffer too small");
+            if (memcpy_s(data->GetAddr(), data->GetSize(), payload->data(), payload->size()) != EOK) {
+                signal_->hasError_.store(true);
+                return progress;
+            }
+            attr.size = static_cast<int32_t>(payload->size());
+        }
+        if (attr.flags == AVCODEC_BUFFER_FLAG_NONE) {
+            latency_.OnQueued();
+        }
+        apiCalls_++;
+        if (videoDec_->PushInputData(index, attr) != MSERR_OK) {
+            signal_->hasError_.store(true);
+            return progress;
+        }
+        progress = true;
+    }
+    return progress;
+}
+
+bool VDecBenchInstance::DrainOutput(uint32_t index, std::shared_ptr<AVMemoryMock> data,
+    const AVCodecBufferAttrMock &attr)
+{
+    (void)data;
+    if ((attr.flags & AVCODEC_BUFFER_FLAG_EOS) != 0) {
+        eos_ = true;
+        return true;
+    }
+    latency_.OnOutput();
+    outFrames_++;
+    apiCalls_++;
+    return videoDec_->RenderOutputData(index) == MSERR_OK;
+}
+
+VEncBenchInstance::VEncBenchInstance(uint32_t id, const VBenchConfig &config, std::shared_ptr<VBenchStream> capture)
+    : VBenchInstance(id, config), capture_(capture)
+{
+    codecName_ = config.encoderName;
+}
+
+VEncBenchInstance::~VEncBenchInstance()
+{
+    (void)Release();
+}
+
+int32_t VEncBenchInstance::Init()
+{
+    videoEnc_ = AVCodecMockFactory::CreateVideoEncMockByName(codecName_);
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(videoEnc_ != nullptr, MSERR_UNKNOWN, "create encoder failed");
+    int32_t ret = videoEnc_->SetCallback(callback_);
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "SetCallback failed");
+
+    std::shared_ptr<FormatMock> format = CreateFormat();
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(format != nullptr, MSERR_NO_MEMORY, "create format failed");
+    ret = videoEnc_->Configure(format);
+    format->Destroy();
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Configure failed");
+
+    surface_ = videoEnc_->GetInputSurface();
+    auto nativeSurface = std::static_pointer_cast<SurfaceNativeMock>(surface_);
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(nativeSurface != nullptr, MSERR_UNKNOWN, "GetInputSurface failed");
+    producerSurface_ = nativeSurface->GetSurface();
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(producerSurface_ != nullptr, MSERR_UNKNOWN, "no producer surface");
+    ret = videoEnc_->Prepare();
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(ret == MSERR_OK, ret, "Prepare failed");
+    return MSERR_OK;
+}
+
+int32_t VEncBenchInstance::Start()
+{
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(videoEnc_ != nullptr, MSERR_INVALID_OPERATION, "encoder not created");
+    return videoEnc_->Start();
+}
+
+int32_t VEncBenchInstance::Stop()
+{
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(videoEnc_ != nullptr, MSERR_INVALID_OPERATION, "encoder not created");
+    return videoEnc_->Stop();
+}
+
+int32_t VEncBenchInstance::Release()
+{
+    producerSurface_ = nullptr;
+    surface_ = nullptr;
+    if (videoEnc_ == nullptr) {
+        return MSERR_OK;
+    }
+    int32_t ret = videoEnc_->Release();
+    videoEnc_ = nullptr;
+    return ret;
+}
+
+bool VEncBenchInstance::HasPendingInput() const
+{
+    // the producer surface does not notify when the encoder hands a buffer back, so the loop polls it
+    return false;
+}
+
+void VEncBenchInstance::FillSyntheticFrame(uint8_t *addr, int32_t stride, uint32_t size) const
+{
+    // a diagonal gradient drifting a few pixels per frame keeps the encoder out of its all-skip fast path
+    uint32_t lumaSize = static_cast<uint32_t>(stride) * static_cast<uint32_t>(config_.height);
+    uint32_t shift = inFrames_ * PATTERN_STEP;
+    for (int32_t y = 0; y < config_.height; y++) {
+        uint8_t *line = addr + static_cast<uint32_t>(y) * static_cast<uint32_t>(stride);
+        for (int32_t x = 0; x < config_.width; x++) {
+            line[x] = static_cast<uint8_t>(static_cast<uint32_t>(x + y) + shift);
+        }
+    }
+    if (size > lumaSize) {
+        (void)memset_s(addr + lumaSize, size - lumaSize, CHROMA_NEUTRAL, size - lumaSize);
+    }
+}
+
+bool VEncBenchInstance::FeedInput()
+{
+    if (eosSent_) {
+        return false;
+    }
+    if (inFrames_ == config_.frameCount) {
+        eosSent_ = true;
+        apiCalls_++;
+        if (videoEnc_->NotifyEos() != MSERR_OK) {
+            signal_->hasError_.store(true);
+        }
+        return true;
+    }
+
+    BufferRequestConfig requestConfig = {
+        .width = config_.width,
+        .height = config_.height,
+        .strideAlignment = STRIDE_ALIGN,
+        .format = PIXEL_FMT_YCBCR_420_SP,
+        .usage = HBM_USE_CPU_READ | HBM_USE_CPU_WRITE | HBM_USE_MEM_DMA,
+        .timeout = 0
+    };
+    sptr<SurfaceBuffer> buffer = nullptr;
+    int32_t releaseFence = -1;
+    apiCalls_++;
+    SurfaceError ret = producerSurface_->RequestBuffer(buffer, releaseFence, requestConfig);
+    if (ret == SURFACE_ERROR_NO_BUFFER) {
+        return false;
+    }
+    if (ret != SURFACE_ERROR_OK || buffer == nullptr) {
+        cout << "VBench instance " << id_ << " RequestBuffer failed" << endl;
+        signal_->hasError_.store(true);
+        return false;
+    }
+    sptr<SyncFence> fence = new SyncFence(releaseFence);
+    (void)fence->Wait(FENCE_WAIT_MS);
+
+    auto addr = static_cast<uint8_t *>(buffer->GetVirAddr());
+    if (addr == nullptr) {
+        (void)producerSurface_->CancelBuffer(buffer);
+        signal_->hasError_.store(true);
+        return false;
+    }
+    FillSyntheticFrame(addr, buffer->GetStride(), buffer->GetSize());
+
+    int64_t ptsNs = static_cast<int64_t>(inFrames_) * US_PER_SEC * NS_PER_US / config_.frameRate;
+    (void)buffer->GetExtraData()->ExtraSet("dataSize", static_cast<int32_t>(buffer->GetSize()));
+    (void)buffer->GetExtraData()->ExtraSet("timeStamp", ptsNs);
+    (void)buffer->GetExtraData()->ExtraSet("isKeyFrame", static_cast<int32_t>(inFrames_ % KEY_FRAME_INTERVAL == 0));
+    BufferFlushConfig flushConfig = {
+        .damage = {
+            .x = 0,
+            .y = 0,
+            .w = config_.width,
+            .h = config_.height
+        },
+        .timestamp = ptsNs
+    };
+    latency_.OnQueued();
+    apiCalls_++;
+    if (producerSurface_->FlushBuffer(buffer, -1, flushConfig) != SURFACE_ERROR_OK) {
+        signal_->hasError_.store(true);
+        return false;
+    }
+    inFrames_++;
+    return true;
+}
+
+bool VEncBenchInstance::DrainOutput(uint32_t index, std::shared_ptr<AVMemoryMock> data,
+    const AVCodecBufferAttrMock &attr)
+{
+    bool isEos = (attr.flags & AVCODEC_BUFFER_FLAG_EOS) != 0;
+    bool isCodecData = (attr.flags & AVCODEC_BUFFER_FLAG_CODEC_DATA) != 0;
+    if (!isCodecData && attr.size > 0) {
+        latency_.OnOutput();
+        outFrames_++;
+    }
+    if (capture_ != nullptr && data != nullptr && attr.size > 0 &&
+        attr.offset >= 0 && attr.offset + attr.size <= data->GetSize()) {
+        const uint8_t *begin = data->GetAddr() + attr.offset;
+        if (isCodecData) {
+            capture_->codecData.assign(begin, begin + attr.size);
+        } else {
+            capture_->frames.emplace_back(begin, begin + attr.size);
+        }
+    }
+    apiCalls_++;
+    int32_t ret = videoEnc_->FreeOutputData(index);
+    if (isEos) {
+        eos_ = true;
+        return true;
+    }
+    return ret == MSERR_OK;
+}
+
+VBenchRunResult VBenchRunner::Run(const std::string &scenario, std::vector<std::shared_ptr<VBenchInstance>> &instances)
+{
+    VBenchRunResult run;
+    run.scenario = scenario;
+    run.instances = static_cast<uint32_t>(instances.size());
+    int64_t serviceRssBefore = GetServiceRssKb();
+
+    std::vector<std::shared_ptr<VBenchInstance>> ready;
+    for (auto &instance : instances) {
+        if (instance != nullptr && instance->Init() == MSERR_OK) {
+            ready.push_back(instance);
+        }
+    }
+    run.results.resize(ready.size());
+
+    int64_t ipcBefore = GetIpcTransactions();
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool go = false;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < ready.size(); i++) {
+        threads.emplace_back([&, i]() {
+            {
+                unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&go]() { return go; });
+            }
+            run.results[i] = ready[i]->Run();
+        });
+    }
+    {
+        lock_guard<std::mutex> lock(mutex);
+        go = true;
+    }
+    cond.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    run.ipcTransactions = GetIpcTransactions() - ipcBefore;
+
+    // sampled before the instances are released so the numbers reflect N live codecs
+    run.clientRssKb = GetRssKb("/proc/self/status");
+    run.serviceRssKb = GetServiceRssKb();
+    if (serviceRssBefore >= 0 && run.serviceRssKb >= 0) {
+        run.serviceRssDeltaKb = run.serviceRssKb - serviceRssBefore;
+    }
+    uint32_t frames = 0;
+    for (auto &result : run.results) {
+        run.totalFps += result.fps;
+        frames += result.frames;
+    }
+    if (frames > 0) {
+        run.ipcPerFrame = static_cast<double>(run.ipcTransactions) / frames;
+    }
+    return run;
+}
+
+int64_t VBenchRunner::GetRssKb(const std::string &statusPath)
+{
+    std::ifstream status(statusPath);
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, strlen("VmRSS:"), "VmRSS:") == 0) {
+            return std::strtoll(line.c_str() + strlen("VmRSS:"), nullptr, 10); // 10: decimal
+        }
+    }
+    return -1;
+}
+
+int64_t VBenchRunner::GetServiceRssKb()
+{
+    DIR *dir = opendir("/proc");
+    UNITTEST_CHECK_AND_RETURN_RET_LOG(dir != nullptr, -1, "open /proc failed");
+    int64_t rss = -1;
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string pid = entry->d_name;
+        if (pid.empty() || !std::all_of(pid.begin(), pid.end(), [](unsigned char c) { return std::isdigit(c) != 0; })) {
+            continue;
+        }
+        std::ifstream comm("/proc/" + pid + "/comm");
+        std::string name;
+        if (std::getline(comm, name) && name == SERVICE_PROCESS_NAME) {
+            rss = GetRssKb("/proc/" + pid + "/status");
+            break;
+        }
+    }
+    (void)closedir(dir);
+    return rss;
+}
+
+int64_t VBenchRunner::GetIpcTransactions()
+{
+    // process wide, so the transactions are only reported for the whole run
+    MediaMetrics &metrics = MediaMetrics::Inst();
+    return metrics.GetCounter(metrics.RegisterCounter("avcodec.ipc.request")) +
+        metrics.GetCounter(metrics.RegisterCounter("avcodec.ipc.notify"));
+}
+
+std::string VBenchRunner::ToJson(const std::vector<VBenchRunResult> &runs)
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    out << "{\"runs\":[";
+    for (size_t i = 0; i < runs.size(); i++) {
+        const VBenchRunResult &run = runs[i];
+        out << (i == 0 ? "" : ",") << "{\"scenario\":\"" << run.scenario << "\",\"instances\":" << run.instances
+            << ",\"total_fps\":" << run.totalFps << ",\"client_rss_kb\":" << run.clientRssKb
+            << ",\"service_rss_kb\":" << run.serviceRssKb << ",\"service_rss_delta_kb\":" << run.serviceRssDeltaKb
+            << ",\"ipc_transactions\":" << run.ipcTransactions << ",\"ipc_per_frame\":" << run.ipcPerFrame
+            << ",\"streams\":[";
+        for (size_t j = 0; j < run.results.size(); j++) {
+            const VBenchResult &result = run.results[j];
+            out << (j == 0 ? "" : ",") << "{\"id\":" << result.instanceId << ",\"codec\":\"" << result.codecName
+                << "\",\"completed\":" << (result.completed ? "true" : "false") << ",\"frames\":" << result.frames
+                << ",\"elapsed_us\":" << result.elapsedUs << ",\"fps\":" << result.fps
+                << ",\"latency_us\":{\"p50\":" << result.latencyP50Us << ",\"p90\":" << result.latencyP90Us
+                << ",\"p99\":" << result.latencyP99Us << ",\"max\":" << result.latencyMaxUs << "}"
+                << ",\"api_calls\":" << result.apiCalls << ",\"api_per_frame\":" << result.apiPerFrame << "}";
+        }
+        out << "]}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+std::string VBenchRunner::ToText(const std::vector<VBenchRunResult> &runs)
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    for (const VBenchRunResult &run : runs) {
+        out << run.scenario << " x" << run.instances << ": total " << run.totalFps << " fps, client rss "
+            << run.clientRssKb << " KB, service rss " << run.serviceRssKb << " KB (+" << run.serviceRssDeltaKb
+            << " KB), " << run.ipcPerFrame << " ipc/frame" << endl;
+        for (const VBenchResult &result : run.results) {
+            out << "  #" << result.instanceId << " " << result.codecName << (result.completed ? "" : " [incomplete]")
+                << ": " << result.frames << " frames, " << result.fps << " fps, latency p50/p90/p99/max "
+                << result.latencyP50Us << "/" << result.latencyP90Us << "/" << result.latencyP99Us << "/"
+                << result.latencyMaxUs << " us, " << result.apiPerFrame << " api/frame" << endl;
+        }
+    }
+    return out.str();
+}
+} // namespace Media
+} // namespace OHOS
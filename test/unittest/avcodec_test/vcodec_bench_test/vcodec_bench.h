@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VCODEC_BENCH_H
+#define VCODEC_BENCH_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+#include "avcodec_mock.h"
+#include "surface.h"
+#include "test_params_config.h"
+
+namespace OHOS {
+namespace Media {
+namespace VCodecBenchParam {
+constexpr uint32_t DEFAULT_FRAME_COUNT = 300;
+constexpr int64_t STALL_TIMEOUT_MS = 5000;
+const std::string DECODER_NAME = "avdec_mpeg4";
+const std::string ENCODER_NAME = "avenc_mpeg4";
+} // namespace VCodecBenchParam
+
+struct VBenchConfig {
+    std::string decoderName = VCodecBenchParam::DECODER_NAME;
+    std::string encoderName = VCodecBenchParam::ENCODER_NAME;
+    int32_t width = VCodecTestParam::DEFAULT_WIDTH;
+    int32_t height = VCodecTestParam::DEFAULT_HEIGHT;
+    int32_t frameRate = VCodecTestParam::DEFAULT_FRAME_RATE;
+    uint32_t frameCount = VCodecBenchParam::DEFAULT_FRAME_COUNT;
+};
+
+// elementary stream produced locally by the software encoder, replayed by the decoder instances
+struct VBenchStream {
+    std::vector<uint8_t> codecData;
+    std::vector<std::vector<uint8_t>> frames;
+};
+
+struct VBenchResult {
+    uint32_t instanceId = 0;
+    std::string codecName;
+    bool completed = false;
+    uint32_t frames = 0;
+    int64_t elapsedUs = 0;
+    double fps = 0.0;
+    int64_t latencyP50Us = 0;
+    int64_t latencyP90Us = 0;
+    int64_t latencyP99Us = 0;
+    int64_t latencyMaxUs = 0;
+    // the codec API calls made by the instance and the callbacks it received
+    uint64_t apiCalls = 0;
+    double apiPerFrame = 0.0;
+};
+
+struct VBenchRunResult {
+    std::string scenario;
+    uint32_t instances = 0;
+    double totalFps = 0.0;
+    int64_t clientRssKb = 0;
+    int64_t serviceRssKb = 0;
+    int64_t serviceRssDeltaKb = 0;
+    // the binder transactions between this process and the service, counted by the avcodec ipc layer
+    int64_t ipcTransactions = 0;
+    double ipcPerFrame = 0.0;
+    std::vector<VBenchResult> results;
+};
+
+struct VBenchSignal {
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::queue<uint32_t> inIndexQueue_;
+    std::queue<std::shared_ptr<AVMemoryMock>> inBufferQueue_;
+    std::queue<uint32_t> outIndexQueue_;
+    std::queue<std::shared_ptr<AVMemoryMock>> outBufferQueue_;
+    std::queue<AVCodecBufferAttrMock> outAttrQueue_;
+    std::atomic<bool> isRunning_ = false;
+    std::atomic<bool> hasError_ = false;
+    std::atomic<uint64_t> callbacks_ = 0;
+};
+
+class VBenchCallback : public AVCodecCallbackMock {
+public:
+    explicit VBenchCallback(std::shared_ptr<VBenchSignal> signal) : signal_(signal) {}
+    ~VBenchCallback() = default;
+    void OnError(int32_t errorCode) override;
+    void OnStreamChanged(std::shared_ptr<FormatMock> format) override;
+    void OnNeedInputData(uint32_t index, std::shared_ptr<AVMemoryMock> data) override;
+    void OnNewOutputData(uint32_t index, std::shared_ptr<AVMemoryMock> data, AVCodecBufferAttrMock attr) override;
+private:
+    std::shared_ptr<VBenchSignal> signal_;
+};
+
+// queue-in to output-available latency, matched in decode order
+class VBenchLatency {
+public:
+    void OnQueued();
+    void OnOutput();
+    void Fill(VBenchResult &result);
+private:
+    std::queue<int64_t> queued_;
+    std::vector<int64_t> samples_;
+};
+
+class VBenchInstance : public NoCopyable {
+public:
+    VBenchInstance(uint32_t id, const VBenchConfig &config);
+    virtual ~VBenchInstance();
+    virtual int32_t Init() = 0;
+    // drives the codec from the calling thread until EOS comes out or the codec stalls
+    VBenchResult Run();
+    static int64_t GetNowUs();
+
+protected:
+    std::shared_ptr<FormatMock> CreateFormat() const;
+    virtual int32_t Start() = 0;
+    virtual int32_t Stop() = 0;
+    virtual int32_t Release() = 0;
+    virtual bool FeedInput() = 0;
+    virtual bool DrainOutput(uint32_t index, std::shared_ptr<AVMemoryMock> data, const AVCodecBufferAttrMock &attr) = 0;
+    virtual bool HasPendingInput() const = 0;
+    bool PopInput(uint32_t &index, std::shared_ptr<AVMemoryMock> &data);
+    uint32_t id_;
+    VBenchConfig config_;
+    std::string codecName_;
+    std::shared_ptr<VBenchSignal> signal_;
+    std::shared_ptr<VBenchCallback> callback_;
+    VBenchLatency latency_;
+    uint64_t apiCalls_ = 0;
+    uint32_t outFrames_ = 0;
+    bool eos_ = false;
+};
+
+class VDecBenchInstance : public VBenchInstance {
+public:
+    VDecBenchInstance(uint32_t id, const VBenchConfig &config, std::shared_ptr<const VBenchStream> stream);
+    ~VDecBenchInstance() override;
+    int32_t Init() override;
+
+protected:
+    int32_t Start() override;
+    int32_t Stop() override;
+    int32_t Release() override;
+    bool FeedInput() override;
+    bool DrainOutput(uint32_t index, std::shared_ptr<AVMemoryMock> data, const AVCodecBufferAttrMock &attr) override;
+    bool HasPendingInput() const override;
+
+private:
+    std::shared_ptr<VideoDecMock> videoDec_ = nullptr;
+    std::shared_ptr<SurfaceMock> surface_ = nullptr;
+    std::shared_ptr<const VBenchStream> stream_;
+    bool codecDataSent_ = false;
+    uint32_t inFrames_ = 0;
+    bool eosSent_ = false;
+};
+
+class VEncBenchInstance : public VBenchInstance {
+public:
+    VEncBenchInstance(uint32_t id, const VBenchConfig &config, std::shared_ptr<VBenchStream> capture = nullptr);
+    ~VEncBenchInstance() override;
+    int32_t Init() override;
+
+protected:
+    int32_t Start() override;
+    int32_t Stop() override;
+    int32_t Release() override;
+    bool FeedInput() override;
+    bool DrainOutput(uint32_t index, std::shared_ptr<AVMemoryMock> data, const AVCodecBufferAttrMock &attr) override;
+    bool HasPendingInput() const override;
+
+private:
+    void FillSyntheticFrame(uint8_t *addr, int32_t stride, uint32_t size) const;
+    std::shared_ptr<VideoEncMock> videoEnc_ = nullptr;
+    std::shared_ptr<SurfaceMock> surface_ = nullptr;
+    sptr<Surface> producerSurface_ = nullptr;
+    std::shared_ptr<VBenchStream> capture_;
+    uint32_t inFrames_ = 0;
+    bool eosSent_ = false;
+};
+
+class VBenchRunner {
+public:
+    // runs every instance on its own thread, all released at the same moment
+    static VBenchRunResult Run(const std::string &scenario, std::vector<std::shared_ptr<VBenchInstance>> &instances);
+    static std::string ToJson(const std::vector<VBenchRunResult> &runs);
+    static std::string ToText(const std::vector<VBenchRunResult> &runs);
+    static int64_t GetRssKb(const std::string &statusPath);
+    static int64_t GetServiceRssKb();
+    static int64_t GetIpcTransactions();
+};
+} // namespace Media
+} // namespace OHOS
+#endif // VCODEC_BENCH_H
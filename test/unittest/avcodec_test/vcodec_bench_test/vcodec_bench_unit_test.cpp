@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vcodec_bench_unit_test.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "media_errors.h"
+
+using namespace std;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace testing::ext;
+
+namespace {
+    // environment knobs, so one binary covers both the CI smoke run and the capacity sweep
+    constexpr const char *ENV_INSTANCES = "VCODEC_BENCH_INSTANCES"; // e.g. "1,2,4,8"
+    constexpr const char *ENV_FRAMES = "VCODEC_BENCH_FRAMES";
+    constexpr const char *ENV_JSON = "VCODEC_BENCH_JSON"; // output path, "-" for stdout
+    const std::vector<uint32_t> DEFAULT_INSTANCE_COUNTS = { 1, 2, 4 };
+    constexpr uint32_t MAX_INSTANCE_COUNT = 64;
+
+    std::vector<uint32_t> ParseInstanceCounts(const char *value)
+    {
+        std::vector<uint32_t> counts;
+        if (value == nullptr) {
+            return DEFAULT_INSTANCE_COUNTS;
+        }
+        std::istringstream in(value);
+        std::string item;
+        while (std::getline(in, item, ',')) {
+            unsigned long count = std::strtoul(item.c_str(), nullptr, 10); // 10: decimal
+            if (count > 0 && count <= MAX_INSTANCE_COUNT) {
+                counts.push_back(static_cast<uint32_t>(count));
+            }
+        }
+        return counts.empty() ? DEFAULT_INSTANCE_COUNTS : counts;
+    }
+
+    std::vector<std::shared_ptr<VBenchInstance>> CreateDecoders(uint32_t count, const VBenchConfig &config,
+        std::shared_ptr<const VBenchStream> stream)
+    {
+        std::vector<std::shared_ptr<VBenchInstance>> instances;
+        for (uint32_t i = 0; i < count; i++) {
+            instances.push_back(std::make_shared<VDecBenchInstance>(i, config, stream));
+        }
+        return instances;
+    }
+
+    std::vector<std::shared_ptr<VBenchInstance>> CreateEncoders(uint32_t count, const VBenchConfig &config)
+    {
+        std::vector<std::shared_ptr<VBenchInstance>> instances;
+        for (uint32_t i = 0; i < count; i++) {
+            instances.push_back(std::make_shared<VEncBenchInstance>(i, config));
+        }
+        return instances;
+    }
+}
+
+VBenchConfig VCodecBenchUnitTest::config_;
+std::vector<uint32_t> VCodecBenchUnitTest::instanceCounts_;
+std::shared_ptr<VBenchStream> VCodecBenchUnitTest::stream_ = nullptr;
+std::vector<VBenchRunResult> VCodecBenchUnitTest::runs_;
+
+void VCodecBenchUnitTest::SetUpTestCase(void)
+{
+    instanceCounts_ = ParseInstanceCounts(getenv(ENV_INSTANCES));
+    const char *frames = getenv(ENV_FRAMES);
+    if (frames != nullptr && std::strtoul(frames, nullptr, 10) > 0) { // 10: decimal
+        config_.frameCount = static_cast<uint32_t>(std::strtoul(frames, nullptr, 10)); // 10: decimal
+    }
+}
+
+void VCodecBenchUnitTest::TearDownTestCase(void)
+{
+    const char *jsonPath = getenv(ENV_JSON);
+    if (jsonPath == nullptr) {
+        cout << VBenchRunner::ToText(runs_);
+    } else if (std::string(jsonPath) == "-") {
+        cout << VBenchRunner::ToJson(runs_) << endl;
+    } else {
+        std::ofstream out(jsonPath, std::ios::trunc);
+        out << VBenchRunner::ToJson(runs_) << endl;
+        cout << "vcodec bench report written to " << jsonPath << endl;
+    }
+    runs_.clear();
+    stream_ = nullptr;
+}
+
+void VCodecBenchUnitTest::SetUp(void) {}
+
+void VCodecBenchUnitTest::TearDown(void) {}
+
+std::shared_ptr<const VBenchStream> VCodecBenchUnitTest::GetStream()
+{
+    if (stream_ == nullptr || stream_->frames.empty()) {
+        // one encoder pass over the synthetic pattern gives every decoder instance the same bitstream
+        stream_ = std::make_shared<VBenchStream>();
+        std::vector<std::shared_ptr<VBenchInstance>> generator = {
+            std::make_shared<VEncBenchInstance>(0, config_, stream_)
+        };
+        VBenchRunResult run = VBenchRunner::Run("generate", generator);
+        if (run.results.empty() || !run.results[0].completed) {
+            stream_->frames.clear();
+        }
+    }
+    return stream_;
+}
+
+/**
+ * @tc.name: vcodec_bench_stream_0100
+ * @tc.desc: generate the synthetic bitstream with the software encoder
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(VCodecBenchUnitTest, vcodec_bench_stream_0100, TestSize.Level1)
+{
+    std::shared_ptr<const VBenchStream> stream = GetStream();
+    ASSERT_NE(nullptr, stream);
+    EXPECT_FALSE(stream->frames.empty());
+}
+
+/**
+ * @tc.name: vcodec_bench_decoder_0100
+ * @tc.desc: run N concurrent software video decoders over the synthetic bitstream
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(VCodecBenchUnitTest, vcodec_bench_decoder_0100, TestSize.Level1)
+{
+    std::shared_ptr<const VBenchStream> stream = GetStream();
+    ASSERT_NE(nullptr, stream);
+    ASSERT_FALSE(stream->frames.empty());
+    for (uint32_t count : instanceCounts_) {
+        std::vector<std::shared_ptr<VBenchInstance>> instances = CreateDecoders(count, config_, stream);
+        VBenchRunResult run = VBenchRunner::Run("decoder", instances);
+        EXPECT_EQ(count, run.results.size());
+        for (const VBenchResult &result : run.results) {
+            EXPECT_TRUE(result.completed) << "decoder instance " << result.instanceId << " of " << count;
+        }
+        runs_.push_back(run);
+    }
+}
+
+/**
+ * @tc.name: vcodec_bench_encoder_0100
+ * @tc.desc: run N concurrent software video encoders over synthetic surface frames
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(VCodecBenchUnitTest, vcodec_bench_encoder_0100, TestSize.Level1)
+{
+    for (uint32_t count : instanceCounts_) {
+        std::vector<std::shared_ptr<VBenchInstance>> instances = CreateEncoders(count, config_);
+        VBenchRunResult run = VBenchRunner::Run("encoder", instances);
+        EXPECT_EQ(count, run.results.size());
+        for (const VBenchResult &result : run.results) {
+            EXPECT_TRUE(result.completed) << "encoder instance " << result.instanceId << " of " << count;
+            EXPECT_GT(result.frames, 0u);
+        }
+        runs_.push_back(run);
+    }
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VCODEC_BENCH_UNIT_TEST_H
+#define VCODEC_BENCH_UNIT_TEST_H
+
+#include "gtest/gtest.h"
+#include "vcodec_bench.h"
+
+namespace OHOS {
+namespace Media {
+class VCodecBenchUnitTest : public testing::Test {
+public:
+    // SetUpTestCase: Called before all test cases
+    static void SetUpTestCase(void);
+    // TearDownTestCase: Called after all test case, prints or writes the collected report
+    static void TearDownTestCase(void);
+    // SetUp: Called before each test cases
+    void SetUp(void);
+    // TearDown: Called after each test cases
+    void TearDown(void);
+
+protected:
+    static std::shared_ptr<const VBenchStream> GetStream();
+    static VBenchConfig config_;
+    static std::vector<uint32_t> instanceCounts_;
+    static std::shared_ptr<VBenchStream> stream_;
+    static std::vector<VBenchRunResult> runs_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // VCODEC_BENCH_UNIT_TEST_H
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETA_HEADER_PARSER_UNIT_TEST_H
+#define AVMETA_HEADER_PARSER_UNIT_TEST_H
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "avmeta_header_parser.h"
+
+namespace OHOS {
+namespace Media {
+class AVMetaHeaderParserUnitTest : public testing::Test {
+public:
+    // SetUpTestCase: Called before all test cases
+    static void SetUpTestCase(void);
+    // TearDownTestCase: Called after all test case
+    static void TearDownTestCase(void);
+    // SetUp: Called before each test cases
+    void SetUp(void);
+    // TearDown: Called after each test cases
+    void TearDown(void);
+
+protected:
+    /**
+     * Write the data behind the prefix into the test file, and parse the data part of it.
+     */
+    int32_t Parse(const std::vector<uint8_t> &data, Metadata &meta, size_t prefixSize = 0);
+    int32_t Parse(const std::vector<uint8_t> &data);
+    /**
+     * Parse every truncated or corrupted copy of the data, it is either resolved or rejected.
+     */
+    void ParseDamaged(const std::vector<uint8_t> &data);
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMETA_HEADER_PARSER_UNIT_TEST_H
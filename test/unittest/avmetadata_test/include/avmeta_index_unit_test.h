@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AVMETA_INDEX_UNIT_TEST_H
+#define AVMETA_INDEX_UNIT_TEST_H
+
+#include "gtest/gtest.h"
+#include "avmeta_index.h"
+
+namespace OHOS {
+namespace Media {
+class AVMetaIndexUnitTest : public testing::Test {
+public:
+    // SetUpTestCase: Called before all test cases
+    static void SetUpTestCase(void);
+    // TearDownTestCase: Called after all test case
+    static void TearDownTestCase(void);
+    // SetUp: Called before each test cases
+    void SetUp(void);
+    // TearDown: Called after each test cases
+    void TearDown(void);
+
+protected:
+    void OpenIndex(uint64_t maxFileSize, uint64_t minCompactSize);
+    void CloseIndex();
+    int64_t GetFileSize(const std::string &path) const;
+    static AVMetaIndexKey MakeKey(uint32_t id);
+    static std::unordered_map<int32_t, std::string> MakeMeta(uint32_t id, char fill);
+    void ExpectMeta(uint32_t id, char fill);
+
+    std::unique_ptr<AVMetaIndex> index_ = nullptr;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // AVMETA_INDEX_UNIT_TEST_H
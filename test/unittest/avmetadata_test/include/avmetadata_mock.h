@@ -16,8 +16,11 @@
 #ifndef AVMETADATA_MOCK_H
 #define AVMETADATA_MOCK_H
 
+#include <condition_variable>
+#include <mutex>
 #include "securec.h"
 #include "jpeglib.h"
+#include "media_errors.h"
 #include "test_params_config.h"
 #include "unittest_log.h"
 
@@ -36,6 +39,28 @@ static const unsigned char R_INDEX = 2;
 static const unsigned char G_INDEX = 1;
 static const unsigned char B_INDEX = 0;
 
+class AVMetadataBatchCallbackMock : public AVMetadataBatchCallback, public NoCopyable {
+public:
+    AVMetadataBatchCallbackMock() = default;
+    ~AVMetadataBatchCallbackMock() = default;
+    void OnResult(int32_t index, int32_t errCode, const std::unordered_map<int32_t, std::string> &metadata,
+        const std::shared_ptr<PixelMap> &thumbnail) override;
+    void OnFinished(int32_t errCode) override;
+    bool WaitFinished(int32_t timeoutMs);
+
+    struct Result {
+        int32_t errCode;
+        std::unordered_map<int32_t, std::string> metadata;
+        std::shared_ptr<PixelMap> thumbnail;
+    };
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::unordered_map<int32_t, Result> results_;
+    int32_t duplicatedResults_ = 0;
+    int32_t finishedCount_ = 0;
+    int32_t finishedErrCode_ = MSERR_OK;
+};
+
 class AVMetadataMock : public NoCopyable {
 public:
     std::shared_ptr<OHOS::Media::AVMetadataHelper> avMetadataHelper_ = nullptr;
@@ -49,6 +74,11 @@ public:
     std::string ResolveMetadata(int32_t key);
     std::unordered_map<int32_t, std::string> ResolveMetadata();
     std::shared_ptr<PixelMap> FetchFrameAtTime(int64_t timeUs, int32_t option, PixelMapParams param);
+    int32_t FetchFramesAtTimes(const std::vector<int64_t> &timesUs, int32_t option, PixelMapParams param,
+        const FrameFetchedCallback &callback);
+    int32_t ResolveMetadataBatch(const std::vector<std::string> &paths, const AVMetadataBatchParams &params,
+        const std::shared_ptr<AVMetadataBatchCallback> &callback);
+    int32_t CancelBatch();
     std::shared_ptr<AVSharedMemory> FetchArtPicture();
     void Release();
     void FrameToFile(std::shared_ptr<PixelMap> frame, const char *fileName, int64_t timeUs, int32_t queryOption);
@@ -0,0 +1,833 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmeta_header_parser_unit_test.h"
+#include <cstring>
+#include <fcntl.h>
+#include <initializer_list>
+#include <unistd.h>
+#include "avmetadatahelper.h"
+#include "gst_meta_parser.h"
+#include "media_errors.h"
+
+using namespace std;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace testing::ext;
+
+namespace {
+    using Bytes = std::vector<uint8_t>;
+    const std::string TEST_FILE_PATH = "/data/test/avmeta_header_parser_unit_test";
+    constexpr size_t PREFIX_SIZE = 100;
+    constexpr uint8_t PREFIX_BYTE = 0x5A;
+    // every truncation below it is parsed, and every byte below the half of it is corrupted
+    constexpr size_t MAX_DAMAGE_POS = 1024;
+    constexpr uint8_t CORRUPT_MASK = 0xFF;
+
+    constexpr uint32_t MP4_TIMESCALE = 1000;
+    constexpr uint32_t MP4_DURATION = 5000;
+    constexpr uint16_t MP4_WIDTH = 1280;
+    constexpr uint16_t MP4_HEIGHT = 720;
+    constexpr uint32_t MP4_SAMPLE_RATE = 44100;
+    constexpr size_t MP4_VISUAL_ENTRY_SIZE = 78;
+    constexpr size_t MP4_AUDIO_ENTRY_SIZE = 28;
+    constexpr size_t MP4_ENTRY_WIDTH_POS = 24;
+    constexpr size_t MP4_ENTRY_RATE_POS = 24;
+
+    // mpeg1 layer 3, 128kbps, 44100Hz, stereo: 1152 samples and 417 bytes per frame
+    constexpr uint8_t MP3_FRAME_HEADER[] = { 0xFF, 0xFB, 0x90, 0x00 };
+    constexpr size_t MP3_FRAME_SIZE = 417;
+    constexpr size_t MP3_XING_POS = 36;
+    constexpr uint32_t MP3_XING_FRAMES = 100;
+    constexpr uint32_t MP3_CBR_FRAMES = 10;
+    constexpr size_t ID3V1_SIZE = 128;
+
+    // mpeg4 aac lc, 44100Hz, stereo, 100 bytes and 1024 samples per frame
+    constexpr uint8_t ADTS_FRAME_HEADER[] = { 0xFF, 0xF1, 0x50, 0x80, 0x0C, 0x9F, 0xFC };
+    constexpr size_t ADTS_FRAME_SIZE = 100;
+    constexpr uint32_t ADTS_FRAMES = 86;
+
+    // 48000Hz, stereo, 16 bits, 144000 samples
+    constexpr uint8_t FLAC_STREAMINFO[] = {
+        0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x0B, 0xB8, 0x02, 0xF0, 0x00, 0x02, 0x32, 0x80,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+    // after "fLaC" and the block header
+    constexpr size_t FLAC_STREAMINFO_POS = 8;
+    constexpr size_t FLAC_RATE_POS = 10;
+    constexpr size_t FLAC_FRAMES_SIZE = 64;
+
+    constexpr uint32_t WAV_SAMPLE_RATE = 8000;
+    constexpr uint32_t WAV_BYTE_RATE = 32000;
+    constexpr uint32_t WAV_DATA_SIZE = 16000;
+
+    constexpr uint32_t EBML_ID_HEADER = 0x1A45DFA3;
+    constexpr uint32_t EBML_ID_DOCTYPE = 0x4282;
+    constexpr uint32_t MKV_ID_SEGMENT = 0x18538067;
+    constexpr uint32_t MKV_ID_SEEKHEAD = 0x114D9B74;
+    constexpr uint32_t MKV_ID_SEEK = 0x4DBB;
+    constexpr uint32_t MKV_ID_SEEKID = 0x53AB;
+    constexpr uint32_t MKV_ID_SEEKPOSITION = 0x53AC;
+    constexpr uint32_t MKV_ID_INFO = 0x1549A966;
+    constexpr uint32_t MKV_ID_TIMECODESCALE = 0x2AD7B1;
+    constexpr uint32_t MKV_ID_DURATION = 0x4489;
+    constexpr uint32_t MKV_ID_TITLE = 0x7BA9;
+    constexpr uint32_t MKV_ID_TRACKS = 0x1654AE6B;
+    constexpr uint32_t MKV_ID_TRACKENTRY = 0xAE;
+    constexpr uint32_t MKV_ID_TRACKTYPE = 0x83;
+    constexpr uint32_t MKV_ID_NAME = 0x536E;
+    constexpr uint32_t MKV_ID_VIDEO = 0xE0;
+    constexpr uint32_t MKV_ID_PIXELWIDTH = 0xB0;
+    constexpr uint32_t MKV_ID_PIXELHEIGHT = 0xBA;
+    constexpr uint32_t MKV_ID_AUDIO = 0xE1;
+    constexpr uint32_t MKV_ID_SAMPLINGFREQUENCY = 0xB5;
+    constexpr uint32_t MKV_ID_CLUSTER = 0x1F43B675;
+    constexpr uint32_t MKV_ID_TIMECODE = 0xE7;
+    constexpr uint64_t MKV_TIMECODESCALE = 1000000;
+    constexpr float MKV_DURATION = 2500.0f;
+    constexpr uint64_t MKV_WIDTH = 640;
+    constexpr uint64_t MKV_HEIGHT = 480;
+    constexpr float MKV_SAMPLE_RATE = 48000.0f;
+    constexpr uint64_t MKV_TRACK_TYPE_VIDEO = 1;
+    constexpr uint64_t MKV_TRACK_TYPE_AUDIO = 2;
+    constexpr size_t MKV_UINT_SIZE = 2;
+    constexpr size_t MKV_SEEK_POSITION_SIZE = 8;
+}
+
+static void PutU8(Bytes &out, uint32_t value)
+{
+    out.push_back(static_cast<uint8_t>(value & 0xFF));
+}
+
+static void PutBE(Bytes &out, uint64_t value, size_t size)
+{
+    for (size_t i = size; i > 0; i--) {
+        PutU8(out, static_cast<uint32_t>(value >> ((i - 1) * 8))); // 8: bits of byte
+    }
+}
+
+static void PutLE(Bytes &out, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        PutU8(out, static_cast<uint32_t>(value >> (i * 8))); // 8: bits of byte
+    }
+}
+
+static void PutU16BE(Bytes &out, uint32_t value)
+{
+    PutBE(out, value, sizeof(uint16_t));
+}
+
+static void PutU32BE(Bytes &out, uint32_t value)
+{
+    PutBE(out, value, sizeof(uint32_t));
+}
+
+static void PutU16LE(Bytes &out, uint32_t value)
+{
+    PutLE(out, value, sizeof(uint16_t));
+}
+
+static void PutU32LE(Bytes &out, uint32_t value)
+{
+    PutLE(out, value, sizeof(uint32_t));
+}
+
+static void PutStr(Bytes &out, const std::string &str)
+{
+    out.insert(out.end(), str.begin(), str.end());
+}
+
+static void PutZeros(Bytes &out, size_t size)
+{
+    out.insert(out.end(), size, 0);
+}
+
+static Bytes Concat(std::initializer_list<Bytes> parts)
+{
+    Bytes out;
+    for (auto &part : parts) {
+        out.insert(out.end(), part.begin(), part.end());
+    }
+    return out;
+}
+
+/**
+ * MP4: ftyp, moov with a rotated video track, an audio track and the ilst tags, and mdat.
+ */
+static Bytes Mp4Box(const std::string &type, const Bytes &payload)
+{
+    static constexpr size_t boxHeaderSize = 8;
+    Bytes box;
+    PutU32BE(box, static_cast<uint32_t>(payload.size() + boxHeaderSize));
+    PutStr(box, type);
+    return Concat({ box, payload });
+}
+
+static Bytes MakeMp4Tkhd(bool rotate90)
+{
+    static constexpr size_t matrixPos = 40;
+    static constexpr uint32_t one = 0x10000;
+    static constexpr uint32_t minusOne = 0xFFFF0000;
+    static constexpr uint32_t w = 0x40000000;
+    static constexpr size_t trackSize = 8;
+    Bytes tkhd;
+    PutZeros(tkhd, matrixPos);
+    // a, b, u, c, d, v, x, y, w
+    for (uint32_t value : { rotate90 ? 0 : one, rotate90 ? one : 0, 0U, rotate90 ? minusOne : 0, rotate90 ? 0 : one,
+        0U, 0U, 0U, w }) {
+        PutU32BE(tkhd, value);
+    }
+    PutZeros(tkhd, trackSize);
+    return Mp4Box("tkhd", tkhd);
+}
+
+static Bytes MakeMp4Hdlr(const std::string &handler)
+{
+    static constexpr size_t preDefinedSize = 8;
+    static constexpr size_t reservedSize = 13;
+    Bytes hdlr;
+    PutZeros(hdlr, preDefinedSize);
+    PutStr(hdlr, handler);
+    PutZeros(hdlr, reservedSize);
+    return Mp4Box("hdlr", hdlr);
+}
+
+static Bytes MakeMp4Trak(const std::string &handler, const std::string &format, const Bytes &sampleEntry,
+    bool rotate90)
+{
+    Bytes stsd;
+    PutU32BE(stsd, 0);
+    PutU32BE(stsd, 1);
+    stsd = Concat({ stsd, Mp4Box(format, sampleEntry) });
+    Bytes minf = Mp4Box("minf", Mp4Box("stbl", Mp4Box("stsd", stsd)));
+    return Mp4Box("trak", Concat({ MakeMp4Tkhd(rotate90), Mp4Box("mdia", Concat({ MakeMp4Hdlr(handler), minf })) }));
+}
+
+static Bytes MakeMp4Tag(const std::string &type, const std::string &value)
+{
+    static constexpr uint32_t utf8Type = 1;
+    Bytes data;
+    PutU32BE(data, utf8Type);
+    PutU32BE(data, 0);
+    PutStr(data, value);
+    return Mp4Box(type, Mp4Box("data", data));
+}
+
+static Bytes MakeMp4Ftyp()
+{
+    Bytes ftyp;
+    PutStr(ftyp, "isom");
+    PutU32BE(ftyp, 0);
+    PutStr(ftyp, "isom");
+    return Mp4Box("ftyp", ftyp);
+}
+
+static Bytes MakeMp4(const Bytes &moovExtra = {}, const Bytes &ilstExtra = {})
+{
+    static constexpr size_t mvhdTimescalePos = 12;
+    static constexpr size_t mvhdTailSize = 80;
+    static constexpr size_t mdatSize = 16;
+    Bytes mvhd;
+    PutZeros(mvhd, mvhdTimescalePos);
+    PutU32BE(mvhd, MP4_TIMESCALE);
+    PutU32BE(mvhd, MP4_DURATION);
+    PutZeros(mvhd, mvhdTailSize);
+
+    Bytes visual(MP4_VISUAL_ENTRY_SIZE, 0);
+    Bytes size;
+    PutU16BE(size, MP4_WIDTH);
+    PutU16BE(size, MP4_HEIGHT);
+    std::copy(size.begin(), size.end(), visual.begin() + MP4_ENTRY_WIDTH_POS);
+
+    Bytes audio(MP4_AUDIO_ENTRY_SIZE, 0);
+    Bytes rate;
+    PutU32BE(rate, MP4_SAMPLE_RATE << 16); // 16: the 16.16 fixed point
+    std::copy(rate.begin(), rate.end(), audio.begin() + MP4_ENTRY_RATE_POS);
+
+    Bytes ilst = Concat({ MakeMp4Tag("\251nam", "Mp4 Title"), MakeMp4Tag("\251ART", "Mp4 Artist"),
+        MakeMp4Tag("\251day", "2022-01-02T03:04:05Z"), ilstExtra });
+    Bytes meta;
+    PutU32BE(meta, 0);
+    meta = Concat({ meta, MakeMp4Hdlr("mdir"), Mp4Box("ilst", ilst) });
+
+    Bytes moov = Concat({ Mp4Box("mvhd", mvhd), MakeMp4Trak("vide", "avc1", visual, true),
+        MakeMp4Trak("soun", "mp4a", audio, false), Mp4Box("udta", Mp4Box("meta", meta)), moovExtra });
+    return Concat({ MakeMp4Ftyp(), Mp4Box("moov", moov), Mp4Box("mdat", Bytes(mdatSize, 0)) });
+}
+
+/**
+ * MP3 and ADTS, with the id3v2.3 tag.
+ */
+static Bytes MakeId3Frame(const std::string &id, const std::string &text)
+{
+    Bytes frame;
+    PutStr(frame, id);
+    PutU32BE(frame, static_cast<uint32_t>(text.size() + 1));
+    PutU16BE(frame, 0);
+    PutU8(frame, 0); // latin1
+    PutStr(frame, text);
+    return frame;
+}
+
+static Bytes MakeId3(const Bytes &frames, uint8_t flags = 0)
+{
+    static constexpr uint32_t version = 3;
+    Bytes tag;
+    PutStr(tag, "ID3");
+    PutU8(tag, version);
+    PutU8(tag, 0);
+    PutU8(tag, flags);
+    uint32_t size = static_cast<uint32_t>(frames.size());
+    for (uint32_t shift : { 21U, 14U, 7U, 0U }) { // 21, 14, 7: 7 bits per byte
+        PutU8(tag, (size >> shift) & 0x7F);
+    }
+    return Concat({ tag, frames });
+}
+
+static Bytes MakeId3Frames()
+{
+    return Concat({ MakeId3Frame("TIT2", "Mp3 Title"), MakeId3Frame("TPE1", "Mp3 Artist"),
+        MakeId3Frame("TALB", "Mp3 Album"), MakeId3Frame("TYER", "2021"), MakeId3Frame("TDAT", "0203"),
+        MakeId3Frame("TIME", "1112") });
+}
+
+static Bytes MakeMp3Frames(uint32_t count, bool xing)
+{
+    Bytes frames;
+    for (uint32_t i = 0; i < count; i++) {
+        Bytes frame(MP3_FRAME_SIZE, 0);
+        std::copy(std::begin(MP3_FRAME_HEADER), std::end(MP3_FRAME_HEADER), frame.begin());
+        if (i == 0 && xing) {
+            static constexpr uint32_t framesFlag = 0x1;
+            Bytes header;
+            PutStr(header, "Xing");
+            PutU32BE(header, framesFlag);
+            PutU32BE(header, MP3_XING_FRAMES);
+            std::copy(header.begin(), header.end(), frame.begin() + MP3_XING_POS);
+        }
+        frames = Concat({ frames, frame });
+    }
+    return frames;
+}
+
+static Bytes MakeMp3()
+{
+    return Concat({ MakeId3(MakeId3Frames()), MakeMp3Frames(2, true) }); // 2: the second frame confirms the sync
+}
+
+static Bytes MakeAdts()
+{
+    Bytes frames;
+    for (uint32_t i = 0; i < ADTS_FRAMES; i++) {
+        Bytes frame(ADTS_FRAME_SIZE, 0);
+        std::copy(std::begin(ADTS_FRAME_HEADER), std::end(ADTS_FRAME_HEADER), frame.begin());
+        frames = Concat({ frames, frame });
+    }
+    return frames;
+}
+
+/**
+ * FLAC: STREAMINFO and VORBIS_COMMENT.
+ */
+static Bytes MakeFlac(const Bytes &streamInfo = Bytes(std::begin(FLAC_STREAMINFO), std::end(FLAC_STREAMINFO)))
+{
+    static constexpr uint8_t typeVorbisComment = 4;
+    static constexpr uint8_t lastFlag = 0x80;
+    Bytes comment;
+    std::string vendor = "unit test";
+    PutU32LE(comment, static_cast<uint32_t>(vendor.size()));
+    PutStr(comment, vendor);
+    std::vector<std::string> items = { "TITLE=Flac Title", "artist=Flac Artist", "DATE=2020" };
+    PutU32LE(comment, static_cast<uint32_t>(items.size()));
+    for (auto &item : items) {
+        PutU32LE(comment, static_cast<uint32_t>(item.size()));
+        PutStr(comment, item);
+    }
+
+    Bytes flac;
+    PutStr(flac, "fLaC");
+    PutU8(flac, 0);
+    PutBE(flac, streamInfo.size(), 3); // 3: the 24 bits length
+    flac = Concat({ flac, streamInfo });
+    PutU8(flac, lastFlag | typeVorbisComment);
+    PutBE(flac, comment.size(), 3); // 3: the 24 bits length
+    return Concat({ flac, comment, Bytes(FLAC_FRAMES_SIZE, 0) });
+}
+
+/**
+ * WAV: fmt, LIST-INFO and data.
+ */
+static Bytes RiffChunk(const std::string &id, const Bytes &payload)
+{
+    Bytes chunk;
+    PutStr(chunk, id);
+    PutU32LE(chunk, static_cast<uint32_t>(payload.size()));
+    chunk = Concat({ chunk, payload });
+    if (payload.size() % 2 != 0) { // 2: the chunks are word aligned
+        PutU8(chunk, 0);
+    }
+    return chunk;
+}
+
+static Bytes MakeWav(uint32_t byteRate = WAV_BYTE_RATE, bool hasData = true)
+{
+    static constexpr uint32_t formatPcm = 1;
+    static constexpr uint32_t channels = 2;
+    static constexpr uint32_t blockAlign = 4;
+    static constexpr uint32_t bitsPerSample = 16;
+    Bytes fmt;
+    PutU16LE(fmt, formatPcm);
+    PutU16LE(fmt, channels);
+    PutU32LE(fmt, WAV_SAMPLE_RATE);
+    PutU32LE(fmt, byteRate);
+    PutU16LE(fmt, blockAlign);
+    PutU16LE(fmt, bitsPerSample);
+
+    Bytes info;
+    PutStr(info, "INFO");
+    Bytes title;
+    PutStr(title, "Wav Title");
+    Bytes artist;
+    PutStr(artist, "Wav Artist");
+    info = Concat({ info, RiffChunk("INAM", title), RiffChunk("IART", artist) });
+
+    Bytes body;
+    PutStr(body, "WAVE");
+    body = Concat({ body, RiffChunk("fmt ", fmt), RiffChunk("LIST", info) });
+    if (hasData) {
+        body = Concat({ body, RiffChunk("data", Bytes(WAV_DATA_SIZE, 0)) });
+    }
+    return RiffChunk("RIFF", body);
+}
+
+/**
+ * Matroska and WebM: the EBML header, and the Info, Tracks and Cluster in the Segment.
+ */
+static Bytes Ebml(uint32_t id, const Bytes &payload)
+{
+    static constexpr uint64_t maxOneByteSize = 0x7E;
+    static constexpr uint64_t maxTwoBytesSize = 0x3FFE;
+    static constexpr uint64_t twoBytesMarker = 0x4000;
+    static constexpr uint64_t eightBytesMarker = 0x0100000000000000;
+    Bytes elem;
+    size_t idSize = sizeof(id);
+    while (idSize > 1 && (id >> ((idSize - 1) * 8)) == 0) { // 8: bits of byte
+        idSize--;
+    }
+    PutBE(elem, id, idSize);
+    uint64_t size = payload.size();
+    if (size <= maxOneByteSize) {
+        PutU8(elem, 0x80 | static_cast<uint32_t>(size));
+    } else if (size <= maxTwoBytesSize) {
+        PutBE(elem, twoBytesMarker | size, 2); // 2: bytes of the size
+    } else {
+        PutBE(elem, eightBytesMarker | size, 8); // 8: bytes of the size
+    }
+    return Concat({ elem, payload });
+}
+
+static Bytes EbmlUint(uint32_t id, uint64_t value, size_t size)
+{
+    Bytes payload;
+    PutBE(payload, value, size);
+    return Ebml(id, payload);
+}
+
+static Bytes EbmlFloat(uint32_t id, float value)
+{
+    uint32_t bits = 0;
+    (void)memcpy(&bits, &value, sizeof(bits));
+    Bytes payload;
+    PutU32BE(payload, bits);
+    return Ebml(id, payload);
+}
+
+static Bytes EbmlString(uint32_t id, const std::string &value)
+{
+    Bytes payload;
+    PutStr(payload, value);
+    return Ebml(id, payload);
+}
+
+static Bytes MakeEbmlHeader(const std::string &docType)
+{
+    return Ebml(EBML_ID_HEADER, EbmlString(EBML_ID_DOCTYPE, docType));
+}
+
+static Bytes MakeMkvInfo()
+{
+    return Ebml(MKV_ID_INFO, Concat({ EbmlUint(MKV_ID_TIMECODESCALE, MKV_TIMECODESCALE, 3), // 3: bytes of 1000000
+        EbmlFloat(MKV_ID_DURATION, MKV_DURATION), EbmlString(MKV_ID_TITLE, "Mkv Title") }));
+}
+
+static Bytes MakeMkvAudioEntry()
+{
+    return Ebml(MKV_ID_TRACKENTRY, Concat({ EbmlUint(MKV_ID_TRACKTYPE, MKV_TRACK_TYPE_AUDIO, 1),
+        Ebml(MKV_ID_AUDIO, EbmlFloat(MKV_ID_SAMPLINGFREQUENCY, MKV_SAMPLE_RATE)) }));
+}
+
+static Bytes MakeMkvCluster()
+{
+    return Ebml(MKV_ID_CLUSTER, EbmlUint(MKV_ID_TIMECODE, 0, 1));
+}
+
+static Bytes MakeMkv(const std::string &docType = "matroska", const std::string &trackName = "")
+{
+    Bytes videoEntry = EbmlUint(MKV_ID_TRACKTYPE, MKV_TRACK_TYPE_VIDEO, 1);
+    if (!trackName.empty()) {
+        videoEntry = Concat({ videoEntry, EbmlString(MKV_ID_NAME, trackName) });
+    }
+    videoEntry = Concat({ videoEntry, Ebml(MKV_ID_VIDEO, Concat({ EbmlUint(MKV_ID_PIXELWIDTH, MKV_WIDTH, MKV_UINT_SIZE),
+        EbmlUint(MKV_ID_PIXELHEIGHT, MKV_HEIGHT, MKV_UINT_SIZE) })) });
+    Bytes tracks = Ebml(MKV_ID_TRACKS, Concat({ Ebml(MKV_ID_TRACKENTRY, videoEntry), MakeMkvAudioEntry() }));
+    return Concat({ MakeEbmlHeader(docType), Ebml(MKV_ID_SEGMENT, Concat({ MakeMkvInfo(), tracks, MakeMkvCluster() })) });
+}
+
+static Bytes MakeWebm()
+{
+    // the tracks behind the cluster, located by the seek head
+    Bytes tracks = Ebml(MKV_ID_TRACKS, MakeMkvAudioEntry());
+    auto makeSeekHead = [](uint64_t position) {
+        return Ebml(MKV_ID_SEEKHEAD, Ebml(MKV_ID_SEEK, Concat({ EbmlUint(MKV_ID_SEEKID, MKV_ID_TRACKS, sizeof(uint32_t)),
+            EbmlUint(MKV_ID_SEEKPOSITION, position, MKV_SEEK_POSITION_SIZE) })));
+    };
+    Bytes body = Concat({ MakeMkvInfo(), MakeMkvCluster() });
+    Bytes seekHead = makeSeekHead(makeSeekHead(0).size() + body.size());
+    return Concat({ MakeEbmlHeader("webm"), Ebml(MKV_ID_SEGMENT, Concat({ seekHead, body, tracks })) });
+}
+
+static std::vector<Bytes> MakeAllFixtures()
+{
+    return { MakeMp4(), MakeMp3(), MakeAdts(), MakeFlac(), MakeWav(), MakeMkv(), MakeWebm() };
+}
+
+void AVMetaHeaderParserUnitTest::SetUpTestCase(void) {}
+
+void AVMetaHeaderParserUnitTest::TearDownTestCase(void) {}
+
+void AVMetaHeaderParserUnitTest::SetUp(void) {}
+
+void AVMetaHeaderParserUnitTest::TearDown(void)
+{
+    (void)unlink(TEST_FILE_PATH.c_str());
+}
+
+int32_t AVMetaHeaderParserUnitTest::Parse(const std::vector<uint8_t> &data, Metadata &meta, size_t prefixSize)
+{
+    int32_t fd = open(TEST_FILE_PATH.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        ADD_FAILURE() << "failed to open the test file, errno: " << errno;
+        return MSERR_OPEN_FILE_FAILED;
+    }
+
+    Bytes file(prefixSize, PREFIX_BYTE);
+    file = Concat({ file, data });
+    int32_t ret = MSERR_UNKNOWN;
+    if (write(fd, file.data(), file.size()) == static_cast<ssize_t>(file.size())) {
+        AVMetaHeaderParser parser(fd, static_cast<int64_t>(prefixSize), static_cast<int64_t>(data.size()));
+        ret = parser.Parse(meta);
+    } else {
+        ADD_FAILURE() << "failed to write the test file, errno: " << errno;
+    }
+    (void)close(fd);
+    return ret;
+}
+
+int32_t AVMetaHeaderParserUnitTest::Parse(const std::vector<uint8_t> &data)
+{
+    Metadata meta;
+    return Parse(data, meta);
+}
+
+void AVMetaHeaderParserUnitTest::ParseDamaged(const std::vector<uint8_t> &data)
+{
+    for (size_t size = 0; size < data.size(); size++) {
+        if (size >= MAX_DAMAGE_POS && size != data.size() - 1) {
+            continue;
+        }
+        int32_t ret = Parse(Bytes(data.begin(), data.begin() + size));
+        EXPECT_TRUE(ret == MSERR_OK || ret == MSERR_UNSUPPORT) << "truncated at " << size << ", ret: " << ret;
+    }
+
+    for (size_t pos = 0; pos < data.size() && pos < MAX_DAMAGE_POS / 2; pos++) { // 2: half of the damage range
+        Bytes corrupted = data;
+        corrupted[pos] ^= CORRUPT_MASK;
+        int32_t ret = Parse(corrupted);
+        EXPECT_TRUE(ret == MSERR_OK || ret == MSERR_UNSUPPORT) << "corrupted at " << pos << ", ret: " << ret;
+    }
+}
+
+/**
+ * @tc.name: avmeta_header_parser_mp4_0100
+ * @tc.desc: the moov of the mp4 with a rotated video track, an audio track and the ilst tags is resolved
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaHeaderParserUnitTest, avmeta_header_parser_mp4_0100, TestSize.Level0)
+{
+    Metadata meta;
+    ASSERT_EQ(Parse(MakeMp4(), meta), MSERR_OK);
+    EXPECT_EQ(meta.GetMeta(AV_KEY_MIME_TYPE), FILE_MIMETYPE_VIDEO_MP4);
+    EXPECT_EQ(meta.GetMeta(AV_KEY_DURATION), "5000");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_NUM_TRACKS), "2");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_HAS_VIDEO), "yes");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_HAS_AUDIO), "yes");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_VIDEO_WIDTH), "1280");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_VIDEO_HEIGHT), "720");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_VIDEO_ORIENTATION), "90");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_SAMPLE_RATE), "44100");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_TITLE), "Mp4 Title");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_ARTIST), "Mp4 Artist");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_DATE_TIME), "2022-01-02 03:04:05");
+}
+
+/**
+ * @tc.name: avmeta_header_parser_mp3_0100
+ * @tc.desc: the mp3 with the id3v2.3 tag and the xing header is resolved, the split id3v2.3 date is merged
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaHeaderParserUnitTest, avmeta_header_parser_mp3_0100, TestSize.Level0)
+{
+    Metadata meta;
+    ASSERT_EQ(Parse(MakeMp3(), meta), MSERR_OK);
+    EXPECT_EQ(meta.GetMeta(AV_KEY_MIME_TYPE), FILE_MIMETYPE_AUDIO_MP3);
+    // 100 frames of 1152 samples at 44100Hz
+    EXPECT_EQ(meta.GetMeta(AV_KEY_DURATION), "2612");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_NUM_TRACKS), "1");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_HAS_AUDIO), "yes");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_SAMPLE_RATE), "44100");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_TITLE), "Mp3 Title");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_ARTIST), "Mp3 Artist");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_ALBUM), "Mp3 Album");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_DATE_TIME), "2021-03-02 11:12");
+}
+
+/**
+ * @tc.name: avmeta_header_parser_mp3_0200
+ * @tc.desc: the duration of the cbr mp3 is estimated by the bitrate, the id3v1 tag is excluded
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaHeaderParserUnitTest, avmeta_header_parser_mp3_0200, TestSize.Level0)
+{
+    Bytes id3v1(ID3V1_SIZE, 0);
+    std::copy_n("TAG", strlen("TAG"), id3v1.begin());
+    Metadata meta;
+    ASSERT_EQ(Parse(Concat({ MakeMp3Frames(MP3_CBR_FRAMES, false), id3v1 }), meta), MSERR_OK);
+    // 4170 bytes at 128kbps
+    EXPECT_EQ(meta.GetMeta(AV_KEY_DURATION), "260");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_NUM_TRACKS), "1");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_SAMPLE_RATE), "44100");
+}
+
+/**
+ * @tc.name: avmeta_header_parser_adts_0100
+ * @tc.desc: the duration of the adts is counted through the frame headers
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaHeaderParserUnitTest, avmeta_header_parser_adts_0100, TestSize.Level0)
+{
+    Metadata meta;
+    ASSERT_EQ(Parse(MakeAdts(), meta), MSERR_OK);
+    EXPECT_EQ(meta.GetMeta(AV_KEY_MIME_TYPE), FILE_MIMETYPE_AUDIO_AAC);
+    // 86 frames of 1024 samples at 44100Hz
+    EXPECT_EQ(meta.GetMeta(AV_KEY_DURATION), "1996");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_NUM_TRACKS), "1");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_SAMPLE_RATE), "44100");
+
+    // an id3v2 tag before the frames
+    ASSERT_EQ(Parse(Concat({ MakeId3(MakeId3Frames()), MakeAdts() }), meta), MSERR_OK);
+    EXPECT_EQ(meta.GetMeta(AV_KEY_DURATION), "1996");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_TITLE), "Mp3 Title");
+}
+
+/**
+ * @tc.name: avmeta_header_parser_flac_0100
+ * @tc.desc: the STREAMINFO and VORBIS_COMMENT blocks of the flac are resolved
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaHeaderParserUnitTest, avmeta_header_parser_flac_0100, TestSize.Level0)
+{
+    Metadata meta;
+    ASSERT_EQ(Parse(MakeFlac(), meta), MSERR_OK);
+    EXPECT_EQ(meta.GetMeta(AV_KEY_MIME_TYPE), FILE_MIMETYPE_AUDIO_FLAC);
+    EXPECT_EQ(meta.GetMeta(AV_KEY_DURATION), "3000");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_NUM_TRACKS), "1");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_SAMPLE_RATE), "48000");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_TITLE), "Flac Title");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_ARTIST), "Flac Artist");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_DATE_TIME), "2020");
+}
+
+/**
+ * @tc.name: avmeta_header_parser_wav_0100
+ * @tc.desc: the fmt, data and LIST-INFO chunks of the wav are resolved
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaHeaderParserUnitTest, avmeta_header_parser_wav_0100, TestSize.Level0)
+{
+    Metadata meta;
+    ASSERT_EQ(Parse(MakeWav(), meta), MSERR_OK);
+    EXPECT_EQ(meta.GetMeta(AV_KEY_MIME_TYPE), FILE_MIMETYPE_AUDIO_WAV);
+    EXPECT_EQ(meta.GetMeta(AV_KEY_DURATION), "500");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_NUM_TRACKS), "1");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_SAMPLE_RATE), "8000");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_TITLE), "Wav Title");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_ARTIST), "Wav Artist");
+}
+
+/**
+ * @tc.name: avmeta_header_parser_mkv_0100
+ * @tc.desc: the Info and Tracks before the first Cluster of the matroska are resolved
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaHeaderParserUnitTest, avmeta_header_parser_mkv_0100, TestSize.Level0)
+{
+    Metadata meta;
+    ASSERT_EQ(Parse(MakeMkv(), meta), MSERR_OK);
+    EXPECT_EQ(meta.GetMeta(AV_KEY_MIME_TYPE), FILE_MIMETYPE_VIDEO_MKV);
+    EXPECT_EQ(meta.GetMeta(AV_KEY_DURATION), "2500");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_NUM_TRACKS), "2");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_HAS_VIDEO), "yes");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_HAS_AUDIO), "yes");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_VIDEO_WIDTH), "640");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_VIDEO_HEIGHT), "480");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_SAMPLE_RATE), "48000");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_TITLE), "Mkv Title");
+}
+
+/**
+ * @tc.name: avmeta_header_parser_webm_0100
+ * @tc.desc: the Tracks behind the Cluster of the webm are located by the SeekHead
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaHeaderParserUnitTest, avmeta_header_parser_webm_0100, TestSize.Level0)
+{
+    Metadata meta;
+    ASSERT_EQ(Parse(MakeWebm(), meta), MSERR_OK);
+    EXPECT_EQ(meta.GetMeta(AV_KEY_MIME_TYPE), FILE_MIMETYPE_AUDIO_WEBM);
+    EXPECT_EQ(meta.GetMeta(AV_KEY_DURATION), "2500");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_NUM_TRACKS), "1");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_HAS_AUDIO), "yes");
+    EXPECT_EQ(meta.GetMeta(AV_KEY_SAMPLE_RATE), "48000");
+}
+
+/**
+ * @tc.name: avmeta_header_parser_offset_0100
+ * @tc.desc: the media behind an offset of the fd is resolved the same as the one at the start
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaHeaderParserUnitTest, avmeta_header_parser_offset_0100, TestSize.Level0)
+{
+    for (auto &fixture : MakeAllFixtures()) {
+        Metadata expected;
+        ASSERT_EQ(Parse(fixture, expected), MSERR_OK);
+        Metadata meta;
+        ASSERT_EQ(Parse(fixture, meta, PREFIX_SIZE), MSERR_OK);
+        EXPECT_EQ(meta.tbl_, expected.tbl_);
+    }
+}
+
+/**
+ * @tc.name: avmeta_header_parser_truncated_0100
+ * @tc.desc: the header cut off in the middle is rejected
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaHeaderParserUnitTest, avmeta_header_parser_truncated_0100, TestSize.Level0)
+{
+    EXPECT_EQ(Parse(Bytes()), MSERR_UNSUPPORT);
+
+    // the moov of the mp4
+    Bytes mp4 = MakeMp4();
+    EXPECT_EQ(Parse(Bytes(mp4.begin(), mp4.begin() + mp4.size() / 2)), MSERR_UNSUPPORT); // 2: the middle of the moov
+
+    // the id3v2 tag of the mp3
+    Bytes mp3 = MakeMp3();
+    Bytes id3 = MakeId3(MakeId3Frames());
+    EXPECT_EQ(Parse(Bytes(mp3.begin(), mp3.begin() + id3.size() / 2)), MSERR_UNSUPPORT); // 2: the middle of the tag
+
+    // the STREAMINFO of the flac
+    Bytes flac = MakeFlac();
+    EXPECT_EQ(Parse(Bytes(flac.begin(), flac.begin() + FLAC_STREAMINFO_POS + FLAC_RATE_POS)), MSERR_UNSUPPORT);
+
+    // the Tracks of the matroska
+    Bytes mkv = MakeMkv();
+    Bytes cluster = MakeMkvCluster();
+    EXPECT_EQ(Parse(Bytes(mkv.begin(), mkv.end() - cluster.size() - 1)), MSERR_UNSUPPORT);
+}
+
+/**
+ * @tc.name: avmeta_header_parser_truncated_0200
+ * @tc.desc: every truncated or corrupted header is either resolved or rejected, never read out of the bound
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaHeaderParserUnitTest, avmeta_header_parser_truncated_0200, TestSize.Level1)
+{
+    for (auto &fixture : MakeAllFixtures()) {
+        ParseDamaged(fixture);
+    }
+}
+
+/**
+ * @tc.name: avmeta_header_parser_corrupt_0100
+ * @tc.desc: the corrupted headers and the ones not completely understood are left to the pipeline
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaHeaderParserUnitTest, avmeta_header_parser_corrupt_0100, TestSize.Level0)
+{
+    // the size of the moov beyond the file
+    static constexpr uint8_t oversizedByte = 0x7F;
+    Bytes mp4 = MakeMp4();
+    mp4[MakeMp4Ftyp().size()] = oversizedByte;
+    EXPECT_EQ(Parse(mp4), MSERR_UNSUPPORT);
+
+    // the fragmented mp4 and the numeric genre
+    EXPECT_EQ(Parse(MakeMp4(Mp4Box("mvex", Bytes()))), MSERR_UNSUPPORT);
+    EXPECT_EQ(Parse(MakeMp4({}, Mp4Box("gnre", Bytes()))), MSERR_UNSUPPORT);
+
+    // the unsynchronized id3 tag and the numeric id3 genre
+    static constexpr uint8_t flagUnsync = 0x80;
+    EXPECT_EQ(Parse(Concat({ MakeId3(MakeId3Frames(), flagUnsync), MakeMp3Frames(2, true) })), MSERR_UNSUPPORT);
+    EXPECT_EQ(Parse(Concat({ MakeId3(MakeId3Frame("TCON", "(13)")), MakeMp3Frames(2, true) })), MSERR_UNSUPPORT);
+
+    // the flac without the sample rate
+    Bytes streamInfo(std::begin(FLAC_STREAMINFO), std::end(FLAC_STREAMINFO));
+    std::fill_n(streamInfo.begin() + FLAC_RATE_POS, 2, 0); // 2: the high 16 bits of the sample rate
+    EXPECT_EQ(Parse(MakeFlac(streamInfo)), MSERR_UNSUPPORT);
+
+    // the wav without the data chunk or the byte rate
+    EXPECT_EQ(Parse(MakeWav(WAV_BYTE_RATE, false)), MSERR_UNSUPPORT);
+    EXPECT_EQ(Parse(MakeWav(0, true)), MSERR_UNSUPPORT);
+
+    // the unknown doc type and the named track of the matroska
+    EXPECT_EQ(Parse(MakeMkv("unknown")), MSERR_UNSUPPORT);
+    EXPECT_EQ(Parse(MakeMkv("matroska", "Named Track")), MSERR_UNSUPPORT);
+
+    // not a media file
+    Bytes garbage(MAX_DAMAGE_POS, PREFIX_BYTE);
+    EXPECT_EQ(Parse(garbage), MSERR_UNSUPPORT);
+}
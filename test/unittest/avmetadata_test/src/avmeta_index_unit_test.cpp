@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avmeta_index_unit_test.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "avsharedmemorybase.h"
+#include "media_errors.h"
+
+using namespace std;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace testing::ext;
+
+namespace {
+    const std::string INDEX_PATH = "/data/test/avmeta_index_unit_test";
+    const std::string INDEX_TMP_PATH = INDEX_PATH + ".tmp";
+    // large enough not to be compacted or evicted by the cases not about it
+    constexpr uint64_t NO_LIMIT = 64 * 1024 * 1024;
+    constexpr uint64_t MIN_COMPACT_SIZE = 4096;
+    constexpr uint64_t MAX_FILE_SIZE = 8192;
+    constexpr int32_t META_KEY = 1;
+    constexpr size_t META_VALUE_SIZE = 1000;
+    constexpr int32_t ART_SIZE = 4096;
+    constexpr uint32_t EVICT_RECORD_NUM = 10;
+    constexpr char MAX_FILL = 'z';
+    constexpr off_t TORN_SIZE = 8;
+    constexpr size_t GARBAGE_SIZE = 100;
+    constexpr uint8_t GARBAGE_BYTE = 0xFF;
+}
+
+void AVMetaIndexUnitTest::SetUpTestCase(void) {}
+
+void AVMetaIndexUnitTest::TearDownTestCase(void) {}
+
+void AVMetaIndexUnitTest::SetUp(void)
+{
+    (void)unlink(INDEX_PATH.c_str());
+    (void)unlink(INDEX_TMP_PATH.c_str());
+}
+
+void AVMetaIndexUnitTest::TearDown(void)
+{
+    CloseIndex();
+    (void)unlink(INDEX_PATH.c_str());
+    (void)unlink(INDEX_TMP_PATH.c_str());
+}
+
+void AVMetaIndexUnitTest::OpenIndex(uint64_t maxFileSize, uint64_t minCompactSize)
+{
+    // the file is locked by the index, so the old one is closed before reopened
+    CloseIndex();
+    index_ = std::make_unique<AVMetaIndex>(INDEX_PATH, maxFileSize, minCompactSize);
+    ASSERT_TRUE(index_->IsEnabled());
+}
+
+void AVMetaIndexUnitTest::CloseIndex()
+{
+    index_ = nullptr;
+}
+
+int64_t AVMetaIndexUnitTest::GetFileSize(const std::string &path) const
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return -1;
+    }
+    return static_cast<int64_t>(st.st_size);
+}
+
+AVMetaIndexKey AVMetaIndexUnitTest::MakeKey(uint32_t id)
+{
+    AVMetaIndexKey key;
+    key.dev = 1;
+    key.ino = id;
+    key.fileSize = 1;
+    key.mtimeNs = 1;
+    key.size = 1;
+    return key;
+}
+
+std::unordered_map<int32_t, std::string> AVMetaIndexUnitTest::MakeMeta(uint32_t id, char fill)
+{
+    std::unordered_map<int32_t, std::string> meta;
+    // every record is the same size
+    meta[META_KEY] = std::string(META_VALUE_SIZE, fill);
+    meta[META_KEY][0] = static_cast<char>('0' + id % 10);
+    return meta;
+}
+
+void AVMetaIndexUnitTest::ExpectMeta(uint32_t id, char fill)
+{
+    std::unordered_map<int32_t, std::string> meta;
+    ASSERT_TRUE(index_->Lookup(MakeKey(id), meta, nullptr));
+    EXPECT_EQ(meta, MakeMeta(id, fill));
+}
+
+/**
+ * @tc.name: avmeta_index_store_0100
+ * @tc.desc: the stored metadata and art picture are found after reopened, the newer record overrides the older
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaIndexUnitTest, avmeta_index_store_0100, TestSize.Level0)
+{
+    OpenIndex(NO_LIMIT, NO_LIMIT);
+    std::unordered_map<int32_t, std::string> meta;
+    EXPECT_FALSE(index_->Lookup(MakeKey(0), meta, nullptr));
+
+    auto art = AVSharedMemoryBase::CreateFromLocal(ART_SIZE, AVSharedMemory::FLAGS_READ_WRITE, "artpic");
+    ASSERT_NE(art, nullptr);
+    for (int32_t i = 0; i < ART_SIZE; i++) {
+        art->GetBase()[i] = static_cast<uint8_t>(i);
+    }
+    index_->Store(MakeKey(0), MakeMeta(0, 'a'), art);
+    index_->Store(MakeKey(1), MakeMeta(1, 'a'), nullptr);
+    index_->Store(MakeKey(1), MakeMeta(1, 'b'), nullptr);
+
+    OpenIndex(NO_LIMIT, NO_LIMIT);
+    std::shared_ptr<AVSharedMemory> result = nullptr;
+    ASSERT_TRUE(index_->Lookup(MakeKey(0), meta, &result));
+    EXPECT_EQ(meta, MakeMeta(0, 'a'));
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(result->GetSize(), ART_SIZE);
+    EXPECT_EQ(memcmp(result->GetBase(), art->GetBase(), ART_SIZE), 0);
+
+    ASSERT_TRUE(index_->Lookup(MakeKey(1), meta, &result));
+    EXPECT_EQ(meta, MakeMeta(1, 'b'));
+    EXPECT_EQ(result, nullptr);
+}
+
+/**
+ * @tc.name: avmeta_index_torn_tail_0100
+ * @tc.desc: a record cut short by a crash is dropped and cut off when loaded, the records before it are kept
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaIndexUnitTest, avmeta_index_torn_tail_0100, TestSize.Level0)
+{
+    OpenIndex(NO_LIMIT, NO_LIMIT);
+    index_->Store(MakeKey(0), MakeMeta(0, 'a'), nullptr);
+    int64_t intactSize = GetFileSize(INDEX_PATH);
+    index_->Store(MakeKey(1), MakeMeta(1, 'a'), nullptr);
+    int64_t fullSize = GetFileSize(INDEX_PATH);
+    CloseIndex();
+
+    ASSERT_EQ(truncate(INDEX_PATH.c_str(), static_cast<off_t>(fullSize) - TORN_SIZE), 0);
+    OpenIndex(NO_LIMIT, NO_LIMIT);
+    EXPECT_EQ(GetFileSize(INDEX_PATH), intactSize);
+    ExpectMeta(0, 'a');
+    std::unordered_map<int32_t, std::string> meta;
+    EXPECT_FALSE(index_->Lookup(MakeKey(1), meta, nullptr));
+
+    // appended right after the kept records
+    index_->Store(MakeKey(1), MakeMeta(1, 'b'), nullptr);
+    EXPECT_EQ(GetFileSize(INDEX_PATH), fullSize);
+    OpenIndex(NO_LIMIT, NO_LIMIT);
+    ExpectMeta(0, 'a');
+    ExpectMeta(1, 'b');
+}
+
+/**
+ * @tc.name: avmeta_index_torn_tail_0200
+ * @tc.desc: the garbage following the records is cut off, the file with a corrupt header is recreated
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaIndexUnitTest, avmeta_index_torn_tail_0200, TestSize.Level0)
+{
+    OpenIndex(NO_LIMIT, NO_LIMIT);
+    int64_t emptySize = GetFileSize(INDEX_PATH);
+    index_->Store(MakeKey(0), MakeMeta(0, 'a'), nullptr);
+    int64_t intactSize = GetFileSize(INDEX_PATH);
+    CloseIndex();
+
+    std::vector<uint8_t> garbage(GARBAGE_SIZE, GARBAGE_BYTE);
+    int32_t fd = open(INDEX_PATH.c_str(), O_WRONLY | O_APPEND);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(write(fd, garbage.data(), garbage.size()), static_cast<ssize_t>(garbage.size()));
+    (void)close(fd);
+
+    OpenIndex(NO_LIMIT, NO_LIMIT);
+    EXPECT_EQ(GetFileSize(INDEX_PATH), intactSize);
+    ExpectMeta(0, 'a');
+    CloseIndex();
+
+    fd = open(INDEX_PATH.c_str(), O_WRONLY);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(pwrite(fd, garbage.data(), static_cast<size_t>(emptySize), 0), static_cast<ssize_t>(emptySize));
+    (void)close(fd);
+
+    OpenIndex(NO_LIMIT, NO_LIMIT);
+    EXPECT_EQ(GetFileSize(INDEX_PATH), emptySize);
+    std::unordered_map<int32_t, std::string> meta;
+    EXPECT_FALSE(index_->Lookup(MakeKey(0), meta, nullptr));
+}
+
+/**
+ * @tc.name: avmeta_index_compact_0100
+ * @tc.desc: the overridden records are dropped by the compaction through the tmp file, the live ones are kept
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaIndexUnitTest, avmeta_index_compact_0100, TestSize.Level0)
+{
+    OpenIndex(NO_LIMIT, MIN_COMPACT_SIZE);
+    int64_t emptySize = GetFileSize(INDEX_PATH);
+    index_->Store(MakeKey(0), MakeMeta(0, 'a'), nullptr);
+    int64_t recordSize = GetFileSize(INDEX_PATH) - emptySize;
+    ASSERT_GT(recordSize, 0);
+
+    // override the same key until the overridden records take half of the file beyond the MIN_COMPACT_SIZE
+    char fill = 'a';
+    int64_t lastSize = GetFileSize(INDEX_PATH);
+    bool compacted = false;
+    while (!compacted && fill < MAX_FILL) {
+        fill++;
+        index_->Store(MakeKey(1), MakeMeta(1, fill), nullptr);
+        int64_t size = GetFileSize(INDEX_PATH);
+        compacted = size < lastSize;
+        lastSize = size;
+    }
+
+    ASSERT_TRUE(compacted);
+    ASSERT_TRUE(index_->IsEnabled());
+    EXPECT_EQ(GetFileSize(INDEX_PATH), emptySize + recordSize * 2);
+    EXPECT_EQ(GetFileSize(INDEX_TMP_PATH), -1);
+    ExpectMeta(0, 'a');
+    ExpectMeta(1, fill);
+
+    OpenIndex(NO_LIMIT, MIN_COMPACT_SIZE);
+    ExpectMeta(0, 'a');
+    ExpectMeta(1, fill);
+}
+
+/**
+ * @tc.name: avmeta_index_evict_0100
+ * @tc.desc: the oldest records are dropped once the file grows beyond the limit, the newest ones are kept
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVMetaIndexUnitTest, avmeta_index_evict_0100, TestSize.Level0)
+{
+    OpenIndex(MAX_FILE_SIZE, NO_LIMIT);
+    for (uint32_t id = 0; id < EVICT_RECORD_NUM; id++) {
+        index_->Store(MakeKey(id), MakeMeta(id, 'a'), nullptr);
+        EXPECT_LE(static_cast<uint64_t>(GetFileSize(INDEX_PATH)), MAX_FILE_SIZE);
+    }
+    ASSERT_TRUE(index_->IsEnabled());
+    EXPECT_EQ(GetFileSize(INDEX_TMP_PATH), -1);
+
+    std::unordered_map<int32_t, std::string> meta;
+    EXPECT_FALSE(index_->Lookup(MakeKey(0), meta, nullptr));
+    ExpectMeta(EVICT_RECORD_NUM - 1, 'a');
+
+    OpenIndex(MAX_FILE_SIZE, NO_LIMIT);
+    EXPECT_FALSE(index_->Lookup(MakeKey(0), meta, nullptr));
+    ExpectMeta(EVICT_RECORD_NUM - 1, 'a');
+}
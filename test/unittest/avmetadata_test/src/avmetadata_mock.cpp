@@ -22,6 +22,32 @@ using namespace OHOS::Media;
 using namespace AVMetadataTestParam;
 namespace OHOS {
 namespace Media {
+void AVMetadataBatchCallbackMock::OnResult(int32_t index, int32_t errCode,
+    const std::unordered_map<int32_t, std::string> &metadata, const std::shared_ptr<PixelMap> &thumbnail)
+{
+    UNITTEST_INFO_LOG("%s index %d errCode %d", __FUNCTION__, index, errCode);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (results_.count(index) != 0) {
+        duplicatedResults_++;
+    }
+    results_[index] = {errCode, metadata, thumbnail};
+}
+
+void AVMetadataBatchCallbackMock::OnFinished(int32_t errCode)
+{
+    UNITTEST_INFO_LOG("%s errCode %d", __FUNCTION__, errCode);
+    std::lock_guard<std::mutex> lock(mutex_);
+    finishedCount_++;
+    finishedErrCode_ = errCode;
+    cond_.notify_all();
+}
+
+bool AVMetadataBatchCallbackMock::WaitFinished(int32_t timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cond_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return finishedCount_ > 0; });
+}
+
 AVMetadataMock::AVMetadataMock()
 {
 }
@@ -113,6 +139,48 @@ std::shared_ptr<PixelMap> AVMetadataMock::FetchFrameAtTime(int64_t timeUs, int32
     return avMetadataHelper_->FetchFrameAtTime(timeUs, option, param);
 }
 
+int32_t AVMetadataMock::FetchFramesAtTimes(const std::vector<int64_t> &timesUs, int32_t option,
+    PixelMapParams param, const FrameFetchedCallback &callback)
+{
+    UNITTEST_INFO_LOG("%s", __FUNCTION__);
+    return avMetadataHelper_->FetchFramesAtTimes(timesUs, option, param, callback);
+}
+
+int32_t AVMetadataMock::ResolveMetadataBatch(const std::vector<std::string> &paths,
+    const AVMetadataBatchParams &params, const std::shared_ptr<AVMetadataBatchCallback> &callback)
+{
+    UNITTEST_INFO_LOG("%s %zu sources", __FUNCTION__, paths.size());
+    std::vector<AVMetadataBatchSource> sources;
+    int32_t ret = 0;
+    for (auto &path : paths) {
+        std::string rawFile = path.substr(strlen("file://"));
+        AVMetadataBatchSource source;
+        source.fd = open(rawFile.c_str(), O_RDONLY);
+        struct stat64 st;
+        if (source.fd <= 0 || fstat64(source.fd, &st) != 0) {
+            std::cout << "Open file failed" << std::endl;
+            ret = -1;
+            break;
+        }
+        source.size = static_cast<int64_t>(st.st_size);
+        sources.push_back(source);
+    }
+    if (ret == 0) {
+        ret = avMetadataHelper_->ResolveMetadataBatch(sources, params, callback);
+    }
+    // the fds are only used during the call
+    for (auto &source : sources) {
+        (void)close(source.fd);
+    }
+    return ret;
+}
+
+int32_t AVMetadataMock::CancelBatch()
+{
+    UNITTEST_INFO_LOG("%s", __FUNCTION__);
+    return avMetadataHelper_->CancelBatch();
+}
+
 std::shared_ptr<AVSharedMemory> AVMetadataMock::FetchArtPicture()
 {
     UNITTEST_INFO_LOG("%s", __FUNCTION__);
@@ -13,6 +13,10 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
 #include "gtest/gtest.h"
 #include "media_errors.h"
 #include "avmetadata_unit_test.h"
@@ -112,6 +116,169 @@ HWTEST_F(AVMetadataUnitTest, ResolveMetadata_Format_MP4_0100, TestSize.Level0)
     CheckMeta(uri, expectMeta);
 }
 
+/**
+ * @tc.number    : ResolveMetadataBatch_0100
+ * @tc.name      : Resolve the metadata of a batch of sources
+ * @tc.desc      : every source is reported once, then the batch is finished
+ */
+HWTEST_F(AVMetadataUnitTest, ResolveMetadataBatch_0100, TestSize.Level0)
+{
+    std::string mountPath = AVMetadataTestBase::GetInstance().GetMountPath();
+    std::vector<std::string> paths;
+    for (int32_t i = 0; i < 4; i++) { // 4: enough to keep several workers busy
+        paths.push_back(mountPath + "H264_AAC.mp4");
+        paths.push_back(mountPath + "out_480_320.mp4");
+        paths.push_back(mountPath + "MP3_SURFACE.mp3");
+    }
+
+    std::shared_ptr<AVMetadataMock> helper = std::make_shared<AVMetadataMock>();
+    ASSERT_NE(nullptr, helper);
+    ASSERT_EQ(true, helper->CreateAVMetadataHelper());
+
+    AVMetadataBatchParams params;
+    params.keys = {AV_KEY_DURATION, AV_KEY_HAS_VIDEO, AV_KEY_MIME_TYPE};
+    params.fetchThumbnail = true;
+    params.thumbnailParams = {-1, -1, PixelFormat::RGB_565};
+    auto callback = std::make_shared<AVMetadataBatchCallbackMock>();
+    ASSERT_EQ(MSERR_OK, helper->ResolveMetadataBatch(paths, params, callback));
+    // only one batch at a time
+    EXPECT_NE(MSERR_OK, helper->ResolveMetadataBatch(paths, params, std::make_shared<AVMetadataBatchCallbackMock>()));
+    ASSERT_EQ(true, callback->WaitFinished(60000)); // 60000: 60s
+
+    std::lock_guard<std::mutex> lock(callback->mutex_);
+    EXPECT_EQ(MSERR_OK, callback->finishedErrCode_);
+    EXPECT_EQ(1, callback->finishedCount_);
+    EXPECT_EQ(0, callback->duplicatedResults_);
+    ASSERT_EQ(paths.size(), callback->results_.size());
+    for (int32_t i = 0; i < static_cast<int32_t>(paths.size()); i++) {
+        auto &result = callback->results_[i];
+        EXPECT_EQ(MSERR_OK, result.errCode);
+        EXPECT_EQ(params.keys.size(), result.metadata.size());
+        bool hasVideo = result.metadata[AV_KEY_HAS_VIDEO] == "yes";
+        EXPECT_EQ(paths[i].find(".mp4") != std::string::npos, hasVideo);
+        EXPECT_EQ(hasVideo, result.thumbnail != nullptr);
+    }
+    EXPECT_EQ("10030", callback->results_[0].metadata[AV_KEY_DURATION]);
+    EXPECT_EQ("video/mp4", callback->results_[0].metadata[AV_KEY_MIME_TYPE]);
+    helper->Release();
+}
+
+/**
+ * @tc.number    : ResolveMetadataBatch_0200
+ * @tc.name      : Cancel a batch and start another one
+ * @tc.desc      : no result after cancelled, and the next batch works well
+ */
+HWTEST_F(AVMetadataUnitTest, ResolveMetadataBatch_0200, TestSize.Level0)
+{
+    std::string path = AVMetadataTestBase::GetInstance().GetMountPath() + "H264_AAC.mp4";
+    std::vector<std::string> paths(MAX_BATCH_SOURCES_NUM, path);
+
+    std::shared_ptr<AVMetadataMock> helper = std::make_shared<AVMetadataMock>();
+    ASSERT_NE(nullptr, helper);
+    ASSERT_EQ(true, helper->CreateAVMetadataHelper());
+
+    AVMetadataBatchParams params;
+    auto nopCallback = std::make_shared<AVMetadataBatchCallbackMock>();
+    EXPECT_NE(MSERR_OK, helper->ResolveMetadataBatch({}, params, nopCallback));
+    EXPECT_NE(MSERR_OK, helper->ResolveMetadataBatch({path}, params, nullptr));
+    paths.push_back(path);
+    EXPECT_NE(MSERR_OK, helper->ResolveMetadataBatch(paths, params, nopCallback));
+    paths.pop_back();
+
+    auto callback = std::make_shared<AVMetadataBatchCallbackMock>();
+    ASSERT_EQ(MSERR_OK, helper->ResolveMetadataBatch(paths, params, callback));
+    EXPECT_EQ(MSERR_OK, helper->CancelBatch());
+    size_t reported = 0;
+    {
+        std::lock_guard<std::mutex> lock(callback->mutex_);
+        reported = callback->results_.size();
+    }
+    ASSERT_EQ(true, callback->WaitFinished(60000)); // 60000: 60s
+    {
+        std::lock_guard<std::mutex> lock(callback->mutex_);
+        EXPECT_EQ(reported, callback->results_.size());
+        EXPECT_EQ(MSERR_INVALID_STATE, callback->finishedErrCode_);
+    }
+
+    auto nextCallback = std::make_shared<AVMetadataBatchCallbackMock>();
+    ASSERT_EQ(MSERR_OK, helper->ResolveMetadataBatch({path, path}, params, nextCallback));
+    ASSERT_EQ(true, nextCallback->WaitFinished(60000)); // 60000: 60s
+    {
+        std::lock_guard<std::mutex> lock(nextCallback->mutex_);
+        EXPECT_EQ(MSERR_OK, nextCallback->finishedErrCode_);
+        EXPECT_EQ(2u, nextCallback->results_.size());
+    }
+    helper->Release();
+}
+
+/**
+ * @tc.number    : ResolveMetadataBatch_0300
+ * @tc.name      : Close the fds of the sources once the batch is submitted
+ * @tc.desc      : the batch holds its own fds, every source is still resolved
+ */
+HWTEST_F(AVMetadataUnitTest, ResolveMetadataBatch_0300, TestSize.Level0)
+{
+    std::string path = AVMetadataTestBase::GetInstance().GetMountPath() + "H264_AAC.mp4";
+    std::vector<std::string> paths(MAX_BATCH_SOURCES_NUM, path);
+
+    std::shared_ptr<AVMetadataMock> helper = std::make_shared<AVMetadataMock>();
+    ASSERT_NE(nullptr, helper);
+    ASSERT_EQ(true, helper->CreateAVMetadataHelper());
+
+    AVMetadataBatchParams params;
+    params.keys = {AV_KEY_DURATION};
+    auto callback = std::make_shared<AVMetadataBatchCallbackMock>();
+    // the mock closes the fds of the sources as soon as the batch is submitted
+    ASSERT_EQ(MSERR_OK, helper->ResolveMetadataBatch(paths, params, callback));
+    // reuse the closed fd numbers, a source still using them would read the wrong file
+    std::vector<int32_t> fds;
+    for (size_t i = 0; i < paths.size(); i++) {
+        fds.push_back(open("/dev/null", O_RDONLY));
+    }
+    ASSERT_EQ(true, callback->WaitFinished(60000)); // 60000: 60s
+    for (int32_t fd : fds) {
+        if (fd >= 0) {
+            (void)close(fd);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(callback->mutex_);
+    EXPECT_EQ(MSERR_OK, callback->finishedErrCode_);
+    ASSERT_EQ(paths.size(), callback->results_.size());
+    for (auto &[index, result] : callback->results_) {
+        EXPECT_EQ(MSERR_OK, result.errCode) << "source " << index;
+        EXPECT_EQ("10030", result.metadata[AV_KEY_DURATION]);
+    }
+    helper->Release();
+}
+
+/**
+ * @tc.number    : ResolveMetadataBatch_0400
+ * @tc.name      : Release the helper while a batch is in progress
+ * @tc.desc      : the release does not wait for the sources being resolved
+ */
+HWTEST_F(AVMetadataUnitTest, ResolveMetadataBatch_0400, TestSize.Level0)
+{
+    std::string path = AVMetadataTestBase::GetInstance().GetMountPath() + "H264_AAC.mp4";
+    std::vector<std::string> paths(MAX_BATCH_SOURCES_NUM, path);
+
+    std::shared_ptr<AVMetadataMock> helper = std::make_shared<AVMetadataMock>();
+    ASSERT_NE(nullptr, helper);
+    ASSERT_EQ(true, helper->CreateAVMetadataHelper());
+
+    AVMetadataBatchParams params;
+    params.fetchThumbnail = true;
+    params.thumbnailParams = {-1, -1, PixelFormat::RGB_565};
+    auto callback = std::make_shared<AVMetadataBatchCallbackMock>();
+    ASSERT_EQ(MSERR_OK, helper->ResolveMetadataBatch(paths, params, callback));
+
+    auto begin = std::chrono::steady_clock::now();
+    helper->Release();
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    EXPECT_LT(elapsedMs, 500); // 500: far below a source resolved with its thumbnail
+}
+
 /**
     * @tc.number    : FetchArtPicture_Format_MP3_0100
     * @tc.name      : Get SURFACE FROM MP3_SURFACE.mp3
@@ -153,3 +320,46 @@ HWTEST_F(AVMetadataUnitTest, FetchFrameAtTime_Resolution_2800, TestSize.Level0)
     std::string("out_480_320.mp4");
     GetThumbnail(uri);
 }
+
+/**
+ * @tc.number    : FetchFramesAtTimes_0100
+ * @tc.name      : Fetch a batch of thumbnails
+ * @tc.desc      : the frames are delivered once for every time in ascending order
+ */
+HWTEST_F(AVMetadataUnitTest, FetchFramesAtTimes_0100, TestSize.Level0)
+{
+    std::string uri = AVMetadataTestBase::GetInstance().GetMountPath() +
+    std::string("out_480_320.mp4");
+    std::shared_ptr<AVMetadataMock> helper = std::make_shared<AVMetadataMock>();
+    ASSERT_NE(nullptr, helper);
+    ASSERT_EQ(true, helper->CreateAVMetadataHelper());
+    ASSERT_EQ(MSERR_OK, helper->SetSource(uri, 0, 0, AVMetadataUsage::AV_META_USAGE_PIXEL_MAP));
+
+    struct PixelMapParams param = {-1, -1, PixelFormat::RGB_565};
+    std::vector<int64_t> timesUs = {5000000, 0, 1000000, 1000000, 1040000}; // unordered and duplicated times
+    std::vector<int32_t> queryOptions = {
+        AVMetadataQueryOption::AV_META_QUERY_CLOSEST, AVMetadataQueryOption::AV_META_QUERY_PREVIOUS_SYNC
+    };
+    for (auto queryOption : queryOptions) {
+        std::vector<int64_t> fetchedTimesUs;
+        auto callback = [&](int64_t timeUs, const std::shared_ptr<PixelMap> &frame) {
+            fetchedTimesUs.push_back(timeUs);
+            ASSERT_NE(nullptr, frame);
+            helper->FrameToFile(frame, testInfo_->name(), timeUs, queryOption);
+        };
+        ASSERT_EQ(MSERR_OK, helper->FetchFramesAtTimes(timesUs, queryOption, param, callback));
+
+        std::vector<int64_t> expectTimesUs = timesUs;
+        std::sort(expectTimesUs.begin(), expectTimesUs.end());
+        EXPECT_EQ(expectTimesUs, fetchedTimesUs);
+    }
+
+    auto nopCallback = [](int64_t, const std::shared_ptr<PixelMap> &) {};
+    EXPECT_NE(MSERR_OK, helper->FetchFramesAtTimes({}, AV_META_QUERY_CLOSEST, param, nopCallback));
+    EXPECT_NE(MSERR_OK, helper->FetchFramesAtTimes({-1}, AV_META_QUERY_CLOSEST, param, nopCallback));
+    EXPECT_NE(MSERR_OK, helper->FetchFramesAtTimes({0}, AV_META_QUERY_CLOSEST, param, nullptr));
+
+    // the single fetching works well after a batch
+    EXPECT_NE(nullptr, helper->FetchFrameAtTime(0, AV_META_QUERY_CLOSEST_SYNC, param));
+    helper->Release();
+}
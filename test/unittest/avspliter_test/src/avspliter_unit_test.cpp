@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avspliter_unit_test.h"
+#include <set>
+#include "media_errors.h"
+
+using namespace std;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace testing::ext;
+
+namespace {
+    const std::string TEST_URI = "file:///data/test/H264_AAC.mp4";
+    constexpr size_t SAMPLE_BUFFER_SIZE = 1024 * 1024;
+    constexpr size_t SMALL_BUFFER_SIZE = 16;
+    constexpr uint32_t MAX_READ_TIMES = 100000;
+    constexpr uint32_t PARTIAL_READ_TIMES = 50;
+    constexpr int64_t SEEK_TIME_US = 1000000;
+    constexpr int64_t READ_PAST_SEEK_US = 3000000;
+}
+
+void AVSpliterUnitTest::SetUpTestCase(void) {}
+
+void AVSpliterUnitTest::TearDownTestCase(void) {}
+
+void AVSpliterUnitTest::SetUp(void)
+{
+    spliter_ = AVSpliterFactory::CreateAVSpliter();
+    ASSERT_NE(spliter_, nullptr);
+    ASSERT_EQ(spliter_->SetSource(TEST_URI, TRACK_TIME_SYNC), MSERR_OK);
+    data_.resize(SAMPLE_BUFFER_SIZE);
+    buffer_ = std::make_shared<AVContainerMemory>(data_.data(), data_.size());
+}
+
+void AVSpliterUnitTest::TearDown(void)
+{
+    if (spliter_ != nullptr) {
+        spliter_->Release();
+        spliter_ = nullptr;
+    }
+    buffer_ = nullptr;
+}
+
+int32_t AVSpliterUnitTest::FindTrack(MediaType type, uint32_t &trackIdx)
+{
+    MediaDescription desc;
+    int32_t ret = spliter_->GetContainerDescription(desc);
+    if (ret != MSERR_OK) {
+        return ret;
+    }
+    int32_t trackCount = 0;
+    (void)desc.GetIntValue(MediaDescriptionKey::MD_KEY_TRACK_COUNT, trackCount);
+    for (int32_t idx = 0; idx < trackCount; idx++) {
+        MediaDescription trackDesc;
+        ret = spliter_->GetTrackDescription(static_cast<uint32_t>(idx), trackDesc);
+        if (ret != MSERR_OK) {
+            return ret;
+        }
+        int32_t trackType = -1;
+        if (trackDesc.GetIntValue(MediaDescriptionKey::MD_KEY_TRACK_TYPE, trackType) && trackType == type) {
+            trackIdx = static_cast<uint32_t>(idx);
+            return MSERR_OK;
+        }
+    }
+    return MSERR_INVALID_VAL;
+}
+
+int32_t AVSpliterUnitTest::ReadSample(TrackSampleInfo &info)
+{
+    // the codec data is skipped, only the frames are checked by the cases.
+    int32_t ret = MSERR_OK;
+    do {
+        ret = spliter_->ReadTrackSample(buffer_, info);
+    } while (ret == MSERR_OK && info.flags == AVCODEC_BUFFER_FLAG_CODEC_DATA);
+    return ret;
+}
+
+/**
+ * @tc.name: avspliter_read_interleaved_0100
+ * @tc.desc: the samples of all selected tracks are read in timestamp order until the eos
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVSpliterUnitTest, avspliter_read_interleaved_0100, TestSize.Level0)
+{
+    uint32_t videoIdx = 0;
+    uint32_t audioIdx = 0;
+    ASSERT_EQ(FindTrack(MEDIA_TYPE_VID, videoIdx), MSERR_OK);
+    ASSERT_EQ(FindTrack(MEDIA_TYPE_AUD, audioIdx), MSERR_OK);
+    ASSERT_EQ(spliter_->SelectTrack(videoIdx), MSERR_OK);
+    ASSERT_EQ(spliter_->SelectTrack(audioIdx), MSERR_OK);
+
+    std::set<uint32_t> readTracks;
+    int64_t lastTimeUs = -1;
+    uint32_t readTimes = 0;
+    TrackSampleInfo info = {0, 0, 0, AVCODEC_BUFFER_FLAG_NONE};
+    for (; readTimes < MAX_READ_TIMES; readTimes++) {
+        ASSERT_EQ(ReadSample(info), MSERR_OK);
+        if (info.flags == AVCODEC_BUFFER_FLAG_EOS) {
+            break;
+        }
+        EXPECT_GE(info.timeUs, lastTimeUs);
+        lastTimeUs = info.timeUs;
+        readTracks.insert(info.trackIdx);
+    }
+    EXPECT_LT(readTimes, MAX_READ_TIMES);
+    EXPECT_EQ(readTracks.count(videoIdx), 1u);
+    EXPECT_EQ(readTracks.count(audioIdx), 1u);
+}
+
+/**
+ * @tc.name: avspliter_read_single_track_0100
+ * @tc.desc: only the selected track is read while the other track is unselected
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVSpliterUnitTest, avspliter_read_single_track_0100, TestSize.Level0)
+{
+    uint32_t audioIdx = 0;
+    ASSERT_EQ(FindTrack(MEDIA_TYPE_AUD, audioIdx), MSERR_OK);
+    ASSERT_EQ(spliter_->SelectTrack(audioIdx), MSERR_OK);
+
+    uint32_t readTimes = 0;
+    TrackSampleInfo info = {0, 0, 0, AVCODEC_BUFFER_FLAG_NONE};
+    for (; readTimes < MAX_READ_TIMES; readTimes++) {
+        ASSERT_EQ(ReadSample(info), MSERR_OK);
+        if (info.flags == AVCODEC_BUFFER_FLAG_EOS) {
+            break;
+        }
+        ASSERT_EQ(info.trackIdx, audioIdx);
+    }
+    EXPECT_LT(readTimes, MAX_READ_TIMES);
+}
+
+/**
+ * @tc.name: avspliter_small_buffer_0100
+ * @tc.desc: a sample larger than the buffer stays queued and is returned to the next larger read
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVSpliterUnitTest, avspliter_small_buffer_0100, TestSize.Level0)
+{
+    uint32_t videoIdx = 0;
+    ASSERT_EQ(FindTrack(MEDIA_TYPE_VID, videoIdx), MSERR_OK);
+    ASSERT_EQ(spliter_->SelectTrack(videoIdx), MSERR_OK);
+
+    // a large read first, so that the memory shared with the service has been larger than the small buffer.
+    TrackSampleInfo info = {0, 0, 0, AVCODEC_BUFFER_FLAG_NONE};
+    ASSERT_EQ(ReadSample(info), MSERR_OK);
+    ASSERT_NE(info.flags, AVCODEC_BUFFER_FLAG_EOS);
+
+    std::vector<uint8_t> smallData(SMALL_BUFFER_SIZE);
+    auto smallBuffer = std::make_shared<AVContainerMemory>(smallData.data(), smallData.size());
+    TrackSampleInfo tooLarge = {0, 0, 0, AVCODEC_BUFFER_FLAG_NONE};
+    int32_t ret = MSERR_OK;
+    for (uint32_t readTimes = 0; readTimes < MAX_READ_TIMES; readTimes++) {
+        ret = spliter_->ReadTrackSample(smallBuffer, tooLarge);
+        if (ret != MSERR_OK || tooLarge.flags == AVCODEC_BUFFER_FLAG_EOS) {
+            break;
+        }
+    }
+    ASSERT_EQ(ret, MSERR_NO_MEMORY);
+    EXPECT_GT(tooLarge.size, SMALL_BUFFER_SIZE);
+
+    ASSERT_EQ(spliter_->ReadTrackSample(buffer_, info), MSERR_OK);
+    EXPECT_EQ(info.trackIdx, tooLarge.trackIdx);
+    EXPECT_EQ(info.timeUs, tooLarge.timeUs);
+    EXPECT_EQ(info.size, tooLarge.size);
+}
+
+/**
+ * @tc.name: avspliter_select_after_read_0100
+ * @tc.desc: a track selected during the reading starts from the read position in the time sync mode
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVSpliterUnitTest, avspliter_select_after_read_0100, TestSize.Level0)
+{
+    uint32_t videoIdx = 0;
+    uint32_t audioIdx = 0;
+    ASSERT_EQ(FindTrack(MEDIA_TYPE_VID, videoIdx), MSERR_OK);
+    ASSERT_EQ(FindTrack(MEDIA_TYPE_AUD, audioIdx), MSERR_OK);
+    ASSERT_EQ(spliter_->SelectTrack(videoIdx), MSERR_OK);
+
+    TrackSampleInfo info = {0, 0, 0, AVCODEC_BUFFER_FLAG_NONE};
+    int64_t lastTimeUs = 0;
+    for (uint32_t readTimes = 0; readTimes < PARTIAL_READ_TIMES; readTimes++) {
+        ASSERT_EQ(ReadSample(info), MSERR_OK);
+        ASSERT_NE(info.flags, AVCODEC_BUFFER_FLAG_EOS);
+        lastTimeUs = info.timeUs;
+    }
+
+    ASSERT_EQ(spliter_->SelectTrack(audioIdx), MSERR_OK);
+    bool audioRead = false;
+    for (uint32_t readTimes = 0; readTimes < MAX_READ_TIMES && !audioRead; readTimes++) {
+        ASSERT_EQ(ReadSample(info), MSERR_OK);
+        ASSERT_NE(info.flags, AVCODEC_BUFFER_FLAG_EOS);
+        if (info.trackIdx == audioIdx) {
+            audioRead = true;
+            EXPECT_GE(info.timeUs, lastTimeUs);
+        }
+    }
+    EXPECT_TRUE(audioRead);
+}
+
+/**
+ * @tc.name: avspliter_unselect_0100
+ * @tc.desc: the queued samples of an unselected track are not returned any more
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVSpliterUnitTest, avspliter_unselect_0100, TestSize.Level0)
+{
+    uint32_t videoIdx = 0;
+    uint32_t audioIdx = 0;
+    ASSERT_EQ(FindTrack(MEDIA_TYPE_VID, videoIdx), MSERR_OK);
+    ASSERT_EQ(FindTrack(MEDIA_TYPE_AUD, audioIdx), MSERR_OK);
+    ASSERT_EQ(spliter_->SelectTrack(videoIdx), MSERR_OK);
+    ASSERT_EQ(spliter_->SelectTrack(audioIdx), MSERR_OK);
+
+    TrackSampleInfo info = {0, 0, 0, AVCODEC_BUFFER_FLAG_NONE};
+    for (uint32_t readTimes = 0; readTimes < PARTIAL_READ_TIMES; readTimes++) {
+        ASSERT_EQ(ReadSample(info), MSERR_OK);
+        ASSERT_NE(info.flags, AVCODEC_BUFFER_FLAG_EOS);
+    }
+
+    ASSERT_EQ(spliter_->UnSelectTrack(audioIdx), MSERR_OK);
+    for (uint32_t readTimes = 0; readTimes < PARTIAL_READ_TIMES; readTimes++) {
+        ASSERT_EQ(ReadSample(info), MSERR_OK);
+        if (info.flags == AVCODEC_BUFFER_FLAG_EOS) {
+            break;
+        }
+        ASSERT_EQ(info.trackIdx, videoIdx);
+    }
+}
+
+/**
+ * @tc.name: avspliter_seek_0100
+ * @tc.desc: the samples queued before the seek are dropped, the reading restarts before the seek position
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVSpliterUnitTest, avspliter_seek_0100, TestSize.Level0)
+{
+    uint32_t videoIdx = 0;
+    uint32_t audioIdx = 0;
+    ASSERT_EQ(FindTrack(MEDIA_TYPE_VID, videoIdx), MSERR_OK);
+    ASSERT_EQ(FindTrack(MEDIA_TYPE_AUD, audioIdx), MSERR_OK);
+    ASSERT_EQ(spliter_->SelectTrack(videoIdx), MSERR_OK);
+    ASSERT_EQ(spliter_->SelectTrack(audioIdx), MSERR_OK);
+
+    TrackSampleInfo info = {0, 0, 0, AVCODEC_BUFFER_FLAG_NONE};
+    for (uint32_t readTimes = 0; readTimes < MAX_READ_TIMES; readTimes++) {
+        ASSERT_EQ(ReadSample(info), MSERR_OK);
+        ASSERT_NE(info.flags, AVCODEC_BUFFER_FLAG_EOS);
+        if (info.timeUs > READ_PAST_SEEK_US) {
+            break;
+        }
+    }
+
+    ASSERT_EQ(spliter_->Seek(SEEK_TIME_US, AV_SEEK_PREV_SYNC), MSERR_OK);
+    ASSERT_EQ(ReadSample(info), MSERR_OK);
+    ASSERT_NE(info.flags, AVCODEC_BUFFER_FLAG_EOS);
+    EXPECT_LE(info.timeUs, SEEK_TIME_US);
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEDIA_DATA_SOURCE_RING_UNIT_TEST_H
+#define MEDIA_DATA_SOURCE_RING_UNIT_TEST_H
+
+#include "gtest/gtest.h"
+#include "media_data_source_ring.h"
+
+namespace OHOS {
+namespace Media {
+class MediaDataSourceRingUnitTest : public testing::Test {
+public:
+    // SetUpTestCase: Called before all test cases
+    static void SetUpTestCase(void);
+    // TearDownTestCase: Called after all test case
+    static void TearDownTestCase(void);
+    // SetUp: Called before each test cases
+    void SetUp(void);
+    // TearDown: Called after each test cases
+    void TearDown(void);
+
+protected:
+    // write the bytes of the stream positions, returns the bytes written
+    uint32_t Write(uint32_t length);
+    // read and check the bytes of the stream positions, returns what Read returns
+    int32_t ReadAndCheck(uint32_t length);
+
+    // the server side, which creates the ring
+    std::shared_ptr<MediaDataSourceRing> consumer_ = nullptr;
+    // the app side, which maps the ring through the parcel
+    std::shared_ptr<MediaDataSourceRing> producer_ = nullptr;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // MEDIA_DATA_SOURCE_RING_UNIT_TEST_H
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avsharedmemorypool_unit_test.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "media_errors.h"
+
+using namespace std;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace testing::ext;
+
+namespace {
+    // not a class boundary, the class of 5000 bytes serves up to 5120 bytes.
+    constexpr int32_t PRE_ALLOC_SIZE = 5000;
+    constexpr int32_t PRE_ALLOC_CLASS_LIMIT = 5120;
+    constexpr uint32_t MAX_MEM_CNT = 4;
+    constexpr int32_t ACQUIRE_SIZES[] = { 1, 4096, 4097, 6000, 12345, 65536, 100000, 1048576 };
+    constexpr uint32_t THREAD_NUM = 8;
+    constexpr uint32_t ACQUIRE_TIMES = 2000;
+}
+
+void AVSharedMemoryPoolUnitTest::SetUpTestCase(void) {}
+
+void AVSharedMemoryPoolUnitTest::TearDownTestCase(void) {}
+
+void AVSharedMemoryPoolUnitTest::SetUp(void)
+{
+    pool_ = std::make_shared<AVSharedMemoryPool>("poolUnitTest");
+    ASSERT_NE(pool_, nullptr);
+}
+
+void AVSharedMemoryPoolUnitTest::TearDown(void)
+{
+    if (pool_ != nullptr) {
+        pool_->Reset();
+        pool_ = nullptr;
+    }
+}
+
+/**
+ * @tc.name: avsharedmemorypool_prealloc_0100
+ * @tc.desc: a preallocated block serves every size of the class it is filed under
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVSharedMemoryPoolUnitTest, avsharedmemorypool_prealloc_0100, TestSize.Level0)
+{
+    AVSharedMemoryPool::InitializeOption option;
+    option.preAllocMemCnt = 1;
+    option.memSize = PRE_ALLOC_SIZE;
+    option.maxMemCnt = 1;
+    option.enableFixedSize = false;
+    option.enableSizeClass = true;
+    ASSERT_EQ(pool_->Init(option), MSERR_OK);
+
+    // the only slot is the preallocated one, so the acquired memory must be that block.
+    auto memory = pool_->AcquireMemory(PRE_ALLOC_CLASS_LIMIT, false);
+    ASSERT_NE(memory, nullptr);
+    EXPECT_GE(memory->GetSize(), PRE_ALLOC_CLASS_LIMIT);
+    AVSharedMemory *block = memory.get();
+    memory = nullptr;
+
+    memory = pool_->AcquireMemory(PRE_ALLOC_SIZE, false);
+    ASSERT_NE(memory, nullptr);
+    EXPECT_EQ(memory.get(), block);
+}
+
+/**
+ * @tc.name: avsharedmemorypool_size_class_0100
+ * @tc.desc: the acquired memory is never smaller than the acquired size across the size classes
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVSharedMemoryPoolUnitTest, avsharedmemorypool_size_class_0100, TestSize.Level0)
+{
+    AVSharedMemoryPool::InitializeOption option;
+    option.maxMemCnt = MAX_MEM_CNT;
+    option.enableFixedSize = false;
+    option.enableSizeClass = true;
+    ASSERT_EQ(pool_->Init(option), MSERR_OK);
+
+    for (int32_t size : ACQUIRE_SIZES) {
+        auto memory = pool_->AcquireMemory(size, false);
+        ASSERT_NE(memory, nullptr);
+        EXPECT_GE(memory->GetSize(), size);
+        AVSharedMemory *block = memory.get();
+        memory = nullptr;
+
+        // an idle block of the same class is reused.
+        memory = pool_->AcquireMemory(size, false);
+        ASSERT_NE(memory, nullptr);
+        EXPECT_EQ(memory.get(), block);
+    }
+}
+
+/**
+ * @tc.name: avsharedmemorypool_max_count_0100
+ * @tc.desc: the number of busy blocks is bounded by the maxMemCnt, a released block is available again
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVSharedMemoryPoolUnitTest, avsharedmemorypool_max_count_0100, TestSize.Level0)
+{
+    AVSharedMemoryPool::InitializeOption option;
+    option.maxMemCnt = MAX_MEM_CNT;
+    option.enableFixedSize = false;
+    option.enableSizeClass = true;
+    ASSERT_EQ(pool_->Init(option), MSERR_OK);
+
+    std::vector<std::shared_ptr<AVSharedMemory>> busy;
+    for (uint32_t i = 0; i < MAX_MEM_CNT; ++i) {
+        auto memory = pool_->AcquireMemory(ACQUIRE_SIZES[i], false);
+        ASSERT_NE(memory, nullptr);
+        busy.push_back(memory);
+    }
+    EXPECT_EQ(pool_->AcquireMemory(ACQUIRE_SIZES[0], false), nullptr);
+
+    // the idle block is too small for the next size, it is freed and reallocated.
+    busy.pop_back();
+    auto memory = pool_->AcquireMemory(ACQUIRE_SIZES[MAX_MEM_CNT], false);
+    ASSERT_NE(memory, nullptr);
+    EXPECT_GE(memory->GetSize(), ACQUIRE_SIZES[MAX_MEM_CNT]);
+}
+
+/**
+ * @tc.name: avsharedmemorypool_fixed_size_0100
+ * @tc.desc: all blocks are the memSize in the fixed size mode
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVSharedMemoryPoolUnitTest, avsharedmemorypool_fixed_size_0100, TestSize.Level0)
+{
+    AVSharedMemoryPool::InitializeOption option;
+    option.preAllocMemCnt = 1;
+    option.memSize = PRE_ALLOC_SIZE;
+    option.maxMemCnt = MAX_MEM_CNT;
+    option.enableSizeClass = true;
+    ASSERT_EQ(pool_->Init(option), MSERR_OK);
+
+    auto memory = pool_->AcquireMemory(-1, false);
+    ASSERT_NE(memory, nullptr);
+    EXPECT_EQ(memory->GetSize(), PRE_ALLOC_SIZE);
+    EXPECT_EQ(pool_->AcquireMemory(PRE_ALLOC_SIZE + 1, false), nullptr);
+}
+
+/**
+ * @tc.name: avsharedmemorypool_concurrent_0100
+ * @tc.desc: the blocks are never handed out twice while the threads acquire and release concurrently
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVSharedMemoryPoolUnitTest, avsharedmemorypool_concurrent_0100, TestSize.Level0)
+{
+    AVSharedMemoryPool::InitializeOption option;
+    option.maxMemCnt = MAX_MEM_CNT;
+    option.enableFixedSize = false;
+    option.enableSizeClass = true;
+    ASSERT_EQ(pool_->Init(option), MSERR_OK);
+
+    std::atomic<uint32_t> failures = 0;
+    std::vector<std::thread> threads;
+    for (uint32_t id = 0; id < THREAD_NUM; ++id) {
+        threads.emplace_back([this, id, &failures]() {
+            uint8_t tag = static_cast<uint8_t>(id + 1);
+            for (uint32_t i = 0; i < ACQUIRE_TIMES; ++i) {
+                int32_t size = ACQUIRE_SIZES[(id + i) % (sizeof(ACQUIRE_SIZES) / sizeof(ACQUIRE_SIZES[0]))];
+                // more threads than the blocks, so the blocking acquisitions wait for the releases.
+                auto memory = pool_->AcquireMemory(size, true);
+                if (memory == nullptr || memory->GetSize() < size) {
+                    failures++;
+                    continue;
+                }
+                uint8_t *base = memory->GetBase();
+                base[0] = tag;
+                base[size - 1] = tag;
+                std::this_thread::yield();
+                if (base[0] != tag || base[size - 1] != tag) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(failures.load(), 0u);
+}
+
+/**
+ * @tc.name: avsharedmemorypool_reset_busy_0100
+ * @tc.desc: a block still busy when the pool is reset stays usable and is freed by its release
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AVSharedMemoryPoolUnitTest, avsharedmemorypool_reset_busy_0100, TestSize.Level0)
+{
+    AVSharedMemoryPool::InitializeOption option;
+    option.maxMemCnt = MAX_MEM_CNT;
+    option.enableFixedSize = false;
+    option.enableSizeClass = true;
+    ASSERT_EQ(pool_->Init(option), MSERR_OK);
+
+    auto memory = pool_->AcquireMemory(PRE_ALLOC_SIZE, false);
+    ASSERT_NE(memory, nullptr);
+    pool_->Reset();
+
+    memory->GetBase()[0] = 1;
+    memory = nullptr;
+}
@@ -0,0 +1,363 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "format_unit_test.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "media_description.h"
+
+using namespace std;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace testing::ext;
+
+namespace {
+    constexpr uint32_t MANY_KEYS = 40;
+    constexpr size_t LONG_KEY_LEN = 300;
+    constexpr size_t CSD_SIZE = 64;
+    constexpr uint32_t DEFAULT_BENCH_ITERATIONS = 20000;
+    constexpr const char *ENV_BENCH_ITERATIONS = "FORMAT_BENCH_ITERATIONS";
+
+    // the std::map layout Format used before, kept as the baseline of the benchmark
+    class LegacyFormat {
+    public:
+        LegacyFormat() = default;
+        ~LegacyFormat()
+        {
+            Clear();
+        }
+        LegacyFormat(const LegacyFormat &rhs) : map_(rhs.map_)
+        {
+            for (auto &[key, data] : map_) {
+                if (data.type == FORMAT_TYPE_ADDR) {
+                    uint8_t *addr = reinterpret_cast<uint8_t *>(malloc(data.size));
+                    (void)memcpy(addr, rhs.map_.at(key).addr, data.size);
+                    data.addr = addr;
+                }
+            }
+        }
+        LegacyFormat &operator=(const LegacyFormat &rhs) = delete;
+
+        void PutIntValue(const std::string_view &key, int32_t value)
+        {
+            FormatData data;
+            data.type = FORMAT_TYPE_INT32;
+            data.val.int32Val = value;
+            RemoveKey(key);
+            (void)map_.insert(std::make_pair(key, data));
+        }
+        void PutStringValue(const std::string_view &key, const std::string_view &value)
+        {
+            FormatData data;
+            data.type = FORMAT_TYPE_STRING;
+            data.stringVal = value;
+            RemoveKey(key);
+            (void)map_.insert(std::make_pair(key, data));
+        }
+        void PutBuffer(const std::string_view &key, const uint8_t *addr, size_t size)
+        {
+            FormatData data;
+            data.type = FORMAT_TYPE_ADDR;
+            data.addr = reinterpret_cast<uint8_t *>(malloc(size));
+            (void)memcpy(data.addr, addr, size);
+            data.size = size;
+            RemoveKey(key);
+            (void)map_.insert(std::make_pair(key, data));
+        }
+        bool GetIntValue(const std::string_view &key, int32_t &value) const
+        {
+            auto iter = map_.find(key);
+            if (iter == map_.end() || iter->second.type != FORMAT_TYPE_INT32) {
+                return false;
+            }
+            value = iter->second.val.int32Val;
+            return true;
+        }
+        bool GetStringValue(const std::string_view &key, std::string &value) const
+        {
+            auto iter = map_.find(key);
+            if (iter == map_.end() || iter->second.type != FORMAT_TYPE_STRING) {
+                return false;
+            }
+            value = iter->second.stringVal;
+            return true;
+        }
+
+    private:
+        void RemoveKey(const std::string_view &key)
+        {
+            auto iter = map_.find(key);
+            if (iter != map_.end()) {
+                if (iter->second.type == FORMAT_TYPE_ADDR) {
+                    free(iter->second.addr);
+                }
+                map_.erase(iter);
+            }
+        }
+        void Clear()
+        {
+            for (auto &[key, data] : map_) {
+                if (data.type == FORMAT_TYPE_ADDR) {
+                    free(data.addr);
+                }
+            }
+            map_.clear();
+        }
+        Format::FormatDataMap map_;
+    };
+
+    // a typical decoder output format
+    const std::string_view INT_KEYS[] = {
+        MediaDescriptionKey::MD_KEY_WIDTH, MediaDescriptionKey::MD_KEY_HEIGHT,
+        MediaDescriptionKey::MD_KEY_PIXEL_FORMAT, MediaDescriptionKey::MD_KEY_FRAME_RATE,
+        MediaDescriptionKey::MD_KEY_BITRATE, MediaDescriptionKey::MD_KEY_MAX_INPUT_SIZE,
+        MediaDescriptionKey::MD_KEY_TRACK_INDEX, MediaDescriptionKey::MD_KEY_TRACK_TYPE,
+        MediaDescriptionKey::MD_KEY_I_FRAME_INTERVAL, MediaDescriptionKey::MD_KEY_CHANNEL_COUNT,
+        MediaDescriptionKey::MD_KEY_SAMPLE_RATE,
+    };
+    constexpr std::string_view CSD_KEY = "codec_config";
+
+    template<typename T>
+    void FillFormat(T &format, const uint8_t *csd)
+    {
+        int32_t value = 0;
+        for (const auto &key : INT_KEYS) {
+            format.PutIntValue(key, value++);
+        }
+        format.PutStringValue(MediaDescriptionKey::MD_KEY_CODEC_MIME, "video/avc");
+        format.PutBuffer(CSD_KEY, csd, CSD_SIZE);
+    }
+
+    template<typename Func>
+    double MeasureNs(uint32_t iterations, Func func)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++) {
+            func();
+        }
+        auto cost = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        return static_cast<double>(cost.count()) / iterations;
+    }
+
+    template<typename T>
+    void RunBench(const char *name, uint32_t iterations, const uint8_t *csd)
+    {
+        int32_t sink = 0;
+        double putNs = MeasureNs(iterations, [&]() {
+            T format;
+            FillFormat(format, csd);
+        });
+
+        T filled;
+        FillFormat(filled, csd);
+        double getNs = MeasureNs(iterations, [&]() {
+            int32_t value = 0;
+            std::string mime;
+            for (const auto &key : INT_KEYS) {
+                (void)filled.GetIntValue(key, value);
+                sink += value;
+            }
+            (void)filled.GetStringValue(MediaDescriptionKey::MD_KEY_CODEC_MIME, mime);
+            sink += static_cast<int32_t>(mime.size());
+        });
+        double copyNs = MeasureNs(iterations, [&]() {
+            T copy(filled);
+            int32_t value = 0;
+            (void)copy.GetIntValue(MediaDescriptionKey::MD_KEY_WIDTH, value);
+            sink += value;
+        });
+        cout << name << ": put " << putNs << " ns, get " << getNs << " ns, copy " << copyNs
+             << " ns per format (" << iterations << " iterations, sink " << sink << ")" << endl;
+    }
+}
+
+void FormatUnitTest::SetUpTestCase(void) {}
+
+void FormatUnitTest::TearDownTestCase(void) {}
+
+void FormatUnitTest::SetUp(void) {}
+
+void FormatUnitTest::TearDown(void) {}
+
+/**
+ * @tc.name: format_put_get_0100
+ * @tc.desc: every value type round trips, mismatched types are rejected and overwrite replaces the type
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(FormatUnitTest, format_put_get_0100, TestSize.Level0)
+{
+    Format format;
+    const uint8_t buffer[] = { 1, 2, 3, 4 };
+    EXPECT_TRUE(format.PutIntValue("int", INT32_MIN));
+    EXPECT_TRUE(format.PutLongValue("long", INT64_MAX));
+    EXPECT_TRUE(format.PutFloatValue("float", 1.5f));
+    EXPECT_TRUE(format.PutDoubleValue("double", 2.25));
+    EXPECT_TRUE(format.PutStringValue("string", "video/avc"));
+    EXPECT_TRUE(format.PutBuffer("buffer", buffer, sizeof(buffer)));
+    EXPECT_FALSE(format.PutBuffer("null", nullptr, 0));
+
+    int32_t intVal = 0;
+    int64_t longVal = 0;
+    float floatVal = 0.0f;
+    double doubleVal = 0.0;
+    std::string strVal;
+    uint8_t *addr = nullptr;
+    size_t size = 0;
+    EXPECT_TRUE(format.GetIntValue("int", intVal));
+    EXPECT_EQ(INT32_MIN, intVal);
+    EXPECT_TRUE(format.GetLongValue("long", longVal));
+    EXPECT_EQ(INT64_MAX, longVal);
+    EXPECT_TRUE(format.GetFloatValue("float", floatVal));
+    EXPECT_FLOAT_EQ(1.5f, floatVal);
+    EXPECT_TRUE(format.GetDoubleValue("double", doubleVal));
+    EXPECT_DOUBLE_EQ(2.25, doubleVal);
+    EXPECT_TRUE(format.GetStringValue("string", strVal));
+    EXPECT_EQ("video/avc", strVal);
+    EXPECT_TRUE(format.GetBuffer("buffer", &addr, size));
+    ASSERT_EQ(sizeof(buffer), size);
+    EXPECT_EQ(0, memcmp(buffer, addr, size));
+
+    EXPECT_FALSE(format.GetLongValue("int", longVal));
+    EXPECT_FALSE(format.GetIntValue("missing", intVal));
+    EXPECT_EQ(FORMAT_TYPE_NONE, format.GetValueType("missing"));
+
+    EXPECT_TRUE(format.PutStringValue("int", "now a string"));
+    EXPECT_EQ(FORMAT_TYPE_STRING, format.GetValueType("int"));
+    EXPECT_FALSE(format.GetIntValue("int", intVal));
+    EXPECT_TRUE(format.GetStringValue("int", strVal));
+    EXPECT_EQ("now a string", strVal);
+    EXPECT_EQ(6u, format.GetKeys().size());
+
+    format.RemoveKey("buffer");
+    EXPECT_FALSE(format.ContainKey("buffer"));
+    EXPECT_EQ(5u, format.GetKeys().size());
+}
+
+/**
+ * @tc.name: format_copy_0100
+ * @tc.desc: copies are independent, share buffer payloads, and moves leave the source empty
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(FormatUnitTest, format_copy_0100, TestSize.Level0)
+{
+    const uint8_t buffer[] = { 9, 8, 7 };
+    Format origin;
+    (void)origin.PutIntValue("width", 1920);
+    (void)origin.PutStringValue("mime", "audio/mp4a-latm");
+    (void)origin.PutBuffer("csd", buffer, sizeof(buffer));
+
+    Format copy = origin;
+    (void)copy.PutIntValue("width", 1280);
+    copy.RemoveKey("mime");
+
+    int32_t width = 0;
+    std::string mime;
+    EXPECT_TRUE(origin.GetIntValue("width", width));
+    EXPECT_EQ(1920, width);
+    EXPECT_TRUE(origin.GetStringValue("mime", mime));
+    EXPECT_EQ("audio/mp4a-latm", mime);
+    EXPECT_TRUE(copy.GetIntValue("width", width));
+    EXPECT_EQ(1280, width);
+    EXPECT_FALSE(copy.ContainKey("mime"));
+
+    uint8_t *originAddr = nullptr;
+    uint8_t *copyAddr = nullptr;
+    size_t size = 0;
+    EXPECT_TRUE(origin.GetBuffer("csd", &originAddr, size));
+    EXPECT_TRUE(copy.GetBuffer("csd", &copyAddr, size));
+    EXPECT_EQ(originAddr, copyAddr);
+
+    origin = Format();
+    EXPECT_TRUE(copy.GetBuffer("csd", &copyAddr, size));
+    ASSERT_EQ(sizeof(buffer), size);
+    EXPECT_EQ(0, memcmp(buffer, copyAddr, size));
+
+    Format moved = std::move(copy);
+    EXPECT_TRUE(copy.GetKeys().empty());
+    EXPECT_TRUE(moved.GetIntValue("width", width));
+    EXPECT_EQ(1280, width);
+    copy = moved;
+    EXPECT_EQ(moved.Stringify(), copy.Stringify());
+}
+
+/**
+ * @tc.name: format_many_keys_0100
+ * @tc.desc: formats beyond the inline capacity keep keys sorted and agree with GetFormatMap
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(FormatUnitTest, format_many_keys_0100, TestSize.Level0)
+{
+    Format format;
+    std::string longKey(LONG_KEY_LEN, 'k');
+    for (uint32_t i = 0; i < MANY_KEYS; i++) {
+        // reverse order to exercise insertion in the middle
+        EXPECT_TRUE(format.PutIntValue("key_" + std::to_string(MANY_KEYS - i), static_cast<int32_t>(i)));
+    }
+    EXPECT_TRUE(format.PutStringValue(longKey, "long key"));
+    for (uint32_t i = 1; i <= MANY_KEYS; i += 2) { // 2: drop every other key
+        format.RemoveKey("key_" + std::to_string(i));
+    }
+
+    Format copy(format);
+    std::vector<std::string_view> keys = copy.GetKeys();
+    Format::FormatDataMap formatMap = copy.GetFormatMap();
+    ASSERT_EQ(MANY_KEYS / 2 + 1, keys.size()); // 2: half removed, 1: long key
+    ASSERT_EQ(keys.size(), formatMap.size());
+    auto iter = formatMap.begin();
+    for (size_t i = 0; i < keys.size(); i++, ++iter) {
+        EXPECT_EQ(iter->first, keys[i]);
+        EXPECT_EQ(iter->second.type, copy.GetValueType(keys[i]));
+        if (i > 0) {
+            EXPECT_LT(keys[i - 1], keys[i]);
+        }
+    }
+
+    std::string strVal;
+    EXPECT_TRUE(copy.GetStringValue(longKey, strVal));
+    EXPECT_EQ("long key", strVal);
+    EXPECT_EQ("long key", formatMap[longKey].stringVal);
+}
+
+/**
+ * @tc.name: format_bench_0100
+ * @tc.desc: compare put, get and copy cost of Format against the former std::map layout
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(FormatUnitTest, format_bench_0100, TestSize.Level1)
+{
+    uint32_t iterations = DEFAULT_BENCH_ITERATIONS;
+    const char *env = getenv(ENV_BENCH_ITERATIONS);
+    if (env != nullptr && std::strtoul(env, nullptr, 10) > 0) { // 10: decimal
+        iterations = static_cast<uint32_t>(std::strtoul(env, nullptr, 10)); // 10: decimal
+    }
+    uint8_t csd[CSD_SIZE] = {0};
+    for (size_t i = 0; i < CSD_SIZE; i++) {
+        csd[i] = static_cast<uint8_t>(i);
+    }
+
+    RunBench<LegacyFormat>("std::map format", iterations, csd);
+    RunBench<Format>("flat format", iterations, csd);
+
+    Format format;
+    FillFormat(format, csd);
+    Format copy(format);
+    EXPECT_EQ(format.Stringify(), copy.Stringify());
+}
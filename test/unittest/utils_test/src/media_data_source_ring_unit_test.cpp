@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "media_data_source_ring_unit_test.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "media_data_source.h"
+#include "media_errors.h"
+#include "message_parcel.h"
+
+using namespace std;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace testing::ext;
+
+namespace {
+    constexpr uint32_t RING_CAPACITY = 4096;
+    constexpr uint32_t DATA_SIZE = 1000;
+    constexpr uint32_t SKIP_SIZE = 300;
+    constexpr uint32_t FIRST_SIZE = 3000;
+    // below the min space the producer accepts, which is 1/8 of the ring
+    constexpr uint32_t SMALL_SIZE = 100;
+    constexpr int64_t SEEK_POS = 100000;
+    constexpr int64_t STREAM_SIZE = 4 * 1024 * 1024;
+    constexpr uint32_t MAX_CHUNK_SIZE = 1500;
+    constexpr uint32_t CHUNK_STEP = 31;
+    constexpr uint32_t READ_SIZE = 777;
+    constexpr int32_t DOORBELL_TIMEOUT_MS = 1000;
+
+    uint8_t ByteAt(int64_t pos)
+    {
+        // 7, 3: not a multiple of the ring, a byte copied to the wrong place is noticed
+        return static_cast<uint8_t>(pos * 7 + 3);
+    }
+}
+
+void MediaDataSourceRingUnitTest::SetUpTestCase(void) {}
+
+void MediaDataSourceRingUnitTest::TearDownTestCase(void) {}
+
+void MediaDataSourceRingUnitTest::SetUp(void)
+{
+    consumer_ = MediaDataSourceRing::Create(RING_CAPACITY, "ring_unit_test");
+    ASSERT_NE(consumer_, nullptr);
+    MessageParcel parcel;
+    ASSERT_EQ(consumer_->WriteToParcel(parcel), MSERR_OK);
+    producer_ = MediaDataSourceRing::CreateFromParcel(parcel);
+    ASSERT_NE(producer_, nullptr);
+}
+
+void MediaDataSourceRingUnitTest::TearDown(void)
+{
+    producer_ = nullptr;
+    consumer_ = nullptr;
+}
+
+uint32_t MediaDataSourceRingUnitTest::Write(uint32_t length)
+{
+    std::shared_ptr<AVSharedMemory> space = producer_->AcquireSpace(length);
+    if (space == nullptr) {
+        return 0;
+    }
+    int64_t pos = producer_->GetWritePos();
+    uint8_t *base = space->GetBase();
+    int32_t size = space->GetSize();
+    for (int32_t i = 0; i < size; i++) {
+        base[i] = ByteAt(pos + i);
+    }
+    producer_->Commit(size);
+    return static_cast<uint32_t>(size);
+}
+
+int32_t MediaDataSourceRingUnitTest::ReadAndCheck(uint32_t length)
+{
+    vector<uint8_t> buffer(length);
+    int64_t pos = consumer_->GetReadPos();
+    int32_t ret = consumer_->Read(buffer.data(), length);
+    for (int32_t i = 0; i < ret; i++) {
+        if (buffer[i] != ByteAt(pos + i)) {
+            ADD_FAILURE() << "wrong byte at " << (pos + i);
+            break;
+        }
+    }
+    return ret;
+}
+
+/**
+ * @tc.name: media_data_source_ring_wraparound_0100
+ * @tc.desc: the space ends at the end of the ring, and a read copies across it
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(MediaDataSourceRingUnitTest, media_data_source_ring_wraparound_0100, TestSize.Level0)
+{
+    EXPECT_EQ(Write(FIRST_SIZE), FIRST_SIZE);
+    EXPECT_EQ(ReadAndCheck(FIRST_SIZE), static_cast<int32_t>(FIRST_SIZE));
+
+    uint32_t tail = RING_CAPACITY - FIRST_SIZE;
+    EXPECT_EQ(Write(FIRST_SIZE), tail);
+    EXPECT_EQ(Write(FIRST_SIZE - tail), FIRST_SIZE - tail);
+    EXPECT_EQ(ReadAndCheck(RING_CAPACITY), static_cast<int32_t>(FIRST_SIZE));
+    EXPECT_TRUE(consumer_->IsEmpty());
+
+    // the whole ring is usable from any offset
+    uint32_t written = 0;
+    for (uint32_t size = Write(RING_CAPACITY); size > 0; size = Write(RING_CAPACITY)) {
+        written += size;
+    }
+    EXPECT_EQ(written, RING_CAPACITY);
+    EXPECT_EQ(ReadAndCheck(RING_CAPACITY), static_cast<int32_t>(RING_CAPACITY));
+    EXPECT_EQ(consumer_->GetReadPos(), static_cast<int64_t>(FIRST_SIZE * 2 + RING_CAPACITY)); // 2: two passes
+}
+
+/**
+ * @tc.name: media_data_source_ring_status_0100
+ * @tc.desc: the end of stream and the error of the app are returned after all the data before them
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(MediaDataSourceRingUnitTest, media_data_source_ring_status_0100, TestSize.Level0)
+{
+    EXPECT_EQ(ReadAndCheck(DATA_SIZE), 0);
+    EXPECT_EQ(Write(DATA_SIZE), DATA_SIZE);
+    producer_->Commit(SOURCE_ERROR_EOF);
+    EXPECT_EQ(producer_->AcquireSpace(DATA_SIZE), nullptr);
+
+    EXPECT_EQ(ReadAndCheck(DATA_SIZE / 2), static_cast<int32_t>(DATA_SIZE / 2)); // 2: read the data in two parts
+    EXPECT_EQ(ReadAndCheck(DATA_SIZE), static_cast<int32_t>(DATA_SIZE / 2)); // 2: the rest of the data
+    EXPECT_EQ(ReadAndCheck(DATA_SIZE), SOURCE_ERROR_EOF);
+    EXPECT_EQ(ReadAndCheck(DATA_SIZE), SOURCE_ERROR_EOF);
+
+    producer_->Reset(0);
+    EXPECT_EQ(Write(DATA_SIZE), DATA_SIZE);
+    producer_->Commit(SOURCE_ERROR_IO);
+    EXPECT_EQ(ReadAndCheck(DATA_SIZE), static_cast<int32_t>(DATA_SIZE));
+    EXPECT_EQ(ReadAndCheck(DATA_SIZE), SOURCE_ERROR_IO);
+}
+
+/**
+ * @tc.name: media_data_source_ring_seek_0100
+ * @tc.desc: a seek inside the ring skips the data, otherwise the ring is reset at the position
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(MediaDataSourceRingUnitTest, media_data_source_ring_seek_0100, TestSize.Level0)
+{
+    producer_->Reset(SEEK_POS);
+    EXPECT_EQ(consumer_->GetReadPos(), SEEK_POS);
+    EXPECT_EQ(producer_->GetWritePos(), SEEK_POS);
+    EXPECT_TRUE(consumer_->IsEmpty());
+
+    EXPECT_EQ(Write(DATA_SIZE), DATA_SIZE);
+    EXPECT_TRUE(consumer_->Skip(SEEK_POS + SKIP_SIZE));
+    EXPECT_EQ(consumer_->GetReadPos(), SEEK_POS + SKIP_SIZE);
+    EXPECT_EQ(ReadAndCheck(SKIP_SIZE), static_cast<int32_t>(SKIP_SIZE));
+
+    // backwards or beyond the data written, the producer has to reset the ring
+    EXPECT_FALSE(consumer_->Skip(SEEK_POS));
+    EXPECT_FALSE(consumer_->Skip(producer_->GetWritePos() + 1));
+    EXPECT_TRUE(consumer_->Skip(producer_->GetWritePos()));
+    EXPECT_TRUE(consumer_->IsEmpty());
+
+    // the reset also drops the end of stream
+    producer_->Commit(SOURCE_ERROR_EOF);
+    EXPECT_EQ(ReadAndCheck(DATA_SIZE), SOURCE_ERROR_EOF);
+    producer_->Reset(0);
+    EXPECT_EQ(ReadAndCheck(DATA_SIZE), 0);
+    EXPECT_EQ(Write(DATA_SIZE), DATA_SIZE);
+    EXPECT_EQ(ReadAndCheck(DATA_SIZE), static_cast<int32_t>(DATA_SIZE));
+}
+
+/**
+ * @tc.name: media_data_source_ring_corrupted_0100
+ * @tc.desc: a peer committing more than the ring holds is detected on both sides
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(MediaDataSourceRingUnitTest, media_data_source_ring_corrupted_0100, TestSize.Level0)
+{
+    producer_->Commit(static_cast<int32_t>(RING_CAPACITY + 1));
+    EXPECT_EQ(ReadAndCheck(DATA_SIZE), SOURCE_ERROR_IO);
+    EXPECT_FALSE(consumer_->Skip(consumer_->GetReadPos() + 1));
+    EXPECT_EQ(consumer_->GetReadPos(), 0);
+
+    // the producer ends the stream instead of writing into the ring
+    EXPECT_EQ(producer_->AcquireSpace(DATA_SIZE), nullptr);
+    producer_->Reset(0);
+    EXPECT_EQ(ReadAndCheck(DATA_SIZE), 0);
+}
+
+/**
+ * @tc.name: media_data_source_ring_doorbell_0100
+ * @tc.desc: the doorbell is armed while the space is below the min, and taken once
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(MediaDataSourceRingUnitTest, media_data_source_ring_doorbell_0100, TestSize.Level0)
+{
+    EXPECT_FALSE(consumer_->TakeDoorbell());
+    EXPECT_EQ(Write(RING_CAPACITY), RING_CAPACITY);
+    EXPECT_EQ(producer_->AcquireSpace(DATA_SIZE), nullptr);
+    EXPECT_TRUE(consumer_->TakeDoorbell());
+    EXPECT_FALSE(consumer_->TakeDoorbell());
+
+    EXPECT_EQ(ReadAndCheck(SMALL_SIZE), static_cast<int32_t>(SMALL_SIZE));
+    EXPECT_EQ(producer_->AcquireSpace(DATA_SIZE), nullptr);
+    EXPECT_TRUE(consumer_->TakeDoorbell());
+
+    EXPECT_EQ(ReadAndCheck(RING_CAPACITY), static_cast<int32_t>(RING_CAPACITY - SMALL_SIZE));
+    EXPECT_NE(producer_->AcquireSpace(DATA_SIZE), nullptr);
+    EXPECT_FALSE(consumer_->TakeDoorbell());
+}
+
+/**
+ * @tc.name: media_data_source_ring_doorbell_0200
+ * @tc.desc: the producer is always woken up when it waits for the space freed by a concurrent consumer
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(MediaDataSourceRingUnitTest, media_data_source_ring_doorbell_0200, TestSize.Level1)
+{
+    mutex doorbellMutex;
+    condition_variable doorbellCond;
+    bool rung = false;
+    atomic<bool> lost = false;
+
+    thread producer([&]() {
+        for (int64_t pos = producer_->GetWritePos(); pos < STREAM_SIZE; pos = producer_->GetWritePos()) {
+            uint32_t length = static_cast<uint32_t>(std::min<int64_t>(
+                1 + (pos * CHUNK_STEP) % MAX_CHUNK_SIZE, STREAM_SIZE - pos));
+            if (Write(length) > 0) {
+                continue;
+            }
+            unique_lock<mutex> lock(doorbellMutex);
+            if (!doorbellCond.wait_for(lock, chrono::milliseconds(DOORBELL_TIMEOUT_MS), [&rung]() { return rung; })) {
+                lost = true;
+                break;
+            }
+            rung = false;
+        }
+        producer_->Commit(SOURCE_ERROR_EOF);
+    });
+
+    int32_t ret = 0;
+    do {
+        ret = ReadAndCheck(READ_SIZE);
+        if (ret == 0) {
+            this_thread::yield();
+        } else if (ret > 0 && consumer_->TakeDoorbell()) {
+            lock_guard<mutex> lock(doorbellMutex);
+            rung = true;
+            doorbellCond.notify_one();
+        }
+    } while (ret >= 0);
+    producer.join();
+
+    EXPECT_FALSE(lost.load());
+    EXPECT_EQ(ret, SOURCE_ERROR_EOF);
+    EXPECT_EQ(consumer_->GetReadPos(), STREAM_SIZE);
+}
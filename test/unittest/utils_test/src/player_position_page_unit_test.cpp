@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "player_position_page_unit_test.h"
+#include <atomic>
+#include <thread>
+
+using namespace std;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace testing::ext;
+
+namespace {
+    constexpr int64_t POSITION_US = 5000000;
+    constexpr int32_t POSITION_MS = 5000;
+    constexpr int64_t HALF_SECOND_NS = 500000000;
+    constexpr double DOUBLE_RATE = 2.0;
+    constexpr uint32_t READ_COUNT = 100000;
+}
+
+void PlayerPositionPageUnitTest::SetUpTestCase(void) {}
+
+void PlayerPositionPageUnitTest::TearDownTestCase(void) {}
+
+void PlayerPositionPageUnitTest::SetUp(void)
+{
+    writer_ = PlayerPositionPage::Create();
+    ASSERT_NE(writer_, nullptr);
+    reader_ = PlayerPositionPage::Create(writer_->GetMemory());
+    ASSERT_NE(reader_, nullptr);
+}
+
+void PlayerPositionPageUnitTest::TearDown(void)
+{
+    reader_ = nullptr;
+    writer_ = nullptr;
+}
+
+/**
+ * @tc.name: player_position_page_inactive_0100
+ * @tc.desc: the page is invalid before it is activated and after it is deactivated
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(PlayerPositionPageUnitTest, player_position_page_inactive_0100, TestSize.Level0)
+{
+    PlayerPositionAnchor anchor;
+    anchor.positionUs = POSITION_US;
+    anchor.clockNs = PlayerPositionPage::GetClockNs();
+    int32_t currentTime = -1;
+    EXPECT_FALSE(reader_->GetCurrentTime(currentTime));
+    writer_->Publish(anchor);
+    EXPECT_FALSE(reader_->GetCurrentTime(currentTime));
+
+    writer_->SetActive(true);
+    writer_->Publish(anchor);
+    ASSERT_TRUE(reader_->GetCurrentTime(currentTime));
+    EXPECT_EQ(currentTime, POSITION_MS);
+
+    writer_->SetActive(false);
+    EXPECT_FALSE(reader_->GetCurrentTime(currentTime));
+}
+
+/**
+ * @tc.name: player_position_page_extrapolate_0100
+ * @tc.desc: a running anchor moves at the rate and stops at the max position
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(PlayerPositionPageUnitTest, player_position_page_extrapolate_0100, TestSize.Level0)
+{
+    writer_->SetActive(true);
+    PlayerPositionAnchor anchor;
+    anchor.positionUs = POSITION_US;
+    anchor.clockNs = PlayerPositionPage::GetClockNs() - HALF_SECOND_NS;
+    anchor.rate = DOUBLE_RATE;
+    anchor.running = true;
+    writer_->Publish(anchor);
+
+    int32_t currentTime = -1;
+    ASSERT_TRUE(reader_->GetCurrentTime(currentTime));
+    EXPECT_GE(currentTime, POSITION_MS + 1000); // 0.5s at 2x
+    EXPECT_LT(currentTime, POSITION_MS + 1100); // a bit of the test scheduling
+
+    anchor.maxPositionUs = POSITION_US + 100000; // 100ms
+    writer_->Publish(anchor);
+    ASSERT_TRUE(reader_->GetCurrentTime(currentTime));
+    EXPECT_EQ(currentTime, POSITION_MS + 100);
+}
+
+/**
+ * @tc.name: player_position_page_stale_0100
+ * @tc.desc: an old anchor is reported as stale
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(PlayerPositionPageUnitTest, player_position_page_stale_0100, TestSize.Level0)
+{
+    writer_->SetActive(true);
+    PlayerPositionAnchor anchor;
+    anchor.positionUs = POSITION_US;
+    anchor.clockNs = PlayerPositionPage::GetClockNs() - PlayerPositionPage::MAX_ANCHOR_AGE_NS - HALF_SECOND_NS;
+    writer_->Publish(anchor);
+
+    int32_t currentTime = -1;
+    EXPECT_FALSE(reader_->GetCurrentTime(currentTime));
+}
+
+/**
+ * @tc.name: player_position_page_race_0100
+ * @tc.desc: the reader never sees a torn anchor while the writer keeps publishing
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(PlayerPositionPageUnitTest, player_position_page_race_0100, TestSize.Level1)
+{
+    writer_->SetActive(true);
+    std::atomic<bool> stop = false;
+    std::thread writer([this, &stop] {
+        for (int64_t i = 1; !stop.load(); i++) {
+            // the position always equals the max position, a torn anchor would break it
+            PlayerPositionAnchor anchor;
+            anchor.positionUs = i * 1000; // 1ms per publish
+            anchor.maxPositionUs = anchor.positionUs;
+            anchor.clockNs = PlayerPositionPage::GetClockNs();
+            anchor.running = true;
+            writer_->Publish(anchor);
+        }
+    });
+
+    int32_t lastTime = 0;
+    for (uint32_t i = 0; i < READ_COUNT; i++) {
+        int32_t currentTime = -1;
+        if (reader_->GetCurrentTime(currentTime)) {
+            EXPECT_GE(currentTime, lastTime);
+            lastTime = currentTime;
+        }
+    }
+    stop = true;
+    writer.join();
+}
@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "task_queue_unit_test.h"
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include "media_errors.h"
+
+using namespace std;
+using namespace OHOS;
+using namespace OHOS::Media;
+using namespace testing::ext;
+
+namespace {
+    constexpr uint32_t TASK_COUNT = 200;
+    constexpr uint32_t QUEUE_COUNT = 32;
+    constexpr uint32_t SMALL_POOL = 2;
+    constexpr uint64_t DELAY_US = 20000;
+    constexpr uint64_t PERIOD_US = 5000;
+    constexpr uint32_t PERIODIC_RUNS = 3;
+    constexpr uint32_t CHAIN_DEPTH = 6;
+}
+
+void TaskQueueUnitTest::SetUpTestCase(void) {}
+
+void TaskQueueUnitTest::TearDownTestCase(void) {}
+
+void TaskQueueUnitTest::SetUp(void)
+{
+    savedMaxWorkers_ = TaskExecutor::GetInstance().GetMaxWorkers();
+}
+
+void TaskQueueUnitTest::TearDown(void)
+{
+    TaskExecutor::GetInstance().SetMaxWorkers(savedMaxWorkers_);
+}
+
+/**
+ * @tc.name: task_queue_fifo_0100
+ * @tc.desc: tasks of one queue run in enqueue order and never overlap
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TaskQueueUnitTest, task_queue_fifo_0100, TestSize.Level0)
+{
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::vector<uint32_t>> orders(QUEUE_COUNT);
+    std::vector<std::atomic<int32_t>> running(QUEUE_COUNT);
+    std::atomic<bool> overlapped = false;
+    std::vector<std::shared_ptr<TaskHandler<void>>> tasks;
+    for (uint32_t q = 0; q < QUEUE_COUNT; q++) {
+        queues.push_back(std::make_unique<TaskQueue>("fifo_" + std::to_string(q)));
+        ASSERT_EQ(MSERR_OK, queues[q]->Start());
+    }
+    for (uint32_t i = 0; i < TASK_COUNT; i++) {
+        for (uint32_t q = 0; q < QUEUE_COUNT; q++) {
+            auto task = std::make_shared<TaskHandler<void>>([&, q, i]() {
+                if (running[q].fetch_add(1) != 0) {
+                    overlapped = true;
+                }
+                orders[q].push_back(i);
+                running[q].fetch_sub(1);
+            });
+            ASSERT_EQ(MSERR_OK, queues[q]->EnqueueTask(task));
+            tasks.push_back(task);
+        }
+    }
+    for (auto &task : tasks) {
+        EXPECT_TRUE(task->GetResult().HasResult());
+    }
+    EXPECT_FALSE(overlapped.load());
+    for (uint32_t q = 0; q < QUEUE_COUNT; q++) {
+        ASSERT_EQ(TASK_COUNT, orders[q].size());
+        for (uint32_t i = 0; i < TASK_COUNT; i++) {
+            EXPECT_EQ(i, orders[q][i]);
+        }
+        EXPECT_EQ(MSERR_OK, queues[q]->Stop());
+    }
+    EXPECT_LE(TaskExecutor::GetInstance().GetWorkerCount(), TaskExecutor::GetInstance().GetMaxWorkers());
+}
+
+/**
+ * @tc.name: task_queue_delay_0100
+ * @tc.desc: delayed tasks run after the delay and after undelayed ones, periodic tasks repeat
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TaskQueueUnitTest, task_queue_delay_0100, TestSize.Level0)
+{
+    TaskQueue queue("delay");
+    ASSERT_EQ(MSERR_OK, queue.Start());
+    std::vector<int32_t> order;
+    auto begin = std::chrono::steady_clock::now();
+    auto delayed = std::make_shared<TaskHandler<int64_t>>([&]() {
+        order.push_back(1);
+        auto elapsed = std::chrono::steady_clock::now() - begin;
+        return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    });
+    auto immediate = std::make_shared<TaskHandler<void>>([&]() { order.push_back(0); });
+    ASSERT_EQ(MSERR_OK, queue.EnqueueTask(delayed, false, DELAY_US));
+    ASSERT_EQ(MSERR_OK, queue.EnqueueTask(immediate));
+    auto result = delayed->GetResult();
+    ASSERT_TRUE(result.HasResult());
+    EXPECT_GE(result.Value(), static_cast<int64_t>(DELAY_US));
+    ASSERT_EQ(2u, order.size());
+    EXPECT_EQ(0, order[0]);
+
+    std::atomic<uint32_t> runs = 0;
+    ITaskHandler::Attribute attr;
+    attr.periodicTimeUs_ = PERIOD_US;
+    auto periodic = std::make_shared<TaskHandler<void>>([&runs]() { runs++; }, attr);
+    ASSERT_EQ(MSERR_OK, queue.EnqueueTask(periodic));
+    while (runs.load() < PERIODIC_RUNS) {
+        std::this_thread::sleep_for(std::chrono::microseconds(PERIOD_US));
+    }
+    EXPECT_EQ(MSERR_OK, queue.Stop());
+    uint32_t stopped = runs.load();
+    std::this_thread::sleep_for(std::chrono::microseconds(PERIOD_US * PERIODIC_RUNS));
+    EXPECT_EQ(stopped, runs.load());
+}
+
+/**
+ * @tc.name: task_queue_stop_0100
+ * @tc.desc: Stop cancels pending tasks, is rejected from inside a task and IsInTaskThread tracks the strand
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TaskQueueUnitTest, task_queue_stop_0100, TestSize.Level0)
+{
+    TaskQueue queue("stop");
+    EXPECT_EQ(MSERR_INVALID_OPERATION, queue.EnqueueTask(std::make_shared<TaskHandler<void>>([]() {})));
+    ASSERT_EQ(MSERR_OK, queue.Start());
+    EXPECT_FALSE(queue.IsInTaskThread());
+
+    auto inside = std::make_shared<TaskHandler<int32_t>>([&queue]() {
+        return queue.IsInTaskThread() ? queue.Stop() : MSERR_UNKNOWN;
+    });
+    ASSERT_EQ(MSERR_OK, queue.EnqueueTask(inside));
+    auto insideResult = inside->GetResult();
+    ASSERT_TRUE(insideResult.HasResult());
+    EXPECT_EQ(MSERR_INVALID_OPERATION, insideResult.Value());
+
+    auto pending = std::make_shared<TaskHandler<void>>([]() {});
+    ASSERT_EQ(MSERR_OK, queue.EnqueueTask(pending, false, DELAY_US));
+    EXPECT_EQ(MSERR_OK, queue.Stop());
+    EXPECT_TRUE(pending->IsCanceled());
+    EXPECT_FALSE(pending->GetResult().HasResult());
+
+    ASSERT_EQ(MSERR_OK, queue.Start());
+    auto again = std::make_shared<TaskHandler<void>>([]() {});
+    ASSERT_EQ(MSERR_OK, queue.EnqueueTask(again));
+    EXPECT_TRUE(again->GetResult().HasResult());
+}
+
+/**
+ * @tc.name: task_queue_priority_0100
+ * @tc.desc: when the pool is saturated, a high priority queue is served before a low priority one
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TaskQueueUnitTest, task_queue_priority_0100, TestSize.Level0)
+{
+    TaskExecutor::GetInstance().SetMaxWorkers(SMALL_POOL);
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<bool> release(SMALL_POOL, false);
+    std::atomic<uint32_t> blocked = 0;
+    std::vector<std::unique_ptr<TaskQueue>> busyQueues;
+    std::vector<std::shared_ptr<TaskHandler<void>>> busyTasks;
+    for (uint32_t i = 0; i < SMALL_POOL; i++) {
+        busyQueues.push_back(std::make_unique<TaskQueue>("busy_" + std::to_string(i)));
+        ASSERT_EQ(MSERR_OK, busyQueues[i]->Start());
+        auto task = std::make_shared<TaskHandler<void>>([&, i]() {
+            blocked++;
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&release, i]() { return release[i]; });
+        });
+        ASSERT_EQ(MSERR_OK, busyQueues[i]->EnqueueTask(task));
+        busyTasks.push_back(task);
+    }
+    // every worker is now busy, and the extra idle ones left over by earlier cases have exited
+    while (blocked.load() < SMALL_POOL || TaskExecutor::GetInstance().GetWorkerCount() > SMALL_POOL) {
+        std::this_thread::yield();
+    }
+
+    std::vector<TaskPriority> order;
+    std::mutex orderMutex;
+    TaskQueue lowQueue("low", TaskPriority::LOW);
+    TaskQueue highQueue("high", TaskPriority::HIGH);
+    ASSERT_EQ(MSERR_OK, lowQueue.Start());
+    ASSERT_EQ(MSERR_OK, highQueue.Start());
+    auto low = std::make_shared<TaskHandler<void>>([&]() {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(TaskPriority::LOW);
+    });
+    auto high = std::make_shared<TaskHandler<void>>([&]() {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(TaskPriority::HIGH);
+    });
+    ASSERT_EQ(MSERR_OK, lowQueue.EnqueueTask(low));
+    ASSERT_EQ(MSERR_OK, highQueue.EnqueueTask(high));
+
+    // free a single worker, it must pick the high priority strand first
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release[0] = true;
+    }
+    cond.notify_all();
+    EXPECT_TRUE(low->GetResult().HasResult());
+    EXPECT_TRUE(high->GetResult().HasResult());
+    ASSERT_EQ(2u, order.size());
+    EXPECT_EQ(TaskPriority::HIGH, order[0]);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release[1] = true;
+    }
+    cond.notify_all();
+    for (auto &task : busyTasks) {
+        EXPECT_TRUE(task->GetResult().HasResult());
+    }
+}
+
+/**
+ * @tc.name: task_queue_chain_0100
+ * @tc.desc: tasks waiting synchronously on other queues do not starve a small pool
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TaskQueueUnitTest, task_queue_chain_0100, TestSize.Level0)
+{
+    TaskExecutor::GetInstance().SetMaxWorkers(SMALL_POOL);
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    for (uint32_t i = 0; i < CHAIN_DEPTH; i++) {
+        queues.push_back(std::make_unique<TaskQueue>("chain_" + std::to_string(i)));
+        ASSERT_EQ(MSERR_OK, queues[i]->Start());
+    }
+    std::function<int32_t(uint32_t)> call = [&](uint32_t depth) -> int32_t {
+        if (depth + 1 == CHAIN_DEPTH) {
+            return static_cast<int32_t>(depth);
+        }
+        auto next = std::make_shared<TaskHandler<int32_t>>([&call, depth]() { return call(depth + 1); });
+        if (queues[depth + 1]->EnqueueTask(next) != MSERR_OK) {
+            return -1;
+        }
+        auto result = next->GetResult();
+        return result.HasResult() ? result.Value() : -1;
+    };
+    auto head = std::make_shared<TaskHandler<int32_t>>([&call]() { return call(0); });
+    ASSERT_EQ(MSERR_OK, queues[0]->EnqueueTask(head));
+    auto result = head->GetResult();
+    ASSERT_TRUE(result.HasResult());
+    EXPECT_EQ(static_cast<int32_t>(CHAIN_DEPTH - 1), result.Value());
+}
+
+/**
+ * @tc.name: task_queue_dedicated_0100
+ * @tc.desc: a dedicated queue runs a never-returning style loop without taking a pool worker
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TaskQueueUnitTest, task_queue_dedicated_0100, TestSize.Level0)
+{
+    TaskQueue guard("guard", TaskPriority::NORMAL, true);
+    ASSERT_EQ(MSERR_OK, guard.Start());
+    std::atomic<bool> exit = false;
+    std::atomic<bool> onWorker = true;
+    auto loop = std::make_shared<TaskHandler<void>>([&]() {
+        onWorker = TaskExecutor::IsWorkerThread();
+        while (!exit.load()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(PERIOD_US));
+        }
+    });
+    ASSERT_EQ(MSERR_OK, guard.EnqueueTask(loop));
+
+    TaskQueue shared("shared");
+    ASSERT_EQ(MSERR_OK, shared.Start());
+    auto probe = std::make_shared<TaskHandler<bool>>([]() { return TaskExecutor::IsWorkerThread(); });
+    ASSERT_EQ(MSERR_OK, shared.EnqueueTask(probe));
+    auto probeResult = probe->GetResult();
+    ASSERT_TRUE(probeResult.HasResult());
+    EXPECT_TRUE(probeResult.Value());
+
+    exit = true;
+    EXPECT_TRUE(loop->GetResult().HasResult());
+    EXPECT_FALSE(onWorker.load());
+    EXPECT_EQ(MSERR_OK, guard.Stop());
+}